@@ -58,21 +58,7 @@ typedef enum {
   SML_TIME_STAMP_NOW
 } SMLTimeStampType;
 
-typedef struct SSmlSqlInsertBatch {
-  uint64_t id;
-  int32_t index;
-
-  char* sql;
-  int32_t code;
-  int32_t tryTimes;
-  tsem_t sem;
-  int32_t affectedRows;
-  bool tryAgain;
-  bool resetQueryCache;
-  bool sleep;
-} SSmlSqlInsertBatch;
-
-#define MAX_SML_SQL_INSERT_BATCHES 512
+typedef struct SSmlArena SSmlArena;
 
 typedef struct {
   uint64_t id;
@@ -82,10 +68,10 @@ typedef struct {
 
   int32_t affectedRows;
 
-  pthread_mutex_t batchMutex;
-  pthread_cond_t batchCond;
-  int32_t numBatches;
-  SSmlSqlInsertBatch batches[MAX_SML_SQL_INSERT_BATCHES];
+  SSmlArena* arena;       // keys and values of the points are allocated from it if not NULL, and freed all at once
+  SHashObj* keyHash;      // keys of the line being parsed, to find the duplicated ones
+  TAOS_SML_KV* kvBuf;     // tags or fields of the line being parsed
+  int32_t kvBufCap;
 } SSmlLinesInfo;
 
 char* addEscapeCharToString(char *str, int32_t len);
@@ -96,13 +82,17 @@ bool isValidFloat(char *str);
 
 int32_t isValidChildTableName(const char *pTbName, int16_t len, SSmlLinesInfo* info);
 
-bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
+bool convertSmlValueType(TAOS_SML_KV *pVal, const char *value,
                          uint16_t len, SSmlLinesInfo* info, bool isTag);
-int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, char *value,
+int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, const char *value,
                             uint16_t len, SSmlLinesInfo* info);
+int32_t tscParseLine(const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info);
 
 void destroySmlDataPoint(TAOS_SML_DATA_POINT* point);
 
+// pick the line protocol scanner by the CPU features
+void tscResolveSmlScanner();
+
 int taos_insert_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol,
                       SMLTimeStampType tsType, int* affectedRows);
 int taos_insert_telnet_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType protocol,
@@ -88,6 +88,7 @@ typedef struct SParamInfo {
   uint8_t  timePrec;
   int16_t  bytes;
   uint32_t offset;
+  int16_t  colIndex;  // index of the column in the schema
 } SParamInfo;
 
 typedef struct SBoundColumn {
@@ -216,6 +217,16 @@ static FORCE_INLINE void tscAppendMemRowColValEx(SMemRow row, const void *value,
     tdGetColAppendDeltaLen(value, colType, dataLen, kvLen);
   }
 }
+// values of one column bound by the prepared statement, for the columnar payload
+typedef struct SBindColumn {
+  int32_t  numOfRows;
+  int32_t  len;        // length of the values
+  int32_t  cap;        // allocated length of the values
+  int32_t  offsetCap;  // allocated number of the offsets
+  char    *pData;      // values of the fixed length type, or the VarDataT values of binary and nchar
+  int32_t *offsets;    // offset of each value in pData of binary and nchar, numOfRows + 1 ones are used
+} SBindColumn;
+
 typedef struct STableDataBlocks {
   SName       tableName;
   int8_t      tsSource;     // where does the UNIX timestamp come from, server or client
@@ -237,6 +248,7 @@ typedef struct STableDataBlocks {
   uint32_t       numOfAllocedParams;
   uint32_t       numOfParams;
   SParamInfo *   params;
+  SBindColumn *  pCols;   // for the columnar payload, one for each column of the schema, the rows are not in pData
   SMemRowBuilder rowBuilder;
 } STableDataBlocks;
 
@@ -251,7 +263,7 @@ typedef struct SInsertStatementParam {
   SHashObj    *pTableBlockHashList;     // data block for each table
   SArray      *pDataBlocks;             // SArray<STableDataBlocks*>. Merged submit block for each vgroup
   int8_t       schemaAttached;          // denote if submit block is built with table schema or not
-  uint8_t      payloadType;             // EPayloadType. 0: K-V payload for non-prepare insert, 1: rawPayload for prepare insert
+  uint8_t      payloadType;             // EPayloadType. 0: K-V payload for non-prepare insert, 1: rawPayload for prepare insert, 2: columnar payload for prepare insert
   STagData     tagData;                 // NOTE: pTagData->data is used as a variant length array
 
   int32_t      batchSize;               // for parameter ('?') binding and batch processing
@@ -266,10 +278,12 @@ typedef struct SInsertStatementParam {
 typedef enum {
   PAYLOAD_TYPE_KV = 0,
   PAYLOAD_TYPE_RAW = 1,
+  PAYLOAD_TYPE_COLUMNAR = 2,
 } EPayloadType;
 
 #define IS_RAW_PAYLOAD(t) \
   (((int)(t)) == PAYLOAD_TYPE_RAW)  // 0: K-V payload for non-prepare insert, 1: rawPayload for prepare insert
+#define IS_COLUMNAR_PAYLOAD(t) (((int)(t)) == PAYLOAD_TYPE_COLUMNAR)  // 2: bound by columns, sent as columnar blocks
 
 // TODO extract sql parser supporter
 typedef struct {
@@ -303,6 +317,7 @@ typedef struct {
   int32_t        rspLen;
   uint64_t       qId;     // query id of SQInfo
   int64_t        useconds;
+  int64_t        cpuTime; // cpu time consumed by the query in vnode
   int64_t        offset;  // offset value from vnode during projection query of stable
   int32_t        row;
   int16_t        numOfCols;
@@ -338,6 +353,7 @@ typedef struct STscObj {
   char               clusterId[TSDB_CLUSTER_ID_LEN];
   char               writeAuth : 1;
   char               superAuth : 1;
+  int8_t             features;  // TSDB_CONN_FEATURE_XXX of the cluster
   uint32_t           connId;
   uint64_t           rid;      // ref ID returned by taosAddRef
   int64_t            hbrid;
@@ -424,6 +440,8 @@ typedef struct SSqlStream {
   SInterval interval;
   void *  pTimer;
 
+  struct SStreamIncInfo *pInc;  // partial results of the panes of an incremental stream, NULL if not incremental
+
   void (*fp)();
   void *param;
 
@@ -493,6 +511,7 @@ TAOS_RES * taos_query_ra(TAOS *taos, const char *sqlstr, __async_cb_func_t fp, v
 int32_t taos_unused_session(TAOS* taos);
 
 void waitForQueryRsp(void *param, TAOS_RES *tres, int code);
+void loadMultiTableMetaCallback(void *param, TAOS_RES *res, int code);
 
 void doAsyncQuery(STscObj *pObj, SSqlObj *pSql, __async_cb_func_t fp, void *param, const char *sqlstr, size_t sqlLen);
 
@@ -849,7 +868,7 @@ static FORCE_INLINE int32_t tsParseOneColumnKV(SSchema *pSchema, SStrToken *pTok
       if (pToken->type == TK_NULL) {
         tdAppendMemRowColVal(row, getNullValue(pSchema->type), true, colId, pSchema->type, toffset);
       } else {  // too long values will return invalid sql, not be truncated automatically
-        if (pToken->n + VARSTR_HEADER_SIZE > pSchema->bytes) {  // todo refactor
+        if (pToken->n + VARSTR_HEADER_SIZE > (uint32_t)pSchema->bytes) {  // todo refactor
           return tscInvalidOperationMsg(msg, "string data overflow", pToken->z);
         }
         // STR_WITH_SIZE_TO_VARSTR(payload, pToken->z, pToken->n);
@@ -468,7 +468,7 @@ int tsParseOneRow(char **str, STableDataBlocks *pDataBlocks, int16_t timePrec, i
       }
 
       uint32_t offset = (uint32_t)(start - pDataBlocks->pData);
-      if (tscAddParamToDataBlock(pDataBlocks, pSchema->type, (uint8_t)timePrec, pSchema->bytes, offset) != NULL) {
+      if (tscAddParamToDataBlock(pDataBlocks, pSchema->type, (uint8_t)timePrec, pSchema->bytes, offset, (int16_t)colIndex) != NULL) {
         continue;
       }
 
@@ -827,6 +827,78 @@ int tscSortRemoveDataBlockDupRows(STableDataBlocks *dataBuf, SBlockKeyInfo *pBlk
   return 0;
 }
 
+// the rows of the same timestamp are kept in the bound order, so the later bound one is kept when merged
+static int32_t bindRowCompar(const void *lhs, const void *rhs) {
+  const SBlockKeyTuple *p1 = lhs;
+  const SBlockKeyTuple *p2 = rhs;
+
+  if (p1->skey != p2->skey) {
+    return p1->skey < p2->skey ? -1 : 1;
+  }
+
+  return (intptr_t)p1->payloadAddr < (intptr_t)p2->payloadAddr ? -1 : 1;
+}
+
+/*
+ * the rows bound by columns are disordered, sort the row index (kept in payloadAddr) of them in ascending order of the
+ * timestamp, the bound columns are not moved until they are gathered into the columnar submit block
+ */
+int tscSortRemoveBindColumnDupRows(STableDataBlocks *dataBuf, SBlockKeyInfo *pBlkKeyInfo) {
+  SSubmitBlk *pBlocks = (SSubmitBlk *)dataBuf->pData;
+  int32_t     nRows = pBlocks->numOfRows;
+
+  if (dataBuf->tsSource == TSDB_USE_SERVER_TS) {
+    assert(dataBuf->ordered);
+  }
+
+  if (dataBuf->ordered) {
+    dataBuf->prevTS = INT64_MIN;
+    return 0;
+  }
+
+  size_t nAlloc = nRows * sizeof(SBlockKeyTuple);
+  if (pBlkKeyInfo->pKeyTuple == NULL || pBlkKeyInfo->maxBytesAlloc < nAlloc) {
+    char *tmp = trealloc(pBlkKeyInfo->pKeyTuple, nAlloc);
+    if (tmp == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+    pBlkKeyInfo->pKeyTuple = (SBlockKeyTuple *)tmp;
+    pBlkKeyInfo->maxBytesAlloc = (int32_t)nAlloc;
+  }
+
+  // the rows are disordered only if the timestamp column is bound
+  TSKEY          *keys = (TSKEY *)dataBuf->pCols[PRIMARYKEY_TIMESTAMP_COL_INDEX].pData;
+  SBlockKeyTuple *pBlkKeyTuple = pBlkKeyInfo->pKeyTuple;
+  for (int32_t n = 0; n < nRows; ++n) {
+    pBlkKeyTuple[n].skey = keys[n];
+    pBlkKeyTuple[n].payloadAddr = (void *)(intptr_t)n;
+  }
+
+  qsort(pBlkKeyTuple, nRows, sizeof(SBlockKeyTuple), bindRowCompar);
+  dataBuf->ordered = true;
+
+  if (tsClientMerge) {
+    int32_t i = 0;
+    int32_t j = 1;
+    while (j < nRows) {
+      if (pBlkKeyTuple[i].skey == pBlkKeyTuple[j].skey) {
+        if (dataBuf->pTableMeta && dataBuf->pTableMeta->tableInfo.update != TD_ROW_DISCARD_UPDATE) {
+          pBlkKeyTuple[i] = pBlkKeyTuple[j];
+        }
+
+        ++j;
+        continue;
+      }
+
+      pBlkKeyTuple[++i] = pBlkKeyTuple[j++];
+    }
+    pBlocks->numOfRows = i + 1;
+  }
+
+  dataBuf->prevTS = INT64_MIN;
+  return 0;
+}
+
 static int32_t doParseInsertStatement(SInsertStatementParam *pInsertParam, char **str, STableDataBlocks* dataBuf, int32_t *totalNum) {  
   int32_t maxNumOfRows;
   int32_t code = tscAllocateMemIfNeed(dataBuf, getExtendedRowSize(dataBuf), &maxNumOfRows);
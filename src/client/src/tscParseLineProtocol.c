@@ -15,6 +15,7 @@
 #include "tscUtil.h"
 #include "tsclient.h"
 #include "tscLog.h"
+#include "tscSubquery.h"
 
 #include "taos.h"
 #include "tscParseLine.h"
@@ -26,8 +27,30 @@ typedef struct  {
   SArray* tags; //SArray<SSchema>
   SArray* fields; //SArray<SSchema>
   uint8_t precision;
+  STableMeta* tableMeta; // meta of the super table the points are submitted by
+  int16_t* colIndex;     // column index in tableMeta of each field
 } SSmlSTableSchema;
 
+typedef struct {
+  char* tableName;
+  SName name;
+  SArray* points; //SArray<TAOS_SML_DATA_POINT*>
+  STableMeta* tableMeta;
+} SSmlChildTable;
+
+typedef struct {
+  int32_t table;
+  int32_t row;
+} SSmlSubmitPos;
+
+// the rows of a table in one submit block must be less than INT16_MAX, see tsSetBlockInfo
+#define SML_MAX_ROWS_PER_BLOCK (INT16_MAX - 1)
+
+// the longest wait before the points are submitted again
+#define SML_MAX_RETRY_WAIT_MS 2000
+
+int32_t tsCheckTimestamp(STableDataBlocks *pDataBlocks, const char *start);
+
 //=================================================================================================
 
 static uint64_t linesSmlHandleId = 0;
@@ -42,6 +65,76 @@ uint64_t genLinesSmlId() {
   return id;
 }
 
+// the memory of the points parsed from a batch of lines, it is freed at once after the batch is inserted
+struct SSmlArena {
+  SArray* chunks;  // SArray<char*>
+  char*   pos;     // free space of the last chunk
+  size_t  left;
+};
+
+#define SML_ARENA_CHUNK_SIZE (64 * 1024)
+
+static SSmlArena* smlCreateArena() {
+  SSmlArena* arena = calloc(1, sizeof(SSmlArena));
+  if (arena == NULL) {
+    return NULL;
+  }
+
+  arena->chunks = taosArrayInit(16, POINTER_BYTES);
+  if (arena->chunks == NULL) {
+    free(arena);
+    return NULL;
+  }
+  return arena;
+}
+
+static void smlDestroyArena(SSmlArena* arena) {
+  if (arena == NULL) {
+    return;
+  }
+
+  for (size_t i = 0; i < taosArrayGetSize(arena->chunks); ++i) {
+    free(taosArrayGetP(arena->chunks, i));
+  }
+  taosArrayDestroy(&arena->chunks);
+  free(arena);
+}
+
+// the blocks larger than a quarter of the chunk are allocated alone, so the free space of the last chunk is kept
+static void* smlArenaAlloc(SSmlArena* arena, size_t size) {
+  size = ALIGN8(size);
+  if (size > arena->left) {
+    size_t chunkSize = (size > SML_ARENA_CHUNK_SIZE / 4) ? size : SML_ARENA_CHUNK_SIZE;
+    char*  chunk = malloc(chunkSize);
+    if (chunk == NULL || taosArrayPush(arena->chunks, &chunk) == NULL) {
+      free(chunk);
+      return NULL;
+    }
+
+    if (chunkSize == size) {
+      return chunk;
+    }
+    arena->pos = chunk;
+    arena->left = chunkSize;
+  }
+
+  void* p = arena->pos;
+  arena->pos += size;
+  arena->left -= size;
+  return p;
+}
+
+// the points of the other protocols are freed by destroySmlDataPoint, they have no arena
+static void* smlMalloc(SSmlLinesInfo* info, size_t size) {
+  return (info->arena != NULL) ? smlArenaAlloc(info->arena, size) : malloc(size);
+}
+
+static void smlFree(SSmlLinesInfo* info, void* p) {
+  if (info->arena == NULL) {
+    free(p);
+  }
+}
+
 int compareSmlColKv(const void* p1, const void* p2) {
   TAOS_SML_KV* kv1 = (TAOS_SML_KV*)p1;
   TAOS_SML_KV* kv2 = (TAOS_SML_KV*)p2;
@@ -192,7 +285,7 @@ static int32_t buildSmlChildTableName(TAOS_SML_DATA_POINT* point, SSmlLinesInfo*
   char childTableName[TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE];
   int32_t tableNameLen = TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE;
   getSmlMd5ChildTableName(point, childTableName, &tableNameLen, info);
-  point->childTableName = calloc(1, tableNameLen+1);
+  point->childTableName = smlMalloc(info, tableNameLen+1);
   strncpy(point->childTableName, childTableName, tableNameLen);
   point->childTableName[tableNameLen] = '\0';
   return 0;
@@ -220,6 +313,8 @@ static int32_t buildDataPointSchemas(TAOS_SML_DATA_POINT* points, int numPoint,
       schema.tags = taosArrayInit(8, sizeof(SSchema));
       schema.tagHash = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
       schema.fieldHash = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
+      schema.tableMeta = NULL;
+      schema.colIndex = NULL;
 
       pStableSchema = taosArrayPush(stableSchemas, &schema);
       stableIdx = taosArrayGetSize(stableSchemas) - 1;
@@ -804,467 +899,904 @@ static int smlSnprintf(char* buf, int32_t *total, int32_t cap, char* fmt, ...) {
   return 0;
 }
 
-static int32_t addChildTableDataPointsToInsertSql(char* cTableName, char* sTableName, SSmlSTableSchema* sTableSchema, SArray* cTablePoints,
-                                                  char* sql, int32_t capacity, int32_t* cTableSqlLen, int fromIndex, int* nextIndex, SSmlLinesInfo* info) {
+static int32_t smlSetTableName(SSqlObj* pSql, char* tableName, SName* pName) {
+  char   tableNameBuf[TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE] = {0};
+  size_t len = strlen(tableName);
+  if (len >= tListLen(tableNameBuf)) {
+    return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
+  }
+
+  memcpy(tableNameBuf, tableName, len);
+  SStrToken tableToken = {.z = tableNameBuf, .n = (uint32_t)len, .type = TK_ID};
+  tGetToken(tableNameBuf, &tableToken.type);
+  bool dbIncluded = false;
+  if (tscValidateName(&tableToken, true, &dbIncluded) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
+  }
+
+  return tscSetTableFullName(pName, &tableToken, pSql, dbIncluded);
+}
+
+// map the fields of the points to the columns of the super table, the column names are not escaped
+static int32_t buildColumnIndex(SSmlSTableSchema* sTableSchema, SSmlLinesInfo* info) {
+  STableMeta* pTableMeta = sTableSchema->tableMeta;
+  SSchema*    pSchema = tscGetTableSchema(pTableMeta);
+  size_t      numFields = taosArrayGetSize(sTableSchema->fields);
+
+  int16_t* colIndex = realloc(sTableSchema->colIndex, numFields * sizeof(int16_t));
+  if (colIndex == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  sTableSchema->colIndex = colIndex;
+
+  colIndex[0] = PRIMARYKEY_TIMESTAMP_COL_INDEX;
+  for (int32_t i = 1; i < numFields; ++i) {
+    SSchema* field = taosArrayGet(sTableSchema->fields, i);
+    size_t   nameLen = strlen(field->name) - TS_BACKQUOTE_CHAR_SIZE;
+
+    colIndex[i] = -1;
+    for (int16_t j = 1; j < pTableMeta->tableInfo.numOfColumns; ++j) {
+      if (strlen(pSchema[j].name) == nameLen && strncmp(pSchema[j].name, field->name + 1, nameLen) == 0) {
+        colIndex[i] = j;
+        break;
+      }
+    }
+
+    if (colIndex[i] < 0 || pSchema[colIndex[i]].type != field->type) {
+      tscError("SML:0x%"PRIx64" field %s does not match the columns of super table %s", info->id, field->name,
+               sTableSchema->sTableName);
+      return TSDB_CODE_TSC_INVALID_VALUE;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the child table meta in cache has no schema, it is taken from the super table meta the points are applied to
+static STableMeta* getChildTableMetaFromLocalCache(SSqlObj* pSql, SName* pName, STableMeta* pSTableMeta) {
+  char fullTableName[TSDB_TABLE_FNAME_LEN] = {0};
+  tNameExtractFullName(pName, fullTableName);
+
+  STableMeta* pTableMeta = NULL;
+  size_t      size = 0;
+  taosHashGetCloneExt(UTIL_GET_TABLEMETA(pSql), fullTableName, strlen(fullTableName), NULL, (void**)&pTableMeta, &size);
+  if (pTableMeta == NULL) {
+    return NULL;
+  }
+
+  if (pTableMeta->tableType != TSDB_CHILD_TABLE || pTableMeta->suid != pSTableMeta->id.uid) {
+    free(pTableMeta);
+    return NULL;
+  }
+
+  int32_t     totalBytes = (pSTableMeta->tableInfo.numOfColumns + pSTableMeta->tableInfo.numOfTags) * sizeof(SSchema);
+  STableMeta* pChild = realloc(pTableMeta, sizeof(STableMeta) + totalBytes);
+  if (pChild == NULL) {
+    free(pTableMeta);
+    return NULL;
+  }
+
+  pChild->sversion = pSTableMeta->sversion;
+  pChild->tversion = pSTableMeta->tversion;
+  memcpy(&pChild->tableInfo, &pSTableMeta->tableInfo, sizeof(STableComInfo));
+  memcpy(pChild->schema, pSTableMeta->schema, totalBytes);
+  return pChild;
+}
+
+static int32_t loadChildTableMetas(TAOS* taos, SArray* cTables, SArray* tableIdxList, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  size_t  numTables = taosArrayGetSize(tableIdxList);
+
+  for (int32_t i = 0; i < numTables && code == TSDB_CODE_SUCCESS;) {
+    SArray* plist = taosArrayInit(4, POINTER_BYTES);
+    SArray* vgroupList = taosArrayInit(4, POINTER_BYTES);
+    for (; i < numTables && taosArrayGetSize(plist) < TSDB_MULTI_TABLEMETA_MAX_NUM; ++i) {
+      SSmlChildTable* cTable = taosArrayGet(cTables, *(int32_t*)taosArrayGet(tableIdxList, i));
+
+      char fullTableName[TSDB_TABLE_FNAME_LEN] = {0};
+      tNameExtractFullName(&cTable->name, fullTableName);
+      char* p = strdup(fullTableName);
+      taosArrayPush(plist, &p);
+    }
+
+    SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+    if (pSql == NULL || tscAllocPayload(&pSql->cmd, 1024) != TSDB_CODE_SUCCESS) {
+      tfree(pSql);
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+    } else {
+      tsem_init(&pSql->rspSem, 0, 0);
+      pSql->pTscObj = taos;
+      pSql->signature = pSql;
+      pSql->rootObj = pSql;
+      pSql->cmd.pTableMetaMap = taosHashInit(taosArrayGetSize(plist), taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY),
+                                             false, HASH_NO_LOCK);
+      registerSqlObj(pSql);
+      tscDebug("SML:0x%"PRIx64" load %zu child table metas by 0x%"PRIx64, info->id, taosArrayGetSize(plist), pSql->self);
+
+      code = getMultiTableMetaFromMnode(pSql, plist, vgroupList, NULL, loadMultiTableMetaCallback, false);
+      if (code == TSDB_CODE_TSC_ACTION_IN_PROGRESS) {
+        tsem_wait(&pSql->rspSem);
+        code = pSql->res.code;
+      }
+      tscFreeRegisteredSqlObj(pSql);
+    }
+
+    for (int32_t j = 0; j < taosArrayGetSize(plist); ++j) {
+      free(taosArrayGetP(plist, j));
+    }
+    taosArrayDestroy(&plist);
+    taosArrayDestroy(&vgroupList);
+  }
+
+  return code;
+}
+
+static int32_t addChildTableToCreateSql(SSmlChildTable* cTable, SSmlSTableSchema* sTableSchema, char* sql,
+                                        int32_t* sqlLen, int32_t capacity) {
   size_t  numTags = taosArrayGetSize(sTableSchema->tags);
-  size_t  numCols = taosArrayGetSize(sTableSchema->fields);
-  size_t  rows = taosArrayGetSize(cTablePoints);
+  size_t  rows = taosArrayGetSize(cTable->points);
   SArray* tagsSchema = sTableSchema->tags;
-  SArray* colsSchema = sTableSchema->fields;
 
   TAOS_SML_KV* tagKVs[TSDB_MAX_TAGS] = {0};
   for (int i = 0; i < rows; ++i) {
-    TAOS_SML_DATA_POINT* pDataPoint = taosArrayGetP(cTablePoints, i);
+    TAOS_SML_DATA_POINT* pDataPoint = taosArrayGetP(cTable->points, i);
     for (int j = 0; j < pDataPoint->tagNum; ++j) {
       TAOS_SML_KV* kv = pDataPoint->tags + j;
       tagKVs[kv->fieldSchemaIdx] = kv;
     }
   }
 
-  TAOS_SML_KV** colKVs = malloc(numCols * sizeof(TAOS_SML_KV*));
-  int r = fromIndex;
-
-  int32_t totalLen = 0;
-  int ret = 0;
-  ret = smlSnprintf(sql, &totalLen, capacity, " %s using %s (", cTableName, sTableName);
-  if (ret != 0) {
-    goto _cleanup;
-  }
-
-  for (int i = 0; i < numTags; ++i) {
+  TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, 0);
+  int ret = smlSnprintf(sql, sqlLen, capacity, " if not exists %s using %s (", cTable->tableName, point->stableName);
+  for (int i = 0; i < numTags && ret == 0; ++i) {
     SSchema* tagSchema = taosArrayGet(tagsSchema, i);
-    ret = smlSnprintf(sql, &totalLen, capacity, "%s,", tagSchema->name);
-    if (ret != 0) {
-      goto _cleanup;
-    }
+    ret = smlSnprintf(sql, sqlLen, capacity, "%s,", tagSchema->name);
   }
-  --totalLen;
-
-  ret = smlSnprintf(sql, &totalLen, capacity, ") tags (");
   if (ret != 0) {
-    goto _cleanup;
+    return ret;
   }
+  --(*sqlLen);
 
-  for (int i = 0; i < numTags; ++i) {
-    if (capacity - totalLen < TSDB_MAX_BYTES_PER_ROW) {
-      goto _cleanup;
+  ret = smlSnprintf(sql, sqlLen, capacity, ") tags (");
+  for (int i = 0; i < numTags && ret == 0; ++i) {
+    if (capacity - *sqlLen < TSDB_MAX_BYTES_PER_ROW) {
+      return -2;
     }
+
     if (tagKVs[i] == NULL) {
-      ret = smlSnprintf(sql, &totalLen, capacity, "NULL,");
-      if (ret != 0) {
-        goto _cleanup;
-      }
+      ret = smlSnprintf(sql, sqlLen, capacity, "NULL,");
     } else {
       TAOS_SML_KV* kv = tagKVs[i];
-      size_t       beforeLen = totalLen;
       int32_t      len = 0;
-      converToStr(sql + beforeLen, kv->type, kv->value, kv->length, &len);
-      totalLen += len;
-
-      ret = smlSnprintf(sql, &totalLen, capacity, ",");
-      if (ret != 0) {
-        goto _cleanup;
-      }
+      converToStr(sql + *sqlLen, kv->type, kv->value, kv->length, &len);
+      *sqlLen += len;
+      ret = smlSnprintf(sql, sqlLen, capacity, ",");
     }
   }
-  --totalLen;
-  ret = smlSnprintf(sql, &totalLen, capacity, ") (");
   if (ret != 0) {
-    goto _cleanup;
+    return ret;
   }
+  --(*sqlLen);
 
-  for (int i = 0; i < numCols; ++i) {
-    SSchema* colSchema = taosArrayGet(colsSchema, i);
-    ret = smlSnprintf(sql, &totalLen, capacity, "%s,", colSchema->name);
-    if (ret != 0) {
-      goto _cleanup;
-    }
-  }
-  --totalLen;
-  ret = smlSnprintf(sql, &totalLen, capacity, ") values ");
-  if (ret != 0) {
-    goto _cleanup;
+  return smlSnprintf(sql, sqlLen, capacity, ")");
+}
+
+static int32_t createChildTables(TAOS* taos, SArray* cTables, SArray* tableIdxList, SArray* stableSchemas,
+                                 SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  size_t  numTables = taosArrayGetSize(tableIdxList);
+
+  char* sql = malloc(tsMaxSQLStringLen + 1);
+  if (sql == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
 
-  for (; r < rows; ++r) {
-    if (capacity - totalLen < TSDB_MAX_BYTES_PER_ROW) {
-      break;
+  for (int32_t i = 0; i < numTables && code == TSDB_CODE_SUCCESS;) {
+    int32_t sqlLen = sprintf(sql, "create table");
+    int32_t num = 0;
+    for (; i < numTables; ++i, ++num) {
+      SSmlChildTable*      cTable = taosArrayGet(cTables, *(int32_t*)taosArrayGet(tableIdxList, i));
+      TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, 0);
+      SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
+
+      int32_t len = sqlLen;
+      if (addChildTableToCreateSql(cTable, sTableSchema, sql, &len, tsMaxSQLStringLen) != 0) {
+        break;
+      }
+      sqlLen = len;
     }
-    ret = smlSnprintf(sql, &totalLen, capacity, "(");
-    if (ret != 0) {
-      goto _cleanup;
+
+    if (num == 0) {
+      tscError("SML:0x%"PRIx64" sql to create child table is too long", info->id);
+      code = TSDB_CODE_TSC_EXCEED_SQL_LIMIT;
+      break;
     }
-    memset(colKVs, 0, numCols * sizeof(TAOS_SML_KV*));
 
-    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, r);
-    for (int i = 0; i < point->fieldNum; ++i) {
-      TAOS_SML_KV* kv = point->fields + i;
-      colKVs[kv->fieldSchemaIdx] = kv;
+    sql[sqlLen] = '\0';
+    tscDebug("SML:0x%"PRIx64" create %d child tables, sql: %s", info->id, num, sql);
+    TAOS_RES* res = taos_query(taos, sql);
+    code = taos_errno(res);
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%"PRIx64" create child tables failed: %s", info->id, taos_errstr(res));
     }
+    taos_free_result(res);
+  }
 
-    for (int i = 0; i < numCols; ++i) {
-      if (colKVs[i] == NULL) {
-        ret = smlSnprintf(sql, &totalLen, capacity, "NULL,");
-        if (ret != 0) {
-          goto _cleanup;
-        }
-      } else {
-        TAOS_SML_KV* kv = colKVs[i];
-        size_t       beforeLen = totalLen;
-        int32_t      len = 0;
-        converToStr(sql + beforeLen, kv->type, kv->value, kv->length, &len);
-        totalLen += len;
-        ret = smlSnprintf(sql, &totalLen, capacity, ",");
-        if (ret != 0) {
-          goto _cleanup;
-        }
-      }
+  free(sql);
+  return code;
+}
+
+/*
+ * fill the meta of the child tables from the local cache. The metas not cached are loaded from mnode in batches,
+ * and the tables still missing are created by the tags of their points before the metas are loaded again.
+ */
+static int32_t resolveChildTables(TAOS* taos, SArray* cTables, SArray* stableSchemas, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  size_t numStables = taosArrayGetSize(stableSchemas);
+  for (int32_t i = 0; i < numStables; ++i) {
+    SSmlSTableSchema* sTableSchema = taosArrayGet(stableSchemas, i);
+    tfree(sTableSchema->tableMeta);
+    code = retrieveTableMeta(taos, sTableSchema->sTableName, &sTableSchema->tableMeta, info);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = buildColumnIndex(sTableSchema, info);
     }
-    --totalLen;
-    ret = smlSnprintf(sql, &totalLen, capacity, ")");
-    if (ret != 0) {
-      goto _cleanup;
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
     }
   }
-_cleanup:
-  free(colKVs);
 
-  if (r == fromIndex) {
-    tscInfo("SML:0x%"PRIx64" Remaining buffer is not enough for line: %d of table %s. Allocate a new buffer to continue", info->id, fromIndex, cTableName);
-    *cTableSqlLen = 0;
-  } else {
-    *cTableSqlLen = totalLen;
+  SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
-  *nextIndex = r;
+  pSql->pTscObj = taos;
+  pSql->signature = pSql;
+  registerSqlObj(pSql);
 
-  return 0;
-}
+  size_t  numTables = taosArrayGetSize(cTables);
+  SArray* missing = taosArrayInit(8, sizeof(int32_t));
+  for (int32_t i = 0; i < numTables; ++i) {
+    SSmlChildTable*      cTable = taosArrayGet(cTables, i);
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, 0);
+    SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
 
-static void insertCallback(void *param, TAOS_RES *res, int32_t notUsedCode) {
-  SSmlSqlInsertBatch *batch = (SSmlSqlInsertBatch *)param;
-  batch->code = taos_errno(res);
+    tfree(cTable->tableMeta);
+    code = smlSetTableName(pSql, cTable->tableName, &cTable->name);
+    if (code != TSDB_CODE_SUCCESS) {
+      tscError("SML:0x%"PRIx64" invalid child table name: %s", info->id, cTable->tableName);
+      goto _end;
+    }
 
-  if (batch->code != 0) {
-    tscError("SML:0x%"PRIx64 " batch %d , taos_query_a return %d:%s", batch->id, batch->index, batch->code, taos_errstr(res));
+    cTable->tableMeta = getChildTableMetaFromLocalCache(pSql, &cTable->name, sTableSchema->tableMeta);
+    if (cTable->tableMeta == NULL) {
+      taosArrayPush(missing, &i);
+    }
   }
-  tscDebug("SML:0x%"PRIx64 " batch %d, taos_query inserted %d rows", batch->id, batch->index, taos_affected_rows(res));
-  batch->affectedRows = taos_affected_rows(res);
-  taos_free_result(res);
 
-  int32_t code = batch->code;
-  batch->tryAgain = false;
-  batch->resetQueryCache = false;
-  batch->sleep = false;
-  if ((code == TSDB_CODE_TDB_INVALID_TABLE_ID
-       || code == TSDB_CODE_VND_INVALID_VGROUP_ID
-       || code == TSDB_CODE_TDB_TABLE_RECONFIGURE
-       || code == TSDB_CODE_APP_NOT_READY
-       || code == TSDB_CODE_RPC_NETWORK_UNAVAIL) && batch->tryTimes < TSDB_MAX_REPLICA) {
-    batch->tryAgain = true;
-  }
+  for (int32_t round = 0; round < 2 && taosArrayGetSize(missing) > 0; ++round) {
+    if (round > 0) {
+      code = createChildTables(taos, cTables, missing, stableSchemas, info);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _end;
+      }
+    }
+
+    // mnode fails the batch if any table of it does not exist, the metas loaded are looked up in the cache anyway
+    code = loadChildTableMetas(taos, cTables, missing, info);
+
+    SArray* loaded = missing;
+    missing = taosArrayInit(8, sizeof(int32_t));
+    for (int32_t i = 0; i < taosArrayGetSize(loaded); ++i) {
+      int32_t              idx = *(int32_t*)taosArrayGet(loaded, i);
+      SSmlChildTable*      cTable = taosArrayGet(cTables, idx);
+      TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, 0);
+      SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
 
-  if (code == TSDB_CODE_TDB_INVALID_TABLE_ID || code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
-    batch->resetQueryCache = true;
-    if (batch->tryAgain) {
-      batch->sleep = true;
+      cTable->tableMeta = getChildTableMetaFromLocalCache(pSql, &cTable->name, sTableSchema->tableMeta);
+      if (cTable->tableMeta == NULL) {
+        taosArrayPush(missing, &idx);
+      }
     }
+    taosArrayDestroy(&loaded);
   }
 
-  if (code == TSDB_CODE_APP_NOT_READY || code == TSDB_CODE_RPC_NETWORK_UNAVAIL) {
-    if (batch->tryAgain) {
-      batch->sleep = true;
+  if (taosArrayGetSize(missing) > 0) {
+    SSmlChildTable* cTable = taosArrayGet(cTables, *(int32_t*)taosArrayGet(missing, 0));
+    tscError("SML:0x%"PRIx64" failed to get the meta of %zu child tables, such as %s. %s", info->id,
+             taosArrayGetSize(missing), cTable->tableName, tstrerror(code));
+    if (code == TSDB_CODE_SUCCESS) {
+      code = TSDB_CODE_TSC_INVALID_TABLE_NAME;
     }
+  } else {
+    code = TSDB_CODE_SUCCESS;
   }
 
-  tsem_post(&batch->sem);
+_end:
+  taosArrayDestroy(&missing);
+  taosReleaseRef(tscObjRef, pSql->self);
+  return code;
 }
 
-static int32_t applyDataPointsWithSqlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t numPoints, SArray* stableSchemas, SSmlLinesInfo* info) {
-  int32_t code = TSDB_CODE_SUCCESS;
+static SSqlObj* createSmlInsertObj(TAOS* taos, bool schemaAttached) {
+  SSqlObj* pSql = calloc(1, sizeof(SSqlObj));
+  if (pSql == NULL) {
+    return NULL;
+  }
 
-  SHashObj* cname2points = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
-  arrangePointsByChildTableName(points, numPoints, cname2points, stableSchemas, info);
+  if (tscAllocPayload(&pSql->cmd, TSDB_DEFAULT_PAYLOAD_SIZE) != TSDB_CODE_SUCCESS) {
+    free(pSql);
+    return NULL;
+  }
 
-  for (int i = 0; i < MAX_SML_SQL_INSERT_BATCHES; ++i) {
-    info->batches[i].id = info->id;
-    info->batches[i].index = i;
-    info->batches[i].sql = NULL;
-    info->batches[i].tryTimes = 0;
-    tsem_init(&info->batches[i].sem, 0, 0);
+  tsem_init(&pSql->rspSem, 0, 0);
+  pSql->signature = pSql;
+  pSql->pTscObj = taos;
+  pSql->rootObj = pSql;
+  pSql->param = pSql;
+  pSql->fp = waitForQueryRsp;
+  pSql->fetchFp = waitForQueryRsp;
+  pSql->maxRetry = TSDB_MAX_REPLICA;
+  pSql->retry = pSql->maxRetry + 1;  // no sql to parse again, the points are submitted again by the caller
+  registerSqlObj(pSql);
+
+  SSqlCmd* pCmd = &pSql->cmd;
+  pCmd->command = TSDB_SQL_INSERT;
+  pCmd->insertParam.insertType = TSDB_QUERY_TYPE_INSERT;
+  pCmd->insertParam.objectId = pSql->self;
+  pCmd->insertParam.schemaAttached = schemaAttached ? 1 : 0;
+  pCmd->insertParam.pTableBlockHashList =
+      taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
+
+  SQueryInfo* pQueryInfo = tscGetQueryInfoS(pCmd);
+  if (pQueryInfo == NULL || tscAddEmptyMetaInfo(pQueryInfo) == NULL ||
+      pCmd->insertParam.pTableBlockHashList == NULL) {
+    taos_free_result(pSql);
+    return NULL;
   }
+  TSDB_QUERY_SET_TYPE(pQueryInfo->type, TSDB_QUERY_TYPE_INSERT);
 
-  info->numBatches = 0;
-  SSmlSqlInsertBatch *batch = info->batches;
-  batch->sql = malloc(tsMaxSQLStringLen + 1);
-  int32_t freeBytes = tsMaxSQLStringLen;
-  int32_t usedBytes = sprintf(batch->sql, "insert into");
-  freeBytes -= usedBytes;
+  return pSql;
+}
 
-  int32_t cTableSqlLen = 0;
+static int32_t buildSmlRow(STableDataBlocks* pBlock, TAOS_SML_DATA_POINT* point, SSmlSTableSchema* sTableSchema,
+                           TAOS_SML_KV** colKVs, char* varBuf, SSmlLinesInfo* info) {
+  SParsedDataColInfo* spd = &pBlock->boundColumnInfo;
+  SMemRowBuilder*     pBuilder = &pBlock->rowBuilder;
+  SSchema*            pSchema = tscGetTableSchema(pBlock->pTableMeta);
+  SMemRow             row = pBlock->pData + pBlock->size;
 
-  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
-  while (pCTablePoints) {
-    SArray* cTablePoints = *pCTablePoints;
+  memset(colKVs, 0, spd->numOfCols * POINTER_BYTES);
+  for (int32_t i = 0; i < point->fieldNum; ++i) {
+    TAOS_SML_KV* kv = point->fields + i;
+    colKVs[sTableSchema->colIndex[kv->fieldSchemaIdx]] = kv;
+  }
 
-    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTablePoints, 0);
-    SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
+  initSMemRow(row, pBuilder->memRowType, pBlock, spd->numOfBound);
 
-    int32_t nextIndex = 0;
-    int32_t fromIndex = nextIndex;
-
-    while (nextIndex != taosArrayGetSize(cTablePoints)) {
-      fromIndex = nextIndex;
-      code = addChildTableDataPointsToInsertSql(point->childTableName, point->stableName, sTableSchema, cTablePoints,
-                                                batch->sql + usedBytes, freeBytes, &cTableSqlLen, fromIndex, &nextIndex,
-                                                info);
-      tscDebug("SML:0x%"PRIx64" add child table points to SQL. child table: %s of super table %s. range[%d-%d).",
-               info->id, point->childTableName, point->stableName, fromIndex, nextIndex);
-      usedBytes += cTableSqlLen;
-      freeBytes -= cTableSqlLen;
-      if (nextIndex != taosArrayGetSize(cTablePoints)) {
-        batch->sql[usedBytes] = '\0';
-        info->numBatches++;
-        tscDebug("SML:0x%"PRIx64" sql: %s" , info->id, batch->sql);
-
-        if (info->numBatches >= MAX_SML_SQL_INSERT_BATCHES) {
-          tscError("SML:0x%"PRIx64" Apply points failed. exceeds max sql insert batches", info->id);
-          code = TSDB_CODE_TSC_OUT_OF_MEMORY;
-          goto cleanup;
-        }
+  for (int32_t i = 0; i < spd->numOfBound; ++i) {
+    int32_t toffset = -1;
+    int16_t colId = -1;
+    tscGetMemRowAppendInfo(pSchema, pBuilder->memRowType, spd, i, &toffset, &colId);
+
+    SSchema*     pColSchema = pSchema + spd->boundedColumns[i];
+    TAOS_SML_KV* kv = colKVs[spd->boundedColumns[i]];
+    const void*  value = NULL;
 
-        batch = &info->batches[info->numBatches];
-        batch->sql = malloc(tsMaxSQLStringLen + 1);
-        freeBytes = tsMaxSQLStringLen;
-        usedBytes = sprintf(batch->sql, "insert into");
-        freeBytes -= usedBytes;
+    if (kv == NULL) {
+      value = getNullValue(pColSchema->type);
+    } else if (kv->type != pColSchema->type) {
+      tscError("SML:0x%"PRIx64" point type and db type mismatch. key: %s. point type: %d, db type: %d", info->id,
+               kv->key, kv->type, pColSchema->type);
+      return TSDB_CODE_TSC_INVALID_VALUE;
+    } else if (kv->type == TSDB_DATA_TYPE_BINARY) {
+      if (kv->length > pColSchema->bytes - VARSTR_HEADER_SIZE) {
+        tscError("SML:0x%"PRIx64" value of %s is too long, length: %d", info->id, kv->key, kv->length);
+        return TSDB_CODE_TSC_INVALID_VALUE;
+      }
+      STR_WITH_SIZE_TO_VARSTR(varBuf, kv->value, kv->length);
+      value = varBuf;
+    } else if (kv->type == TSDB_DATA_TYPE_NCHAR) {
+      int32_t len = 0;
+      if (!taosMbsToUcs4(kv->value, kv->length, varDataVal(varBuf), pColSchema->bytes - VARSTR_HEADER_SIZE, &len)) {
+        tscError("SML:0x%"PRIx64" failed to convert value of %s to nchar, length: %d", info->id, kv->key, kv->length);
+        return TSDB_CODE_TSC_INVALID_VALUE;
       }
+      varDataSetLen(varBuf, len);
+      value = varBuf;
+    } else {
+      value = kv->value;
     }
 
-    pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
+    tdAppendMemRowColVal(row, value, true, colId, pColSchema->type, toffset);
   }
-  batch->sql[usedBytes] = '\0';
-  info->numBatches++;
-  tscDebug("SML:0x%"PRIx64" sql: %s" , info->id, batch->sql);
-  if (info->numBatches >= MAX_SML_SQL_INSERT_BATCHES) {
-    tscError("SML:0x%"PRIx64" Apply points failed. exceeds max sql insert batches", info->id);
-    code = TSDB_CODE_TSC_OUT_OF_MEMORY;
-    goto cleanup;
+
+  TSKEY tsKey = memRowKey(row);
+  if (tsCheckTimestamp(pBlock, (const char *)&tsKey) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_TSC_INVALID_TIME_STAMP;
   }
-  bool batchesExecuted[MAX_SML_SQL_INSERT_BATCHES] = {false};
 
-  for (int i = 0; i < info->numBatches; ++i) {
-    SSmlSqlInsertBatch* insertBatch = &info->batches[i];
-    insertBatch->tryTimes = 1;
-    taos_query_a(taos, insertBatch->sql, insertCallback, insertBatch);
-    batchesExecuted[i] = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * encode the points of a child table from fromRow into its submit block, until the block is full or the encoded rows
+ * exceed maxBytes. One row is encoded at least.
+ */
+static int32_t buildSmlSubmitBlock(SSqlObj* pSql, SSmlChildTable* cTable, SSmlSTableSchema* sTableSchema,
+                                   int32_t fromRow, int32_t maxBytes, char* varBuf, int32_t* numOfRows,
+                                   int32_t* numOfBytes, SSmlLinesInfo* info) {
+  STableMeta*       pTableMeta = cTable->tableMeta;
+  STableDataBlocks* pBlock = NULL;
+
+  int32_t code = tscGetDataBlockFromList(pSql->cmd.insertParam.pTableBlockHashList, pTableMeta->id.uid,
+                                         TSDB_DEFAULT_PAYLOAD_SIZE, sizeof(SSubmitBlk), tscGetTableInfo(pTableMeta).rowSize,
+                                         &cTable->name, pTableMeta, &pBlock, NULL);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t extendedRowSize = getExtendedRowSize(pBlock);
+  initMemRowBuilder(&pBlock->rowBuilder, 0, &pBlock->boundColumnInfo);
+  pBlock->rowBuilder.rowSize = extendedRowSize;
+
+  TAOS_SML_KV** colKVs = malloc(pBlock->boundColumnInfo.numOfCols * POINTER_BYTES);
+  if (colKVs == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
-  int32_t triedBatches = info->numBatches;
 
-  while (triedBatches > 0) {
-    for (int i = 0; i < info->numBatches; ++i) {
-      if (batchesExecuted[i]) {
-        tsem_wait(&info->batches[i].sem);
-        info->affectedRows += info->batches[i].affectedRows;
+  SSubmitBlk* pBlk = (SSubmitBlk*)pBlock->pData;
+  int32_t     rows = (int32_t)MIN(taosArrayGetSize(cTable->points) - fromRow, SML_MAX_ROWS_PER_BLOCK - pBlk->numOfRows);
+  int32_t     bytes = 0;
+  int32_t     r = 0;
+
+  for (; r < rows && (r == 0 || bytes < maxBytes); ++r) {
+    if (pBlock->nAllocSize - pBlock->size < extendedRowSize) {
+      uint32_t nAllocSize = (uint32_t)(pBlock->nAllocSize * 1.5) + extendedRowSize;
+      char*    tmp = realloc(pBlock->pData, nAllocSize);
+      if (tmp == NULL) {
+        code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+        break;
       }
+
+      memset(tmp + pBlock->size, 0, nAllocSize - pBlock->size);
+      pBlock->pData = tmp;
+      pBlock->nAllocSize = nAllocSize;
     }
 
-    for (int i = 0; i < info->numBatches; ++i) {
-      SSmlSqlInsertBatch* b = info->batches + i;
-      if (b->resetQueryCache) {
-        TAOS_RES* res = taos_query(taos, "RESET QUERY CACHE");
-        taos_free_result(res);
+    TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, fromRow + r);
+    code = buildSmlRow(pBlock, point, sTableSchema, colKVs, varBuf, info);
+    if (code != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    bytes += memRowTLen(pBlock->pData + pBlock->size);
+    pBlock->size += extendedRowSize;
+  }
+  free(colKVs);
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tsSetBlockInfo((SSubmitBlk*)pBlock->pData, pTableMeta, r);
+    pBlock->numOfTables = 1;
+  }
+
+  *numOfRows = r;
+  *numOfBytes = bytes;
+  return code;
+}
+
+/*
+ * submit the points of the child tables from pPos, the rows are packed into submit blocks per vnode. A submit is sent
+ * once the encoded rows reach maxSQLLength, the same size the batches of sql took before. pPos is moved forward after
+ * each successful submit, so a retry begins from the failed one.
+ */
+static int32_t submitChildTables(TAOS* taos, SArray* cTables, SArray* stableSchemas, SSmlSubmitPos* pPos,
+                                 bool schemaAttached, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  size_t  numTables = taosArrayGetSize(cTables);
+
+  char* varBuf = malloc(TSDB_MAX_BYTES_PER_ROW);
+  if (varBuf == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  while (pPos->table < numTables && code == TSDB_CODE_SUCCESS) {
+    SSqlObj* pSql = createSmlInsertObj(taos, schemaAttached);
+    if (pSql == NULL) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      break;
+    }
+
+    SSmlSubmitPos pos = *pPos;
+    int32_t       bytes = 0;
+    while (pos.table < numTables && bytes < tsMaxSQLStringLen) {
+      SSmlChildTable*      cTable = taosArrayGet(cTables, pos.table);
+      TAOS_SML_DATA_POINT* point = taosArrayGetP(cTable->points, 0);
+      SSmlSTableSchema*    sTableSchema = taosArrayGet(stableSchemas, point->schemaIdx);
+
+      int32_t numOfRows = 0;
+      int32_t numOfBytes = 0;
+      code = buildSmlSubmitBlock(pSql, cTable, sTableSchema, pos.row, tsMaxSQLStringLen - bytes, varBuf, &numOfRows,
+                                 &numOfBytes, info);
+      if (code != TSDB_CODE_SUCCESS) {
         break;
       }
-    }
 
-    for (int i = 0; i < info->numBatches; ++i) {
-      SSmlSqlInsertBatch* b = info->batches + i;
-      if (b->sleep) {
-        taosMsleep(100 * (2 << b->tryTimes));
+      bytes += numOfBytes;
+      pos.row += numOfRows;
+      if (pos.row < taosArrayGetSize(cTable->points)) {
         break;
       }
+
+      pos.table += 1;
+      pos.row = 0;
+    }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tscMergeTableDataBlocks(pSql, &pSql->cmd.insertParam, true);
     }
 
-    memset(batchesExecuted, 0, sizeof(batchesExecuted));
-    triedBatches = 0;
-    for (int i = 0; i < info->numBatches; ++i) {
-      SSmlSqlInsertBatch* insertBatch = &info->batches[i];
-      if (insertBatch->tryAgain) {
-        insertBatch->tryTimes++;
-        taos_query_a(taos, insertBatch->sql, insertCallback, insertBatch);
-        batchesExecuted[i] = true;
-        triedBatches++;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tscHandleMultivnodeInsert(pSql);
+      if (code == TSDB_CODE_SUCCESS) {
+        tsem_wait(&pSql->rspSem);
+        code = pSql->res.code;
       }
     }
-  }
 
-  code = 0;
-  for (int i = 0; i < info->numBatches; ++i) {
-    SSmlSqlInsertBatch* b = info->batches + i;
-    if (b->code != 0) {
-      code = b->code;
+    if (code == TSDB_CODE_SUCCESS) {
+      tscDebug("SML:0x%"PRIx64" submit 0x%"PRIx64" inserted %d rows, %d bytes", info->id, pSql->self,
+               pSql->res.numOfRows, bytes);
+      info->affectedRows += pSql->res.numOfRows;
+      *pPos = pos;
+    } else {
+      tscError("SML:0x%"PRIx64" submit 0x%"PRIx64" failed: %s", info->id, pSql->self, tstrerror(code));
     }
+
+    taos_free_result(pSql);
   }
 
-cleanup:
-  for (int i = 0; i < MAX_SML_SQL_INSERT_BATCHES; ++i) {
-    free(info->batches[i].sql);
-    info->batches[i].sql = NULL;
-    tsem_destroy(&info->batches[i].sem);
+  free(varBuf);
+  return code;
+}
+
+static int32_t applyDataPointsWithSubmitBlocks(TAOS* taos, TAOS_SML_DATA_POINT* points, int32_t numPoints,
+                                               SArray* stableSchemas, SSmlLinesInfo* info) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (!((STscObj*)taos)->writeAuth) {
+    return TSDB_CODE_TSC_NO_WRITE_AUTH;
   }
 
-  pCTablePoints = taosHashIterate(cname2points, NULL);
+  SHashObj* cname2points = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
+  arrangePointsByChildTableName(points, numPoints, cname2points, stableSchemas, info);
+
+  SArray*  cTables = taosArrayInit(taosHashGetSize(cname2points), sizeof(SSmlChildTable));
+  SArray** pCTablePoints = taosHashIterate(cname2points, NULL);
   while (pCTablePoints) {
-    SArray* pPoints = *pCTablePoints;
-    taosArrayDestroy(&pPoints);
+    SSmlChildTable cTable = {0};
+    cTable.points = *pCTablePoints;
+    cTable.tableName = ((TAOS_SML_DATA_POINT*)taosArrayGetP(cTable.points, 0))->childTableName;
+    taosArrayPush(cTables, &cTable);
     pCTablePoints = taosHashIterate(cname2points, pCTablePoints);
   }
   taosHashCleanup(cname2points);
+
+  SSmlSubmitPos pos = {0};
+  bool          schemaAttached = false;
+  for (int32_t tryTimes = 1;; ++tryTimes) {
+    code = resolveChildTables(taos, cTables, stableSchemas, info);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = submitChildTables(taos, cTables, stableSchemas, &pos, schemaAttached, info);
+    }
+
+    if ((code != TSDB_CODE_TDB_INVALID_TABLE_ID && code != TSDB_CODE_VND_INVALID_VGROUP_ID &&
+         code != TSDB_CODE_TDB_TABLE_RECONFIGURE && code != TSDB_CODE_APP_NOT_READY &&
+         code != TSDB_CODE_RPC_NETWORK_UNAVAIL) || tryTimes >= TSDB_MAX_REPLICA) {
+      break;
+    }
+
+    tscWarn("SML:0x%"PRIx64" submit points failed, try again. tries: %d, reason: %s", info->id, tryTimes,
+            tstrerror(code));
+    if (code == TSDB_CODE_TDB_INVALID_TABLE_ID || code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
+      TAOS_RES* res = taos_query(taos, "RESET QUERY CACHE");
+      taos_free_result(res);
+    }
+
+    if (code == TSDB_CODE_TDB_TABLE_RECONFIGURE) {
+      schemaAttached = true;
+    } else {
+      int32_t waitMs = 100 * (2 << tryTimes);
+      if (waitMs > SML_MAX_RETRY_WAIT_MS) {
+        waitMs = SML_MAX_RETRY_WAIT_MS;
+      }
+      taosMsleep(waitMs);
+    }
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(cTables); ++i) {
+    SSmlChildTable* cTable = taosArrayGet(cTables, i);
+    tfree(cTable->tableMeta);
+    taosArrayDestroy(&cTable->points);
+  }
+  taosArrayDestroy(&cTables);
   return code;
 }
 
-static int doSmlInsertOneDataPoint(TAOS* taos, TAOS_SML_DATA_POINT* point, SSmlLinesInfo* info) {
+int tscSmlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int numPoint, SSmlLinesInfo* info) {
+  tscDebug("SML:0x%"PRIx64" taos_sml_insert. number of points: %d", info->id, numPoint);
+
   int32_t code = TSDB_CODE_SUCCESS;
 
-  if (!point->childTableName) {
-    int tableNameLen = TSDB_TABLE_NAME_LEN;
-    point->childTableName = calloc(1, tableNameLen + 1);
-    getSmlMd5ChildTableName(point, point->childTableName, &tableNameLen, info);
-    point->childTableName[tableNameLen] = '\0';
+  info->affectedRows = 0;
+
+  tscDebug("SML:0x%"PRIx64" build data point schemas", info->id);
+  SArray* stableSchemas = taosArrayInit(32, sizeof(SSmlSTableSchema)); // SArray<STableColumnsSchema>
+  code = buildDataPointSchemas(points, numPoint, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error building data point schemas : %s", info->id, tstrerror(code));
+    goto clean_up;
   }
 
-  STableMeta* tableMeta = NULL;
-  int32_t ret = getSuperTableMetaFromLocalCache(taos, point->stableName, &tableMeta, info);
-  if (ret != TSDB_CODE_SUCCESS) {
-    return ret;
+  tscDebug("SML:0x%"PRIx64" modify db schemas", info->id);
+  code = modifyDBSchemas(taos, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error change db schema : %s", info->id, tstrerror(code));
+    goto clean_up;
   }
-  uint8_t precision = tableMeta->tableInfo.precision;
-  free(tableMeta);
 
-  char* sql = malloc(tsMaxSQLStringLen + 1);
-  if (sql == NULL) {
-    tscError("SML:0x%" PRIx64 " failed to allocate memory for sql", info->id);
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  tscDebug("SML:0x%"PRIx64" apply data points", info->id);
+  code = applyDataPointsWithSubmitBlocks(taos, points, numPoint, stableSchemas, info);
+  if (code != 0) {
+    tscError("SML:0x%"PRIx64" error apply data points : %s", info->id, tstrerror(code));
   }
-  int   freeBytes = tsMaxSQLStringLen;
-  int   sqlLen = 0;
-  int   retLen;
-  sqlLen += snprintf(sql + sqlLen, freeBytes - sqlLen, "insert into %s(", point->childTableName);
-  for (int col = 0; col < point->fieldNum; ++col) {
-    TAOS_SML_KV* kv = point->fields + col;
-    retLen = snprintf(sql + sqlLen, freeBytes - sqlLen, "%s,", kv->key);
-    if (retLen >= freeBytes - sqlLen) {
-      tscError("SML:0x%" PRIx64 " no free space for building sql key", info->id);
-      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+
+clean_up:
+  for (int i = 0; i < taosArrayGetSize(stableSchemas); ++i) {
+    SSmlSTableSchema* schema = taosArrayGet(stableSchemas, i);
+    taosArrayDestroy(&schema->fields);
+    taosArrayDestroy(&schema->tags);
+    tfree(schema->tableMeta);
+    tfree(schema->colIndex);
+  }
+  taosArrayDestroy(&stableSchemas);
+  return code;
+}
+
+//=========================================================================
+
+/*        Field                          Escape charaters
+    1: measurement                        Comma,Space
+    2: tag_key, tag_value, field_key  Comma,Equal Sign,Space
+    3: field_value                    Double quote,Backslash
+*/
+/* --------------------------------------------Line Protocol Scanner
+ * The tokenizer stops at the characters below, the runs of other characters between them are skipped or copied at
+ * once. smlSkipPlainCharsFp is picked by tscResolveSmlScanner() according to the CPU features, it finds the end of a
+ * run 32 bytes at a time by AVX2.
+ */
+static const uint8_t smlSpecialChars[256] = {['\0'] = 1, [','] = 1, ['='] = 1, [' '] = 1,
+                                             ['"'] = 1,  ['\\'] = 1, ['L'] = 1};
+
+static const char *smlSkipPlainCharsScalar(const char *cur, const char *end) {
+  while (cur < end && !smlSpecialChars[(uint8_t)*cur]) {
+    ++cur;
+  }
+  return cur;
+}
+
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__) && !defined(WINDOWS)
+#define TS_SML_SCAN_AVX2
+#endif
+
+#ifdef TS_SML_SCAN_AVX2
+#include <immintrin.h>
+
+// the line is terminated at end, so there is no '\0' before it
+__attribute__((target("avx2"))) static const char *smlSkipPlainCharsAvx2(const char *cur, const char *end) {
+  const __m256i comma = _mm256_set1_epi8(',');
+  const __m256i equal = _mm256_set1_epi8('=');
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i slash = _mm256_set1_epi8('\\');
+  const __m256i ell = _mm256_set1_epi8('L');
+
+  while (end - cur >= 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)cur);
+    __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, equal)),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, quote)));
+    m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(v, slash), _mm256_cmpeq_epi8(v, ell)));
+
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+    if (mask != 0) {
+      return cur + __builtin_ctz(mask);
     }
-    sqlLen += retLen;
+    cur += 32;
   }
-  --sqlLen;
-  retLen += snprintf(sql + sqlLen, freeBytes - sqlLen, ") values (");
-  if (retLen >= freeBytes - sqlLen) {
-    tscError("SML:0x%" PRIx64 " no free space for building sql", info->id);
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+
+  return smlSkipPlainCharsScalar(cur, end);
+}
+#endif
+
+static const char *(*smlSkipPlainCharsFp)(const char *, const char *) = smlSkipPlainCharsScalar;
+
+void tscResolveSmlScanner() {
+#ifdef TS_SML_SCAN_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    smlSkipPlainCharsFp = smlSkipPlainCharsAvx2;
+    return;
   }
-  sqlLen += retLen;
-  TAOS_SML_KV* tsField = point->fields + 0;
-  int64_t      ts = *(int64_t*)(tsField->value);
-  ts = convertTimePrecision(ts, TSDB_TIME_PRECISION_NANO, precision);
-  retLen = snprintf(sql + sqlLen, freeBytes - sqlLen, "%" PRId64 ",", ts);
-  if (retLen >= freeBytes - sqlLen) {
-    tscError("SML:0x%" PRIx64 " no free space for building timestamp", info->id);
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+#endif
+  smlSkipPlainCharsFp = smlSkipPlainCharsScalar;
+}
+
+/* --------------------------------------------Number Parsers
+ * The values are parsed from the line by length, there is no '\0' behind them.
+ */
+static const double smlPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// [+-]?[0-9]+, false if there is no digit or the value is out of the range of uint64
+static bool smlParseDigits(const char *str, int32_t len, bool *neg, uint64_t *pVal) {
+  const char *p = str;
+  const char *end = str + len;
+
+  *neg = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    *neg = (*p == '-');
+    ++p;
+  }
+
+  if (p == end) {
+    return false;
+  }
+
+  uint64_t val = 0;
+  for (; p < end; ++p) {
+    uint8_t d = (uint8_t)(*p - '0');
+    if (d > 9 || val > (UINT64_MAX - d) / 10) {
+      return false;
+    }
+    val = val * 10 + d;
+  }
+
+  *pVal = val;
+  return true;
+}
+
+static bool smlParseInt64(const char *str, int32_t len, int64_t *pVal) {
+  bool     neg = false;
+  uint64_t val = 0;
+  if (!smlParseDigits(str, len, &neg, &val)) {
+    return false;
   }
-  sqlLen += retLen;
-  for (int col = 1; col < point->fieldNum; ++col) {
-    TAOS_SML_KV* kv = point->fields + col;
-    int32_t      len = 0;
 
-    if (freeBytes - sqlLen <= kv->length) {
-      tscError("SML:0x%" PRIx64 " no free space for converToStr", info->id);
-      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  if (neg) {
+    if (val > (uint64_t)INT64_MAX + 1) {
+      return false;
     }
-    converToStr(sql + sqlLen, kv->type, kv->value, kv->length, &len);
-    sqlLen += len;
-    retLen = snprintf(sql + sqlLen, freeBytes - sqlLen, ",");
-    if (retLen >= freeBytes - sqlLen) {
-      tscError("SML:0x%" PRIx64 " no free space for building sql comma", info->id);
-      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    *pVal = (val == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)val;
+  } else {
+    if (val > INT64_MAX) {
+      return false;
     }
-    sqlLen += retLen;
-  }
-  --sqlLen;
-  retLen = snprintf(sql + sqlLen, freeBytes - sqlLen, ")");
-  if (retLen >= freeBytes - sqlLen) {
-    tscError("SML:0x%" PRIx64 " no free space for building the last right parenthesis", info->id);
-    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    *pVal = (int64_t)val;
   }
-  sqlLen += retLen;
-  sql[sqlLen] = 0;
-
-  tscDebug("SML:0x%" PRIx64 " insert child table table %s of super table %s sql: %s", info->id,
-           point->childTableName, point->stableName, sql);
-  TAOS_RES* res = taos_query(taos, sql);
-  free(sql);
-  code = taos_errno(res);
-  info->affectedRows = taos_affected_rows(res);
-  taos_free_result(res);
-
-  return code;
+  return true;
 }
 
-int tscSmlInsert(TAOS* taos, TAOS_SML_DATA_POINT* points, int numPoint, SSmlLinesInfo* info) {
-  tscDebug("SML:0x%"PRIx64" taos_sml_insert. number of points: %d", info->id, numPoint);
+static bool smlParseUint64(const char *str, int32_t len, uint64_t *pVal) {
+  bool neg = false;
+  if (!smlParseDigits(str, len, &neg, pVal)) {
+    return false;
+  }
+  return !neg || *pVal == 0;
+}
 
-  int32_t code = TSDB_CODE_SUCCESS;
+/*
+ * [+-]?[0-9]*(\.[0-9]+)?([eE][+-]?[0-9]+)? with at least one digit before the exponent, the same as isValidFloat.
+ * If the significant digits fit in 53 bits and the power of 10 is at most 22, the value is exactly rounded by one
+ * multiplication or division. The others, which are rare, are left to strtod.
+ */
+static bool smlParseDouble(const char *str, int32_t len, double *pVal) {
+  const char *p = str;
+  const char *end = str + len;
+  bool        neg = false;
+
+  if (p < end && (*p == '+' || *p == '-')) {
+    neg = (*p == '-');
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int32_t  numOfDigits = 0;
+  int32_t  significant = 0;
+  int32_t  exp10 = 0;
+  bool     exact = true;
+
+  for (; p < end && isdigit((uint8_t)*p); ++p, ++numOfDigits) {
+    if (significant < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      significant += (mantissa != 0);
+    } else {
+      exact = false;
+    }
+  }
 
-  info->affectedRows = 0;
+  if (p < end && *p == '.') {
+    ++p;
+    if (p == end || !isdigit((uint8_t)*p)) {
+      return false;
+    }
 
-  if (numPoint == 1) {
-    TAOS_SML_DATA_POINT* point = points + 0;
-    code = doSmlInsertOneDataPoint(taos, point, info);
-    if (code == TSDB_CODE_SUCCESS) {
-      return code;
+    for (; p < end && isdigit((uint8_t)*p); ++p, ++numOfDigits) {
+      if (significant < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        significant += (mantissa != 0);
+        exp10 -= 1;
+      } else {
+        exact = false;
+      }
     }
   }
 
-  tscDebug("SML:0x%"PRIx64" build data point schemas", info->id);
-  SArray* stableSchemas = taosArrayInit(32, sizeof(SSmlSTableSchema)); // SArray<STableColumnsSchema>
-  code = buildDataPointSchemas(points, numPoint, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error building data point schemas : %s", info->id, tstrerror(code));
-    goto clean_up;
+  if (numOfDigits == 0) {
+    return false;
   }
 
-  tscDebug("SML:0x%"PRIx64" modify db schemas", info->id);
-  code = modifyDBSchemas(taos, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error change db schema : %s", info->id, tstrerror(code));
-    goto clean_up;
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool expNeg = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      expNeg = (*p == '-');
+      ++p;
+    }
+
+    if (p == end) {
+      return false;
+    }
+
+    int32_t e = 0;
+    for (; p < end && isdigit((uint8_t)*p); ++p) {
+      if (e < 100000) {
+        e = e * 10 + (*p - '0');
+      }
+    }
+    exp10 += expNeg ? -e : e;
   }
 
-  tscDebug("SML:0x%"PRIx64" apply data points", info->id);
-  code = applyDataPointsWithSqlInsert(taos, points, numPoint, stableSchemas, info);
-  if (code != 0) {
-    tscError("SML:0x%"PRIx64" error apply data points : %s", info->id, tstrerror(code));
+  if (p != end) {
+    return false;
   }
 
-clean_up:
-  for (int i = 0; i < taosArrayGetSize(stableSchemas); ++i) {
-    SSmlSTableSchema* schema = taosArrayGet(stableSchemas, i);
-    taosArrayDestroy(&schema->fields);
-    taosArrayDestroy(&schema->tags);
+  double val = 0.0;
+  if (mantissa == 0) {
+    val = 0.0;
+  } else if (exact && mantissa <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+    val = (exp10 >= 0) ? (double)mantissa * smlPow10[exp10] : (double)mantissa / smlPow10[-exp10];
+  } else {
+    char  buf[64];
+    char *s = (len < (int32_t)sizeof(buf)) ? buf : malloc(len + 1);
+    if (s == NULL) {
+      return false;
+    }
+
+    memcpy(s, str, len);
+    s[len] = '\0';
+    errno = 0;
+    *pVal = strtod(s, NULL);
+    bool outOfRange = (errno == ERANGE);
+    if (s != buf) {
+      free(s);
+    }
+    return !outOfRange;
   }
-  taosArrayDestroy(&stableSchemas);
-  return code;
-}
 
-//=========================================================================
+  *pVal = neg ? -val : val;
+  return true;
+}
 
-/*        Field                          Escape charaters
-    1: measurement                        Comma,Space
-    2: tag_key, tag_value, field_key  Comma,Equal Sign,Space
-    3: field_value                    Double quote,Backslash
-*/
 static void escapeSpecialCharacter(uint8_t field, const char **pos) {
   const char *cur = *pos;
   if (*cur != '\\') {
@@ -1389,7 +1921,7 @@ bool isValidFloat(char *str) {
   return true;
 }
 
-static bool isInteger(char *pVal, uint16_t len, bool *has_sign) {
+static bool isInteger(const char *pVal, uint16_t len, bool *has_sign) {
   if (len <= 1) {
     return false;
   }
@@ -1405,147 +1937,147 @@ static bool isInteger(char *pVal, uint16_t len, bool *has_sign) {
   return false;
 }
 
-static bool isTinyInt(char *pVal, uint16_t len) {
+static bool isTinyInt(const char *pVal, uint16_t len) {
   if (len <= 2) {
     return false;
   }
-  if (!strcasecmp(&pVal[len - 2], "i8")) {
+  if (!strncasecmp(&pVal[len - 2], "i8", 2)) {
     //printf("Type is int8(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isTinyUint(char *pVal, uint16_t len) {
+static bool isTinyUint(const char *pVal, uint16_t len) {
   if (len <= 2) {
     return false;
   }
   if (pVal[0] == '-') {
     return false;
   }
-  if (!strcasecmp(&pVal[len - 2], "u8")) {
+  if (!strncasecmp(&pVal[len - 2], "u8", 2)) {
     //printf("Type is uint8(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isSmallInt(char *pVal, uint16_t len) {
+static bool isSmallInt(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
-  if (!strcasecmp(&pVal[len - 3], "i16")) {
+  if (!strncasecmp(&pVal[len - 3], "i16", 3)) {
     //printf("Type is int16(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isSmallUint(char *pVal, uint16_t len) {
+static bool isSmallUint(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
   if (pVal[0] == '-') {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "u16") == 0) {
+  if (strncasecmp(&pVal[len - 3], "u16", 3) == 0) {
     //printf("Type is uint16(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isInt(char *pVal, uint16_t len) {
+static bool isInt(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "i32") == 0) {
+  if (strncasecmp(&pVal[len - 3], "i32", 3) == 0) {
     //printf("Type is int32(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isUint(char *pVal, uint16_t len) {
+static bool isUint(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
   if (pVal[0] == '-') {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "u32") == 0) {
+  if (strncasecmp(&pVal[len - 3], "u32", 3) == 0) {
     //printf("Type is uint32(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isBigInt(char *pVal, uint16_t len) {
+static bool isBigInt(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "i64") == 0) {
+  if (strncasecmp(&pVal[len - 3], "i64", 3) == 0) {
     //printf("Type is int64(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isBigUint(char *pVal, uint16_t len) {
+static bool isBigUint(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
   if (pVal[0] == '-') {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "u64") == 0) {
+  if (strncasecmp(&pVal[len - 3], "u64", 3) == 0) {
     //printf("Type is uint64(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isFloat(char *pVal, uint16_t len) {
+static bool isFloat(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "f32") == 0) {
+  if (strncasecmp(&pVal[len - 3], "f32", 3) == 0) {
     //printf("Type is float(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isDouble(char *pVal, uint16_t len) {
+static bool isDouble(const char *pVal, uint16_t len) {
   if (len <= 3) {
     return false;
   }
-  if (strcasecmp(&pVal[len - 3], "f64") == 0) {
+  if (strncasecmp(&pVal[len - 3], "f64", 3) == 0) {
     //printf("Type is double(%s)\n", pVal);
     return true;
   }
   return false;
 }
 
-static bool isBool(char *pVal, uint16_t len, bool *bVal) {
-  if ((len == 1) && !strcasecmp(&pVal[len - 1], "t")) {
+static bool isBool(const char *pVal, uint16_t len, bool *bVal) {
+  if ((len == 1) && !strncasecmp(&pVal[len - 1], "t", 1)) {
     //printf("Type is bool(%c)\n", pVal[len - 1]);
     *bVal = true;
     return true;
   }
 
-  if ((len == 1) && !strcasecmp(&pVal[len - 1], "f")) {
+  if ((len == 1) && !strncasecmp(&pVal[len - 1], "f", 1)) {
     //printf("Type is bool(%c)\n", pVal[len - 1]);
     *bVal = false;
     return true;
   }
 
-  if((len == 4) && !strcasecmp(&pVal[len - 4], "true")) {
+  if((len == 4) && !strncasecmp(&pVal[len - 4], "true", 4)) {
     //printf("Type is bool(%s)\n", &pVal[len - 4]);
     *bVal = true;
     return true;
   }
-  if((len == 5) && !strcasecmp(&pVal[len - 5], "false")) {
+  if((len == 5) && !strncasecmp(&pVal[len - 5], "false", 5)) {
     //printf("Type is bool(%s)\n", &pVal[len - 5]);
     *bVal = false;
     return true;
@@ -1553,7 +2085,7 @@ static bool isBool(char *pVal, uint16_t len, bool *bVal) {
   return false;
 }
 
-static bool isBinary(char *pVal, uint16_t len) {
+static bool isBinary(const char *pVal, uint16_t len) {
   //binary: "abc"
   if (len < 2) {
     return false;
@@ -1566,7 +2098,7 @@ static bool isBinary(char *pVal, uint16_t len) {
   return false;
 }
 
-static bool isNchar(char *pVal, uint16_t len) {
+static bool isNchar(const char *pVal, uint16_t len) {
   //nchar: L"abc"
   if (len < 3) {
     return false;
@@ -1578,7 +2110,7 @@ static bool isNchar(char *pVal, uint16_t len) {
   return false;
 }
 
-static int32_t isTimeStamp(char *pVal, uint16_t len, SMLTimeStampType *tsType, SSmlLinesInfo* info) {
+static int32_t isTimeStamp(const char *pVal, uint16_t len, SMLTimeStampType *tsType, SSmlLinesInfo* info) {
   if (len == 0) {
     return TSDB_CODE_SUCCESS;
   }
@@ -1639,108 +2171,100 @@ static int32_t isTimeStamp(char *pVal, uint16_t len, SMLTimeStampType *tsType, S
   //return false;
 }
 
-static bool convertStrToNumber(TAOS_SML_KV *pVal, char *str, SSmlLinesInfo* info) {
-  errno = 0;
+static bool convertStrToNumber(TAOS_SML_KV *pVal, const char *str, int32_t len, SSmlLinesInfo* info) {
   uint8_t type = pVal->type;
   int16_t length = pVal->length;
   int64_t val_s = 0;
   uint64_t val_u = 0;
   double val_d = 0.0;
+  bool valid = false;
 
-  strntolower_s(str, str, (int32_t)strlen(str));
   if (IS_FLOAT_TYPE(type)) {
-    val_d = strtod(str, NULL);
+    valid = smlParseDouble(str, len, &val_d);
+  } else if (IS_SIGNED_NUMERIC_TYPE(type)) {
+    valid = smlParseInt64(str, len, &val_s);
   } else {
-    if (IS_SIGNED_NUMERIC_TYPE(type)) {
-      val_s = strtoll(str, NULL, 10);
-    } else {
-      val_u = strtoull(str, NULL, 10);
-    }
+    valid = smlParseUint64(str, len, &val_u);
+  }
+
+  if (!valid) {
+    tscError("SML:0x%"PRIx64" Convert number(%.*s) failed, invalid or out of range", info->id, len, str);
+    return false;
   }
 
-  if (errno == ERANGE) {
-    tscError("SML:0x%"PRIx64" Convert number(%s) out of range", info->id, str);
+  char *value = smlMalloc(info, length);
+  if (value == NULL) {
     return false;
   }
 
   switch (type) {
     case TSDB_DATA_TYPE_TINYINT:
-      if (!IS_VALID_TINYINT(val_s)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(int8_t *)(pVal->value) = (int8_t)val_s;
+      valid = IS_VALID_TINYINT(val_s);
+      *(int8_t *)value = (int8_t)val_s;
       break;
     case TSDB_DATA_TYPE_UTINYINT:
-      if (!IS_VALID_UTINYINT(val_u)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(uint8_t *)(pVal->value) = (uint8_t)val_u;
+      valid = IS_VALID_UTINYINT(val_u);
+      *(uint8_t *)value = (uint8_t)val_u;
       break;
     case TSDB_DATA_TYPE_SMALLINT:
-      if (!IS_VALID_SMALLINT(val_s)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(int16_t *)(pVal->value) = (int16_t)val_s;
+      valid = IS_VALID_SMALLINT(val_s);
+      *(int16_t *)value = (int16_t)val_s;
       break;
     case TSDB_DATA_TYPE_USMALLINT:
-      if (!IS_VALID_USMALLINT(val_u)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(uint16_t *)(pVal->value) = (uint16_t)val_u;
+      valid = IS_VALID_USMALLINT(val_u);
+      *(uint16_t *)value = (uint16_t)val_u;
       break;
     case TSDB_DATA_TYPE_INT:
-      if (!IS_VALID_INT(val_s)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(int32_t *)(pVal->value) = (int32_t)val_s;
+      valid = IS_VALID_INT(val_s);
+      *(int32_t *)value = (int32_t)val_s;
       break;
     case TSDB_DATA_TYPE_UINT:
-      if (!IS_VALID_UINT(val_u)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(uint32_t *)(pVal->value) = (uint32_t)val_u;
+      valid = IS_VALID_UINT(val_u);
+      *(uint32_t *)value = (uint32_t)val_u;
       break;
     case TSDB_DATA_TYPE_BIGINT:
-      if (!IS_VALID_BIGINT(val_s)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(int64_t *)(pVal->value) = (int64_t)val_s;
+      valid = IS_VALID_BIGINT(val_s);
+      *(int64_t *)value = (int64_t)val_s;
       break;
     case TSDB_DATA_TYPE_UBIGINT:
-      if (!IS_VALID_UBIGINT(val_u)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(uint64_t *)(pVal->value) = (uint64_t)val_u;
+      valid = IS_VALID_UBIGINT(val_u);
+      *(uint64_t *)value = (uint64_t)val_u;
       break;
     case TSDB_DATA_TYPE_FLOAT:
-      if (!IS_VALID_FLOAT(val_d)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(float *)(pVal->value) = (float)val_d;
+      valid = IS_VALID_FLOAT(val_d);
+      *(float *)value = (float)val_d;
       break;
     case TSDB_DATA_TYPE_DOUBLE:
-      if (!IS_VALID_DOUBLE(val_d)) {
-        return false;
-      }
-      pVal->value = calloc(length, 1);
-      *(double *)(pVal->value) = (double)val_d;
+      valid = IS_VALID_DOUBLE(val_d);
+      *(double *)value = (double)val_d;
       break;
     default:
-      return false;
+      valid = false;
+  }
+
+  if (!valid) {
+    smlFree(info, value);
+    return false;
+  }
+
+  pVal->value = value;
+  return true;
+}
+
+static bool copySmlValue(TAOS_SML_KV *pVal, uint8_t type, const char *value, int16_t length, SSmlLinesInfo* info) {
+  pVal->type = type;
+  pVal->length = length;
+  pVal->value = smlMalloc(info, length);
+  if (pVal->value == NULL) {
+    return false;
   }
+
+  memcpy(pVal->value, value, length);
   return true;
 }
+
 //len does not include '\0' from value.
-bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
+bool convertSmlValueType(TAOS_SML_KV *pVal, const char *value,
                          uint16_t len, SSmlLinesInfo* info, bool isTag) {
   if (len <= 0) {
     return false;
@@ -1748,161 +2272,83 @@ bool convertSmlValueType(TAOS_SML_KV *pVal, char *value,
 
   //convert tags value to Nchar
   if (isTag) {
-    pVal->type = TSDB_DATA_TYPE_NCHAR;
-    pVal->length = len;
-    pVal->value = calloc(pVal->length, 1);
-    memcpy(pVal->value, value, pVal->length);
-    return true;
+    return copySmlValue(pVal, TSDB_DATA_TYPE_NCHAR, value, len, info);
   }
 
-  //integer number
+  //number with type appendix
+  int32_t appendixLen = 0;
   bool has_sign;
   if (isInteger(value, len, &has_sign)) {
     pVal->type = has_sign ? TSDB_DATA_TYPE_BIGINT : TSDB_DATA_TYPE_UBIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 1] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isTinyInt(value, len)) {
+    appendixLen = 1;
+  } else if (isTinyInt(value, len)) {
     pVal->type = TSDB_DATA_TYPE_TINYINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 2] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isTinyUint(value, len)) {
+    appendixLen = 2;
+  } else if (isTinyUint(value, len)) {
     pVal->type = TSDB_DATA_TYPE_UTINYINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 2] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isSmallInt(value, len)) {
+    appendixLen = 2;
+  } else if (isSmallInt(value, len)) {
     pVal->type = TSDB_DATA_TYPE_SMALLINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isSmallUint(value, len)) {
+    appendixLen = 3;
+  } else if (isSmallUint(value, len)) {
     pVal->type = TSDB_DATA_TYPE_USMALLINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isInt(value, len)) {
+    appendixLen = 3;
+  } else if (isInt(value, len)) {
     pVal->type = TSDB_DATA_TYPE_INT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isUint(value, len)) {
+    appendixLen = 3;
+  } else if (isUint(value, len)) {
     pVal->type = TSDB_DATA_TYPE_UINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isBigInt(value, len)) {
+    appendixLen = 3;
+  } else if (isBigInt(value, len)) {
     pVal->type = TSDB_DATA_TYPE_BIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isBigUint(value, len)) {
+    appendixLen = 3;
+  } else if (isBigUint(value, len)) {
     pVal->type = TSDB_DATA_TYPE_UBIGINT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidInteger(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  //floating number
-  if (isFloat(value, len)) {
+    appendixLen = 3;
+  } else if (isFloat(value, len)) {
     pVal->type = TSDB_DATA_TYPE_FLOAT;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidFloat(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  if (isDouble(value, len)) {
+    appendixLen = 3;
+  } else if (isDouble(value, len)) {
     pVal->type = TSDB_DATA_TYPE_DOUBLE;
+    appendixLen = 3;
+  }
+
+  if (appendixLen > 0) {
     pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    value[len - 3] = '\0';
-    if (!isValidFloat(value) || !convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
+    return convertStrToNumber(pVal, value, len - appendixLen, info);
   }
+
   //binary
   if (isBinary(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_BINARY;
-    pVal->length = len - 2;
-    pVal->value = calloc(pVal->length, 1);
     //copy after "
-    memcpy(pVal->value, value + 1, pVal->length);
-    return true;
+    return copySmlValue(pVal, TSDB_DATA_TYPE_BINARY, value + 1, len - 2, info);
   }
   //nchar
   if (isNchar(value, len)) {
-    pVal->type = TSDB_DATA_TYPE_NCHAR;
-    pVal->length = len - 3;
-    pVal->value = calloc(pVal->length, 1);
     //copy after L"
-    memcpy(pVal->value, value + 2, pVal->length);
-    return true;
+    return copySmlValue(pVal, TSDB_DATA_TYPE_NCHAR, value + 2, len - 3, info);
   }
   //bool
   bool bVal;
   if (isBool(value, len, &bVal)) {
-    pVal->type = TSDB_DATA_TYPE_BOOL;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    pVal->value = calloc(pVal->length, 1);
-    memcpy(pVal->value, &bVal, pVal->length);
-    return true;
+    return copySmlValue(pVal, TSDB_DATA_TYPE_BOOL, (const char *)&bVal, (int16_t)tDataTypes[TSDB_DATA_TYPE_BOOL].bytes,
+                        info);
   }
 
   //Handle default(no appendix) type as DOUBLE
-  if (isValidInteger(value) || isValidFloat(value)) {
-    pVal->type = TSDB_DATA_TYPE_DOUBLE;
-    pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-    if (!convertStrToNumber(pVal, value, info)) {
-      return false;
-    }
-    return true;
-  }
-  return false;
+  pVal->type = TSDB_DATA_TYPE_DOUBLE;
+  pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
+  return convertStrToNumber(pVal, value, len, info);
 }
 
-static int32_t getTimeStampValue(char *value, uint16_t len,
+static int32_t getTimeStampValue(const char *value, uint16_t len,
                                  SMLTimeStampType type, int64_t *ts, SSmlLinesInfo* info) {
 
   //No appendix or no timestamp given (len = 0)
   if (len != 0 && type != SML_TIME_STAMP_NOW) {
-    *ts = (int64_t)strtoll(value, NULL, 10);
+    if (!smlParseInt64(value, len, ts)) {
+      return TSDB_CODE_TSC_INVALID_TIME_STAMP;
+    }
   } else {
     type = SML_TIME_STAMP_NOW;
   }
@@ -1942,7 +2388,7 @@ static int32_t getTimeStampValue(char *value, uint16_t len,
   return TSDB_CODE_SUCCESS;
 }
 
-int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, char *value,
+int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, const char *value,
                             uint16_t len, SSmlLinesInfo* info) {
   int32_t ret;
   SMLTimeStampType type = SML_TIME_STAMP_NOW;
@@ -1959,43 +2405,34 @@ int32_t convertSmlTimeStamp(TAOS_SML_KV *pVal, char *value,
   }
   tscDebug("SML:0x%"PRIx64"Timestamp after conversion:%"PRId64, info->id, tsVal);
 
-  pVal->type = TSDB_DATA_TYPE_TIMESTAMP;
-  pVal->length = (int16_t)tDataTypes[pVal->type].bytes;
-  pVal->value = calloc(pVal->length, 1);
-  memcpy(pVal->value, &tsVal, pVal->length);
+  if (!copySmlValue(pVal, TSDB_DATA_TYPE_TIMESTAMP, (const char *)&tsVal,
+                    (int16_t)tDataTypes[TSDB_DATA_TYPE_TIMESTAMP].bytes, info)) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t parseSmlTimeStamp(TAOS_SML_KV **pTS, const char **index, SSmlLinesInfo* info) {
-  const char *start, *cur;
-  int32_t ret = TSDB_CODE_SUCCESS;
-  int len = 0;
+static int32_t parseSmlTimeStamp(TAOS_SML_KV *pTS, const char **index, const char *end, SSmlLinesInfo* info) {
+  const char *start = *index;
   char key[] = "ts";
-  char *value = NULL;
 
-  start = cur = *index;
-  *pTS = calloc(1, sizeof(TAOS_SML_KV));
-
-  while(*cur != '\0') {
-    cur++;
-    len++;
+  if (end - start > INT16_MAX) {
+    return TSDB_CODE_TSC_INVALID_TIME_STAMP;
   }
 
-  if (len > 0) {
-    value = calloc(len + 1, 1);
-    memcpy(value, start, len);
-  }
-
-  ret = convertSmlTimeStamp(*pTS, value, len, info);
+  int32_t ret = convertSmlTimeStamp(pTS, start, (uint16_t)(end - start), info);
   if (ret) {
-    free(value);
-    free(*pTS);
     return ret;
   }
-  free(value);
 
-  (*pTS)->key = calloc(sizeof(key), 1);
-  memcpy((*pTS)->key, key, sizeof(key));
+  pTS->key = smlMalloc(info, sizeof(key));
+  if (pTS->key == NULL) {
+    smlFree(info, pTS->value);
+    pTS->value = NULL;
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  memcpy(pTS->key, key, sizeof(key));
+  *index = end;
   return ret;
 }
 
@@ -2013,16 +2450,25 @@ bool checkDuplicateKey(char *key, SHashObj *pHash, SSmlLinesInfo* info) {
   return false;
 }
 
-static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash, SSmlLinesInfo* info) {
+static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, const char *end, SSmlLinesInfo* info) {
   const char *cur = *index;
   char key[TSDB_COL_NAME_LEN + 1];  // +1 to avoid key[len] over write
   int16_t len = 0;
 
   while (*cur != '\0') {
-    if (len > TSDB_COL_NAME_LEN - 1) {
+    //copy the characters up to the next special one at once
+    const char *next = (*smlSkipPlainCharsFp)(cur, end);
+    if (len + (next - cur) > TSDB_COL_NAME_LEN - 1) {
       tscError("SML:0x%"PRIx64" Key field cannot exceeds %d characters", info->id, TSDB_COL_NAME_LEN - 1);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
+    memcpy(key + len, cur, next - cur);
+    len += (int16_t)(next - cur);
+    cur = next;
+    if (*cur == '\0') {
+      break;
+    }
+
     //unescaped '=' identifies a tag key
     if (*cur == '=' && *(cur - 1) != '\\') {
       break;
@@ -2031,20 +2477,27 @@ static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash
     if (*cur == '\\') {
       escapeSpecialCharacter(2, &cur);
     }
+    if (len > TSDB_COL_NAME_LEN - 2) {
+      tscError("SML:0x%"PRIx64" Key field cannot exceeds %d characters", info->id, TSDB_COL_NAME_LEN - 1);
+      return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
+    }
     key[len] = *cur;
     cur++;
     len++;
   }
-  if (len == 0) {
+  if (len == 0 || *cur == '\0') {
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
   key[len] = '\0';
 
-  if (checkDuplicateKey(key, pHash, info)) {
+  if (checkDuplicateKey(key, info->keyHash, info)) {
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
 
-  pKV->key = malloc(len + TS_BACKQUOTE_CHAR_SIZE + 1);
+  pKV->key = smlMalloc(info, len + TS_BACKQUOTE_CHAR_SIZE + 1);
+  if (pKV->key == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
   memcpy(pKV->key, key, len + 1);
   addEscapeCharToString(pKV->key, len);
   tscDebug("SML:0x%"PRIx64" Key:%s|len:%d", info->id, pKV->key, len);
@@ -2053,12 +2506,11 @@ static int32_t parseSmlKey(TAOS_SML_KV *pKV, const char **index, SHashObj *pHash
 }
 
 
-static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
+static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index, const char *end,
                           bool *is_last_kv, SSmlLinesInfo* info, bool isTag) {
   const char *start, *cur;
   int32_t     ret = TSDB_CODE_SUCCESS;
-  char       *value = NULL;
-  int16_t     len = 0;
+  int32_t     len = 0;
 
   bool   kv_done = false;
   bool   back_slash = false;
@@ -2082,6 +2534,15 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
   val_state = val_common;
 
   while (1) {
+    //skip the characters up to the next special one, unless an escaped or closing one is expected
+    if (!back_slash && !double_quote &&
+        (isTag ? (tag_state == tag_common || tag_state == tag_lqoute)
+               : (val_state == val_common || val_state == val_lqoute))) {
+      const char *next = (*smlSkipPlainCharsFp)(cur, end);
+      len += (int32_t)(next - cur);
+      cur = next;
+    }
+
     if (isTag) {
       /* ',', '=' and spaces MUST be escaped */
       switch (tag_state) {
@@ -2107,7 +2568,7 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
           len += 1;
           break;
         } else if (*cur == 'L') {
-          line_len = strlen(*index);
+          line_len = end - *index;
 
           /* common character at the end */
           if (cur + 1 >= *index + line_len) {
@@ -2250,7 +2711,7 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
           len += 1;
           break;
         } else if (*cur == 'L') {
-          line_len = strlen(*index);
+          line_len = end - *index;
 
           /* common character at the end */
           if (cur + 1 >= *index + line_len) {
@@ -2380,57 +2841,55 @@ static int32_t parseSmlValue(TAOS_SML_KV *pKV, const char **index,
   }
 
   if (len == 0 || ret != TSDB_CODE_SUCCESS) {
-    free(pKV->key);
+    smlFree(info, pKV->key);
     pKV->key = NULL;
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
 
-  value = calloc(len + 1, 1);
-  memcpy(value, start, len);
-  value[len] = '\0';
-  if (!convertSmlValueType(pKV, value, len, info, isTag)) {
-    tscError("SML:0x%"PRIx64" Failed to convert sml value string(%s) to any type",
-            info->id, value);
-    free(value);
+  if (len > INT16_MAX || !convertSmlValueType(pKV, start, (uint16_t)len, info, isTag)) {
+    tscError("SML:0x%"PRIx64" Failed to convert sml value string(%.*s) to any type",
+            info->id, len, start);
     ret = TSDB_CODE_TSC_INVALID_VALUE;
     goto error;
   }
-  free(value);
 
   *index = (*cur == '\0') ? cur : cur + 1;
   return ret;
 
 error:
   //free previous alocated key field
-  free(pKV->key);
+  smlFree(info, pKV->key);
   pKV->key = NULL;
   return ret;
 }
 
-static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index,
+static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index, const char *end,
                                    uint8_t *has_tags, SSmlLinesInfo* info) {
   const char *cur = *index;
+  char name[TSDB_TABLE_NAME_LEN];
   int16_t len = 0;
 
-  pSml->stableName = calloc(TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE, 1);
-  if (pSml->stableName == NULL){
-      return TSDB_CODE_TSC_OUT_OF_MEMORY;
-  }
-
   while (*cur != '\0') {
-    if (len > TSDB_TABLE_NAME_LEN - 1) {
+    //copy the characters up to the next special one at once
+    const char *next = (*smlSkipPlainCharsFp)(cur, end);
+    if (len + (next - cur) > TSDB_TABLE_NAME_LEN - 1) {
       tscError("SML:0x%"PRIx64" Measurement field cannot exceeds %d characters", info->id, TSDB_TABLE_NAME_LEN - 1);
-      free(pSml->stableName);
-      pSml->stableName = NULL;
       return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
     }
+    memcpy(name + len, cur, next - cur);
+    len += (int16_t)(next - cur);
+    cur = next;
+    if (*cur == '\0') {
+      break;
+    }
+
     //first unescaped comma or space identifies measurement
     //if space detected first, meaning no tag in the input
-    if (*cur == ',' && *(cur - 1) != '\\') {
+    if (*cur == ',' && (cur == *index || *(cur - 1) != '\\')) {
       *has_tags = 1;
       break;
     }
-    if (*cur == ' ' && *(cur - 1) != '\\') {
+    if (*cur == ' ' && (cur == *index || *(cur - 1) != '\\')) {
       if (*(cur + 1) != ' ') {
         break;
       }
@@ -2443,17 +2902,25 @@ static int32_t parseSmlMeasurement(TAOS_SML_DATA_POINT *pSml, const char **index
     if (*cur == '\\') {
       escapeSpecialCharacter(1, &cur);
     }
-    pSml->stableName[len] = *cur;
+    if (len > TSDB_TABLE_NAME_LEN - 2) {
+      tscError("SML:0x%"PRIx64" Measurement field cannot exceeds %d characters", info->id, TSDB_TABLE_NAME_LEN - 1);
+      return TSDB_CODE_TSC_INVALID_TABLE_ID_LENGTH;
+    }
+    name[len] = *cur;
     cur++;
     len++;
   }
   if (len == 0) {
-    free(pSml->stableName);
-    pSml->stableName = NULL;
     return TSDB_CODE_TSC_LINE_SYNTAX_ERROR;
   }
+
+  pSml->stableName = smlMalloc(info, len + TS_BACKQUOTE_CHAR_SIZE + 1);
+  if (pSml->stableName == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+  memcpy(pSml->stableName, name, len);
   addEscapeCharToString(pSml->stableName, len);
-  *index = cur + 1;
+  *index = (*cur == '\0') ? cur : cur + 1;
   tscDebug("SML:0x%"PRIx64" Stable name in measurement:%s|len:%d", info->id, pSml->stableName, len);
 
   return TSDB_CODE_SUCCESS;
@@ -2475,27 +2942,40 @@ int32_t isValidChildTableName(const char *pTbName, int16_t len, SSmlLinesInfo* i
 }
 
 
+static int32_t reserveSmlKvBuf(SSmlLinesInfo* info, int32_t num) {
+  if (num <= info->kvBufCap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t capacity = MAX(info->kvBufCap * 2, 64);
+  TAOS_SML_KV *kvs = realloc(info->kvBuf, capacity * sizeof(TAOS_SML_KV));
+  if (kvs == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  info->kvBuf = kvs;
+  info->kvBufCap = capacity;
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * the kvs are parsed into the buffer kept by the batch of lines, and copied out by the exact number. The first field is
+ * left for the timestamp.
+ */
 static int32_t parseSmlKvPairs(TAOS_SML_KV **pKVs, int *num_kvs,
-                               const char **index, bool isField,
-                               TAOS_SML_DATA_POINT* smlData, SHashObj *pHash,
-                               SSmlLinesInfo* info) {
+                               const char **index, const char *end, bool isField,
+                               TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info) {
   const char *cur = *index;
   int32_t ret = TSDB_CODE_SUCCESS;
-  TAOS_SML_KV *pkv;
   bool is_last_kv = false;
+  int32_t first = isField ? 1 : 0;
+  int32_t num = first;
 
-  int32_t capacity = 0;
-  if (isField) {
-    capacity = 64;
-    *pKVs = malloc(capacity * sizeof(TAOS_SML_KV));
-    // leave space for timestamp;
-    pkv = *pKVs;
-    pkv++;
-  } else {
-    capacity = 8;
-    *pKVs = malloc(capacity * sizeof(TAOS_SML_KV));
-    pkv = *pKVs;
+  ret = reserveSmlKvBuf(info, 1);
+  if (ret) {
+    return ret;
   }
+  memset(info->kvBuf, 0, sizeof(TAOS_SML_KV));
 
   size_t childTableNameLen = strlen(tsSmlChildTableName);
   char childTableName[TSDB_TABLE_NAME_LEN + TS_BACKQUOTE_CHAR_SIZE] = {0};
@@ -2505,127 +2985,112 @@ static int32_t parseSmlKvPairs(TAOS_SML_KV **pKVs, int *num_kvs,
   }
 
   while (*cur != '\0') {
-    ret = parseSmlKey(pkv, &cur, pHash, info);
+    ret = reserveSmlKvBuf(info, num + 1);
+    if (ret) {
+      goto error;
+    }
+
+    TAOS_SML_KV *pkv = info->kvBuf + num;
+    memset(pkv, 0, sizeof(TAOS_SML_KV));
+    ret = parseSmlKey(pkv, &cur, end, info);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse key", info->id);
       goto error;
     }
-    ret = parseSmlValue(pkv, &cur, &is_last_kv, info, !isField);
+    ret = parseSmlValue(pkv, &cur, end, &is_last_kv, info, !isField);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse value", info->id);
       goto error;
     }
 
     if (!isField && childTableNameLen != 0 && strcasecmp(pkv->key, childTableName) == 0)  {
-      smlData->childTableName = malloc(pkv->length + TS_BACKQUOTE_CHAR_SIZE + 1);
-      memcpy(smlData->childTableName, pkv->value, pkv->length);
-      addEscapeCharToString(smlData->childTableName, (int32_t)pkv->length);
-      free(pkv->key);
-      free(pkv->value);
+      smlData->childTableName = smlMalloc(info, pkv->length + TS_BACKQUOTE_CHAR_SIZE + 1);
+      if (smlData->childTableName != NULL) {
+        memcpy(smlData->childTableName, pkv->value, pkv->length);
+        addEscapeCharToString(smlData->childTableName, (int32_t)pkv->length);
+      }
+      smlFree(info, pkv->key);
+      smlFree(info, pkv->value);
+      if (smlData->childTableName == NULL) {
+        ret = TSDB_CODE_TSC_OUT_OF_MEMORY;
+        goto error;
+      }
     } else {
-      *num_kvs += 1;
+      num += 1;
     }
     if (is_last_kv) {
-      goto done;
-    }
-
-    //reallocate addtional memory for more kvs
-    TAOS_SML_KV *more_kvs = NULL;
-
-    if (isField) {
-      if ((*num_kvs + 2) > capacity) {
-        capacity *= 3; capacity /= 2;
-        more_kvs = realloc(*pKVs, capacity * sizeof(TAOS_SML_KV));
-      } else {
-        more_kvs = *pKVs;
-      }
-    } else {
-      if ((*num_kvs + 1) > capacity) {
-        capacity *= 3; capacity /= 2;
-        more_kvs = realloc(*pKVs, capacity * sizeof(TAOS_SML_KV));
-      } else {
-        more_kvs = *pKVs;
-      }
+      break;
     }
+  }
 
-    if (!more_kvs) {
+  if (num > 0) {
+    *pKVs = smlMalloc(info, num * sizeof(TAOS_SML_KV));
+    if (*pKVs == NULL) {
+      ret = TSDB_CODE_TSC_OUT_OF_MEMORY;
       goto error;
     }
-    *pKVs = more_kvs;
-    //move pKV points to next TAOS_SML_KV block
-    if (isField) {
-      pkv = *pKVs + *num_kvs + 1;
-    } else {
-      pkv = *pKVs + *num_kvs;
-    }
+    memcpy(*pKVs, info->kvBuf, num * sizeof(TAOS_SML_KV));
   }
-  goto done;
-
-error:
-  return ret;
-done:
+  *num_kvs = num - first;
   *index = cur;
   return ret;
-}
 
-static void moveTimeStampToFirstKv(TAOS_SML_DATA_POINT** smlData, TAOS_SML_KV *ts) {
-  TAOS_SML_KV* tsField = (*smlData)->fields;
-  tsField->length = ts->length;
-  tsField->type = ts->type;
-  tsField->value = malloc(ts->length);
-  tsField->key = malloc(strlen(ts->key) + 1);
-  memcpy(tsField->key, ts->key, strlen(ts->key) + 1);
-  memcpy(tsField->value, ts->value, ts->length);
-  (*smlData)->fieldNum = (*smlData)->fieldNum + 1;
-
-  free(ts->key);
-  free(ts->value);
-  free(ts);
+error:
+  for (int32_t i = first; i < num; ++i) {
+    smlFree(info, info->kvBuf[i].key);
+    smlFree(info, info->kvBuf[i].value);
+  }
+  return ret;
 }
 
 int32_t tscParseLine(const char* sql, TAOS_SML_DATA_POINT* smlData, SSmlLinesInfo* info) {
   const char* index = sql;
+  const char* end = sql + strlen(sql);
   int32_t ret = TSDB_CODE_SUCCESS;
   uint8_t has_tags = 0;
-  TAOS_SML_KV *timestamp = NULL;
-  SHashObj *keyHashTable = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
 
-  ret = parseSmlMeasurement(smlData, &index, &has_tags, info);
+  //the keys of the former line are cleared, the hash table is kept by the batch of lines
+  if (info->keyHash == NULL) {
+    info->keyHash = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, false);
+    if (info->keyHash == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  } else {
+    taosHashClear(info->keyHash);
+  }
+
+  ret = parseSmlMeasurement(smlData, &index, end, &has_tags, info);
   if (ret) {
     tscError("SML:0x%"PRIx64" Unable to parse measurement", info->id);
-    taosHashCleanup(keyHashTable);
     return ret;
   }
   tscDebug("SML:0x%"PRIx64" Parse measurement finished, has_tags:%d", info->id, has_tags);
 
   //Parse Tags
   if (has_tags) {
-    ret = parseSmlKvPairs(&smlData->tags, &smlData->tagNum, &index, false, smlData, keyHashTable, info);
+    ret = parseSmlKvPairs(&smlData->tags, &smlData->tagNum, &index, end, false, smlData, info);
     if (ret) {
       tscError("SML:0x%"PRIx64" Unable to parse tag", info->id);
-      taosHashCleanup(keyHashTable);
       return ret;
     }
   }
   tscDebug("SML:0x%"PRIx64" Parse tags finished, num of tags:%d", info->id, smlData->tagNum);
 
   //Parse fields
-  ret = parseSmlKvPairs(&smlData->fields, &smlData->fieldNum, &index, true, smlData, keyHashTable, info);
+  ret = parseSmlKvPairs(&smlData->fields, &smlData->fieldNum, &index, end, true, smlData, info);
   if (ret) {
     tscError("SML:0x%"PRIx64" Unable to parse field", info->id);
-    taosHashCleanup(keyHashTable);
     return ret;
   }
   tscDebug("SML:0x%"PRIx64" Parse fields finished, num of fields:%d", info->id, smlData->fieldNum);
-  taosHashCleanup(keyHashTable);
 
-  //Parse timestamp
-  ret = parseSmlTimeStamp(&timestamp, &index, info);
+  //Parse timestamp into the first field
+  ret = parseSmlTimeStamp(smlData->fields, &index, end, info);
+  smlData->fieldNum += 1;
   if (ret) {
     tscError("SML:0x%"PRIx64" Unable to parse timestamp", info->id);
     return ret;
   }
-  moveTimeStampToFirstKv(&smlData, timestamp);
   tscDebug("SML:0x%"PRIx64" Parse timestamp finished", info->id);
 
   return TSDB_CODE_SUCCESS;
@@ -2654,7 +3119,9 @@ int32_t tscParseLines(char* lines[], int numLines, SArray* points, SArray* faile
     int32_t code = tscParseLine(lines[i], &point, info);
     if (code != TSDB_CODE_SUCCESS) {
       tscError("SML:0x%"PRIx64" data point line parse failed. line %d : %s", info->id, i, lines[i]);
-      destroySmlDataPoint(&point);
+      if (info->arena == NULL) {
+        destroySmlDataPoint(&point);
+      }
       return code;
     } else {
       tscDebug("SML:0x%"PRIx64" data point line parse success. line %d", info->id, i);
@@ -2690,8 +3157,11 @@ int taos_insert_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType p
   }
 
   SArray* lpPoints = taosArrayInit(numLines, sizeof(TAOS_SML_DATA_POINT));
-  if (lpPoints == NULL) {
+  info->arena = smlCreateArena();
+  if (lpPoints == NULL || info->arena == NULL) {
     tscError("SML:0x%"PRIx64" taos_insert_lines failed to allocate memory", info->id);
+    taosArrayDestroy(&lpPoints);
+    smlDestroyArena(info->arena);
     tfree(info);
     return TSDB_CODE_TSC_OUT_OF_MEMORY;
   }
@@ -2715,13 +3185,11 @@ int taos_insert_lines(TAOS* taos, char* lines[], int numLines, SMLProtocolType p
 
 cleanup:
   tscDebug("SML:0x%"PRIx64" taos_insert_lines finish inserting %d lines. code: %d", info->id, numLines, code);
-  points = TARRAY_GET_START(lpPoints);
-  numPoints = taosArrayGetSize(lpPoints);
-  for (int i=0; i<numPoints; ++i) {
-    destroySmlDataPoint(points+i);
-  }
-
+  //the names, keys and values of the points are all released with the arena
   taosArrayDestroy(&lpPoints);
+  smlDestroyArena(info->arena);
+  taosHashCleanup(info->keyHash);
+  tfree(info->kvBuf);
 
   tfree(info);
   return code;
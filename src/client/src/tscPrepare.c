@@ -75,6 +75,7 @@ typedef enum {
 typedef struct STscStmt {
   bool isInsert;
   bool multiTbInsert;
+  bool columnar;   // the bound values are kept by columns, and sent as the columnar submit blocks
   int16_t  last;
   STscObj* taos;
   SSqlObj* pSql;
@@ -359,6 +360,11 @@ static int fillColumnsNull(STableDataBlocks* pBlock, int32_t rowNum) {
 int32_t fillTablesColumnsNull(SSqlObj* pSql) {
   SSqlCmd* pCmd = &pSql->cmd;
 
+  // the columns without value are filled when the columnar blocks are built
+  if (IS_COLUMNAR_PAYLOAD(pCmd->insertParam.payloadType)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
   STableDataBlocks** p = taosHashIterate(pCmd->insertParam.pTableBlockHashList, NULL);
 
   STableDataBlocks* pOneTableBlock = *p;
@@ -842,6 +848,7 @@ static int32_t insertStmtGenLastBlock(STableDataBlocks** lastBlock, STableDataBl
   (*lastBlock)->cloned = true;
   
   (*lastBlock)->pData    = NULL;
+  (*lastBlock)->pCols    = NULL;
   (*lastBlock)->ordered  = true;
   (*lastBlock)->prevTS   = INT64_MIN;
   (*lastBlock)->size     = sizeof(SSubmitBlk);
@@ -872,6 +879,7 @@ static int32_t insertStmtGenBlock(STscStmt* pStmt, STableDataBlocks** pBlock, ST
   memcpy((*pBlock)->pTableMeta, pTableMeta, msize);
 
   (*pBlock)->pData = malloc((*pBlock)->nAllocSize);
+  (*pBlock)->pCols = NULL;
 
   (*pBlock)->vgId     = (*pBlock)->pTableMeta->vgId;
 
@@ -943,6 +951,136 @@ static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MU
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t bindColumnMakeRoom(SBindColumn* pCol, int32_t len) {
+  if (pCol->len + len <= pCol->cap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t cap = MAX(pCol->len + len, pCol->cap * 2);
+  char*   tmp = realloc(pCol->pData, cap);
+  if (tmp == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  pCol->pData = tmp;
+  pCol->cap = cap;
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * append the values of the column to the rows from rowNum, which are kept by columns for the columnar payload, so the
+ * fixed length values are copied at once. The rows bound before from rowNum are overwritten like the raw payload.
+ */
+static int doBindColumn(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MULTI_BIND* bind, int32_t rowNum) {
+  if (bind->buffer_type != param->type || !isValidDataType(param->type)) {
+    tscError("column mismatch or invalid");
+    return TSDB_CODE_TSC_INVALID_VALUE;
+  }
+
+  if (IS_VAR_DATA_TYPE(param->type) && bind->length == NULL) {
+    tscError("BINARY/NCHAR no length");
+    return TSDB_CODE_TSC_INVALID_VALUE;
+  }
+
+  if (pBlock->pCols == NULL) {
+    pBlock->pCols = calloc(tscGetNumOfColumns(pBlock->pTableMeta), sizeof(SBindColumn));
+    if (pBlock->pCols == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  SBindColumn* pCol = &pBlock->pCols[param->colIndex];
+  if (pCol->numOfRows < rowNum) {
+    tscError("column %d: %d rows are bound, less than %d", param->colIndex, pCol->numOfRows, rowNum);
+    return TSDB_CODE_TSC_INVALID_VALUE;
+  }
+
+  int32_t num = bind->num;
+
+  if (!IS_VAR_DATA_TYPE(param->type)) {
+    int32_t bytes = TYPE_BYTES[param->type];
+
+    pCol->len = rowNum * bytes;
+    if (bindColumnMakeRoom(pCol, num * bytes) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    char* data = pCol->pData + pCol->len;
+    if (bind->buffer_length == (uintptr_t)bytes) {
+      memcpy(data, bind->buffer, (size_t)num * bytes);
+    } else {
+      for (int32_t i = 0; i < num; ++i) {
+        memcpy(data + bytes * i, (char *)bind->buffer + bind->buffer_length * i, bytes);
+      }
+    }
+
+    for (int32_t i = 0; i < num; ++i) {
+      if (bind->is_null != NULL && bind->is_null[i]) {
+        setNull(data + bytes * i, param->type, bytes);
+      } else if (param->colIndex == PRIMARYKEY_TIMESTAMP_COL_INDEX) {
+        if (tsCheckTimestamp(pBlock, data + bytes * i) != TSDB_CODE_SUCCESS) {
+          tscError("invalid timestamp");
+          return TSDB_CODE_TSC_INVALID_VALUE;
+        }
+      }
+    }
+
+    pCol->len += num * bytes;
+    pCol->numOfRows = rowNum + num;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (rowNum + num + 1 > pCol->offsetCap) {
+    int32_t  cap = MAX(rowNum + num + 1, pCol->offsetCap * 2);
+    int32_t* tmp = realloc(pCol->offsets, cap * sizeof(int32_t));
+    if (tmp == NULL) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    if (pCol->offsets == NULL) {
+      tmp[0] = 0;
+    }
+
+    pCol->offsets = tmp;
+    pCol->offsetCap = cap;
+  }
+
+  pCol->len = pCol->offsets[rowNum];
+  for (int32_t i = 0; i < num; ++i) {
+    if (bindColumnMakeRoom(pCol, param->bytes) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    char* data = pCol->pData + pCol->len;
+    char* src = (char *)bind->buffer + bind->buffer_length * i;
+
+    if (bind->is_null != NULL && bind->is_null[i]) {
+      setVardataNull(data, param->type);
+    } else if (param->type == TSDB_DATA_TYPE_BINARY) {
+      int32_t maxLen = param->bytes - (int32_t)VARSTR_HEADER_SIZE;
+      if (bind->length[i] > maxLen) {
+        tscError("binary length too long, ignore it, max:%d, actual:%d", maxLen, bind->length[i]);
+        return TSDB_CODE_TSC_INVALID_VALUE;
+      }
+      STR_WITH_SIZE_TO_VARSTR(data, src, (VarDataLenT)bind->length[i]);
+    } else {
+      int32_t output = 0;
+      if (!taosMbsToUcs4(src, bind->length[i], varDataVal(data), param->bytes - VARSTR_HEADER_SIZE, &output)) {
+        tscError("convert nchar string to UCS4_LE failed:%s", src);
+        return TSDB_CODE_TSC_INVALID_VALUE;
+      }
+      varDataSetLen(data, output);
+    }
+
+    pCol->offsets[rowNum + i] = pCol->len;
+    pCol->len += varDataTLen(data);
+  }
+
+  pCol->offsets[rowNum + num] = pCol->len;
+  pCol->numOfRows = rowNum + num;
+  return TSDB_CODE_SUCCESS;
+}
+
 static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
   SSqlCmd* pCmd = &stmt->pSql->cmd;
   STscStmt* pStmt = (STscStmt*)stmt;
@@ -978,6 +1116,27 @@ static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
     }
   }
 
+  if (pStmt->columnar) {
+    for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+      SParamInfo* param = &pBlock->params[j];
+      TAOS_BIND*  pBind = &bind[param->idx];
+
+      int32_t length = (IS_VAR_DATA_TYPE(param->type) && pBind->length != NULL) ? (int32_t)*pBind->length : 0;
+      char    isNull = (pBind->is_null != NULL && *pBind->is_null) ? 1 : 0;
+
+      TAOS_MULTI_BIND mbind = {.buffer_type = pBind->buffer_type, .buffer = pBind->buffer,
+                               .buffer_length = 0, .length = &length, .is_null = &isNull, .num = 1};
+
+      int code = doBindColumn(pBlock, param, &mbind, pCmd->batchSize);
+      if (code != TSDB_CODE_SUCCESS) {
+        tscDebug("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
+        return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
+      }
+    }
+
+    return TSDB_CODE_SUCCESS;
+  }
+
   uint32_t totalDataSize = sizeof(SSubmitBlk) + (pCmd->batchSize + 1) * pBlock->rowSize;
   if (totalDataSize > pBlock->nAllocSize) {
     const double factor = 1.5;
@@ -1048,7 +1207,7 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
   }
 
   uint32_t totalDataSize = sizeof(SSubmitBlk) + (pCmd->batchSize + rowNum) * pBlock->rowSize;
-  if (totalDataSize > pBlock->nAllocSize) {
+  if (!pStmt->columnar && totalDataSize > pBlock->nAllocSize) {
     const double factor = 1.5;
 
     void* tmp = realloc(pBlock->pData, (uint32_t)(totalDataSize * factor));
@@ -1068,7 +1227,8 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
         return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind row num mismatch");
       }
 
-      int code = doBindBatchParam(pBlock, param, &bind[param->idx], pCmd->batchSize);
+      int code = pStmt->columnar ? doBindColumn(pBlock, param, &bind[param->idx], pCmd->batchSize)
+                                 : doBindBatchParam(pBlock, param, &bind[param->idx], pCmd->batchSize);
       if (code != TSDB_CODE_SUCCESS) {
         tscError("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
         return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
@@ -1079,7 +1239,8 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
   } else {
     SParamInfo* param = &pBlock->params[colIdx];
 
-    int code = doBindBatchParam(pBlock, param, bind, pCmd->batchSize);
+    int code = pStmt->columnar ? doBindColumn(pBlock, param, bind, pCmd->batchSize)
+                               : doBindBatchParam(pBlock, param, bind, pCmd->batchSize);
     if (code != TSDB_CODE_SUCCESS) {
       tscError("0x%"PRIx64" bind column %d: type mismatch or invalid", pStmt->pSql->self, param->idx);
       return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "bind column type mismatch or invalid");
@@ -1255,6 +1416,7 @@ static void insertBatchClean(STscStmt* pStmt) {
   STableDataBlocks** p = taosHashIterate(pCmd->insertParam.pTableBlockHashList, NULL);
   while(p) {
     tfree((*p)->pData);
+    tscDestroyBindColumns(*p);
     p = taosHashIterate(pCmd->insertParam.pTableBlockHashList, p);
   }
 
@@ -1663,6 +1825,7 @@ int taos_stmt_prepare(TAOS_STMT* stmt, const char* sql, unsigned long length) {
 
   if (tscIsInsertData(pSql->sqlstr)) {
     pStmt->isInsert = true;
+    pStmt->columnar = (pStmt->taos->features & TSDB_CONN_FEATURE_COLUMNAR_SUBMIT) != 0;
 
     pSql->cmd.insertParam.numOfParams = 0;
     pSql->cmd.batchSize   = 0;
@@ -2087,12 +2250,17 @@ int taos_stmt_execute(TAOS_STMT* stmt) {
 
     pStmt->last = STMT_EXECUTE;
 
-    pStmt->pSql->cmd.insertParam.payloadType = PAYLOAD_TYPE_RAW;
+    pStmt->pSql->cmd.insertParam.payloadType = pStmt->columnar ? PAYLOAD_TYPE_COLUMNAR : PAYLOAD_TYPE_RAW;
     if (pStmt->multiTbInsert) {
       ret = insertBatchStmtExecute(pStmt);
     } else {
       ret = insertStmtExecute(pStmt);
     }
+
+    if (ret == TSDB_CODE_VND_NO_COLUMNAR_SUBMIT) {
+      // columnar submit is turned off in the cluster, the statements prepared later bind rows
+      pStmt->taos->features &= ~TSDB_CONN_FEATURE_COLUMNAR_SUBMIT;
+    }
   } else { // normal stmt query
     char* sql = normalStmtBuildSql(pStmt);
     if (sql == NULL) {
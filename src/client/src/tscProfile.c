@@ -245,6 +245,10 @@ int tscBuildQueryStreamDesc(void *pMsg, STscObj *pObj) {
   pHeartbeat->numOfQueries = 0;
   SQueryDesc *pQdesc = (SQueryDesc *)pHeartbeat->pData;
 
+  // the cpu times are kept behind the space of all descs, and moved to the end of the msg at last
+  int64_t *pCpuTime = (int64_t *)(pHeartbeat->pData + allocedQueriesNum * sizeof(SQueryDesc) +
+                                  allocedStreamsNum * sizeof(SStreamDesc));
+
   int64_t now = taosGetTimestampMs();
   SSqlObj *pSql = pObj->sqlList;
 
@@ -270,6 +274,9 @@ int tscBuildQueryStreamDesc(void *pMsg, STscObj *pObj) {
     // todo race condition
     pQdesc->stableQuery = 0;
 
+    // the cpu time of the subqueries are accumulated, which are executed in different vnodes
+    int64_t cpuTime = pSql->res.cpuTime;
+
     char *p = pQdesc->subSqlInfo;
     int32_t remainLen = sizeof(pQdesc->subSqlInfo);
     if (pQdesc->numOfSub == 0) {
@@ -283,6 +290,10 @@ int tscBuildQueryStreamDesc(void *pMsg, STscObj *pObj) {
 //      }
       pthread_mutex_lock(&pSql->subState.mutex);
       if (pSql->pSubs != NULL && pSql->subState.states != NULL) {
+        for (int32_t i = 0; i < pQdesc->numOfSub; ++i) {
+          cpuTime += (pSql->pSubs[i] != NULL)? pSql->pSubs[i]->res.cpuTime : 0;
+        }
+
         for (int32_t i = 0; i < pQdesc->numOfSub; ++i) {
           SSqlObj *psub = pSql->pSubs[i];
           int64_t  self = (psub != NULL)? psub->self : 0;
@@ -299,6 +310,7 @@ int tscBuildQueryStreamDesc(void *pMsg, STscObj *pObj) {
       pthread_mutex_unlock(&pSql->subState.mutex);
     }
 
+    pCpuTime[pHeartbeat->numOfQueries] = htobe64(cpuTime);
     pQdesc->numOfSub = htonl(pQdesc->numOfSub);
     taosGetFqdn(pQdesc->fqdn);
 
@@ -338,8 +350,11 @@ int tscBuildQueryStreamDesc(void *pMsg, STscObj *pObj) {
     if (pHeartbeat->numOfStreams >= allocedStreamsNum) break;
   }
 
-  int32_t msgLen = pHeartbeat->numOfQueries * sizeof(SQueryDesc) + pHeartbeat->numOfStreams * sizeof(SStreamDesc) +
-                   sizeof(SHeartBeatMsg);
+  memmove(pSdesc, pCpuTime, pHeartbeat->numOfQueries * sizeof(int64_t));
+  pHeartbeat->extend = TSDB_MSG_EXT_CPU_TIME;
+
+  int32_t msgLen = pHeartbeat->numOfQueries * (sizeof(SQueryDesc) + sizeof(int64_t)) +
+                   pHeartbeat->numOfStreams * sizeof(SStreamDesc) + sizeof(SHeartBeatMsg);
   pHeartbeat->connId = htonl(pObj->connId);
   pHeartbeat->numOfQueries = htonl(pHeartbeat->numOfQueries);
   pHeartbeat->numOfStreams = htonl(pHeartbeat->numOfStreams);
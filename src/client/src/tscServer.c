@@ -1988,7 +1988,8 @@ int tscProcessRetrieveGlobalMergeRsp(SSqlObj *pSql) {
   }
 
   uint64_t localQueryId = pSql->self;
-  qTableQuery(pQueryInfo->pQInfo, &localQueryId);
+  bool     continueExec = false;
+  qTableQuery(pQueryInfo->pQInfo, &localQueryId, &continueExec);
   bool convertJson = true;
   if (pQueryInfo->isStddev == true) convertJson = false;
   convertQueryResult(pRes, pQueryInfo, pSql->self, true, convertJson);
@@ -2119,7 +2120,8 @@ int tscBuildHeartBeatMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
     numOfStreams++;
   }
 
-  int size = numOfQueries * sizeof(SQueryDesc) + numOfStreams * sizeof(SStreamDesc) + sizeof(SHeartBeatMsg) + 100;
+  int size = numOfQueries * (sizeof(SQueryDesc) + sizeof(int64_t)) + numOfStreams * sizeof(SStreamDesc) +
+             sizeof(SHeartBeatMsg) + 100;
   if (TSDB_CODE_SUCCESS != tscAllocPayload(pCmd, size)) {
     pthread_mutex_unlock(&pObj->mutex);
     tscError("0x%"PRIx64" failed to create heartbeat msg", pSql->self);
@@ -2727,6 +2729,7 @@ int tscProcessConnectRsp(SSqlObj *pSql) {
   strcpy(pObj->sversion, pConnect->serverVersion);
   pObj->writeAuth = pConnect->writeAuth;
   pObj->superAuth = pConnect->superAuth;
+  pObj->features = pConnect->features;
   pObj->connId = htonl(pConnect->connId);
   tstrncpy(pObj->clusterId, pConnect->clusterId, sizeof(pObj->clusterId));  
   
@@ -2896,6 +2899,14 @@ int tscProcessRetrieveRspFromNode(SSqlObj *pSql) {
     decompressQueryColData(pSql, pRes, pQueryInfo, &pRes->data, pRetrieve->compressed, compLen);
   }
 
+  // the cpu time is appended by the vnodes of new versions only
+  pRetrieve = (SRetrieveTableRsp *)pRes->pRsp;
+  if ((pRetrieve->extend & TSDB_MSG_EXT_CPU_TIME) && pRes->rspLen >= sizeof(SRetrieveTableRsp) + sizeof(int64_t)) {
+    pRes->cpuTime = htobe64(*(int64_t *)(pRes->pRsp + pRes->rspLen - sizeof(int64_t)));
+  } else {
+    pRes->cpuTime = 0;
+  }
+
   STableMetaInfo *pTableMetaInfo = tscGetMetaInfo(pQueryInfo, 0);
   if ((pCmd->command == TSDB_SQL_RETRIEVE) ||
       ((UTIL_TABLE_IS_CHILD_TABLE(pTableMetaInfo) || UTIL_TABLE_IS_NORMAL_TABLE(pTableMetaInfo)) &&
@@ -19,6 +19,7 @@
 #include "tscUtil.h"
 #include "tsched.h"
 #include "tcache.h"
+#include "tcompare.h"
 #include "tsclient.h"
 #include "ttimer.h"
 #include "tutil.h"
@@ -48,6 +49,389 @@ static bool isProjectStream(SQueryInfo* pQueryInfo) {
   return true;
 }
 
+/*
+ * Incremental stream: a sliding window of N * sliding is made up of N panes of the sliding length. The stream queries
+ * each pane only once, keeps the partial results of the panes that are still needed, and merges the panes into the
+ * time windows, so that a row is scanned once instead of once per window covering it. Late data in the recently
+ * closed panes is picked up by querying them again, which reopens the windows already output.
+ */
+#define STREAM_PANE_VAL_OFFSET 8  // the null flag and the length of var data are ahead of the value of each column
+
+enum {
+  STREAM_PANE_MERGE_TS = 0,  // the start of the time window
+  STREAM_PANE_MERGE_GROUP,   // tag or tbname of the group
+  STREAM_PANE_MERGE_SUM,
+  STREAM_PANE_MERGE_MIN,
+  STREAM_PANE_MERGE_MAX,
+  STREAM_PANE_MERGE_FIRST,
+  STREAM_PANE_MERGE_LAST,
+};
+
+typedef struct SStreamPaneCol {
+  int8_t  mergeType;
+  int16_t type;
+  int32_t bytes;
+  int32_t offset;
+} SStreamPaneCol;
+
+typedef struct SStreamPane {
+  TSKEY ts;
+  char *data;
+} SStreamPane;
+
+typedef struct SStreamIncInfo {
+  int32_t         numOfCols;
+  int32_t         rowSize;
+  SStreamPaneCol *cols;
+  SInterval       paneInterval;
+  SHashObj       *pGroups;    // SArray<SStreamPane> of each group, sorted by ts
+  TSKEY           firstWin;   // the first time window of the stream
+  TSKEY           nextWin;    // the next time window to output
+  TSKEY           reopenWin;  // the first output time window changed by late data, INT64_MAX if none
+  int64_t         lateWin;
+  int32_t        *length;
+  char           *keyBuf;
+} SStreamIncInfo;
+
+static int8_t tscStreamIncGetMergeType(int16_t functionId, int16_t type) {
+  switch (functionId) {
+    case TSDB_FUNC_TS:
+      return STREAM_PANE_MERGE_TS;
+    case TSDB_FUNC_TAG:
+    case TSDB_FUNC_TAGPRJ:
+      return STREAM_PANE_MERGE_GROUP;
+    case TSDB_FUNC_COUNT:
+    case TSDB_FUNC_SUM:
+      return (type == TSDB_DATA_TYPE_BIGINT || type == TSDB_DATA_TYPE_UBIGINT || type == TSDB_DATA_TYPE_DOUBLE)
+                 ? STREAM_PANE_MERGE_SUM
+                 : -1;
+    case TSDB_FUNC_MIN:
+      return IS_NUMERIC_TYPE(type) ? STREAM_PANE_MERGE_MIN : -1;
+    case TSDB_FUNC_MAX:
+      return IS_NUMERIC_TYPE(type) ? STREAM_PANE_MERGE_MAX : -1;
+    case TSDB_FUNC_FIRST:
+    case TSDB_FUNC_FIRST_DST:
+      return STREAM_PANE_MERGE_FIRST;
+    case TSDB_FUNC_LAST:
+    case TSDB_FUNC_LAST_DST:
+      return STREAM_PANE_MERGE_LAST;
+    default:
+      return -1;
+  }
+}
+
+static void tscStreamIncDestroy(SStreamIncInfo *pInc) {
+  if (pInc == NULL) {
+    return;
+  }
+
+  void *pIter = taosHashIterate(pInc->pGroups, NULL);
+  while (pIter != NULL) {
+    SArray *pPanes = *(SArray **)pIter;
+    for (size_t i = 0; i < taosArrayGetSize(pPanes); ++i) {
+      tfree(((SStreamPane *)taosArrayGet(pPanes, i))->data);
+    }
+    taosArrayDestroy(&pPanes);
+    pIter = taosHashIterate(pInc->pGroups, pIter);
+  }
+
+  taosHashCleanup(pInc->pGroups);
+  tfree(pInc->cols);
+  tfree(pInc->length);
+  tfree(pInc->keyBuf);
+  tfree(pInc);
+}
+
+/*
+ * The stream is incremental only if each output column of a window can be merged from the results of its panes,
+ * and the panes line up with the windows.
+ */
+static SStreamIncInfo *tscStreamIncCreate(SSqlStream *pStream, SQueryInfo *pQueryInfo) {
+  SInterval *pInterval = &pQueryInfo->interval;
+
+  if (!tsStreamIncremental || pStream->isProject || pInterval->intervalUnit == 'n' || pInterval->intervalUnit == 'y' ||
+      pInterval->slidingUnit == 'n' || pInterval->slidingUnit == 'y' || pInterval->offset != 0 ||
+      pInterval->sliding <= 0 || pInterval->interval <= pInterval->sliding ||
+      pInterval->interval % pInterval->sliding != 0) {
+    return NULL;
+  }
+
+  if (pQueryInfo->fillType != TSDB_FILL_NONE || pQueryInfo->havingFieldNum > 0 || pQueryInfo->limit.limit >= 0 ||
+      pQueryInfo->slimit.limit >= 0 || pQueryInfo->order.order != TSDB_ORDER_ASC || pQueryInfo->numOfTables != 1 ||
+      taosArrayGetSize(pQueryInfo->pUpstream) > 0 || pQueryInfo->arithmeticOnAgg || pQueryInfo->distinct) {
+    return NULL;
+  }
+
+  int32_t numOfCols = tscNumOfFields(pQueryInfo);
+  if (numOfCols <= 1) {
+    return NULL;
+  }
+
+  SStreamIncInfo *pInc = calloc(1, sizeof(SStreamIncInfo));
+  if (pInc == NULL) {
+    return NULL;
+  }
+
+  pInc->numOfCols = numOfCols;
+  pInc->cols = calloc(numOfCols, sizeof(SStreamPaneCol));
+  pInc->length = calloc(numOfCols, sizeof(int32_t));
+  if (pInc->cols == NULL || pInc->length == NULL) {
+    goto _ineligible;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SInternalField *pField = tscFieldInfoGetInternalField(&pQueryInfo->fieldsInfo, i);
+    if (!pField->visible || pField->pExpr == NULL || pField->pExpr->pExpr != NULL) {
+      goto _ineligible;
+    }
+
+    SStreamPaneCol *pCol = &pInc->cols[i];
+    pCol->mergeType = tscStreamIncGetMergeType(pField->pExpr->base.functionId, pField->field.type);
+    if (pCol->mergeType < 0 || ((pCol->mergeType == STREAM_PANE_MERGE_TS) != (i == 0))) {
+      goto _ineligible;
+    }
+
+    pCol->type = pField->field.type;
+    pCol->bytes = pField->field.bytes;
+    pCol->offset = pInc->rowSize;
+    pInc->rowSize += ALIGN8(STREAM_PANE_VAL_OFFSET + pCol->bytes);
+  }
+
+  pInc->keyBuf = calloc(1, pInc->rowSize + 1);
+  pInc->pGroups = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (pInc->keyBuf == NULL || pInc->pGroups == NULL) {
+    goto _ineligible;
+  }
+
+  // the late window is made up of whole panes
+  int64_t lateWin = convertTimePrecision(tsStreamLateWindow, TSDB_TIME_PRECISION_MILLI, pStream->precision);
+  pInc->lateWin = (lateWin + pInterval->sliding - 1) / pInterval->sliding * pInterval->sliding;
+
+  pInc->firstWin = pStream->stime;
+  pInc->nextWin = pStream->stime;
+  pInc->reopenWin = INT64_MAX;
+
+  // query the panes instead of the windows
+  pInterval->interval = pInterval->sliding;
+  pInc->paneInterval = *pInterval;
+
+  return pInc;
+
+_ineligible:
+  tscStreamIncDestroy(pInc);
+  return NULL;
+}
+
+static TSKEY tscStreamIncGetQueryStart(const SSqlStream *pStream) {
+  const SStreamIncInfo *pInc = pStream->pInc;
+
+  if (pStream->stime == INT64_MIN || pInc->lateWin == 0) {
+    return pStream->stime;
+  }
+
+  TSKEY skey = pStream->stime - pInc->lateWin;
+  return (skey < pInc->firstWin) ? pInc->firstWin : skey;
+}
+
+// index of the first pane not earlier than ts
+static size_t tscStreamIncSearchPane(SArray *pPanes, TSKEY ts) {
+  size_t low = 0, high = taosArrayGetSize(pPanes);
+  while (low < high) {
+    size_t mid = (low + high) >> 1;
+    if (((SStreamPane *)taosArrayGet(pPanes, mid))->ts < ts) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+static void tscStreamIncReopen(SSqlStream *pStream, TSKEY ts) {
+  SStreamIncInfo *pInc = pStream->pInc;
+  TSKEY           win = ts - pStream->interval.interval + pStream->interval.sliding;
+
+  if (pInc->nextWin == INT64_MIN || win >= pInc->nextWin) {
+    return;
+  }
+
+  if (win < pInc->firstWin) {
+    win = pInc->firstWin;
+  }
+
+  if (win < pInc->reopenWin) {
+    pInc->reopenWin = win;
+  }
+}
+
+static int32_t tscStreamIncAddPane(SSqlStream *pStream, TAOS_ROW row) {
+  SStreamIncInfo *pInc = pStream->pInc;
+
+  char *data = calloc(1, pInc->rowSize);
+  if (data == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  int32_t keyLen = 1;  // hash keys can not be empty, even without any group column
+  for (int32_t i = 0; i < pInc->numOfCols; ++i) {
+    SStreamPaneCol *pCol = &pInc->cols[i];
+    char           *slot = data + pCol->offset;
+    char           *val = slot + STREAM_PANE_VAL_OFFSET;
+
+    if (row[i] == NULL) {
+      slot[0] = 1;
+    } else if (IS_VAR_DATA_TYPE(pCol->type)) {
+      memcpy(val, row[i], varDataLen((char *)row[i] - VARSTR_HEADER_SIZE));
+      varDataSetLen(val - VARSTR_HEADER_SIZE, varDataLen((char *)row[i] - VARSTR_HEADER_SIZE));
+    } else {
+      memcpy(val, row[i], pCol->bytes);
+    }
+
+    if (pCol->mergeType == STREAM_PANE_MERGE_GROUP) {
+      int32_t len = STREAM_PANE_VAL_OFFSET +
+                    (IS_VAR_DATA_TYPE(pCol->type) ? varDataLen(val - VARSTR_HEADER_SIZE) : pCol->bytes);
+      memcpy(pInc->keyBuf + keyLen, slot, len);
+      keyLen += len;
+    }
+  }
+
+  TSKEY   ts = *(TSKEY *)row[0];
+  SArray *pPanes = NULL;
+
+  SArray **ppPanes = taosHashGet(pInc->pGroups, pInc->keyBuf, keyLen);
+  if (ppPanes != NULL) {
+    pPanes = *ppPanes;
+  } else {
+    pPanes = taosArrayInit(16, sizeof(SStreamPane));
+    if (pPanes == NULL || taosHashPut(pInc->pGroups, pInc->keyBuf, keyLen, &pPanes, POINTER_BYTES) != 0) {
+      taosArrayDestroy(&pPanes);
+      free(data);
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  size_t       idx = tscStreamIncSearchPane(pPanes, ts);
+  SStreamPane *pPane = (idx < taosArrayGetSize(pPanes)) ? taosArrayGet(pPanes, idx) : NULL;
+
+  if (pPane != NULL && pPane->ts == ts) {
+    // the pane is queried again for late data
+    if (memcmp(pPane->data, data, pInc->rowSize) == 0) {
+      free(data);
+      return TSDB_CODE_SUCCESS;
+    }
+
+    free(pPane->data);
+    pPane->data = data;
+  } else {
+    SStreamPane pane = {.ts = ts, .data = data};
+    if (taosArrayInsert(pPanes, idx, &pane) == NULL) {
+      free(data);
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+  }
+
+  tscStreamIncReopen(pStream, ts);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tscStreamIncMergeVal(const SStreamPaneCol *pCol, char *slot, const char *paneSlot) {
+  char       *val = slot + STREAM_PANE_VAL_OFFSET;
+  const char *paneVal = paneSlot + STREAM_PANE_VAL_OFFSET;
+
+  if (pCol->mergeType == STREAM_PANE_MERGE_TS || pCol->mergeType == STREAM_PANE_MERGE_GROUP || paneSlot[0]) {
+    return;
+  }
+
+  if (slot[0] || pCol->mergeType == STREAM_PANE_MERGE_LAST) {
+    memcpy(slot, paneSlot, ALIGN8(STREAM_PANE_VAL_OFFSET + pCol->bytes));
+    return;
+  }
+
+  switch (pCol->mergeType) {
+    case STREAM_PANE_MERGE_SUM:
+      if (pCol->type == TSDB_DATA_TYPE_DOUBLE) {
+        *(double *)val += *(const double *)paneVal;
+      } else if (pCol->type == TSDB_DATA_TYPE_UBIGINT) {
+        *(uint64_t *)val += *(const uint64_t *)paneVal;
+      } else {
+        *(int64_t *)val += *(const int64_t *)paneVal;
+      }
+      break;
+    case STREAM_PANE_MERGE_MIN:
+      if (getComparFunc(pCol->type, 0)(paneVal, val) < 0) {
+        memcpy(val, paneVal, pCol->bytes);
+      }
+      break;
+    case STREAM_PANE_MERGE_MAX:
+      if (getComparFunc(pCol->type, 0)(paneVal, val) > 0) {
+        memcpy(val, paneVal, pCol->bytes);
+      }
+      break;
+    default:  // the first one is kept
+      break;
+  }
+}
+
+// merge the panes [start, end) into the row of the time window
+static TAOS_ROW tscStreamIncMergeWindow(SStreamIncInfo *pInc, SArray *pPanes, size_t start, size_t end, TSKEY win) {
+  char *buf = malloc(POINTER_BYTES * pInc->numOfCols + pInc->rowSize);
+  if (buf == NULL) {
+    return NULL;
+  }
+
+  TAOS_ROW row = (TAOS_ROW)buf;
+  char    *data = buf + POINTER_BYTES * pInc->numOfCols;
+
+  memcpy(data, ((SStreamPane *)taosArrayGet(pPanes, start))->data, pInc->rowSize);
+  for (size_t i = start + 1; i < end; ++i) {
+    SStreamPane *pPane = taosArrayGet(pPanes, i);
+    for (int32_t j = 0; j < pInc->numOfCols; ++j) {
+      tscStreamIncMergeVal(&pInc->cols[j], data + pInc->cols[j].offset, pPane->data + pInc->cols[j].offset);
+    }
+  }
+
+  *(TSKEY *)(data + pInc->cols[0].offset + STREAM_PANE_VAL_OFFSET) = win;
+
+  for (int32_t j = 0; j < pInc->numOfCols; ++j) {
+    char *slot = data + pInc->cols[j].offset;
+    row[j] = slot[0] ? NULL : slot + STREAM_PANE_VAL_OFFSET;
+  }
+
+  return row;
+}
+
+// drop the panes that neither a future window nor late data needs any more, the groups are kept though empty
+static void tscStreamIncPrunePanes(SSqlStream *pStream) {
+  SStreamIncInfo *pInc = pStream->pInc;
+  TSKEY           keep = pInc->nextWin;
+
+  if (pInc->lateWin > 0) {
+    TSKEY lateKeep = pStream->stime - pInc->lateWin - pStream->interval.interval + pStream->interval.sliding;
+    if (lateKeep < keep) {
+      keep = lateKeep;
+    }
+  }
+
+  void *pIter = taosHashIterate(pInc->pGroups, NULL);
+  while (pIter != NULL) {
+    SArray *pPanes = *(SArray **)pIter;
+    size_t  num = tscStreamIncSearchPane(pPanes, keep);
+    size_t  size = taosArrayGetSize(pPanes);
+
+    for (size_t i = 0; i < num; ++i) {
+      tfree(((SStreamPane *)taosArrayGet(pPanes, i))->data);
+    }
+
+    if (num > 0) {
+      memmove(pPanes->pData, TARRAY_GET_ELEM(pPanes, num), (size - num) * sizeof(SStreamPane));
+      pPanes->size = size - num;
+    }
+
+    pIter = taosHashIterate(pInc->pGroups, pIter);
+  }
+}
+
 static int64_t tscGetRetryDelayTime(SSqlStream* pStream, int64_t slidingTime, int16_t prec) {
   float retryRangeFactor = 0.3f;
   int64_t retryDelta = (int64_t)(tsRetryStreamCompDelay * retryRangeFactor);
@@ -159,6 +543,9 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
       pQueryInfo->window.ekey = pStream->etime;
     }
   } else {
+    // an incremental stream waits for the closed panes instead of the windows
+    const SInterval* pInterval = (pStream->pInc != NULL) ? &pStream->pInc->paneInterval : &pStream->interval;
+
     pQueryInfo->window.skey = pStream->stime;
     int64_t etime = taosGetTimestamp(pStream->precision);
     int64_t one = convertTimePrecision(1, TSDB_TIME_PRECISION_MILLI, pStream->precision);
@@ -166,14 +553,14 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
     etime -= convertTimePrecision(tsMaxStreamComputDelay, TSDB_TIME_PRECISION_MILLI, pStream->precision);
     if (etime > pStream->etime) {
       etime = pStream->etime;
-    } else if (pStream->interval.intervalUnit != 'y' && pStream->interval.intervalUnit != 'n') {
+    } else if (pInterval->intervalUnit != 'y' && pInterval->intervalUnit != 'n') {
       if(pStream->stime == INT64_MIN) {
-        etime = taosTimeTruncate(etime, &pStream->interval, pStream->precision) - one;
+        etime = taosTimeTruncate(etime, pInterval, pStream->precision) - one;
       } else {
-        etime = pStream->stime + (etime - pStream->stime) / pStream->interval.interval * pStream->interval.interval - one;
+        etime = pStream->stime + (etime - pStream->stime) / pInterval->interval * pInterval->interval - one;
       }
     } else {
-      etime = taosTimeTruncate(etime, &pStream->interval, pStream->precision) - one;
+      etime = taosTimeTruncate(etime, pInterval, pStream->precision) - one;
     }
     pQueryInfo->window.ekey = etime;
     if (pQueryInfo->window.skey >= pQueryInfo->window.ekey) {
@@ -202,6 +589,10 @@ static void tscProcessStreamTimer(void *handle, void *tmrId) {
       tscSetRetryTimer(pStream, pSql, timer);
       return;
     }
+
+    if (pStream->pInc != NULL) {
+      pQueryInfo->window.skey = tscStreamIncGetQueryStart(pStream);
+    }
   }
 
   tscDebug("CQ ProcessStreamTimer skey=%" PRId64 " ekey=%" PRId64 " stime=%" PRId64 " etime=%" PRId64, pQueryInfo->window.skey, pQueryInfo->window.ekey, pStream->stime, pStream->etime);
@@ -502,6 +893,154 @@ bool tbHashAdd(SHashObj *tbHash, TAOS_ROW row, TAOS_FIELD* fields, int32_t idx,
   return true;
 }
 
+// the column to split the rows into the tables of another super table
+static int32_t tscStreamGetSplitColumn(SSqlStream *pStream, TAOS_FIELD *fields, int32_t fieldsNum) {
+  char *split = "tbname"; // default
+  if(pStream->split)
+     split = pStream->split;
+  for(int32_t i = 1; i < fieldsNum; i++ ) {
+    if(strcasecmp(fields[i].name, split) == 0 ) {
+      return i;
+    }
+  }
+
+  // set default with last fields if
+  return fieldsNum - 1;
+}
+
+// output the time windows whose panes are all closed, and the output ones reopened by late data
+static void tscStreamIncOutput(SSqlStream *pStream, SSqlObj *pSql) {
+  SStreamIncInfo *pInc = pStream->pInc;
+  int64_t         interval = pStream->interval.interval;
+  int64_t         sliding = pStream->interval.sliding;
+  TSKEY           lastWin = pStream->stime - interval;
+  void           *pIter = NULL;
+
+  if (pInc->nextWin == INT64_MIN) {
+    // no start time is given, so the stream starts from the first window of the data
+    TSKEY first = INT64_MAX;
+    while ((pIter = taosHashIterate(pInc->pGroups, pIter)) != NULL) {
+      SArray *pPanes = *(SArray **)pIter;
+      if (taosArrayGetSize(pPanes) > 0 && ((SStreamPane *)taosArrayGet(pPanes, 0))->ts < first) {
+        first = ((SStreamPane *)taosArrayGet(pPanes, 0))->ts;
+      }
+    }
+
+    if (first == INT64_MAX) {
+      return;
+    }
+
+    pInc->firstWin = first - interval + sliding;
+    pInc->nextWin = pInc->firstWin;
+  }
+
+  TSKEY   fromWin = (pInc->reopenWin < pInc->nextWin) ? pInc->reopenWin : pInc->nextWin;
+  SArray *pRows = taosArrayInit(64, POINTER_BYTES);
+  if (pRows == NULL) {
+    return;
+  }
+
+  while ((pIter = taosHashIterate(pInc->pGroups, pIter)) != NULL) {
+    SArray *pPanes = *(SArray **)pIter;
+    size_t  num = taosArrayGetSize(pPanes);
+    size_t  start = tscStreamIncSearchPane(pPanes, fromWin);
+    TSKEY   win = fromWin;
+
+    while (start < num) {
+      TSKEY ts = ((SStreamPane *)taosArrayGet(pPanes, start))->ts;
+      if (ts >= win + interval) {  // skip the windows without any pane
+        win = ts - interval + sliding;
+      }
+
+      if (win > lastWin) {
+        break;
+      }
+
+      size_t end = start;
+      while (end < num && ((SStreamPane *)taosArrayGet(pPanes, end))->ts < win + interval) {
+        end++;
+      }
+
+      TAOS_ROW row = tscStreamIncMergeWindow(pInc, pPanes, start, end, win);
+      if (row != NULL) {
+        taosArrayPush(pRows, &row);
+      }
+
+      win += sliding;
+      while (start < num && ((SStreamPane *)taosArrayGet(pPanes, start))->ts < win) {
+        start++;
+      }
+    }
+  }
+
+  int32_t numOfRows = (int32_t)taosArrayGetSize(pRows);
+  if (numOfRows > 0) {
+    bool        toAnother = pStream->to != NULL;
+    SHashObj   *tbHash = NULL;
+    TAOS_FIELD *fields = NULL;
+    int32_t     colIdx = -1;
+    int32_t     dstColsNum = pStream->dstCols;
+
+    if (toAnother) {
+      tbHash = taosHashInit(100, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+      fields = taos_fetch_fields(pSql);
+      if (dstColsNum == -1) {
+        dstColsNum = pInc->numOfCols;
+      }
+      colIdx = tscStreamGetSplitColumn(pStream, fields, pInc->numOfCols);
+    }
+
+    // the rows are not in the result buffer, neither are their lengths
+    int32_t *length = pSql->res.length;
+    pSql->res.length = pInc->length;
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      TAOS_ROW row = taosArrayGetP(pRows, i);
+      for (int32_t j = 0; j < pInc->numOfCols; ++j) {
+        if (row[j] == NULL) {
+          pInc->length[j] = 0;
+        } else if (IS_VAR_DATA_TYPE(pInc->cols[j].type)) {
+          pInc->length[j] = varDataLen((char *)row[j] - VARSTR_HEADER_SIZE);
+        } else {
+          pInc->length[j] = pInc->cols[j].bytes;
+        }
+      }
+
+      if (toAnother) {
+        tbHashAdd(tbHash, row, fields, colIdx, dstColsNum);
+        if (i == numOfRows - 1) {
+          (*pStream->fp)(pStream->param, pSql, row);
+        }
+      } else {
+        (*pStream->fp)(pStream->param, pSql, row);
+      }
+      pStream->numOfRes++;
+    }
+
+    pSql->res.length = length;
+
+    if (toAnother) {
+      toAnotherTable(pSql->pTscObj, pStream->to, fields, dstColsNum, tbHash, numOfRows);
+      taosHashCleanup(tbHash);
+    }
+  }
+
+  tscDebug("0x%" PRIx64 " stream:%p, %d windows from %" PRId64 " are output by merging panes", pSql->self, pStream,
+           numOfRows, fromWin);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    free(taosArrayGetP(pRows, i));
+  }
+  taosArrayDestroy(&pRows);
+
+  if (lastWin + sliding > pInc->nextWin) {
+    pInc->nextWin = lastWin + sliding;
+  }
+  pInc->reopenWin = INT64_MAX;
+
+  tscStreamIncPrunePanes(pStream);
+}
+
 static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOfRows) {
   SSqlStream *    pStream = (SSqlStream *)param;
   SSqlObj *       pSql = (SSqlObj *)res;
@@ -517,7 +1056,19 @@ static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOf
   SQueryInfo* pQueryInfo = tscGetQueryInfo(&pSql->cmd);
   STableMetaInfo *pTableMetaInfo = pQueryInfo->pTableMetaInfo[0];
 
-  if (numOfRows > 0) { // when reaching here the first execution of stream computing is successful.
+  if (numOfRows > 0 && pStream->pInc != NULL) {
+    // the rows are the results of the panes, which are output when their windows are closed
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      TAOS_ROW row = taos_fetch_row(res);
+      if (row != NULL && tscStreamIncAddPane(pStream, row) != TSDB_CODE_SUCCESS) {
+        tscError("0x%"PRIx64" stream:%p, failed to keep the result of pane:%" PRId64, pSql->self, pStream, *(TSKEY*)row[0]);
+      }
+    }
+
+    if (pQueryInfo->pQInfo == NULL || pQueryInfo->pQInfo->code == TSDB_CODE_SUCCESS) {
+      taos_fetch_rows_a(res, tscProcessStreamRetrieveResult, pStream);
+    }
+  } else if (numOfRows > 0) { // when reaching here the first execution of stream computing is successful.
     // init hash
     SHashObj* tbHash = NULL;
     int32_t colIdx = -1;
@@ -532,21 +1083,7 @@ static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOf
       fieldsNum = tscNumOfFields(pQueryInfo);
       if(dstColsNum == -1) 
          dstColsNum = fieldsNum;
-      //search split column
-      char *split = "tbname"; // default
-      if(pStream->split)
-         split = pStream->split;
-      for(int32_t i = 1; i < fieldsNum; i++ ) {
-        if(strcasecmp(fields[i].name, split) == 0 ) {
-          colIdx = i;
-          break;
-        }
-      }
-
-      // set default with last fields if
-      if(colIdx == -1) { 
-        colIdx = fieldsNum - 1; 
-      }
+      colIdx = tscStreamGetSplitColumn(pStream, fields, fieldsNum);
     }
 
     // save rows
@@ -586,6 +1123,11 @@ static void tscProcessStreamRetrieveResult(void *param, TAOS_RES *res, int numOf
     }
   } else {  // numOfRows == 0, all data has been retrieved
     pStream->useconds += pSql->res.useconds;
+    if (pStream->pInc != NULL && pQueryInfo->window.ekey != INT64_MAX) {
+      pStream->stime = pQueryInfo->window.ekey + 1;
+      tscStreamIncOutput(pStream, pSql);
+    }
+
     if (pStream->numOfRes == 0) {
       if (pStream->isProject) {
         /* no resuls in the query range, retry */
@@ -879,6 +1421,12 @@ static void tscCreateStream(void *param, TAOS_RES *res, int code) {
     pStream->stime = pStream->ltime;
   }
 
+  pStream->pInc = tscStreamIncCreate(pStream, pQueryInfo);
+  if (pStream->pInc != NULL) {
+    tscDebug("0x%"PRIx64" stream:%p is incremental, panes of %" PRId64 " in each window of %" PRId64, pSql->self, pStream,
+             pStream->interval.sliding, pStream->interval.interval);
+  }
+
   int64_t starttime = tscGetFirstLaunchTime(pStream);
   pCmd->command = TSDB_SQL_SELECT;
 
@@ -1121,6 +1669,7 @@ void taos_close_stream(TAOS_STREAM *handle) {
       tfree(pStream->split);
       pStream->split = NULL;
     }
+    tscStreamIncDestroy(pStream->pInc);
     tfree(pStream);
   }
 }
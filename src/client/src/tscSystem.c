@@ -25,7 +25,9 @@
 #include "tglobal.h"
 #include "tconfig.h"
 #include "ttimezone.h"
+#include "tscompression.h"
 #include "qScript.h"
+#include "tscParseLine.h"
 
 // global, not configurable
 #define TSC_VAR_NOT_RELEASE 1
@@ -184,6 +186,8 @@ void taos_init_imp(void) {
   errno = TSDB_CODE_SUCCESS;
   srand(taosGetTimestampSec());
   deltaToUtcInitOnce();
+  taosResolveDecompress();
+  tscResolveSmlScanner();
 
   if (tscEmbedded == 0) {
 
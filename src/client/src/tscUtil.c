@@ -1545,7 +1545,8 @@ void handleDownstreamOperator(SSqlObj** pSqlObjList, int32_t numOfUpstream, SQue
   }
 
   uint64_t qId = pSql->self;
-  qTableQuery(px->pQInfo, &qId);
+  bool     continueExec = false;
+  qTableQuery(px->pQInfo, &qId, &continueExec);
   convertQueryResult(pOutput, px, pSql->self, true, false);
 }
 
@@ -1794,6 +1795,7 @@ void tscDestroyDataBlock(SSqlObj *pSql, STableDataBlocks* pDataBlock, bool remov
   }
 
   tfree(pDataBlock->pData);
+  tscDestroyBindColumns(pDataBlock);
 
   if (removeMeta) {
     char name[TSDB_TABLE_FNAME_LEN] = {0};
@@ -1816,8 +1818,22 @@ void tscDestroyDataBlock(SSqlObj *pSql, STableDataBlocks* pDataBlock, bool remov
   tfree(pDataBlock);
 }
 
+void tscDestroyBindColumns(STableDataBlocks* pDataBlock) {
+  if (pDataBlock->pCols == NULL) {
+    return;
+  }
+
+  int32_t numOfCols = tscGetNumOfColumns(pDataBlock->pTableMeta);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    tfree(pDataBlock->pCols[i].pData);
+    tfree(pDataBlock->pCols[i].offsets);
+  }
+
+  tfree(pDataBlock->pCols);
+}
+
 SParamInfo* tscAddParamToDataBlock(STableDataBlocks* pDataBlock, char type, uint8_t timePrec, int16_t bytes,
-                                   uint32_t offset) {
+                                   uint32_t offset, int16_t colIndex) {
   uint32_t needed = pDataBlock->numOfParams + 1;
   if (needed > pDataBlock->numOfAllocedParams) {
     needed *= 2;
@@ -1835,6 +1851,7 @@ SParamInfo* tscAddParamToDataBlock(STableDataBlocks* pDataBlock, char type, uint
   param->timePrec = timePrec;
   param->bytes = bytes;
   param->offset = offset;
+  param->colIndex = colIndex;
 
   ++pDataBlock->numOfParams;
   return param;
@@ -2137,6 +2154,130 @@ static int trimDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SI
   return len;
 }
 
+// the length of the columns of the bound rows in the columnar submit block, or -1 if some rows are not bound
+static int32_t getColumnarDataSize(STableDataBlocks* pTableDataBlock, int32_t numOfRows) {
+  int32_t  numOfCols = tscGetNumOfColumns(pTableDataBlock->pTableMeta);
+  SSchema* pSchema = tscGetTableSchema(pTableDataBlock->pTableMeta);
+
+  if (pTableDataBlock->pCols == NULL) {
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < pTableDataBlock->numOfParams; ++i) {
+    if (pTableDataBlock->pCols[pTableDataBlock->params[i].colIndex].numOfRows < numOfRows) {
+      return -1;
+    }
+  }
+
+  int32_t len = 0;
+  for (int32_t j = 0; j < numOfCols; ++j) {
+    SBindColumn* pCol = pTableDataBlock->pCols + j;
+
+    if (!IS_VAR_DATA_TYPE(pSchema[j].type)) {
+      len += numOfRows * TYPE_BYTES[pSchema[j].type];
+    } else if (pCol->numOfRows > 0) {
+      len += (numOfRows + 1) * sizeof(int32_t) + pCol->offsets[numOfRows];
+    } else {  // the NULL value of nchar is the longest one
+      len += (numOfRows + 1) * sizeof(int32_t) + numOfRows * (VARSTR_HEADER_SIZE + sizeof(int32_t));
+    }
+  }
+
+  return len;
+}
+
+/*
+ * gather the bound columns into the columnar submit block, the rows are in the order of blkKeyTuple, or in the bound
+ * order if it is NULL. The columns without value are filled with NULL.
+ */
+static int trimColumnarBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SInsertStatementParam* insertParam,
+                             SBlockKeyTuple* blkKeyTuple) {
+  int32_t  numOfCols = tscGetNumOfColumns(pTableDataBlock->pTableMeta);
+  SSchema* pSchema = tscGetTableSchema(pTableDataBlock->pTableMeta);
+
+  SSubmitBlk* pBlock = pDataBlock;
+  memcpy(pDataBlock, pTableDataBlock->pData, sizeof(SSubmitBlk));
+  pDataBlock = (char*)pDataBlock + sizeof(SSubmitBlk);
+
+  pBlock->flag |= FLAG_BLK_COLUMNAR;
+  pBlock->schemaLen = 0;
+
+  if (insertParam->schemaAttached) {
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      STColumn* pCol = (STColumn*)pDataBlock;
+      pCol->colId = htons(pSchema[j].colId);
+      pCol->type = pSchema[j].type;
+      pCol->bytes = htons(pSchema[j].bytes);
+      pCol->offset = 0;
+
+      pDataBlock = (char*)pDataBlock + sizeof(STColumn);
+    }
+
+    pBlock->schemaLen = sizeof(STColumn) * numOfCols;
+  }
+
+  char*   start = pDataBlock;
+  int32_t numOfRows = htons(pBlock->numOfRows);
+
+  for (int32_t j = 0; j < numOfCols; ++j) {
+    SBindColumn* pCol = pTableDataBlock->pCols + j;
+    int16_t      type = pSchema[j].type;
+
+    if (!IS_VAR_DATA_TYPE(type)) {
+      int32_t bytes = TYPE_BYTES[type];
+
+      if (pCol->numOfRows == 0) {
+        setNullN(pDataBlock, type, bytes, numOfRows);
+      } else if (blkKeyTuple == NULL) {
+        memcpy(pDataBlock, pCol->pData, numOfRows * bytes);
+      } else {
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          intptr_t row = (intptr_t)blkKeyTuple[i].payloadAddr;
+          memcpy((char*)pDataBlock + bytes * i, pCol->pData + bytes * row, bytes);
+        }
+      }
+
+      pDataBlock = (char*)pDataBlock + numOfRows * bytes;
+      continue;
+    }
+
+    int32_t* offsets = pDataBlock;
+    char*    values = (char*)pDataBlock + (numOfRows + 1) * sizeof(int32_t);
+    int32_t  len = 0;
+
+    if (pCol->numOfRows == 0) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        offsets[i] = len;
+        setVardataNull(values + len, type);
+        len += varDataTLen(values + len);
+      }
+    } else if (blkKeyTuple == NULL) {
+      len = pCol->offsets[numOfRows];
+      memcpy(offsets, pCol->offsets, numOfRows * sizeof(int32_t));
+      memcpy(values, pCol->pData, len);
+    } else {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        intptr_t row = (intptr_t)blkKeyTuple[i].payloadAddr;
+        int32_t  vlen = pCol->offsets[row + 1] - pCol->offsets[row];
+
+        offsets[i] = len;
+        memcpy(values + len, pCol->pData + pCol->offsets[row], vlen);
+        len += vlen;
+      }
+    }
+
+    offsets[numOfRows] = len;
+    pDataBlock = values + len;
+  }
+
+  pBlock->dataLen = (int32_t)((char*)pDataBlock - start);
+
+  int32_t len = pBlock->dataLen + pBlock->schemaLen;
+  pBlock->dataLen = htonl(pBlock->dataLen);
+  pBlock->schemaLen = htonl(pBlock->schemaLen);
+
+  return len;
+}
+
 static int32_t getRowExpandSize(STableMeta* pTableMeta) {
   int32_t  result = TD_MEM_ROW_DATA_HEAD_SIZE;
   int32_t  columns = tscGetNumOfColumns(pTableMeta);
@@ -2174,6 +2315,7 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
   const int INSERT_HEAD_SIZE = sizeof(SMsgDesc) + sizeof(SSubmitMsg);
   int       code = 0;
   bool      isRawPayload = IS_RAW_PAYLOAD(pInsertParam->payloadType);
+  bool      isColumnarPayload = IS_COLUMNAR_PAYLOAD(pInsertParam->payloadType);
   void*     pVnodeDataBlockHashList = taosHashInit(128, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
   SArray*   pVnodeDataBlockList = taosArrayInit(8, POINTER_BYTES);
 
@@ -2200,8 +2342,19 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
         return ret;
       }
 
-      int64_t destSize = dataBuf->size + pOneTableBlock->size + pBlocks->numOfRows * expandSize +
-                         sizeof(STColumn) * tscGetNumOfColumns(pOneTableBlock->pTableMeta);
+      // the columnar block is no longer than the bound columns, although the rows are not in pData
+      int32_t columnarLen = 0;
+      if (isColumnarPayload && (columnarLen = getColumnarDataSize(pOneTableBlock, pBlocks->numOfRows)) < 0) {
+        tscError("0x%"PRIx64" table %s, not all columns of the %d rows are bound", pInsertParam->objectId,
+                 tNameGetTableName(&pOneTableBlock->tableName), pBlocks->numOfRows);
+        taosHashCleanup(pVnodeDataBlockHashList);
+        tscDestroyBlockArrayList(pSql, pVnodeDataBlockList);
+        tfree(blkKeyInfo.pKeyTuple);
+        return TSDB_CODE_TSC_INVALID_VALUE;
+      }
+
+      int64_t destSize = dataBuf->size + (isColumnarPayload ? sizeof(SSubmitBlk) + columnarLen : pOneTableBlock->size) +
+                         pBlocks->numOfRows * expandSize + sizeof(STColumn) * tscGetNumOfColumns(pOneTableBlock->pTableMeta);
 
       if (dataBuf->nAllocSize < destSize) {
         dataBuf->nAllocSize = (uint32_t)(destSize * 1.5);
@@ -2222,6 +2375,7 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
         }
       }
 
+      SBlockKeyTuple* pKeyTuple = NULL;
       if (isRawPayload) {
         tscSortRemoveDataBlockDupRowsRaw(pOneTableBlock);
         char* ekey = (char*)pBlocks->data + pOneTableBlock->rowSize * (pBlocks->numOfRows - 1);
@@ -2229,6 +2383,20 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
         tscDebug("0x%" PRIx64 " name:%s, tid:%d rows:%d sversion:%d skey:%" PRId64 ", ekey:%" PRId64,
                  pInsertParam->objectId, tNameGetTableName(&pOneTableBlock->tableName), pBlocks->tid,
                  pBlocks->numOfRows, pBlocks->sversion, GET_INT64_VAL(pBlocks->data), GET_INT64_VAL(ekey));
+      } else if (isColumnarPayload) {
+        bool ordered = pOneTableBlock->ordered;
+        if ((code = tscSortRemoveBindColumnDupRows(pOneTableBlock, &blkKeyInfo)) != 0) {
+          taosHashCleanup(pVnodeDataBlockHashList);
+          tscDestroyBlockArrayList(pSql, pVnodeDataBlockList);
+          tfree(dataBuf->pData);
+          tfree(blkKeyInfo.pKeyTuple);
+          return code;
+        }
+
+        pKeyTuple = ordered ? NULL : blkKeyInfo.pKeyTuple;
+        tscDebug("0x%" PRIx64 " name:%s, tid:%d rows:%d sversion:%d, columnar, ordered:%d", pInsertParam->objectId,
+                 tNameGetTableName(&pOneTableBlock->tableName), pBlocks->tid, pBlocks->numOfRows, pBlocks->sversion,
+                 ordered);
       } else {
         if ((code = tscSortRemoveDataBlockDupRows(pOneTableBlock, &blkKeyInfo)) != 0) {
           taosHashCleanup(pVnodeDataBlockHashList);
@@ -2245,8 +2413,9 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
                  pBlocks->numOfRows, pBlocks->sversion, blkKeyInfo.pKeyTuple->skey, pLastKeyTuple->skey);
       }
 
-      int32_t len = pBlocks->numOfRows *
-                        (isRawPayload ? (pOneTableBlock->rowSize + expandSize) : getExtendedRowSize(pOneTableBlock)) +
+      int32_t len = (isColumnarPayload ? columnarLen
+                                       : pBlocks->numOfRows * (isRawPayload ? (pOneTableBlock->rowSize + expandSize)
+                                                                            : getExtendedRowSize(pOneTableBlock))) +
                     sizeof(STColumn) * tscGetNumOfColumns(pOneTableBlock->pTableMeta);
 
       pBlocks->tid = htonl(pBlocks->tid);
@@ -2256,7 +2425,9 @@ int32_t tscMergeTableDataBlocks(SSqlObj *pSql, SInsertStatementParam *pInsertPar
       pBlocks->schemaLen = 0;
 
       // erase the empty space reserved for binary data
-      int32_t finalLen = trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, pInsertParam, blkKeyInfo.pKeyTuple);
+      int32_t finalLen = isColumnarPayload
+                             ? trimColumnarBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, pInsertParam, pKeyTuple)
+                             : trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, pInsertParam, blkKeyInfo.pKeyTuple);
       assert(finalLen <= len);
 
       dataBuf->size += (finalLen + sizeof(SSubmitBlk));
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "taos.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "hash.h"
+#include "tsclient.h"
+
+/*
+ * the cases insert through taos_schemaless_insert into a running server, the config dir of the client is taken from
+ * TAOS_TEST_CFG_DIR. They are skipped if the server can not be connected.
+ */
+namespace {
+
+const char* db = "sml_insert_test";
+
+TAOS* connectServer() {
+  static bool inited = false;
+  if (!inited) {
+    const char* cfgDir = getenv("TAOS_TEST_CFG_DIR");
+    if (cfgDir != NULL) {
+      taos_options(TSDB_OPTION_CONFIGDIR, cfgDir);
+    }
+    taos_init();
+    inited = true;
+  }
+
+  return taos_connect(NULL, "root", "taosdata", NULL, 0);
+}
+
+int32_t execute(TAOS* conn, const std::string& sql) {
+  TAOS_RES* res = taos_query(conn, sql.c_str());
+  int32_t   code = taos_errno(res);
+  taos_free_result(res);
+  return code;
+}
+
+int64_t queryInt(TAOS* conn, const std::string& sql) {
+  TAOS_RES* res = taos_query(conn, sql.c_str());
+  int64_t   val = -1;
+  if (taos_errno(res) == TSDB_CODE_SUCCESS) {
+    TAOS_ROW row = taos_fetch_row(res);
+    if (row != NULL && row[0] != NULL) {
+      val = *(int64_t*)row[0];
+    }
+  }
+  taos_free_result(res);
+  return val;
+}
+
+int32_t numOfRows(TAOS* conn, const std::string& sql) {
+  TAOS_RES* res = taos_query(conn, sql.c_str());
+  int32_t   rows = -1;
+  if (taos_errno(res) == TSDB_CODE_SUCCESS) {
+    rows = 0;
+    while (taos_fetch_row(res) != NULL) {
+      ++rows;
+    }
+  }
+  taos_free_result(res);
+  return rows;
+}
+
+int32_t insertLines(TAOS* conn, std::vector<std::string>& lines, int32_t* affectedRows = NULL) {
+  std::vector<char*> pLines;
+  for (size_t i = 0; i < lines.size(); ++i) {
+    pLines.push_back((char*)lines[i].c_str());
+  }
+
+  TAOS_RES* res = taos_schemaless_insert(conn, pLines.data(), (int)pLines.size(), TSDB_SML_LINE_PROTOCOL,
+                                         TSDB_SML_TIMESTAMP_MILLI_SECONDS);
+  int32_t code = taos_errno(res);
+  if (affectedRows != NULL) {
+    *affectedRows = taos_affected_rows(res);
+  }
+  taos_free_result(res);
+  return code;
+}
+
+typedef struct {
+  char*  key;
+  size_t keyLen;
+  void*  meta;
+  size_t size;
+} SSavedTableMeta;
+
+// the cached meta of a table is kept, so that it can be put back after the table is dropped
+SSavedTableMeta* saveTableMeta(TAOS* conn, const std::string& tbname) {
+  SHashObj* pMetaMap = (SHashObj*)((STscObj*)conn)->pClusterInfo->tableMetaMap;
+  size_t    nameLen = tbname.length();
+
+  SSavedTableMeta* pSaved = NULL;
+  void*            p = taosHashIterate(pMetaMap, NULL);
+  while (p != NULL) {
+    char*  key = (char*)taosHashGetDataKey(pMetaMap, p);
+    size_t keyLen = taosHashGetDataKeyLen(pMetaMap, p);
+
+    // the keys are the full names, which end with ".tbname"
+    if (pSaved == NULL && keyLen > nameLen && key[keyLen - nameLen - 1] == '.' &&
+        strncmp(key + keyLen - nameLen, tbname.c_str(), nameLen) == 0) {
+      pSaved = (SSavedTableMeta*)calloc(1, sizeof(SSavedTableMeta));
+      pSaved->key = (char*)malloc(keyLen);
+      pSaved->keyLen = keyLen;
+      memcpy(pSaved->key, key, keyLen);
+    }
+    p = taosHashIterate(pMetaMap, p);
+  }
+
+  if (pSaved == NULL) {
+    return NULL;
+  }
+
+  taosHashGetCloneExt(pMetaMap, pSaved->key, pSaved->keyLen, NULL, &pSaved->meta, &pSaved->size);
+  if (pSaved->meta == NULL) {
+    free(pSaved->key);
+    free(pSaved);
+    return NULL;
+  }
+
+  return pSaved;
+}
+
+// the kept meta is put back into the cache and freed
+int32_t restoreTableMeta(TAOS* conn, SSavedTableMeta* pSaved) {
+  SHashObj* pMetaMap = (SHashObj*)((STscObj*)conn)->pClusterInfo->tableMetaMap;
+
+  int32_t code = taosHashPut(pMetaMap, pSaved->key, pSaved->keyLen, pSaved->meta, pSaved->size);
+
+  free(pSaved->meta);
+  free(pSaved->key);
+  free(pSaved);
+  return code;
+}
+
+std::string line(const char* stable, int32_t tag, int64_t ts, const std::string& fields) {
+  return std::string(stable) + ",t1=t" + std::to_string(tag) + " " + fields + " " + std::to_string(ts);
+}
+
+class SmlInsertTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    conn = connectServer();
+    if (conn == NULL) {
+      GTEST_SKIP() << "server is not available";
+    }
+
+    ASSERT_EQ(execute(conn, std::string("drop database if exists ") + db), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(execute(conn, std::string("create database ") + db), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(execute(conn, std::string("use ") + db), TSDB_CODE_SUCCESS);
+  }
+
+  void TearDown() override {
+    if (conn != NULL) {
+      execute(conn, std::string("drop database if exists ") + db);
+      taos_close(conn);
+    }
+  }
+
+  TAOS* conn = NULL;
+};
+
+}  // namespace
+
+TEST_F(SmlInsertTest, create_child_tables) {
+  std::vector<std::string> lines;
+  for (int32_t t = 0; t < 3; ++t) {
+    for (int32_t r = 0; r < 10; ++r) {
+      lines.push_back(line("st", t, 1626006833000 + r, "c1=" + std::to_string(r) + "i64"));
+    }
+  }
+
+  int32_t affectedRows = 0;
+  ASSERT_EQ(insertLines(conn, lines, &affectedRows), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(affectedRows, 30);
+  EXPECT_EQ(numOfRows(conn, "select tbname from st"), 3);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st"), 30);
+
+  // the existing tables are reused, only the new tag set gets a new table
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006834000, "c1=100i64"));
+  lines.push_back(line("st", 3, 1626006834000, "c1=100i64"));
+  ASSERT_EQ(insertLines(conn, lines, &affectedRows), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(affectedRows, 2);
+  EXPECT_EQ(numOfRows(conn, "select tbname from st"), 4);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st where t1 = 't0'"), 11);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st where t1 = 't3'"), 1);
+}
+
+// a table dropped by another client is still in the local meta cache, the submit fails with an invalid table id. The
+// points are submitted again from the failed submit, after the table is created again.
+TEST_F(SmlInsertTest, stale_meta_retry) {
+  std::vector<std::string> lines;
+  for (int32_t t = 0; t < 4; ++t) {
+    lines.push_back(line("st", t, 1626006833000, "c1=0i64"));
+  }
+  ASSERT_EQ(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  TAOS_RES* res = taos_query(conn, "select tbname from st where t1 = 't2'");
+  ASSERT_EQ(taos_errno(res), TSDB_CODE_SUCCESS);
+  TAOS_ROW row = taos_fetch_row(res);
+  ASSERT_NE(row, nullptr);
+  std::string tbname((char*)row[0], taos_fetch_lengths(res)[0]);
+  taos_free_result(res);
+
+  // keep the cached meta of the table, and put it back after the table is dropped
+  SSavedTableMeta* saved = saveTableMeta(conn, tbname);
+  ASSERT_NE(saved, nullptr);
+
+  ASSERT_EQ(execute(conn, "drop table " + tbname), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(restoreTableMeta(conn, saved), 0);
+
+  // several submits, so that the stale table is not the first one
+  int32_t maxSQLStringLen = tsMaxSQLStringLen;
+  tsMaxSQLStringLen = TSDB_MAX_SQL_LEN;
+
+  lines.clear();
+  for (int32_t t = 0; t < 4; ++t) {
+    for (int32_t r = 1; r <= 2000; ++r) {
+      lines.push_back(line("st", t, 1626006833000 + r, "c1=" + std::to_string(r) + "i64"));
+    }
+  }
+
+  int32_t affectedRows = 0;
+  int32_t code = insertLines(conn, lines, &affectedRows);
+  tsMaxSQLStringLen = maxSQLStringLen;
+
+  ASSERT_EQ(code, TSDB_CODE_SUCCESS);
+  EXPECT_EQ(affectedRows, 8000);
+  EXPECT_EQ(numOfRows(conn, "select tbname from st"), 4);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st where t1 = 't2'"), 2000);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st where t1 <> 't2'"), 6003);
+}
+
+TEST_F(SmlInsertTest, var_length_overflow) {
+  std::vector<std::string> lines;
+  lines.push_back(line("st", 0, 1626006833000, "c1=\"abc\",c2=L\"abc\""));
+  ASSERT_EQ(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  // the columns are widened for the longer values
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006833001, "c1=\"" + std::string(100, 'a') + "\",c2=L\"abc\""));
+  lines.push_back(line("st", 0, 1626006833002, "c1=\"abc\",c2=L\"" + std::string(100, 'b') + "\""));
+  ASSERT_EQ(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(queryInt(conn, "select count(*) from st"), 3);
+
+  // the values longer than a column can ever be are rejected
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006833003, "c1=\"" + std::string(TSDB_MAX_BINARY_LEN + 1, 'a') + "\""));
+  EXPECT_NE(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006833004, "c2=L\"" + std::string(TSDB_MAX_NCHAR_LEN / TSDB_NCHAR_SIZE + 1, 'b') + "\""));
+  EXPECT_NE(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  EXPECT_EQ(queryInt(conn, "select count(*) from st"), 3);
+}
+
+TEST_F(SmlInsertTest, type_mismatch) {
+  std::vector<std::string> lines;
+  lines.push_back(line("st", 0, 1626006833000, "c1=1i64,c2=\"abc\""));
+  ASSERT_EQ(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  // the type of a column can not be changed by the points
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006833001, "c1=\"abc\",c2=\"abc\""));
+  EXPECT_NE(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  lines.clear();
+  lines.push_back(line("st", 0, 1626006833002, "c1=1i64,c2=2f64"));
+  EXPECT_NE(insertLines(conn, lines, NULL), TSDB_CODE_SUCCESS);
+
+  EXPECT_EQ(queryInt(conn, "select count(*) from st"), 1);
+}
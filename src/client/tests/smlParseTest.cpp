@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <iostream>
+#include <inttypes.h>
+
+#include "os.h"
+#include "taos.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "hash.h"
+#include "tutil.h"
+#include "tscParseLine.h"
+
+namespace {
+
+class SmlParser {
+ public:
+  SmlParser() {
+    memset(&info, 0, sizeof(info));
+    info.protocol = TSDB_SML_LINE_PROTOCOL;
+    info.tsType = SML_TIME_STAMP_NANO_SECONDS;
+    memset(&point, 0, sizeof(point));
+  }
+
+  ~SmlParser() {
+    destroySmlDataPoint(&point);
+    taosHashCleanup(info.keyHash);
+    tfree(info.kvBuf);
+  }
+
+  int32_t parse(const char* line) {
+    destroySmlDataPoint(&point);
+    memset(&point, 0, sizeof(point));
+    return tscParseLine(line, &point, &info);
+  }
+
+  SSmlLinesInfo       info;
+  TAOS_SML_DATA_POINT point;
+};
+
+double parseDouble(const char* value) {
+  SSmlLinesInfo info;
+  memset(&info, 0, sizeof(info));
+
+  TAOS_SML_KV kv = {0};
+  if (!convertSmlValueType(&kv, value, (uint16_t)strlen(value), &info, false)) {
+    return NAN;
+  }
+  EXPECT_EQ(kv.type, TSDB_DATA_TYPE_DOUBLE);
+
+  double v = *(double*)kv.value;
+  free(kv.value);
+  return v;
+}
+
+bool parseValue(const char* value, uint8_t type, void* dst, int32_t bytes) {
+  SSmlLinesInfo info;
+  memset(&info, 0, sizeof(info));
+
+  TAOS_SML_KV kv = {0};
+  if (!convertSmlValueType(&kv, value, (uint16_t)strlen(value), &info, false)) {
+    return false;
+  }
+  EXPECT_EQ(kv.type, type);
+  memcpy(dst, kv.value, bytes);
+  free(kv.value);
+  return true;
+}
+
+}  // namespace
+
+TEST(smlParseTest, line) {
+  SmlParser p;
+
+  const char* line = "st,t1=3i64,t2=4f64,t3=\"t3\" c1=3i64,c3=L\"passit\",c2=false,c4=4f64 1626006833639000000";
+  ASSERT_EQ(p.parse(line), TSDB_CODE_SUCCESS);
+  EXPECT_STREQ(p.point.stableName, "`st`");
+  ASSERT_EQ(p.point.tagNum, 3);
+  EXPECT_STREQ(p.point.tags[2].key, "`t3`");
+  EXPECT_EQ(p.point.tags[2].type, TSDB_DATA_TYPE_NCHAR);
+  EXPECT_EQ(std::string(p.point.tags[2].value, p.point.tags[2].length), "\"t3\"");
+
+  // the timestamp is the first field
+  ASSERT_EQ(p.point.fieldNum, 5);
+  EXPECT_STREQ(p.point.fields[0].key, "ts");
+  EXPECT_EQ(p.point.fields[0].type, TSDB_DATA_TYPE_TIMESTAMP);
+  EXPECT_EQ(*(int64_t*)p.point.fields[0].value, 1626006833639000000LL);
+  EXPECT_EQ(p.point.fields[1].type, TSDB_DATA_TYPE_BIGINT);
+  EXPECT_EQ(*(int64_t*)p.point.fields[1].value, 3);
+  EXPECT_EQ(p.point.fields[2].type, TSDB_DATA_TYPE_NCHAR);
+  EXPECT_EQ(std::string(p.point.fields[2].value, p.point.fields[2].length), "passit");
+  EXPECT_EQ(p.point.fields[3].type, TSDB_DATA_TYPE_BOOL);
+  EXPECT_EQ(*(double*)p.point.fields[4].value, 4.0);
+
+  // no tags, the hash of the keys is reused by the next line
+  ASSERT_EQ(p.parse("st c1=1,c2=2 1"), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(p.point.tagNum, 0);
+  EXPECT_EQ(p.point.fieldNum, 3);
+
+  EXPECT_NE(p.parse("st,t=a c1=1,c1=2 1"), TSDB_CODE_SUCCESS);
+  EXPECT_NE(p.parse("st,t=a 1"), TSDB_CODE_SUCCESS);
+  EXPECT_NE(p.parse("st,t=a c1=1 9223372036854775808"), TSDB_CODE_SUCCESS);
+}
+
+TEST(smlParseTest, escape) {
+  SmlParser p;
+
+  ASSERT_EQ(p.parse("m\\ e\\,as,t\\ 1=a\\ b,t\\,2=c\\=d c\\ 1=1,c\\=2=2 1"), TSDB_CODE_SUCCESS);
+  EXPECT_STREQ(p.point.stableName, "`m e,as`");
+  ASSERT_EQ(p.point.tagNum, 2);
+  EXPECT_STREQ(p.point.tags[0].key, "`t 1`");
+  EXPECT_STREQ(p.point.tags[1].key, "`t,2`");
+  EXPECT_STREQ(p.point.fields[1].key, "`c 1`");
+  EXPECT_STREQ(p.point.fields[2].key, "`c=2`");
+
+  ASSERT_EQ(p.parse("st,t=a c1=\"with, comma and space\",c2=L\"中文\" 1"), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(p.point.fieldNum, 3);
+  EXPECT_EQ(std::string(p.point.fields[1].value, p.point.fields[1].length), "with, comma and space");
+  EXPECT_EQ(std::string(p.point.fields[2].value, p.point.fields[2].length), "中文");
+
+  // the runs of plain characters longer than a vector
+  std::string value(100, 'x');
+  std::string line = "st,t=a c=\"" + value + "\\\"" + value + "\" 1";
+  ASSERT_EQ(p.parse(line.c_str()), TSDB_CODE_SUCCESS);
+  EXPECT_EQ(std::string(p.point.fields[1].value, p.point.fields[1].length), value + "\\\"" + value);
+
+  std::string key(TSDB_COL_NAME_LEN, 'k');
+  line = "st,t=a " + key + "=1 1";
+  EXPECT_NE(p.parse(line.c_str()), TSDB_CODE_SUCCESS);
+}
+
+TEST(smlParseTest, number) {
+  int8_t  i8 = 0;
+  int32_t i32 = 0;
+  int64_t i64 = 0;
+  uint64_t u64 = 0;
+
+  EXPECT_TRUE(parseValue("-127i8", TSDB_DATA_TYPE_TINYINT, &i8, sizeof(i8)));
+  EXPECT_EQ(i8, -127);
+  EXPECT_FALSE(parseValue("128i8", TSDB_DATA_TYPE_TINYINT, &i8, sizeof(i8)));
+  EXPECT_TRUE(parseValue("+2147483647i32", TSDB_DATA_TYPE_INT, &i32, sizeof(i32)));
+  EXPECT_EQ(i32, INT32_MAX);
+  EXPECT_TRUE(parseValue("-9223372036854775807i64", TSDB_DATA_TYPE_BIGINT, &i64, sizeof(i64)));
+  EXPECT_EQ(i64, -INT64_MAX);
+  EXPECT_FALSE(parseValue("9223372036854775808i64", TSDB_DATA_TYPE_BIGINT, &i64, sizeof(i64)));
+  EXPECT_TRUE(parseValue("18446744073709551614u64", TSDB_DATA_TYPE_UBIGINT, &u64, sizeof(u64)));
+  EXPECT_EQ(u64, 18446744073709551614ULL);
+  EXPECT_FALSE(parseValue("-1u64", TSDB_DATA_TYPE_UBIGINT, &u64, sizeof(u64)));
+  EXPECT_FALSE(parseValue("-i64", TSDB_DATA_TYPE_BIGINT, &i64, sizeof(i64)));
+  EXPECT_FALSE(parseValue("1.5i64", TSDB_DATA_TYPE_BIGINT, &i64, sizeof(i64)));
+
+  // the doubles of the fast path and the fallback are the same as strtod
+  const char* doubles[] = {"1.5", "-2.25e3", ".5", "1e-5", "123456789012345678901234567890", "0.1", "3.141592653589793",
+                           "1e-27", "123456789.123456789", "9007199254740993", "1e22", "1e23", "4.35", "0.3f64",
+                           "2.2250738585072014e-308", "1.7976931348623157e308"};
+  for (size_t i = 0; i < tListLen(doubles); ++i) {
+    EXPECT_EQ(parseDouble(doubles[i]), strtod(doubles[i], NULL)) << doubles[i];
+  }
+
+  EXPECT_TRUE(std::isnan(parseDouble("1e400")));
+  EXPECT_TRUE(std::isnan(parseDouble("1.2.3")));
+  EXPECT_TRUE(std::isnan(parseDouble("e5")));
+}
+
+TEST(smlParseTest, throughput) {
+  SmlParser p;
+  tscResolveSmlScanner();
+
+  const int32_t numOfLines = 200000;
+  char          line[512];
+  int64_t       st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfLines; ++i) {
+    snprintf(line, sizeof(line),
+             "cpu_load_short,host=server%02d,region=us-west,datacenter=dc%d usage_user=%d.%d,usage_system=%di64,"
+             "usage_idle=%d.5,status=\"running normally\",online=true %" PRId64,
+             i % 100, i % 7, i % 100, i % 10, i % 37, i % 1000, (int64_t)1626006833639000000LL + i);
+    ASSERT_EQ(p.parse(line), TSDB_CODE_SUCCESS) << line;
+  }
+
+  double elapsed = (taosGetTimestampUs() - st) / 1000000.0;
+  std::cout << numOfLines << " lines are parsed in " << elapsed << " seconds, " << numOfLines / elapsed
+            << " lines per second" << std::endl;
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "taos.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "tsclient.h"
+
+/*
+ * the rows bound by columns through stmt are inserted into a running server, the config dir of the client is taken
+ * from TAOS_TEST_CFG_DIR. They are skipped if the server can not be connected.
+ */
+namespace {
+
+const char* db = "stmt_columnar_test";
+
+TAOS* connectServer() {
+  static bool inited = false;
+  if (!inited) {
+    const char* cfgDir = getenv("TAOS_TEST_CFG_DIR");
+    if (cfgDir != NULL) {
+      taos_options(TSDB_OPTION_CONFIGDIR, cfgDir);
+    }
+    taos_init();
+    inited = true;
+  }
+
+  return taos_connect(NULL, "root", "taosdata", NULL, 0);
+}
+
+int32_t execute(TAOS* conn, const std::string& sql) {
+  TAOS_RES* res = taos_query(conn, sql.c_str());
+  int32_t   code = taos_errno(res);
+  taos_free_result(res);
+  return code;
+}
+
+struct SRow {
+  int64_t     ts;
+  int32_t     c1;
+  std::string c2;
+};
+
+// the rows are bound in batches of the given sizes, and executed at once
+int32_t insertRows(TAOS* conn, const std::vector<SRow>& rows, const std::vector<int32_t>& batches) {
+  TAOS_STMT* stmt = taos_stmt_init(conn);
+  int32_t    code = taos_stmt_prepare(stmt, "insert into t values(?, ?, ?)", 0);
+
+  size_t start = 0;
+  for (size_t b = 0; b < batches.size() && code == TSDB_CODE_SUCCESS; ++b) {
+    int32_t              num = batches[b];
+    std::vector<int64_t> ts(num);
+    std::vector<int32_t> c1(num);
+    std::vector<char>    c2(num * 16);
+    std::vector<int32_t> c2Len(num);
+    for (int32_t i = 0; i < num; ++i) {
+      const SRow& row = rows[start + i];
+      ts[i] = row.ts;
+      c1[i] = row.c1;
+      memcpy(&c2[i * 16], row.c2.c_str(), row.c2.size());
+      c2Len[i] = (int32_t)row.c2.size();
+    }
+    start += num;
+
+    TAOS_MULTI_BIND params[3];
+    memset(params, 0, sizeof(params));
+    params[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+    params[0].buffer_length = sizeof(int64_t);
+    params[0].buffer = ts.data();
+    params[0].num = num;
+
+    params[1].buffer_type = TSDB_DATA_TYPE_INT;
+    params[1].buffer_length = sizeof(int32_t);
+    params[1].buffer = c1.data();
+    params[1].num = num;
+
+    params[2].buffer_type = TSDB_DATA_TYPE_BINARY;
+    params[2].buffer_length = 16;
+    params[2].buffer = c2.data();
+    params[2].length = c2Len.data();
+    params[2].num = num;
+
+    code = taos_stmt_bind_param_batch(stmt, params);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = taos_stmt_add_batch(stmt);
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = taos_stmt_execute(stmt);
+  }
+
+  taos_stmt_close(stmt);
+  return code;
+}
+
+std::vector<SRow> queryRows(TAOS* conn) {
+  std::vector<SRow> rows;
+  TAOS_RES*         res = taos_query(conn, "select ts, c1, c2 from t");
+  if (taos_errno(res) == TSDB_CODE_SUCCESS) {
+    TAOS_ROW row = NULL;
+    while ((row = taos_fetch_row(res)) != NULL) {
+      int* lengths = taos_fetch_lengths(res);
+      rows.push_back({*(int64_t*)row[0], *(int32_t*)row[1], std::string((char*)row[2], lengths[2])});
+    }
+  }
+  taos_free_result(res);
+  return rows;
+}
+
+// the bound rows are disordered, and each of the timestamps 1626006833000 and 1626006833002 is bound twice
+const std::vector<SRow> boundRows = {
+    {1626006833002, 20, "b"}, {1626006833000, 0, "first"}, {1626006833001, 10, "a"},
+    {1626006833000, 1, "second"}, {1626006833003, 30, ""}, {1626006833002, 21, "bb"},
+};
+
+class StmtColumnarTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    clientMerge = tsClientMerge;
+    conn = connectServer();
+    if (conn == NULL) {
+      GTEST_SKIP() << "server is not available";
+    }
+
+    // the stmt of the connection binds by columns and submits columnar blocks
+    ASSERT_NE(((STscObj*)conn)->features & TSDB_CONN_FEATURE_COLUMNAR_SUBMIT, 0);
+  }
+
+  void TearDown() override {
+    tsClientMerge = clientMerge;
+    if (conn != NULL) {
+      execute(conn, std::string("drop database if exists ") + db);
+      taos_close(conn);
+    }
+  }
+
+  void createTable(int32_t update) {
+    ASSERT_EQ(execute(conn, std::string("drop database if exists ") + db), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(execute(conn, std::string("create database ") + db + " update " + std::to_string(update)),
+              TSDB_CODE_SUCCESS);
+    ASSERT_EQ(execute(conn, std::string("use ") + db), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(execute(conn, "create table t (ts timestamp, c1 int, c2 binary(16))"), TSDB_CODE_SUCCESS);
+  }
+
+  // the rows of the same timestamp are merged in the bound order, by the client or by tsdb
+  void roundTrip(int32_t update, const std::vector<int32_t>& batches) {
+    for (int8_t merge = 0; merge <= 1; ++merge) {
+      tsClientMerge = merge;
+      createTable(update);
+      ASSERT_EQ(insertRows(conn, boundRows, batches), TSDB_CODE_SUCCESS);
+
+      std::vector<SRow> expected = {
+          {1626006833000, update ? 1 : 0, update ? "second" : "first"},
+          {1626006833001, 10, "a"},
+          {1626006833002, update ? 21 : 20, update ? "bb" : "b"},
+          {1626006833003, 30, ""},
+      };
+
+      std::vector<SRow> rows = queryRows(conn);
+      ASSERT_EQ(rows.size(), expected.size()) << "update:" << update << " clientMerge:" << (int)merge;
+      for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(rows[i].ts, expected[i].ts);
+        EXPECT_EQ(rows[i].c1, expected[i].c1) << "update:" << update << " clientMerge:" << (int)merge;
+        EXPECT_EQ(rows[i].c2, expected[i].c2) << "update:" << update << " clientMerge:" << (int)merge;
+      }
+    }
+  }
+
+  TAOS*  conn = NULL;
+  int8_t clientMerge = 0;
+};
+
+}  // namespace
+
+TEST_F(StmtColumnarTest, dup_rows_discard_update) {
+  roundTrip(0, {6});
+}
+
+TEST_F(StmtColumnarTest, dup_rows_update) {
+  roundTrip(1, {6});
+}
+
+// the duplicated timestamps are bound in different batches of the same execution
+TEST_F(StmtColumnarTest, dup_rows_across_batches) {
+  roundTrip(0, {2, 1, 3});
+  roundTrip(1, {2, 1, 3});
+}
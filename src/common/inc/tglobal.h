@@ -50,6 +50,7 @@ extern int32_t  tsSyncCheckInterval;
 extern int      tsRpcTimer;
 extern int      tsRpcMaxTime;
 extern int      tsRpcForceTcp;  // all commands go to tcp protocol if this is enabled
+extern int8_t   tsRpcReusePort;
 extern int32_t  tsMaxConnections;
 extern int32_t  tsMaxShellConns;
 extern int32_t  tsShellActivityTimer;
@@ -64,6 +65,9 @@ extern char     tsCharset[];  // default encode string
 extern int8_t   tsEnableCoreFile;
 extern int32_t  tsCompressMsgSize;
 extern int32_t  tsCompressColData;
+extern int8_t   tsRpcCompressCodec;
+extern int32_t  tsRpcLz4Acceleration;
+extern int32_t  tsRpcZstdLevel;
 extern int32_t  tsMaxNumOfDistinctResults;
 extern char     tsTempDir[];
 extern int32_t  tsShortcutFlag;
@@ -73,6 +77,9 @@ extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB fo
 extern int64_t
     tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node during query processing
 extern int32_t tsRetrieveBlockingModel;  // retrieve threads will be blocked
+extern int32_t tsQueryScanThreads;       // threads scanning file sets of one aggregate query
+extern int32_t tsQueryTimeSlice;         // time slice of a query execution before it yields
+extern int32_t tsQueryPrefetchBlocks;    // result blocks of a query computed ahead of the retrieve msg
 
 extern int8_t tsKeepOriginalColumnName;
 
@@ -88,6 +95,8 @@ extern int32_t tsMaxStreamComputDelay;
 extern int32_t tsFirstLaunchDelay;
 extern int32_t tsRetryStreamCompDelay;
 extern float   tsStreamComputDelayRatio;  // the delayed computing ration of the whole time window
+extern int32_t tsStreamIncremental;
+extern int32_t tsStreamLateWindow;
 extern int32_t tsProjectExecInterval;
 extern int64_t tsMaxRetentWindow;
 
@@ -117,6 +126,13 @@ extern int8_t  tsCacheLastRow;
 extern bool    tsdbForceKeepFile;
 extern bool    tsdbForceCompactFile;
 extern int32_t tsdbWalFlushSize;
+extern int32_t tsdbMemSkipListMode;
+extern int32_t tsdbBlockCacheSize;
+extern int32_t tsdbReadAheadBlocks;
+extern int32_t tsdbTagIndex;
+extern int32_t tsWalBufferSize;
+extern int32_t tsWalPreallocSize;
+extern int8_t  tsColumnarSubmit;
 
 // balance
 extern int8_t  tsEnableBalance;
@@ -55,6 +55,7 @@ int32_t  tsSyncCheckInterval = 1500;
 int32_t tsRpcTimer = 300;
 int32_t tsRpcMaxTime = 600;  // seconds;
 int32_t tsRpcForceTcp = 0;   // disable this, means query, show command use udp protocol as default
+int8_t  tsRpcReusePort = 0;  // each TCP server thread accepts connections by its own listening socket of SO_REUSEPORT
 int32_t tsMaxShellConns = 50000;
 int32_t tsMaxConnections = 5000;
 int32_t tsShellActivityTimer = 3;  // second
@@ -86,6 +87,16 @@ int32_t tsCompressMsgSize = 512 * 1024;
  */
 int32_t tsCompressColData = -1;
 
+/*
+ * codec to compress the rpc message whose payload size is greater than the tsCompressMsgSize, 1: lz4, 2: zstd. zstd is
+ * only built in with TD_TSZ, otherwise 2 is rejected and reset to lz4 when the config is loaded.
+ * The response is compressed by it only if the peer can decompress it, otherwise lz4 is used, and so is the request.
+ * tsRpcLz4Acceleration and tsRpcZstdLevel tune each codec, since lz4 is still used for the requests and old peers.
+ */
+int8_t  tsRpcCompressCodec = 1;
+int32_t tsRpcLz4Acceleration = 1;
+int32_t tsRpcZstdLevel = 3;
+
 // client
 int32_t tsMaxSQLStringLen = TSDB_MAX_ALLOWED_SQL_LEN;
 int32_t tsMaxWildCardsLen = TSDB_PATTERN_STRING_DEFAULT_LEN;
@@ -118,6 +129,13 @@ int32_t tsRetryStreamCompDelay = 30 * 60 * 1000;
 // The delayed computing ration. 10% of the whole computing time window by default.
 float tsStreamComputDelayRatio = 0.1f;
 
+// fold only the rows of newly closed panes into the time windows of a sliding stream, instead of re-running the windows.
+// Off by default, it changes when the existing streams emit their windows
+int32_t tsStreamIncremental = 0;
+
+// 0 ms, the range of closed panes queried again by an incremental stream to pick up late data
+int32_t tsStreamLateWindow = 0;
+
 int32_t tsProjectExecInterval = 10000;   // every 10sec, the projection will be executed once
 int64_t tsMaxRetentWindow = 24 * 3600L;  // maximum time window tolerance
 
@@ -131,6 +149,15 @@ int64_t tsQueryBufferSizeBytes = -1;
 // in retrieve blocking model, the retrieve threads will wait for the completion of the query processing.
 int32_t tsRetrieveBlockingModel = 0;
 
+// number of threads scanning the file sets of one aggregate query in parallel, 1 disables the parallel scan
+int32_t tsQueryScanThreads = 1;
+
+// time slice in milliseconds of a query execution, the aggregate query yields after it and is queued again, 0 disables
+int32_t tsQueryTimeSlice = 100;
+
+// number of result blocks computed ahead of the retrieve msg of a query, 0 disables the prefetch
+int32_t tsQueryPrefetchBlocks = 2;
+
 // last_row(*), first(*), last_row(ts, col1, col2) query, the result fields will be the original column name
 int8_t tsKeepOriginalColumnName = 0;
 
@@ -162,6 +189,13 @@ int32_t tsTsdbMetaCompactRatio = TSDB_META_COMPACT_RATIO;
 bool    tsdbForceKeepFile = false;
 bool    tsdbForceCompactFile = false;                    // compact TSDB fileset forcibly
 int32_t tsdbWalFlushSize = TSDB_DEFAULT_WAL_FLUSH_SIZE;  // MB
+int32_t tsdbMemSkipListMode = 0;                         // 0: no lock, 1: lock free, 2: rwlock
+int32_t tsdbBlockCacheSize = 0;                          // MB, per vnode, 0: disabled
+int32_t tsdbReadAheadBlocks = 0;                         // blocks read ahead by each query, 0 to disable
+int32_t tsdbTagIndex = 0;                                // index all tags of super tables, 0 for the first tag only
+int32_t tsWalBufferSize = 0;                             // KB, group commit buffer of each vnode wal, 0 to disable
+int32_t tsWalPreallocSize = 0;                           // MB, size vnode wal files are preallocated to, 0 to disable
+int8_t  tsColumnarSubmit = 1;                            // accept the columnar submit blocks of stmt, 0 before downgrade
 
 // balance
 int8_t  tsEnableBalance = 1;
@@ -769,6 +803,16 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "rpcReusePort";
+  cfg.ptr = &tsRpcReusePort;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "statusInterval";
   cfg.ptr = &tsStatusInterval;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -849,6 +893,26 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "streamIncremental";
+  cfg.ptr = &tsStreamIncremental;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "streamLateWindow";
+  cfg.ptr = &tsStreamLateWindow;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1000000000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MS;
+  taosInitConfigOption(cfg);
+
   cfg.option = "maxVgroupsPerDb";
   cfg.ptr = &tsMaxVgroupsPerDb;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1060,6 +1124,36 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "rpcCompressCodec";
+  cfg.ptr = &tsRpcCompressCodec;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 2;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "rpcLz4Acceleration";
+  cfg.ptr = &tsRpcLz4Acceleration;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 65537;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "rpcZstdLevel";
+  cfg.ptr = &tsRpcZstdLevel;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_CLIENT | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 22;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "maxSQLLength";
   cfg.ptr = &tsMaxSQLStringLen;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1120,6 +1214,36 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "queryScanThreads";
+  cfg.ptr = &tsQueryScanThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "queryTimeSlice";
+  cfg.ptr = &tsQueryTimeSlice;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 60000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MS;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "queryPrefetchBlocks";
+  cfg.ptr = &tsQueryPrefetchBlocks;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "keepColumnName";
   cfg.ptr = &tsKeepOriginalColumnName;
   cfg.valType = TAOS_CFG_VTYPE_INT8;
@@ -1722,6 +1846,78 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_MB;
   taosInitConfigOption(cfg);
 
+  // concurrency mode of the mem table skip lists of the vnodes created afterwards, kept in the vnode cfg
+  cfg.option = "memSkipListMode";
+  cfg.ptr = &tsdbMemSkipListMode;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 2;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // memory of each vnode to cache decompressed data file blocks for queries, 0 to disable the cache
+  cfg.option = "blockCacheSize";
+  cfg.ptr = &tsdbBlockCacheSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "readAheadBlocks";
+  cfg.ptr = &tsdbReadAheadBlocks;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 64;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "tagIndex";
+  cfg.ptr = &tsdbTagIndex;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "walBufferSize";
+  cfg.ptr = &tsWalBufferSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_KB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "walPreallocSize";
+  cfg.ptr = &tsWalPreallocSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1024;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "columnarSubmit";
+  cfg.ptr = &tsColumnarSubmit;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   // shortcut flag to facilitate debugging
   cfg.option = "shortcutFlag";
   cfg.ptr = &tsShortcutFlag;
@@ -1854,6 +2050,13 @@ int32_t taosCheckGlobalCfg() {
     tsMaxTablePerVnode = tsMinTablePerVnode;
   }
 
+#ifndef TD_TSZ
+  if (tsRpcCompressCodec == 2) {
+    uError("rpcCompressCodec(2) needs zstd, which is not built in without TD_TSZ, reset to lz4(1)");
+    tsRpcCompressCodec = 1;
+  }
+#endif
+
   // todo refactor
   tsVersion = 0;
   for (int ver = 0, i = 0; i < TSDB_VERSION_LEN; ++i) {
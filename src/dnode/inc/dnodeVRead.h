@@ -25,8 +25,10 @@ int32_t dnodeInitVRead();
 void    dnodeCleanupVRead();
 void    dnodeDispatchToVReadQueue(SRpcMsg *pMsg);
 void *  dnodeAllocVQueryQueue(void *pVnode);
+void *  dnodeAllocVBatchQueue(void *pVnode);
 void *  dnodeAllocVFetchQueue(void *pVnode);
 void    dnodeFreeVQueryQueue(void *pQqueue);
+void    dnodeFreeVBatchQueue(void *pBqueue);
 void    dnodeFreeVFetchQueue(void *pFqueue);
 
 #ifdef __cplusplus
@@ -168,6 +168,7 @@ int32_t dnodeInitSystem() {
   taosIgnSIGPIPE();
   taosBlockSIGPIPE();
   taosResolveCRC();
+  taosResolveDecompress();
   taosInitGlobalCfg();
   taosReadGlobalLogCfg();
   dnodeInitTmr();
@@ -23,6 +23,7 @@ static void *dnodeProcessReadQueue(void *pWorker);
 
 // module global variable
 static SWorkerPool tsVQueryWP;
+static SWorkerPool tsVBatchWP;
 static SWorkerPool tsVFetchWP;
 
 int32_t dnodeInitVRead() {
@@ -37,6 +38,13 @@ int32_t dnodeInitVRead() {
   tsVQueryWP.max = tsVQueryWP.min;
   if (tWorkerInit(&tsVQueryWP) != 0) return -1;
 
+  // the queries yielded by the time slice are executed by fewer threads, so they never occupy all the query threads
+  tsVBatchWP.name = "vbatch";
+  tsVBatchWP.workerFp = dnodeProcessReadQueue;
+  tsVBatchWP.min = MAX(tsVQueryWP.min / 2, 1);
+  tsVBatchWP.max = tsVBatchWP.min;
+  if (tWorkerInit(&tsVBatchWP) != 0) return -1;
+
   tsVFetchWP.name = "vfetch";
   tsVFetchWP.workerFp = dnodeProcessReadQueue;
   tsVFetchWP.min = MIN(maxFetchThreads, tsNumOfCores);
@@ -48,6 +56,7 @@ int32_t dnodeInitVRead() {
 
 void dnodeCleanupVRead() {
   tWorkerCleanup(&tsVFetchWP);
+  tWorkerCleanup(&tsVBatchWP);
   tWorkerCleanup(&tsVQueryWP);
 }
 
@@ -86,6 +95,10 @@ void *dnodeAllocVQueryQueue(void *pVnode) {
   return tWorkerAllocQueue(&tsVQueryWP, pVnode);
 }
 
+void *dnodeAllocVBatchQueue(void *pVnode) {
+  return tWorkerAllocQueue(&tsVBatchWP, pVnode);
+}
+
 void *dnodeAllocVFetchQueue(void *pVnode) {
   return tWorkerAllocQueue(&tsVFetchWP, pVnode);
 }
@@ -94,6 +107,10 @@ void dnodeFreeVQueryQueue(void *pQqueue) {
   tWorkerFreeQueue(&tsVQueryWP, pQqueue);
 }
 
+void dnodeFreeVBatchQueue(void *pBqueue) {
+  tWorkerFreeQueue(&tsVBatchWP, pBqueue);
+}
+
 void dnodeFreeVFetchQueue(void *pFqueue) {
   tWorkerFreeQueue(&tsVFetchWP, pFqueue);
 }
@@ -106,7 +123,14 @@ void dnodeSendRpcVReadRsp(void *pVnode, SVReadMsg *pRead, int32_t code) {
     .code    = code,
   };
 
-  rpcSendResponse(&rpcRsp);
+  if (pRead->rspRet.numOfIov > 0) {
+    rpcSendResponseV(&rpcRsp, pRead->rspRet.pIov, pRead->rspRet.numOfIov, free);
+  } else {
+    rpcSendResponse(&rpcRsp);
+  }
+
+  tfree(pRead->rspRet.pIov);
+  pRead->rspRet.numOfIov = 0;
 }
 
 void dnodeDispatchNonRspMsg(void *pVnode, SVReadMsg *pRead, int32_t code) {
@@ -119,7 +143,12 @@ static void *dnodeProcessReadQueue(void *wparam) {
   int32_t      qtype;
   void *       pVnode;
 
-  char* threadname  = strcmp(pPool->name, "vquery") == 0? "dnodeQueryQ":"dnodeFetchQ";
+  char* threadname = "dnodeFetchQ";
+  if (strcmp(pPool->name, "vquery") == 0) {
+    threadname = "dnodeQueryQ";
+  } else if (strcmp(pPool->name, "vbatch") == 0) {
+    threadname = "dnodeBatchQ";
+  }
 
   char name[16] = {0};
   snprintf(name, tListLen(name), "%s", threadname);
@@ -255,6 +255,7 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
     }
 
     bool forceFsync = false;
+    vnodeBeginForwards(pVnode);
     for (int32_t i = 0; i < numOfMsgs; ++i) {
       taosGetQitem(pWorker->qall, &qtype, (void **)&pWrite);
       dTrace("msg:%p, app:%p type:%s will be processed in vwrite queue, qtype:%s hver:%" PRIu64, pWrite,
@@ -268,17 +269,31 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
       dTrace("msg:%p is processed in vwrite queue, code:0x%x", pWrite, pWrite->code);
     }
 
-    walFsync(vnodeGetWal(pVnode), forceFsync);
+    // the forwards of the batch travel to the slaves in one frame while the wal is synced
+    vnodeFlushForwards(pVnode);
+
+    // with a wal buffer, the whole batch is written and synced here and all of its writers are acked together
+    int32_t walCode = walFsync(vnodeGetWal(pVnode), forceFsync);
 
     // browse all items, and process them one by one
+    uint64_t fwdVersion = 0;
+    bool     fwdForce = false;
+    bool     cumulative = vnodeCumulativeAcks(pVnode);
     taosResetQitems(pWorker->qall);
     for (int32_t i = 0; i < numOfMsgs; ++i) {
       taosGetQitem(pWorker->qall, &qtype, (void **)&pWrite);
+      if (walCode != 0 && pWrite->code == 0) pWrite->code = walCode;
       if (qtype == TAOS_QTYPE_RPC) {
         dnodeSendRpcVWriteRsp(pVnode, pWrite, pWrite->code);
       } else {
         if (qtype == TAOS_QTYPE_FWD) {
-          vnodeConfirmForward(pVnode, pWrite->walHead.version, pWrite->code, pWrite->walHead.msgType != TSDB_MSG_TYPE_SUBMIT);
+          bool force = pWrite->walHead.msgType != TSDB_MSG_TYPE_SUBMIT;
+          if (pWrite->code == 0 && cumulative) {
+            fwdVersion = pWrite->walHead.version;
+            fwdForce = fwdForce || force;
+          } else {
+            vnodeConfirmForward(pVnode, pWrite->walHead.version, pWrite->code, force);
+          }
         }
         if (pWrite->rspRet.rsp) {
           rpcFreeCont(pWrite->rspRet.rsp);
@@ -286,6 +301,9 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
         vnodeFreeFromWQueue(pVnode, pWrite);
       }
     }
+
+    // the forwards processed successfully are acked in one response, if the master supports it
+    if (fwdVersion > 0) vnodeConfirmForward(pVnode, fwdVersion, 0, fwdForce);
   }
 
   return NULL;
@@ -277,7 +277,7 @@ static void dnodeSendStatusMsg(void *handle, void *tmrId) {
     return;
   }
 
-  int32_t contLen = sizeof(SStatusMsg) + TSDB_MAX_VNODES * sizeof(SVnodeLoad);
+  int32_t contLen = sizeof(SStatusMsg) + TSDB_MAX_VNODES * (sizeof(SVnodeLoad) + sizeof(SVnodeLoadExt));
   SStatusMsg *pStatus = rpcMallocCont(contLen);
   if (pStatus == NULL) {
     taosTmrReset(dnodeSendStatusMsg, tsStatusInterval * 1000, NULL, tsDnodeTmr, &tsStatusTimer);
@@ -292,6 +292,8 @@ static void dnodeSendStatusMsg(void *handle, void *tmrId) {
   pStatus->numOfCores       = htons((uint16_t) tsNumOfCores);
   pStatus->diskAvailable    = tsAvailDataDirGB;
   pStatus->alternativeRole  = tsAlternativeRole;
+  pStatus->loadVersion      = TSDB_VNODE_LOAD_EXT_VER;
+  pStatus->features         = tsColumnarSubmit ? TSDB_CONN_FEATURE_COLUMNAR_SUBMIT : 0;
   tstrncpy(pStatus->dnodeEp, tsLocalEp, TSDB_EP_LEN);
 
   // fill cluster cfg parameters
@@ -315,7 +317,9 @@ static void dnodeSendStatusMsg(void *handle, void *tmrId) {
   pStatus->clusterCfg.adjustMaster = tsEnableAdjustMaster;
 
   vnodeBuildStatusMsg(pStatus);
-  contLen = sizeof(SStatusMsg) + pStatus->openVnodes * sizeof(SVnodeLoad);
+  memmove(pStatus->load + pStatus->openVnodes, pStatus->load + TSDB_MAX_VNODES,
+          pStatus->openVnodes * sizeof(SVnodeLoadExt));
+  contLen = sizeof(SStatusMsg) + pStatus->openVnodes * (sizeof(SVnodeLoad) + sizeof(SVnodeLoadExt));
   pStatus->openVnodes = htons(pStatus->openVnodes);
 
   SRpcMsg rpcMsg = {
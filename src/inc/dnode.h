@@ -57,8 +57,10 @@ void *dnodeAllocVWriteQueue(void *pVnode);
 void  dnodeFreeVWriteQueue(void *pWqueue);
 void  dnodeSendRpcVWriteRsp(void *pVnode, void *pWrite, int32_t code);
 void *dnodeAllocVQueryQueue(void *pVnode);
+void *dnodeAllocVBatchQueue(void *pVnode);
 void *dnodeAllocVFetchQueue(void *pVnode);
 void  dnodeFreeVQueryQueue(void *pQqueue);
+void  dnodeFreeVBatchQueue(void *pBqueue);
 void  dnodeFreeVFetchQueue(void *pFqueue);
 
 int32_t dnodeAllocateMPeerQueue();
@@ -36,9 +36,11 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryTableMs
  * which are decided according to the tag or table name query conditions
  *
  * @param qinfo
+ * @param continueExec the query needs to be executed again, since its time slice is used up or its result is
+ *                     prefetched before the retrieve msg arrives
  * @return
  */
-bool qTableQuery(qinfo_t qinfo, uint64_t *qId);
+bool qTableQuery(qinfo_t qinfo, uint64_t *qId, bool *continueExec);
 
 /**
  * Retrieve the produced results information, if current query is not paused or completed,
@@ -58,9 +60,13 @@ int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContex
  * @param qinfo  qinfo object
  * @param pRsp    response message
  * @param contLen payload length
+ * @param pIov    the result columns following the response message, which are not copied into it. They are only
+ *                set for the last result of the query, and are released by free.
+ * @param numOfIov number of pIov
  * @return
  */
-int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp** pRsp, int32_t* contLen, bool* continueExec);
+int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp** pRsp, int32_t* contLen, struct SRpcIov** pIov,
+                            int32_t* numOfIov, bool* continueExec);
 
 /**
  *
@@ -83,6 +89,13 @@ bool qSolveCommitNoBlock(void* pRepo, void* pMgmt);
 
 int32_t qQueryCompleted(qinfo_t qinfo);
 
+/**
+ * the query has yielded at least once, and is executed in the batch class afterwards
+ * @param qinfo
+ * @return
+ */
+bool qIsBatchQuery(qinfo_t qinfo);
+
 /**
  * destroy query info structure
  * @param qHandle
@@ -99,6 +112,9 @@ void** qReleaseQInfo(void* pMgmt, void* pQInfo, bool freeHandle);
 bool checkQIdEqual(void *qHandle, uint64_t qId);
 int64_t genQueryId(void);
 
+int32_t qInitQueryScanPool();
+void    qCleanupQueryScanPool();
+
 #ifdef __cplusplus
 }
 #endif
@@ -202,6 +202,23 @@ enum _mgmt_table {
 // SSubmitBlk->flag define
 #define FLAG_BLK_CONTROL            0x00000001 // SSubmitBlk is a control block to submit
 #define IS_CONTROL_BLOCK(x)         (x->flag & FLAG_BLK_CONTROL)
+#define FLAG_BLK_COLUMNAR           0x00000002 // SSubmitBlk keeps the rows by columns
+#define IS_COLUMNAR_BLOCK(x)        (x->flag & FLAG_BLK_COLUMNAR)
+
+/*
+ * The data of the columnar SSubmitBlk are the columns of the schema in order, each of numOfRows values in the byte
+ * order of the host, NULL is the NULL value of the type:
+ *   fixed length type: numOfRows values of TYPE_BYTES[type] bytes
+ *   binary and nchar : numOfRows + 1 offsets of int32_t, then the VarDataT values, the value of row i begins at
+ *                      offsets[i] of the values, and offsets[numOfRows] is the length of the values
+ * The rows must be ascending by the timestamp of the first column.
+ */
+
+// SConnectRsp->features and SStatusMsg->features define
+#define TSDB_CONN_FEATURE_COLUMNAR_SUBMIT 0x01  // columnar SSubmitBlk is accepted
+
+// SRetrieveTableRsp->extend and SHeartBeatMsg->extend define, old peers ignore the trailing parts
+#define TSDB_MSG_EXT_CPU_TIME 0x01  // int64_t cpu time in microseconds is appended, one for each query
 
 extern char *taosMsg[];
 
@@ -361,7 +378,7 @@ typedef struct {
   char      clusterId[TSDB_CLUSTER_ID_LEN];
   int8_t    writeAuth;
   int8_t    superAuth;
-  int8_t    reserved1;
+  int8_t    features;
   int8_t    reserved2;
   int32_t   connId;
   SRpcEpSet epSet;
@@ -591,6 +608,15 @@ typedef struct {
   uint8_t  truncate;
 } SVnodeLoad;
 
+// appended to the status msg after the SVnodeLoad array, if the loadVersion of the msg is not less than
+// TSDB_VNODE_LOAD_EXT_VER, so that the layout of SVnodeLoad is kept for the dnodes of old versions
+#define TSDB_VNODE_LOAD_EXT_VER 1
+
+typedef struct {
+  int64_t  blockCacheHits;
+  int64_t  blockCacheMisses;
+} SVnodeLoadExt;
+
 typedef struct {
   int8_t   extend;
   char     db[TSDB_ACCT_ID_LEN + TSDB_DB_NAME_LEN];
@@ -741,7 +767,9 @@ typedef struct {
   float       diskAvailable;  // GB
   char        clusterId[TSDB_CLUSTER_ID_LEN];
   uint8_t     alternativeRole;
-  uint8_t     reserve2[15];
+  uint8_t     loadVersion;       // 0: only SVnodeLoad, TSDB_VNODE_LOAD_EXT_VER: followed by SVnodeLoadExt
+  uint8_t     features;          // TSDB_CONN_FEATURE_* the dnode accepts, 0 from old versions
+  uint8_t     reserve2[13];
   SClusterCfg clusterCfg;
   SVnodeLoad  load[];
 } SStatusMsg;
@@ -56,6 +56,24 @@ typedef struct SRpcMsg {
   void   *ahandle;  // app handle set by client
 } SRpcMsg;
 
+// a segment of the message content, sent without being copied into the message
+typedef struct SRpcIov {
+  void   *pCont;
+  int     contLen;
+} SRpcIov;
+
+// counters of the compressed messages, the time is in microseconds
+typedef struct SRpcCompStat {
+  int64_t compMsgs;        // messages tried to be compressed
+  int64_t compRawBytes;    // content bytes before compression
+  int64_t compBytes;       // content bytes sent
+  int64_t compUs;
+  int64_t decompMsgs;
+  int64_t decompBytes;     // compressed content bytes received
+  int64_t decompRawBytes;  // content bytes after decompression
+  int64_t decompUs;
+} SRpcCompStat;
+
 typedef struct SRpcInit {
   uint16_t localPort; // local port
   char  *label;        // for debug purpose
@@ -87,12 +105,14 @@ void  rpcFreeCont(void *pCont);
 void *rpcReallocCont(void *ptr, int contLen);
 void  rpcSendRequest(void *thandle, const SRpcEpSet *pEpSet, SRpcMsg *pMsg, int64_t *rid);
 void  rpcSendResponse(const SRpcMsg *pMsg);
+void  rpcSendResponseV(const SRpcMsg *pMsg, const SRpcIov *pIov, int numOfIov, void (*freeFp)(void *));
 void  rpcSendRedirectRsp(void *pConn, const SRpcEpSet *pEpSet); 
 int   rpcGetConnInfo(void *thandle, SRpcConnInfo *pInfo);
 void  rpcSendRecv(void *shandle, SRpcEpSet *pEpSet, SRpcMsg *pReq, SRpcMsg *pRsp);
 int   rpcReportProgress(void *pConn, char *pCont, int contLen);
 void  rpcCancelRequest(int64_t rid);
 int32_t rpcUnusedSession(void * rpcInfo, bool bLock);
+void  rpcGetCompStat(void *shandle, SRpcCompStat *pStat);
 
 #ifdef __cplusplus
 }
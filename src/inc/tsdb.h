@@ -71,12 +71,18 @@ typedef struct {
   int8_t  compression;
   int8_t  update;
   int8_t  cacheLastRow;    // 0:no cache, 1: cache last row, 2: cache last NULL column 3: 1&2
+  int8_t  memSkipListMode; // 0: no lock, 1: lock free, 2: rwlock, see TSDB_MEM_SKIPLIST_XXX
 } STsdbCfg;
 
 #define CACHE_NO_LAST(c)          ((c)->cacheLastRow == 0)
 #define CACHE_LAST_ROW(c)         (((c)->cacheLastRow & 1) > 0)
 #define CACHE_LAST_NULL_COLUMN(c) (((c)->cacheLastRow & 2) > 0)
 
+// concurrency mode of the mem table skip lists
+#define TSDB_MEM_SKIPLIST_NO_LOCK   0
+#define TSDB_MEM_SKIPLIST_LOCK_FREE 1
+#define TSDB_MEM_SKIPLIST_RWLOCK    2
+
 // --------- TSDB REPOSITORY USAGE STATISTICS
 typedef struct {
   int64_t totalStorage;  // total bytes occupie
@@ -395,6 +401,16 @@ void tsdbResetQueryHandleForNewTable(TsdbQueryHandleT queryHandle, STsdbQueryCon
 
 int32_t tsdbGetFileBlocksDistInfo(TsdbQueryHandleT* queryHandle, STableBlockDist* pTableBlockInfo);
 
+/**
+ * split the ascending query time window at the boundaries of the data file sets, so that each sub window can be
+ * scanned by an independent query handle. The sub windows are contiguous and cover the whole query time window.
+ *
+ * @param tsdb      tsdbHandle
+ * @param pWindow   the query time window, skey <= ekey
+ * @return          SArray<STimeWindow>, or NULL if out of memory
+ */
+SArray *tsdbGetFileSetWindows(STsdbRepo *tsdb, STimeWindow *pWindow);
+
 // obtain queryHandle attribute
 int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle);
 
@@ -407,6 +423,14 @@ int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle);
  */
 void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int64_t *compStorage);
 
+/**
+ * get the hit and miss counters of the block cache, both are 0 if the cache is disabled
+ * @param repo. point to the tsdbrepo
+ * @param hits. column chunks served from the cache
+ * @param misses. column chunks read and decompressed from data files
+ */
+void tsdbReportBlockCacheStat(void *repo, int64_t *hits, int64_t *misses);
+
 int  tsdbInitCommitQueue();
 void tsdbDestroyCommitQueue();
 int  tsdbSyncCommit(STsdbRepo *repo);
@@ -109,6 +109,9 @@ int64_t syncStart(const SSyncInfo *);
 void    syncStop(int64_t rid);
 int32_t syncReconfig(int64_t rid, const SSyncCfg *);
 int32_t syncForwardToPeer(int64_t rid, void *pHead, void *mhandle, int32_t qtype, bool force);
+void    syncBeginForwards(int64_t rid);  // forwards are kept until flushed, then sent to each peer in one frame
+void    syncFlushForwards(int64_t rid);
+bool    syncCumulativeAcks(int64_t rid);  // the master counts one forward response for all versions up to it
 void    syncConfirmForward(int64_t rid, uint64_t version, int32_t code, bool force);
 void    syncRecover(int64_t rid);  // recover from other nodes:
 int32_t syncGetNodesRole(int64_t rid, SNodesRole *);
@@ -46,6 +46,8 @@ typedef struct {
   int32_t  fsyncPeriod;  // millisecond
   EWalType walLevel;     // wal level
   EWalKeep keep;         // keep the wal file when closed
+  int32_t  bufSize;      // bytes of records batched into one write by walFsync, 0 to write each record directly
+  int32_t  preallocSize; // bytes each wal file is preallocated and recycled with, 0 to grow files by appending
 } SWalCfg;
 
 typedef void *  twalh;  // WAL HANDLE
@@ -61,13 +63,16 @@ int32_t  walRenew(twalh);
 void     walRemoveOneOldFile(twalh);
 void     walRemoveAllOldFiles(twalh);
 int32_t  walWrite(twalh, SWalHead *);
-void     walFsync(twalh, bool forceFsync);
+int32_t  walFsync(twalh, bool forceFsync);
 int32_t  walRestore(twalh, void *pVnode, FWalWrite writeFp);
 int32_t  walGetWalFile(twalh, char *fileName, int64_t *fileId);
 uint64_t walGetVersion(twalh);
 void     walResetVersion(twalh, uint64_t newVer);
 int64_t  walGetFSize(twalh);
 
+// false for the zeros after the last record of a preallocated file, or a record read before it is completely written
+bool     walIsValidRecord(SWalHead *pHead);
+
 #ifdef __cplusplus
 }
 #endif
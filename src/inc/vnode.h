@@ -29,9 +29,11 @@ typedef struct {
 } SVnodeStatisInfo;
 
 typedef struct {
-  int32_t len;
-  void *  rsp;
-  void *  qhandle;  // used by query and retrieve msg
+  int32_t  len;
+  void *   rsp;
+  SRpcIov *pIov;      // segments sent after rsp without copy, released by free
+  int32_t  numOfIov;
+  void *   qhandle;  // used by query and retrieve msg
   tsem_t* psem;  // if it is not zero, need wait result with async 
 } SRspRet;
 
@@ -98,6 +100,9 @@ SVnodeStatisInfo vnodeGetStatisInfo();
 
 // vnodeSync
 void    vnodeConfirmForward(void *pVnode, uint64_t version, int32_t code, bool force);
+void    vnodeBeginForwards(void *pVnode);
+void    vnodeFlushForwards(void *pVnode);
+bool    vnodeCumulativeAcks(void *pVnode);
 
 // vnodeRead
 int32_t vnodeWriteToRQueue(void *pVnode, void *pCont, int32_t contLen, int8_t qtype, void *rparam);
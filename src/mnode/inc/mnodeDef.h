@@ -69,7 +69,7 @@ typedef struct SDnodeObj {
   int16_t    memoryAvgUsage;   // calc from sys.mem
   int16_t    bandwidthUsage;   // calc from sys.band
   int8_t     offlineReason;
-  int8_t     reserved2[1];
+  uint8_t    features;         // from dnode status msg
 } SDnodeObj;
 
 typedef struct SMnodeObj {
@@ -153,6 +153,8 @@ typedef struct SVgObj {
   int64_t        totalStorage;
   int64_t        compStorage;
   int64_t        pointsWritten;
+  int64_t        blockCacheHits[TSDB_MAX_REPLICA];    // reported by each vnode, not persisted
+  int64_t        blockCacheMisses[TSDB_MAX_REPLICA];
   struct SDbObj *pDb;
   void *         idPool;
 } SVgObj;
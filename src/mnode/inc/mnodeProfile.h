@@ -37,6 +37,7 @@ typedef struct {
   int32_t  numOfStreams;
   SStreamDesc *pStreams;
   SQueryDesc * pQueries;
+  int64_t *    pCpuTimes;  // cpu time of the queries, 0 if not sent by the client
 } SConnObj;
 
 int32_t mnodeInitProfile();
@@ -45,7 +46,7 @@ void    mnodeCleanupProfile();
 SConnObj *mnodeCreateConn(char *user, uint32_t ip, uint16_t port, int32_t pid, const char* app);
 SConnObj *mnodeAccquireConn(int32_t connId, char *user, uint32_t ip, uint16_t port);
 void      mnodeReleaseConn(SConnObj *pConn);
-int32_t   mnodeSaveQueryStreamList(SConnObj *pConn, SHeartBeatMsg *pHBMsg);
+int32_t   mnodeSaveQueryStreamList(SConnObj *pConn, SHeartBeatMsg *pHBMsg, int32_t contLen);
 
 #ifdef __cplusplus
 }
@@ -274,6 +274,24 @@ int32_t mnodeGetOnlineDnodesNum() {
   return onlineDnodes;
 }
 
+// the features all dnodes accept, offline dnodes count as they may come back by an older version
+uint8_t mnodeGetDnodeFeatures() {
+  SDnodeObj *pDnode = NULL;
+  void *     pIter = NULL;
+  int32_t    numOfDnodes = 0;
+  uint8_t    features = 0xFF;
+
+  while (1) {
+    pIter = mnodeGetNextDnode(pIter, &pDnode);
+    if (pDnode == NULL) break;
+    features &= pDnode->features;
+    numOfDnodes++;
+    mnodeDecDnodeRef(pDnode);
+  }
+
+  return numOfDnodes > 0 ? features : 0;
+}
+
 int32_t mnodeGetVnodeDnodesNum() {
   SDnodeObj *pDnode = NULL;
   void *     pIter = NULL;
@@ -580,6 +598,7 @@ static int32_t mnodeProcessDnodeStatusMsg(SMnodeMsg *pMsg) {
   pDnode->diskAvailable    = pStatus->diskAvailable;
   pDnode->alternativeRole  = pStatus->alternativeRole;
   pDnode->moduleStatus     = pStatus->moduleStatus;
+  pDnode->features         = pStatus->features;
 
   if (pStatus->dnodeId == 0) {
     mDebug("dnode:%d %s, first access, set clusterId %s", pDnode->dnodeId, pDnode->dnodeEp, mnodeGetClusterId());
@@ -613,7 +632,14 @@ static int32_t mnodeProcessDnodeStatusMsg(SMnodeMsg *pMsg) {
   pRsp->dnodeCfg.numOfVnodes = htonl(openVnodes);
   tstrncpy(pRsp->dnodeCfg.clusterId, mnodeGetClusterId(), TSDB_CLUSTER_ID_LEN);
   SVgroupAccess *pAccess = (SVgroupAccess *)((char *)pRsp + sizeof(SStatusRsp));
-  
+
+  // the dnodes of old versions do not report the extended vnode load
+  SVnodeLoadExt *pLoadExt = NULL;
+  if (pStatus->loadVersion >= TSDB_VNODE_LOAD_EXT_VER &&
+      pMsg->rpcMsg.contLen >= sizeof(SStatusMsg) + openVnodes * (sizeof(SVnodeLoad) + sizeof(SVnodeLoadExt))) {
+    pLoadExt = (SVnodeLoadExt *)(pStatus->load + openVnodes);
+  }
+
   for (int32_t j = 0; j < openVnodes; ++j) {
     SVnodeLoad *pVload = &pStatus->load[j];
     pVload->vgId = htonl(pVload->vgId);
@@ -627,7 +653,7 @@ static int32_t mnodeProcessDnodeStatusMsg(SMnodeMsg *pMsg) {
       mInfo("dnode:%d, vgId:%d not exist in mnode, drop it", pDnode->dnodeId, pVload->vgId);
       mnodeSendDropVnodeMsg(pVload->vgId, &epSet, NULL);
     } else {
-      mnodeUpdateVgroupStatus(pVgroup, pDnode, pVload);
+      mnodeUpdateVgroupStatus(pVgroup, pDnode, pVload, pLoadExt ? &pLoadExt[j] : NULL);
       pAccess->vgId = htonl(pVload->vgId);
       pAccess->accessState = pVgroup->accessState;
       pAccess++;
@@ -1215,6 +1241,18 @@ static int32_t mnodeGetVnodeMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pC
   pSchema[cols].bytes = htons(pShow->bytes[cols]);
   cols++;
 
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "block_cache_hits");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "block_cache_misses");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
   pMeta->numOfColumns = htons(cols);
   pShow->numOfColumns = cols;
 
@@ -1276,6 +1314,14 @@ static int32_t mnodeRetrieveVnodes(SShowObj *pShow, char *data, int32_t rows, vo
           pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
           STR_TO_VARSTR(pWrite, syncRole[pVgid->role]);
           cols++;
+
+          pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+          *(int64_t *)pWrite = pVgroup->blockCacheHits[i];
+          cols++;
+
+          pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+          *(int64_t *)pWrite = pVgroup->blockCacheMisses[i];
+          cols++;
           numOfRows++;
         }
       }
@@ -139,6 +139,7 @@ static void mnodeFreeConn(void *data) {
   SConnObj *pConn = data;
   tfree(pConn->pQueries);
   tfree(pConn->pStreams);
+  tfree(pConn->pCpuTimes);
 
   mDebug("connId:%d, is destroyed", pConn->connId);
 }
@@ -284,7 +285,7 @@ static int32_t mnodeRetrieveConns(SShowObj *pShow, char *data, int32_t rows, voi
 }
 
 // not thread safe, need optimized
-int32_t mnodeSaveQueryStreamList(SConnObj *pConn, SHeartBeatMsg *pHBMsg) {
+int32_t mnodeSaveQueryStreamList(SConnObj *pConn, SHeartBeatMsg *pHBMsg, int32_t contLen) {
   pConn->numOfQueries = 0;	
   pConn->numOfStreams = 0;
   int32_t numOfQueries = htonl(pHBMsg->numOfQueries);
@@ -301,6 +302,21 @@ int32_t mnodeSaveQueryStreamList(SConnObj *pConn, SHeartBeatMsg *pHBMsg) {
     if (saveSize > 0 && pConn->pQueries != NULL) {
       memcpy(pConn->pQueries, pHBMsg->pData, saveSize);
     }
+
+    if (pConn->pCpuTimes == NULL) {
+      pConn->pCpuTimes = calloc(sizeof(int64_t), QUERY_STREAM_SAVE_SIZE);
+    }
+
+    // the cpu times follow the stream descs, they are not sent by the clients of old versions
+    int32_t cpuTimeOffset = numOfQueries * sizeof(SQueryDesc) + numOfStreams * sizeof(SStreamDesc);
+    if (pConn->pCpuTimes != NULL) {
+      if ((pHBMsg->extend & TSDB_MSG_EXT_CPU_TIME) &&
+          contLen >= sizeof(SHeartBeatMsg) + cpuTimeOffset + numOfQueries * sizeof(int64_t)) {
+        memcpy(pConn->pCpuTimes, pHBMsg->pData + cpuTimeOffset, pConn->numOfQueries * sizeof(int64_t));
+      } else {
+        memset(pConn->pCpuTimes, 0, pConn->numOfQueries * sizeof(int64_t));
+      }
+    }
   }
 
   if (numOfStreams > 0) {
@@ -405,6 +421,12 @@ static int32_t mnodeGetQueryMeta(STableMetaMsg *pMeta, SShowObj *pShow, void *pC
   pSchema[cols].bytes = htons(pShow->bytes[cols]);
   cols++;
 
+  pShow->bytes[cols] = 8;
+  pSchema[cols].type = TSDB_DATA_TYPE_BIGINT;
+  strcpy(pSchema[cols].name, "cpu_time");
+  pSchema[cols].bytes = htons(pShow->bytes[cols]);
+  cols++;
+
   pMeta->numOfColumns = htons(cols);
   pShow->numOfColumns = cols;
 
@@ -504,6 +526,10 @@ static int32_t mnodeRetrieveQueries(SShowObj *pShow, char *data, int32_t rows, v
       STR_WITH_MAXSIZE_TO_VARSTR(pWrite, pDesc->sql, pShow->bytes[cols]);
       cols++;
 
+      pWrite = data + pShow->offset[cols] * rows + pShow->bytes[cols] * numOfRows;
+      *(int64_t *)pWrite = (pConnObj->pCpuTimes != NULL) ? htobe64(pConnObj->pCpuTimes[i]) / 1000 : 0;
+      cols++;
+
       numOfRows++;
     }
   }
@@ -260,7 +260,7 @@ static int32_t mnodeProcessHeartBeatMsg(SMnodeMsg *pMsg) {
     // pRsp->killConnection = 1;    
   } else {
     pRsp->connId = htonl(pConn->connId);
-    mnodeSaveQueryStreamList(pConn, pHBMsg);
+    mnodeSaveQueryStreamList(pConn, pHBMsg, pMsg->rpcMsg.contLen);
     
     if (pConn->killed != 0) {
       pRsp->killConnection = 1;
@@ -343,7 +343,8 @@ static int32_t mnodeProcessConnectMsg(SMnodeMsg *pMsg) {
   memcpy(pConnectRsp->serverVersion, version, TSDB_VERSION_LEN);
   pConnectRsp->writeAuth = pUser->writeAuth;
   pConnectRsp->superAuth = pUser->superAuth;
-  
+  pConnectRsp->features = mnodeGetDnodeFeatures();
+
   mnodeGetMnodeEpSetForShell(&pConnectRsp->epSet, false);
 
   dnodeGetClusterId(pConnectRsp->clusterId);
@@ -315,7 +315,7 @@ void mnodeCheckUnCreatedVgroup(SDnodeObj *pDnode, SVnodeLoad *pVloads, int32_t o
   mnodeCancelGetNextVgroup(pIter);
 }
 
-void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVload) {
+void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVload, SVnodeLoadExt *pLoadExt) {
   bool dnodeExist = false;
   for (int32_t i = 0; i < pVgroup->numOfVnodes; ++i) {
     SVnodeGid *pVgid = &pVgroup->vnodeGid[i];
@@ -324,6 +324,10 @@ void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVl
              pDnode->dnodeId, syncRole[pVload->role], syncRole[pVgid->role], pVload->vnodeVersion);
       pVgid->role = pVload->role;
       mnodeSetVgidVer(pVgid->vver, pVload->vnodeVersion);
+      if (pLoadExt != NULL) {
+        pVgroup->blockCacheHits[i] = htobe64(pLoadExt->blockCacheHits);
+        pVgroup->blockCacheMisses[i] = htobe64(pLoadExt->blockCacheMisses);
+      }
       if (pVload->role == TAOS_SYNC_ROLE_MASTER) {
         pVgroup->inUse = i;
       }
@@ -22,6 +22,7 @@ extern "C" {
 
 #include "osInc.h"
 #include "osDef.h"
+#include "osAio.h"
 #include "osAtomic.h"
 #include "osDir.h"
 #include "osFile.h"
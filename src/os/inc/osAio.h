@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_OS_AIO_H
+#define TDENGINE_OS_AIO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "osFile.h"
+
+// Asynchronous positional file reads. On Linux the reads are submitted to an io_uring, where io_uring is not
+// available (old kernels, seccomp, other platforms) each read is done with pread at submission and its result
+// is handed out by taosAioWait, so callers have one code path for both.
+typedef struct SAioCtx SAioCtx;
+
+SAioCtx *taosAioOpen(int32_t depth);
+void     taosAioClose(SAioCtx *pCtx);
+bool     taosAioIsAsync(SAioCtx *pCtx);
+int32_t  taosAioRead(SAioCtx *pCtx, FileFd fd, void *buf, int64_t count, int64_t offset, uint64_t tag);
+int32_t  taosAioWait(SAioCtx *pCtx, uint64_t *tag, int64_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
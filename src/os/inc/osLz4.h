@@ -25,21 +25,25 @@ extern "C" {
   int32_t BUILDIN_CLZ(uint32_t val);
   int32_t BUILDIN_CTZL(uint64_t val);
   int32_t BUILDIN_CTZ(uint32_t val);
+  int32_t BUILDIN_POPCOUNTL(uint64_t val);
 #elif defined (_TD_LINUX_32)
   #define BUILDIN_CLZL(val) __builtin_clzll(val)
   #define BUILDIN_CTZL(val) __builtin_ctzll(val)
   #define BUILDIN_CLZ(val) __builtin_clz(val)
   #define BUILDIN_CTZ(val) __builtin_ctz(val)
+  #define BUILDIN_POPCOUNTL(val) __builtin_popcountll(val)
 #elif defined (_TD_ARM_32)
   #define BUILDIN_CLZL(val) __builtin_clzll(val)
   #define BUILDIN_CTZL(val) __builtin_ctzll(val)
   #define BUILDIN_CLZ(val) __builtin_clz(val)
   #define BUILDIN_CTZ(val) __builtin_ctz(val)
+  #define BUILDIN_POPCOUNTL(val) __builtin_popcountll(val)
 #else
   #define BUILDIN_CLZL(val) __builtin_clzl(val)
   #define BUILDIN_CTZL(val) __builtin_ctzl(val)
   #define BUILDIN_CLZ(val) __builtin_clz(val)
   #define BUILDIN_CTZ(val) __builtin_ctz(val)
+  #define BUILDIN_POPCOUNTL(val) __builtin_popcountll(val)
 #endif
 
 #ifdef __cplusplus
@@ -62,6 +62,17 @@ static FORCE_INLINE int64_t taosGetTimestampNs() {
   return (int64_t)systemTime.tv_sec * 1000000000L + (int64_t)systemTime.tv_nsec;
 }
 
+//@return cpu time consumed by the calling thread in microsecond
+static FORCE_INLINE int64_t taosGetThreadCpuTimeUs() {
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+  return taosGetTimestampUs();
+#else
+  struct timespec cpuTime = {0};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+  return (int64_t)cpuTime.tv_sec * 1000000L + (int64_t)cpuTime.tv_nsec / 1000;
+#endif
+}
+
 /*
  * @return timestamp decided by global conf variable, tsTimePrecision
  * if precision == TSDB_TIME_PRECISION_MICRO, it returns timestamp in microsecond.
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "taoserror.h"
+#include "tulog.h"
+
+#if defined(_TD_LINUX) && defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define TD_AIO_IO_URING
+#endif
+#endif
+
+typedef struct {
+  uint64_t tag;
+  int64_t  result;
+} SAioResult;
+
+typedef struct {
+  uint64_t     tag;
+  bool         used;
+  struct iovec iov;  // shall stay valid until the read completes
+} SAioReq;
+
+#ifdef TD_AIO_IO_URING
+typedef struct {
+  int32_t              fd;
+  uint32_t *           sqTail;
+  uint32_t *           sqMask;
+  uint32_t *           sqArray;
+  uint32_t *           cqHead;
+  uint32_t *           cqTail;
+  uint32_t *           cqMask;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  void *               sqRing;
+  size_t               sqRingSize;
+  void *               cqRing;
+  size_t               cqRingSize;
+  size_t               sqesSize;
+} SAioRing;
+#endif
+
+struct SAioCtx {
+  int32_t     depth;
+  int32_t     numOfInflight;  // submitted to the ring, not reaped yet
+  int32_t     numOfDone;      // read synchronously, not handed out yet
+  int32_t     doneHead;
+  SAioResult *done;
+  SAioReq *   reqs;
+#ifdef TD_AIO_IO_URING
+  SAioRing *  ring;        // NULL if io_uring is not available
+  bool        ringFailed;  // a submission failed, reads in flight are still reaped from the ring
+#endif
+};
+
+static int64_t taosAioPRead(FileFd fd, void *buf, int64_t count, int64_t offset) {
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+  if (taosLSeek(fd, offset, SEEK_SET) < 0) return -1;
+  return taosRead(fd, buf, count);
+#else
+  int64_t nread = 0;
+  while (nread < count) {
+    ssize_t n = pread(fd, (char *)buf + nread, (size_t)(count - nread), (off_t)(offset + nread));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return -1;
+    }
+    if (n == 0) break;
+    nread += n;
+  }
+  return nread;
+#endif
+}
+
+#ifdef TD_AIO_IO_URING
+static void taosAioCloseRing(SAioRing *ring) {
+  if (ring->sqes != NULL && ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+  if (ring->cqRing != NULL && ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing) {
+    munmap(ring->cqRing, ring->cqRingSize);
+  }
+  if (ring->sqRing != NULL && ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+  close(ring->fd);
+  free(ring);
+}
+
+static SAioRing *taosAioOpenRing(uint32_t entries) {
+  struct io_uring_params p;
+  memset(&p, 0, sizeof(p));
+
+  int32_t fd = (int32_t)syscall(__NR_io_uring_setup, entries, &p);
+  if (fd < 0) {
+    uDebug("io_uring is not available since %s, read files synchronously", strerror(errno));
+    return NULL;
+  }
+
+  SAioRing *ring = calloc(1, sizeof(SAioRing));
+  if (ring == NULL) {
+    close(fd);
+    return NULL;
+  }
+
+  ring->fd = fd;
+  ring->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+  ring->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  ring->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+
+  bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single) ring->sqRingSize = ring->cqRingSize = MAX(ring->sqRingSize, ring->cqRingSize);
+
+  ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (ring->sqRing == MAP_FAILED) goto _err;
+
+  if (single) {
+    ring->cqRing = ring->sqRing;
+  } else {
+    ring->cqRing =
+        mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (ring->cqRing == MAP_FAILED) goto _err;
+  }
+
+  ring->sqes = mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED) goto _err;
+
+  ring->sqTail = (uint32_t *)((char *)ring->sqRing + p.sq_off.tail);
+  ring->sqMask = (uint32_t *)((char *)ring->sqRing + p.sq_off.ring_mask);
+  ring->sqArray = (uint32_t *)((char *)ring->sqRing + p.sq_off.array);
+  ring->cqHead = (uint32_t *)((char *)ring->cqRing + p.cq_off.head);
+  ring->cqTail = (uint32_t *)((char *)ring->cqRing + p.cq_off.tail);
+  ring->cqMask = (uint32_t *)((char *)ring->cqRing + p.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)((char *)ring->cqRing + p.cq_off.cqes);
+
+  return ring;
+
+_err:
+  uError("failed to map io_uring since %s, read files synchronously", strerror(errno));
+  taosAioCloseRing(ring);
+  return NULL;
+}
+
+// queue one read and submit it, the sqe is only published if the submission succeeds
+static int32_t taosAioSubmitRing(SAioRing *ring, FileFd fd, SAioReq *pReq, int32_t reqIndex, int64_t offset) {
+  uint32_t             tail = *ring->sqTail;
+  uint32_t             idx = tail & *ring->sqMask;
+  struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->off = (uint64_t)offset;
+  sqe->addr = (uint64_t)(uintptr_t)(&pReq->iov);
+  sqe->len = 1;
+  sqe->user_data = (uint64_t)reqIndex;
+  ring->sqArray[idx] = idx;
+
+  __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+  while (true) {
+    int32_t ret = (int32_t)syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+    if (ret == 1) return 0;
+    if (ret < 0 && errno == EINTR) continue;
+    break;
+  }
+
+  // the kernel did not take the sqe, it is never submitted again since later enters submit nothing
+  return -1;
+}
+#endif
+
+SAioCtx *taosAioOpen(int32_t depth) {
+  SAioCtx *pCtx = calloc(1, sizeof(SAioCtx));
+  if (pCtx == NULL) return NULL;
+
+  pCtx->depth = depth;
+  pCtx->done = calloc(depth, sizeof(SAioResult));
+  pCtx->reqs = calloc(depth, sizeof(SAioReq));
+  if (pCtx->done == NULL || pCtx->reqs == NULL) {
+    taosAioClose(pCtx);
+    return NULL;
+  }
+
+#ifdef TD_AIO_IO_URING
+  pCtx->ring = taosAioOpenRing((uint32_t)depth);
+#endif
+
+  return pCtx;
+}
+
+void taosAioClose(SAioCtx *pCtx) {
+  if (pCtx == NULL) return;
+
+  // the buffers may still be written by the kernel, wait for all of them
+  uint64_t tag;
+  int64_t  result;
+  while (pCtx->numOfInflight > 0 && taosAioWait(pCtx, &tag, &result) > 0) {
+  }
+
+#ifdef TD_AIO_IO_URING
+  if (pCtx->ring) taosAioCloseRing(pCtx->ring);
+#endif
+
+  free(pCtx->done);
+  free(pCtx->reqs);
+  free(pCtx);
+}
+
+bool taosAioIsAsync(SAioCtx *pCtx) {
+#ifdef TD_AIO_IO_URING
+  return pCtx->ring != NULL && !pCtx->ringFailed;
+#else
+  return false;
+#endif
+}
+
+int32_t taosAioRead(SAioCtx *pCtx, FileFd fd, void *buf, int64_t count, int64_t offset, uint64_t tag) {
+  if (pCtx->numOfInflight + pCtx->numOfDone >= pCtx->depth) {
+    terrno = TAOS_SYSTEM_ERROR(EAGAIN);
+    return -1;
+  }
+
+#ifdef TD_AIO_IO_URING
+  if (pCtx->ring && !pCtx->ringFailed) {
+    int32_t reqIndex = 0;
+    while (pCtx->reqs[reqIndex].used) reqIndex++;
+
+    SAioReq *pReq = &pCtx->reqs[reqIndex];
+    pReq->tag = tag;
+    pReq->iov.iov_base = buf;
+    pReq->iov.iov_len = (size_t)count;
+
+    if (taosAioSubmitRing(pCtx->ring, fd, pReq, reqIndex, offset) == 0) {
+      pReq->used = true;
+      pCtx->numOfInflight++;
+      return 0;
+    }
+
+    uError("failed to submit read to io_uring since %s, read files synchronously", strerror(errno));
+    pCtx->ringFailed = true;
+  }
+#endif
+
+  SAioResult *pResult = &pCtx->done[(pCtx->doneHead + pCtx->numOfDone) % pCtx->depth];
+  pResult->tag = tag;
+  pResult->result = taosAioPRead(fd, buf, count, offset);
+  if (pResult->result < 0) pResult->result = -errno;
+  pCtx->numOfDone++;
+
+  return 0;
+}
+
+// Wait for one read to complete, result is the number of bytes read or -errno. It returns 0 if there
+// is no read to wait for.
+int32_t taosAioWait(SAioCtx *pCtx, uint64_t *tag, int64_t *result) {
+  if (pCtx->numOfDone > 0) {
+    SAioResult *pResult = &pCtx->done[pCtx->doneHead];
+    *tag = pResult->tag;
+    *result = pResult->result;
+    pCtx->doneHead = (pCtx->doneHead + 1) % pCtx->depth;
+    pCtx->numOfDone--;
+    return 1;
+  }
+
+#ifdef TD_AIO_IO_URING
+  SAioRing *ring = pCtx->ring;
+  if (ring == NULL || pCtx->numOfInflight == 0) return 0;
+
+  while (true) {
+    uint32_t head = *ring->cqHead;
+    if (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+      struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+      SAioReq *            pReq = &pCtx->reqs[cqe->user_data];
+
+      *tag = pReq->tag;
+      *result = cqe->res;
+      pReq->used = false;
+      pCtx->numOfInflight--;
+
+      __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+      return 1;
+    }
+
+    int32_t ret = (int32_t)syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (ret < 0 && errno != EINTR) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return -1;
+    }
+  }
+#else
+  return 0;
+#endif
+}
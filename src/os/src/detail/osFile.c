@@ -18,6 +18,14 @@
 #include "tglobal.h"
 #include "tulog.h"
 
+#if defined(_TD_LINUX_64) && __has_include(<linux/falloc.h>)
+#include <linux/falloc.h>
+#include <sys/syscall.h>
+#if defined(__NR_fallocate) && defined(FALLOC_FL_ZERO_RANGE)
+#define TD_FALLOCATE
+#endif
+#endif
+
 void taosClose(FileFd fd) {
   close(fd);
   fd = FD_INITIALIZER;
@@ -377,6 +385,13 @@ int32_t taosFsync(FileFd fd) {
   return FlushFileBuffers(h)-1;
 }
 
+int32_t taosFdatasync(FileFd fd) { return taosFsync(fd); }
+
+int32_t taosFallocate(FileFd fd, int64_t length) {
+  if (taosFtruncate(fd, 0) != 0) return -1;
+  return taosFtruncate(fd, length);
+}
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = MoveFileEx(oldName, newName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED);
   if (code < 0) {
@@ -393,6 +408,25 @@ int32_t taosRename(char *oldName, char *newName) {
 int32_t taosFtruncate(FileFd fd, int64_t length) { return ftruncate(fd, length); }
 int32_t taosFsync(FileFd fd) { return fsync(fd); }
 
+#if defined(_TD_DARWIN_64)
+int32_t taosFdatasync(FileFd fd) { return fsync(fd); }
+#else
+int32_t taosFdatasync(FileFd fd) { return fdatasync(fd); }
+#endif
+
+int32_t taosFallocate(FileFd fd, int64_t length) {
+#if defined(TD_FALLOCATE)
+  if (syscall(__NR_fallocate, fd, FALLOC_FL_ZERO_RANGE, (off_t)0, (off_t)length) == 0) return ftruncate(fd, length);
+
+  // the file system cannot zero the blocks in place, drop them and allocate again
+  if (ftruncate(fd, 0) != 0) return -1;
+  if (syscall(__NR_fallocate, fd, 0, (off_t)0, (off_t)length) == 0) return 0;
+#else
+  if (ftruncate(fd, 0) != 0) return -1;
+#endif
+  return ftruncate(fd, length);
+}
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = rename(oldName, newName);
   if (code < 0) {
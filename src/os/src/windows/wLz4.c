@@ -67,4 +67,11 @@ int32_t BUILDIN_CTZ(uint32_t val) {
   unsigned long r = 0;
   _BitScanForward(&r, val);
   return (int)(r >> 3);
-}
\ No newline at end of file
+}
+
+int32_t BUILDIN_POPCOUNTL(uint64_t val) {
+  val = val - ((val >> 1) & 0x5555555555555555ULL);
+  val = (val & 0x3333333333333333ULL) + ((val >> 2) & 0x3333333333333333ULL);
+  val = (val + (val >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int32_t)((val * 0x0101010101010101ULL) >> 56);
+}
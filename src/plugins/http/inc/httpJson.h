@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #define JSON_BUFFER_SIZE 16384
 struct HttpContext;
@@ -36,12 +37,23 @@ extern char JsonNulTkn[];
 extern char JsonTrueTkn[];
 extern char JsonFalseTkn[];
 
+// the local time of a span of seconds with the same utc offset, so that most timestamps skip localtime_r
+typedef struct {
+  int64_t   start;  // first second of the span
+  int64_t   end;    // exclusive
+  bool      valid;  // the year has four digits
+  int32_t   zoneLen;
+  char      zone[8];
+  struct tm tm;     // local time of the first second
+} JsonTimeCache;
+
 typedef struct {
   int32_t size;
   int32_t total;
   char*   lst;
   char    buf[JSON_BUFFER_SIZE];
   struct  HttpContext* pContext;
+  JsonTimeCache timeCache;
 } JsonBuf;
 
 // http response
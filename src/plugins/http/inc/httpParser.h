@@ -19,6 +19,10 @@
 
 #define HTTP_MAX_URL 6  // http url stack size
 
+#define HTTP_ACCEPT_JSON         0
+#define HTTP_ACCEPT_COLUMNAR     1
+#define HTTP_ACCEPT_COLUMNAR_LZ4 2
+
 #define HTTP_CODE_CONTINUE                 100
 #define HTTP_CODE_SWITCHING_PROTOCOL       101
 #define HTTP_CODE_PROCESSING               102
@@ -157,6 +161,7 @@ typedef struct HttpParser {
   int8_t  httpVersion;
   int8_t  acceptEncodingGzip;
   int8_t  acceptEncodingChunked;
+  int8_t  acceptColumnar;
   int8_t  contentLengthSpecified;
   int8_t  contentChunked;
   int8_t  transferGzip;
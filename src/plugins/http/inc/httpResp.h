@@ -27,6 +27,8 @@ enum _httpRespTempl {
   HTTP_RESPONSE_CHUNKED_COMPRESS,
   HTTP_RESPONSE_OPTIONS,
   HTTP_RESPONSE_GRAFANA,
+  HTTP_RESPONSE_CHUNKED_COLUMNAR_UN_COMPRESS,
+  HTTP_RESPONSE_CHUNKED_COLUMNAR_COMPRESS,
   HTTP_RESP_END
 };
 
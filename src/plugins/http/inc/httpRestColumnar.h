@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_REST_COLUMNAR_H
+#define TDENGINE_REST_COLUMNAR_H
+#include <stdbool.h>
+#include "httpHandle.h"
+#include "taos.h"
+
+/*
+ * The result of a query in columns, returned to the clients sending "Accept: application/vnd.taosdata.columnar",
+ * optionally with "; compress=lz4". All integers are little endian, and every part starts at 8-byte alignment.
+ *
+ *   stream := head column[numOfCols] block* end
+ *   column := SRestColumnarCol, name padded to 8 bytes
+ *   block  := SRestColumnarBlock, data of dataLen bytes padded to 8 bytes, which is compressed by lz4 if the codec
+ *             is REST_COLUMNAR_CODEC_LZ4 and rawLen bytes after decompression
+ *   end    := SRestColumnarEnd
+ *
+ * The data of a block holds the buffers of each column in the layout of apache arrow, so that they can be wrapped
+ * as arrow arrays without copy:
+ *   validity bitmap of numOfRows bits, least significant bit first, 1 for the values which are not null
+ *   fixed length types: the values, numOfRows * bytes, bool takes one byte, timestamp is int64 in the precision
+ *   binary, nchar, json: int32 offsets[numOfRows + 1], and the utf-8 data of all values
+ */
+#define REST_COLUMNAR_CONTENT_TYPE "application/vnd.taosdata.columnar"
+#define REST_COLUMNAR_MAGIC        "TDCB"
+#define REST_COLUMNAR_VERSION      1
+#define REST_COLUMNAR_CODEC_NONE   0
+#define REST_COLUMNAR_CODEC_LZ4    1
+
+typedef struct {
+  char     magic[4];
+  uint16_t version;
+  uint16_t numOfCols;
+  uint8_t  precision;
+  uint8_t  codec;  // the codec asked by the client, blocks which do not shrink are sent uncompressed
+  uint8_t  reserved[6];
+} SRestColumnarHead;
+
+typedef struct {
+  uint8_t  type;
+  uint8_t  reserved;
+  uint16_t nameLen;
+  int32_t  bytes;
+} SRestColumnarCol;
+
+typedef struct {
+  int32_t numOfRows;
+  uint8_t codec;
+  uint8_t reserved[3];
+  int32_t rawLen;
+  int32_t dataLen;
+} SRestColumnarBlock;
+
+typedef struct {
+  int32_t numOfRows;  // always 0
+  int32_t code;       // error code if the retrieve failed
+  int64_t totalRows;
+} SRestColumnarEnd;
+
+void restStartSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result);
+bool restBuildSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows);
+void restBuildSqlAffectRowsColumnar(HttpContext *pContext, HttpSqlCmd *cmd, int32_t affect_rows);
+void restStopSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd);
+
+#endif
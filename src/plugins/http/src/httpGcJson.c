@@ -19,6 +19,7 @@
 #include "httpGcJson.h"
 #include "httpJson.h"
 #include "httpResp.h"
+#include "tnumfmt.h"
 
 unsigned char *base64_decode(const char *value, int inlen, int *outlen);
 
@@ -181,14 +182,20 @@ bool gcBuildQueryJson(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result,
             cur = snprintf(target + len, HTTP_GC_TARGET_SIZE - len - 2, "%s:%" PRId64, fields[i].name, *((int64_t *)row[i]));
             HTTP_GC_CHECK_SIZE(fields[i].name)
             break;
-          case TSDB_DATA_TYPE_FLOAT:
-            cur = snprintf(target + len, HTTP_GC_TARGET_SIZE - len - 2, "%s:%.5f", fields[i].name, GET_FLOAT_VAL(row[i]));
+          case TSDB_DATA_TYPE_FLOAT: {
+            char num[TNUMFMT_MAX_LEN];
+            tFloatToStr(GET_FLOAT_VAL(row[i]), num);
+            cur = snprintf(target + len, HTTP_GC_TARGET_SIZE - len - 2, "%s:%s", fields[i].name, num);
             HTTP_GC_CHECK_SIZE(fields[i].name)
             break;
-          case TSDB_DATA_TYPE_DOUBLE:
-            cur = snprintf(target + len, HTTP_GC_TARGET_SIZE - len - 2, "%s:%.9f", fields[i].name, GET_DOUBLE_VAL(row[i]));
+          }
+          case TSDB_DATA_TYPE_DOUBLE: {
+            char num[TNUMFMT_MAX_LEN];
+            tDoubleToStr(GET_DOUBLE_VAL(row[i]), num);
+            cur = snprintf(target + len, HTTP_GC_TARGET_SIZE - len - 2, "%s:%s", fields[i].name, num);
             HTTP_GC_CHECK_SIZE(fields[i].name)
             break;
+          }
           case TSDB_DATA_TYPE_BINARY:
           case TSDB_DATA_TYPE_NCHAR:
             if (row[i] != NULL) {
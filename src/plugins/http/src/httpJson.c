@@ -17,6 +17,7 @@
 #include "os.h"
 #include "taosmsg.h"
 #include "taoserror.h"
+#include "tnumfmt.h"
 #include "tglobal.h"
 #include "http.h"
 #include "httpLog.h"
@@ -24,7 +25,8 @@
 #include "httpResp.h"
 #include "httpUtil.h"
 
-#define MAX_NUM_STR_SZ 25
+#define MAX_NUM_STR_SZ TNUMFMT_MAX_LEN
+#define MAX_TIME_STR_SZ 40
 
 char JsonItmTkn = ',';
 char JsonObjStt = '{';
@@ -38,6 +40,19 @@ char JsonNulTkn[] = "null";
 char JsonTrueTkn[] = "true";
 char JsonFalseTkn[] = "false";
 
+// wait until the socket drains, the rows are fetched no faster than the client reads the chunks
+static void httpWaitWritable(struct HttpContext* pContext) {
+#ifdef WINDOWS
+  taosMsleep(HTTP_WRITE_WAIT_TIME_MS);
+#else
+  if (errno == EAGAIN || errno == EWOULDBLOCK) {
+    struct pollfd pfd = {.fd = pContext->fd, .events = POLLOUT};
+    if (poll(&pfd, 1, HTTP_WRITE_WAIT_TIME_MS) >= 0) return;
+  }
+  taosMsleep(HTTP_WRITE_WAIT_TIME_MS);
+#endif
+}
+
 int32_t httpWriteBufByFd(struct HttpContext* pContext, const char* buf, int32_t sz) {
   int32_t len;
   int32_t countWait = 0;
@@ -54,7 +69,7 @@ int32_t httpWriteBufByFd(struct HttpContext* pContext, const char* buf, int32_t
       httpDebug("context:%p, fd:%d, socket write errno:%d:%s, times:%d", pContext, pContext->fd, errno, strerror(errno),
                 countWait);
       if (++countWait > HTTP_WRITE_RETRY_TIMES) break;
-      taosMsleep(HTTP_WRITE_WAIT_TIME_MS);
+      httpWaitWritable(pContext);
       continue;
     } else if (len == 0) {
       httpDebug("context:%p, fd:%d, socket write errno:%d:%s, connect already closed", pContext, pContext->fd, errno,
@@ -96,6 +111,8 @@ int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast) {
   char    sLen[24];
   int32_t srcLen = (int32_t)(buf->lst - buf->buf);
 
+  *buf->lst = 0;  // for the trace
+
   if (buf->pContext->fd <= 0) {
     httpTrace("context:%p, fd:%d, write json body error", buf->pContext, buf->pContext->fd);
     buf->pContext->fd = -1;
@@ -121,7 +138,7 @@ int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast) {
       remain = httpWriteBufNoTrace(buf->pContext, buf->buf, srcLen);
     }
   } else {
-    char    compressBuf[JSON_BUFFER_SIZE] = {0};
+    char    compressBuf[JSON_BUFFER_SIZE];
     int32_t compressBufLen = JSON_BUFFER_SIZE;
     int32_t ret = httpGzipCompress(buf->pContext, buf->buf, srcLen, compressBuf, &compressBufLen, isTheLast);
     if (ret == 0) {
@@ -146,7 +163,6 @@ int32_t httpWriteJsonBufBody(JsonBuf* buf, bool isTheLast) {
   httpWriteBufNoTrace(buf->pContext, "\r\n", 2);
   buf->total += (int32_t)(buf->lst - buf->buf);
   buf->lst = buf->buf;
-  memset(buf->buf, 0, (size_t)buf->size);
   return remain;
 }
 
@@ -184,7 +200,7 @@ void httpInitJsonBuf(JsonBuf* buf, struct HttpContext* pContext) {
   buf->total = 0;
   buf->size = JSON_BUFFER_SIZE;  // option setting
   buf->pContext = pContext;
-  memset(buf->lst, 0, JSON_BUFFER_SIZE);
+  *buf->lst = 0;
 
   if (pContext->parser->acceptEncodingGzip == 1 && tsHttpEnableCompress) {
     httpGzipCompressInit(buf->pContext);
@@ -253,122 +269,127 @@ void httpJsonStringForTransMean(JsonBuf* buf, char* sVal, int32_t maxLen) {
 void httpJsonInt64(JsonBuf* buf, int64_t num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%" PRId64, num);
+  buf->lst += tInt64ToStr(num, buf->lst);
 }
 
 void httpJsonUInt64(JsonBuf* buf, uint64_t num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%" PRIu64, num);
+  buf->lst += tUInt64ToStr(num, buf->lst);
 }
 
-void httpJsonTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
-  char       ts[35] = {0};
-  
-  int32_t fractionLen;
-  char* format = NULL;
-  time_t quot = 0;
-  int64_t mod = 0;
+static int32_t httpJsonSplitTime(int64_t t, int32_t timePrecision, time_t* quot, uint32_t* mod) {
+  int64_t unit = 0;
+  int32_t digits = 0;
 
   switch (timePrecision) {
-    case TSDB_TIME_PRECISION_MILLI: {
-      mod = ((t) % 1000 + 1000) % 1000;
-      if (t < 0 && mod != 0) {
-        t -= 1000;
-      }
-      quot = t / 1000;
-      fractionLen = 5;
-      format = ".%03" PRId64;
+    case TSDB_TIME_PRECISION_MILLI:
+      unit = 1000;
+      digits = 3;
       break;
-    }
-
-    case TSDB_TIME_PRECISION_MICRO: {
-      mod = ((t) % 1000000 + 1000000) % 1000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000;
-      }
-      quot = t / 1000000;
-      fractionLen = 8;
-      format = ".%06" PRId64;
+    case TSDB_TIME_PRECISION_MICRO:
+      unit = 1000000;
+      digits = 6;
       break;
-    }
-
-    case TSDB_TIME_PRECISION_NANO: {
-      mod = ((t) % 1000000000 + 1000000000) % 1000000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000000;
-      }
-      quot = t / 1000000000;
-      fractionLen = 11;
-      format = ".%09" PRId64;
+    case TSDB_TIME_PRECISION_NANO:
+      unit = 1000000000;
+      digits = 9;
       break;
-    }
-
     default:
-      fractionLen = 0;
       assert(false);
+      unit = 1000;
+      digits = 3;
   }
 
-  struct tm ptm = {0};
-  localtime_r(&quot, &ptm);
-  int32_t length = (int32_t)strftime(ts, 35, "%Y-%m-%d %H:%M:%S", &ptm);
-  length += snprintf(ts + length, fractionLen, format, mod);
+  int64_t m = (t % unit + unit) % unit;
+  *quot = (time_t)((t - m) / unit);
+  *mod = (uint32_t)m;
+  return digits;
+}
 
-  httpJsonString(buf, ts, length);
+/*
+ * Write the local time of quot as "%Y-%m-%d %H:%M:%S" with the separator sep between the date and the time. The
+ * local time of a 15-minute span is cached and the seconds into the span are added, utc offsets change at such
+ * boundaries. The span never crosses the local midnight. Returns the length, and writes the "%z" zone if asked.
+ */
+static int32_t httpJsonFormatTime(JsonBuf* buf, time_t quot, char sep, char* ts, char* zone, int32_t* zoneLen) {
+  JsonTimeCache* pCache = &buf->timeCache;
+
+  if (quot < pCache->start || quot >= pCache->end) {
+    time_t start = quot - (time_t)(((int64_t)quot % 900 + 900) % 900);
+    localtime_r(&start, &pCache->tm);
+
+    int32_t secOfDay = pCache->tm.tm_hour * 3600 + pCache->tm.tm_min * 60 + pCache->tm.tm_sec;
+    pCache->start = start;
+    pCache->end = start + MIN(900, 86400 - secOfDay);
+    pCache->valid = pCache->tm.tm_year >= -1900 && pCache->tm.tm_year <= 9999 - 1900;
+    pCache->zoneLen = (int32_t)strftime(pCache->zone, sizeof(pCache->zone), "%z", &pCache->tm);
+  }
+
+  if (!pCache->valid || quot < pCache->start || quot >= pCache->end) {
+    struct tm ptm = {0};
+    localtime_r(&quot, &ptm);
+    char fmt[] = "%Y-%m-%d %H:%M:%S";
+    fmt[8] = sep;
+    int32_t length = (int32_t)strftime(ts, MAX_TIME_STR_SZ, fmt, &ptm);
+    if (zone != NULL) {
+      *zoneLen = (int32_t)strftime(zone, sizeof(pCache->zone), "%z", &ptm);
+    }
+    return length;
+  }
+
+  struct tm* tm = &pCache->tm;
+  int32_t    sec = tm->tm_hour * 3600 + tm->tm_min * 60 + tm->tm_sec + (int32_t)(quot - pCache->start);
+
+  tFmtPadDigits((uint32_t)(tm->tm_year + 1900), 4, ts);
+  ts[4] = '-';
+  tFmtPadDigits((uint32_t)(tm->tm_mon + 1), 2, ts + 5);
+  ts[7] = '-';
+  tFmtPadDigits((uint32_t)tm->tm_mday, 2, ts + 8);
+  ts[10] = sep;
+  tFmtPadDigits((uint32_t)(sec / 3600), 2, ts + 11);
+  ts[13] = ':';
+  tFmtPadDigits((uint32_t)(sec / 60 % 60), 2, ts + 14);
+  ts[16] = ':';
+  tFmtPadDigits((uint32_t)(sec % 60), 2, ts + 17);
+
+  if (zone != NULL) {
+    memcpy(zone, pCache->zone, sizeof(pCache->zone));
+    *zoneLen = pCache->zoneLen;
+  }
+  return 19;
 }
 
-void httpJsonUtcTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
-  char       ts[40] = {0};
-  struct tm* ptm;
+void httpJsonTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
+  char     ts[MAX_TIME_STR_SZ];
+  time_t   quot = 0;
+  uint32_t mod = 0;
 
-  int32_t fractionLen;
-  char* format = NULL;
-  time_t quot = 0;
-  long mod = 0;
+  int32_t digits = httpJsonSplitTime(t, timePrecision, &quot, &mod);
+  int32_t length = httpJsonFormatTime(buf, quot, ' ', ts, NULL, NULL);
 
-  switch (timePrecision) {
-    case TSDB_TIME_PRECISION_MILLI: {
-      mod = ((t) % 1000 + 1000) % 1000;
-      if (t < 0 && mod != 0) {
-        t -= 1000;
-      }
-      quot = t / 1000;
-      fractionLen = 5;
-      format = ".%03" PRId64;
-      break;
-    }
+  ts[length++] = '.';
+  tFmtPadDigits(mod, digits, ts + length);
+  length += digits;
 
-    case TSDB_TIME_PRECISION_MICRO: {
-      mod = ((t) % 1000000 + 1000000) % 1000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000;
-      }
-      quot = t / 1000000;
-      fractionLen = 8;
-      format = ".%06" PRId64;
-      break;
-    }
+  httpJsonString(buf, ts, length);
+}
 
-    case TSDB_TIME_PRECISION_NANO: {
-      mod = ((t) % 1000000000 + 1000000000) % 1000000000;
-      if (t < 0 && mod != 0) {
-        t -= 1000000000;
-      }
-      quot = t / 1000000000;
-      fractionLen = 11;
-      format = ".%09" PRId64;
-      break;
-    }
+void httpJsonUtcTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
+  char     ts[MAX_TIME_STR_SZ];
+  char     zone[sizeof(buf->timeCache.zone)];
+  time_t   quot = 0;
+  uint32_t mod = 0;
+  int32_t  zoneLen = 0;
 
-    default:
-      fractionLen = 0;
-      assert(false);
-  }
+  int32_t digits = httpJsonSplitTime(t, timePrecision, &quot, &mod);
+  int32_t length = httpJsonFormatTime(buf, quot, 'T', ts, zone, &zoneLen);
 
-  ptm = localtime(&quot);
-  int32_t length = (int32_t)strftime(ts, 40, "%Y-%m-%dT%H:%M:%S", ptm);
-  length += snprintf(ts + length, fractionLen, format, mod);
-  length += (int32_t)strftime(ts + length, 40 - length, "%z", ptm);
+  ts[length++] = '.';
+  tFmtPadDigits(mod, digits, ts + length);
+  length += digits;
+  memcpy(ts + length, zone, zoneLen);
+  length += zoneLen;
 
   httpJsonString(buf, ts, length);
 }
@@ -376,24 +397,24 @@ void httpJsonUtcTimestamp(JsonBuf* buf, int64_t t, int32_t timePrecision) {
 void httpJsonInt(JsonBuf* buf, int32_t num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%d", num);
+  buf->lst += tInt64ToStr(num, buf->lst);
 }
 
 void httpJsonUInt(JsonBuf* buf, uint32_t num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
-  buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%u", num);
+  buf->lst += tUInt64ToStr(num, buf->lst);
 }
 
+// the shortest text which reads back as the same value, instead of a fixed number of decimals
 void httpJsonFloat(JsonBuf* buf, float num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
   if (isinf(num) || isnan(num)) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "null");
-  } else if (num > 1E10 || num < -1E10) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.5e", num);
+    memcpy(buf->lst, JsonNulTkn, sizeof(JsonNulTkn) - 1);
+    buf->lst += sizeof(JsonNulTkn) - 1;
   } else {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.5f", num);
+    buf->lst += tFloatToStr(num, buf->lst);
   }
 }
 
@@ -401,11 +422,10 @@ void httpJsonDouble(JsonBuf* buf, double num) {
   httpJsonItemToken(buf);
   httpJsonTestBuf(buf, MAX_NUM_STR_SZ);
   if (isinf(num) || isnan(num)) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "null");
-  } else if (num > 1E10 || num < -1E10) {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.9e", num);
+    memcpy(buf->lst, JsonNulTkn, sizeof(JsonNulTkn) - 1);
+    buf->lst += sizeof(JsonNulTkn) - 1;
   } else {
-    buf->lst += snprintf(buf->lst, MAX_NUM_STR_SZ, "%.9f", num);
+    buf->lst += tDoubleToStr(num, buf->lst);
   }
 }
 
@@ -21,6 +21,7 @@
 #include "httpParser.h"
 #include "httpGzip.h"
 #include "httpAuth.h"
+#include "httpRestColumnar.h"
 
 static void httpOnData(ehttp_gzip_t *gzip, void *arg, const char *buf, int32_t len);
 
@@ -242,6 +243,14 @@ static int32_t httpOnParseHeaderField(HttpParser *parser, const char *key, const
     return 0;
   }
 
+  else if (0 == strcasecmp(key, "Accept")) {
+    if (strstr(val, REST_COLUMNAR_CONTENT_TYPE)) {
+      parser->acceptColumnar = strstr(val, "compress=lz4") ? HTTP_ACCEPT_COLUMNAR_LZ4 : HTTP_ACCEPT_COLUMNAR;
+      httpTrace("context:%p, fd:%d, acceptColumnar:%d", pContext, pContext->fd, parser->acceptColumnar);
+    }
+    return 0;
+  }
+
   else if (strncasecmp(key, "Connection", 10) == 0) {
     if (strncasecmp(val, "Keep-Alive", 10) == 0) {
       parser->keepAlive = HTTP_KEEPALIVE_ENABLE;
@@ -443,6 +452,7 @@ void httpInitParser(HttpParser *parser) {
   parser->httpVersion = 0;
   parser->acceptEncodingGzip = 0;
   parser->acceptEncodingChunked = 0;
+  parser->acceptColumnar = HTTP_ACCEPT_JSON;
   parser->contentLengthSpecified = 0;
   parser->contentChunked = 0;
   parser->transferGzip = 0;
@@ -21,6 +21,7 @@
 #include "httpResp.h"
 #include "httpJson.h"
 #include "httpContext.h"
+#include "httpRestColumnar.h"
 #include "monitor.h"
 
 const char *httpKeepAliveStr[] = {"", "Connection: Keep-Alive\r\n", "Connection: Close\r\n"};
@@ -42,7 +43,10 @@ const char *httpRespTemplate[] = {
     // HTTP_RESPONSE_OPTIONS
     "%s 200 OK\r\nAccess-Control-Allow-Origin:*\r\n%sContent-Type: application/json;charset=utf-8\r\nContent-Length: %d\r\nAccess-Control-Allow-Methods: *\r\nAccess-Control-Max-Age: 3600\r\nAccess-Control-Allow-Headers: Origin, X-Requested-With, Content-Type, Accept, authorization\r\n\r\n",
     // HTTP_RESPONSE_GRAFANA
-    "%s 200 OK\r\nAccess-Control-Allow-Origin:*\r\n%sAccess-Control-Allow-Methods:POST, GET, OPTIONS, DELETE, PUT\r\nAccess-Control-Allow-Headers:Accept, Content-Type\r\nContent-Type: application/json;charset=utf-8\r\nContent-Length: %d\r\n\r\n"
+    "%s 200 OK\r\nAccess-Control-Allow-Origin:*\r\n%sAccess-Control-Allow-Methods:POST, GET, OPTIONS, DELETE, PUT\r\nAccess-Control-Allow-Headers:Accept, Content-Type\r\nContent-Type: application/json;charset=utf-8\r\nContent-Length: %d\r\n\r\n",
+    // HTTP_RESPONSE_CHUNKED_COLUMNAR_UN_COMPRESS, HTTP_RESPONSE_CHUNKED_COLUMNAR_COMPRESS
+    "%s 200 OK\r\nAccess-Control-Allow-Origin:*\r\n%sContent-Type: " REST_COLUMNAR_CONTENT_TYPE "\r\nTransfer-Encoding: chunked\r\n\r\n",
+    "%s 200 OK\r\nAccess-Control-Allow-Origin:*\r\n%sContent-Type: " REST_COLUMNAR_CONTENT_TYPE "\r\nContent-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n\r\n"
 };
 
 static void httpSendErrorRespImp(HttpContext *pContext, int32_t httpCode, char *httpCodeStr, int32_t errNo, const char *desc) {
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "os.h"
+#include "lz4.h"
+#include "tglobal.h"
+#include "tsclient.h"
+#include "tscUtil.h"
+#include "httpLog.h"
+#include "httpJson.h"
+#include "httpResp.h"
+#include "httpUtil.h"
+#include "httpRestJson.h"
+#include "httpRestColumnar.h"
+
+#define REST_COLUMNAR_ALIGN(n) (((n) + 7) & ~7)
+
+static bool restColumnarIsVarType(int32_t type) {
+  return IS_VAR_DATA_TYPE(type) || type == TSDB_DATA_TYPE_JSON;
+}
+
+// the json buffer only serves as the chunk buffer here, one byte is kept for the terminator of the trace
+static void restColumnarWrite(JsonBuf *buf, const void *data, int32_t len) {
+  const char *p = data;
+
+  while (len > 0) {
+    int32_t space = buf->size - (int32_t)(buf->lst - buf->buf) - 1;
+    if (space <= 0) {
+      httpWriteJsonBufBody(buf, false);
+      continue;
+    }
+
+    int32_t n = MIN(space, len);
+    memcpy(buf->lst, p, (size_t)n);
+    buf->lst += n;
+    p += n;
+    len -= n;
+  }
+}
+
+static void restColumnarPad(JsonBuf *buf, int32_t len) {
+  static const char zeros[8] = {0};
+  if (REST_COLUMNAR_ALIGN(len) > len) {
+    restColumnarWrite(buf, zeros, REST_COLUMNAR_ALIGN(len) - len);
+  }
+}
+
+static void restColumnarWriteHead(JsonBuf *buf) {
+  HttpParser *pParser = buf->pContext->parser;
+  char        msg[1024] = {0};
+  int32_t     templ = HTTP_RESPONSE_CHUNKED_COLUMNAR_UN_COMPRESS;
+
+  if (pParser->acceptEncodingGzip != 0 && tsHttpEnableCompress) {
+    templ = HTTP_RESPONSE_CHUNKED_COLUMNAR_COMPRESS;
+  }
+
+  int32_t len = sprintf(msg, httpRespTemplate[templ], httpVersionStr[pParser->httpVersion],
+                        httpKeepAliveStr[pParser->keepAlive]);
+  httpWriteBuf(buf->pContext, (const char *)msg, len);
+}
+
+static void restColumnarWriteCol(JsonBuf *buf, int32_t type, int32_t bytes, const char *name) {
+  SRestColumnarCol col = {.type = (uint8_t)type, .nameLen = (uint16_t)strlen(name), .bytes = bytes};
+
+  restColumnarWrite(buf, &col, sizeof(col));
+  restColumnarWrite(buf, name, col.nameLen);
+  restColumnarPad(buf, col.nameLen);
+}
+
+void restStartSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result) {
+  JsonBuf *buf = httpMallocJsonBuf(pContext);
+  if (buf == NULL) return;
+
+  TAOS_FIELD *fields = taos_fetch_fields(result);
+  int32_t     numOfFields = taos_num_fields(result);
+
+  httpInitJsonBuf(buf, pContext);
+  restColumnarWriteHead(buf);
+
+  SRestColumnarHead head = {.version = REST_COLUMNAR_VERSION,
+                            .numOfCols = (uint16_t)MAX(numOfFields, 1),
+                            .precision = (uint8_t)taos_result_precision(result),
+                            .codec = REST_COLUMNAR_CODEC_NONE};
+  memcpy(head.magic, REST_COLUMNAR_MAGIC, sizeof(head.magic));
+  if (pContext->parser->acceptColumnar == HTTP_ACCEPT_COLUMNAR_LZ4) {
+    head.codec = REST_COLUMNAR_CODEC_LZ4;
+  }
+
+  restColumnarWrite(buf, &head, sizeof(head));
+
+  if (numOfFields == 0) {
+    restColumnarWriteCol(buf, TSDB_DATA_TYPE_INT, sizeof(int32_t), REST_JSON_AFFECT_ROWS);
+  } else {
+    for (int32_t i = 0; i < numOfFields; ++i) {
+      restColumnarWriteCol(buf, fields[i].type, fields[i].bytes, fields[i].name);
+    }
+  }
+
+  cmd->code = TSDB_CODE_SUCCESS;
+}
+
+typedef struct {
+  int32_t type;
+  int32_t bytes;  // the stride of the values in the result block
+  char   *data;
+} SRestColumnarData;
+
+static int32_t restColumnarDataLen(SRestColumnarData *cols, int32_t numOfCols, int32_t rows) {
+  int32_t len = 0;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    len += REST_COLUMNAR_ALIGN((rows + 7) / 8);
+
+    if (!restColumnarIsVarType(cols[i].type)) {
+      len += REST_COLUMNAR_ALIGN(rows * cols[i].bytes);
+      continue;
+    }
+
+    int32_t varLen = 0;
+    char   *p = cols[i].data;
+    for (int32_t k = 0; k < rows; ++k, p += cols[i].bytes) {
+      if (!isNull(p, cols[i].type)) varLen += varDataLen(p);
+    }
+
+    len += REST_COLUMNAR_ALIGN((rows + 1) * (int32_t)sizeof(int32_t)) + REST_COLUMNAR_ALIGN(varLen);
+  }
+
+  return len;
+}
+
+// lay out the columns of the block as the arrow buffers, the null values are marked in the bitmaps
+static void restColumnarFillData(SRestColumnarData *cols, int32_t numOfCols, int32_t rows, char *data) {
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    uint8_t *bitmap = (uint8_t *)data;
+    int32_t  type = cols[i].type;
+    int32_t  bytes = cols[i].bytes;
+    char    *p = cols[i].data;
+
+    data += REST_COLUMNAR_ALIGN((rows + 7) / 8);
+
+    if (!restColumnarIsVarType(type)) {
+      memcpy(data, p, (size_t)rows * bytes);
+      for (int32_t k = 0; k < rows; ++k, p += bytes) {
+        if (!isNull(p, type)) bitmap[k >> 3] |= (uint8_t)(1u << (k & 7));
+      }
+      data += REST_COLUMNAR_ALIGN(rows * bytes);
+      continue;
+    }
+
+    int32_t *offsets = (int32_t *)data;
+    char    *values = data + REST_COLUMNAR_ALIGN((rows + 1) * (int32_t)sizeof(int32_t));
+    int32_t  varLen = 0;
+
+    offsets[0] = 0;
+    for (int32_t k = 0; k < rows; ++k, p += bytes) {
+      if (!isNull(p, type)) {
+        bitmap[k >> 3] |= (uint8_t)(1u << (k & 7));
+        memcpy(values + varLen, varDataVal(p), varDataLen(p));
+        varLen += varDataLen(p);
+      }
+      offsets[k + 1] = varLen;
+    }
+
+    data = values + REST_COLUMNAR_ALIGN(varLen);
+  }
+}
+
+static bool restColumnarWriteBlock(HttpContext *pContext, SRestColumnarData *cols, int32_t numOfCols, int32_t rows) {
+  JsonBuf *buf = httpMallocJsonBuf(pContext);
+  if (buf == NULL) return false;
+
+  SRestColumnarBlock block = {.numOfRows = rows, .codec = REST_COLUMNAR_CODEC_NONE};
+  block.rawLen = restColumnarDataLen(cols, numOfCols, rows);
+
+  char *data = calloc(1, (size_t)block.rawLen);
+  if (data == NULL) {
+    httpError("context:%p, fd:%d, user:%s, failed to alloc %d bytes for the columnar block", pContext, pContext->fd,
+              pContext->user, block.rawLen);
+    return false;
+  }
+
+  restColumnarFillData(cols, numOfCols, rows, data);
+
+  char *out = data;
+  block.dataLen = block.rawLen;
+
+  if (pContext->parser->acceptColumnar == HTTP_ACCEPT_COLUMNAR_LZ4) {
+    int32_t bound = LZ4_compressBound(block.rawLen);
+    char   *compressed = malloc((size_t)bound);
+    int32_t len = (compressed == NULL) ? 0 : LZ4_compress_default(data, compressed, block.rawLen, bound);
+
+    if (len > 0 && len < block.rawLen) {
+      out = compressed;
+      block.codec = REST_COLUMNAR_CODEC_LZ4;
+      block.dataLen = len;
+    } else {
+      tfree(compressed);
+    }
+  }
+
+  restColumnarWrite(buf, &block, sizeof(block));
+  restColumnarWrite(buf, out, block.dataLen);
+  restColumnarPad(buf, block.dataLen);
+
+  if (out != data) free(out);
+  free(data);
+  return true;
+}
+
+bool restBuildSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd, TAOS_RES *result, int32_t numOfRows) {
+  SSqlObj    *pObj = (SSqlObj *)result;
+  SQueryInfo *pQueryInfo = tscGetQueryInfo(&pObj->cmd);
+  TAOS_ROW   *pRow = taos_result_block(result);
+  int32_t     rows = numOfRows;
+  bool        isContinue = true;
+
+  // the block was fetched asynchronously already, its columns are taken as they are
+  if (rows <= 0 || pQueryInfo == NULL || pRow == NULL || *pRow == NULL) {
+    return false;
+  }
+
+  if (cmd->numOfRows + rows >= tsRestRowLimit) {
+    httpDebug("context:%p, fd:%d, user:%s, retrieve rows:%d larger than limit:%d, abort retrieve", pContext,
+              pContext->fd, pContext->user, cmd->numOfRows + rows, tsRestRowLimit);
+    rows = tsRestRowLimit - cmd->numOfRows;
+    isContinue = false;
+  }
+
+  // the invisible columns are kept in the block, with the internal length of the var types
+  int32_t            numOfOutput = pQueryInfo->fieldsInfo.numOfOutput;
+  SRestColumnarData *cols = calloc((size_t)MAX(numOfOutput, 1), sizeof(SRestColumnarData));
+  int32_t            numOfCols = 0;
+
+  for (int32_t i = 0; cols != NULL && i < numOfOutput; ++i) {
+    SInternalField *pInfo = tscFieldInfoGetInternalField(&pQueryInfo->fieldsInfo, i);
+    if (!pInfo->visible) continue;
+
+    cols[numOfCols].type = pInfo->field.type;
+    cols[numOfCols].bytes = pInfo->field.bytes;
+    cols[numOfCols].data = (*pRow)[i];
+    numOfCols++;
+  }
+
+  if (cols == NULL || (rows > 0 && !restColumnarWriteBlock(pContext, cols, numOfCols, rows))) {
+    tfree(cols);
+    cmd->code = TSDB_CODE_HTTP_NO_ENOUGH_MEMORY;
+    return false;
+  }
+
+  tfree(cols);
+  cmd->numOfRows += rows;
+
+  if (pContext->fd <= 0) {
+    httpError("context:%p, fd:%d, user:%s, conn closed, abort retrieve", pContext, pContext->fd, pContext->user);
+    return false;
+  }
+
+  httpDebug("context:%p, fd:%d, user:%s, retrieved row:%d", pContext, pContext->fd, pContext->user, cmd->numOfRows);
+  return isContinue;
+}
+
+void restBuildSqlAffectRowsColumnar(HttpContext *pContext, HttpSqlCmd *cmd, int32_t affect_rows) {
+  SRestColumnarData col = {.type = TSDB_DATA_TYPE_INT, .bytes = sizeof(int32_t), .data = (char *)&affect_rows};
+
+  if (restColumnarWriteBlock(pContext, &col, 1, 1)) {
+    cmd->numOfRows = 1;
+  }
+}
+
+void restStopSqlColumnar(HttpContext *pContext, HttpSqlCmd *cmd) {
+  JsonBuf *buf = httpMallocJsonBuf(pContext);
+  if (buf == NULL) return;
+
+  SRestColumnarEnd end = {.numOfRows = 0, .code = cmd->code, .totalRows = cmd->numOfRows};
+  restColumnarWrite(buf, &end, sizeof(end));
+
+  httpWriteJsonBufEnd(buf);
+}
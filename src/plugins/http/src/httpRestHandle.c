@@ -19,6 +19,7 @@
 #include "httpLog.h"
 #include "httpRestHandle.h"
 #include "httpRestJson.h"
+#include "httpRestColumnar.h"
 #include "tglobal.h"
 
 static HttpDecodeMethod restDecodeMethod = {"rest", restProcessRequest};
@@ -56,6 +57,17 @@ static HttpEncodeMethod restEncodeSqlUtcTimeStringMethod = {
   .setNextCmdFp         = NULL
 };
 
+static HttpEncodeMethod restEncodeSqlColumnarMethod = {
+  .startJsonFp          = restStartSqlColumnar,
+  .stopJsonFp           = restStopSqlColumnar,
+  .buildQueryJsonFp     = restBuildSqlColumnar,
+  .buildAffectRowJsonFp = restBuildSqlAffectRowsColumnar,
+  .initJsonFp           = NULL,
+  .cleanJsonFp          = NULL,
+  .checkFinishedFp      = NULL,
+  .setNextCmdFp         = NULL
+};
+
 void restInitHandle(HttpServer* pServer) {
   httpAddMethod(pServer, &restDecodeMethod);
   httpAddMethod(pServer, &restDecodeMethod2);
@@ -135,6 +147,11 @@ bool restProcessSqlRequest(HttpContext* pContext, int32_t timestampFmt) {
     pContext->encodeMethod = &restEncodeSqlUtcTimeStringMethod;
   }
 
+  // timestamps are always sent as the integers in the columnar format
+  if (pContext->parser->acceptColumnar != HTTP_ACCEPT_JSON) {
+    pContext->encodeMethod = &restEncodeSqlColumnarMethod;
+  }
+
   return true;
 }
 
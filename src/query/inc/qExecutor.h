@@ -189,6 +189,8 @@ typedef struct SQueryCostInfo {
   uint32_t loadBlockStatis;
   uint32_t discardBlocks;
   uint64_t elapsedTime;
+  uint64_t cpuTime;
+  uint32_t numOfYields;
   uint64_t firstStageMergeTime;
   uint64_t winInfoSize;
   uint64_t tableInfoSize;
@@ -331,6 +333,9 @@ typedef struct SQueryRuntimeEnv {
   bool                  udfIsCopy;
   SHashObj             *pTablesRead;    // record child tables already read rows by tid hash
   int32_t              cntTableReadOver; // read table over count  
+  bool                  yieldable;       // the master scan can be paused between data blocks and resumed
+  bool                  yielded;         // the master scan is paused since the time slice is used up
+  int64_t               sliceEndUs;      // end of the time slice of current execution, 0 if not yieldable
 } SQueryRuntimeEnv;
 
 enum {
@@ -395,6 +400,23 @@ typedef struct {
   SColumnInfo *colList;
 } SQueriedTableInfo;
 
+// the result dumped into the retrieve rsp msg before the retrieve msg arrives
+typedef struct SQueryRsp {
+  SRetrieveTableRsp *pRsp;
+  int32_t            contLen;
+  struct SRpcIov    *pIov;
+  int32_t            numOfIov;
+  int64_t            size;       // bytes taken from the query buffer
+} SQueryRsp;
+
+typedef struct SQueryPrefetch {
+  SQueryRsp *pRsps;     // ring buffer of the results computed ahead
+  int32_t    capacity;  // 0 means no result is computed ahead
+  int32_t    head;
+  int32_t    num;
+  bool       last;      // the last result is in the buffer, and the query execution is over
+} SQueryPrefetch;
+
 typedef struct SQInfo {
   void*            signature;
   uint64_t         qId;
@@ -413,6 +435,7 @@ typedef struct SQInfo {
   int64_t          lastRetrieveTs; // last retrieve timestamp  
   char*            sql;         // query sql string
   SQueryCostInfo   summary;
+  SQueryPrefetch   prefetch;    // protected by lock
 } SQInfo;
 
 typedef struct SQueryParam {
@@ -707,6 +730,8 @@ int32_t buildScalarExprFromMsg(SExprInfo * pExprInfo, void *pQueryMsg);
 
 bool isQueryKilled(SQInfo *pQInfo);
 int32_t checkForQueryBuf(size_t numOfTables);
+bool acquireQueryBufBytes(int64_t size);
+void releaseQueryBufBytes(int64_t size);
 bool checkNeedToCompressQueryCol(SQInfo *pQInfo);
 bool doBuildResCheck(SQInfo* pQInfo);
 void setQueryStatus(SQueryRuntimeEnv *pRuntimeEnv, int8_t status);
@@ -717,6 +742,8 @@ void destroyUdfInfo(SUdfInfo* pUdfInfo);
 bool isValidQInfo(void *param);
 
 int32_t doDumpQueryResult(SQInfo *pQInfo, char *data, int8_t compressed, int32_t *compLen);
+bool    isQueryResultLast(SQInfo *pQInfo);
+int32_t doDumpQueryResultV(SQInfo *pQInfo, struct SRpcIov *pIov, int32_t *numOfIov);
 
 size_t getResultSize(SQInfo *pQInfo, int64_t *numOfRows);
 void setQueryKilled(SQInfo *pQInfo);
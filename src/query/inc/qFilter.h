@@ -23,6 +23,7 @@ extern "C" {
 #include "texpr.h"
 #include "hash.h"
 #include "tname.h"
+#include "troaring.h"
 
 #define FILTER_DEFAULT_GROUP_SIZE 4
 #define FILTER_DEFAULT_UNIT_SIZE 4
@@ -243,6 +244,8 @@ typedef struct SFilterInfo {
   SFilterPCtx       pctx;
 } SFilterInfo;
 
+typedef int32_t (*filer_get_unit_cand)(void *, SFilterInfo *, uint32_t, SRoaringBitmap **);
+
 #define FILTER_NO_MERGE_DATA_TYPE(t) ((t) == TSDB_DATA_TYPE_BINARY || (t) == TSDB_DATA_TYPE_NCHAR || (t) == TSDB_DATA_TYPE_JSON)
 #define FILTER_NO_MERGE_OPTR(o) ((o) == TSDB_RELATION_ISNULL || (o) == TSDB_RELATION_NOTNULL || (o) == FILTER_DUMMY_EMPTY_OPTR)
 
@@ -336,6 +339,8 @@ extern void filterFreeInfo(SFilterInfo *info);
 extern bool filterRangeExecute(SFilterInfo *info, SDataStatis *pDataStatis, int32_t numOfCols, int32_t numOfRows);
 extern int32_t filterIsIndexedColumnQuery(SFilterInfo* info, int32_t idxId, bool *res);
 extern int32_t filterGetIndexedColumnInfo(SFilterInfo* info, char** val, int32_t *order, int32_t *flag);
+extern bool filterExecuteUnit(SFilterInfo *info, uint32_t uidx, void *colData);
+extern int32_t filterGetIndexCandidates(SFilterInfo *info, void *param, filer_get_unit_cand fp, SRoaringBitmap **res);
 
 #ifdef __cplusplus
 }
@@ -896,6 +896,16 @@ static void function_finalizer(SQLFunctionCtx *pCtx) {
   doFinalizer(pCtx);
 }
 
+// the null value of a numeric type is a bit pattern, so the values are compared as the unsigned integer bt
+#define LIST_COUNT_N(ctx, p, bt, numOfElem, tsdbType)                               \
+  do {                                                                              \
+    bt *d = (bt *)(p);                                                              \
+    bt  _null = *(bt *)getNullValue(tsdbType);                                      \
+    for (int32_t i = 0; i < (ctx)->size; ++i) {                                     \
+      (numOfElem) += ((d)[i] != _null);                                             \
+    }                                                                               \
+  } while(0)
+
 /*
  * count function does need the finalize, if data is missing, the default value, which is 0, is used
  * count function does not use the pCtx->interResBuf to keep the intermediate buffer
@@ -912,13 +922,38 @@ static void count_function(SQLFunctionCtx *pCtx) {
     numOfElem = pCtx->size - pCtx->preAggVals.statis.numOfNull;
   } else {
     if (pCtx->hasNull) {
-      for (int32_t i = 0; i < pCtx->size; ++i) {
-        char *val = GET_INPUT_DATA(pCtx, i);
-        if (isNull(val, pCtx->inputType)) {
-          continue;
-        }
+      void *pData = GET_INPUT_DATA_LIST(pCtx);
+
+      switch (pCtx->inputType) {
+        case TSDB_DATA_TYPE_BOOL:
+        case TSDB_DATA_TYPE_TINYINT:
+        case TSDB_DATA_TYPE_UTINYINT:
+          LIST_COUNT_N(pCtx, pData, uint8_t, numOfElem, pCtx->inputType);
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+        case TSDB_DATA_TYPE_USMALLINT:
+          LIST_COUNT_N(pCtx, pData, uint16_t, numOfElem, pCtx->inputType);
+          break;
+        case TSDB_DATA_TYPE_INT:
+        case TSDB_DATA_TYPE_UINT:
+        case TSDB_DATA_TYPE_FLOAT:
+          LIST_COUNT_N(pCtx, pData, uint32_t, numOfElem, pCtx->inputType);
+          break;
+        case TSDB_DATA_TYPE_BIGINT:
+        case TSDB_DATA_TYPE_UBIGINT:
+        case TSDB_DATA_TYPE_TIMESTAMP:
+        case TSDB_DATA_TYPE_DOUBLE:
+          LIST_COUNT_N(pCtx, pData, uint64_t, numOfElem, pCtx->inputType);
+          break;
+        default:
+          for (int32_t i = 0; i < pCtx->size; ++i) {
+            char *val = GET_INPUT_DATA(pCtx, i);
+            if (isNull(val, pCtx->inputType)) {
+              continue;
+            }
 
-        numOfElem += 1;
+            numOfElem += 1;
+          }
       }
     } else {
       //when counting on the primary time stamp column and no statistics data is presented, use the size value directly.
@@ -963,39 +998,75 @@ int32_t countRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
 int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
   return BLK_DATA_NO_NEEDED;
 }
-#define LIST_ADD_N_DOUBLE_FLOAT(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , GET_DOUBLE_VAL(&(x)) + GET_FLOAT_VAL(&(d)[i]));                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
+/*
+ * The adding kernels below take the fast path without any null check if the block has no null value. Floating point
+ * values are accumulated in the original order to keep the result unchanged.
+ */
+#define LIST_ADD_N_DOUBLE_FLOAT(x, ctx, p, t, numOfElem, tsdbType)                  \
+  do {                                                                              \
+    t *d = (t *)(p);                                                                \
+    if (!(ctx)->hasNull) {                                                          \
+      double _sum = GET_DOUBLE_VAL(&(x));                                           \
+      for (int32_t i = 0; i < (ctx)->size; ++i) {                                   \
+        _sum += GET_FLOAT_VAL(&(d)[i]);                                             \
+      }                                                                             \
+      SET_DOUBLE_VAL(&(x), _sum);                                                   \
+      (numOfElem) += (ctx)->size;                                                   \
+      break;                                                                        \
+    }                                                                               \
+    for (int32_t i = 0; i < (ctx)->size; ++i) {                                     \
+      if (isNull((char *)&(d)[i], tsdbType)) {                                      \
+        continue;                                                                   \
+      };                                                                            \
+      SET_DOUBLE_VAL(&(x) , GET_DOUBLE_VAL(&(x)) + GET_FLOAT_VAL(&(d)[i]));         \
+      (numOfElem)++;                                                                \
+    }                                                                               \
   } while(0)
-#define LIST_ADD_N_DOUBLE(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , (x) + (d)[i]);                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
+#define LIST_ADD_N_DOUBLE(x, ctx, p, t, numOfElem, tsdbType)                        \
+  do {                                                                              \
+    t *d = (t *)(p);                                                                \
+    if (!(ctx)->hasNull) {                                                          \
+      double _sum = (x);                                                            \
+      for (int32_t i = 0; i < (ctx)->size; ++i) {                                   \
+        _sum += (d)[i];                                                             \
+      }                                                                             \
+      SET_DOUBLE_VAL(&(x), _sum);                                                   \
+      (numOfElem) += (ctx)->size;                                                   \
+      break;                                                                        \
+    }                                                                               \
+    for (int32_t i = 0; i < (ctx)->size; ++i) {                                     \
+      if (isNull((char *)&(d)[i], tsdbType)) {                                      \
+        continue;                                                                   \
+      };                                                                            \
+      SET_DOUBLE_VAL(&(x) , (x) + (d)[i]);                                          \
+      (numOfElem)++;                                                                \
+    }                                                                               \
   } while(0)
 
-#define LIST_ADD_N(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      (x) += (d)[i];                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
+/*
+ * Integers are summed up in a local accumulator of type st, which does not alias with the input and can be vectorized.
+ * The null values are masked out instead of being skipped by branches.
+ */
+#define LIST_ADD_N(x, ctx, p, t, st, numOfElem, tsdbType)                           \
+  do {                                                                              \
+    t      *d = (t *)(p);                                                           \
+    st      _sum = 0;                                                               \
+    int32_t _num = 0;                                                               \
+    if ((ctx)->hasNull) {                                                           \
+      t _null = *(t *)getNullValue(tsdbType);                                       \
+      for (int32_t i = 0; i < (ctx)->size; ++i) {                                   \
+        int32_t _notNull = ((d)[i] != _null);                                       \
+        _sum += _notNull ? (d)[i] : 0;                                              \
+        _num += _notNull;                                                           \
+      }                                                                             \
+    } else {                                                                        \
+      for (int32_t i = 0; i < (ctx)->size; ++i) {                                   \
+        _sum += (d)[i];                                                             \
+      }                                                                             \
+      _num = (ctx)->size;                                                           \
+    }                                                                               \
+    (x) += _sum;                                                                    \
+    (numOfElem) += _num;                                                            \
   } while(0)
 
 #define UPDATE_DATA(ctx, left, right, num, sign, k) \
@@ -1032,6 +1103,89 @@ int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
     LOOPCHECK_N(*_data, _list, ctx, tsdbType, sign, notNullElems);             \
   } while (0)
 
+/*
+ * Branch free min/max kernels for the blocks of which the result row is not needed by any tag column. The extreme value
+ * of the block is found first and then merged into the result, which ends up the same as the row by row comparison.
+ * A NaN breaks the total order, so the kernel returns -1 and leaves the block to the comparison loop.
+ * Otherwise the return value tells if the result is updated.
+ */
+#define DEFINE_MINMAX_KERNEL(name, t, bt, lowest, highest)                                   \
+  static int32_t name(SQLFunctionCtx *pCtx, const t *d, t *pOutput, int32_t isMin) {         \
+    bt      nullVal = *(bt *)getNullValue(pCtx->inputType);                                  \
+    int32_t hasNull = pCtx->hasNull;                                                         \
+    int32_t num = 0, nan = 0;                                                                \
+    t       ext = isMin ? (highest) : (lowest);                                              \
+                                                                                             \
+    if (isMin) {                                                                             \
+      for (int32_t i = 0; i < pCtx->size; ++i) {                                             \
+        t       v = d[i];                                                                    \
+        int32_t notNull = !hasNull || (*(bt *)&d[i] != nullVal);                             \
+        nan |= notNull & (v != v);                                                           \
+        v = notNull ? v : (highest);                                                         \
+        ext = (ext < v) ? ext : v;                                                           \
+        num += notNull;                                                                      \
+      }                                                                                      \
+    } else {                                                                                 \
+      for (int32_t i = 0; i < pCtx->size; ++i) {                                             \
+        t       v = d[i];                                                                    \
+        int32_t notNull = !hasNull || (*(bt *)&d[i] != nullVal);                             \
+        nan |= notNull & (v != v);                                                           \
+        v = notNull ? v : (lowest);                                                          \
+        ext = (ext < v) ? v : ext;                                                           \
+        num += notNull;                                                                      \
+      }                                                                                      \
+    }                                                                                        \
+                                                                                             \
+    if (nan) {                                                                               \
+      return -1;                                                                             \
+    }                                                                                        \
+                                                                                             \
+    if (num > 0 && ((*pOutput < ext) ^ isMin)) {                                             \
+      *pOutput = ext;                                                                        \
+      return 1;                                                                              \
+    }                                                                                        \
+                                                                                             \
+    return 0;                                                                                \
+  }
+
+DEFINE_MINMAX_KERNEL(minMaxTinyint, int8_t, uint8_t, INT8_MIN, INT8_MAX)
+DEFINE_MINMAX_KERNEL(minMaxSmallint, int16_t, uint16_t, INT16_MIN, INT16_MAX)
+DEFINE_MINMAX_KERNEL(minMaxInt, int32_t, uint32_t, INT32_MIN, INT32_MAX)
+DEFINE_MINMAX_KERNEL(minMaxBigint, int64_t, uint64_t, INT64_MIN, INT64_MAX)
+DEFINE_MINMAX_KERNEL(minMaxUTinyint, uint8_t, uint8_t, 0, UINT8_MAX)
+DEFINE_MINMAX_KERNEL(minMaxUSmallint, uint16_t, uint16_t, 0, UINT16_MAX)
+DEFINE_MINMAX_KERNEL(minMaxUInt, uint32_t, uint32_t, 0, UINT32_MAX)
+DEFINE_MINMAX_KERNEL(minMaxUBigint, uint64_t, uint64_t, 0, UINT64_MAX)
+DEFINE_MINMAX_KERNEL(minMaxFloat, float, uint32_t, -INFINITY, INFINITY)
+DEFINE_MINMAX_KERNEL(minMaxDouble, double, uint64_t, -INFINITY, INFINITY)
+
+static int32_t minMax_kernel(SQLFunctionCtx *pCtx, void *p, char *pOutput, int32_t isMin) {
+  switch (pCtx->inputType) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return minMaxTinyint(pCtx, p, (int8_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_SMALLINT:
+      return minMaxSmallint(pCtx, p, (int16_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_INT:
+      return minMaxInt(pCtx, p, (int32_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_BIGINT:
+      return minMaxBigint(pCtx, p, (int64_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_UTINYINT:
+      return minMaxUTinyint(pCtx, p, (uint8_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_USMALLINT:
+      return minMaxUSmallint(pCtx, p, (uint16_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_UINT:
+      return minMaxUInt(pCtx, p, (uint32_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_UBIGINT:
+      return minMaxUBigint(pCtx, p, (uint64_t *)pOutput, isMin);
+    case TSDB_DATA_TYPE_FLOAT:
+      return minMaxFloat(pCtx, p, (float *)pOutput, isMin);
+    case TSDB_DATA_TYPE_DOUBLE:
+      return minMaxDouble(pCtx, p, (double *)pOutput, isMin);
+    default:
+      return -1;
+  }
+}
+
 static void do_sum(SQLFunctionCtx *pCtx) {
   int32_t notNullElems = 0;
 
@@ -1058,25 +1212,25 @@ static void do_sum(SQLFunctionCtx *pCtx) {
       int64_t *retVal = (int64_t *)pCtx->pOutput;
 
       if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, int8_t, int64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, int16_t, int64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, int32_t, int64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, int64_t, int64_t, notNullElems, pCtx->inputType);
       }
     } else if (IS_UNSIGNED_NUMERIC_TYPE(pCtx->inputType)) {
       uint64_t *retVal = (uint64_t *)pCtx->pOutput;
 
       if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, uint8_t, uint64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, uint16_t, uint64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, uint32_t, uint64_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(*retVal, pCtx, pData, uint64_t, uint64_t, notNullElems, pCtx->inputType);
       }
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
       double *retVal = (double *)pCtx->pOutput;
@@ -1260,25 +1414,25 @@ static void avg_function(SQLFunctionCtx *pCtx) {
     void *pData = GET_INPUT_DATA_LIST(pCtx);
 
     if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, int8_t, int64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, int16_t, int64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, int32_t, int64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N_DOUBLE(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
       LIST_ADD_N_DOUBLE(*pVal, pCtx, pData, double, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
       LIST_ADD_N_DOUBLE_FLOAT(*pVal, pCtx, pData, float, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, uint8_t, uint64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, uint16_t, uint64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(*pVal, pCtx, pData, uint32_t, uint64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N_DOUBLE(*pVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
     }
   }
 
@@ -1457,6 +1611,14 @@ static void minMax_function(SQLFunctionCtx *pCtx, char *pOutput, int32_t isMin,
 
   *notNullElems = 0;
 
+  if (pCtx->tagInfo.numOfTagCols == 0) {
+    int32_t ret = minMax_kernel(pCtx, p, pOutput, isMin);
+    if (ret >= 0) {
+      *notNullElems = ret;
+      return;
+    }
+  }
+
   if (IS_SIGNED_NUMERIC_TYPE(pCtx->inputType)) {
     if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
       TYPED_LOOPCHECK_N(int8_t, pOutput, p, pCtx, pCtx->inputType, isMin, *notNullElems);
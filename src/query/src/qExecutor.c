@@ -33,6 +33,7 @@
 #include "cJSON.h"
 #include "tsdbMeta.h"
 #include "tscUtil.h"
+#include "tsched.h"
 
 #define IS_MASTER_SCAN(runtime)        ((runtime)->scanFlag == MASTER_SCAN)
 #define IS_REVERSE_SCAN(runtime)       ((runtime)->scanFlag == REVERSE_SCAN)
@@ -2101,6 +2102,31 @@ static void* destroySQLFunctionCtx(SQLFunctionCtx* pCtx, int32_t numOfOutput) {
   return NULL;
 }
 
+/*
+ * The execution is able to yield between the data blocks of the master scan, if the root operator is a blocking
+ * aggregate operator upon the table scan, since all the states of both are kept in their operator info.
+ */
+static bool isYieldableOperator(SOperatorInfo* pOperator) {
+  if (pOperator == NULL || pOperator->numOfUpstream != 1) {
+    return false;
+  }
+
+  int32_t upstreamType = pOperator->upstream[0]->operatorType;
+  if (upstreamType != OP_TableScan && upstreamType != OP_DataBlocksOptScan) {
+    return false;
+  }
+
+  switch (pOperator->operatorType) {
+    case OP_Aggregate:
+    case OP_MultiTableAggregate:
+    case OP_TimeWindow:
+    case OP_Groupby:
+      return true;
+    default:
+      return false;
+  }
+}
+
 static int32_t setupQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOfTables, SArray* pOperator, void* merger) {
   qDebug("QInfo:0x%"PRIx64" setup runtime env", GET_QID(pRuntimeEnv));
   SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
@@ -2383,6 +2409,7 @@ static int32_t setupQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOf
     }
   }
 
+  pRuntimeEnv->yieldable = isYieldableOperator(pRuntimeEnv->proot);
   return TSDB_CODE_SUCCESS;
 
 _clean:
@@ -4486,6 +4513,8 @@ static int32_t compressQueryColData(SColumnInfoData *pColRes, int32_t numOfRows,
                                                                  colSize + COMP_OVERFLOW_BYTES, compressed, NULL, 0);
 }
 
+static char* doCopyTableRetrieveTsToMsg(SQInfo *pQInfo, char *data);
+
 static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data, int8_t compressed, int32_t *compLen) {
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
   SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
@@ -4519,6 +4548,17 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data
     tfree(compSizes);
   }
 
+  doCopyTableRetrieveTsToMsg(pQInfo, data);
+
+  // Check if query is completed or not for stable query or normal table query respectively.
+  if (Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_COMPLETED) && pRuntimeEnv->proot->status == OP_EXEC_DONE) {
+    setQueryStatus(pRuntimeEnv, QUERY_OVER);
+  }
+}
+
+static char* doCopyTableRetrieveTsToMsg(SQInfo *pQInfo, char *data) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+
   int32_t numOfTables = (int32_t) taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap);
   *(int32_t*)data = htonl(numOfTables);
   data += sizeof(int32_t);
@@ -4540,11 +4580,7 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data
   }
 
   qDebug("QInfo:0x%"PRIx64" set %d subscribe info", pQInfo->qId, total);
-
-  // Check if query is completed or not for stable query or normal table query respectively.
-  if (Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_COMPLETED) && pRuntimeEnv->proot->status == OP_EXEC_DONE) {
-    setQueryStatus(pRuntimeEnv, QUERY_OVER);
-  }
+  return data;
 }
 
 int32_t doFillTimeIntervalGapsInResults(SFillInfo* pFillInfo, SSDataBlock *pOutput, int32_t capacity, void** p) {
@@ -4681,10 +4717,11 @@ void queryCostStatis(SQInfo *pQInfo) {
 
   calculateOperatorProfResults(pQInfo);
 
-  qDebug("QInfo:0x%"PRIx64" :cost summary: elapsed time:%"PRId64" us, first merge:%"PRId64" us, total blocks:%d, "
-         "load block statis:%d, load data block:%d, total rows:%"PRId64 ", check rows:%"PRId64,
-         pQInfo->qId, pSummary->elapsedTime, pSummary->firstStageMergeTime, pSummary->totalBlocks, pSummary->loadBlockStatis,
-         pSummary->loadBlocks, pSummary->totalRows, pSummary->totalCheckedRows);
+  qDebug("QInfo:0x%"PRIx64" :cost summary: elapsed time:%"PRId64" us, cpu time:%"PRId64" us, yields:%u, first merge:%"PRId64" us, "
+         "total blocks:%d, load block statis:%d, load data block:%d, total rows:%"PRId64 ", check rows:%"PRId64,
+         pQInfo->qId, pSummary->elapsedTime, pSummary->cpuTime, pSummary->numOfYields, pSummary->firstStageMergeTime,
+         pSummary->totalBlocks, pSummary->loadBlockStatis, pSummary->loadBlocks, pSummary->totalRows,
+         pSummary->totalCheckedRows);
 
   qDebug("QInfo:0x%"PRIx64" :cost summary: winResPool size:%.2f Kb, numOfWin:%"PRId64", tableInfoSize:%.2f Kb, hashTable:%.2f Kb", pQInfo->qId, pSummary->winInfoSize/1024.0,
       pSummary->numOfTimeWindows, pSummary->tableInfoSize/1024.0, pSummary->hashSize/1024.0);
@@ -5217,6 +5254,20 @@ static void notifyTableScan(void* param, int32_t option) {
   return;
 }
 
+// the time slice is checked before the next data block, and the scan is paused if it is used up
+static bool doYieldTableScan(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTableScanInfo) {
+  if (pRuntimeEnv->sliceEndUs == 0 || !IS_MASTER_SCAN(pRuntimeEnv) || pTableScanInfo->numOfBlocks == 0) {
+    return false;
+  }
+
+  if (taosGetTimestampUs() < pRuntimeEnv->sliceEndUs) {
+    return false;
+  }
+
+  pRuntimeEnv->yielded = true;
+  return true;
+}
+
 static SSDataBlock* doTableScanImpl(void* param, bool* newgroup) {
   SOperatorInfo    *pOperator = (SOperatorInfo*) param;
 
@@ -5228,7 +5279,7 @@ static SSDataBlock* doTableScanImpl(void* param, bool* newgroup) {
 
   *newgroup = false;
 
-  while (tsdbNextDataBlock(pTableScanInfo->pQueryHandle)) {
+  while (!doYieldTableScan(pRuntimeEnv, pTableScanInfo) && tsdbNextDataBlock(pTableScanInfo->pQueryHandle)) {
     if (isQueryKilled(pOperator->pRuntimeEnv->qinfo)) {
       longjmp(pOperator->pRuntimeEnv->env, TSDB_CODE_TSC_QUERY_CANCELLED);
     }
@@ -5286,7 +5337,7 @@ static SSDataBlock* doTableScan(void* param, bool *newgroup) {
 
   while (pTableScanInfo->current < pTableScanInfo->times) {
     SSDataBlock* p = doTableScanImpl(pOperator, newgroup);
-    if (p != NULL) {
+    if (p != NULL || pRuntimeEnv->yielded) {
       return p;
     }
 
@@ -6002,6 +6053,341 @@ static bool allCtxCompleted(SOperatorInfo* pOperator, SQLFunctionCtx* pCtx) {
   return true;
 }
 
+typedef struct SParallelScanSupporter {
+  SOperatorInfo *pOperator;
+  SArray        *pQueryHandles;  // one tsdb query handle for each sub window, SArray<TsdbQueryHandleT>
+  int32_t        nextWindow;
+  int32_t        code;
+  tsem_t         done;
+} SParallelScanSupporter;
+
+typedef struct SParallelScanWorker {
+  SParallelScanSupporter *pSup;
+  SQLFunctionCtx         *pCtx;  // the partial aggregate of all sub windows scanned by this worker
+  uint32_t                totalBlocks;
+  uint32_t                loadBlocks;
+  uint32_t                loadBlockStatis;
+  uint64_t                totalRows;
+} SParallelScanWorker;
+
+static void* queryScanQhandle = NULL;
+
+int32_t qInitQueryScanPool() {
+  if (tsQueryScanThreads <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the query thread works as one of the scan threads
+  queryScanQhandle = taosInitScheduler(1024, tsQueryScanThreads - 1, "qscan");
+  if (queryScanQhandle == NULL) {
+    qError("failed to init query scan pool, threads:%d", tsQueryScanThreads - 1);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  qInfo("query scan pool is initialized, threads:%d", tsQueryScanThreads - 1);
+  return TSDB_CODE_SUCCESS;
+}
+
+void qCleanupQueryScanPool() {
+  if (queryScanQhandle != NULL) {
+    taosCleanUpScheduler(queryScanQhandle);
+    queryScanQhandle = NULL;
+  }
+}
+
+/*
+ * The file sets of a simple aggregate query on a normal table can be scanned by several threads, if only the
+ * distributive functions, of which the partial results are able to be merged by the _func_merge routines, are
+ * involved in the query. The super table query is not supported, since its vnode result must be kept in the
+ * intermediate format, which is not the output of the _func_merge routines.
+ */
+static bool isParallelScanAggregate(SOperatorInfo* pOperator) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQueryAttr*       pQueryAttr = pRuntimeEnv->pQueryAttr;
+
+  if (queryScanQhandle == NULL || pOperator->numOfUpstream != 1 ||
+      pOperator->upstream[0]->operatorType != OP_TableScan) {
+    return false;
+  }
+
+  // the scan has been started in a previous time slice
+  STableScanInfo* pScanInfo = pOperator->upstream[0]->info;
+  if (pScanInfo->times != 1 || pScanInfo->reverseTimes != 0 || pScanInfo->numOfBlocks > 0) {
+    return false;
+  }
+
+  if (!pQueryAttr->simpleAgg || pQueryAttr->stableQuery || !QUERY_IS_ASC_QUERY(pQueryAttr) ||
+      pQueryAttr->numOfFilterCols > 0 || pQueryAttr->pFilters != NULL || pRuntimeEnv->pTsBuf != NULL ||
+      pQueryAttr->tableGroupInfo.numOfTables != 1 || pRuntimeEnv->tableqinfoGroupInfo.numOfTables != 1) {
+    return false;
+  }
+
+  SQLFunctionCtx* pCtx = ((SAggOperatorInfo*)pOperator->info)->binfo.pCtx;
+  for (int32_t i = 0; i < pOperator->numOfOutput; ++i) {
+    int32_t    functionId = pCtx[i].functionId;
+    SColIndex* pColIndex = &pOperator->pExpr[i].base.colInfo;
+
+    if (functionId != TSDB_FUNC_COUNT && functionId != TSDB_FUNC_SUM && functionId != TSDB_FUNC_AVG &&
+        functionId != TSDB_FUNC_MIN && functionId != TSDB_FUNC_MAX) {
+      return false;
+    }
+
+    if (!TSDB_COL_IS_NORMAL_COL(pColIndex->flag) || TSDB_COL_IS_TSWIN_COL(pColIndex->colId) || pColIndex->colIndex < 0 ||
+        pCtx[i].tagInfo.numOfTagCols > 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void destroyParallelScanCtx(SQLFunctionCtx* pCtx, int32_t numOfOutput) {
+  if (pCtx == NULL) {
+    return;
+  }
+
+  // the parameters are shallow copies of those in the operator context, and are destroyed along with it
+  for (int32_t i = 0; i < numOfOutput; ++i) {
+    tfree(pCtx[i].resultInfo);
+    tfree(pCtx[i].pOutput);
+  }
+
+  tfree(pCtx);
+}
+
+// the partial results are kept in the intermediate format of the super table query, as the merge functions expect
+static SQLFunctionCtx* createParallelScanCtx(SQLFunctionCtx* pSrcCtx, int32_t numOfOutput) {
+  SQLFunctionCtx* pCtx = calloc(numOfOutput, sizeof(SQLFunctionCtx));
+  if (pCtx == NULL) {
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < numOfOutput; ++i) {
+    int16_t type = 0;
+    int32_t bytes = 0, interBytes = 0;
+
+    pCtx[i] = pSrcCtx[i];
+    getResultDataInfo(pSrcCtx[i].inputType, pSrcCtx[i].inputBytes, pSrcCtx[i].functionId, 0, &type, &bytes,
+                      &interBytes, 0, true, NULL);
+
+    pCtx[i].outputType    = type;
+    pCtx[i].outputBytes   = bytes;
+    pCtx[i].interBufBytes = interBytes;
+    pCtx[i].stableQuery   = true;
+    pCtx[i].currentStage  = MASTER_SCAN;
+    pCtx[i].resultInfo    = calloc(1, sizeof(SResultRowCellInfo) + interBytes);
+    pCtx[i].pOutput       = calloc(1, bytes);
+
+    if (pCtx[i].resultInfo == NULL || pCtx[i].pOutput == NULL) {
+      destroyParallelScanCtx(pCtx, i + 1);
+      return NULL;
+    }
+
+    aAggs[pCtx[i].functionId].init(&pCtx[i], pCtx[i].resultInfo);
+  }
+
+  return pCtx;
+}
+
+static void doParallelScanAggregateImpl(SParallelScanWorker* pWorker) {
+  SParallelScanSupporter* pSup = pWorker->pSup;
+  SOperatorInfo*          pOperator = pSup->pOperator;
+  SQueryRuntimeEnv*       pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQLFunctionCtx*         pCtx = pWorker->pCtx;
+
+  int32_t     numOfWindows = (int32_t)taosArrayGetSize(pSup->pQueryHandles);
+  SSDataBlock block = {0};
+
+  while (atomic_load_32(&pSup->code) == TSDB_CODE_SUCCESS) {
+    int32_t index = atomic_fetch_add_32(&pSup->nextWindow, 1);
+    if (index >= numOfWindows) {
+      break;
+    }
+
+    TsdbQueryHandleT pQueryHandle = taosArrayGetP(pSup->pQueryHandles, index);
+    while (tsdbNextDataBlock(pQueryHandle)) {
+      if (isQueryKilled(pRuntimeEnv->qinfo)) {
+        atomic_val_compare_exchange_32(&pSup->code, TSDB_CODE_SUCCESS, TSDB_CODE_TSC_QUERY_CANCELLED);
+        return;
+      }
+
+      tsdbRetrieveDataBlockInfo(pQueryHandle, &block.info);
+      block.pBlockStatis = NULL;
+      block.pDataBlock   = NULL;
+
+      pWorker->totalBlocks += 1;
+      pWorker->totalRows += block.info.rows;
+
+      uint32_t status = BLK_DATA_NO_NEEDED;
+      for (int32_t i = 0; i < pOperator->numOfOutput; ++i) {
+        status |= aAggs[pCtx[i].functionId].dataReqFunc(&pCtx[i], &block.info.window, pCtx[i].colId);
+      }
+
+      if (status != BLK_DATA_NO_NEEDED) {
+        pWorker->loadBlockStatis += 1;
+        tsdbRetrieveDataBlockStatisInfo(pQueryHandle, &block.pBlockStatis);
+
+        if (status == BLK_DATA_ALL_NEEDED || block.pBlockStatis == NULL) {
+          pWorker->loadBlocks += 1;
+          block.pDataBlock = tsdbRetrieveDataBlock(pQueryHandle, NULL);
+          if (block.pDataBlock == NULL) {
+            atomic_val_compare_exchange_32(&pSup->code, TSDB_CODE_SUCCESS, terrno);
+            return;
+          }
+        }
+      }
+
+      for (int32_t i = 0; i < pOperator->numOfOutput; ++i) {
+        SColIndex* pColIndex = &pOperator->pExpr[i].base.colInfo;
+
+        pCtx[i].size    = block.info.rows;
+        pCtx[i].startTs = pRuntimeEnv->pQueryAttr->window.skey;
+        setBlockStatisInfo(&pCtx[i], &block, pColIndex);
+
+        if (block.pDataBlock != NULL) {
+          SColumnInfoData* pColInfo = taosArrayGet(block.pDataBlock, pColIndex->colIndex);
+          pCtx[i].pInput = pColInfo->pData;
+        }
+
+        aAggs[pCtx[i].functionId].xFunction(&pCtx[i]);
+      }
+    }
+  }
+}
+
+static void doParallelScanAggregateTask(SSchedMsg* pMsg) {
+  SParallelScanWorker* pWorker = pMsg->ahandle;
+
+  doParallelScanAggregateImpl(pWorker);
+  tsem_post(&pWorker->pSup->done);
+}
+
+// merge the partial result of each worker into the operator output buffer, and generate the final result
+static void doMergeParallelScanResult(SOperatorInfo* pOperator, SParallelScanWorker* pWorkers, int32_t numOfWorkers) {
+  SQLFunctionCtx* pCtx = ((SAggOperatorInfo*)pOperator->info)->binfo.pCtx;
+
+  for (int32_t i = 0; i < pOperator->numOfOutput; ++i) {
+    SQLFunctionCtx ctx = pCtx[i];
+
+    pCtx[i].currentStage = MERGE_STAGE;
+    pCtx[i].inputType    = TSDB_DATA_TYPE_BINARY;
+    pCtx[i].stableQuery  = true;
+    pCtx[i].hasNull      = false;
+    pCtx[i].size         = 1;
+    pCtx[i].preAggVals.isSet = false;
+
+    for (int32_t j = 0; j < numOfWorkers; ++j) {
+      SQLFunctionCtx* pPartial = &pWorkers[j].pCtx[i];
+      if (GET_RES_INFO(pPartial)->numOfRes <= 0) {  // no qualified data in all sub windows of this worker
+        continue;
+      }
+
+      pCtx[i].inputBytes = pPartial->outputBytes;
+      pCtx[i].pInput     = pPartial->pOutput;
+      aAggs[pCtx[i].functionId].mergeFunc(&pCtx[i]);
+    }
+
+    aAggs[pCtx[i].functionId].xFinalize(&pCtx[i]);
+
+    // the result cell and output buffer are not changed, restore the context for the normal table query
+    pCtx[i] = ctx;
+  }
+}
+
+static bool doParallelScanAggregate(SOperatorInfo* pOperator) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQueryAttr*       pQueryAttr = pRuntimeEnv->pQueryAttr;
+  SQInfo*           pQInfo = pRuntimeEnv->qinfo;
+  SQLFunctionCtx*   pCtx = ((SAggOperatorInfo*)pOperator->info)->binfo.pCtx;
+
+  SArray* pWindows = tsdbGetFileSetWindows(pQueryAttr->tsdb, &pQueryAttr->window);
+  if (pWindows == NULL || taosArrayGetSize(pWindows) <= 1) {
+    taosArrayDestroy(&pWindows);
+    return false;
+  }
+
+  int32_t numOfWindows = (int32_t)taosArrayGetSize(pWindows);
+  int32_t numOfWorkers = MIN(tsQueryScanThreads, numOfWindows);
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  SParallelScanSupporter sup = {.pOperator = pOperator};
+  sup.pQueryHandles = taosArrayInit(numOfWindows, POINTER_BYTES);
+  SParallelScanWorker* pWorkers = calloc(numOfWorkers, sizeof(SParallelScanWorker));
+  if (sup.pQueryHandles == NULL || pWorkers == NULL) {
+    code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  // the query handles share the mem table snapshot of the query, and must be created in current thread
+  for (int32_t i = 0; i < numOfWindows; ++i) {
+    STsdbQueryCond   cond = createTsdbQueryCond(pQueryAttr, taosArrayGet(pWindows, i));
+    TsdbQueryHandleT pQueryHandle =
+        tsdbQueryTables(pQueryAttr->tsdb, &cond, &pQueryAttr->tableGroupInfo, pQInfo->qId, &pQueryAttr->memRef);
+    if (pQueryHandle == NULL) {
+      code = terrno;
+      goto _end;
+    }
+
+    taosArrayPush(sup.pQueryHandles, &pQueryHandle);
+  }
+
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    pWorkers[i].pSup = &sup;
+    if ((pWorkers[i].pCtx = createParallelScanCtx(pCtx, pOperator->numOfOutput)) == NULL) {
+      code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
+
+  qDebug("QInfo:0x%" PRIx64 " scan %d sub windows with %d threads", pQInfo->qId, numOfWindows, numOfWorkers);
+
+  tsem_init(&sup.done, 0, 0);
+  for (int32_t i = 1; i < numOfWorkers; ++i) {
+    SSchedMsg schedMsg = {0};
+    schedMsg.fp      = doParallelScanAggregateTask;
+    schedMsg.ahandle = &pWorkers[i];
+    taosScheduleTask(queryScanQhandle, &schedMsg);
+  }
+
+  // current thread works as the first worker, and then waits for the others
+  doParallelScanAggregateImpl(&pWorkers[0]);
+  for (int32_t i = 1; i < numOfWorkers; ++i) {
+    tsem_wait(&sup.done);
+  }
+  tsem_destroy(&sup.done);
+
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    pQInfo->summary.totalBlocks += pWorkers[i].totalBlocks;
+    pQInfo->summary.loadBlocks += pWorkers[i].loadBlocks;
+    pQInfo->summary.loadBlockStatis += pWorkers[i].loadBlockStatis;
+    pQInfo->summary.totalRows += pWorkers[i].totalRows;
+  }
+
+  code = sup.code;
+  if (code == TSDB_CODE_SUCCESS) {
+    doMergeParallelScanResult(pOperator, pWorkers, numOfWorkers);
+  }
+
+_end:
+  for (int32_t i = 0; sup.pQueryHandles != NULL && i < taosArrayGetSize(sup.pQueryHandles); ++i) {
+    tsdbCleanupQueryHandle(taosArrayGetP(sup.pQueryHandles, i));
+  }
+
+  for (int32_t i = 0; pWorkers != NULL && i < numOfWorkers; ++i) {
+    destroyParallelScanCtx(pWorkers[i].pCtx, pOperator->numOfOutput);
+  }
+
+  taosArrayDestroy(&sup.pQueryHandles);
+  taosArrayDestroy(&pWindows);
+  tfree(pWorkers);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, code);
+  }
+
+  return true;
+}
+
 // this is a blocking operator
 static SSDataBlock* doAggregate(void* param, bool* newgroup) {
   SOperatorInfo* pOperator = (SOperatorInfo*) param;
@@ -6019,6 +6405,12 @@ static SSDataBlock* doAggregate(void* param, bool* newgroup) {
 
   SOperatorInfo* upstream = pOperator->upstream[0];
 
+  if (isParallelScanAggregate(pOperator) && doParallelScanAggregate(pOperator)) {
+    doSetOperatorCompleted(pOperator);
+    pInfo->pRes->info.rows = getNumOfResult(pRuntimeEnv, pInfo->pCtx, pOperator->numOfOutput);
+    return pInfo->pRes;
+  }
+
   while(1) {
     publishOperatorProfEvent(upstream, QUERY_PROF_BEFORE_OPERATOR_EXEC);
     SSDataBlock* pBlock = upstream->exec(upstream, newgroup);
@@ -6045,6 +6437,11 @@ static SSDataBlock* doAggregate(void* param, bool* newgroup) {
       break;
   }
 
+  // the master scan is paused by the time slice, and resumed from here in the next execution
+  if (pRuntimeEnv->yielded) {
+    return NULL;
+  }
+
   doSetOperatorCompleted(pOperator);
 
   finalizeQueryResult(pOperator, pInfo->pCtx, &pInfo->resultRowInfo, pInfo->rowCellInfoOffset);
@@ -6111,6 +6508,11 @@ static SSDataBlock* doSTableAggregate(void* param, bool* newgroup) {
     doAggregateImpl(pOperator, pQueryAttr->window.skey, pInfo->pCtx, pBlock);
   }
 
+  // the master scan is paused by the time slice, and resumed from here in the next execution
+  if (pRuntimeEnv->yielded) {
+    return NULL;
+  }
+
   pOperator->status = OP_RES_TO_RETURN;
   closeAllResultRows(&pInfo->resultRowInfo);
 
@@ -6399,6 +6801,11 @@ static SSDataBlock* doIntervalAgg(void* param, bool* newgroup) {
   pQueryAttr->order.order = order;
   pQueryAttr->window = win;
 
+  // the master scan is paused by the time slice, and resumed from here in the next execution
+  if (pRuntimeEnv->yielded) {
+    return NULL;
+  }
+
   pOperator->status = OP_RES_TO_RETURN;
   if (pIntervalInfo->resultRowInfo.size > 0 && pQueryAttr->needSort) {
     qsort(pIntervalInfo->resultRowInfo.pResult, pIntervalInfo->resultRowInfo.size, POINTER_BYTES, resRowCompare);
@@ -7199,6 +7606,11 @@ static SSDataBlock* hashGroupbyAggregate(void* param, bool* newgroup) {
     doHashGroupbyAgg(pOperator, pInfo, pBlock);
   }
 
+  // the master scan is paused by the time slice, and resumed from here in the next execution
+  if (pRuntimeEnv->yielded) {
+    return NULL;
+  }
+
   pOperator->status = OP_RES_TO_RETURN;
   closeAllResultRows(&pInfo->binfo.resultRowInfo);
   setQueryStatus(pRuntimeEnv, QUERY_COMPLETED);
@@ -9981,6 +10393,23 @@ void* freeColumnInfo(SColumnInfo* pColumnInfo, int32_t numOfCols) {
   return NULL;
 }
 
+// the results computed ahead but never retrieved are discarded
+static void destroyQueryPrefetch(SQueryPrefetch *pPrefetch) {
+  for (int32_t i = 0; i < pPrefetch->num; ++i) {
+    SQueryRsp *pRsp = &pPrefetch->pRsps[(pPrefetch->head + i) % pPrefetch->capacity];
+    for (int32_t j = 0; j < pRsp->numOfIov; ++j) {
+      free(pRsp->pIov[j].pCont);
+    }
+
+    tfree(pRsp->pIov);
+    rpcFreeCont(pRsp->pRsp);
+    releaseQueryBufBytes(pRsp->size);
+  }
+
+  pPrefetch->num = 0;
+  tfree(pPrefetch->pRsps);
+}
+
 void freeQInfo(SQInfo *pQInfo) {
   if (!isValidQInfo(pQInfo)) {
     return;
@@ -9990,6 +10419,7 @@ void freeQInfo(SQInfo *pQInfo) {
 
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
   releaseQueryBuf(pRuntimeEnv->tableqinfoGroupInfo.numOfTables);
+  destroyQueryPrefetch(&pQInfo->prefetch);
 
   doDestroyTableQueryInfo(&pRuntimeEnv->tableqinfoGroupInfo);
   teardownQueryRuntimeEnv(&pQInfo->runtimeEnv);
@@ -10070,6 +10500,61 @@ int32_t doDumpQueryResult(SQInfo *pQInfo, char *data, int8_t compressed, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
+// no more result is generated after the current one, so that the result columns can be handed over to the message
+bool isQueryResultLast(SQInfo *pQInfo) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
+
+  if (pQueryAttr->tsCompQuery || pRuntimeEnv->outputBuf == NULL || pRuntimeEnv->proot == NULL) {
+    return false;
+  }
+
+  if (pQueryAttr->limit.limit > 0 && pQueryAttr->limit.limit == pRuntimeEnv->resultInfo.total) {
+    return true;
+  }
+
+  return (Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_COMPLETED) || Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_OVER)) &&
+         pRuntimeEnv->proot->status == OP_EXEC_DONE;
+}
+
+/*
+ * The columns of the last result are taken by the message without copy, and the column buffers of the output are
+ * left empty, which are never written again. The subscribe info follows the columns as the last segment.
+ */
+int32_t doDumpQueryResultV(SQInfo *pQInfo, SRpcIov *pIov, int32_t *numOfIov) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
+  SSDataBlock* pRes = pRuntimeEnv->outputBuf;
+
+  int32_t numOfRows = pRes->info.rows;
+  int32_t numOfCols = pQueryAttr->pExpr2 ? pQueryAttr->numOfExpr2 : pQueryAttr->numOfOutput;
+  int32_t tailLen = (int32_t)(sizeof(int32_t) + sizeof(STableIdInfo) * taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap) +
+                             sizeof(int64_t));  // the cpu time is set by the caller
+
+  char* tail = malloc(tailLen);
+  if (tail == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColRes = taosArrayGet(pRes->pDataBlock, col);
+    pIov[col].pCont = pColRes->pData;
+    pIov[col].contLen = pColRes->info.bytes * numOfRows;
+    pColRes->pData = NULL;
+  }
+
+  doCopyTableRetrieveTsToMsg(pQInfo, tail);
+  pIov[numOfCols].pCont = tail;
+  pIov[numOfCols].contLen = tailLen;
+  *numOfIov = numOfCols + 1;
+
+  qDebug("QInfo:0x%"PRIx64" current numOfRes rows:%d, total:%" PRId64 ", dumped without copy", pQInfo->qId,
+         numOfRows, pRuntimeEnv->resultInfo.total);
+
+  setQueryStatus(pRuntimeEnv, QUERY_OVER);
+  return TSDB_CODE_SUCCESS;
+}
+
 bool doBuildResCheck(SQInfo* pQInfo) {
   bool buildRes = false;
 
@@ -10123,27 +10608,40 @@ static int64_t getQuerySupportBufSize(size_t numOfTables) {
   return (int64_t)((s1 + s2) * 1.5 * numOfTables);
 }
 
-int32_t checkForQueryBuf(size_t numOfTables) {
-  int64_t t = getQuerySupportBufSize(numOfTables);
+// take the bytes from the query buffer of the dnode, which is disabled if its size is zero
+bool acquireQueryBufBytes(int64_t size) {
   if (tsQueryBufferSizeBytes < 0) {
-    return TSDB_CODE_SUCCESS;
+    return true;
   } else if (tsQueryBufferSizeBytes > 0) {
 
     while(1) {
       int64_t s = tsQueryBufferSizeBytes;
-      int64_t remain = s - t;
+      int64_t remain = s - size;
       if (remain >= 0) {
         if (atomic_val_compare_exchange_64(&tsQueryBufferSizeBytes, s, remain) == s) {
-          return TSDB_CODE_SUCCESS;
+          return true;
         }
       } else {
-        return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+        return false;
       }
     }
   }
 
-  // disable query processing if the value of tsQueryBufferSize is zero.
-  return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+  return false;
+}
+
+void releaseQueryBufBytes(int64_t size) {
+  if (tsQueryBufferSizeBytes < 0) {
+    return;
+  }
+
+  // restore value is not enough buffer available
+  atomic_add_fetch_64(&tsQueryBufferSizeBytes, size);
+}
+
+int32_t checkForQueryBuf(size_t numOfTables) {
+  int64_t t = getQuerySupportBufSize(numOfTables);
+  return acquireQueryBufBytes(t) ? TSDB_CODE_SUCCESS : TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
 }
 
 bool checkNeedToCompressQueryCol(SQInfo *pQInfo) {
@@ -10171,14 +10669,7 @@ bool checkNeedToCompressQueryCol(SQInfo *pQInfo) {
 }
 
 void releaseQueryBuf(size_t numOfTables) {
-  if (tsQueryBufferSizeBytes < 0) {
-    return;
-  }
-
-  int64_t t = getQuerySupportBufSize(numOfTables);
-
-  // restore value is not enough buffer available
-  atomic_add_fetch_64(&tsQueryBufferSizeBytes, t);
+  releaseQueryBufBytes(getQuerySupportBufSize(numOfTables));
 }
 
 void freeQueryAttr(SQueryAttr* pQueryAttr) {
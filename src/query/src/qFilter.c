@@ -3156,6 +3156,38 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, int8_t** p, SDataStat
   return all;
 }
 
+static FORCE_INLINE void filterDoUnitExecute(SFilterComUnit *cunit, void *colData, int8_t *res) {
+  uint8_t optr = cunit->optr;
+
+  if (colData == NULL || isNull(colData, cunit->dataType)) {
+    *res = optr == TSDB_RELATION_ISNULL ? true : false;
+  } else {
+    if (optr == TSDB_RELATION_NOTNULL) {
+      *res = 1;
+    } else if (optr == TSDB_RELATION_ISNULL) {
+      *res = 0;
+    } else if (cunit->rfunc >= 0) {
+      *res = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+    } else {
+      if(cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH)){
+        char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+        int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+        if (len < 0){
+          qError("castConvert1 taosUcs4ToMbs error");
+        }else{
+          varDataSetLen(newColData, len);
+          *res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
+        }
+        tfree(newColData);
+      }else if(cunit->dataType == TSDB_DATA_TYPE_JSON){
+        doJsonCompare(cunit, res, colData);
+      }else{
+        *res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
+      }
+    }
+  }
+}
+
 bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -3181,38 +3213,9 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *
         //if (FILTER_UNIT_GET_F(info, uidx)) {
         //  p[i] = FILTER_UNIT_GET_R(info, uidx);
         //} else {
-          uint8_t optr = cunit->optr;
-
-          if (colData == NULL || isNull(colData, cunit->dataType)) {
-            (*p)[i] = optr == TSDB_RELATION_ISNULL ? true : false;
-          } else {
-            if (optr == TSDB_RELATION_NOTNULL) {
-              (*p)[i] = 1;
-            } else if (optr == TSDB_RELATION_ISNULL) {
-              (*p)[i] = 0;
-            } else if (cunit->rfunc >= 0) {
-              (*p)[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
-            } else {
-              if(cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH)){
-                char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-                int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-                if (len < 0){
-                  qError("castConvert1 taosUcs4ToMbs error");
-                }else{
-                  varDataSetLen(newColData, len);
-                  (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-                }
-                tfree(newColData);
-              }else if(cunit->dataType == TSDB_DATA_TYPE_JSON){
-                doJsonCompare(cunit, &(*p)[i], colData);
-              }else{
-                (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
-              }
-            }
-          
+          filterDoUnitExecute(cunit, colData, &(*p)[i]);
           //FILTER_UNIT_SET_R(info, uidx, p[i]);
           //FILTER_UNIT_SET_F(info, uidx);
-          }
 
         if ((*p)[i] == 0) {
           break;
@@ -3672,6 +3675,92 @@ _return:
 }
 
 
+bool filterExecuteUnit(SFilterInfo *info, uint32_t uidx, void *colData) {
+  int8_t res = 0;
+
+  filterDoUnitExecute(&info->cunits[uidx], colData, &res);
+
+  return res;
+}
+
+/*
+ * Narrow down the rows the filter may match by the column indexes of the caller. fp returns the bitmap of the
+ * candidate rows of one unit, or NULL if the unit can not be answered by an index. The bitmaps of the units in a
+ * group are intersected and those of the groups are unioned, so the result is a superset of the matched rows which
+ * still needs filterExecute. *res is NULL if any group has no indexed unit, and all rows must be checked then.
+ */
+int32_t filterGetIndexCandidates(SFilterInfo *info, void *param, filer_get_unit_cand fp, SRoaringBitmap **res) {
+  SRoaringBitmap *result = NULL;
+  int32_t         code = TSDB_CODE_SUCCESS;
+
+  *res = NULL;
+
+  if (info == NULL || info->groupNum == 0 || FILTER_ALL_RES(info) || FILTER_EMPTY_RES(info)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup   *group = &info->groups[g];
+    SRoaringBitmap *gcand = NULL;
+
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      SRoaringBitmap *ucand = NULL;
+      code = fp(param, info, group->unitIdxs[u], &ucand);
+      if (code != TSDB_CODE_SUCCESS) {
+        tRoaringDestroy(gcand);
+        goto _return;
+      }
+
+      if (ucand == NULL) {
+        continue;
+      }
+
+      if (gcand == NULL) {
+        gcand = ucand;
+      } else {
+        SRoaringBitmap *t = tRoaringAnd(gcand, ucand);
+        tRoaringDestroy(gcand);
+        tRoaringDestroy(ucand);
+        gcand = t;
+        if (gcand == NULL) {
+          code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+          goto _return;
+        }
+      }
+
+      if (tRoaringCardinality(gcand) == 0) {
+        break;
+      }
+    }
+
+    if (gcand == NULL) {
+      tRoaringDestroy(result);
+      return TSDB_CODE_SUCCESS;
+    }
+
+    if (result == NULL) {
+      result = gcand;
+    } else {
+      SRoaringBitmap *t = tRoaringOr(result, gcand);
+      tRoaringDestroy(result);
+      tRoaringDestroy(gcand);
+      result = t;
+      if (result == NULL) {
+        code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+        goto _return;
+      }
+    }
+  }
+
+  *res = result;
+
+  return TSDB_CODE_SUCCESS;
+
+_return:
+  tRoaringDestroy(result);
+  return code;
+}
+
 int32_t filterGetIndexedColumnInfo(SFilterInfo* info, char** val, int32_t *order, int32_t *flag) {
   SFilterComUnit *cunit = info->cunits;
   uint8_t optr = cunit->optr;
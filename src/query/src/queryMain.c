@@ -196,6 +196,15 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qi
 
   code = initQInfo(&pQueryMsg->tsBuf, tsdb, NULL, *pQInfo, &param, (char*)pQueryMsg, pQueryMsg->prevResultLen, NULL);
 
+  // in the retrieve blocking model, the retrieve thread waits for the result of the execution it starts
+  if (code == TSDB_CODE_SUCCESS && tsQueryPrefetchBlocks > 0 && !tsRetrieveBlockingModel) {
+    SQueryPrefetch* pPrefetch = &((SQInfo*)(*pQInfo))->prefetch;
+    pPrefetch->pRsps = calloc(tsQueryPrefetchBlocks, sizeof(SQueryRsp));
+    if (pPrefetch->pRsps != NULL) {
+      pPrefetch->capacity = tsQueryPrefetchBlocks;
+    }
+  }
+
   _over:
   if (param.pGroupbyExpr != NULL) {
     taosArrayDestroy(&(param.pGroupbyExpr->columnInfo));
@@ -225,11 +234,159 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qi
   return code;
 }
 
-bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
+// dump the current result of the query into the retrieve rsp msg
+static int32_t doBuildRetrieveRsp(SQInfo *pQInfo, SQueryRsp *pQRsp) {
+  SQueryAttr *pQueryAttr = pQInfo->runtimeEnv.pQueryAttr;
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  int32_t compLen = 0;
+
+  int32_t s = GET_NUM_OF_RESULTS(pRuntimeEnv);
+  int8_t  compressed = (int8_t)((tsCompressColData != -1) && checkNeedToCompressQueryCol(pQInfo));
+
+  // the last result is sent from the output columns, which are not touched by the following execution
+  if (s > 0 && pQInfo->code == TSDB_CODE_SUCCESS && !compressed && isQueryResultLast(pQInfo)) {
+    int32_t numOfCols = pQueryAttr->pExpr2 ? pQueryAttr->numOfExpr2 : pQueryAttr->numOfOutput;
+    pQRsp->pIov = calloc(numOfCols + 1, sizeof(SRpcIov));
+  }
+
+  size_t size = 0;
+  if (pQRsp->pIov == NULL) {
+    size = pQueryAttr->resultRowSize * s;
+    size += sizeof(int32_t);
+    size += sizeof(STableIdInfo) * taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap);
+    size += sizeof(int64_t);
+  }
+
+  pQRsp->contLen = (int32_t)(size + sizeof(SRetrieveTableRsp));
+
+  // current solution only avoid crash, but cannot return error code to client
+  SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)rpcMallocCont(pQRsp->contLen);
+  if (pRsp == NULL) {
+    tfree(pQRsp->pIov);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  pRsp->numOfRows = htonl((int32_t)s);
+
+  if (pQInfo->code == TSDB_CODE_SUCCESS) {
+    pRsp->offset   = htobe64(pQInfo->runtimeEnv.currentOffset);
+    pRsp->useconds = htobe64(pQInfo->summary.elapsedTime);
+  } else {
+    pRsp->offset   = 0;
+    pRsp->useconds = htobe64(pQInfo->summary.elapsedTime);
+  }
+
+  pRsp->precision = htons(pQueryAttr->precision);
+  pRsp->compressed = compressed;
+
+  if (pQRsp->pIov != NULL) {
+    if (doDumpQueryResultV(pQInfo, pQRsp->pIov, &pQRsp->numOfIov) != TSDB_CODE_SUCCESS) {
+      tfree(pQRsp->pIov);
+      rpcFreeCont(pRsp);
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+  } else if (GET_NUM_OF_RESULTS(&(pQInfo->runtimeEnv)) > 0 && pQInfo->code == TSDB_CODE_SUCCESS) {
+    doDumpQueryResult(pQInfo, pRsp->data, pRsp->compressed, &compLen);
+  } else {
+    setQueryStatus(pRuntimeEnv, QUERY_OVER);
+  }
+
+  RESET_NUM_OF_RESULTS(&(pQInfo->runtimeEnv));
+
+  if (pRsp->compressed && compLen != 0) {
+    int32_t numOfCols = pQueryAttr->pExpr2 ? pQueryAttr->numOfExpr2 : pQueryAttr->numOfOutput;
+    int32_t origSize  = pQueryAttr->resultRowSize * s;
+    int32_t compSize  = compLen + numOfCols * sizeof(int32_t);
+    pQRsp->contLen = pQRsp->contLen - origSize + compSize;
+    pRsp = (SRetrieveTableRsp *)rpcReallocCont(pRsp, pQRsp->contLen);
+    qDebug("QInfo:0x%"PRIx64" compress col data, uncompressed size:%d, compressed size:%d, ratio:%.2f",
+           pQInfo->qId, origSize, compSize, (float)origSize / (float)compSize);
+  }
+  pRsp->compLen = htonl(compLen);
+
+  // the cpu time takes the last bytes of the msg, after the table id infos
+  char *pEnd = (char *)pRsp + pQRsp->contLen;
+  if (pQRsp->pIov != NULL) {
+    SRpcIov *pTail = &pQRsp->pIov[pQRsp->numOfIov - 1];
+    pEnd = (char *)pTail->pCont + pTail->contLen;
+  }
+
+  pRsp->extend = TSDB_MSG_EXT_CPU_TIME;
+  *(int64_t *)(pEnd - sizeof(int64_t)) = htobe64(pQInfo->summary.cpuTime);
+
+  // notify no more result to client
+  pRsp->completed = (IS_QUERY_KILLED(pQInfo) || Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_OVER)) ? 1 : 0;
+
+  pQRsp->pRsp = pRsp;
+  return TSDB_CODE_SUCCESS;
+}
+
+/*
+ * Dump the current result into the tail of the prefetch buffer, so that the query continues to execute before the
+ * retrieve msg arrives. The rsp msg is accounted in the query buffer of the dnode. The lock of pQInfo is held.
+ */
+static bool doPrefetchResult(SQInfo *pQInfo) {
+  SQueryPrefetch   *pPrefetch = &pQInfo->prefetch;
+  SQueryRuntimeEnv *pRuntimeEnv = &pQInfo->runtimeEnv;
+
+  if (pPrefetch->num >= pPrefetch->capacity || pQInfo->code != TSDB_CODE_SUCCESS || IS_QUERY_KILLED(pQInfo)) {
+    return false;
+  }
+
+  SQueryRsp rsp = {0};
+  rsp.size = sizeof(SRetrieveTableRsp) + sizeof(int32_t) +
+             (int64_t)pRuntimeEnv->pQueryAttr->resultRowSize * GET_NUM_OF_RESULTS(pRuntimeEnv) +
+             sizeof(STableIdInfo) * taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap) + sizeof(int64_t);
+
+  if (!acquireQueryBufBytes(rsp.size)) {
+    qDebug("QInfo:0x%"PRIx64" not enough query buffer to prefetch result, size:%"PRId64, pQInfo->qId, rsp.size);
+    return false;
+  }
+
+  if (doBuildRetrieveRsp(pQInfo, &rsp) != TSDB_CODE_SUCCESS) {
+    releaseQueryBufBytes(rsp.size);
+    return false;
+  }
+
+  pPrefetch->pRsps[(pPrefetch->head + pPrefetch->num) % pPrefetch->capacity] = rsp;
+  pPrefetch->num += 1;
+  pPrefetch->last = (rsp.pRsp->completed != 0);
+
+  qDebug("QInfo:0x%"PRIx64" result prefetched, rows:%d, prefetched results:%d, last:%d", pQInfo->qId,
+         (int32_t)htonl(rsp.pRsp->numOfRows), pPrefetch->num, pPrefetch->last);
+  return true;
+}
+
+// the result is prefetched if there is room in the buffer and no retrieve msg is waiting for it
+static bool doBuildResOrPrefetch(SQInfo *pQInfo, bool *continueExec) {
+  if (pQInfo->prefetch.capacity == 0) {
+    return doBuildResCheck(pQInfo);
+  }
+
+  bool buildRes = false;
+  pthread_mutex_lock(&pQInfo->lock);
+
+  if (pQInfo->rspContext == NULL && doPrefetchResult(pQInfo)) {
+    *continueExec = !pQInfo->prefetch.last;
+  } else {
+    pQInfo->dataReady = QUERY_RESULT_READY;
+    buildRes = (pQInfo->rspContext != NULL);
+  }
+
+  assert(pQInfo->owner == taosGetSelfPthreadId());
+  pQInfo->owner = 0;
+
+  pthread_mutex_unlock(&pQInfo->lock);
+  return buildRes;
+}
+
+bool qTableQuery(qinfo_t qinfo, uint64_t *qId, bool *continueExec) {
   SQInfo *pQInfo = (SQInfo *)qinfo;
   assert(pQInfo && pQInfo->signature == pQInfo);
   int64_t threadId = taosGetSelfPthreadId();
 
+  *continueExec = false;
+
   int64_t curOwner = 0;
   if ((curOwner = atomic_val_compare_exchange_64(&pQInfo->owner, 0, threadId)) != 0) {
     qError("QInfo:0x%"PRIx64"-%p qhandle is now executed by thread:%p", pQInfo->qId, pQInfo, (void*) curOwner);
@@ -238,6 +395,7 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
   }
 
   *qId = pQInfo->qId;
+  pQInfo->runtimeEnv.yielded = false;
   if(pQInfo->startExecTs == 0) {
     pQInfo->startExecTs = taosGetTimestampMs();
     pQInfo->lastRetrieveTs = pQInfo->startExecTs;
@@ -271,13 +429,37 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
   bool newgroup = false;
   publishOperatorProfEvent(pRuntimeEnv->proot, QUERY_PROF_BEFORE_OPERATOR_EXEC);
 
+  // in the retrieve blocking model, the retrieve thread waits for the results of only one execution
   int64_t st = taosGetTimestampUs();
+  int64_t cpuSt = taosGetThreadCpuTimeUs();
+  if (pRuntimeEnv->yieldable && tsQueryTimeSlice > 0 && !tsRetrieveBlockingModel) {
+    pRuntimeEnv->sliceEndUs = st + tsQueryTimeSlice * 1000L;
+  }
+
   pRuntimeEnv->outputBuf = pRuntimeEnv->proot->exec(pRuntimeEnv->proot, &newgroup);
+  pRuntimeEnv->sliceEndUs = 0;
   pQInfo->summary.elapsedTime += (taosGetTimestampUs() - st);
+  pQInfo->summary.cpuTime += (taosGetThreadCpuTimeUs() - cpuSt);
 #ifdef TEST_IMPL
   waitMoment(pQInfo);
 #endif
   publishOperatorProfEvent(pRuntimeEnv->proot, QUERY_PROF_AFTER_OPERATOR_EXEC);
+
+  // no result is produced, the query is queued again to continue, so the retrieve msg keeps waiting
+  if (pRuntimeEnv->yielded) {
+    pQInfo->summary.numOfYields += 1;
+    qDebug("QInfo:0x%"PRIx64" query yields, cpu time:%"PRId64" us, yields:%u", pQInfo->qId, pQInfo->summary.cpuTime,
+           pQInfo->summary.numOfYields);
+
+    pthread_mutex_lock(&pQInfo->lock);
+    assert(pQInfo->owner == taosGetSelfPthreadId());
+    pQInfo->owner = 0;
+    pthread_mutex_unlock(&pQInfo->lock);
+
+    *continueExec = true;
+    return false;
+  }
+
   pRuntimeEnv->resultInfo.total += GET_NUM_OF_RESULTS(pRuntimeEnv);
 
   if (isQueryKilled(pQInfo)) {
@@ -290,7 +472,7 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
         GET_NUM_OF_RESULTS(pRuntimeEnv), pRuntimeEnv->resultInfo.total);
   }
 
-  return doBuildResCheck(pQInfo);
+  return doBuildResOrPrefetch(pQInfo, continueExec);
 }
 
 int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContext) {
@@ -321,7 +503,11 @@ int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContex
     pthread_mutex_lock(&pQInfo->lock);
 
     assert(pQInfo->rspContext == NULL);
-    if (pQInfo->dataReady == QUERY_RESULT_READY) {
+    if (pQInfo->prefetch.num > 0) {
+      *buildRes = true;
+      qDebug("QInfo:0x%"PRIx64" retrieve result info, %d prefetched results, code:%s", pQInfo->qId,
+             pQInfo->prefetch.num, tstrerror(pQInfo->code));
+    } else if (pQInfo->dataReady == QUERY_RESULT_READY) {
       *buildRes = true;
       qDebug("QInfo:0x%"PRIx64" retrieve result info, rowsize:%d, rows:%d, code:%s", pQInfo->qId, pQueryAttr->resultRowSize,
              GET_NUM_OF_RESULTS(pRuntimeEnv), tstrerror(pQInfo->code));
@@ -339,70 +525,68 @@ int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContex
   return code;
 }
 
-int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp **pRsp, int32_t *contLen, bool* continueExec) {
+int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp **pRsp, int32_t *contLen, SRpcIov **pIov,
+                            int32_t *numOfIov, bool* continueExec) {
   SQInfo *pQInfo = (SQInfo *)qinfo;
-  int32_t compLen = 0;
+
+  *pIov = NULL;
+  *numOfIov = 0;
 
   if (pQInfo == NULL || !isValidQInfo(pQInfo)) {
     return TSDB_CODE_QRY_INVALID_QHANDLE;
   }
 
-  SQueryAttr *pQueryAttr = pQInfo->runtimeEnv.pQueryAttr;
-  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SQueryPrefetch* pPrefetch = &pQInfo->prefetch;
+  SQueryRsp       rsp = {0};
 
-  int32_t s = GET_NUM_OF_RESULTS(pRuntimeEnv);
-  size_t size = pQueryAttr->resultRowSize * s;
-  size += sizeof(int32_t);
-  size += sizeof(STableIdInfo) * taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap);
-
-  *contLen = (int32_t)(size + sizeof(SRetrieveTableRsp));
+  *continueExec = false;
 
-  // current solution only avoid crash, but cannot return error code to client
-  *pRsp = (SRetrieveTableRsp *)rpcMallocCont(*contLen);
-  if (*pRsp == NULL) {
-    return TSDB_CODE_QRY_OUT_OF_MEMORY;
-  }
+  pthread_mutex_lock(&pQInfo->lock);
+  if (pPrefetch->num > 0) {
+    rsp = pPrefetch->pRsps[pPrefetch->head];
+    pPrefetch->head = (pPrefetch->head + 1) % pPrefetch->capacity;
+    pPrefetch->num -= 1;
+    releaseQueryBufBytes(rsp.size);
 
-  (*pRsp)->numOfRows = htonl((int32_t)s);
+    // the query is paused since the buffer was full, its result takes the room and the query continues
+    if (pQInfo->dataReady == QUERY_RESULT_READY && doPrefetchResult(pQInfo)) {
+      pQInfo->dataReady = QUERY_RESULT_NOT_READY;
+      *continueExec = !pPrefetch->last;
+    }
 
-  if (pQInfo->code == TSDB_CODE_SUCCESS) {
-    (*pRsp)->offset   = htobe64(pQInfo->runtimeEnv.currentOffset);
-    (*pRsp)->useconds = htobe64(pQInfo->summary.elapsedTime);
-  } else {
-    (*pRsp)->offset   = 0;
-    (*pRsp)->useconds = htobe64(pQInfo->summary.elapsedTime);
+    pQInfo->rspContext = NULL;
   }
+  pthread_mutex_unlock(&pQInfo->lock);
 
-  (*pRsp)->precision = htons(pQueryAttr->precision);
-  (*pRsp)->compressed = (int8_t)((tsCompressColData != -1) && checkNeedToCompressQueryCol(pQInfo));
+  if (rsp.pRsp != NULL) {
+    *pRsp     = rsp.pRsp;
+    *contLen  = rsp.contLen;
+    *pIov     = rsp.pIov;
+    *numOfIov = rsp.numOfIov;
 
-  if (GET_NUM_OF_RESULTS(&(pQInfo->runtimeEnv)) > 0 && pQInfo->code == TSDB_CODE_SUCCESS) {
-    doDumpQueryResult(pQInfo, (*pRsp)->data, (*pRsp)->compressed, &compLen);
-  } else {
-    setQueryStatus(pRuntimeEnv, QUERY_OVER);
+    pQInfo->lastRetrieveTs = taosGetTimestampMs();
+    qDebug("QInfo:0x%"PRIx64" prefetched result retrieved, completed:%d, prefetched results:%d", pQInfo->qId,
+           rsp.pRsp->completed, pPrefetch->num);
+    return TSDB_CODE_SUCCESS;
   }
 
-  RESET_NUM_OF_RESULTS(&(pQInfo->runtimeEnv));
-  pQInfo->lastRetrieveTs = taosGetTimestampMs();
-
-  if ((*pRsp)->compressed && compLen != 0) {
-    int32_t numOfCols = pQueryAttr->pExpr2 ? pQueryAttr->numOfExpr2 : pQueryAttr->numOfOutput;
-    int32_t origSize  = pQueryAttr->resultRowSize * s;
-    int32_t compSize  = compLen + numOfCols * sizeof(int32_t);
-    *contLen = *contLen - origSize + compSize;
-    *pRsp = (SRetrieveTableRsp *)rpcReallocCont(*pRsp, *contLen);
-    qDebug("QInfo:0x%"PRIx64" compress col data, uncompressed size:%d, compressed size:%d, ratio:%.2f",
-           pQInfo->qId, origSize, compSize, (float)origSize / (float)compSize);
+  int32_t code = doBuildRetrieveRsp(pQInfo, &rsp);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
   }
-  (*pRsp)->compLen = htonl(compLen);
 
+  *pRsp     = rsp.pRsp;
+  *contLen  = rsp.contLen;
+  *pIov     = rsp.pIov;
+  *numOfIov = rsp.numOfIov;
+
+  pQInfo->lastRetrieveTs = taosGetTimestampMs();
   pQInfo->rspContext = NULL;
   pQInfo->dataReady  = QUERY_RESULT_NOT_READY;
 
-  if (IS_QUERY_KILLED(pQInfo) || Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_OVER)) {
+  if ((*pRsp)->completed) {
     // here current thread hold the refcount, so it is safe to free tsdbQueryHandle.
     *continueExec = false;
-    (*pRsp)->completed = 1;  // notify no more result to client
     qDebug("QInfo:0x%"PRIx64" no more results to retrieve", pQInfo->qId);
   } else {
     *continueExec = true;
@@ -451,7 +635,14 @@ int32_t qQueryCompleted(qinfo_t qinfo) {
     return TSDB_CODE_QRY_INVALID_QHANDLE;
   }
 
-  return isQueryKilled(pQInfo) || Q_STATUS_EQUAL(pQInfo->runtimeEnv.status, QUERY_OVER);
+  // the last result waiting in the prefetch buffer keeps the qhandle, which is freed after it is retrieved
+  return isQueryKilled(pQInfo) ||
+         (Q_STATUS_EQUAL(pQInfo->runtimeEnv.status, QUERY_OVER) && !pQInfo->prefetch.last);
+}
+
+bool qIsBatchQuery(qinfo_t qinfo) {
+  SQInfo *pQInfo = (SQInfo *)qinfo;
+  return pQInfo != NULL && isValidQInfo(pQInfo) && pQInfo->summary.numOfYields > 0;
 }
 
 void qDestroyQueryInfo(qinfo_t qHandle) {
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_RPC_COMP_H
+#define TDENGINE_RPC_COMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// codec of the message content, kept in the comp field of the message head
+#define RPC_COMP_NONE 0
+#define RPC_COMP_LZ4  1
+#define RPC_COMP_ZSTD 2
+
+#define RPC_COMP_CODEC_BIT(codec) ((uint8_t)(1u << (codec)))
+
+// the acceleration range of LZ4_compress_fast, values out of it are clamped by lz4 itself
+#define RPC_COMP_LZ4_ACCEL_MIN 1
+#define RPC_COMP_LZ4_ACCEL_MAX 65537
+
+// the codecs can be decompressed by this side, it is sent to the peer in each message head
+uint8_t rpcCompCodecs();
+
+// the configured codec if the peer accepts it, otherwise LZ4, which is known by the peers of all versions
+int8_t  rpcCompSelectCodec(uint8_t peerCodecs);
+
+// the lz4 acceleration or zstd level of the codec, configured by its own option and clamped to the codec range
+int32_t rpcCompLevel(int8_t codec);
+
+/*
+ * compress the source into dst by the scratch buffer and codec context of the calling thread, so dst may overlap
+ * with the source. The compressed length is returned, 0 if it is not less than dstLen, or -1 if failed
+ */
+int32_t rpcCompress(int8_t codec, const char *src, int32_t srcLen, char *dst, int32_t dstLen);
+
+// the decompressed length is returned, or -1 if the codec is unknown or the data is corrupted
+int32_t rpcDecompress(int8_t codec, const char *src, int32_t srcLen, char *dst, int32_t dstLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_RPC_COMP_H
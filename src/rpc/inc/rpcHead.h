@@ -39,7 +39,7 @@ typedef struct {
 
 typedef struct {
   char     version:4; // RPC version
-  char     comp:4;    // compression algorithm, 0:no compression 1:lz4
+  char     comp:4;    // compression algorithm, 0:no compression 1:lz4 2:zstd
   char     resflag:2; // reserved bits
   char     spi:3;     // security parameter index
   char     encrypt:3; // encrypt algorithm, 0: no encryption
@@ -51,7 +51,7 @@ typedef struct {
   uint32_t destIp;    // destination IP address, for NAT scenario
   char     user[TSDB_UNI_LEN]; // user ID 
   uint16_t port;      // for UDP only, port may be changed
-  char     empty[1];  // reserved
+  uint8_t  codecs;    // bit mask of the compression algorithms the sender accepts, 0 from old versions for lz4 only
   uint8_t  msgType;   // message type  
   int32_t  msgLen;    // message length including the header iteslf
   uint32_t msgVer;
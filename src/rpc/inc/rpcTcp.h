@@ -31,6 +31,7 @@ void *taosOpenTcpClientConnection(void *shandle, void *thandle, uint32_t ip, uin
 
 void taosCloseTcpConnection(void *chandle);
 int  taosSendTcpData(uint32_t ip, uint16_t port, void *data, int len, void *chandle);
+int  taosSendTcpDataV(struct SRpcIov *pIov, int numOfIov, void *chandle);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "lz4.h"
+#ifdef TD_TSZ
+#include "zstd.h"
+#endif
+#include "tglobal.h"
+#include "rpcLog.h"
+#include "rpcComp.h"
+
+// the scratch buffer larger than it is released after the message is compressed
+#define RPC_COMP_MAX_SCRATCH (4 * 1024 * 1024)
+
+typedef struct {
+  char      *buf;       // scratch buffer to compress the message
+  int32_t    bufLen;
+  void      *lz4State;
+#ifdef TD_TSZ
+  ZSTD_CCtx *zstdCCtx;
+  ZSTD_DCtx *zstdDCtx;
+#endif
+} SRpcCompCtx;
+
+static pthread_key_t  tsRpcCompKey;
+static pthread_once_t tsRpcCompOnce = PTHREAD_ONCE_INIT;
+static int32_t        tsRpcCompKeyCode = -1;
+
+static void rpcCompFreeCtx(void *param) {
+  SRpcCompCtx *pCtx = param;
+  if (pCtx == NULL) return;
+
+  tfree(pCtx->buf);
+  tfree(pCtx->lz4State);
+#ifdef TD_TSZ
+  if (pCtx->zstdCCtx) ZSTD_freeCCtx(pCtx->zstdCCtx);
+  if (pCtx->zstdDCtx) ZSTD_freeDCtx(pCtx->zstdDCtx);
+#endif
+  free(pCtx);
+}
+
+static void rpcCompInitKey() { tsRpcCompKeyCode = pthread_key_create(&tsRpcCompKey, rpcCompFreeCtx); }
+
+// the contexts are kept by each thread, and released when the thread exits
+static SRpcCompCtx *rpcCompGetCtx() {
+  pthread_once(&tsRpcCompOnce, rpcCompInitKey);
+  if (tsRpcCompKeyCode != 0) return NULL;
+
+  SRpcCompCtx *pCtx = pthread_getspecific(tsRpcCompKey);
+  if (pCtx == NULL) {
+    pCtx = calloc(1, sizeof(SRpcCompCtx));
+    if (pCtx == NULL) return NULL;
+
+    if (pthread_setspecific(tsRpcCompKey, pCtx) != 0) {
+      free(pCtx);
+      return NULL;
+    }
+  }
+
+  return pCtx;
+}
+
+uint8_t rpcCompCodecs() {
+  uint8_t codecs = RPC_COMP_CODEC_BIT(RPC_COMP_LZ4);
+#ifdef TD_TSZ
+  codecs |= RPC_COMP_CODEC_BIT(RPC_COMP_ZSTD);
+#endif
+  return codecs;
+}
+
+int8_t rpcCompSelectCodec(uint8_t peerCodecs) {
+  int8_t codec = tsRpcCompressCodec;
+  if ((rpcCompCodecs() & peerCodecs & RPC_COMP_CODEC_BIT(codec)) == 0) codec = RPC_COMP_LZ4;
+  return codec;
+}
+
+int32_t rpcCompLevel(int8_t codec) {
+  int32_t level = 0;
+  int32_t minLevel = 0;
+  int32_t maxLevel = 0;
+
+  if (codec == RPC_COMP_LZ4) {
+    level = tsRpcLz4Acceleration;
+    minLevel = RPC_COMP_LZ4_ACCEL_MIN;
+    maxLevel = RPC_COMP_LZ4_ACCEL_MAX;
+#ifdef TD_TSZ
+  } else if (codec == RPC_COMP_ZSTD) {
+    level = tsRpcZstdLevel;
+    minLevel = 1;
+    maxLevel = ZSTD_maxCLevel();
+#endif
+  }
+
+  if (level < minLevel) level = minLevel;
+  if (level > maxLevel) level = maxLevel;
+  return level;
+}
+
+int32_t rpcCompress(int8_t codec, const char *src, int32_t srcLen, char *dst, int32_t dstLen) {
+  SRpcCompCtx *pCtx = rpcCompGetCtx();
+  int32_t      compLen = -1;
+  int32_t      bound = 0;
+
+  if (pCtx == NULL) return -1;
+
+  if (codec == RPC_COMP_LZ4) {
+    bound = LZ4_compressBound(srcLen);
+#ifdef TD_TSZ
+  } else if (codec == RPC_COMP_ZSTD) {
+    bound = (int32_t)ZSTD_compressBound(srcLen);
+#endif
+  } else {
+    return -1;
+  }
+
+  if (pCtx->bufLen < bound) {
+    char *buf = realloc(pCtx->buf, bound);
+    if (buf == NULL) return -1;
+    pCtx->buf = buf;
+    pCtx->bufLen = bound;
+  }
+
+  if (codec == RPC_COMP_LZ4) {
+    if (pCtx->lz4State == NULL) pCtx->lz4State = malloc(LZ4_sizeofState());
+    if (pCtx->lz4State != NULL) {
+      compLen = LZ4_compress_fast_extState(pCtx->lz4State, src, pCtx->buf, srcLen, bound, rpcCompLevel(codec));
+      if (compLen <= 0) compLen = -1;
+    }
+#ifdef TD_TSZ
+  } else {
+    if (pCtx->zstdCCtx == NULL) pCtx->zstdCCtx = ZSTD_createCCtx();
+    if (pCtx->zstdCCtx != NULL) {
+      size_t len = ZSTD_compressCCtx(pCtx->zstdCCtx, pCtx->buf, bound, src, srcLen, rpcCompLevel(codec));
+      compLen = ZSTD_isError(len) ? -1 : (int32_t)len;
+    }
+#endif
+  }
+
+  if (compLen >= dstLen) {
+    compLen = 0;
+  } else if (compLen > 0) {
+    memcpy(dst, pCtx->buf, compLen);
+  }
+
+  if (pCtx->bufLen > RPC_COMP_MAX_SCRATCH) {
+    tfree(pCtx->buf);
+    pCtx->bufLen = 0;
+  }
+
+  return compLen;
+}
+
+int32_t rpcDecompress(int8_t codec, const char *src, int32_t srcLen, char *dst, int32_t dstLen) {
+  if (codec == RPC_COMP_LZ4) {
+    int32_t len = LZ4_decompress_safe(src, dst, srcLen, dstLen);
+    return len < 0 ? -1 : len;
+  }
+
+#ifdef TD_TSZ
+  if (codec == RPC_COMP_ZSTD) {
+    SRpcCompCtx *pCtx = rpcCompGetCtx();
+    if (pCtx == NULL) return -1;
+
+    if (pCtx->zstdDCtx == NULL) pCtx->zstdDCtx = ZSTD_createDCtx();
+    if (pCtx->zstdDCtx == NULL) return -1;
+
+    size_t len = ZSTD_decompressDCtx(pCtx->zstdDCtx, dst, dstLen, src, srcLen);
+    return ZSTD_isError(len) ? -1 : (int32_t)len;
+  }
+#endif
+
+  tError("failed to decompress rpc msg, codec:%d is not supported", codec);
+  return -1;
+}
@@ -32,6 +32,7 @@
 #include "rpcCache.h"
 #include "rpcTcp.h"
 #include "rpcHead.h"
+#include "rpcComp.h"
 
 #define RPC_MSG_OVERHEAD (sizeof(SRpcReqContext) + sizeof(SRpcHead) + sizeof(SRpcDigest)) 
 #define rpcHeadFromCont(cont) ((SRpcHead *) ((char*)cont - sizeof(SRpcHead)))
@@ -67,6 +68,7 @@ typedef struct {
   void     *pCache;   // connection cache
   pthread_mutex_t  mutex;
   struct SRpcConn *connList;  // connection list
+  SRpcCompStat     compStat;  // compression of the messages
 } SRpcInfo;
 
 typedef struct {
@@ -110,6 +112,7 @@ typedef struct SRpcConn {
   uint16_t  inTranId;       // transcation ID for incoming msg
   uint8_t   outType;        // message type for outgoing request
   uint8_t   inType;         // message type for incoming request  
+  uint8_t   peerCodecs;     // compression algorithms the peer accepts
   void     *chandle;  // handle passed by TCP/UDP connection layer
   void     *ahandle;  // handle provided by upper app layter
   int       retry;    // number of retry for sending request
@@ -118,6 +121,9 @@ typedef struct SRpcConn {
   void     *pIdleTimer; // idle timer
   char     *pRspMsg;    // response message including header
   int       rspMsgLen;  // response messag length
+  SRpcIov  *pRspIov;    // segments sent after the response message
+  int       rspIovNum;  // number of the segments
+  void    (*rspIovFreeFp)(void *);  // to free the segments
   char     *pReqMsg;    // request message including header
   int       reqMsgLen;  // request message length
   SRpcInfo *pRpc;       // the associated SRpcInfo
@@ -197,6 +203,7 @@ static void  rpcSendReqToServer(SRpcInfo *pRpc, SRpcReqContext *pContext);
 static void  rpcSendQuickRsp(SRpcConn *pConn, int32_t code);
 static void  rpcSendErrorMsgToPeer(SRecvInfo *pRecv, int32_t code);
 static void  rpcSendMsgToPeer(SRpcConn *pConn, void *data, int dataLen);
+static void  rpcSendMsgToPeerV(SRpcConn *pConn, void *data, int dataLen, const SRpcIov *pIov, int numOfIov);
 static void  rpcSendReqHead(SRpcConn *pConn);
 
 static void *rpcProcessMsgFromPeer(SRecvInfo *pRecv);
@@ -207,9 +214,11 @@ static void  rpcProcessIdleTimer(void *param, void *tmrId);
 static void  rpcProcessProgressTimer(void *param, void *tmrId);
 
 static void  rpcFreeMsg(void *msg);
-static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen);
-static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead);
-static int   rpcAddAuthPart(SRpcConn *pConn, char *msg, int msgLen);
+static void  rpcFreeRspMsg(SRpcConn *pConn);
+static void  rpcFreeIov(const SRpcIov *pIov, int numOfIov, void (*freeFp)(void *));
+static int32_t rpcCompressRpcMsg(SRpcInfo *pRpc, int8_t codec, char* pCont, int32_t contLen);
+static SRpcHead *rpcDecompressRpcMsg(SRpcInfo *pRpc, SRpcHead *pHead);
+static int   rpcAddAuthPart(SRpcConn *pConn, char *msg, int msgLen, const SRpcIov *pIov, int numOfIov);
 static int   rpcCheckAuthentication(SRpcConn *pConn, char *msg, int msgLen);
 static void  rpcLockConn(SRpcConn *pConn);
 static void  rpcUnlockConn(SRpcConn *pConn);
@@ -340,10 +349,31 @@ void rpcClose(void *param) {
   (*taosCleanUpConn[pRpc->connType | RPC_CONN_TCP])(pRpc->tcphandle);
   (*taosCleanUpConn[pRpc->connType])(pRpc->udphandle);
 
+  SRpcCompStat *pStat = &pRpc->compStat;
+  if (pStat->compMsgs > 0 || pStat->decompMsgs > 0) {
+    tInfo("%s rpc compression, compressed %" PRId64 " msgs from %" PRId64 " to %" PRId64 " bytes in %" PRId64
+          " us, decompressed %" PRId64 " msgs from %" PRId64 " to %" PRId64 " bytes in %" PRId64 " us",
+          pRpc->label, pStat->compMsgs, pStat->compRawBytes, pStat->compBytes, pStat->compUs, pStat->decompMsgs,
+          pStat->decompBytes, pStat->decompRawBytes, pStat->decompUs);
+  }
+
   tDebug("%s rpc is closed", pRpc->label);
   rpcDecRef(pRpc);
 }
 
+void rpcGetCompStat(void *shandle, SRpcCompStat *pStat) {
+  SRpcInfo *pRpc = (SRpcInfo *)shandle;
+
+  pStat->compMsgs = atomic_load_64(&pRpc->compStat.compMsgs);
+  pStat->compRawBytes = atomic_load_64(&pRpc->compStat.compRawBytes);
+  pStat->compBytes = atomic_load_64(&pRpc->compStat.compBytes);
+  pStat->compUs = atomic_load_64(&pRpc->compStat.compUs);
+  pStat->decompMsgs = atomic_load_64(&pRpc->compStat.decompMsgs);
+  pStat->decompBytes = atomic_load_64(&pRpc->compStat.decompBytes);
+  pStat->decompRawBytes = atomic_load_64(&pRpc->compStat.decompRawBytes);
+  pStat->decompUs = atomic_load_64(&pRpc->compStat.decompUs);
+}
+
 void *rpcMallocCont(int contLen) {
   int size = contLen + RPC_MSG_OVERHEAD;
 
@@ -389,7 +419,8 @@ void rpcSendRequest(void *shandle, const SRpcEpSet *pEpSet, SRpcMsg *pMsg, int64
   SRpcInfo       *pRpc = (SRpcInfo *)shandle;
   SRpcReqContext *pContext;
 
-  int contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen);
+  // the server of the request is unknown yet, so it is compressed by lz4
+  int contLen = rpcCompressRpcMsg(pRpc, RPC_COMP_LZ4, pMsg->pCont, pMsg->contLen);
   pContext = (SRpcReqContext *) ((char*)pMsg->pCont-sizeof(SRpcHead)-sizeof(SRpcReqContext));
   pContext->ahandle = pMsg->ahandle;
   pContext->pRpc = (SRpcInfo *)shandle;
@@ -419,21 +450,55 @@ void rpcSendRequest(void *shandle, const SRpcEpSet *pEpSet, SRpcMsg *pMsg, int64
 }
 
 void rpcSendResponse(const SRpcMsg *pRsp) {
+  rpcSendResponseV(pRsp, NULL, 0, NULL);
+}
+
+/*
+ * The segments are sent after the content by writev, and they are owned by rpc after the call, since the response
+ * is kept to be sent again. They are merged into the content if the message shall be compressed or sent by UDP.
+ */
+void rpcSendResponseV(const SRpcMsg *pRsp, const SRpcIov *pIov, int numOfIov, void (*freeFp)(void *)) {
   int        msgLen = 0;
   SRpcConn  *pConn = (SRpcConn *)pRsp->handle;
   SRpcMsg    rpcMsg = *pRsp;
   SRpcMsg   *pMsg = &rpcMsg;
   SRpcInfo  *pRpc = pConn->pRpc;
+  SRpcIov   *pSegs = NULL;
+  int        segLen = 0;
 
   if ( pMsg->pCont == NULL ) {
     pMsg->pCont = rpcMallocCont(0);
     pMsg->contLen = 0;
   }
 
+  for (int i = 0; i < numOfIov; ++i) segLen += pIov[i].contLen;
+
+  if (numOfIov > 0 && !NEEDTO_COMPRESSS_MSG(pMsg->contLen + segLen) && (pConn->connType & RPC_CONN_TCP)) {
+    pSegs = malloc(sizeof(SRpcIov) * numOfIov);
+    if (pSegs != NULL) memcpy(pSegs, pIov, sizeof(SRpcIov) * numOfIov);
+  }
+
+  if (numOfIov > 0 && pSegs == NULL) {
+    char *pCont = rpcReallocCont(pMsg->pCont, pMsg->contLen + segLen);
+    if (pCont != NULL) {
+      for (int i = 0; i < numOfIov; ++i) {
+        memcpy(pCont + pMsg->contLen, pIov[i].pCont, pIov[i].contLen);
+        pMsg->contLen += pIov[i].contLen;
+      }
+      pMsg->pCont = pCont;
+    } else {
+      pMsg->contLen = 0;
+      pMsg->code = TSDB_CODE_COM_OUT_OF_MEMORY;
+    }
+
+    rpcFreeIov(pIov, numOfIov, freeFp);
+    numOfIov = 0;
+  }
+
   SRpcHead  *pHead = rpcHeadFromCont(pMsg->pCont);
   char      *msg = (char *)pHead;
 
-  pMsg->contLen = rpcCompressRpcMsg(pMsg->pCont, pMsg->contLen);
+  pMsg->contLen = rpcCompressRpcMsg(pRpc, rpcCompSelectCodec(pConn->peerCodecs), pMsg->pCont, pMsg->contLen);
   msgLen = rpcMsgLenFromCont(pMsg->contLen);
 
   rpcLockConn(pConn);
@@ -442,6 +507,8 @@ void rpcSendResponse(const SRpcMsg *pRsp) {
     tError("%s, connection is already released, rsp wont be sent", pConn->info);
     rpcUnlockConn(pConn);
     rpcFreeCont(pMsg->pCont);
+    rpcFreeIov(pSegs, numOfIov, freeFp);
+    tfree(pSegs);
     rpcDecRef(pRpc);
     return;
   }
@@ -463,9 +530,12 @@ void rpcSendResponse(const SRpcMsg *pRsp) {
   pConn->inType = 0;
 
   // response message is released until new response is sent
-  rpcFreeMsg(pConn->pRspMsg); 
+  rpcFreeRspMsg(pConn);
   pConn->pRspMsg = msg;
   pConn->rspMsgLen = msgLen;
+  pConn->pRspIov = pSegs;
+  pConn->rspIovNum = numOfIov;
+  pConn->rspIovFreeFp = freeFp;
   if (pMsg->code == TSDB_CODE_RPC_ACTION_IN_PROGRESS) pConn->inTranId--;
 
   // stop the progress timer
@@ -473,7 +543,7 @@ void rpcSendResponse(const SRpcMsg *pRsp) {
 
   // set the idle timer to monitor the activity
   taosTmrReset(rpcProcessIdleTimer, pRpc->idleTime * 30, pConn, pRpc->tmrCtrl, &pConn->pIdleTimer);
-  rpcSendMsgToPeer(pConn, msg, msgLen);
+  rpcSendMsgToPeerV(pConn, msg, msgLen, pSegs, numOfIov);
 
   // if not set to secured, set it expcet NOT_READY case, since client wont treat it as secured
   if (pConn->secured == 0 && pMsg->code != TSDB_CODE_RPC_NOT_READY)
@@ -570,6 +640,21 @@ void rpcCancelRequest(int64_t rid) {
   taosReleaseRef(tsRpcRefId, rid);
 }
 
+static void rpcFreeIov(const SRpcIov *pIov, int numOfIov, void (*freeFp)(void *)) {
+  for (int i = 0; i < numOfIov && freeFp; ++i) {
+    (*freeFp)(pIov[i].pCont);
+  }
+}
+
+static void rpcFreeRspMsg(SRpcConn *pConn) {
+  rpcFreeMsg(pConn->pRspMsg);
+  pConn->pRspMsg = NULL;
+
+  rpcFreeIov(pConn->pRspIov, pConn->rspIovNum, pConn->rspIovFreeFp);
+  tfree(pConn->pRspIov);
+  pConn->rspIovNum = 0;
+}
+
 static void rpcFreeMsg(void *msg) {
   if ( msg ) {
     char *temp = (char *)msg - sizeof(SRpcReqContext);
@@ -627,8 +712,7 @@ static void rpcReleaseConn(SRpcConn *pConn) {
     char hashstr[40] = {0};
     size_t size = snprintf(hashstr, sizeof(hashstr), "%x:%x:%x:%d", pConn->peerIp, pConn->linkUid, pConn->peerId, pConn->connType);
     taosHashRemove(pRpc->hash, hashstr, size);
-    rpcFreeMsg(pConn->pRspMsg); // it may have a response msg saved, but not request msg
-    pConn->pRspMsg = NULL;
+    rpcFreeRspMsg(pConn); // it may have a response msg saved, but not request msg
   
     // if server has ever reported progress, free content
     if (pConn->pReqMsg) rpcFreeCont(pConn->pReqMsg);  // do not use rpcFreeMsg
@@ -840,7 +924,7 @@ static int rpcProcessReqHead(SRpcConn *pConn, SRpcHead *pHead) {
         }
       } else if (pConn->inType == 0) {
         tDebug("%s, %s is already processed, tranId:%d", pConn->info, taosMsg[pHead->msgType], pConn->inTranId);
-        rpcSendMsgToPeer(pConn, pConn->pRspMsg, pConn->rspMsgLen); // resend the response
+        rpcSendMsgToPeerV(pConn, pConn->pRspMsg, pConn->rspMsgLen, pConn->pRspIov, pConn->rspIovNum); // resend the response
       } else {
         tDebug("%s, mismatched message %s and tranId", pConn->info, taosMsg[pHead->msgType]);
       }
@@ -1003,6 +1087,8 @@ static SRpcConn *rpcProcessMsgHead(SRpcInfo *pRpc, SRecvInfo *pRecv, SRpcReqCont
       // decrypt here
     }
 
+    pConn->peerCodecs = pHead->codecs;
+
     if ( rpcIsReq(pHead->msgType) ) {
       pConn->connType = pRecv->connType;
       terrno = rpcProcessReqHead(pConn, pHead);
@@ -1154,8 +1240,23 @@ static void rpcProcessIncomingMsg(SRpcConn *pConn, SRpcHead *pHead, SRpcReqConte
 
   SRpcInfo *pRpc = pConn->pRpc;
   SRpcMsg   rpcMsg;
+  SRpcHead *pNewHead = rpcDecompressRpcMsg(pRpc, pHead);
+
+  if (pNewHead == NULL) {
+    // the content is dropped, and the message is processed as failed
+    pHead->msgLen = sizeof(SRpcHead);
+    if (rpcIsReq(pHead->msgType)) {
+      SRpcMsg rspMsg = {.handle = pConn, .code = TSDB_CODE_RPC_INVALID_VALUE};
+      rpcAddRef(pRpc);
+      rpcSendResponse(&rspMsg);
+      rpcFreeMsg(pHead);
+      return;
+    }
+    pHead->code = TSDB_CODE_RPC_INVALID_VALUE;
+  } else {
+    pHead = pNewHead;
+  }
 
-  pHead = rpcDecompressRpcMsg(pHead);
   rpcMsg.contLen = rpcContLenFromMsg(pHead->msgLen);
   rpcMsg.pCont = pHead->content;
   rpcMsg.msgType = pHead->msgType;
@@ -1350,10 +1451,16 @@ static void rpcSendReqToServer(SRpcInfo *pRpc, SRpcReqContext *pContext) {
 }
 
 static void rpcSendMsgToPeer(SRpcConn *pConn, void *msg, int msgLen) {
+  rpcSendMsgToPeerV(pConn, msg, msgLen, NULL, 0);
+}
+
+static void rpcSendMsgToPeerV(SRpcConn *pConn, void *msg, int msgLen, const SRpcIov *pIov, int numOfIov) {
   int        writtenLen = 0;
+  int        headLen = msgLen;
   SRpcHead  *pHead = (SRpcHead *)msg;
 
-  msgLen = rpcAddAuthPart(pConn, msg, msgLen);
+  pHead->codecs = rpcCompCodecs();
+  msgLen = rpcAddAuthPart(pConn, msg, msgLen, pIov, numOfIov);
 
   if ( rpcIsReq(pHead->msgType)) {
     tDebug("%s, %s is sent to %s:%hu, len:%d sig:0x%08x:0x%08x:%d",
@@ -1367,13 +1474,36 @@ static void rpcSendMsgToPeer(SRpcConn *pConn, void *msg, int msgLen) {
   }
 
   //tTrace("connection type is: %d", pConn->connType);
-  writtenLen = (*taosSendData[pConn->connType])(pConn->peerIp, pConn->peerPort, pHead, msgLen, pConn->chandle);
+  if (numOfIov == 0) {
+    writtenLen = (*taosSendData[pConn->connType])(pConn->peerIp, pConn->peerPort, pHead, msgLen, pConn->chandle);
+  } else {
+    // the head and content, the segments, and the digest if it is appended
+    SRpcIov *vec = malloc(sizeof(SRpcIov) * (numOfIov + 2));
+    int      num = 0;
+
+    if (vec != NULL) {
+      int segLen = 0;
+      vec[num].pCont = msg;
+      vec[num++].contLen = headLen;
+      for (int i = 0; i < numOfIov; ++i) {
+        vec[num++] = pIov[i];
+        segLen += pIov[i].contLen;
+      }
+      if (msgLen > headLen + segLen) {
+        vec[num].pCont = (char *)msg + headLen;
+        vec[num++].contLen = msgLen - headLen - segLen;
+      }
+
+      writtenLen = taosSendTcpDataV(vec, num, pConn->chandle);
+      free(vec);
+    }
+  }
 
   if (writtenLen != msgLen) {
     tError("%s, failed to send, msgLen:%d written:%d, reason:%s", pConn->info, msgLen, writtenLen, strerror(errno));
   }
  
-  tDump(msg, msgLen);
+  tDump(msg, numOfIov == 0 ? msgLen : headLen);
 }
 
 static void rpcProcessConnError(void *param, void *id) {
@@ -1469,7 +1599,7 @@ static void rpcProcessProgressTimer(void *param, void *tmrId) {
   rpcUnlockConn(pConn);
 }
 
-static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen) {
+static int32_t rpcCompressRpcMsg(SRpcInfo *pRpc, int8_t codec, char* pCont, int32_t contLen) {
   SRpcHead  *pHead = rpcHeadFromCont(pCont);
   int32_t    finalLen = 0;
   int        overhead = sizeof(SRpcComp);
@@ -1477,68 +1607,86 @@ static int32_t rpcCompressRpcMsg(char* pCont, int32_t contLen) {
   if (!NEEDTO_COMPRESSS_MSG(contLen)) {
     return contLen;
   }
-  
-  char *buf = malloc (contLen + overhead + 8);  // 8 extra bytes
-  if (buf == NULL) {
-    tError("failed to allocate memory for rpc msg compression, contLen:%d", contLen);
-    return contLen;
-  }
-  
-  int32_t compLen = LZ4_compress_default(pCont, buf, contLen, contLen + overhead);
-  tDebug("compress rpc msg, before:%d, after:%d, overhead:%d", contLen, compLen, overhead);
-  
+
   /*
    * only the compressed size is less than the value of contLen - overhead, the compression is applied
    * The first four bytes is set to 0, the second four bytes are utilized to keep the original length of message
    */
-  if (compLen > 0 && compLen < contLen - overhead) {
+  int64_t st = taosGetTimestampUs();
+  int32_t compLen = rpcCompress(codec, pCont, contLen, pCont + overhead, contLen - overhead);
+  int64_t et = taosGetTimestampUs();
+
+  if (compLen > 0) {
     SRpcComp *pComp = (SRpcComp *)pCont;
     pComp->reserved = 0; 
     pComp->contLen = htonl(contLen); 
-    memcpy(pCont + overhead, buf, compLen);
-    
-    pHead->comp = 1;
-    tDebug("compress rpc msg, before:%d, after:%d", contLen, compLen);
+
+    pHead->comp = codec;
+    tDebug("compress rpc msg, codec:%d before:%d, after:%d, overhead:%d", codec, contLen, compLen, overhead);
     finalLen = compLen + overhead;
   } else {
+    if (compLen < 0) tError("failed to compress rpc msg, codec:%d contLen:%d", codec, contLen);
     finalLen = contLen;
   }
 
-  free(buf);
+  atomic_add_fetch_64(&pRpc->compStat.compMsgs, 1);
+  atomic_add_fetch_64(&pRpc->compStat.compRawBytes, contLen);
+  atomic_add_fetch_64(&pRpc->compStat.compBytes, finalLen);
+  atomic_add_fetch_64(&pRpc->compStat.compUs, et - st);
+
   return finalLen;
 }
 
-static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead) {
+// NULL is returned if the content can not be decompressed
+static SRpcHead *rpcDecompressRpcMsg(SRpcInfo *pRpc, SRpcHead *pHead) {
   int overhead = sizeof(SRpcComp);
   SRpcHead   *pNewHead = NULL;  
   uint8_t    *pCont = pHead->content;
   SRpcComp   *pComp = (SRpcComp *)pHead->content;
 
-  if (pHead->comp) {
-    // decompress the content
-    assert(pComp->reserved == 0);
-    int contLen = htonl(pComp->contLen);
-  
-    // prepare the temporary buffer to decompress message
-    char *temp = (char *)malloc(contLen + RPC_MSG_OVERHEAD);
-    pNewHead = (SRpcHead *)(temp + sizeof(SRpcReqContext)); // reserve SRpcReqContext
-  
-    if (pNewHead) {
-      int compLen = rpcContLenFromMsg(pHead->msgLen) - overhead;
-      int origLen = LZ4_decompress_safe((char*)(pCont + overhead), (char *)pNewHead->content, compLen, contLen);
-      assert(origLen == contLen);
-    
-      memcpy(pNewHead, pHead, sizeof(SRpcHead));
-      pNewHead->msgLen = rpcMsgLenFromCont(origLen);
-      rpcFreeMsg(pHead); // free the compressed message buffer
-      pHead = pNewHead; 
-      tTrace("decomp malloc mem:%p", temp);
-    } else {
-      tError("failed to allocate memory to decompress msg, contLen:%d", contLen);
-    }
+  if (pHead->comp == 0) {
+    return pHead;
   }
 
-  return pHead;
+  // decompress the content
+  int compLen = rpcContLenFromMsg(pHead->msgLen) - overhead;
+  if (compLen < 0 || pComp->reserved != 0) {
+    tError("invalid compressed rpc msg, codec:%d msgLen:%d", pHead->comp, pHead->msgLen);
+    return NULL;
+  }
+
+  int contLen = htonl(pComp->contLen);
+
+  // prepare the temporary buffer to decompress message
+  char *temp = (contLen >= 0) ? (char *)malloc(contLen + RPC_MSG_OVERHEAD) : NULL;
+  if (temp == NULL) {
+    tError("failed to allocate memory to decompress msg, contLen:%d", contLen);
+    return NULL;
+  }
+
+  pNewHead = (SRpcHead *)(temp + sizeof(SRpcReqContext)); // reserve SRpcReqContext
+
+  int64_t st = taosGetTimestampUs();
+  int     origLen = rpcDecompress(pHead->comp, (char *)(pCont + overhead), compLen, (char *)pNewHead->content, contLen);
+  int64_t et = taosGetTimestampUs();
+
+  if (origLen != contLen) {
+    tError("failed to decompress rpc msg, codec:%d compLen:%d contLen:%d", pHead->comp, compLen, contLen);
+    free(temp);
+    return NULL;
+  }
+
+  atomic_add_fetch_64(&pRpc->compStat.decompMsgs, 1);
+  atomic_add_fetch_64(&pRpc->compStat.decompBytes, compLen + overhead);
+  atomic_add_fetch_64(&pRpc->compStat.decompRawBytes, contLen);
+  atomic_add_fetch_64(&pRpc->compStat.decompUs, et - st);
+
+  memcpy(pNewHead, pHead, sizeof(SRpcHead));
+  pNewHead->msgLen = rpcMsgLenFromCont(origLen);
+  rpcFreeMsg(pHead); // free the compressed message buffer
+  tTrace("decomp malloc mem:%p", temp);
+
+  return pNewHead;
 }
 
 static int rpcAuthenticateMsg(void *pMsg, int msgLen, void *pAuth, void *pKey) {
@@ -1556,35 +1704,45 @@ static int rpcAuthenticateMsg(void *pMsg, int msgLen, void *pAuth, void *pKey) {
   return ret;
 }
 
-static void rpcBuildAuthHead(void *pMsg, int msgLen, void *pAuth, void *pKey) {
+// the digest covers the message, the segments following it and the time stamp of the digest
+static void rpcBuildAuthHead(void *pMsg, int msgLen, const SRpcIov *pIov, int numOfIov, SRpcDigest *pDigest,
+                             void *pKey) {
   T_MD5_CTX context;
 
   tMD5Init(&context);
   tMD5Update(&context, (uint8_t *)pKey, TSDB_KEY_LEN);
   tMD5Update(&context, (uint8_t *)pMsg, msgLen);
+  for (int i = 0; i < numOfIov; ++i) {
+    tMD5Update(&context, (uint8_t *)pIov[i].pCont, pIov[i].contLen);
+  }
+  tMD5Update(&context, (uint8_t *)&pDigest->timeStamp, sizeof(pDigest->timeStamp));
   tMD5Update(&context, (uint8_t *)pKey, TSDB_KEY_LEN);
   tMD5Final(&context);
 
-  memcpy(pAuth, context.digest, sizeof(context.digest));
+  memcpy(pDigest->auth, context.digest, sizeof(context.digest));
 }
 
-static int rpcAddAuthPart(SRpcConn *pConn, char *msg, int msgLen) {
+// the digest is built in the space reserved after the content, the returned length includes the segments
+static int rpcAddAuthPart(SRpcConn *pConn, char *msg, int msgLen, const SRpcIov *pIov, int numOfIov) {
   SRpcHead *pHead = (SRpcHead *)msg;
+  int       totalLen = msgLen;
+
+  for (int i = 0; i < numOfIov; ++i) totalLen += pIov[i].contLen;
 
   if (pConn->spi && pConn->secured == 0) {
     // add auth part
     pHead->spi = pConn->spi;
     SRpcDigest *pDigest = (SRpcDigest *)(msg + msgLen);
     pDigest->timeStamp = htonl(taosGetTimestampSec());
-    msgLen += sizeof(SRpcDigest);
-    pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
-    rpcBuildAuthHead(pHead, msgLen - TSDB_AUTH_LEN, pDigest->auth, pConn->secret);
+    totalLen += sizeof(SRpcDigest);
+    pHead->msgLen = (int32_t)htonl((uint32_t)totalLen);
+    rpcBuildAuthHead(pHead, msgLen, pIov, numOfIov, pDigest, pConn->secret);
   } else {
     pHead->spi = 0;
-    pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
+    pHead->msgLen = (int32_t)htonl((uint32_t)totalLen);
   }
 
-  return msgLen;
+  return totalLen;
 }
 
 static int rpcCheckAuthentication(SRpcConn *pConn, char *msg, int msgLen) {
@@ -18,10 +18,19 @@
 #include "tutil.h"
 #include "taosdef.h"
 #include "taoserror.h"
+#include "tglobal.h"
 #include "rpcLog.h"
+#include "trpc.h"
 #include "rpcHead.h"
 #include "rpcTcp.h"
 
+#if defined(_TD_LINUX) && defined(SO_REUSEPORT)
+#define RPC_TCP_REUSE_PORT
+#endif
+
+#define RPC_TCP_ACCEPT_BATCH   64
+#define RPC_TCP_READ_BUF_SIZE  (64 * 1024)
+
 typedef struct SFdObj {
   void              *signature;
   SOCKET             fd;          // TCP socket FD
@@ -43,6 +52,11 @@ typedef struct SThreadObj {
   EpollFd         pollFd;
   int             numOfFds;
   int             threadId;
+  SOCKET          listenFd;  // listening socket owned by the thread in SO_REUSEPORT mode, otherwise -1
+  int8_t          stopAccept;  // set by taosStopTcpServer, then the thread closes its listening socket
+  char           *readBuf;   // data read from a socket at once, it is consumed before the next socket is processed
+  int32_t         readLen;
+  int32_t         readPos;
   char            label[TSDB_LABEL_LEN];
   void           *shandle;  // handle passed by upper layer during server initialization
   void           *(*processData)(SRecvInfo *pPacket);
@@ -61,6 +75,7 @@ typedef struct {
   uint16_t    port;
   int8_t      stop;
   int8_t      reserve;
+  int8_t      reusePort;  // each thread accepts the connections by its own listening socket
   char        label[TSDB_LABEL_LEN];
   int         numOfThreads;
   void *      shandle;
@@ -73,6 +88,10 @@ static SFdObj *taosMallocFdObj(SThreadObj *pThreadObj, SOCKET fd);
 static void    taosFreeFdObj(SFdObj *pFdObj);
 static void    taosReportBrokenLink(SFdObj *pFdObj);
 static void   *taosAcceptTcpConnection(void *arg);
+static int     taosOpenTcpListener(SServerObj *pServerObj, SThreadObj *pThreadObj);
+static void    taosCloseTcpListener(SThreadObj *pThreadObj);
+static void    taosAcceptTcpConnections(SThreadObj *pThreadObj);
+static void    taosSetupTcpConnection(SThreadObj *pThreadObj, SOCKET connFd, struct sockaddr_in *caddr);
 
 void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle) {
   SServerObj *pServerObj;
@@ -91,6 +110,17 @@ void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThread
   pServerObj->port = port;
   tstrncpy(pServerObj->label, label, sizeof(pServerObj->label));
   pServerObj->numOfThreads = numOfThreads;
+#ifdef RPC_TCP_REUSE_PORT
+  pServerObj->reusePort = tsRpcReusePort;
+
+  // the sockets of SO_REUSEPORT would join the listeners of another server on the port silently
+  if (pServerObj->reusePort && taosTcpPortInUse(ip, port)) {
+    tError("%s failed to init TCP server, port:%hu is already in use", label, port);
+    terrno = TAOS_SYSTEM_ERROR(EADDRINUSE);
+    free(pServerObj);
+    return NULL;
+  }
+#endif
 
   pServerObj->pThreadObj = (SThreadObj **)calloc(sizeof(SThreadObj *), numOfThreads);
   if (pServerObj->pThreadObj == NULL) {
@@ -119,6 +149,7 @@ void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThread
 
     pServerObj->pThreadObj[i] = pThreadObj;
     pThreadObj->pollFd = -1;
+    pThreadObj->listenFd = -1;
     taosResetPthread(&pThreadObj->thread);
     pThreadObj->processData = fp;
     tstrncpy(pThreadObj->label, label, sizeof(pThreadObj->label));
@@ -142,22 +173,30 @@ void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThread
       break;
     }
 
+    if (pServerObj->reusePort) {
+      code = taosOpenTcpListener(pServerObj, pThreadObj);
+      if (code != 0) break;
+    }
+
     code = pthread_create(&(pThreadObj->thread), &thattr, taosProcessTcpData, (void *)(pThreadObj));
     if (code != 0) {
       tError("%s failed to create TCP process data thread(%s)", label, strerror(errno));
+      if (pThreadObj->listenFd >= 0) taosCloseSocket(pThreadObj->listenFd);
       break;
     }
 
     pThreadObj->threadId = i;
   }
 
-  pServerObj->fd = taosOpenTcpServerSocket(pServerObj->ip, pServerObj->port);
-  if (pServerObj->fd < 0) code = -1;
+  if (code == 0 && !pServerObj->reusePort) {
+    pServerObj->fd = taosOpenTcpServerSocket(pServerObj->ip, pServerObj->port);
+    if (pServerObj->fd < 0) code = -1;
 
-  if (code == 0) {
-    code = pthread_create(&pServerObj->thread, &thattr, taosAcceptTcpConnection, (void *)pServerObj);
-    if (code != 0) {
-      tError("%s failed to create TCP accept thread(%s)", label, strerror(code));
+    if (code == 0) {
+      code = pthread_create(&pServerObj->thread, &thattr, taosAcceptTcpConnection, (void *)pServerObj);
+      if (code != 0) {
+        tError("%s failed to create TCP accept thread(%s)", label, strerror(code));
+      }
     }
   }
 
@@ -166,7 +205,8 @@ void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThread
     taosCleanUpTcpServer(pServerObj);
     pServerObj = NULL;
   } else {
-    tDebug("%s TCP server is initialized, ip:0x%x port:%hu numOfThreads:%d", label, ip, port, numOfThreads);
+    tDebug("%s TCP server is initialized, ip:0x%x port:%hu numOfThreads:%d reusePort:%d", label, ip, port,
+           numOfThreads, pServerObj->reusePort);
   }
 
   pthread_attr_destroy(&thattr);
@@ -194,6 +234,19 @@ void taosStopTcpServer(void *handle) {
   if (pServerObj == NULL) return;
   pServerObj->stop = 1;
 
+#ifdef RPC_TCP_REUSE_PORT
+  // the listening sockets are only touched by the threads owning them, so wait until each thread closes its socket
+  for (int i = 0; pServerObj->reusePort && i < pServerObj->numOfThreads; ++i) {
+    SThreadObj *pThreadObj = pServerObj->pThreadObj[i];
+    atomic_store_8(&pThreadObj->stopAccept, 1);
+    if (taosComparePthread(pThreadObj->thread, pthread_self())) taosCloseTcpListener(pThreadObj);
+  }
+
+  for (int i = 0; pServerObj->reusePort && i < pServerObj->numOfThreads; ++i) {
+    while (atomic_load_32(&pServerObj->pThreadObj[i]->listenFd) >= 0) taosMsleep(1);
+  }
+#endif
+
   if (pServerObj->fd >= 0) {
 #ifdef WINDOWS
     closesocket(pServerObj->fd);
@@ -262,31 +315,9 @@ static void *taosAcceptTcpConnection(void *arg) {
       continue;
     }
 
-    taosKeepTcpAlive(connFd);
-    struct timeval to={5, 0};
-    int32_t ret = taosSetSockOpt(connFd, SOL_SOCKET, SO_RCVTIMEO, &to, sizeof(to));
-    if (ret != 0) {
-      taosCloseSocket(connFd);
-      tError("%s failed to set recv timeout fd(%s)for connection from:%s:%hu", pServerObj->label, strerror(errno),
-             taosInetNtoa(caddr.sin_addr), htons(caddr.sin_port));
-      continue;
-    }
-
-
     // pick up the thread to handle this connection
     pThreadObj = pServerObj->pThreadObj[threadId];
-
-    SFdObj *pFdObj = taosMallocFdObj(pThreadObj, connFd);
-    if (pFdObj) {
-      pFdObj->ip = caddr.sin_addr.s_addr;
-      pFdObj->port = htons(caddr.sin_port);
-      tDebug("%s new TCP connection from %s:%hu, fd:%d FD:%p numOfFds:%d", pServerObj->label,
-              taosInetNtoa(caddr.sin_addr), pFdObj->port, connFd, pFdObj, pThreadObj->numOfFds);
-    } else {
-      taosCloseSocket(connFd);
-      tError("%s failed to malloc FdObj(%s) for connection from:%s:%hu", pServerObj->label, strerror(errno),
-             taosInetNtoa(caddr.sin_addr), htons(caddr.sin_port));
-    }
+    taosSetupTcpConnection(pThreadObj, connFd, &caddr);
 
     // pick up next thread for next connection
     threadId++;
@@ -297,6 +328,90 @@ static void *taosAcceptTcpConnection(void *arg) {
   return NULL;
 }
 
+static void taosSetupTcpConnection(SThreadObj *pThreadObj, SOCKET connFd, struct sockaddr_in *caddr) {
+  taosKeepTcpAlive(connFd);
+  struct timeval to={5, 0};
+  int32_t ret = taosSetSockOpt(connFd, SOL_SOCKET, SO_RCVTIMEO, &to, sizeof(to));
+  if (ret != 0) {
+    taosCloseSocket(connFd);
+    tError("%s failed to set recv timeout fd(%s)for connection from:%s:%hu", pThreadObj->label, strerror(errno),
+           taosInetNtoa(caddr->sin_addr), htons(caddr->sin_port));
+    return;
+  }
+
+  SFdObj *pFdObj = taosMallocFdObj(pThreadObj, connFd);
+  if (pFdObj) {
+    pFdObj->ip = caddr->sin_addr.s_addr;
+    pFdObj->port = htons(caddr->sin_port);
+    tDebug("%s new TCP connection from %s:%hu, fd:%d FD:%p numOfFds:%d", pThreadObj->label,
+            taosInetNtoa(caddr->sin_addr), pFdObj->port, connFd, pFdObj, pThreadObj->numOfFds);
+  } else {
+    taosCloseSocket(connFd);
+    tError("%s failed to malloc FdObj(%s) for connection from:%s:%hu", pThreadObj->label, strerror(errno),
+           taosInetNtoa(caddr->sin_addr), htons(caddr->sin_port));
+  }
+}
+
+// the listening socket is non-blocking and watched by the epoll of the thread, it is marked by the thread object
+static int taosOpenTcpListener(SServerObj *pServerObj, SThreadObj *pThreadObj) {
+#ifdef RPC_TCP_REUSE_PORT
+  struct epoll_event event;
+
+  SOCKET fd = taosOpenTcpReusePortSocket(pServerObj->ip, pServerObj->port);
+  if (fd < 0) return -1;
+
+  if (taosSetNonblocking(fd, 1) != 0) {
+    taosCloseSocket(fd);
+    return -1;
+  }
+
+  event.events = EPOLLIN;
+  event.data.ptr = pThreadObj;
+  if (epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    tError("%s failed to add TCP listening socket into epoll(%s)", pServerObj->label, strerror(errno));
+    taosCloseSocket(fd);
+    return -1;
+  }
+
+  pThreadObj->listenFd = fd;
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+static void taosCloseTcpListener(SThreadObj *pThreadObj) {
+#ifdef RPC_TCP_REUSE_PORT
+  SOCKET fd = pThreadObj->listenFd;
+  if (fd < 0) return;
+
+  epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_DEL, fd, NULL);
+  taosCloseSocket(fd);
+  atomic_store_32(&pThreadObj->listenFd, -1);
+#endif
+}
+
+static void taosAcceptTcpConnections(SThreadObj *pThreadObj) {
+  struct sockaddr_in caddr;
+
+  if (pThreadObj->listenFd < 0) return;
+
+  // at most a batch at a time, so the data of connections already accepted are not delayed by a connection storm
+  for (int i = 0; i < RPC_TCP_ACCEPT_BATCH; ++i) {
+    socklen_t addrlen = sizeof(caddr);
+    SOCKET    connFd = accept(pThreadObj->listenFd, (struct sockaddr *)&caddr, &addrlen);
+    if (connFd == -1) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINVAL) {
+        tError("%s TCP accept failure(%s)", pThreadObj->label, strerror(errno));
+      }
+      break;
+    }
+
+    taosSetupTcpConnection(pThreadObj, connFd, &caddr);
+  }
+}
+
 void *taosInitTcpClient(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle) {
   SClientObj *pClientObj = (SClientObj *)calloc(1, sizeof(SClientObj));
   if (pClientObj == NULL) {
@@ -331,6 +446,7 @@ void *taosInitTcpClient(uint32_t ip, uint16_t port, char *label, int numOfThread
     }
     pClientObj->pThreadObj[i] = pThreadObj;
     taosResetPthread(&pThreadObj->thread);
+    pThreadObj->listenFd = -1;
     pThreadObj->ip      = ip;
     pThreadObj->stop    = false;
     tstrncpy(pThreadObj->label, label, sizeof(pThreadObj->label));
@@ -450,6 +566,40 @@ int taosSendTcpData(uint32_t ip, uint16_t port, void *data, int len, void *chand
   return ret;
 }
 
+int taosSendTcpDataV(SRpcIov *pIov, int numOfIov, void *chandle) {
+  SFdObj *pFdObj = chandle;
+  if (pFdObj == NULL || pFdObj->signature != pFdObj) return -1;
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+  int         ret = 0;
+
+#ifdef WINDOWS
+  for (int i = 0; i < numOfIov; ++i) {
+    int len = taosWriteMsg(pFdObj->fd, pIov[i].pCont, pIov[i].contLen);
+    if (len != pIov[i].contLen) {
+      ret = -1;
+      break;
+    }
+    ret += len;
+  }
+#else
+  struct iovec *iov = malloc(sizeof(struct iovec) * numOfIov);
+  if (iov == NULL) return -1;
+
+  for (int i = 0; i < numOfIov; ++i) {
+    iov[i].iov_base = pIov[i].pCont;
+    iov[i].iov_len = (size_t)pIov[i].contLen;
+  }
+
+  ret = taosWriteMsgV(pFdObj->fd, iov, numOfIov);
+  free(iov);
+#endif
+
+  tTrace("%s %p TCP data is sent in %d segments, FD:%p fd:%d bytes:%d", pThreadObj->label, pFdObj->thandle, numOfIov,
+         pFdObj, pFdObj->fd, ret);
+
+  return ret;
+}
+
 static void taosReportBrokenLink(SFdObj *pFdObj) {
 
   SThreadObj *pThreadObj = pFdObj->pThreadObj;
@@ -473,6 +623,40 @@ static void taosReportBrokenLink(SFdObj *pFdObj) {
   taosFreeFdObj(pFdObj);
 }
 
+/*
+ * The messages are read from the buffer of the thread first. If more data is needed, as much data as the socket has
+ * is read into the buffer by one call, so several small messages arrived together are read by one system call.
+ */
+static int32_t taosReadTcpBuf(SFdObj *pFdObj, char *buf, int32_t len) {
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+  int32_t     nread = 0;
+
+  while (nread < len) {
+    int32_t left = pThreadObj->readLen - pThreadObj->readPos;
+    if (left > 0) {
+      int32_t n = MIN(left, len - nread);
+      memcpy(buf + nread, pThreadObj->readBuf + pThreadObj->readPos, n);
+      pThreadObj->readPos += n;
+      nread += n;
+      continue;
+    }
+
+    if (pThreadObj->readBuf == NULL || len - nread >= RPC_TCP_READ_BUF_SIZE) {
+      int32_t ret = taosReadMsg(pFdObj->fd, buf + nread, len - nread);
+      return (ret < 0) ? ret : nread + ret;
+    }
+
+    int32_t ret = (int32_t)taosReadSocket(pFdObj->fd, pThreadObj->readBuf, RPC_TCP_READ_BUF_SIZE);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) return (ret < 0) ? ret : nread;
+
+    pThreadObj->readPos = 0;
+    pThreadObj->readLen = ret;
+  }
+
+  return nread;
+}
+
 static int taosReadTcpData(SFdObj *pFdObj, SRecvInfo *pInfo) {
   SRpcHead    rpcHead;
   int32_t     msgLen, leftLen, retLen, headLen;
@@ -480,7 +664,7 @@ static int taosReadTcpData(SFdObj *pFdObj, SRecvInfo *pInfo) {
 
   SThreadObj *pThreadObj = pFdObj->pThreadObj;
 
-  headLen = taosReadMsg(pFdObj->fd, &rpcHead, sizeof(SRpcHead));
+  headLen = taosReadTcpBuf(pFdObj, (char *)&rpcHead, sizeof(SRpcHead));
   if (headLen != sizeof(SRpcHead)) {
     tDebug("%s %p read error, FD:%p headLen:%d", pThreadObj->label, pFdObj->thandle, pFdObj, headLen);
     return -1;
@@ -504,7 +688,7 @@ static int taosReadTcpData(SFdObj *pFdObj, SRecvInfo *pInfo) {
 
   msg = buffer + tsRpcOverhead;
   leftLen = msgLen - headLen;
-  retLen = taosReadMsg(pFdObj->fd, msg + headLen, leftLen);
+  retLen = taosReadTcpBuf(pFdObj, msg + headLen, leftLen);
 
   if (leftLen != retLen) {
     tError("%s %p read error, leftLen:%d retLen:%d FD:%p",
@@ -544,15 +728,23 @@ static void *taosProcessTcpData(void *param) {
   snprintf(name, tListLen(name), "%s-tcp", pThreadObj->label);
   setThreadName(name);
 
+  pThreadObj->readBuf = malloc(RPC_TCP_READ_BUF_SIZE);
+
   while (1) {
     int fdNum = epoll_wait(pThreadObj->pollFd, events, maxEvents, TAOS_EPOLL_WAIT_TIME);
     if (pThreadObj->stop) {
       tDebug("%s TCP thread get stop event, exiting...", pThreadObj->label);
       break;
     }
+    if (atomic_load_8(&pThreadObj->stopAccept)) taosCloseTcpListener(pThreadObj);
     if (fdNum < 0) continue;
 
     for (int i = 0; i < fdNum; ++i) {
+      if (events[i].data.ptr == pThreadObj) {
+        taosAcceptTcpConnections(pThreadObj);
+        continue;
+      }
+
       pFdObj = events[i].data.ptr;
 
       if (events[i].events & EPOLLERR) {
@@ -573,18 +765,27 @@ static void *taosProcessTcpData(void *param) {
         continue;
       }
 
-      if (taosReadTcpData(pFdObj, &recvInfo) < 0) {
-        shutdown(pFdObj->fd, SHUT_WR);
-        continue;
-      }
-
-      pFdObj->thandle = (*(pThreadObj->processData))(&recvInfo);
-      if (pFdObj->thandle == NULL) taosFreeFdObj(pFdObj);
+      // the messages already in the buffer are processed, since epoll does not report them again
+      pThreadObj->readPos = pThreadObj->readLen = 0;
+      do {
+        if (taosReadTcpData(pFdObj, &recvInfo) < 0) {
+          shutdown(pFdObj->fd, SHUT_WR);
+          break;
+        }
+
+        pFdObj->thandle = (*(pThreadObj->processData))(&recvInfo);
+        if (pFdObj->thandle == NULL) {
+          taosFreeFdObj(pFdObj);
+          break;
+        }
+      } while (pThreadObj->readPos < pThreadObj->readLen);
     }
 
     if (pThreadObj->stop) break;
   }
 
+  taosCloseTcpListener(pThreadObj);
+
   if (pThreadObj->pollFd >=0) {
     EpollClose(pThreadObj->pollFd);
     pThreadObj->pollFd = -1;
@@ -598,6 +799,7 @@ static void *taosProcessTcpData(void *param) {
 
   pthread_mutex_destroy(&(pThreadObj->mutex));
   tDebug("%s TCP thread exits ...", pThreadObj->label);
+  tfree(pThreadObj->readBuf);
   tfree(pThreadObj);
 
   return NULL;
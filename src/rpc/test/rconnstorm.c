@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Connection storm against rserver: every app thread opens its share of the TCP connections at once, like the
+ * collectors reconnecting after a network failure, and each connection sends one request and waits for its response.
+ * The connections are kept open until all of them are answered. Run rserver with user "jeff", which needs no
+ * authentication, and enough sessions, e.g. "rserver -s 10000 -t 8 [-r]".
+ */
+
+#include "os.h"
+#include "tutil.h"
+#include "tglobal.h"
+#include "tsocket.h"
+#include "rpcLog.h"
+#include "rpcHead.h"
+#include "trpc.h"
+
+typedef struct {
+  int       index;
+  int       numOfConns;
+  int       msgSize;
+  uint32_t  ip;
+  uint16_t  port;
+  SOCKET   *fds;
+  int       succ;
+  int       failed;
+  int64_t   maxUs;
+  int64_t   totalUs;
+  pthread_t thread;
+} SInfo;
+
+static int sendRequest(SInfo *pInfo, SOCKET fd, uint32_t linkUid) {
+  int       msgLen = sizeof(SRpcHead) + pInfo->msgSize;
+  char     *msg = calloc(1, msgLen);
+  SRpcHead *pHead = (SRpcHead *)msg;
+
+  if (msg == NULL) return -1;
+
+  pHead->version = 1;
+  pHead->msgVer = htonl(tsVersion >> 8);
+  pHead->msgType = 1;
+  pHead->tranId = 1;
+  pHead->linkUid = linkUid;
+  pHead->sourceId = htonl(linkUid);
+  pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
+  tstrncpy(pHead->user, "jeff", sizeof(pHead->user));
+
+  int ret = taosWriteMsg(fd, msg, msgLen);
+  free(msg);
+
+  return (ret == msgLen) ? 0 : -1;
+}
+
+static int recvResponse(SOCKET fd) {
+  SRpcHead head;
+  char     buf[1024];
+
+  if (taosReadMsg(fd, &head, sizeof(head)) != sizeof(head)) return -1;
+
+  int left = (int32_t)htonl((uint32_t)head.msgLen) - (int)sizeof(head);
+  while (left > 0) {
+    int len = taosReadMsg(fd, buf, MIN(left, (int)sizeof(buf)));
+    if (len <= 0) return -1;
+    left -= len;
+  }
+
+  return 0;
+}
+
+static void *connectServer(void *param) {
+  SInfo *pInfo = param;
+
+  for (int i = 0; i < pInfo->numOfConns; ++i) {
+    int64_t st = taosGetTimestampUs();
+
+    SOCKET fd = taosOpenTcpClientSocket(pInfo->ip, pInfo->port, 0);
+    if (fd <= 0) {
+      pInfo->failed++;
+      continue;
+    }
+
+    pInfo->fds[i] = fd;
+    if (sendRequest(pInfo, fd, (uint32_t)(pInfo->index << 20 | i) + 1) < 0 || recvResponse(fd) < 0) {
+      pInfo->failed++;
+      continue;
+    }
+
+    int64_t us = taosGetTimestampUs() - st;
+    pInfo->succ++;
+    pInfo->totalUs += us;
+    if (us > pInfo->maxUs) pInfo->maxUs = us;
+  }
+
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  char serverIp[40] = "127.0.0.1";
+  int  port = 7000;
+  int  numOfConns = 5000;
+  int  appThreads = 16;
+  int  msgSize = 128;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-i") == 0 && i < argc - 1) {
+      tstrncpy(serverIp, argv[++i], sizeof(serverIp));
+    } else if (strcmp(argv[i], "-c") == 0 && i < argc - 1) {
+      numOfConns = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-a") == 0 && i < argc - 1) {
+      appThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      msgSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-d") == 0 && i < argc - 1) {
+      rpcDebugFlag = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-i ip]: server IP address, default is:%s\n", serverIp);
+      printf("  [-p port]: server port number, default is:%d\n", port);
+      printf("  [-c connections]: number of connections, default is:%d\n", numOfConns);
+      printf("  [-a threads]: number of app threads, default is:%d\n", appThreads);
+      printf("  [-m msgSize]: message body size, default is:%d\n", msgSize);
+      printf("  [-d debugFlag]: debug flag, default:%d\n", rpcDebugFlag);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  if (appThreads <= 0 || numOfConns < appThreads) appThreads = 1;
+
+  taosInitLog("storm.log", 100000, 10);
+  taosBlockSIGPIPE();
+  taosInitGlobalCfg();
+  taosCheckGlobalCfg();
+
+  SInfo *pInfos = calloc(appThreads, sizeof(SInfo));
+  if (pInfos == NULL) return -1;
+
+  int64_t startTime = taosGetTimestampUs();
+
+  for (int i = 0; i < appThreads; ++i) {
+    SInfo *pInfo = pInfos + i;
+    pInfo->index = i;
+    pInfo->numOfConns = numOfConns / appThreads + (i < numOfConns % appThreads ? 1 : 0);
+    pInfo->msgSize = msgSize;
+    pInfo->ip = taosInetAddr(serverIp);
+    pInfo->port = (uint16_t)port;
+    pInfo->fds = calloc(pInfo->numOfConns, sizeof(SOCKET));
+    pthread_create(&pInfo->thread, NULL, connectServer, pInfo);
+  }
+
+  int     succ = 0, failed = 0;
+  int64_t maxUs = 0, totalUs = 0;
+  for (int i = 0; i < appThreads; ++i) {
+    SInfo *pInfo = pInfos + i;
+    pthread_join(pInfo->thread, NULL);
+    succ += pInfo->succ;
+    failed += pInfo->failed;
+    totalUs += pInfo->totalUs;
+    if (pInfo->maxUs > maxUs) maxUs = pInfo->maxUs;
+  }
+
+  float usedTime = (taosGetTimestampUs() - startTime) / 1000.0f;  // mseconds
+
+  printf("%d connections are answered, %d failed, it takes %.3f mseconds, %.1f connections per second\n", succ, failed,
+         usedTime, 1000.0 * succ / usedTime);
+  printf("latency from connecting to response, avg:%.3f ms max:%.3f ms\n", succ ? totalUs / 1000.0 / succ : 0.0,
+         maxUs / 1000.0);
+
+  for (int i = 0; i < appThreads; ++i) {
+    for (int j = 0; j < pInfos[i].numOfConns; ++j) {
+      if (pInfos[i].fds[j] > 0) taosCloseSocket(pInfos[i].fds[j]);
+    }
+    free(pInfos[i].fds);
+  }
+
+  free(pInfos);
+  taosCloseLog();
+
+  return 0;
+}
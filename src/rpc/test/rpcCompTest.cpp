@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+#include "taosmsg.h"
+#include "tglobal.h"
+#include "trpc.h"
+#include "rpcHead.h"
+#include "rpcComp.h"
+
+namespace {
+
+// compressible payload, which looks like the rows of a retrieve response
+std::vector<char> makePayload(int32_t len) {
+  std::vector<char> src(len);
+  std::mt19937      rng(20211018);
+  for (int32_t i = 0; i < len; ++i) {
+    src[i] = (char)((i % 64 < 48) ? (i / 64) % 7 : rng() % 256);
+  }
+  return src;
+}
+
+void roundTrip(int8_t codec, int32_t len) {
+  std::vector<char> src = makePayload(len);
+  std::vector<char> comp(len);
+  std::vector<char> dst(len);
+
+  int32_t compLen = rpcCompress(codec, src.data(), len, comp.data(), len);
+  ASSERT_GT(compLen, 0);
+  ASSERT_LT(compLen, len);
+
+  ASSERT_EQ(rpcDecompress(codec, comp.data(), compLen, dst.data(), len), len);
+  ASSERT_EQ(memcmp(src.data(), dst.data(), len), 0);
+
+  // the destination may overlap with the source, as it does in rpcCompressRpcMsg
+  std::vector<char> inPlace = src;
+  compLen = rpcCompress(codec, inPlace.data(), len, inPlace.data() + sizeof(SRpcComp), len - sizeof(SRpcComp));
+  ASSERT_GT(compLen, 0);
+  ASSERT_EQ(rpcDecompress(codec, inPlace.data() + sizeof(SRpcComp), compLen, dst.data(), len), len);
+  ASSERT_EQ(memcmp(src.data(), dst.data(), len), 0);
+
+  // the data is not compressed if it does not get smaller
+  ASSERT_EQ(rpcCompress(codec, src.data(), len, comp.data(), compLen), 0);
+}
+
+void corrupted(int8_t codec) {
+  int32_t           len = 64 * 1024;
+  std::vector<char> src = makePayload(len);
+  std::vector<char> comp(len);
+  std::vector<char> dst(len);
+
+  int32_t compLen = rpcCompress(codec, src.data(), len, comp.data(), len);
+  ASSERT_GT(compLen, 0);
+
+  // a truncated message and a too small original length are both detected
+  ASSERT_NE(rpcDecompress(codec, comp.data(), compLen / 2, dst.data(), len), len);
+  ASSERT_EQ(rpcDecompress(codec, comp.data(), compLen, dst.data(), len / 2), -1);
+
+  std::vector<char> garbage(128, (char)0xff);
+  ASSERT_EQ(rpcDecompress(codec, garbage.data(), (int32_t)garbage.size(), dst.data(), len), -1);
+}
+
+bool hasZstd() { return (rpcCompCodecs() & RPC_COMP_CODEC_BIT(RPC_COMP_ZSTD)) != 0; }
+
+void noopProcessMsg(SRpcMsg *pMsg, SRpcEpSet *pEpSet) { rpcFreeCont(pMsg->pCont); }
+
+}  // namespace
+
+TEST(rpcCompTest, lz4_round_trip) {
+  roundTrip(RPC_COMP_LZ4, 1024);
+  roundTrip(RPC_COMP_LZ4, 1024 * 1024);
+
+  tsRpcLz4Acceleration = 1000;
+  roundTrip(RPC_COMP_LZ4, 1024 * 1024);
+  tsRpcLz4Acceleration = 1;
+}
+
+TEST(rpcCompTest, zstd_round_trip) {
+  if (!hasZstd()) {
+    std::cout << "zstd is not built in, skipped" << std::endl;
+    return;
+  }
+
+  roundTrip(RPC_COMP_ZSTD, 1024);
+  roundTrip(RPC_COMP_ZSTD, 1024 * 1024);
+
+  tsRpcZstdLevel = 12;
+  roundTrip(RPC_COMP_ZSTD, 1024 * 1024);
+  tsRpcZstdLevel = 3;
+}
+
+TEST(rpcCompTest, level_per_codec) {
+  tsRpcLz4Acceleration = 0;
+  tsRpcZstdLevel = 9;
+  EXPECT_EQ(rpcCompLevel(RPC_COMP_LZ4), RPC_COMP_LZ4_ACCEL_MIN);
+  if (hasZstd()) {
+    EXPECT_EQ(rpcCompLevel(RPC_COMP_ZSTD), 9);
+  }
+
+  tsRpcLz4Acceleration = 100000;
+  tsRpcZstdLevel = 100;
+  EXPECT_EQ(rpcCompLevel(RPC_COMP_LZ4), RPC_COMP_LZ4_ACCEL_MAX);
+  if (hasZstd()) {
+    EXPECT_EQ(rpcCompLevel(RPC_COMP_ZSTD), 22);
+  }
+
+  EXPECT_EQ(rpcCompLevel(RPC_COMP_NONE), 0);
+
+  tsRpcLz4Acceleration = 1;
+  tsRpcZstdLevel = 3;
+}
+
+TEST(rpcCompTest, select_codec) {
+  int8_t codec = tsRpcCompressCodec;
+
+  tsRpcCompressCodec = RPC_COMP_ZSTD;
+  EXPECT_EQ(rpcCompSelectCodec(0), RPC_COMP_LZ4);  // old peers
+  EXPECT_EQ(rpcCompSelectCodec(RPC_COMP_CODEC_BIT(RPC_COMP_LZ4)), RPC_COMP_LZ4);
+  EXPECT_EQ(rpcCompSelectCodec(rpcCompCodecs()), hasZstd() ? RPC_COMP_ZSTD : RPC_COMP_LZ4);
+
+  tsRpcCompressCodec = codec;
+}
+
+TEST(rpcCompTest, decompress_failure) {
+  corrupted(RPC_COMP_LZ4);
+  if (hasZstd()) corrupted(RPC_COMP_ZSTD);
+
+  std::vector<char> dst(64);
+  EXPECT_EQ(rpcDecompress(RPC_COMP_NONE, dst.data(), 8, dst.data(), 64), -1);
+  EXPECT_EQ(rpcDecompress(7, dst.data(), 8, dst.data(), 64), -1);
+}
+
+// a request whose content can not be decompressed is answered with TSDB_CODE_RPC_INVALID_VALUE
+TEST(rpcCompTest, corrupted_request_rejected) {
+  const uint16_t port = 7371;
+
+  tsVersion = (2u << 24) | (4u << 16);
+  rpcInit();
+
+  SRpcInit init;
+  memset(&init, 0, sizeof(init));
+  init.localPort = port;
+  init.label = (char *)"CSVR";
+  init.numOfThreads = 1;
+  init.cfp = noopProcessMsg;
+  init.sessions = 10;
+  init.connType = TAOS_CONN_SERVER;
+  init.idleTime = 2000;
+
+  void *pRpc = rpcOpen(&init);
+  ASSERT_NE(pRpc, nullptr);
+
+  char      msg[sizeof(SRpcHead) + sizeof(SRpcComp) + 64];
+  SRpcHead *pHead = (SRpcHead *)msg;
+  memset(msg, 0, sizeof(msg));
+  pHead->version = 1;
+  pHead->comp = RPC_COMP_LZ4;
+  pHead->tranId = htons(1);
+  pHead->linkUid = htonl(1);
+  pHead->ahandle = 1;
+  pHead->sourceId = htonl(1);
+  pHead->codecs = rpcCompCodecs();
+  pHead->msgType = TSDB_MSG_TYPE_QUERY;
+  pHead->msgLen = (int32_t)htonl(sizeof(msg));
+  pHead->msgVer = htonl(tsVersion >> 8);
+  tstrncpy(pHead->user, "root", sizeof(pHead->user));
+
+  SRpcComp *pComp = (SRpcComp *)pHead->content;
+  pComp->contLen = htonl(1024);
+  memset(pHead->content + sizeof(SRpcComp), 0xff, 64);
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_GE(fd, 0);
+
+  struct timeval tv = {5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(sendto(fd, msg, sizeof(msg), 0, (struct sockaddr *)&addr, sizeof(addr)), (ssize_t)sizeof(msg));
+
+  char    rsp[1024];
+  ssize_t rspLen = recv(fd, rsp, sizeof(rsp), 0);
+  ASSERT_GE(rspLen, (ssize_t)sizeof(SRpcHead));
+
+  SRpcHead *pRspHead = (SRpcHead *)rsp;
+  EXPECT_EQ(pRspHead->msgType, TSDB_MSG_TYPE_QUERY + 1);
+  EXPECT_EQ(pRspHead->tranId, pHead->tranId);
+  EXPECT_EQ((int32_t)htonl(pRspHead->code), TSDB_CODE_RPC_INVALID_VALUE);
+
+  close(fd);
+  rpcClose(pRpc);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tglobal.h"
+#include "tsocket.h"
+#include "trpc.h"
+#include "rpcHead.h"
+#include "rpcTcp.h"
+
+namespace {
+
+// the connections carry no message in the test, so only the broken links are reported
+void *processTcpData(SRecvInfo *pRecv) { return NULL; }
+
+void *openServer(uint16_t port, int numOfThreads) {
+  return taosInitTcpServer(0, port, (char *)"TSVR", numOfThreads, (void *)processTcpData, NULL);
+}
+
+bool canConnect(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  bool ok = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+  close(fd);
+  return ok;
+}
+
+}  // namespace
+
+#if defined(_TD_LINUX) && defined(SO_REUSEPORT)
+TEST(rpcTcpTest, reuse_port_listener) {
+  const uint16_t port = 7381;
+  int8_t         reusePort = tsRpcReusePort;
+
+  tsRpcReusePort = 1;
+  EXPECT_FALSE(taosTcpPortInUse(0, port));
+
+  void *pServer = openServer(port, 4);
+  ASSERT_NE(pServer, nullptr);
+  EXPECT_TRUE(taosTcpPortInUse(0, port));
+  EXPECT_TRUE(canConnect(port));
+
+  // another server on the same port is rejected, instead of sharing the connections silently
+  void *pOther = openServer(port, 2);
+  EXPECT_EQ(pOther, nullptr);
+  if (pOther != nullptr) {
+    taosStopTcpServer(pOther);
+    taosCleanUpTcpServer(pOther);
+  }
+
+  // the listening sockets of all threads are closed once the server is stopped
+  taosStopTcpServer(pServer);
+  EXPECT_FALSE(taosTcpPortInUse(0, port));
+  EXPECT_FALSE(canConnect(port));
+  taosCleanUpTcpServer(pServer);
+
+  pServer = openServer(port, 2);
+  ASSERT_NE(pServer, nullptr);
+  EXPECT_TRUE(canConnect(port));
+  taosStopTcpServer(pServer);
+  taosCleanUpTcpServer(pServer);
+
+  tsRpcReusePort = reusePort;
+}
+#endif
@@ -113,6 +113,13 @@ void processRequestMsg(SRpcMsg *pMsg, SRpcEpSet *pEpSet) {
   taosWriteQitem(qhandle, TAOS_QTYPE_RPC, pTemp); 
 }
 
+// the version of the requests is checked, and the message buffers are allocated with the rpc overhead
+static void initRpcEnv() {
+  taosInitGlobalCfg();
+  taosCheckGlobalCfg();
+  rpcInit();
+}
+
 int main(int argc, char *argv[]) {
   SRpcInit rpcInit;
   char     dataName[20] = "server.data";
@@ -141,6 +148,8 @@ int main(int argc, char *argv[]) {
       tsCompressMsgSize = atoi(argv[++i]);
     } else if (strcmp(argv[i], "-w")==0 && i < argc-1) {
       commit = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r")==0) {
+      tsRpcReusePort = 1;
     } else if (strcmp(argv[i], "-d")==0 && i < argc-1) {
       rpcDebugFlag = atoi(argv[++i]);
       dDebugFlag = rpcDebugFlag;
@@ -153,6 +162,7 @@ int main(int argc, char *argv[]) {
       printf("  [-m msgSize]: message body size, default is:%d\n", msgSize);
       printf("  [-o compSize]: compression message size, default is:%d\n", tsCompressMsgSize);
       printf("  [-w write]: write received data to file(0, 1, 2), default is:%d\n", commit);
+      printf("  [-r]: accept connections by a SO_REUSEPORT socket in each thread, default is:%d\n", tsRpcReusePort);
       printf("  [-d debugFlag]: debug flag, default:%d\n", rpcDebugFlag);
       printf("  [-h help]: print out this help\n\n");
       exit(0);
@@ -162,6 +172,7 @@ int main(int argc, char *argv[]) {
   tsAsyncLog = 0;
   rpcInit.connType = TAOS_CONN_SERVER;
   taosInitLog("server.log", 100000, 10);
+  initRpcEnv();
 
   void *pRpc = rpcOpen(&rpcInit);
   if (pRpc == NULL) {
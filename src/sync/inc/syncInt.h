@@ -35,7 +35,8 @@ extern "C" {
 #define SYNC_MAX_SIZE (TSDB_MAX_WAL_SIZE + sizeof(SWalHead) + sizeof(SSyncHead) + 16)
 #define SYNC_RECV_BUFFER_SIZE (5*1024*1024)
 
-#define SYNC_MAX_FWDS 4096
+#define SYNC_MAX_FWDS 4096              // window of the forwards in flight
+#define SYNC_FWD_BATCH_SIZE (64 * 1024)  // initial size of the forward batch, it grows up to TSDB_MAX_WAL_SIZE
 #define SYNC_FWD_TIMER 300
 #define SYNC_ROLE_TIMER 15000             // ms
 #define SYNC_CHECK_INTERVAL 1000          // ms
@@ -59,6 +60,7 @@ typedef struct {
   int8_t    acks;
   int8_t    nacks;
   int8_t    confirmed;
+  uint8_t   ackPeers;  // fwdBit of each peer which has acked the version
   int32_t   code;
   int64_t   time;
 } SFwdInfo;
@@ -70,6 +72,15 @@ typedef struct {
   SFwdInfo fwdInfo[];
 } SSyncFwds;
 
+// forwards sent in one frame, each one is a TAOS_SMSG_SYNC_FWD msg padded to 8 bytes
+typedef struct {
+  char *   buffer;    // starts with the sync head of the frame
+  int32_t  size;
+  int32_t  len;       // content length, does not include sync head
+  int32_t  forwards;
+  uint64_t version;   // version of the last WAL head
+} SFwdBatch;
+
 typedef struct SsyncPeer {
   int32_t  nodeId;
   uint32_t ip;
@@ -88,6 +99,8 @@ typedef struct SsyncPeer {
   int32_t  fileChanged;     // a flag to indicate file is changed during retrieving process
   int32_t  refCount;
   int8_t   isArb;
+  int8_t   features;        // SYNC_FEATURE_* of the peer, reset once the connection is closed
+  uint8_t  fwdBit;          // stays the same across reconfig, so that pending acks are not mixed up
   int64_t  rid;
   void *   timer;
   void *   pConn;
@@ -106,6 +119,9 @@ typedef struct SSyncNode {
   SSyncPeer *  pMaster;
   SRecvBuffer *pRecv;
   SSyncFwds *  pSyncFwds;  // saved forward info if quorum >1
+  SFwdBatch *  pFwdBatch;  // forwards not sent yet
+  int8_t       batching;   // forwards are kept in batch until it is flushed
+  uint8_t      fwdBits;    // fwdBit allocated to the peers
   void *       pFwdTimer;
   void *       pRoleTimer;
   void *       pTsdb;
@@ -136,6 +152,13 @@ uint32_t   syncResolvePeerFqdn(SSyncPeer *pPeer);
 SSyncPeer *syncAcquirePeer(int64_t rid);
 void       syncReleasePeer(SSyncPeer *pPeer);
 
+// forward window and batch, the mutex of node shall be held
+void       syncAllocFwdBit(SSyncNode *pNode, SSyncPeer *pPeer);
+void       syncFreeFwdBit(SSyncNode *pNode, SSyncPeer *pPeer);
+int32_t    syncSaveFwdInfo(SSyncNode *pNode, uint64_t version, void *mhandle);
+void       syncProcessFwdAcks(SSyncNode *pNode, uint8_t fwdBit, uint64_t version, int32_t code);
+int32_t    syncAddIntoFwdBatch(SSyncNode *pNode, SWalHead *pWalHead);
+
 #ifdef __cplusplus
 }
 #endif
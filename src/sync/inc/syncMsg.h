@@ -22,23 +22,24 @@ extern "C" {
 #include "tsync.h"
 
 typedef enum {
-  TAOS_SMSG_START         = 0,
-  TAOS_SMSG_SYNC_DATA     = 1,
-  TAOS_SMSG_SYNC_DATA_RSP = 2,
-  TAOS_SMSG_SYNC_FWD      = 3,
-  TAOS_SMSG_SYNC_FWD_RSP  = 4,
-  TAOS_SMSG_SYNC_REQ      = 5,
-  TAOS_SMSG_SYNC_REQ_RSP  = 6,
-  TAOS_SMSG_SYNC_MUST     = 7,
-  TAOS_SMSG_SYNC_MUST_RSP = 8,
-  TAOS_SMSG_STATUS        = 9,
-  TAOS_SMSG_STATUS_RSP    = 10,
-  TAOS_SMSG_SETUP         = 11,
-  TAOS_SMSG_SETUP_RSP     = 12,
-  TAOS_SMSG_SYNC_FILE     = 13,
-  TAOS_SMSG_SYNC_FILE_RSP = 14,
-  TAOS_SMSG_TEST          = 15,
-  TAOS_SMSG_END           = 16
+  TAOS_SMSG_START          = 0,
+  TAOS_SMSG_SYNC_DATA      = 1,
+  TAOS_SMSG_SYNC_DATA_RSP  = 2,
+  TAOS_SMSG_SYNC_FWD       = 3,
+  TAOS_SMSG_SYNC_FWD_RSP   = 4,
+  TAOS_SMSG_SYNC_REQ       = 5,
+  TAOS_SMSG_SYNC_REQ_RSP   = 6,
+  TAOS_SMSG_SYNC_MUST      = 7,
+  TAOS_SMSG_SYNC_MUST_RSP  = 8,
+  TAOS_SMSG_STATUS         = 9,
+  TAOS_SMSG_STATUS_RSP     = 10,
+  TAOS_SMSG_SETUP          = 11,
+  TAOS_SMSG_SETUP_RSP      = 12,
+  TAOS_SMSG_SYNC_FILE      = 13,
+  TAOS_SMSG_SYNC_FILE_RSP  = 14,
+  TAOS_SMSG_TEST           = 15,
+  TAOS_SMSG_SYNC_FWD_BATCH = 16,
+  TAOS_SMSG_END            = 17
 } ESyncMsgType;
 
 typedef enum {
@@ -91,7 +92,8 @@ typedef struct {
   int8_t      role;
   int8_t      ack;
   int8_t      type;
-  int8_t      reserved[3];
+  int8_t      features;  // SYNC_FEATURE_*, old versions leave it 0
+  int8_t      reserved[2];
   uint16_t    tranId;
   uint64_t    version;
   SPeerStatus peersStatus[TAOS_SYNC_MAX_REPLICA];
@@ -107,6 +109,7 @@ typedef struct {
   int8_t    ack;
 } SFileAck;
 
+// the versions up to it are acked if code is 0, otherwise only the version itself is nacked
 typedef struct {
   SSyncHead head;
   uint64_t  version;
@@ -118,12 +121,18 @@ typedef struct {
 #define SYNC_PROTOCOL_VERSION 1
 #define SYNC_SIGNATURE ((uint16_t)(0xCDEF))
 
+// a peer with it accepts TAOS_SMSG_SYNC_FWD_BATCH, and counts a forward response for all versions up to it
+#define SYNC_FEATURE_FWD_BATCH 0x1
+#define SYNC_FEATURES SYNC_FEATURE_FWD_BATCH
+
 extern char *statusType[];
 
 uint16_t syncGenTranId();
 int32_t  syncCheckHead(SSyncHead *pHead);
 
 void syncBuildSyncFwdMsg(SSyncHead *pHead, int32_t vgId, int32_t len);
+void syncBuildSyncFwdBatchMsg(SSyncHead *pHead, int32_t vgId, int32_t len);
+SSyncHead *syncGetFwdInBatch(char **ppos, char *end);
 void syncBuildSyncFwdRsp(SFwdRsp *pMsg, int32_t vgId, uint64_t version, int32_t code);
 void syncBuildSyncReqMsg(SSyncMsg *pMsg, int32_t vgId);
 void syncBuildSyncDataMsg(SSyncMsg *pMsg, int32_t vgId);
@@ -54,9 +54,9 @@ static void    syncRemoveConfirmedFwdInfo(SSyncNode *pNode);
 static void    syncMonitorFwdInfos(void *param, void *tmrId);
 static void    syncMonitorNodeRole(void *param, void *tmrId);
 static void    syncProcessFwdAck(SSyncNode *pNode, SFwdInfo *pFwdInfo, int32_t code);
-static int32_t syncSaveFwdInfo(SSyncNode *pNode, uint64_t version, void *mhandle);
 static void    syncRestartPeer(SSyncPeer *pPeer);
 static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle, int32_t qtype, bool force);
+static void    syncSendFwdBatch(SSyncNode *pNode);
 
 static SSyncPeer *syncAddPeer(SSyncNode *pNode, const SNodeInfo *pInfo);
 static void       syncStartCheckPeerConn(SSyncPeer *pPeer);
@@ -389,6 +389,48 @@ int32_t syncForwardToPeer(int64_t rid, void *data, void *mhandle, int32_t qtype,
   return code;
 }
 
+void syncBeginForwards(int64_t rid) {
+  if (rid <= 0) return;
+
+  SSyncNode *pNode = syncAcquireNode(rid);
+  if (pNode == NULL) return;
+
+  pthread_mutex_lock(&pNode->mutex);
+  pNode->batching = 1;
+  pthread_mutex_unlock(&pNode->mutex);
+
+  syncReleaseNode(pNode);
+}
+
+void syncFlushForwards(int64_t rid) {
+  if (rid <= 0) return;
+
+  SSyncNode *pNode = syncAcquireNode(rid);
+  if (pNode == NULL) return;
+
+  pthread_mutex_lock(&pNode->mutex);
+  pNode->batching = 0;
+  syncSendFwdBatch(pNode);
+  pthread_mutex_unlock(&pNode->mutex);
+
+  syncReleaseNode(pNode);
+}
+
+bool syncCumulativeAcks(int64_t rid) {
+  if (rid <= 0) return false;
+
+  SSyncNode *pNode = syncAcquireNode(rid);
+  if (pNode == NULL) return false;
+
+  pthread_mutex_lock(&pNode->mutex);
+  SSyncPeer *pMaster = pNode->pMaster;
+  bool       cumulative = (pMaster != NULL) && (pMaster->features & SYNC_FEATURE_FWD_BATCH) != 0;
+  pthread_mutex_unlock(&pNode->mutex);
+
+  syncReleaseNode(pNode);
+  return cumulative;
+}
+
 void syncConfirmForward(int64_t rid, uint64_t _version, int32_t code, bool force) {
   SSyncNode *pNode = syncAcquireNode(rid);
   if (pNode == NULL) return;
@@ -492,6 +534,8 @@ static void syncFreeNode(void *param) {
   pthread_mutex_destroy(&pNode->mutex);
   tfree(pNode->pRecv);
   tfree(pNode->pSyncFwds);
+  if (pNode->pFwdBatch) tfree(pNode->pFwdBatch->buffer);
+  tfree(pNode->pFwdBatch);
   tfree(pNode);
 }
 
@@ -546,6 +590,7 @@ static void syncClosePeerConn(SSyncPeer *pPeer) {
 
   taosTmrStopA(&pPeer->timer);
   taosCloseSocket(pPeer->syncFd);
+  pPeer->features = 0;
   if (pPeer->peerFd >= 0) {
     pPeer->peerFd = -1;
     void *pConn = pPeer->pConn;
@@ -562,6 +607,7 @@ static void syncRemovePeer(SSyncPeer *pPeer) {
   //pPeer->ip = 0;
   pPeer->fqdn[0] = '\0';
   syncClosePeerConn(pPeer);
+  syncFreeFwdBit(pPeer->pSyncNode, pPeer);
   //taosRemoveRef(tsPeerRefId, pPeer->rid);
   syncReleasePeer(pPeer);
 }
@@ -621,6 +667,7 @@ static SSyncPeer *syncAddPeer(SSyncNode *pNode, const SNodeInfo *pInfo) {
   pPeer->pSyncNode = pNode;
   pPeer->refCount = 1;
   pPeer->rid = taosAddRef(tsPeerRefId, pPeer);
+  syncAllocFwdBit(pNode, pPeer);
 
   sInfo("%s, %p it is configured, ep:%s:%u rid:%" PRId64, pPeer->id, pPeer, pPeer->fqdn, pPeer->port, pPeer->rid);
 
@@ -985,50 +1032,126 @@ static void syncRecoverFromMaster(SSyncPeer *pPeer) {
   }
 }
 
-static void syncProcessFwdResponse(SFwdRsp *pFwdRsp, SSyncPeer *pPeer) {
-  SSyncNode *pNode = pPeer->pSyncNode;
+void syncAllocFwdBit(SSyncNode *pNode, SSyncPeer *pPeer) {
+  for (int32_t i = 0; i < 8; ++i) {
+    uint8_t fwdBit = (uint8_t)(1u << i);
+    if (pNode->fwdBits & fwdBit) continue;
+
+    pNode->fwdBits |= fwdBit;
+    pPeer->fwdBit = fwdBit;
+    return;
+  }
+}
+
+// the bit may be allocated to a new peer, so it is cleared from the pending forwards
+void syncFreeFwdBit(SSyncNode *pNode, SSyncPeer *pPeer) {
+  uint8_t fwdBit = pPeer->fwdBit;
+  if (fwdBit == 0) return;
+
+  pNode->fwdBits &= (uint8_t)~fwdBit;
+  pPeer->fwdBit = 0;
+
   SSyncFwds *pSyncFwds = pNode->pSyncFwds;
-  SFwdInfo * pFwdInfo;
+  if (pSyncFwds == NULL) return;
 
-  sTrace("%s, forward-rsp is received, code:%x hver:%" PRIu64, pPeer->id, pFwdRsp->code, pFwdRsp->version);
-  SFwdInfo *pFirst = pSyncFwds->fwdInfo + pSyncFwds->first;
-
-  if (pFirst->version <= pFwdRsp->version && pSyncFwds->fwds > 0) {
-    // find the forwardInfo from first
-    for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
-      pFwdInfo = pSyncFwds->fwdInfo + (i + pSyncFwds->first) % SYNC_MAX_FWDS;
-      if (pFwdRsp->version == pFwdInfo->version) {
-        syncProcessFwdAck(pNode, pFwdInfo, pFwdRsp->code);
-        syncRemoveConfirmedFwdInfo(pNode);
-        return;
-      }
-    }
+  for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
+    SFwdInfo *pFwdInfo = pSyncFwds->fwdInfo + (i + pSyncFwds->first) % SYNC_MAX_FWDS;
+    pFwdInfo->ackPeers &= (uint8_t)~fwdBit;
   }
 }
 
-static void syncProcessForwardFromPeer(char *cont, SSyncPeer *pPeer) {
+// all versions up to it are acked if code is 0, otherwise only the version itself is nacked
+void syncProcessFwdAcks(SSyncNode *pNode, uint8_t fwdBit, uint64_t _version, int32_t code) {
+  SSyncFwds *pSyncFwds = pNode->pSyncFwds;
+  if (fwdBit == 0 || pSyncFwds == NULL) return;
+
+  for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
+    SFwdInfo *pFwdInfo = pSyncFwds->fwdInfo + (i + pSyncFwds->first) % SYNC_MAX_FWDS;
+    if (pFwdInfo->version > _version) break;
+    if (code != 0 && pFwdInfo->version != _version) continue;
+    if (pFwdInfo->ackPeers & fwdBit) continue;
+
+    pFwdInfo->ackPeers |= fwdBit;
+    syncProcessFwdAck(pNode, pFwdInfo, code);
+  }
+
+  syncRemoveConfirmedFwdInfo(pNode);
+}
+
+static void syncProcessFwdResponse(SFwdRsp *pFwdRsp, SSyncPeer *pPeer) {
+  sTrace("%s, forward-rsp is received, code:%x hver:%" PRIu64, pPeer->id, pFwdRsp->code, pFwdRsp->version);
+  syncProcessFwdAcks(pPeer->pSyncNode, pPeer->fwdBit, pFwdRsp->version, pFwdRsp->code);
+}
+
+static int32_t syncProcessForward(SSyncPeer *pPeer, SWalHead *pHead) {
   SSyncNode *pNode = pPeer->pSyncNode;
-  SWalHead * pHead = (SWalHead *)(cont + sizeof(SSyncHead));
 
   sTrace("%s, forward is received, hver:%" PRIu64 ", len:%d", pPeer->id, pHead->version, pHead->len);
 
-  int32_t code = 0;
   if (nodeRole == TAOS_SYNC_ROLE_SLAVE) {
     // nodeVersion = pHead->version;
-    code = (*pNode->writeToCacheFp)(pNode->vgId, pHead, TAOS_QTYPE_FWD, NULL);
+    return (*pNode->writeToCacheFp)(pNode->vgId, pHead, TAOS_QTYPE_FWD, NULL);
+  }
+
+  if (nodeSStatus != TAOS_SYNC_STATUS_INIT) {
+    return syncSaveIntoBuffer(pPeer, pHead);
+  }
+
+  sError("%s, forward discarded since sstatus:%s, hver:%" PRIu64, pPeer->id, syncStatus[nodeSStatus], pHead->version);
+  return -1;
+}
+
+static void syncProcessForwardFromPeer(char *cont, SSyncPeer *pPeer) {
+  SSyncNode *pNode = pPeer->pSyncNode;
+  SWalHead * pHead = (SWalHead *)(cont + sizeof(SSyncHead));
+
+  int32_t code = syncProcessForward(pPeer, pHead);
+  if (nodeRole == TAOS_SYNC_ROLE_SLAVE) {
     syncConfirmForward(pNode->rid, pHead->version, code, false);
-  } else {
-    if (nodeSStatus != TAOS_SYNC_STATUS_INIT) {
-      code = syncSaveIntoBuffer(pPeer, pHead);
-    } else {
-      sError("%s, forward discarded since sstatus:%s, hver:%" PRIu64, pPeer->id, syncStatus[nodeSStatus],
-             pHead->version);
+  }
+
+  if (code != 0) {
+    sError("%s, failed to process fwd msg, hver:%" PRIu64 ", len:%d", pPeer->id, pHead->version, pHead->len);
+    syncRestartConnection(pPeer);
+  }
+}
+
+static void syncProcessForwardBatchFromPeer(char *cont, SSyncPeer *pPeer) {
+  SSyncNode *pNode = pPeer->pSyncNode;
+  SSyncHead *pSyncHead = (SSyncHead *)cont;
+  char *     pos = cont + sizeof(SSyncHead);
+  char *     end = pos + pSyncHead->len;
+  SWalHead * pHead = NULL;
+  uint64_t   lastVer = 0;
+  int32_t    forwards = 0;
+  int32_t    code = 0;
+
+  while (pos < end) {
+    SSyncHead *pFwdHead = syncGetFwdInBatch(&pos, end);
+    if (pFwdHead == NULL) {
+      sError("%s, invalid fwd batch, forwards:%d len:%d", pPeer->id, forwards, pSyncHead->len);
+      pHead = NULL;
       code = -1;
+      break;
     }
+
+    pHead = (SWalHead *)((char *)pFwdHead + sizeof(SSyncHead));
+    code = syncProcessForward(pPeer, pHead);
+    if (code != 0) break;
+
+    lastVer = pHead->version;
+    forwards++;
+  }
+
+  // the forwards written are acked in one response, and the failed one in another
+  if (nodeRole == TAOS_SYNC_ROLE_SLAVE) {
+    if (forwards > 0) syncConfirmForward(pNode->rid, lastVer, 0, false);
+    if (code != 0 && pHead != NULL) syncConfirmForward(pNode->rid, pHead->version, code, false);
   }
 
   if (code != 0) {
-    sError("%s, failed to process fwd msg, hver:%" PRIu64 ", len:%d", pPeer->id, pHead->version, pHead->len);
+    sError("%s, failed to process fwd batch, forwards:%d hver:%" PRIu64, pPeer->id, forwards,
+           pHead ? pHead->version : 0);
     syncRestartConnection(pPeer);
   }
 }
@@ -1041,6 +1164,7 @@ static void syncProcessPeersStatusMsg(SPeersStatus *pPeersStatus, SSyncPeer *pPe
          pPeersStatus->version, pPeersStatus->ack, pPeersStatus->tranId, statusType[pPeersStatus->type], pPeer->peerFd);
 
   pPeer->version = pPeersStatus->version;
+  pPeer->features = pPeersStatus->features;
   syncCheckRole(pPeer, pPeersStatus->peersStatus, pPeersStatus->role);
 
   if (pPeersStatus->ack) {
@@ -1086,6 +1210,8 @@ static int32_t syncProcessPeerMsg(int64_t rid, void *buffer) {
   if (code == 0) {
     if (pHead->type == TAOS_SMSG_SYNC_FWD) {
       syncProcessForwardFromPeer(buffer, pPeer);
+    } else if (pHead->type == TAOS_SMSG_SYNC_FWD_BATCH) {
+      syncProcessForwardBatchFromPeer(buffer, pPeer);
     } else if (pHead->type == TAOS_SMSG_SYNC_FWD_RSP) {
       syncProcessFwdResponse(buffer, pPeer);
     } else if (pHead->type == TAOS_SMSG_SYNC_REQ) {
@@ -1119,6 +1245,7 @@ static int32_t syncSendPeersStatusMsgToPeer(SSyncPeer *pPeer, char ack, int8_t t
   msg.type = type;
   msg.tranId = tranId;
   msg.version = nodeVersion;
+  msg.features = SYNC_FEATURES;
 
   for (int32_t i = 0; i < pNode->replica; ++i) {
     msg.peersStatus[i].role = pNode->peerInfo[i]->role;
@@ -1329,7 +1456,7 @@ static void syncProcessBrokenLink(int64_t rid, int32_t closedByApp) {
   syncReleasePeer(pPeer);
 }
 
-static int32_t syncSaveFwdInfo(SSyncNode *pNode, uint64_t _version, void *mhandle) {
+int32_t syncSaveFwdInfo(SSyncNode *pNode, uint64_t _version, void *mhandle) {
   SSyncFwds *pSyncFwds = pNode->pSyncFwds;
   int64_t    time = taosGetTimestampMs();
 
@@ -1448,11 +1575,131 @@ static void syncMonitorFwdInfos(void *param, void *tmrId) {
   syncReleaseNode(pNode);
 }
 
+static bool syncIsFwdPeer(SSyncPeer *pPeer) {
+  if (pPeer == NULL || pPeer->peerFd < 0) return false;
+  return pPeer->role == TAOS_SYNC_ROLE_SLAVE || pPeer->sstatus == TAOS_SYNC_STATUS_CACHE;
+}
+
+static bool syncHasFwdPeer(SSyncNode *pNode) {
+  for (int32_t i = 0; i < pNode->replica; ++i) {
+    if (syncIsFwdPeer(pNode->peerInfo[i])) return true;
+  }
+
+  return false;
+}
+
+// a peer of old version does not know the batch, so the forwards in it are written one by one
+static int32_t syncWriteFwdBatch(SOCKET peerFd, SSyncHead *pSyncHead, bool batch) {
+  int32_t fwdLen = pSyncHead->len + sizeof(SSyncHead);  // include the WAL and SYNC head
+  if (batch || pSyncHead->type != TAOS_SMSG_SYNC_FWD_BATCH) return taosWriteMsg(peerFd, pSyncHead, fwdLen);
+
+  char *pos = (char *)pSyncHead + sizeof(SSyncHead);
+  char *end = pos + pSyncHead->len;
+  while (pos < end) {
+    SSyncHead *pFwdHead = syncGetFwdInBatch(&pos, end);
+    if (pFwdHead == NULL) return -1;
+
+    int32_t len = pFwdHead->len + sizeof(SSyncHead);
+    int32_t retLen = taosWriteMsg(peerFd, pFwdHead, len);
+    if (retLen != len) return retLen;
+  }
+
+  return fwdLen;
+}
+
+// the mutex is released while the msg is written to each peer
+static void syncSendFwdToPeers(SSyncNode *pNode, SSyncHead *pSyncHead, uint64_t _version, int32_t forwards) {
+  int32_t fwdLen = pSyncHead->len + sizeof(SSyncHead);
+
+  for (int32_t i = 0; i < pNode->replica; ++i) {
+    SSyncPeer *pPeer = pNode->peerInfo[i];
+    if (!syncIsFwdPeer(pPeer)) continue;
+
+    SOCKET peerFd = pPeer->peerFd;
+    bool   batch = (pPeer->features & SYNC_FEATURE_FWD_BATCH) != 0;
+    pthread_mutex_unlock(&pNode->mutex);
+    int32_t retLen = syncWriteFwdBatch(peerFd, pSyncHead, batch);
+    pthread_mutex_lock(&pNode->mutex);
+    if (retLen == fwdLen) {
+      sTrace("%s, forward is sent, role:%s sstatus:%s hver:%" PRIu64 " forwards:%d len:%d", pPeer->id,
+             syncRole[pPeer->role], syncStatus[pPeer->sstatus], _version, forwards, pSyncHead->len);
+    } else {
+      sError("%s, failed to forward, role:%s sstatus:%s hver:%" PRIu64 " forwards:%d retLen:%d", pPeer->id,
+             syncRole[pPeer->role], syncStatus[pPeer->sstatus], _version, forwards, retLen);
+      syncRestartConnection(pPeer);
+    }
+  }
+}
+
+static void syncSendFwdBatch(SSyncNode *pNode) {
+  SFwdBatch *pBatch = pNode->pFwdBatch;
+  if (pBatch == NULL || pBatch->forwards == 0) return;
+
+  // detached, since the forwards of other threads may be kept while the mutex is released
+  pNode->pFwdBatch = NULL;
+
+  SSyncHead *pSyncHead = (SSyncHead *)pBatch->buffer;
+  syncBuildSyncFwdBatchMsg(pSyncHead, pNode->vgId, pBatch->len);
+  syncSendFwdToPeers(pNode, pSyncHead, pBatch->version, pBatch->forwards);
+
+  pBatch->len = 0;
+  pBatch->forwards = 0;
+
+  if (pNode->pFwdBatch == NULL) {
+    if (pBatch->size > SYNC_FWD_BATCH_SIZE) {
+      tfree(pBatch->buffer);
+      pBatch->size = 0;
+    }
+    pNode->pFwdBatch = pBatch;
+  } else {
+    tfree(pBatch->buffer);
+    tfree(pBatch);
+  }
+}
+
+int32_t syncAddIntoFwdBatch(SSyncNode *pNode, SWalHead *pWalHead) {
+  int32_t walLen = sizeof(SWalHead) + pWalHead->len;
+  int32_t fwdLen = sizeof(SSyncHead) + walLen;
+  int32_t len = ALIGN8(fwdLen);
+  if (len > TSDB_MAX_WAL_SIZE) return -1;
+
+  if (pNode->pFwdBatch != NULL && pNode->pFwdBatch->len + len > TSDB_MAX_WAL_SIZE) {
+    syncSendFwdBatch(pNode);
+  }
+
+  if (pNode->pFwdBatch == NULL) {
+    pNode->pFwdBatch = calloc(1, sizeof(SFwdBatch));
+    if (pNode->pFwdBatch == NULL) return -1;
+  }
+
+  SFwdBatch *pBatch = pNode->pFwdBatch;
+  int32_t    size = sizeof(SSyncHead) + pBatch->len + len;
+  if (pBatch->size < size) {
+    int32_t newSize = MAX(pBatch->size * 2, SYNC_FWD_BATCH_SIZE);
+    if (newSize < size) newSize = size;
+    char *  buffer = realloc(pBatch->buffer, newSize);
+    if (buffer == NULL) return -1;
+
+    pBatch->buffer = buffer;
+    pBatch->size = newSize;
+  }
+
+  char *pos = pBatch->buffer + sizeof(SSyncHead) + pBatch->len;
+  syncBuildSyncFwdMsg((SSyncHead *)pos, pNode->vgId, walLen);
+  memcpy(pos + sizeof(SSyncHead), pWalHead, walLen);
+  memset(pos + fwdLen, 0, len - fwdLen);
+
+  pBatch->len += len;
+  pBatch->forwards++;
+  pBatch->version = pWalHead->version;
+
+  return 0;
+}
+
 static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle, int32_t qtype, bool force) {
   SSyncPeer *pPeer;
   SSyncHead *pSyncHead;
   SWalHead * pWalHead = data;
-  int32_t    fwdLen;
   int32_t    code = 0;
 
   if (pWalHead->version > nodeVersion + 1) {
@@ -1480,42 +1727,35 @@ static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle
   // only msg from RPC or CQ can be forwarded
   if (qtype != TAOS_QTYPE_RPC && qtype != TAOS_QTYPE_CQ) return 0;
 
-    // a hacker way to improve the performance
-  pSyncHead = (SSyncHead *)(((char *)pWalHead) - sizeof(SSyncHead));
-  syncBuildSyncFwdMsg(pSyncHead, pNode->vgId, sizeof(SWalHead) + pWalHead->len);
-  fwdLen = pSyncHead->len + sizeof(SSyncHead);  // include the WAL and SYNC head
-
   pthread_mutex_lock(&pNode->mutex);
 
-  for (int32_t i = 0; i < pNode->replica; ++i) {
-    pPeer = pNode->peerInfo[i];
-    if (pPeer == NULL || pPeer->peerFd < 0) continue;
-    if (pPeer->role != TAOS_SYNC_ROLE_SLAVE && pPeer->sstatus != TAOS_SYNC_STATUS_CACHE) continue;
+  if (!syncHasFwdPeer(pNode)) {
+    pthread_mutex_unlock(&pNode->mutex);
+    return 0;
+  }
 
-    if ((pNode->quorum > 1 || force) && code == 0) {
-      code = syncSaveFwdInfo(pNode, pWalHead->version, mhandle);
-      if (code >= 0) {
-        code = 1;
-      } else {
-        pthread_mutex_unlock(&pNode->mutex);
-        return code;
-      }
+  if (pNode->quorum > 1 || force) {
+    code = syncSaveFwdInfo(pNode, pWalHead->version, mhandle);
+    if (code < 0) {
+      pthread_mutex_unlock(&pNode->mutex);
+      return code;
     }
+    code = 1;
+  }
 
-    SOCKET peerFd = pPeer->peerFd;
+  if (pNode->batching && syncAddIntoFwdBatch(pNode, pWalHead) == 0) {
     pthread_mutex_unlock(&pNode->mutex);
-    int32_t retLen = taosWriteMsg(peerFd, pSyncHead, fwdLen);
-    pthread_mutex_lock(&pNode->mutex);
-    if (retLen == fwdLen) {
-      sTrace("%s, forward is sent, role:%s sstatus:%s hver:%" PRIu64 " contLen:%d", pPeer->id, syncRole[pPeer->role],
-             syncStatus[pPeer->sstatus], pWalHead->version, pWalHead->len);
-    } else {
-      sError("%s, failed to forward, role:%s sstatus:%s hver:%" PRIu64 " retLen:%d", pPeer->id, syncRole[pPeer->role],
-             syncStatus[pPeer->sstatus], pWalHead->version, retLen);
-      syncRestartConnection(pPeer);
-    }
+    return code;
   }
 
+  // the forwards kept in batch shall arrive first
+  syncSendFwdBatch(pNode);
+
+  // a hacker way to improve the performance
+  pSyncHead = (SSyncHead *)(((char *)pWalHead) - sizeof(SSyncHead));
+  syncBuildSyncFwdMsg(pSyncHead, pNode->vgId, sizeof(SWalHead) + pWalHead->len);
+  syncSendFwdToPeers(pNode, pSyncHead, pWalHead->version, 1);
+
   pthread_mutex_unlock(&pNode->mutex);
 
   return code;
@@ -61,6 +61,30 @@ void syncBuildSyncFwdMsg(SSyncHead *pHead, int32_t vgId, int32_t len) {
   syncBuildHead(pHead);
 }
 
+void syncBuildSyncFwdBatchMsg(SSyncHead *pHead, int32_t vgId, int32_t len) {
+  pHead->type = TAOS_SMSG_SYNC_FWD_BATCH;
+  pHead->vgId = vgId;
+  pHead->len = len;
+  syncBuildHead(pHead);
+}
+
+// each forward of a batch is a TAOS_SMSG_SYNC_FWD msg padded to 8 bytes, NULL is returned if it is invalid
+SSyncHead *syncGetFwdInBatch(char **ppos, char *end) {
+  char *pos = *ppos;
+  if (end - pos < (int64_t)(sizeof(SSyncHead) + sizeof(SWalHead))) return NULL;
+
+  SSyncHead *pHead = (SSyncHead *)pos;
+  SWalHead * pWalHead = (SWalHead *)(pos + sizeof(SSyncHead));
+  if (pHead->type != TAOS_SMSG_SYNC_FWD || pWalHead->len < 0) return NULL;
+  if (pHead->len != (int64_t)sizeof(SWalHead) + pWalHead->len) return NULL;
+
+  int64_t len = ALIGN8(sizeof(SSyncHead) + (int64_t)pHead->len);
+  if (end - pos < len) return NULL;
+
+  *ppos = pos + len;
+  return pHead;
+}
+
 void syncBuildSyncFwdRsp(SFwdRsp *pMsg, int32_t vgId, uint64_t _version, int32_t code) {
   pMsg->head.type = TAOS_SMSG_SYNC_FWD_RSP;
   pMsg->head.vgId = vgId;
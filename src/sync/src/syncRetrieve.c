@@ -134,6 +134,17 @@ static int32_t syncRetrieveFile(SSyncPeer *pPeer) {
   return 0;
 }
 
+// only the zeros of a preallocated file, or nothing, follow the last record of a wal file
+static bool syncIsWalTail(int32_t sfd, int64_t offset) {
+  static const SWalHead zeroHead = {0};
+  SWalHead              head;
+
+  int32_t ret = (int32_t)pread(sfd, &head, sizeof(SWalHead), offset);
+  if (ret < 0) return false;
+  if (ret < sizeof(SWalHead)) return true;
+  return memcmp(&head, &zeroHead, sizeof(SWalHead)) == 0;
+}
+
 // if only a partial record is read out, upper layer will reload the file to get a complete record
 static int32_t syncReadOneWalRecord(int32_t sfd, SWalHead *pHead) {
   int32_t ret = read(sfd, pHead, sizeof(SWalHead));
@@ -167,6 +178,25 @@ static int32_t syncReadOneWalRecord(int32_t sfd, SWalHead *pHead) {
     return 0;
   }
 
+  if (!walIsValidRecord(pHead)) {
+    int32_t size = sizeof(SWalHead) + pHead->len;
+    int64_t next = taosLSeek(sfd, 0, SEEK_CUR);
+
+    if (next >= 0 && syncIsWalTail(sfd, next)) {
+      // the end of records in a preallocated file, or a record still being written
+      sDebug("sfd:%d, no complete wal record is read out, len:%d", sfd, pHead->len);
+      return 0;
+    }
+
+    // records follow it, so it is either completed after it was read, or corrupted
+    if (next < 0 || pread(sfd, pHead, size, next - size) != size || pHead->len != size - sizeof(SWalHead) ||
+        !walIsValidRecord(pHead)) {
+      sError("sfd:%d, wal record is corrupted, hver:%" PRIu64 " len:%d offset:%" PRId64, sfd, pHead->version,
+             pHead->len, next - size);
+      return -1;
+    }
+  }
+
   return sizeof(SWalHead) + pHead->len;
 }
 
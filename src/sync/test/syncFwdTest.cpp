@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "taosmsg.h"
+#include "syncInt.h"
+
+namespace {
+
+std::vector<std::pair<uint64_t, int32_t>> confirmed;
+
+void confirmForward(int32_t vgId, void *mhandle, int32_t code) {
+  confirmed.push_back(std::make_pair((uint64_t)(int64_t)mhandle, code));
+}
+
+SSyncNode *createNode(int8_t replica, int8_t quorum) {
+  SSyncNode *pNode = (SSyncNode *)calloc(1, sizeof(SSyncNode));
+  pNode->vgId = 2;
+  pNode->replica = replica;
+  pNode->quorum = quorum;
+  pNode->confirmForward = confirmForward;
+  pNode->pSyncFwds = (SSyncFwds *)calloc(sizeof(SSyncFwds) + SYNC_MAX_FWDS * sizeof(SFwdInfo), 1);
+  confirmed.clear();
+  return pNode;
+}
+
+void destroyNode(SSyncNode *pNode) {
+  if (pNode->pFwdBatch) free(pNode->pFwdBatch->buffer);
+  free(pNode->pFwdBatch);
+  free(pNode->pSyncFwds);
+  free(pNode);
+}
+
+// the version is also the mhandle, so that the confirmed forwards can be told
+void saveFwds(SSyncNode *pNode, uint64_t first, uint64_t last) {
+  for (uint64_t v = first; v <= last; ++v) {
+    ASSERT_EQ(syncSaveFwdInfo(pNode, v, (void *)(int64_t)v), 0);
+  }
+}
+
+std::vector<char> makeWalHead(uint64_t version, int32_t len) {
+  std::vector<char> buf(sizeof(SWalHead) + len);
+  SWalHead *        pHead = (SWalHead *)buf.data();
+  pHead->msgType = TSDB_MSG_TYPE_SUBMIT;
+  pHead->len = len;
+  pHead->version = version;
+  for (int32_t i = 0; i < len; ++i) pHead->cont[i] = (char)(version + i);
+  return buf;
+}
+
+}  // namespace
+
+TEST(syncFwdTest, batch_of_fwd_msgs) {
+  SSyncNode *     pNode = createNode(3, 2);
+  const int32_t   lens[] = {0, 1, 13, 1024, 7};
+  const int32_t   num = sizeof(lens) / sizeof(lens[0]);
+
+  for (int32_t i = 0; i < num; ++i) {
+    std::vector<char> wal = makeWalHead(100 + i, lens[i]);
+    ASSERT_EQ(syncAddIntoFwdBatch(pNode, (SWalHead *)wal.data()), 0);
+  }
+
+  SFwdBatch *pBatch = pNode->pFwdBatch;
+  ASSERT_NE(pBatch, nullptr);
+  EXPECT_EQ(pBatch->forwards, num);
+  EXPECT_EQ(pBatch->version, 100u + num - 1);
+
+  // each forward is a msg that a peer of old version can take, so it can be written alone
+  char *pos = pBatch->buffer + sizeof(SSyncHead);
+  char *end = pos + pBatch->len;
+  for (int32_t i = 0; i < num; ++i) {
+    char *     start = pos;
+    SSyncHead *pHead = syncGetFwdInBatch(&pos, end);
+    ASSERT_NE(pHead, nullptr);
+    EXPECT_EQ(syncCheckHead(pHead), 0);
+    EXPECT_EQ(pHead->type, TAOS_SMSG_SYNC_FWD);
+    EXPECT_EQ(pHead->vgId, 2);
+
+    SWalHead *pWalHead = (SWalHead *)(pHead + 1);
+    EXPECT_EQ(pHead->len, (int32_t)sizeof(SWalHead) + lens[i]);
+    EXPECT_EQ(pWalHead->version, 100u + i);
+    for (int32_t j = 0; j < lens[i]; ++j) EXPECT_EQ(pWalHead->cont[j], (char)(100 + i + j));
+    EXPECT_EQ((pos - start) % 8, 0);
+  }
+  EXPECT_EQ(pos, end);
+
+  destroyNode(pNode);
+}
+
+TEST(syncFwdTest, invalid_batch) {
+  SSyncNode *       pNode = createNode(3, 2);
+  std::vector<char> wal = makeWalHead(1, 100);
+  ASSERT_EQ(syncAddIntoFwdBatch(pNode, (SWalHead *)wal.data()), 0);
+
+  SFwdBatch *pBatch = pNode->pFwdBatch;
+  char *     start = pBatch->buffer + sizeof(SSyncHead);
+
+  // truncated
+  char *pos = start;
+  EXPECT_EQ(syncGetFwdInBatch(&pos, start + pBatch->len - 8), nullptr);
+  EXPECT_EQ(pos, start);
+  EXPECT_EQ(syncGetFwdInBatch(&pos, start + sizeof(SSyncHead)), nullptr);
+
+  // the length of sync head does not match the WAL head
+  ((SSyncHead *)start)->len += 8;
+  EXPECT_EQ(syncGetFwdInBatch(&pos, start + pBatch->len), nullptr);
+  ((SSyncHead *)start)->len -= 8;
+
+  ((SSyncHead *)start)->type = TAOS_SMSG_SYNC_FWD_BATCH;
+  EXPECT_EQ(syncGetFwdInBatch(&pos, start + pBatch->len), nullptr);
+
+  destroyNode(pNode);
+}
+
+TEST(syncFwdTest, cumulative_acks) {
+  SSyncNode *pNode = createNode(3, 3);
+  SSyncFwds *pSyncFwds = pNode->pSyncFwds;
+  saveFwds(pNode, 1, 5);
+
+  // one peer acks all versions up to 3, but the quorum needs another one
+  syncProcessFwdAcks(pNode, 0x1, 3, 0);
+  EXPECT_TRUE(confirmed.empty());
+  EXPECT_EQ(pSyncFwds->fwds, 5);
+
+  // acks from the same peer are never counted twice
+  syncProcessFwdAcks(pNode, 0x1, 2, 0);
+  syncProcessFwdAcks(pNode, 0x1, 3, 0);
+  EXPECT_TRUE(confirmed.empty());
+
+  syncProcessFwdAcks(pNode, 0x2, 5, 0);
+  ASSERT_EQ(confirmed.size(), 3u);
+  for (uint64_t v = 1; v <= 3; ++v) {
+    EXPECT_EQ(confirmed[v - 1].first, v);
+    EXPECT_EQ(confirmed[v - 1].second, 0);
+  }
+  EXPECT_EQ(pSyncFwds->fwds, 2);
+
+  // the versions confirmed are removed from the window, acks for them are ignored
+  syncProcessFwdAcks(pNode, 0x2, 2, 0);
+  EXPECT_EQ(confirmed.size(), 3u);
+
+  syncProcessFwdAcks(pNode, 0x1, 5, 0);
+  ASSERT_EQ(confirmed.size(), 5u);
+  EXPECT_EQ(confirmed[3].first, 4u);
+  EXPECT_EQ(confirmed[4].first, 5u);
+  EXPECT_EQ(pSyncFwds->fwds, 0);
+
+  // an ack beyond the window does nothing
+  syncProcessFwdAcks(pNode, 0x1, 100, 0);
+  EXPECT_EQ(confirmed.size(), 5u);
+
+  destroyNode(pNode);
+}
+
+TEST(syncFwdTest, nacks) {
+  SSyncNode *pNode = createNode(3, 2);
+  SSyncFwds *pSyncFwds = pNode->pSyncFwds;
+  saveFwds(pNode, 1, 4);
+
+  // a nack is for its own version only
+  syncProcessFwdAcks(pNode, 0x1, 2, TSDB_CODE_SYN_INVALID_VERSION);
+  EXPECT_TRUE(confirmed.empty());
+
+  // 2 nacks of 3 replicas fail the quorum
+  syncProcessFwdAcks(pNode, 0x2, 2, TSDB_CODE_SYN_INVALID_VERSION);
+  ASSERT_EQ(confirmed.size(), 1u);
+  EXPECT_EQ(confirmed[0].first, 2u);
+  EXPECT_EQ(confirmed[0].second, TSDB_CODE_SYN_INVALID_VERSION);
+  EXPECT_EQ(pSyncFwds->fwds, 4);
+
+  // the cumulative ack skips the version nacked by the same peer
+  syncProcessFwdAcks(pNode, 0x1, 3, 0);
+  ASSERT_EQ(confirmed.size(), 3u);
+  EXPECT_EQ(confirmed[1].first, 1u);
+  EXPECT_EQ(confirmed[1].second, 0);
+  EXPECT_EQ(confirmed[2].first, 3u);
+  EXPECT_EQ(confirmed[2].second, 0);
+  EXPECT_EQ(pSyncFwds->fwds, 1);
+
+  // the window wraps around
+  for (uint64_t v = 5; v < SYNC_MAX_FWDS + 4; ++v) {
+    ASSERT_EQ(syncSaveFwdInfo(pNode, v, (void *)(int64_t)v), 0);
+  }
+  EXPECT_EQ(syncSaveFwdInfo(pNode, SYNC_MAX_FWDS + 4, NULL), TSDB_CODE_SYN_TOO_MANY_FWDINFO);
+
+  syncProcessFwdAcks(pNode, 0x2, SYNC_MAX_FWDS + 3, 0);
+  EXPECT_EQ(confirmed.size(), (size_t)SYNC_MAX_FWDS + 3);
+  EXPECT_EQ(pSyncFwds->fwds, 0);
+
+  destroyNode(pNode);
+}
+
+TEST(syncFwdTest, ack_bits_across_reconfig) {
+  SSyncNode *pNode = createNode(3, 3);
+  SSyncPeer  peers[4];
+  memset(peers, 0, sizeof(peers));
+
+  for (int32_t i = 0; i < 3; ++i) {
+    syncAllocFwdBit(pNode, &peers[i]);
+    EXPECT_EQ(peers[i].fwdBit, 1u << i);
+  }
+
+  saveFwds(pNode, 1, 3);
+  syncProcessFwdAcks(pNode, peers[1].fwdBit, 3, 0);
+  EXPECT_TRUE(confirmed.empty());
+
+  // peer 1 is replaced, the new peer takes its bit but the acks it has sent are still counted
+  syncFreeFwdBit(pNode, &peers[1]);
+  EXPECT_EQ(peers[1].fwdBit, 0);
+  syncAllocFwdBit(pNode, &peers[3]);
+  EXPECT_EQ(peers[3].fwdBit, 0x2);
+
+  // the other peers keep their bits, even if their index in the config is changed
+  EXPECT_EQ(peers[2].fwdBit, 0x4);
+
+  syncProcessFwdAcks(pNode, peers[3].fwdBit, 3, 0);
+  ASSERT_EQ(confirmed.size(), 3u);
+  EXPECT_EQ(pNode->pSyncFwds->fwds, 0);
+
+  // freed twice does nothing
+  syncFreeFwdBit(pNode, &peers[1]);
+  EXPECT_EQ(pNode->fwdBits, 0x7);
+
+  destroyNode(pNode);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
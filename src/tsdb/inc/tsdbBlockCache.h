@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_BLOCK_CACHE_H_
+#define _TD_TSDB_BLOCK_CACHE_H_
+
+// ================== TSDB global config
+extern int32_t tsdbBlockCacheSize;  // MB, capacity of each vnode's block cache, 0 to disable
+
+// A decompressed column chunk of a .data/.last block. The magic of the file is part of the key, it changes
+// whenever the file is written, so a chunk read from an old version of the file set never matches a new one.
+// The key is hashed as raw bytes, so it has no implicit padding and is always copied with memcpy.
+typedef struct {
+  int64_t  offset;  // offset of the column chunk in the file
+  int32_t  fid;
+  uint32_t magic;
+  int16_t  colId;
+  int8_t   last;
+  int8_t   reserved[5];
+} SBlockCacheKey;
+
+typedef struct SBlockCache SBlockCache;
+
+SBlockCache *tsdbNewBlockCache(int64_t capacity);
+void         tsdbFreeBlockCache(SBlockCache *pCache);
+bool         tsdbGetBlockCacheCol(SBlockCache *pCache, SBlockCacheKey *pKey, SDataCol *pDataCol, int numOfRows,
+                                  int maxPoints);
+void         tsdbPutBlockCacheCol(SBlockCache *pCache, SBlockCacheKey *pKey, SDataCol *pDataCol);
+void         tsdbInvalidateBlockCache(SBlockCache *pCache, int fid);
+void         tsdbGetBlockCacheStat(SBlockCache *pCache, int64_t *hits, int64_t *misses, int64_t *size);
+
+static FORCE_INLINE void tsdbInitBlockCacheKey(SBlockCacheKey *pKey, int fid, SDFile *pDFile, bool last,
+                                               int64_t offset, int16_t colId) {
+  memset(pKey, 0, sizeof(*pKey));
+  pKey->offset = offset;
+  pKey->fid = fid;
+  pKey->magic = pDFile->info.magic;
+  pKey->colId = colId;
+  pKey->last = last ? 1 : 0;
+}
+
+#endif /* _TD_TSDB_BLOCK_CACHE_H_ */
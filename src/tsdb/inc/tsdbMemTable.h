@@ -61,6 +61,14 @@ typedef struct {
   char cont[];
 } SActCont;
 
+typedef struct {
+  int32_t   numOfRows;
+  int32_t   row;
+  STSchema *pSchema;
+  char **   pCols;   // the columns of the columnar submit block
+  SMemRow   memRow;  // the row is built in it, and copied into the buffer of tsdb when it is inserted
+} SSubmitColIter;
+
 int   tsdbRefMemTable(STsdbRepo* pRepo, SMemTable* pMemTable);
 int   tsdbUnRefMemTable(STsdbRepo* pRepo, SMemTable* pMemTable);
 int   tsdbTakeMemSnapshot(STsdbRepo* pRepo, SMemSnapshot* pSnapshot, SArray* pATable);
@@ -72,6 +80,9 @@ int   tsdbSyncCommitConfig(STsdbRepo* pRepo);
 int   tsdbLoadDataFromCache(STable* pTable, SSkipListIterator* pIter, TSKEY maxKey, int maxRowsToRead, SDataCols* pCols,
                             TKEY* filterKeys, int nFilterKeys, bool keepDup, SMergeInfo* pMergeInfo);
 void* tsdbCommitData(STsdbRepo* pRepo, bool end);
+int   tsdbCheckColumnarData(STSchema* pSchema, SSubmitBlk* pBlock);
+int   tsdbInitSubmitColIter(STSchema* pSchema, SSubmitBlk* pBlock, void** ppBuf, SSubmitColIter* pIter);
+SMemRow tsdbGetSubmitColNext(SSubmitColIter* pIter);
 
 static FORCE_INLINE SMemRow tsdbNextIterRow(SSkipListIterator* pIter) {
   if (pIter == NULL) return NULL;
@@ -16,6 +16,8 @@
 #ifndef _TD_TSDB_META_H_
 #define _TD_TSDB_META_H_
 
+#include "troaring.h"
+
 #define TSDB_MAX_TABLE_SCHEMAS 16
 
 #pragma  pack (push,1)
@@ -26,6 +28,14 @@ typedef struct jsonMapValue{
 
 #pragma  pack (pop)
 
+// secondary index of a super table on one tag column other than the first one
+typedef struct {
+  int16_t         colId;
+  int8_t          type;
+  SHashObj*       valMap;   // tag value -> SRoaringBitmap of the tids of child tables
+  SRoaringBitmap* notNull;  // tids of the child tables whose tag is not NULL
+} STagIndex;
+
 typedef struct STable {
   STableId       tableId;
   ETableType     type;
@@ -37,6 +47,8 @@ typedef struct STable {
   SKVRow         tagVal;
   SSkipList*     pIndex;         // For TSDB_SUPER_TABLE, it is the skiplist index
   SHashObj*      jsonKeyMap;     // For json tag key  {"key":[t1, t2, t3]}
+  SArray*        pTagIndex;      // For TSDB_SUPER_TABLE, STagIndex of the other tags
+  bool           tagIndexFailed; // For TSDB_SUPER_TABLE, pTagIndex is dropped after it failed to add a table
   void*          eventHandler;   // TODO
   void*          streamHandler;  // TODO
   TSKEY          lastKey;
@@ -66,6 +78,8 @@ typedef struct {
   int       maxCols;
 } STsdbMeta;
 
+extern int32_t tsdbTagIndex;  // build secondary indexes on all tags of super tables, 0 to disable
+
 #define TSDB_INIT_NTABLES 1024
 #define TABLE_TYPE(t) (t)->type
 #define TABLE_NAME(t) (t)->name
@@ -100,6 +114,12 @@ STSchema*  tsdbGetTableLatestSchema(STable *pTable);
 void       tsdbFreeLastColumns(STable* pTable);
 int        tsdbCompareJsonMapValue(const void* a, const void* b);
 void*      tsdbGetJsonTagValue(STable* pTable, char* key, int32_t keyLen, int16_t* colId);
+STagIndex* tsdbGetTagIndex(STable* pSTable, int16_t colId);
+
+// a tag value is the key of its tag index, a var-length value with its length header
+static FORCE_INLINE int32_t tsdbGetTagIndexKeyLen(int8_t type, const void *val) {
+  return IS_VAR_DATA_TYPE(type) ? varDataTLen(val) : TYPE_BYTES[type];
+}
 
 static FORCE_INLINE int tsdbCompareSchemaVersion(const void *key1, const void *key2) {
   if (*(int16_t *)key1 < schemaVersion(*(STSchema **)key2)) {
@@ -161,6 +161,10 @@ typedef struct {
 
 typedef void SAggrBlkData;  // SBlockCol cols[];
 
+extern int32_t tsdbReadAheadBlocks;  // number of data blocks a query reads ahead, 0 to disable
+
+typedef struct SReadAhead SReadAhead;
+
 struct SReadH {
   STsdbRepo * pRepo;
   SDFileSet   rSet;     // FSET to read
@@ -175,6 +179,8 @@ struct SReadH {
   void *      pBuf;   // buffer
   void *      pCBuf;  // compression buffer
   void *      pExBuf;  // extra buffer
+  bool        useBlkCache;  // look up and fill the repo's block cache when loading column data
+  SReadAhead *pReadAhead;   // blocks read ahead of loading, created on the first tsdbReadAheadBlock call
 };
 
 #define TSDB_READ_REPO(rh) ((rh)->pRepo)
@@ -225,6 +231,7 @@ int   tsdbSetReadTable(SReadH *pReadh, STable *pTable);
 int   tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen);
 int   tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlockInfo);
 int   tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo, int16_t *colIds, int numOfColsIds);
+int   tsdbReadAheadBlock(SReadH *pReadh, SBlock *pBlock, int16_t *colIds, int numOfColIds);
 int   tsdbLoadBlockStatis(SReadH *pReadh, SBlock *pBlock);
 int   tsdbLoadBlockOffset(SReadH *pReadh, SBlock *pBlock);
 int   tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx);
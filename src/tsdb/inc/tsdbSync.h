@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TD_TSDB_SYNC_H_
+#define _TD_TSDB_SYNC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the data files are synced by chunks, and a chunk is sent only if the receiver has no chunk of the same digest
+#define TSDB_SYNC_CHUNK_SIZE (4 * 1024 * 1024)
+#define TSDB_SYNC_DIGEST_LEN 16
+
+// features of the sender, appended to each fileset info. Old versions append nothing
+#define TSDB_SYNC_FEATURE_CHUNKS 0x1
+#define TSDB_SYNC_FEATURES TSDB_SYNC_FEATURE_CHUNKS
+
+// decision of the receiver, old versions only know the first two
+#define TSDB_SYNC_SKIP 0
+#define TSDB_SYNC_SEND 1         // the files are sent in whole
+#define TSDB_SYNC_SEND_CHUNKS 2  // only the chunks of different digests are sent
+
+// Sync handle
+typedef struct {
+  STsdbRepo *pRepo;
+  SRtn       rtn;
+  SOCKET     socketFd;
+  void *     pBuf;
+  bool       mfChanged;
+  SMFile *   pmf;
+  SMFile     mf;
+  SDFileSet  df;
+  SDFileSet *pdf;
+  uint8_t    features;  // TSDB_SYNC_FEATURE_* of the sender of pdf
+  void *     pChunk;    // buffer to digest a chunk
+  int64_t    sent;      // bytes of the data files sent or received through the socket
+  int64_t    received;
+} SSyncH;
+
+void    tsdbDestroySyncH(SSyncH *pSyncH);
+int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet);
+int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch);
+int32_t tsdbSyncSendDFile(SSyncH *pSynch, SDFile *pDFile, bool byChunks);
+int32_t tsdbSyncRecvDFile(SSyncH *pSynch, SDFile *pDFile, SDFile *pRDFile, SDFile *pLDFile, SDFile *pPDFile,
+                          bool byChunks);
+void    tsdbRemoveSyncPart(STsdbRepo *pRepo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TD_TSDB_SYNC_H_ */
@@ -62,12 +62,16 @@ extern "C" {
 #include "tsdbFS.h"
 // ReadImpl
 #include "tsdbReadImpl.h"
+// Block cache
+#include "tsdbBlockCache.h"
 // Commit
 #include "tsdbCommit.h"
 // Compact
 #include "tsdbCompact.h"
 // Delete
 #include "tsdbDelete.h"
+// Sync
+#include "tsdbSync.h"
 // Commit Queue
 #include "tsdbCommitQueue.h"
 
@@ -91,6 +95,7 @@ struct STsdbRepo {
   SMemTable*      mem;
   SMemTable*      imem;
   STsdbFS*        fs;
+  SBlockCache*    blkCache;  // decompressed column chunks of data files, NULL if disabled
   SRtn            rtn;
   tsem_t          readyToCommit;
   pthread_mutex_t mutex;
@@ -98,8 +103,10 @@ struct STsdbRepo {
   int32_t         code;  // Commit code
 
   SMergeBuf       mergeBuf;  //used when update=2
+  void*           submitBuf;  // the rows of the columnar submit blocks are built in it
   int8_t          compactState;  // compact state: inCompact/noCompact/waitingCompact?
   int8_t          deleteState;  // truncate state: inTruncate/noTruncate/waitingTruncate
+  SDFileSet*      syncPart;     // fileset partly received by a broken sync, its chunks are reused by the next one
 
   pthread_t*      pthread;
 };
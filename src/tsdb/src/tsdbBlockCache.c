@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+typedef struct SBlockCacheEntry {
+  SBlockCacheKey           key;
+  struct SBlockCacheEntry *prev;
+  struct SBlockCacheEntry *next;
+  int32_t                  len;
+  char                     data[];
+} SBlockCacheEntry;
+
+struct SBlockCache {
+  pthread_mutex_t   mutex;
+  SHashObj *        pHash;  // SBlockCacheKey -> SBlockCacheEntry *
+  SBlockCacheEntry *head;   // most recently used
+  SBlockCacheEntry *tail;   // least recently used, evicted first
+  int64_t           size;
+  int64_t           capacity;
+  int64_t           hits;
+  int64_t           misses;
+};
+
+#define TSDB_BLOCK_CACHE_ENTRY_SIZE(len) ((int64_t)sizeof(SBlockCacheEntry) + (len))
+
+static void tsdbUnlinkBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry);
+static void tsdbLinkBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry);
+static void tsdbRemoveBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry);
+
+SBlockCache *tsdbNewBlockCache(int64_t capacity) {
+  SBlockCache *pCache = (SBlockCache *)calloc(1, sizeof(*pCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  int code = pthread_mutex_init(&(pCache->mutex), NULL);
+  if (code != 0) {
+    terrno = TAOS_SYSTEM_ERROR(code);
+    free(pCache);
+    return NULL;
+  }
+
+  pCache->pHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pCache->pHash == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    pthread_mutex_destroy(&(pCache->mutex));
+    free(pCache);
+    return NULL;
+  }
+
+  pCache->capacity = capacity;
+  return pCache;
+}
+
+void tsdbFreeBlockCache(SBlockCache *pCache) {
+  if (pCache == NULL) return;
+
+  SBlockCacheEntry *pEntry = pCache->head;
+  while (pEntry) {
+    SBlockCacheEntry *pNext = pEntry->next;
+    free(pEntry);
+    pEntry = pNext;
+  }
+
+  taosHashCleanup(pCache->pHash);
+  pthread_mutex_destroy(&(pCache->mutex));
+  free(pCache);
+}
+
+// Copy the cached chunk into pDataCol, return false if it is not cached
+bool tsdbGetBlockCacheCol(SBlockCache *pCache, SBlockCacheKey *pKey, SDataCol *pDataCol, int numOfRows,
+                          int maxPoints) {
+  pthread_mutex_lock(&(pCache->mutex));
+
+  SBlockCacheEntry **ppEntry = (SBlockCacheEntry **)taosHashGet(pCache->pHash, pKey, sizeof(*pKey));
+  if (ppEntry == NULL) {
+    pCache->misses++;
+    pthread_mutex_unlock(&(pCache->mutex));
+    return false;
+  }
+
+  SBlockCacheEntry *pEntry = *ppEntry;
+  tsdbUnlinkBlockCacheEntry(pCache, pEntry);
+  tsdbLinkBlockCacheEntry(pCache, pEntry);
+  pCache->hits++;
+
+  tdAllocMemForCol(pDataCol, maxPoints);
+  memcpy(pDataCol->pData, pEntry->data, pEntry->len);
+  pDataCol->len = pEntry->len;
+
+  pthread_mutex_unlock(&(pCache->mutex));
+
+  if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+    dataColSetOffset(pDataCol, numOfRows);
+  }
+
+  return true;
+}
+
+void tsdbPutBlockCacheCol(SBlockCache *pCache, SBlockCacheKey *pKey, SDataCol *pDataCol) {
+  int64_t esize = TSDB_BLOCK_CACHE_ENTRY_SIZE(pDataCol->len);
+  if (esize > pCache->capacity) return;
+
+  SBlockCacheEntry *pEntry = (SBlockCacheEntry *)malloc(esize);
+  if (pEntry == NULL) return;
+
+  memcpy(&(pEntry->key), pKey, sizeof(*pKey));
+  pEntry->len = pDataCol->len;
+  memcpy(pEntry->data, pDataCol->pData, pDataCol->len);
+
+  pthread_mutex_lock(&(pCache->mutex));
+
+  // another query may have loaded the same chunk
+  if (taosHashGet(pCache->pHash, pKey, sizeof(*pKey)) != NULL) {
+    pthread_mutex_unlock(&(pCache->mutex));
+    free(pEntry);
+    return;
+  }
+
+  while (pCache->tail && pCache->size + esize > pCache->capacity) {
+    tsdbRemoveBlockCacheEntry(pCache, pCache->tail);
+  }
+
+  if (taosHashPut(pCache->pHash, pKey, sizeof(*pKey), &pEntry, sizeof(pEntry)) < 0) {
+    pthread_mutex_unlock(&(pCache->mutex));
+    free(pEntry);
+    return;
+  }
+
+  tsdbLinkBlockCacheEntry(pCache, pEntry);
+  pCache->size += esize;
+
+  pthread_mutex_unlock(&(pCache->mutex));
+}
+
+// Drop all the chunks of a file set, called when a new version of the file set is applied
+void tsdbInvalidateBlockCache(SBlockCache *pCache, int fid) {
+  pthread_mutex_lock(&(pCache->mutex));
+
+  SBlockCacheEntry *pEntry = pCache->head;
+  while (pEntry) {
+    SBlockCacheEntry *pNext = pEntry->next;
+    if (pEntry->key.fid == fid) tsdbRemoveBlockCacheEntry(pCache, pEntry);
+    pEntry = pNext;
+  }
+
+  pthread_mutex_unlock(&(pCache->mutex));
+}
+
+void tsdbGetBlockCacheStat(SBlockCache *pCache, int64_t *hits, int64_t *misses, int64_t *size) {
+  pthread_mutex_lock(&(pCache->mutex));
+  *hits = pCache->hits;
+  *misses = pCache->misses;
+  *size = pCache->size;
+  pthread_mutex_unlock(&(pCache->mutex));
+}
+
+static void tsdbUnlinkBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry) {
+  if (pEntry->prev) {
+    pEntry->prev->next = pEntry->next;
+  } else {
+    pCache->head = pEntry->next;
+  }
+
+  if (pEntry->next) {
+    pEntry->next->prev = pEntry->prev;
+  } else {
+    pCache->tail = pEntry->prev;
+  }
+
+  pEntry->prev = NULL;
+  pEntry->next = NULL;
+}
+
+static void tsdbLinkBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry) {
+  pEntry->prev = NULL;
+  pEntry->next = pCache->head;
+  if (pCache->head) {
+    pCache->head->prev = pEntry;
+  } else {
+    pCache->tail = pEntry;
+  }
+  pCache->head = pEntry;
+}
+
+static void tsdbRemoveBlockCacheEntry(SBlockCache *pCache, SBlockCacheEntry *pEntry) {
+  tsdbUnlinkBlockCacheEntry(pCache, pEntry);
+  taosHashRemove(pCache->pHash, &(pEntry->key), sizeof(pEntry->key));
+  pCache->size -= TSDB_BLOCK_CACHE_ENTRY_SIZE(pEntry->len);
+  free(pEntry);
+}
@@ -37,6 +37,7 @@ static void tsdbScanAndTryFixDFilesHeader(STsdbRepo *pRepo, int32_t *nExpired);
 static int  tsdbProcessExpiredFS(STsdbRepo *pRepo);
 static int  tsdbCreateMeta(STsdbRepo *pRepo);
 static int  tsdbFetchTFileSet(STsdbRepo *pRepo, SArray **fArray);
+static void tsdbInvalidateBlockCacheOnTxn(STsdbRepo *pRepo, SFSStatus *pFrom, SFSStatus *pTo);
 
 // For backward compatibility
 // ================== CURRENT file header info
@@ -393,6 +394,7 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
 
   // Apply actual change to each file and SDFileSet
   tsdbApplyFSTxnOnDisk(pfs->nstatus, pfs->cstatus);
+  tsdbInvalidateBlockCacheOnTxn(pRepo, pfs->nstatus, pfs->cstatus);
 
   pfs->intxn = false;
   return 0;
@@ -551,6 +553,27 @@ static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo) {
   }
 }
 
+// Drop the cached blocks of the file sets whose .data or .last file is changed or removed by the transaction
+static void tsdbInvalidateBlockCacheOnTxn(STsdbRepo *pRepo, SFSStatus *pFrom, SFSStatus *pTo) {
+  if (pRepo->blkCache == NULL) return;
+
+  size_t sizeFrom = taosArrayGetSize(pFrom->df);
+  for (size_t i = 0; i < sizeFrom; i++) {
+    SDFileSet *pSetFrom = taosArrayGet(pFrom->df, i);
+    SDFileSet *pSetTo = taosArraySearch(pTo->df, &(pSetFrom->fid), tsdbComparFidFSet, TD_EQ);
+
+    bool changed = (pSetTo == NULL);
+    for (TSDB_FILE_T ftype = TSDB_FILE_DATA; !changed && ftype <= TSDB_FILE_LAST; ftype++) {
+      SDFile *pDFileFrom = TSDB_DFILE_IN_SET(pSetFrom, ftype);
+      SDFile *pDFileTo = TSDB_DFILE_IN_SET(pSetTo, ftype);
+      changed = !tfsIsSameFile(TSDB_FILE_F(pDFileFrom), TSDB_FILE_F(pDFileTo)) ||
+                pDFileFrom->info.magic != pDFileTo->info.magic;
+    }
+
+    if (changed) tsdbInvalidateBlockCache(pRepo->blkCache, pSetFrom->fid);
+  }
+}
+
 // ================== SFSIter
 // ASSUMPTIONS: the FS Should be read locked when calling these functions
 void tsdbFSIterInit(SFSIter *pIter, STsdbFS *pfs, int direction) {
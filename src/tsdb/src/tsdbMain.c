@@ -224,6 +224,16 @@ void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int
   *compStorage = pRepo->stat.compStorage;
 }
 
+void tsdbReportBlockCacheStat(void *repo, int64_t *hits, int64_t *misses) {
+  ASSERT(repo != NULL);
+  STsdbRepo *pRepo = repo;
+  int64_t    size = 0;
+
+  *hits = 0;
+  *misses = 0;
+  if (pRepo->blkCache) tsdbGetBlockCacheStat(pRepo->blkCache, hits, misses, &size);
+}
+
 int32_t tsdbConfigRepo(STsdbRepo *repo, STsdbCfg *pCfg) {
   // TODO: think about multithread cases
   if (tsdbCheckAndSetDefaultCfg(pCfg) < 0) return -1;
@@ -628,15 +638,27 @@ static STsdbRepo *tsdbNewRepo(STsdbCfg *pCfg, STsdbAppH *pAppH) {
     return NULL;
   }
 
+  if (tsdbBlockCacheSize > 0) {
+    pRepo->blkCache = tsdbNewBlockCache((int64_t)tsdbBlockCacheSize * 1024 * 1024);
+    if (pRepo->blkCache == NULL) {
+      tsdbError("vgId:%d failed to create block cache since %s", REPO_ID(pRepo), tstrerror(terrno));
+      tsdbFreeRepo(pRepo);
+      return NULL;
+    }
+  }
+
   return pRepo;
 }
 
 static void tsdbFreeRepo(STsdbRepo *pRepo) {
   if (pRepo) {
+    tsdbRemoveSyncPart(pRepo);
+    tsdbFreeBlockCache(pRepo->blkCache);
     tsdbFreeFS(pRepo->fs);
     tsdbFreeBufPool(pRepo->pPool);
     tsdbFreeMeta(pRepo->tsdbMeta);
     tsdbFreeMergeBuf(pRepo->mergeBuf);
+    taosTZfree(pRepo->submitBuf);
     // tsdbFreeMemTable(pRepo->mem);
     // tsdbFreeMemTable(pRepo->imem);
     tsem_destroy(&(pRepo->readyToCommit));
@@ -36,13 +36,16 @@ typedef struct {
 
 static SMemTable *  tsdbNewMemTable(STsdbRepo *pRepo);
 static void         tsdbFreeMemTable(SMemTable *pMemTable);
-static STableData*  tsdbNewTableData(STsdbCfg *pCfg, STable *pTable);
+static STableData*  tsdbNewTableData(STsdbRepo *pRepo, STable *pTable);
+static void *       tsdbAllocSkipListNode(void *param, int32_t size);
 static void         tsdbFreeTableData(STableData *pTableData);
 static char *       tsdbGetTsTupleKey(const void *data);
 static int          tsdbAdjustMemMaxTables(SMemTable *pMemTable, int maxTables);
 static int          tsdbAppendTableRowToCols(STable *pTable, SDataCols *pCols, STSchema **ppSchema, SMemRow row);
 static int          tsdbInitSubmitBlkIter(SSubmitBlk *pBlock, SSubmitBlkIter *pIter);
 static SMemRow      tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter);
+static int          tsdbCheckColumnarBlock(STsdbRepo *pRepo, STable *pTable, SSubmitBlk *pBlock, TSKEY minKey,
+                                           TSKEY maxKey, TSKEY now);
 static int          tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg);
 static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows);
 static int          tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter);
@@ -559,7 +562,8 @@ static void tsdbFreeMemTable(SMemTable* pMemTable) {
   }
 }
 
-static STableData *tsdbNewTableData(STsdbCfg *pCfg, STable *pTable) {
+static STableData *tsdbNewTableData(STsdbRepo *pRepo, STable *pTable) {
+  STsdbCfg *  pCfg = &(pRepo->config);
   STableData *pTableData = (STableData *)calloc(1, sizeof(*pTableData));
   if (pTableData == NULL) {
     terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
@@ -577,6 +581,12 @@ static STableData *tsdbNewTableData(STsdbCfg *pCfg, STable *pTable) {
   else
     skipListCreateFlags = SL_UPDATE_DUP_KEY;
 
+  if (pCfg->memSkipListMode == TSDB_MEM_SKIPLIST_LOCK_FREE) {
+    skipListCreateFlags |= SL_LOCK_FREE;
+  } else if (pCfg->memSkipListMode == TSDB_MEM_SKIPLIST_RWLOCK) {
+    skipListCreateFlags |= SL_THREAD_SAFE;
+  }
+
   pTableData->pData =
       tSkipListCreate(TSDB_DATA_SKIPLIST_LEVEL, TSDB_DATA_TYPE_TIMESTAMP, TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP],
                       tkeyComparFn, skipListCreateFlags, tsdbGetTsTupleKey);
@@ -586,6 +596,9 @@ static STableData *tsdbNewTableData(STsdbCfg *pCfg, STable *pTable) {
     return NULL;
   }
 
+  // skip list nodes live in the buffer blocks of the mem table, just like the rows they point to
+  tSkipListSetNodeAllocator(pTableData->pData, tsdbAllocSkipListNode, pRepo);
+
   T_REF_INC(pTableData);
 
   return pTableData;
@@ -603,6 +616,14 @@ static void tsdbFreeTableData(STableData *pTableData) {
 
 static char *tsdbGetTsTupleKey(const void *data) { return memRowKeys((SMemRow)data); }
 
+static void *tsdbAllocSkipListNode(void *param, int32_t size) {
+  // buffer blocks are allocated byte by byte, while the node links are accessed atomically and must be aligned
+  void *ptr = tsdbAllocBytes((STsdbRepo *)param, size + POINTER_BYTES - 1);
+  if (ptr == NULL) return NULL;
+
+  return (void *)ALIGN_NUM((uintptr_t)ptr, POINTER_BYTES);
+}
+
 static int tsdbAdjustMemMaxTables(SMemTable *pMemTable, int maxTables) {
   ASSERT(pMemTable->maxTables < maxTables);
 
@@ -663,9 +684,8 @@ static SMemRow tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter) {
   return row;
 }
 
-static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
+static FORCE_INLINE int tsdbCheckKeyRange(STsdbRepo *pRepo, STable *pTable, TSKEY rowKey, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now) {
-  TSKEY rowKey = memRowKey(row);
   if (rowKey < minKey || rowKey > maxKey) {
     tsdbError("vgId:%d table %s tid %d uid %" PRIu64 " timestamp is out of range! now %" PRId64 " minKey %" PRId64
               " maxKey %" PRId64 " row key %" PRId64,
@@ -678,6 +698,131 @@ static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMem
   return 0;
 }
 
+static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
+                                          TSKEY now) {
+  return tsdbCheckKeyRange(pRepo, pTable, memRowKey(row), minKey, maxKey, now);
+}
+
+/*
+ * the columns of the columnar submit block are checked against the schema of its version, since the rows are built
+ * from them without any more check
+ */
+int tsdbCheckColumnarData(STSchema *pSchema, SSubmitBlk *pBlock) {
+  int32_t numOfRows = pBlock->numOfRows;
+  char *  pData = pBlock->data + pBlock->schemaLen;
+  char *  pEnd = pData + pBlock->dataLen;
+
+  if (pSchema == NULL || numOfRows <= 0) goto _err;
+
+  for (int i = 0; i < schemaNCols(pSchema); i++) {
+    STColumn *pCol = schemaColAt(pSchema, i);
+
+    if (!IS_VAR_DATA_TYPE(colType(pCol))) {
+      if (pEnd - pData < (int64_t)numOfRows * TYPE_BYTES[colType(pCol)]) goto _err;
+      pData += numOfRows * TYPE_BYTES[colType(pCol)];
+      continue;
+    }
+
+    if (pEnd - pData < (int64_t)(numOfRows + 1) * sizeof(int32_t)) goto _err;
+
+    int32_t *offsets = (int32_t *)pData;
+    char *   values = pData + (numOfRows + 1) * sizeof(int32_t);
+    if (offsets[0] != 0 || offsets[numOfRows] < 0 || pEnd - values < offsets[numOfRows]) goto _err;
+
+    for (int32_t r = 0; r < numOfRows; r++) {
+      int32_t vlen = offsets[r + 1] - offsets[r];
+      if (vlen < VARSTR_HEADER_SIZE || vlen > colBytes(pCol) || varDataTLen(values + offsets[r]) != vlen) goto _err;
+    }
+
+    pData = values + offsets[numOfRows];
+  }
+
+  if (pData != pEnd) goto _err;
+  return 0;
+
+_err:
+  terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+  return -1;
+}
+
+static int tsdbCheckColumnarBlock(STsdbRepo *pRepo, STable *pTable, SSubmitBlk *pBlock, TSKEY minKey, TSKEY maxKey,
+                                  TSKEY now) {
+  STSchema *pSchema = tsdbGetTableSchemaByVersion(pTable, pBlock->sversion, -1);
+
+  if (tsdbCheckColumnarData(pSchema, pBlock) < 0) {
+    tsdbError("vgId:%d table %s tid %d uid %" PRIu64 " columnar submit block of %d rows is messed up", REPO_ID(pRepo),
+              TABLE_CHAR_NAME(pTable), TABLE_TID(pTable), TABLE_UID(pTable), pBlock->numOfRows);
+    return -1;
+  }
+
+  // the timestamps are the first column
+  TSKEY *keys = (TSKEY *)(pBlock->data + pBlock->schemaLen);
+  for (int32_t r = 0; r < pBlock->numOfRows; r++) {
+    if (tsdbCheckKeyRange(pRepo, pTable, keys[r], minKey, maxKey, now) < 0) return -1;
+  }
+
+  return 0;
+}
+
+// the rows of the columnar submit block are built one by one in *ppBuf, the submit buffer of the repo
+int tsdbInitSubmitColIter(STSchema *pSchema, SSubmitBlk *pBlock, void **ppBuf, SSubmitColIter *pIter) {
+  int numOfCols = schemaNCols(pSchema);
+
+  if (tsdbMakeRoom(ppBuf, POINTER_BYTES * numOfCols + TD_MEM_ROW_DATA_HEAD_SIZE + schemaTLen(pSchema)) < 0) {
+    return -1;
+  }
+
+  pIter->numOfRows = pBlock->numOfRows;
+  pIter->row = 0;
+  pIter->pSchema = pSchema;
+  pIter->pCols = *ppBuf;
+  pIter->memRow = POINTER_SHIFT(*ppBuf, POINTER_BYTES * numOfCols);
+
+  char *pData = pBlock->data + pBlock->schemaLen;
+  for (int i = 0; i < numOfCols; i++) {
+    STColumn *pCol = schemaColAt(pSchema, i);
+
+    pIter->pCols[i] = pData;
+    if (IS_VAR_DATA_TYPE(colType(pCol))) {
+      int32_t *offsets = (int32_t *)pData;
+      pData += (pIter->numOfRows + 1) * sizeof(int32_t) + offsets[pIter->numOfRows];
+    } else {
+      pData += pIter->numOfRows * TYPE_BYTES[colType(pCol)];
+    }
+  }
+
+  return 0;
+}
+
+SMemRow tsdbGetSubmitColNext(SSubmitColIter *pIter) {
+  if (pIter->row >= pIter->numOfRows) return NULL;
+
+  STSchema *pSchema = pIter->pSchema;
+  SMemRow   memRow = pIter->memRow;
+  SDataRow  row = memRowDataBody(memRow);
+  int32_t   r = pIter->row++;
+
+  memRowSetType(memRow, SMEM_ROW_DATA);
+  dataRowSetLen(row, (TDRowLenT)(TD_DATA_ROW_HEAD_SIZE + schemaFLen(pSchema)));
+  dataRowSetVersion(row, schemaVersion(pSchema));
+
+  for (int i = 0; i < schemaNCols(pSchema); i++) {
+    STColumn *pCol = schemaColAt(pSchema, i);
+    char *    value = NULL;
+
+    if (IS_VAR_DATA_TYPE(colType(pCol))) {
+      int32_t *offsets = (int32_t *)pIter->pCols[i];
+      value = (char *)(offsets + pIter->numOfRows + 1) + offsets[r];
+    } else {
+      value = pIter->pCols[i] + TYPE_BYTES[colType(pCol)] * r;
+    }
+
+    tdAppendColVal(row, value, colType(pCol), colOffset(pCol));
+  }
+
+  return memRow;
+}
+
 static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
   ASSERT(pMsg != NULL);
   STsdbMeta *    pMeta = pRepo->tsdbMeta;
@@ -740,7 +885,11 @@ static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
     }
 
     // check each row time invalid if not control block
-    if (!IS_CONTROL_BLOCK(pBlock)) {
+    if (IS_COLUMNAR_BLOCK(pBlock)) {
+      if (tsdbCheckColumnarBlock(pRepo, pTable, pBlock, minKey, maxKey, now) < 0) {
+        return -1;
+      }
+    } else if (!IS_CONTROL_BLOCK(pBlock)) {
       tsdbInitSubmitBlkIter(pBlock, &blkIter);
       while ((row = tsdbGetSubmitBlkNext(&blkIter)) != NULL) {
         if (tsdbCheckRowRange(pRepo, pTable, row, minKey, maxKey, now) < 0) {
@@ -836,13 +985,19 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   int32_t          points = 0;
   STable          *pTable = NULL;
   SSubmitBlkIter   blkIter = {0};
+  SSubmitColIter   colIter = {0};
   SMemTable       *pMemTable = NULL;
   STableData      *pTableData = NULL;
-  STsdbCfg        *pCfg = &(pRepo->config);
+  TSKEY            firstRowKey = 0;
 
-  tsdbInitSubmitBlkIter(pBlock, &blkIter);
-  if(blkIter.row == NULL) return 0;
-  TSKEY firstRowKey = memRowKey(blkIter.row);
+  if (IS_COLUMNAR_BLOCK(pBlock)) {
+    if (pBlock->numOfRows <= 0) return 0;
+    firstRowKey = *(TSKEY *)(pBlock->data + pBlock->schemaLen);
+  } else {
+    tsdbInitSubmitBlkIter(pBlock, &blkIter);
+    if(blkIter.row == NULL) return 0;
+    firstRowKey = memRowKey(blkIter.row);
+  }
 
   tsdbAllocBytes(pRepo, 0);
   pMemTable = pRepo->mem;
@@ -870,7 +1025,7 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
       taosWUnLockLatch(&(pMemTable->latch));
     }
 
-    pTableData = tsdbNewTableData(pCfg, pTable);
+    pTableData = tsdbNewTableData(pRepo, pTable);
     if (pTableData == NULL) {
       tsdbError("vgId:%d failed to insert data to table %s uid %" PRId64 " tid %d since %s", REPO_ID(pRepo),
                 TABLE_CHAR_NAME(pTable), TABLE_UID(pTable), TABLE_TID(pTable), tstrerror(terrno));
@@ -885,7 +1040,13 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   SMemRow lastRow = NULL;
   int64_t osize = SL_SIZE(pTableData->pData);
   tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow);
-  tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
+  if (IS_COLUMNAR_BLOCK(pBlock)) {
+    STSchema *pSchema = tsdbGetTableSchemaByVersion(pTable, pBlock->sversion, -1);
+    if (tsdbInitSubmitColIter(pSchema, pBlock, &pRepo->submitBuf, &colIter) < 0) return -1;
+    tSkipListPutBatchByIter(pTableData->pData, &colIter, (iter_next_fn_t)tsdbGetSubmitColNext);
+  } else {
+    tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
+  }
   int64_t dsize = SL_SIZE(pTableData->pData) - osize;
   (*pAffectedRows) += points;
 
@@ -27,6 +27,13 @@ static int     tsdbAddTableToMeta(STsdbRepo *pRepo, STable *pTable, bool addIdx,
 static void    tsdbRemoveTableFromMeta(STsdbRepo *pRepo, STable *pTable, bool rmFromIdx, bool lock);
 static int     tsdbAddTableIntoIndex(STsdbMeta *pMeta, STable *pTable, bool refSuper);
 static int     tsdbRemoveTableFromIndex(STsdbMeta *pMeta, STable *pTable);
+static int     tsdbAddTableIntoTagIndex(STable *pSTable, STable *pTable);
+static int     tsdbAddTableIntoTagIndexCol(STable *pSTable, STable *pTable, STColumn *pCol);
+static void    tsdbRemoveTableFromTagIndex(STable *pSTable, STable *pTable);
+static void    tsdbDropFailedTagIndex(STable *pSTable, STable *pTable);
+static void    tsdbRemoveTableFromTagIndexCol(STagIndex *pTagIdx, STable *pTable);
+static void    tsdbDropStaleTagIndex(STable *pSTable);
+static void    tsdbFreeTagIndex(SArray *pTagIndex);
 static int     tsdbInitTableCfg(STableCfg *config, ETableType type, uint64_t uid, int32_t tid);
 static int     tsdbTableSetSchema(STableCfg *config, STSchema *pSchema, bool dup);
 static int     tsdbTableSetName(STableCfg *config, char *name, bool dup);
@@ -118,6 +125,7 @@ int tsdbCreateTable(STsdbRepo *repo, STableCfg *pCfg) {
 
   // Register to meta
   tsdbWLockRepoMeta(pRepo);
+  if (superChanged) tsdbDropStaleTagIndex(super);
   if (newSuper) {
     if (tsdbAddTableToMeta(pRepo, super, true, false) < 0) {
       super = NULL;
@@ -391,16 +399,26 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
     pTable->pSuper->tagSchema = pNewSchema;
     tdFreeSchema(pOldSchema);
     TSDB_WUNLOCK_TABLE(pTable->pSuper);
+
+    tsdbWLockRepoMeta(pRepo);
+    tsdbDropStaleTagIndex(pTable->pSuper);
+    tsdbUnlockRepoMeta(pRepo);
   }
 
   bool      isChangeIndexCol = (pMsg->colId == colColId(schemaColAt(pTable->pSuper->tagSchema, 0)))
       || pMsg->type == TSDB_DATA_TYPE_JSON;
+  // only the index of the changed tag is updated if it is not the first one
+  STColumn *pTagCol = (!isChangeIndexCol && tsdbTagIndex) ? tdGetColOfID(pTable->pSuper->tagSchema, pMsg->colId) : NULL;
   // STColumn *pCol = bsearch(&(pMsg->colId), pMsg->data, pMsg->numOfTags, sizeof(STColumn), colIdCompar);
   // ASSERT(pCol != NULL);
 
   if (isChangeIndexCol) {
     tsdbWLockRepoMeta(pRepo);
     tsdbRemoveTableFromIndex(pMeta, pTable);
+  } else if (pTagCol != NULL) {
+    tsdbWLockRepoMeta(pRepo);
+    STagIndex *pTagIdx = tsdbGetTagIndex(pTable->pSuper, pMsg->colId);
+    if (pTagIdx != NULL) tsdbRemoveTableFromTagIndexCol(pTagIdx, pTable);
   }
   TSDB_WLOCK_TABLE(pTable);
   if (pMsg->type == TSDB_DATA_TYPE_JSON){
@@ -411,7 +429,15 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
   }
   TSDB_WUNLOCK_TABLE(pTable);
   if (isChangeIndexCol) {
-    tsdbAddTableIntoIndex(pMeta, pTable, false);
+    if (tsdbAddTableIntoIndex(pMeta, pTable, false) < 0) {
+      tsdbError("vgId:%d failed to index table %s after its tag is updated since %s", REPO_ID(pRepo),
+                TABLE_CHAR_NAME(pTable), tstrerror(terrno));
+    }
+    tsdbUnlockRepoMeta(pRepo);
+  } else if (pTagCol != NULL) {
+    if (tsdbAddTableIntoTagIndexCol(pTable->pSuper, pTable, pTagCol) < 0) {
+      tsdbDropFailedTagIndex(pTable->pSuper, pTable);
+    }
     tsdbUnlockRepoMeta(pRepo);
   }
 
@@ -792,8 +818,9 @@ void tsdbOrgMeta(STsdbRepo *pRepo) {
 
   for (int i = 1; i < pMeta->maxTables; i++) {
     STable *pTable = pMeta->tables[i];
-    if (pTable != NULL && pTable->type == TSDB_CHILD_TABLE) {
-      tsdbAddTableIntoIndex(pMeta, pTable, true);
+    if (pTable != NULL && pTable->type == TSDB_CHILD_TABLE && tsdbAddTableIntoIndex(pMeta, pTable, true) < 0) {
+      tsdbError("vgId:%d failed to index table %s since %s", REPO_ID(pRepo), TABLE_CHAR_NAME(pTable),
+                tstrerror(terrno));
     }
   }
 }
@@ -947,6 +974,7 @@ static void tsdbFreeTable(STable *pTable) {
 
     tSkipListDestroy(pTable->pIndex);
     taosHashCleanup(pTable->jsonKeyMap);
+    tsdbFreeTagIndex(pTable->pTagIndex);
     taosTZfree(pTable->lastRow);    
     tfree(pTable->sql);
 
@@ -1084,6 +1112,18 @@ void* tsdbGetJsonTagValue(STable* pTable, char* key, int32_t keyLen, int16_t* re
   return tdGetKVRowValOfCol(pTable->tagVal, colId);
 }
 
+STagIndex* tsdbGetTagIndex(STable* pSTable, int16_t colId) {
+  if (pSTable->pTagIndex == NULL) return NULL;
+
+  size_t size = taosArrayGetSize(pSTable->pTagIndex);
+  for (size_t i = 0; i < size; ++i) {
+    STagIndex* pTagIdx = taosArrayGet(pSTable->pTagIndex, i);
+    if (pTagIdx->colId == colId) return pTagIdx;
+  }
+
+  return NULL;
+}
+
 int tsdbCompareJsonMapValue(const void* a, const void* b) {
   const JsonMapValue* x = (const JsonMapValue*)a;
   const JsonMapValue* y = (const JsonMapValue*)b;
@@ -1155,6 +1195,10 @@ static int tsdbAddTableIntoIndex(STsdbMeta *pMeta, STable *pTable, bool refSuper
     }
   }else{
     tSkipListPut(pSTable->pIndex, (void *)pTable);
+    // the table is already in the skiplist, so a failure of the tag index only drops it
+    if (tsdbTagIndex && tsdbAddTableIntoTagIndex(pSTable, pTable) < 0) {
+      tsdbDropFailedTagIndex(pSTable, pTable);
+    }
   }
 
   return 0;
@@ -1217,10 +1261,145 @@ static int tsdbRemoveTableFromIndex(STsdbMeta *pMeta, STable *pTable) {
     }
 
     taosArrayDestroy(&res);
+
+    tsdbRemoveTableFromTagIndex(pSTable, pTable);
+  }
+  return 0;
+}
+
+static void tsdbFreeTagIndexBitmap(void *p) { tRoaringDestroy(*(SRoaringBitmap **)p); }
+
+// Index the tags other than the first one, which is already in the skiplist. A NULL tag value is not indexed.
+static int tsdbAddTableIntoTagIndex(STable *pSTable, STable *pTable) {
+  STSchema *pSchema = pSTable->tagSchema;
+
+  for (int i = DEFAULT_TAG_INDEX_COLUMN + 1; i < schemaNCols(pSchema); ++i) {
+    if (tsdbAddTableIntoTagIndexCol(pSTable, pTable, schemaColAt(pSchema, i)) < 0) return -1;
+  }
+
+  return 0;
+}
+
+static int tsdbAddTableIntoTagIndexCol(STable *pSTable, STable *pTable, STColumn *pCol) {
+  if (pSTable->tagIndexFailed) return 0;
+
+  uint32_t tid = (uint32_t)TABLE_TID(pTable);
+  void *   val = tdGetKVRowValOfCol(pTable->tagVal, colColId(pCol));
+  if (val == NULL || isNull(val, colType(pCol))) return 0;
+
+  if (pSTable->pTagIndex == NULL) {
+    pSTable->pTagIndex = taosArrayInit(schemaNCols(pSTable->tagSchema), sizeof(STagIndex));
+    if (pSTable->pTagIndex == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  STagIndex *pTagIdx = tsdbGetTagIndex(pSTable, colColId(pCol));
+  if (pTagIdx == NULL) {
+    STagIndex tagIdx = {.colId = colColId(pCol), .type = colType(pCol)};
+    tagIdx.valMap = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_ENTRY_LOCK);
+    tagIdx.notNull = tRoaringCreate();
+    if (tagIdx.valMap == NULL || tagIdx.notNull == NULL) {
+      taosHashCleanup(tagIdx.valMap);
+      tRoaringDestroy(tagIdx.notNull);
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+    taosHashSetFreeFp(tagIdx.valMap, tsdbFreeTagIndexBitmap);
+    pTagIdx = taosArrayPush(pSTable->pTagIndex, &tagIdx);
   }
+
+  int32_t          keyLen = tsdbGetTagIndexKeyLen(pTagIdx->type, val);
+  SRoaringBitmap **ppTids = (SRoaringBitmap **)taosHashGet(pTagIdx->valMap, val, keyLen);
+  SRoaringBitmap * pTids = NULL;
+  if (ppTids == NULL) {
+    pTids = tRoaringCreate();
+    if (pTids == NULL || taosHashPut(pTagIdx->valMap, val, keyLen, &pTids, sizeof(void *)) < 0) {
+      tRoaringDestroy(pTids);
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  } else {
+    pTids = *ppTids;
+  }
+
+  if (tRoaringAdd(pTids, tid) < 0 || tRoaringAdd(pTagIdx->notNull, tid) < 0) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
   return 0;
 }
 
+// An index missing a table would make the queries miss it, so the whole tag index is dropped and not built again until
+// the vnode is opened again. queryByTagIndex then falls back to the skiplist scan.
+static void tsdbDropFailedTagIndex(STable *pSTable, STable *pTable) {
+  tsdbError("failed to index the tags of table %s since %s, the tag index of %s is dropped", TABLE_CHAR_NAME(pTable),
+            tstrerror(terrno), TABLE_CHAR_NAME(pSTable));
+
+  tsdbFreeTagIndex(pSTable->pTagIndex);
+  pSTable->pTagIndex = NULL;
+  pSTable->tagIndexFailed = true;
+}
+
+static void tsdbRemoveTableFromTagIndex(STable *pSTable, STable *pTable) {
+  if (pSTable->pTagIndex == NULL) return;
+
+  size_t size = taosArrayGetSize(pSTable->pTagIndex);
+  for (size_t i = 0; i < size; ++i) {
+    tsdbRemoveTableFromTagIndexCol(taosArrayGet(pSTable->pTagIndex, i), pTable);
+  }
+}
+
+static void tsdbRemoveTableFromTagIndexCol(STagIndex *pTagIdx, STable *pTable) {
+  uint32_t tid = (uint32_t)TABLE_TID(pTable);
+  void *   val = tdGetKVRowValOfCol(pTable->tagVal, pTagIdx->colId);
+  if (val == NULL || isNull(val, pTagIdx->type)) return;
+
+  int32_t          keyLen = tsdbGetTagIndexKeyLen(pTagIdx->type, val);
+  SRoaringBitmap **ppTids = (SRoaringBitmap **)taosHashGet(pTagIdx->valMap, val, keyLen);
+  if (ppTids == NULL) return;
+
+  tRoaringRemove(*ppTids, tid);
+  tRoaringRemove(pTagIdx->notNull, tid);
+  if (tRoaringCardinality(*ppTids) == 0) {
+    taosHashRemove(pTagIdx->valMap, val, keyLen);
+  }
+}
+
+// Free the indexes of the tags which are dropped from the tag schema, or have become the first tag
+static void tsdbDropStaleTagIndex(STable *pSTable) {
+  if (pSTable->pTagIndex == NULL) return;
+
+  STSchema *pSchema = pSTable->tagSchema;
+  for (size_t i = 0; i < taosArrayGetSize(pSTable->pTagIndex);) {
+    STagIndex *pTagIdx = taosArrayGet(pSTable->pTagIndex, i);
+    STColumn * pCol = tdGetColOfID(pSchema, pTagIdx->colId);
+    if (pCol != NULL && pCol != schemaColAt(pSchema, DEFAULT_TAG_INDEX_COLUMN) && colType(pCol) == pTagIdx->type) {
+      ++i;
+      continue;
+    }
+
+    taosHashCleanup(pTagIdx->valMap);
+    tRoaringDestroy(pTagIdx->notNull);
+    taosArrayRemove(pSTable->pTagIndex, i);
+  }
+}
+
+static void tsdbFreeTagIndex(SArray *pTagIndex) {
+  if (pTagIndex == NULL) return;
+
+  size_t size = taosArrayGetSize(pTagIndex);
+  for (size_t i = 0; i < size; ++i) {
+    STagIndex *pTagIdx = taosArrayGet(pTagIndex, i);
+    taosHashCleanup(pTagIdx->valMap);
+    tRoaringDestroy(pTagIdx->notNull);
+  }
+
+  taosArrayDestroy(&pTagIndex);
+}
+
 static int tsdbInitTableCfg(STableCfg *config, ETableType type, uint64_t uid, int32_t tid) {
   if (type != TSDB_CHILD_TABLE && type != TSDB_NORMAL_TABLE && type != TSDB_STREAM_TABLE) {
     terrno = TSDB_CODE_TDB_INVALID_TABLE_TYPE;
@@ -1600,6 +1779,11 @@ static int tsdbRmTableFromMeta(STsdbRepo *pRepo, STable *pTable) {
       }
       tSkipListDestroyIter(pIter);
     }
+
+    // the super table may be kept by queries for a while, its tag indexes are useless from now on
+    tsdbFreeTagIndex(pTable->pTagIndex);
+    pTable->pTagIndex = NULL;
+
     tsdbRemoveTableFromMeta(pRepo, pTable, false, false);
     tsdbUnlockRepoMeta(pRepo);
   } else {
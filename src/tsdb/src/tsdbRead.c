@@ -187,7 +187,7 @@ static int32_t doGetExternalRow(STsdbQueryHandle* pQueryHandle, int16_t type, SM
 static void*   doFreeColumnInfoData(SArray* pColumnInfoData);
 static void*   destroyTableCheckInfo(SArray* pTableCheckInfo);
 static bool    tsdbGetExternalRow(TsdbQueryHandleT pHandle);
-static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo);
+static int32_t tsdbQueryTableList(STsdbMeta* pMeta, STable* pTable, SArray* pRes, void* filterInfo);
 static STableBlockInfo* moveToNextDataBlockInCurrentFile(STsdbQueryHandle* pQueryHandle);
 static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCheckInfo);
 static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order, int32_t update, SMemRow* extraRow);
@@ -453,6 +453,7 @@ static STsdbQueryHandle* tsdbQueryTablesImpl(STsdbRepo* tsdb, STsdbQueryCond* pC
   if (tsdbInitReadH(&pQueryHandle->rhelper, (STsdbRepo*)tsdb) != 0) {
     goto _end;
   }
+  pQueryHandle->rhelper.useBlkCache = true;
 
   assert(pCond != NULL && pMemRef != NULL);
   setQueryTimewindow(pQueryHandle, pCond);
@@ -1500,6 +1501,19 @@ static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBloc
 
   int16_t* colIds = pQueryHandle->defaultLoadColumn->pData;
 
+  // issue the reads of the following blocks so that they are on the way while this one is decoded
+  if (tsdbReadAheadBlocks > 0 && slotIndex >= 0 && slotIndex < pQueryHandle->numOfBlocks) {
+    int32_t step = ASCENDING_TRAVERSE(pQueryHandle->order) ? 1 : -1;
+    for (int32_t i = 1; i <= tsdbReadAheadBlocks; ++i) {
+      int32_t next = slotIndex + i * step;
+      if (next < 0 || next >= pQueryHandle->numOfBlocks) break;
+      if (tsdbReadAheadBlock(&(pQueryHandle->rhelper), pQueryHandle->pDataBlockInfo[next].compBlock, colIds,
+                             (int)(QH_GET_NUM_OF_COLS(pQueryHandle))) < 0) {
+        break;
+      }
+    }
+  }
+
   int32_t ret = tsdbLoadBlockDataCols(&(pQueryHandle->rhelper), pBlock, pCheckInfo->pCompInfo, colIds, (int)(QH_GET_NUM_OF_COLS(pQueryHandle)));
   if (ret != TSDB_CODE_SUCCESS) {
     int32_t c = terrno;
@@ -2871,6 +2885,52 @@ int32_t tsdbGetFileBlocksDistInfo(TsdbQueryHandleT* queryHandle, STableBlockDist
   return code;
 }
 
+SArray* tsdbGetFileSetWindows(STsdbRepo* tsdb, STimeWindow* pWindow) {
+  assert(pWindow->skey <= pWindow->ekey);
+
+  SArray* pWindows = taosArrayInit(4, sizeof(STimeWindow));
+  if (pWindows == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  STsdbFS*  pFileHandle = REPO_FS(tsdb);
+  STsdbCfg* pCfg = &tsdb->config;
+  int32_t   fid = getFileIdFromKey(pWindow->skey, pCfg->daysPerFile, pCfg->precision);
+
+  // each file set starts a new sub window, the rows before the first file set and those after the last one, which
+  // reside only in the mem/imem table, are attached to the first and the last sub window respectively.
+  STimeWindow win = *pWindow;
+  STimeWindow frange = TSWINDOW_INITIALIZER;
+  SFSIter     fsIter;
+  SDFileSet*  pSet = NULL;
+
+  tsdbRLockFS(pFileHandle);
+  tsdbFSIterInit(&fsIter, pFileHandle, TSDB_FS_ITER_FORWARD);
+  tsdbFSIterSeek(&fsIter, fid);
+
+  while ((pSet = tsdbFSIterNext(&fsIter)) != NULL) {
+    tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, pSet->fid, &frange.skey, &frange.ekey);
+    if (frange.skey > pWindow->ekey) {
+      break;
+    }
+
+    if (frange.skey <= win.skey) {
+      continue;
+    }
+
+    win.ekey = frange.skey - 1;
+    taosArrayPush(pWindows, &win);
+    win.skey = frange.skey;
+  }
+
+  tsdbUnLockFS(pFileHandle);
+
+  win.ekey = pWindow->ekey;
+  taosArrayPush(pWindows, &win);
+  return pWindows;
+}
+
 static int32_t getDataBlocksInFiles(STsdbQueryHandle* pQueryHandle, bool* exists) {
   STsdbFS*       pFileHandle = REPO_FS(pQueryHandle->pTsdb);
   SQueryFilePos* cur = &pQueryHandle->cur;
@@ -4026,6 +4086,148 @@ SArray* createTableGroup(SArray* pTableList, STSchema* pTagSchema, SColIndex* pC
   return pTableGroup;
 }
 
+static int32_t tagIndexKeyComparFn(const void *p1, const void *p2, const void *param) {
+  const STColumn* pCol = (const STColumn*) param;
+  return doCompare(*(const char**)p1, *(const char**)p2, pCol->type, pCol->bytes);
+}
+
+static void tagIndexGroupDestroy(SArray* pGroups) {
+  if (pGroups == NULL) return;
+
+  size_t num = taosArrayGetSize(pGroups);
+  for (int32_t i = 0; i < num; ++i) {
+    SArray* g = taosArrayGetP(pGroups, i);
+    for (int32_t j = 0; j < taosArrayGetSize(g); ++j) {
+      tsdbUnRefTable(((STableKeyInfo*)taosArrayGet(g, j))->pTable);
+    }
+    taosArrayDestroy(&g);
+  }
+  taosArrayDestroy(&pGroups);
+}
+
+/*
+ * Group the tables by one tag which has a tag index. The distinct values of the tag are sorted instead of the tables,
+ * and each group is the bitmap of the value intersected with the bitmap of the tables. The tables whose tag is NULL
+ * are grouped by sorting as before, and the two group lists are merged in order. NULL is returned if the tag index
+ * can not be used, or has more distinct values than the tables to group.
+ */
+static SArray* createTableGroupByTagIndex(STsdbMeta* pMeta, STable* pSTable, SArray* pTableList, SColIndex* pCols,
+                                          int32_t numOfOrderCols, TSKEY skey) {
+  STSchema* pTagSchema = pSTable->tagSchema;
+  size_t    size = taosArrayGetSize(pTableList);
+
+  if (numOfOrderCols != 1 || size <= 1 || pCols->colIndex < 0 || pCols->colIndex >= schemaNCols(pTagSchema)) {
+    return NULL;
+  }
+
+  STColumn*  pCol = schemaColAt(pTagSchema, pCols->colIndex);
+  STagIndex* pTagIdx = tsdbGetTagIndex(pSTable, pCol->colId);
+  if (pTagIdx == NULL || pTagIdx->type != pCol->type || taosHashGetSize(pTagIdx->valMap) >= size) {
+    return NULL;
+  }
+
+  SArray*         pGroups = taosArrayInit(16, POINTER_BYTES);
+  SArray*         pNullList = taosArrayInit(4, sizeof(STableKeyInfo));
+  SArray*         pNullGroups = taosArrayInit(4, POINTER_BYTES);
+  SArray*         pKeys = taosArrayInit(taosHashGetSize(pTagIdx->valMap), POINTER_BYTES);
+  SRoaringBitmap* pTids = tRoaringCreate();
+  if (pGroups == NULL || pNullList == NULL || pNullGroups == NULL || pKeys == NULL || pTids == NULL) {
+    goto _err;
+  }
+
+  for (int32_t i = 0; i < size; ++i) {
+    STableKeyInfo* pKeyInfo = taosArrayGet(pTableList, i);
+    STable*        pTable = pKeyInfo->pTable;
+    void*          val = tdGetKVRowValOfCol(pTable->tagVal, pCol->colId);
+    if (val == NULL || isNull(val, pCol->type)) {
+      taosArrayPush(pNullList, pKeyInfo);
+    } else if (tRoaringAdd(pTids, (uint32_t)TABLE_TID(pTable)) < 0) {
+      goto _err;
+    }
+  }
+
+  void** ppTids = taosHashIterate(pTagIdx->valMap, NULL);
+  while (ppTids != NULL) {
+    void* key = taosHashGetDataKey(pTagIdx->valMap, ppTids);
+    taosArrayPush(pKeys, &key);
+    ppTids = taosHashIterate(pTagIdx->valMap, ppTids);
+  }
+
+  taosqsort(pKeys->pData, taosArrayGetSize(pKeys), POINTER_BYTES, pCol, tagIndexKeyComparFn);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pKeys); ++i) {
+    char*            key = taosArrayGetP(pKeys, i);
+    SRoaringBitmap** ppValTids = taosHashGet(pTagIdx->valMap, key, tsdbGetTagIndexKeyLen(pCol->type, key));
+    SRoaringBitmap*  pGroupTids = tRoaringAnd(*ppValTids, pTids);
+    if (pGroupTids == NULL) goto _err;
+
+    if (tRoaringCardinality(pGroupTids) > 0) {
+      SArray*      g = taosArrayInit((size_t)tRoaringCardinality(pGroupTids), sizeof(STableKeyInfo));
+      SRoaringIter iter;
+      uint32_t     tid = 0;
+
+      tRoaringIterInit(&iter, pGroupTids);
+      while (g != NULL && tRoaringIterNext(&iter, &tid)) {
+        STableKeyInfo info = {.pTable = pMeta->tables[tid], .lastKey = skey};
+        tsdbRefTable(info.pTable);
+        taosArrayPush(g, &info);
+      }
+
+      if (g == NULL) {
+        tRoaringDestroy(pGroupTids);
+        goto _err;
+      }
+      taosArrayPush(pGroups, &g);
+    }
+
+    tRoaringDestroy(pGroupTids);
+  }
+
+  if (taosArrayGetSize(pNullList) > 0) {
+    STableGroupSupporter sup = {.numOfCols = numOfOrderCols, .pCols = pCols, .pTagSchema = pTagSchema};
+
+    taosqsort(pNullList->pData, taosArrayGetSize(pNullList), sizeof(STableKeyInfo), &sup, tableGroupComparFn);
+    createTableGroupImpl(pNullGroups, pNullList, taosArrayGetSize(pNullList), skey, &sup, tableGroupComparFn);
+
+    // NULL tags may sort before or after the values, depending on the type
+    SArray* pMerged = taosArrayInit(taosArrayGetSize(pGroups) + taosArrayGetSize(pNullGroups), POINTER_BYTES);
+    if (pMerged == NULL) goto _err;
+
+    size_t i = 0, j = 0;
+    while (i < taosArrayGetSize(pGroups) || j < taosArrayGetSize(pNullGroups)) {
+      SArray* g1 = (i < taosArrayGetSize(pGroups)) ? taosArrayGetP(pGroups, i) : NULL;
+      SArray* g2 = (j < taosArrayGetSize(pNullGroups)) ? taosArrayGetP(pNullGroups, j) : NULL;
+      if (g2 == NULL || (g1 != NULL && tableGroupComparFn(taosArrayGet(g1, 0), taosArrayGet(g2, 0), &sup) <= 0)) {
+        taosArrayPush(pMerged, &g1);
+        i++;
+      } else {
+        taosArrayPush(pMerged, &g2);
+        j++;
+      }
+    }
+
+    taosArrayDestroy(&pGroups);
+    taosArrayClear(pNullGroups);
+    pGroups = pMerged;
+  }
+
+  tsdbDebug("%" PRIzu " tables are grouped by tag index of %" PRIzu " values", size, taosArrayGetSize(pKeys));
+
+  taosArrayDestroy(&pNullList);
+  taosArrayDestroy(&pNullGroups);
+  taosArrayDestroy(&pKeys);
+  tRoaringDestroy(pTids);
+  return pGroups;
+
+_err:
+  tagIndexGroupDestroy(pGroups);
+  tagIndexGroupDestroy(pNullGroups);
+  taosArrayDestroy(&pNullList);
+  taosArrayDestroy(&pKeys);
+  tRoaringDestroy(pTids);
+  return NULL;
+}
+
 int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, const char* pTagCond, size_t len,
                                  STableGroupInfo* pGroupInfo, SColIndex* pColIndex, int32_t numOfCols) {
   SArray* res = NULL;
@@ -4062,7 +4264,10 @@ int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, cons
     }
 
     pGroupInfo->numOfTables = (uint32_t) taosArrayGetSize(res);
-    pGroupInfo->pGroupList  = createTableGroup(res, pTagSchema, pColIndex, numOfCols, skey);
+    pGroupInfo->pGroupList  = createTableGroupByTagIndex(tsdbGetMeta(tsdb), pTable, res, pColIndex, numOfCols, skey);
+    if (pGroupInfo->pGroupList == NULL) {
+      pGroupInfo->pGroupList = createTableGroup(res, pTagSchema, pColIndex, numOfCols, skey);
+    }
     pGroupInfo->sVersion = tsdbGetTableSchema(pTable)->version;
     pGroupInfo->tVersion = pTagSchema->version;
     tsdbDebug("%p no table name/tag condition, all tables qualified, numOfTables:%u, group:%zu", tsdb,
@@ -4101,7 +4306,7 @@ int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, cons
     goto _error;
   }
 
-  ret = tsdbQueryTableList(pTable, res, filterInfo);
+  ret = tsdbQueryTableList(tsdbGetMeta(tsdb), pTable, res, filterInfo);
   if (ret != TSDB_CODE_SUCCESS) {
     terrno = ret;
     tsdbUnlockRepoMeta(tsdb);
@@ -4112,7 +4317,10 @@ int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, cons
   filterFreeInfo(filterInfo);
 
   pGroupInfo->numOfTables = (uint32_t)taosArrayGetSize(res);
-  pGroupInfo->pGroupList  = createTableGroup(res, pTagSchema, pColIndex, numOfCols, skey);
+  pGroupInfo->pGroupList  = createTableGroupByTagIndex(tsdbGetMeta(tsdb), pTable, res, pColIndex, numOfCols, skey);
+  if (pGroupInfo->pGroupList == NULL) {
+    pGroupInfo->pGroupList = createTableGroup(res, pTagSchema, pColIndex, numOfCols, skey);
+  }
 
   tsdbDebug("%p stable tid:%d, uid:%"PRIu64" query, numOfTables:%u, belong to %" PRIzu " groups", tsdb, pTable->tableId.tid,
       pTable->tableId.uid, pGroupInfo->numOfTables, taosArrayGetSize(pGroupInfo->pGroupList));
@@ -4500,7 +4708,168 @@ static int32_t queryByJsonTag(STable* pTable, void* filterInfo, SArray* res){
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo) {
+// union the bitmaps pairwise level by level, so that each tid is copied only O(log n) times
+static SRoaringBitmap* tsdbUnionTagIndexBitmaps(SArray* bitmaps) {
+  size_t n = taosArrayGetSize(bitmaps);
+  if (n == 0) {
+    return tRoaringCreate();
+  }
+
+  // the first level reads the bitmaps of the index, the later levels consume their own results
+  SRoaringBitmap** level = malloc(sizeof(SRoaringBitmap*) * ((n + 1) / 2));
+  if (level == NULL) {
+    return NULL;
+  }
+
+  size_t num = 0;
+  bool   oom = false;
+  for (size_t i = 0; i < n; i += 2) {
+    SRoaringBitmap* p1 = taosArrayGetP(bitmaps, i);
+    level[num] = (i + 1 < n) ? tRoaringOr(p1, taosArrayGetP(bitmaps, i + 1)) : tRoaringDup(p1);
+    if (level[num++] == NULL) oom = true;
+  }
+
+  while (!oom && num > 1) {
+    size_t next = 0;
+    for (size_t i = 0; i < num; i += 2) {
+      SRoaringBitmap* p = level[i];
+      if (i + 1 < num) {
+        p = tRoaringOr(level[i], level[i + 1]);
+        if (p == NULL) {
+          oom = true;
+          p = level[i];  // keep it for the cleanup below
+        } else {
+          tRoaringDestroy(level[i]);
+        }
+        tRoaringDestroy(level[i + 1]);
+        level[i + 1] = NULL;
+      }
+      level[next++] = p;
+    }
+    num = next;
+  }
+
+  SRoaringBitmap* res = NULL;
+  if (oom) {
+    for (size_t i = 0; i < num; ++i) tRoaringDestroy(level[i]);
+  } else {
+    res = level[0];
+  }
+
+  free(level);
+  return res;
+}
+
+// the tids of the child tables whose tag may satisfy one filter unit, found in the tag index of the super table
+static int32_t tsdbGetTagIndexCandidates(void* param, SFilterInfo* info, uint32_t uidx, SRoaringBitmap** res) {
+  STable*         pSTable = (STable*)param;
+  SFilterComUnit* cunit = &info->cunits[uidx];
+
+  *res = NULL;
+
+  // null tag values are not indexed
+  if (cunit->optr == TSDB_RELATION_ISNULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  STagIndex* pTagIdx = tsdbGetTagIndex(pSTable, (int16_t)cunit->colId);
+  if (pTagIdx == NULL || pTagIdx->type != cunit->dataType) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  bool exact = cunit->rfunc < 0 && !IS_FLOAT_TYPE(cunit->dataType);
+
+  if (cunit->optr == TSDB_RELATION_NOTNULL) {
+    *res = tRoaringDup(pTagIdx->notNull);
+  } else if (exact && (cunit->optr == TSDB_RELATION_EQUAL || cunit->optr == TSDB_RELATION_NOT_EQUAL)) {
+    void*            val = cunit->valData;
+    SRoaringBitmap** ppTids = taosHashGet(pTagIdx->valMap, val, tsdbGetTagIndexKeyLen(cunit->dataType, val));
+
+    if (cunit->optr == TSDB_RELATION_EQUAL) {
+      *res = (ppTids == NULL) ? tRoaringCreate() : tRoaringDup(*ppTids);
+    } else {
+      *res = (ppTids == NULL) ? tRoaringDup(pTagIdx->notNull) : tRoaringAndNot(pTagIdx->notNull, *ppTids);
+    }
+  } else {
+    // check the unit on each distinct value of the tag, and union the bitmaps of the matching values
+    SArray* bitmaps = taosArrayInit(64, POINTER_BYTES);
+    if (bitmaps == NULL) {
+      return TSDB_CODE_TDB_OUT_OF_MEMORY;
+    }
+
+    SRoaringBitmap** ppTids = taosHashIterate(pTagIdx->valMap, NULL);
+    while (ppTids != NULL) {
+      void* val = taosHashGetDataKey(pTagIdx->valMap, ppTids);
+      if (filterExecuteUnit(info, uidx, val)) {
+        taosArrayPush(bitmaps, ppTids);
+      }
+      ppTids = taosHashIterate(pTagIdx->valMap, ppTids);
+    }
+
+    *res = tsdbUnionTagIndexBitmaps(bitmaps);
+    taosArrayDestroy(&bitmaps);
+  }
+
+  if (*res == NULL) {
+    return TSDB_CODE_TDB_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static FORCE_INLINE int32_t tsdbGetTagDataFromTable(void *param, int32_t id, void **data) {
+  STable* pTable = (STable*)param;
+
+  if (id == TSDB_TBNAME_COLUMN_INDEX) {
+    *data = TABLE_NAME(pTable);
+  } else {
+    *data = tdGetKVRowValOfCol(pTable->tagVal, id);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool queryByTagIndex(STsdbMeta* pMeta, STable* pSTable, void* filterInfo, SArray* res) {
+  SRoaringBitmap* pTids = NULL;
+
+  if (pSTable->pTagIndex == NULL) {
+    return false;
+  }
+
+  if (filterGetIndexCandidates(filterInfo, pSTable, tsdbGetTagIndexCandidates, &pTids) != TSDB_CODE_SUCCESS ||
+      pTids == NULL) {
+    return false;
+  }
+
+  SRoaringIter iter;
+  uint32_t     tid = 0;
+  int8_t*      addToResult = NULL;
+
+  tsdbDebug("filter by tag index, %" PRId64 " candidate tables", tRoaringCardinality(pTids));
+
+  // only the tables passing the filter are materialized, in tid order
+  tRoaringIterInit(&iter, pTids);
+  while (tRoaringIterNext(&iter, &tid)) {
+    STable* pTable = (tid < (uint32_t)pMeta->maxTables) ? pMeta->tables[tid] : NULL;
+    if (pTable == NULL || pTable->pSuper != pSTable) continue;
+
+    filterSetColFieldData(filterInfo, pTable, tsdbGetTagDataFromTable);
+
+    bool all = filterExecute(filterInfo, 1, &addToResult, NULL, 0);
+
+    if (all || (addToResult && *addToResult)) {
+      STableKeyInfo info = {.pTable = (void*)pTable, .lastKey = TSKEY_INITIAL_VAL};
+      taosArrayPush(res, &info);
+    }
+  }
+
+  tfree(addToResult);
+  tRoaringDestroy(pTids);
+
+  return true;
+}
+
+static int32_t tsdbQueryTableList(STsdbMeta* pMeta, STable* pTable, SArray* pRes, void* filterInfo) {
   STSchema*   pTSSchema = pTable->tagSchema;
 
   if(pTSSchema->columns->type == TSDB_DATA_TYPE_JSON){
@@ -4513,7 +4882,7 @@ static int32_t tsdbQueryTableList(STable* pTable, SArray* pRes, void* filterInfo
 
     if (indexQuery) {
       queryIndexedColumn(pSkipList, filterInfo, pRes);
-    } else {
+    } else if (!queryByTagIndex(pMeta, pTable, filterInfo, pRes)) {
       queryIndexlessColumn(pSkipList, filterInfo, pRes);
     }
   }
@@ -25,8 +25,45 @@ static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int3
 static int  tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols, int16_t *colIds,
                                       int numOfColIds);
 static int  tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol);
+static int  tsdbReadColData(SReadH *pReadh, SDFile *pDFile, SBlockCol *pBlockCol, int64_t offset);
 static int  tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock);
 static int  tsdbLoadBlockStatisFromAggr(SReadH *pReadh, SBlock *pBlock);
+static int   tsdbWaitReadAhead(SReadH *pReadh, int32_t slot, bool data);
+static void  tsdbReadAheadColData(SReadH *pReadh, int32_t slot);
+static void *tsdbGetReadAheadData(SReadH *pReadh, SBlock *pBlock, int64_t offset, int64_t len);
+static void  tsdbResetReadAhead(SReadH *pReadh);
+static void  tsdbFreeReadAhead(SReadH *pReadh);
+
+#define TSDB_READ_AHEAD_FREE 0
+#define TSDB_READ_AHEAD_STATIS_INFLIGHT 1  // the SBlockData part is being read
+#define TSDB_READ_AHEAD_STATIS_READY 2     // the SBlockData part is read, the column data is not read ahead
+#define TSDB_READ_AHEAD_DATA_INFLIGHT 3    // the column data of the requested columns is being read
+#define TSDB_READ_AHEAD_READY 4
+
+// the statis part of slot i is read with tag 2 * i, and the column data with tag 2 * i + 1
+#define TSDB_READ_AHEAD_TAG(slot, data) ((uint64_t)(slot)*2 + ((data) ? 1 : 0))
+
+typedef struct {
+  SBlock   block;
+  int16_t *colIds;      // the columns to read ahead, owned by the query handle
+  int      numOfColIds;
+  int8_t   state;
+  int64_t  statisLen;
+  void *   pStatis;
+  int64_t  offset;      // offset of the column data read ahead in the file
+  int64_t  nread;
+  void *   pBuf;
+} SReadAheadBlock;
+
+// A ring of blocks read asynchronously from the current file set, the oldest one is reused for the next block.
+// The SBlockData part of a block is read first, and then only the span of the requested columns in it.
+struct SReadAhead {
+  SAioCtx *       pAio;
+  int32_t         nBlocks;
+  int32_t         next;
+  bool            broken;  // the completions are lost, the buffers of reads in flight must not be touched
+  SReadAheadBlock blocks[];
+};
 
 int tsdbInitReadH(SReadH *pReadh, STsdbRepo *pRepo) {
   ASSERT(pReadh != NULL && pRepo != NULL);
@@ -63,6 +100,7 @@ int tsdbInitReadH(SReadH *pReadh, STsdbRepo *pRepo) {
 
 void tsdbDestroyReadH(SReadH *pReadh) {
   if (pReadh == NULL) return;
+  tsdbFreeReadAhead(pReadh);
   pReadh->pExBuf = taosTZfree(pReadh->pExBuf);
   pReadh->pCBuf = taosTZfree(pReadh->pCBuf);
   pReadh->pBuf = taosTZfree(pReadh->pBuf);
@@ -425,13 +463,27 @@ int tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo,
 
 static int tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock) {
   SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  size_t  size = tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
+
+  void *pData = tsdbGetReadAheadData(pReadh, pBlock, pBlock->offset, size);
+  if (pData != NULL) {
+    if (tsdbMakeRoom((void **)(&(pReadh->pBlkData)), size) < 0) return -1;
+    memcpy(pReadh->pBlkData, pData, size);
+    if (!taosCheckChecksumWhole((uint8_t *)(pReadh->pBlkData), (uint32_t)size)) {
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      tsdbError("vgId:%d block statis part in file %s is corrupted since wrong checksum, offset:%" PRId64 " len :%" PRIzu,
+                TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, size);
+      return -1;
+    }
+    return 0;
+  }
+
   if (tsdbSeekDFile(pDFile, pBlock->offset, SEEK_SET) < 0) {
     tsdbError("vgId:%d failed to load block statis part while seek file %s to offset %" PRId64 " since %s",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, tstrerror(terrno));
     return -1;
   }
 
-  size_t size = tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
   if (tsdbMakeRoom((void **)(&(pReadh->pBlkData)), size) < 0) return -1;
 
   int64_t nread = tsdbReadDFile(pDFile, (void *)(pReadh->pBlkData), size);
@@ -614,6 +666,7 @@ static void tsdbResetReadTable(SReadH *pReadh) {
 }
 
 static void tsdbResetReadFile(SReadH *pReadh) {
+  tsdbResetReadAhead(pReadh);
   tsdbResetReadTable(pReadh);
   taosArrayClear(pReadh->aBlkIdx);
   tsdbCloseDFileSet(TSDB_READ_FSET(pReadh));
@@ -840,11 +893,40 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
   STsdbCfg * pCfg = REPO_CFG(pRepo);
   int        tsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
 
-  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlockCol->len) < 0) return -1;
-  if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), tsize) < 0) return -1;
-
   int64_t offset = pBlock->offset + tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer) +
                    tsdbGetBlockColOffset(pBlockCol);
+
+  SBlockCache *  pCache = pReadh->useBlkCache ? pRepo->blkCache : NULL;
+  SBlockCacheKey key;
+  if (pCache) {
+    tsdbInitBlockCacheKey(&key, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), pDFile, pBlock->last, offset,
+                          pBlockCol->colId);
+    if (tsdbGetBlockCacheCol(pCache, &key, pDataCol, pBlock->numOfRows, pCfg->maxRowsPerFileBlock)) return 0;
+  }
+
+  if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), tsize) < 0) return -1;
+
+  void *pContent = tsdbGetReadAheadData(pReadh, pBlock, offset, pBlockCol->len);
+  if (pContent == NULL) {
+    if (tsdbReadColData(pReadh, pDFile, pBlockCol, offset) < 0) return -1;
+    pContent = TSDB_READ_BUF(pReadh);
+  }
+
+  if (tsdbCheckAndDecodeColumnData(pDataCol, pContent, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
+                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
+    tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
+              pBlockCol->colId, offset);
+    return -1;
+  }
+
+  if (pCache) tsdbPutBlockCacheCol(pCache, &key, pDataCol);
+
+  return 0;
+}
+
+static int tsdbReadColData(SReadH *pReadh, SDFile *pDFile, SBlockCol *pBlockCol, int64_t offset) {
+  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlockCol->len) < 0) return -1;
+
   if (tsdbSeekDFile(pDFile, offset, SEEK_SET) < 0) {
     tsdbError("vgId:%d failed to load block column data while seek file %s to offset %" PRId64 " since %s",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, tstrerror(terrno));
@@ -866,12 +948,218 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
     return -1;
   }
 
-  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
-                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
-    tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
-              pBlockCol->colId, offset);
-    return -1;
+  return 0;
+}
+
+int tsdbReadAheadBlock(SReadH *pReadh, SBlock *pBlock, int16_t *colIds, int numOfColIds) {
+  if (tsdbReadAheadBlocks <= 0 || pBlock->numOfSubBlocks > 1) return 0;
+
+  SReadAhead *pRa = pReadh->pReadAhead;
+  if (pRa == NULL) {
+    pRa = (SReadAhead *)calloc(1, sizeof(SReadAhead) + sizeof(SReadAheadBlock) * tsdbReadAheadBlocks);
+    if (pRa == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    pRa->nBlocks = tsdbReadAheadBlocks;
+    pRa->pAio = taosAioOpen(pRa->nBlocks * 2);
+    if (pRa->pAio == NULL) {
+      free(pRa);
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return -1;
+    }
+
+    tsdbDebug("vgId:%d read ahead %d blocks with %s io", TSDB_READ_REPO_ID(pReadh), pRa->nBlocks,
+              taosAioIsAsync(pRa->pAio) ? "async" : "sync");
+    pReadh->pReadAhead = pRa;
   }
 
+  if (pRa->broken) return 0;
+
+  for (int32_t i = 0; i < pRa->nBlocks; i++) {
+    SReadAheadBlock *pRb = pRa->blocks + i;
+    if (pRb->state != TSDB_READ_AHEAD_FREE && pRb->block.offset == pBlock->offset && pRb->block.last == pBlock->last) {
+      return 0;
+    }
+  }
+
+  int32_t          slot = pRa->next;
+  SReadAheadBlock *pRb = pRa->blocks + slot;
+  if (tsdbWaitReadAhead(pReadh, slot, true) < 0) return -1;
+
+  pRb->state = TSDB_READ_AHEAD_FREE;
+  pRb->statisLen = (int64_t)tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
+  if (tsdbMakeRoom(&pRb->pStatis, pRb->statisLen) < 0) return -1;
+
+  SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  if (taosAioRead(pRa->pAio, TSDB_FILE_FD(pDFile), pRb->pStatis, pRb->statisLen, pBlock->offset,
+                  TSDB_READ_AHEAD_TAG(slot, false)) < 0) {
+    // the ring is full of completions nobody asked for yet, just load this block the normal way
+    return 0;
+  }
+
+  pRb->block = *pBlock;
+  pRb->colIds = colIds;
+  pRb->numOfColIds = numOfColIds;
+  pRb->nread = 0;
+  pRb->state = TSDB_READ_AHEAD_STATIS_INFLIGHT;
+  pRa->next = (slot + 1) % pRa->nBlocks;
+
   return 0;
 }
+
+// Issue the read of the span from the first to the last requested column of a block whose SBlockData is read
+static void tsdbReadAheadColData(SReadH *pReadh, int32_t slot) {
+  SReadAhead *     pRa = pReadh->pReadAhead;
+  SReadAheadBlock *pRb = pRa->blocks + slot;
+  SBlock *         pBlock = &pRb->block;
+  SBlockData *     pBlockData = (SBlockData *)pRb->pStatis;
+
+  // a broken block is reported by the normal path
+  if (!taosCheckChecksumWhole((uint8_t *)pRb->pStatis, (uint32_t)pRb->statisLen)) return;
+
+  int64_t   start = INT64_MAX;
+  int64_t   end = 0;
+  int       ccol = 0;
+  SBlockCol blockCol = {0};
+  for (int i = 0; i < pRb->numOfColIds; i++) {
+    int16_t colId = pRb->colIds[i];
+    if (colId == 0) {  // the key column
+      start = MIN(start, TSDB_KEY_COL_OFFSET);
+      end = MAX(end, TSDB_KEY_COL_OFFSET + pBlock->keyLen);
+      continue;
+    }
+
+    for (; ccol < pBlock->numOfCols; ccol++) {
+      SBlockCol *pBlockCol = &blockCol;
+      tsdbGetSBlockCol(pBlock, &pBlockCol, pBlockData->cols, ccol);
+      if (pBlockCol->colId > colId) break;
+      if (pBlockCol->colId == colId) {
+        start = MIN(start, (int64_t)tsdbGetBlockColOffset(pBlockCol));
+        end = MAX(end, (int64_t)tsdbGetBlockColOffset(pBlockCol) + pBlockCol->len);
+        ccol++;
+        break;
+      }
+    }
+  }
+
+  if (start >= end || end > (int64_t)pBlock->len - pRb->statisLen) return;
+  if (tsdbMakeRoom(&pRb->pBuf, end - start) < 0) return;
+
+  SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  int64_t offset = pBlock->offset + pRb->statisLen + start;
+  if (taosAioRead(pRa->pAio, TSDB_FILE_FD(pDFile), pRb->pBuf, end - start, offset, TSDB_READ_AHEAD_TAG(slot, true)) <
+      0) {
+    return;
+  }
+
+  pRb->offset = offset;
+  pRb->nread = 0;
+  pRb->state = TSDB_READ_AHEAD_DATA_INFLIGHT;
+}
+
+// Reap completions until the SBlockData part of slot, or all the reads of slot if data is true, finish. The reads of
+// the other blocks reaped meanwhile go on to their column data.
+static int tsdbWaitReadAhead(SReadH *pReadh, int32_t slot, bool data) {
+  SReadAhead *pRa = pReadh->pReadAhead;
+  if (pRa->broken) return -1;
+
+  while (pRa->blocks[slot].state == TSDB_READ_AHEAD_STATIS_INFLIGHT ||
+         (data && pRa->blocks[slot].state == TSDB_READ_AHEAD_DATA_INFLIGHT)) {
+    uint64_t tag = 0;
+    int64_t  result = 0;
+    int32_t  code = taosAioWait(pRa->pAio, &tag, &result);
+    if (code <= 0) {
+      // the reads in flight may still be writing into their buffers, so keep them as they are until the aio
+      // context is closed, and load the blocks the normal way from now on
+      tsdbWarn("vgId:%d failed to wait read ahead blocks since %s", TSDB_READ_REPO_ID(pReadh), strerror(errno));
+      pRa->broken = true;
+      return -1;
+    }
+
+    if (tag >= TSDB_READ_AHEAD_TAG(pRa->nBlocks, false)) continue;
+    SReadAheadBlock *pRb = pRa->blocks + tag / 2;
+    if (tag % 2 == 0) {
+      if (result != pRb->statisLen) {
+        tsdbDebug("vgId:%d failed to read ahead block at offset %" PRId64 " since %s", TSDB_READ_REPO_ID(pReadh),
+                  (int64_t)pRb->block.offset, result < 0 ? strerror((int)(-result)) : "short read");
+        pRb->state = TSDB_READ_AHEAD_FREE;
+      } else {
+        pRb->state = TSDB_READ_AHEAD_STATIS_READY;
+        tsdbReadAheadColData(pReadh, (int32_t)(tag / 2));
+      }
+    } else {
+      if (result < 0) {
+        tsdbDebug("vgId:%d failed to read ahead column data at offset %" PRId64 " since %s",
+                  TSDB_READ_REPO_ID(pReadh), pRb->offset, strerror((int)(-result)));
+        pRb->state = TSDB_READ_AHEAD_STATIS_READY;
+      } else {
+        pRb->nread = result;
+        pRb->state = TSDB_READ_AHEAD_READY;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void *tsdbGetReadAheadData(SReadH *pReadh, SBlock *pBlock, int64_t offset, int64_t len) {
+  SReadAhead *pRa = pReadh->pReadAhead;
+  if (pRa == NULL || pRa->broken) return NULL;
+
+  for (int32_t i = 0; i < pRa->nBlocks; i++) {
+    SReadAheadBlock *pRb = pRa->blocks + i;
+    if (pRb->state == TSDB_READ_AHEAD_FREE || pRb->block.offset != pBlock->offset ||
+        pRb->block.last != pBlock->last) {
+      continue;
+    }
+
+    bool statis = (offset == pRb->block.offset && len == pRb->statisLen);
+    if (tsdbWaitReadAhead(pReadh, i, !statis) < 0) return NULL;
+    if (statis) return (pRb->state == TSDB_READ_AHEAD_FREE) ? NULL : pRb->pStatis;
+    if (pRb->state != TSDB_READ_AHEAD_READY) return NULL;
+
+    // a short read falls back to the normal path which reports the corruption
+    if (offset < pRb->offset || offset + len > pRb->offset + pRb->nread) return NULL;
+    return POINTER_SHIFT(pRb->pBuf, offset - pRb->offset);
+  }
+
+  return NULL;
+}
+
+static void tsdbResetReadAhead(SReadH *pReadh) {
+  SReadAhead *pRa = pReadh->pReadAhead;
+  if (pRa == NULL || pRa->broken) return;
+
+  // reads in flight refer to files about to be closed
+  for (int32_t i = 0; i < pRa->nBlocks; i++) {
+    if (tsdbWaitReadAhead(pReadh, i, true) < 0) return;
+  }
+
+  for (int32_t i = 0; i < pRa->nBlocks; i++) {
+    pRa->blocks[i].state = TSDB_READ_AHEAD_FREE;
+  }
+  pRa->next = 0;
+}
+
+static void tsdbFreeReadAhead(SReadH *pReadh) {
+  SReadAhead *pRa = pReadh->pReadAhead;
+  if (pRa == NULL) return;
+
+  taosAioClose(pRa->pAio);
+  for (int32_t i = 0; i < pRa->nBlocks; i++) {
+    SReadAheadBlock *pRb = pRa->blocks + i;
+    if (pRa->broken && (pRb->state == TSDB_READ_AHEAD_STATIS_INFLIGHT || pRb->state == TSDB_READ_AHEAD_DATA_INFLIGHT)) {
+      // no one can tell whether the kernel is done with the buffers, leaking them is better than a corruption
+      tsdbWarn("vgId:%d read ahead buffers of block at offset %" PRId64 " are not freed", TSDB_READ_REPO_ID(pReadh),
+               (int64_t)pRb->block.offset);
+      continue;
+    }
+
+    taosTZfree(pRb->pStatis);
+    taosTZfree(pRb->pBuf);
+  }
+  free(pRa);
+  pReadh->pReadAhead = NULL;
+}
@@ -17,36 +17,30 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tsdbint.h"
+#include "tmd5.h"
 
-// Sync handle
-typedef struct {
-  STsdbRepo *pRepo;
-  SRtn       rtn;
-  SOCKET     socketFd;
-  void *     pBuf;
-  bool       mfChanged;
-  SMFile *   pmf;
-  SMFile     mf;
-  SDFileSet  df;
-  SDFileSet *pdf;
-} SSyncH;
+/*
+ * The filesets are sent one by one over the single socket that the sync module gives to each peer, they are not
+ * sent over several connections in parallel.
+ */
 
 #define SYNC_BUFFER(sh) ((sh)->pBuf)
 
 static void    tsdbInitSyncH(SSyncH *pSyncH, STsdbRepo *pRepo, SOCKET socketFd);
-static void    tsdbDestroySyncH(SSyncH *pSyncH);
 static int32_t tsdbSyncSendMeta(SSyncH *pSynch);
 static int32_t tsdbSyncRecvMeta(SSyncH *pSynch);
 static int32_t tsdbSendMetaInfo(SSyncH *pSynch);
 static int32_t tsdbRecvMetaInfo(SSyncH *pSynch);
-static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend);
-static int32_t tsdbRecvDecision(SSyncH *pSynch, bool *toSend);
+static int32_t tsdbSendDecision(SSyncH *pSynch, uint8_t decision);
+static int32_t tsdbRecvDecision(SSyncH *pSynch, uint8_t *decision);
 static int32_t tsdbSyncSendDFileSetArray(SSyncH *pSynch);
 static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch);
 static bool    tsdbIsTowFSetSame(SDFileSet *pSet1, SDFileSet *pSet2);
 static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet);
-static int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet);
-static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch);
+static int32_t tsdbSyncWriteMsg(SSyncH *pSynch, uint32_t tlen);
+static int32_t tsdbSyncReadMsg(SSyncH *pSynch, uint32_t *tlen);
+static int32_t tsdbSyncDigestChunk(SSyncH *pSynch, int32_t fd, int64_t offset, int64_t len, uint8_t *digest);
+static void    tsdbKeepSyncPart(STsdbRepo *pRepo, SDFileSet *pSet);
 static int     tsdbReload(STsdbRepo *pRepo, bool isMfChanged);
 
 int32_t tsdbSyncSend(void *tsdb, SOCKET socketFd) {
@@ -67,6 +61,8 @@ int32_t tsdbSyncSend(void *tsdb, SOCKET socketFd) {
     goto _err;
   }
 
+  tsdbInfo("vgId:%d, filesets are sent, sent:%" PRId64, REPO_ID(pRepo), synch.sent);
+
   // Enable TSDB commit
   tsem_post(&(pRepo->readyToCommit));
   tsdbDestroySyncH(&synch);
@@ -98,6 +94,8 @@ int32_t tsdbSyncRecv(void *tsdb, SOCKET socketFd) {
     goto _err;
   }
 
+  tsdbInfo("vgId:%d, filesets are received, received:%" PRId64, REPO_ID(pRepo), synch.received);
+
   tsdbEndFSTxn(pRepo);
   tsem_post(&(pRepo->readyToCommit));
   tsdbDestroySyncH(&synch);
@@ -120,11 +118,14 @@ static void tsdbInitSyncH(SSyncH *pSyncH, STsdbRepo *pRepo, SOCKET socketFd) {
   tsdbGetRtnSnap(pRepo, &(pSyncH->rtn));
 }
 
-static void tsdbDestroySyncH(SSyncH *pSyncH) { taosTZfree(pSyncH->pBuf); }
+void tsdbDestroySyncH(SSyncH *pSyncH) {
+  taosTZfree(pSyncH->pBuf);
+  tfree(pSyncH->pChunk);
+}
 
 static int32_t tsdbSyncSendMeta(SSyncH *pSynch) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  bool       toSendMeta = false;
+  uint8_t    toSendMeta = TSDB_SYNC_SKIP;
   SMFile     mf;
 
   // Send meta info to remote
@@ -199,7 +200,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
     // Local has no meta file or has a different meta file, need to copy from remote
     pSynch->mfChanged = true;
 
-    if (tsdbSendDecision(pSynch, true) < 0) {
+    if (tsdbSendDecision(pSynch, TSDB_SYNC_SEND) < 0) {
       tsdbError("vgId:%d, failed to send decision while recv metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
       return -1;
     }
@@ -236,7 +237,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
   } else {
     pSynch->mfChanged = false;
     tsdbInfo("vgId:%d, metafile is same, no need to recv", REPO_ID(pRepo));
-    if (tsdbSendDecision(pSynch, false) < 0) {
+    if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
       tsdbError("vgId:%d, failed to send decision while recv metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
       return -1;
     }
@@ -327,9 +328,8 @@ static int32_t tsdbRecvMetaInfo(SSyncH *pSynch) {
   return 0;
 }
 
-static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend) {
+static int32_t tsdbSendDecision(SSyncH *pSynch, uint8_t decision) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  uint8_t    decision = toSend;
 
   int32_t writeLen = sizeof(uint8_t);
   int32_t ret = taosWriteMsg(pSynch->socketFd, (void *)(&decision), writeLen);
@@ -342,19 +342,17 @@ static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend) {
   return 0;
 }
 
-static int32_t tsdbRecvDecision(SSyncH *pSynch, bool *toSend) {
+static int32_t tsdbRecvDecision(SSyncH *pSynch, uint8_t *decision) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  uint8_t    decision = 0;
 
   int32_t readLen = sizeof(uint8_t);
-  int32_t ret = taosReadMsg(pSynch->socketFd, (void *)(&decision), readLen);
+  int32_t ret = taosReadMsg(pSynch->socketFd, (void *)decision, readLen);
   if (ret != readLen) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     tsdbError("vgId:%d, failed to recv decison, ret:%d readLen:%d", REPO_ID(pRepo), ret, readLen);
     return -1;
   }
 
-  *toSend = decision;
   return 0;
 }
 
@@ -401,6 +399,7 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
   while (true) {
     if (pLSet == NULL && pSynch->pdf == NULL) {
       tsdbInfo("vgId:%d, all filesets is disposed", REPO_ID(pRepo));
+      tsdbRemoveSyncPart(pRepo);
       break;
     } else {
       tsdbInfo("vgId:%d, fileset local:%d remote:%d, will be disposed", REPO_ID(pRepo), pLSet != NULL ? pLSet->fid : -1,
@@ -423,16 +422,17 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           return -1;
         }
 
-        if (tsdbSendDecision(pSynch, false) < 0) {
+        if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
           tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
           return -1;
         }
       } else {
         // Need to copy from remote
-        int fidLevel = tsdbGetFidLevel(pSynch->pdf->fid, &(pSynch->rtn));
+        bool byChunks = (pSynch->features & TSDB_SYNC_FEATURE_CHUNKS) != 0;
+        int  fidLevel = tsdbGetFidLevel(pSynch->pdf->fid, &(pSynch->rtn));
         if (fidLevel < 0) {  // expired fileset
           tsdbInfo("vgId:%d, fileset:%d will be skipped as expired", REPO_ID(pRepo), pSynch->pdf->fid);
-          if (tsdbSendDecision(pSynch, false) < 0) {
+          if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
             tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
             return -1;
           }
@@ -447,9 +447,9 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           // Next loop
           continue;
         } else {
-          tsdbInfo("vgId:%d, fileset:%d will be received", REPO_ID(pRepo), pSynch->pdf->fid);
-          // Notify remote to send there file here
-          if (tsdbSendDecision(pSynch, true) < 0) {
+          tsdbInfo("vgId:%d, fileset:%d will be received, by chunks:%d", REPO_ID(pRepo), pSynch->pdf->fid, byChunks);
+          // Notify remote to send there file here, a sender of old version only sends the whole files
+          if (tsdbSendDecision(pSynch, byChunks ? TSDB_SYNC_SEND_CHUNKS : TSDB_SYNC_SEND) < 0) {
             tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
             return -1;
           }
@@ -474,27 +474,28 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           return -1;
         }
 
+        // the chunks may be taken from the fileset partly received by the broken sync, or the local one
+        SDFileSet *pPSet = (pRepo->syncPart && pRepo->syncPart->fid == pSynch->pdf->fid) ? pRepo->syncPart : NULL;
+        SDFileSet *pOSet = (pLSet && pLSet->fid == pSynch->pdf->fid) ? pLSet : NULL;
+
         for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSynch->pdf); ftype++) {
           SDFile *pDFile = TSDB_DFILE_IN_SET(&fset, ftype);         // local file
           SDFile *pRDFile = TSDB_DFILE_IN_SET(pSynch->pdf, ftype);  // remote file
+          SDFile *pLDFile = (pOSet && ftype < tsdbGetNFiles(pOSet)) ? TSDB_DFILE_IN_SET(pOSet, ftype) : NULL;
+          SDFile *pPDFile = (pPSet && ftype < tsdbGetNFiles(pPSet)) ? TSDB_DFILE_IN_SET(pPSet, ftype) : NULL;
 
           tsdbInfo("vgId:%d, file:%s will be received, osize:%" PRIu64 " rsize:%" PRIu64, REPO_ID(pRepo),
                    pDFile->f.aname, pDFile->info.size, pRDFile->info.size);
 
-          int64_t writeLen = pRDFile->info.size;
-          int64_t ret = taosCopyFds(pSynch->socketFd, pDFile->fd, writeLen);
-          if (ret != writeLen) {
-            terrno = TAOS_SYSTEM_ERROR(errno);
-            tsdbError("vgId:%d, failed to recv file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
-                      pDFile->f.aname, tstrerror(terrno), ret, writeLen);
+          if (tsdbSyncRecvDFile(pSynch, pDFile, pRDFile, pLDFile, pPDFile, byChunks) < 0) {
+            tsdbError("vgId:%d, failed to recv file:%s since %s", REPO_ID(pRepo), pDFile->f.aname, tstrerror(terrno));
             tsdbCloseDFileSet(&fset);
-            tsdbRemoveDFileSet(&fset);
+            tsdbKeepSyncPart(pRepo, &fset);
             return -1;
           }
 
           // Update new file info
           pDFile->info = pRDFile->info;
-          tsdbInfo("vgId:%d, file:%s is received, size:%" PRId64, REPO_ID(pRepo), pDFile->f.aname, writeLen);
         }
 
         tsdbCloseDFileSet(&fset);
@@ -503,6 +504,7 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           return -1;
         }
 
+        if (pPSet) tsdbRemoveSyncPart(pRepo);
         tsdbInfo("vgId:%d, fileset:%d is received", REPO_ID(pRepo), pSynch->pdf->fid);
       }
 
@@ -567,7 +569,7 @@ static bool tsdbIsTowFSetSame(SDFileSet *pSet1, SDFileSet *pSet2) {
 
 static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  bool toSend = false;
+  uint8_t    decision = TSDB_SYNC_SKIP;
 
   // skip expired fileset
   if (pSet && tsdbGetFidLevel(pSet->fid, &(pSynch->rtn)) < 0) {
@@ -586,14 +588,15 @@ static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
     return 0;
   }
 
-  if (tsdbRecvDecision(pSynch, &toSend) < 0) {
+  if (tsdbRecvDecision(pSynch, &decision) < 0) {
     tsdbError("vgId:%d, failed to recv decision while send fileset:%d since %s", REPO_ID(pRepo), pSet->fid,
               tstrerror(terrno));
     return -1;
   }
 
-  if (toSend) {
-    tsdbInfo("vgId:%d, fileset:%d will be sent", REPO_ID(pRepo), pSet->fid);
+  if (decision != TSDB_SYNC_SKIP) {
+    bool byChunks = (decision == TSDB_SYNC_SEND_CHUNKS);
+    tsdbInfo("vgId:%d, fileset:%d will be sent, by chunks:%d", REPO_ID(pRepo), pSet->fid, byChunks);
 
     for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
       SDFile df = *TSDB_DFILE_IN_SET(pSet, ftype);
@@ -603,19 +606,14 @@ static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
         return -1;
       }
 
-      int64_t writeLen = df.info.size;
-      tsdbInfo("vgId:%d, file:%s will be sent, size:%" PRId64, REPO_ID(pRepo), df.f.aname, writeLen);
+      tsdbInfo("vgId:%d, file:%s will be sent, size:%" PRId64, REPO_ID(pRepo), df.f.aname, df.info.size);
 
-      int64_t ret = taosSendFile(pSynch->socketFd, TSDB_FILE_FD(&df), 0, writeLen);
-      if (ret != writeLen) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        tsdbError("vgId:%d, failed to send file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
-                  df.f.aname, tstrerror(terrno), ret, writeLen);
+      if (tsdbSyncSendDFile(pSynch, &df, byChunks) < 0) {
+        tsdbError("vgId:%d, failed to send file:%s since %s", REPO_ID(pRepo), df.f.aname, tstrerror(terrno));
         tsdbCloseDFile(&df);
         return -1;
       }
 
-      tsdbInfo("vgId:%d, file:%s is sent", REPO_ID(pRepo), df.f.aname);
       tsdbCloseDFile(&df);
     }
 
@@ -627,12 +625,13 @@ static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
   return 0;
 }
 
-static int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet) {
+// the features follow the fileset, a receiver of old version decodes the fileset only
+int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet) {
   STsdbRepo *pRepo = pSynch->pRepo;
   uint32_t   tlen = 0;
 
   if (pSet) {
-    tlen = tsdbEncodeDFileSetEx(NULL, pSet) + sizeof(TSCKSUM);
+    tlen = tsdbEncodeDFileSetEx(NULL, pSet) + sizeof(uint8_t) + sizeof(TSCKSUM);
   }
 
   if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), tlen + sizeof(tlen)) < 0) {
@@ -645,6 +644,7 @@ static int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet) {
   void *tptr = ptr;
   if (pSet) {
     tsdbEncodeDFileSetEx(&ptr, pSet);
+    taosEncodeFixedU8(&ptr, TSDB_SYNC_FEATURES);
     taosCalcChecksumAppend(0, (uint8_t *)tptr, tlen);
   }
 
@@ -659,7 +659,7 @@ static int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet) {
   return 0;
 }
 
-static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch) {
+int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch) {
   STsdbRepo *pRepo = pSynch->pRepo;
   uint32_t   tlen;
   char       buf[64] = {0};
@@ -674,6 +674,7 @@ static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch) {
   taosDecodeFixedU32(buf, &tlen);
 
   tsdbInfo("vgId:%d, fileinfo len:%d is received", REPO_ID(pRepo), tlen);
+  pSynch->features = 0;
   if (tlen == 0) {
     pSynch->pdf = NULL;
     return 0;
@@ -698,11 +699,381 @@ static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch) {
   }
 
   pSynch->pdf = &(pSynch->df);
-  tsdbDecodeDFileSetEx(SYNC_BUFFER(pSynch), pSynch->pdf);
+  void *ptr = tsdbDecodeDFileSetEx(SYNC_BUFFER(pSynch), pSynch->pdf);
+
+  // a sender of old version sends no features
+  if (POINTER_DISTANCE(ptr, SYNC_BUFFER(pSynch)) + sizeof(uint8_t) + sizeof(TSCKSUM) <= tlen) {
+    taosDecodeFixedU8(ptr, &pSynch->features);
+  }
+
+  return 0;
+}
+
+// the msg is the length, the content and the checksum of the content, the content is encoded after the length
+static int32_t tsdbSyncWriteMsg(SSyncH *pSynch, uint32_t tlen) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  void *     ptr = SYNC_BUFFER(pSynch);
+
+  taosEncodeFixedU32(&ptr, tlen);
+  taosCalcChecksumAppend(0, (uint8_t *)ptr, tlen);
+
+  int32_t writeLen = tlen + sizeof(uint32_t);
+  int32_t ret = taosWriteMsg(pSynch->socketFd, SYNC_BUFFER(pSynch), writeLen);
+  if (ret != writeLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to send msg, ret:%d writeLen:%d", REPO_ID(pRepo), ret, writeLen);
+    return -1;
+  }
+
+  return 0;
+}
+
+// the content is read into the sync buffer
+static int32_t tsdbSyncReadMsg(SSyncH *pSynch, uint32_t *tlen) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  char       buf[sizeof(uint32_t)];
+
+  int32_t ret = taosReadMsg(pSynch->socketFd, buf, sizeof(uint32_t));
+  if (ret != sizeof(uint32_t)) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  taosDecodeFixedU32(buf, tlen);
+  if (*tlen <= sizeof(TSCKSUM) || *tlen > INT32_MAX) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid msg len:%u", REPO_ID(pRepo), *tlen);
+    return -1;
+  }
+
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), *tlen) < 0) return -1;
+
+  ret = taosReadMsg(pSynch->socketFd, SYNC_BUFFER(pSynch), *tlen);
+  if (ret != *tlen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to recv msg, ret:%d readLen:%u", REPO_ID(pRepo), ret, *tlen);
+    return -1;
+  }
+
+  if (!taosCheckChecksumWhole((uint8_t *)SYNC_BUFFER(pSynch), *tlen)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, failed to checksum msg since %s", REPO_ID(pRepo), tstrerror(terrno));
+    return -1;
+  }
+
+  return 0;
+}
+
+// -1 is returned if the chunk can not be read out completely
+static int32_t tsdbSyncDigestChunk(SSyncH *pSynch, int32_t fd, int64_t offset, int64_t len, uint8_t *digest) {
+  if (pSynch->pChunk == NULL) {
+    pSynch->pChunk = malloc(TSDB_SYNC_CHUNK_SIZE);
+    if (pSynch->pChunk == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  for (int64_t nread = 0; nread < len;) {
+    ssize_t ret = pread(fd, (char *)pSynch->pChunk + nread, (size_t)(len - nread), (off_t)(offset + nread));
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
+      terrno = (ret < 0) ? TAOS_SYSTEM_ERROR(errno) : TSDB_CODE_TDB_FILE_CORRUPTED;
+      return -1;
+    }
+    nread += ret;
+  }
+
+  T_MD5_CTX context;
+  tMD5Init(&context);
+  tMD5Update(&context, pSynch->pChunk, (unsigned int)len);
+  tMD5Final(&context);
+  memcpy(digest, context.digest, TSDB_SYNC_DIGEST_LEN);
 
   return 0;
 }
 
+#define TSDB_SYNC_NCHUNKS(size) ((int32_t)(((size) + TSDB_SYNC_CHUNK_SIZE - 1) / TSDB_SYNC_CHUNK_SIZE))
+#define TSDB_SYNC_CHUNK_END(i, size) MIN((int64_t)(i + 1) * TSDB_SYNC_CHUNK_SIZE, size)
+#define TSDB_SYNC_CHUNK_KEPT(kept, nkept, i) ((i) < (nkept) && ((kept)[(i) >> 3] & (1u << ((i)&7))))
+
+/*
+ * the receiver tells the digests of the leading chunks it has, then it is told which of them are the same as the
+ * chunks of this file, and the runs of the other chunks are sent by sendfile. A receiver of old version gets the
+ * whole file without any digest exchanged
+ */
+int32_t tsdbSyncSendDFile(SSyncH *pSynch, SDFile *pDFile, bool byChunks) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  int64_t    size = pDFile->info.size;
+  int32_t    nchunks = TSDB_SYNC_NCHUNKS(size);
+  uint32_t   tlen = 0;
+  uint32_t   nkept = 0;
+  uint8_t *  kept = NULL;
+  uint8_t    digest[TSDB_SYNC_DIGEST_LEN];
+  int64_t    sent = 0;
+  int32_t    code = -1;
+
+  if (!byChunks) goto _send;
+
+  if (tsdbSyncReadMsg(pSynch, &tlen) < 0) return -1;
+
+  void *ptr = taosDecodeFixedU32(SYNC_BUFFER(pSynch), &nkept);
+  if (nkept > nchunks || tlen != sizeof(uint32_t) + nkept * TSDB_SYNC_DIGEST_LEN + sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid digests of file:%s, chunks:%u tlen:%u", REPO_ID(pRepo), pDFile->f.aname, nkept, tlen);
+    return -1;
+  }
+
+  int32_t bitmapLen = (nkept + 7) / 8;
+  kept = calloc(1, bitmapLen + 1);
+  if (kept == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < nkept; ++i) {
+    int64_t offset = (int64_t)i * TSDB_SYNC_CHUNK_SIZE;
+    if (tsdbSyncDigestChunk(pSynch, TSDB_FILE_FD(pDFile), offset, TSDB_SYNC_CHUNK_END(i, size) - offset, digest) < 0) {
+      goto _err;
+    }
+
+    if (memcmp(digest, (uint8_t *)ptr + (int64_t)i * TSDB_SYNC_DIGEST_LEN, TSDB_SYNC_DIGEST_LEN) == 0) {
+      kept[i >> 3] |= (uint8_t)(1u << (i & 7));
+    }
+  }
+
+  tlen = sizeof(uint32_t) + bitmapLen + sizeof(TSCKSUM);
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), sizeof(uint32_t) + tlen) < 0) goto _err;
+
+  ptr = POINTER_SHIFT(SYNC_BUFFER(pSynch), sizeof(uint32_t));
+  taosEncodeFixedU32(&ptr, nkept);
+  memcpy(ptr, kept, bitmapLen);
+  if (tsdbSyncWriteMsg(pSynch, tlen) < 0) goto _err;
+
+_send:
+  for (int32_t i = 0; i < nchunks;) {
+    if (TSDB_SYNC_CHUNK_KEPT(kept, nkept, i)) {
+      i++;
+      continue;
+    }
+
+    int32_t j = i + 1;
+    while (j < nchunks && !TSDB_SYNC_CHUNK_KEPT(kept, nkept, j)) j++;
+
+    int64_t offset = (int64_t)i * TSDB_SYNC_CHUNK_SIZE;
+    int64_t writeLen = TSDB_SYNC_CHUNK_END(j - 1, size) - offset;
+    int64_t ret = taosSendFile(pSynch->socketFd, TSDB_FILE_FD(pDFile), &offset, writeLen);
+    if (ret != writeLen) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      tsdbError("vgId:%d, failed to send file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
+                pDFile->f.aname, tstrerror(terrno), ret, writeLen);
+      goto _err;
+    }
+
+    sent += writeLen;
+    i = j;
+  }
+
+  pSynch->sent += sent;
+  tsdbInfo("vgId:%d, file:%s is sent, size:%" PRId64 " sent:%" PRId64 " chunks:%d digests:%u", REPO_ID(pRepo),
+           pDFile->f.aname, size, sent, nchunks, nkept);
+  code = 0;
+
+_err:
+  tfree(kept);
+  return code;
+}
+
+// a file of the same content as the local one is linked to it instead of being copied
+static bool tsdbSyncLinkDFile(SDFile *pDFile, SDFile *pLDFile) {
+  char tname[TSDB_FILENAME_LEN + 8];
+
+  snprintf(tname, sizeof(tname), "%s.link", TSDB_FILE_FULL_NAME(pDFile));
+  if (link(TSDB_FILE_FULL_NAME(pLDFile), tname) != 0) return false;
+
+  // the created file is replaced, the data written into its fd is discarded
+  if (taosRename(tname, TSDB_FILE_FULL_NAME(pDFile)) != 0) {
+    (void)remove(tname);
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * each leading chunk of the remote file is digested from the file partly received by the broken sync if it covers
+ * the chunk, otherwise from the local file. The chunks of the same digests are copied from them, and the others
+ * are received. A sender of old version sends the whole file without any digest exchanged
+ */
+int32_t tsdbSyncRecvDFile(SSyncH *pSynch, SDFile *pDFile, SDFile *pRDFile, SDFile *pLDFile, SDFile *pPDFile,
+                          bool byChunks) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  int64_t    size = pRDFile->info.size;
+  int32_t    nchunks = TSDB_SYNC_NCHUNKS(size);
+  SDFile     srcs[2];  // the partly received and local file
+  int64_t    srcSize[2] = {0};
+  uint8_t *  srcOf = NULL;
+  uint32_t   tlen = 0;
+  uint32_t   ndigests = 0;
+  uint32_t   nkept = 0;
+  uint8_t *  kept = NULL;
+  int64_t    received = 0;
+  int32_t    code = -1;
+
+  SDFile *pSrcs[2] = {pPDFile, pLDFile};
+  for (int32_t s = 0; s < 2; ++s) {
+    TSDB_FILE_SET_CLOSED(&srcs[s]);
+    if (pSrcs[s] == NULL || !byChunks) continue;
+
+    tsdbInitDFileEx(&srcs[s], pSrcs[s]);
+    if (tsdbOpenDFile(&srcs[s], O_RDONLY) < 0) continue;
+
+    int64_t fsize = taosLSeek(TSDB_FILE_FD(&srcs[s]), 0, SEEK_END);
+    srcSize[s] = (s == 0) ? fsize : MIN(fsize, pLDFile->info.size);
+  }
+
+  if (!byChunks) goto _recv;
+
+  srcOf = calloc(1, nchunks + 1);
+  if (srcOf == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  tlen = sizeof(uint32_t) + nchunks * TSDB_SYNC_DIGEST_LEN + sizeof(TSCKSUM);
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), sizeof(uint32_t) + tlen) < 0) goto _err;
+
+  uint8_t *digests = POINTER_SHIFT(SYNC_BUFFER(pSynch), sizeof(uint32_t) * 2);
+  for (int32_t i = 0; i < nchunks; ++i) {
+    int64_t offset = (int64_t)i * TSDB_SYNC_CHUNK_SIZE;
+    int64_t end = TSDB_SYNC_CHUNK_END(i, size);
+    int32_t s = (end <= srcSize[0]) ? 0 : ((end <= srcSize[1]) ? 1 : -1);
+    if (s < 0) break;
+
+    if (tsdbSyncDigestChunk(pSynch, TSDB_FILE_FD(&srcs[s]), offset, end - offset,
+                            digests + (int64_t)i * TSDB_SYNC_DIGEST_LEN) < 0) {
+      break;
+    }
+
+    srcOf[i] = (uint8_t)s;
+    ndigests++;
+  }
+
+  void *ptr = POINTER_SHIFT(SYNC_BUFFER(pSynch), sizeof(uint32_t));
+  taosEncodeFixedU32(&ptr, ndigests);
+  tlen = sizeof(uint32_t) + ndigests * TSDB_SYNC_DIGEST_LEN + sizeof(TSCKSUM);
+  if (tsdbSyncWriteMsg(pSynch, tlen) < 0) goto _err;
+
+  if (tsdbSyncReadMsg(pSynch, &tlen) < 0) goto _err;
+
+  kept = taosDecodeFixedU32(SYNC_BUFFER(pSynch), &nkept);
+  if (nkept != ndigests || tlen != sizeof(uint32_t) + (nkept + 7) / 8 + sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid chunk map of file:%s, chunks:%u digests:%u", REPO_ID(pRepo), pDFile->f.aname, nkept,
+              ndigests);
+    goto _err;
+  }
+
+  bool allKept = (pLDFile != NULL && size == pLDFile->info.size);
+  for (int32_t i = 0; i < nchunks && allKept; ++i) {
+    allKept = TSDB_SYNC_CHUNK_KEPT(kept, nkept, i) && srcOf[i] == 1;
+  }
+
+  if (allKept && tsdbSyncLinkDFile(pDFile, pLDFile)) {
+    tsdbInfo("vgId:%d, file:%s is same as %s, linked", REPO_ID(pRepo), pDFile->f.aname, pLDFile->f.aname);
+    code = 0;
+    goto _err;
+  }
+
+_recv:
+  for (int32_t i = 0; i < nchunks;) {
+    bool    isKept = TSDB_SYNC_CHUNK_KEPT(kept, nkept, i);
+    int32_t j = i + 1;
+    while (j < nchunks && TSDB_SYNC_CHUNK_KEPT(kept, nkept, j) == isKept && (!isKept || srcOf[j] == srcOf[i])) j++;
+
+    int64_t offset = (int64_t)i * TSDB_SYNC_CHUNK_SIZE;
+    int64_t len = TSDB_SYNC_CHUNK_END(j - 1, size) - offset;
+    int64_t ret;
+
+    if (isKept) {
+      ret = taosSendFile(TSDB_FILE_FD(pDFile), TSDB_FILE_FD(&srcs[srcOf[i]]), &offset, len);
+    } else {
+      ret = taosCopyFds(pSynch->socketFd, TSDB_FILE_FD(pDFile), len);
+    }
+
+    if (ret != len) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      tsdbError("vgId:%d, failed to %s file:%s since %s, ret:%" PRId64 " len:%" PRId64, REPO_ID(pRepo),
+                isKept ? "copy" : "recv", pDFile->f.aname, tstrerror(terrno), ret, len);
+      goto _err;
+    }
+
+    if (!isKept) received += len;
+    i = j;
+  }
+
+  tsdbInfo("vgId:%d, file:%s is received, size:%" PRId64 " received:%" PRId64 " chunks:%d kept:%u", REPO_ID(pRepo),
+           pDFile->f.aname, size, received, nchunks, nkept);
+  code = 0;
+
+_err:
+  pSynch->received += received;
+  tsdbCloseDFile(&srcs[0]);
+  tsdbCloseDFile(&srcs[1]);
+  tfree(srcOf);
+  return code;
+}
+
+static int64_t tsdbGetDFileSetDiskSize(SDFileSet *pSet) {
+  int64_t size = 0;
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+    struct stat fstat;
+    if (stat(TSDB_FILE_FULL_NAME(TSDB_DFILE_IN_SET(pSet, ftype)), &fstat) == 0) size += fstat.st_size;
+  }
+
+  return size;
+}
+
+// the files are renamed, since the next sync may create the files of the same name
+static void tsdbKeepSyncPart(STsdbRepo *pRepo, SDFileSet *pSet) {
+  if (pRepo->syncPart && tsdbGetDFileSetDiskSize(pRepo->syncPart) >= tsdbGetDFileSetDiskSize(pSet)) {
+    tsdbRemoveDFileSet(pSet);
+    return;
+  }
+
+  SDFileSet *pPart = malloc(sizeof(SDFileSet));
+  if (pPart == NULL) {
+    tsdbRemoveDFileSet(pSet);
+    return;
+  }
+
+  *pPart = *pSet;
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pPart); ftype++) {
+    SDFile *pDFile = TSDB_DFILE_IN_SET(pPart, ftype);
+    char    aname[TSDB_FILENAME_LEN + 8];
+
+    snprintf(aname, sizeof(aname), "%s.sync", TSDB_FILE_FULL_NAME(pDFile));
+    if (strlen(aname) >= sizeof(pDFile->f.aname) || taosRename(TSDB_FILE_FULL_NAME(pDFile), aname) != 0) {
+      tsdbRemoveDFileSet(pPart);
+      free(pPart);
+      return;
+    }
+    tstrncpy(pDFile->f.aname, aname, sizeof(pDFile->f.aname));
+  }
+
+  tsdbRemoveSyncPart(pRepo);
+  pRepo->syncPart = pPart;
+  tsdbInfo("vgId:%d, fileset:%d partly received is kept, size:%" PRId64, REPO_ID(pRepo), pPart->fid,
+           tsdbGetDFileSetDiskSize(pPart));
+}
+
+void tsdbRemoveSyncPart(STsdbRepo *pRepo) {
+  if (pRepo->syncPart == NULL) return;
+
+  tsdbRemoveDFileSet(pRepo->syncPart);
+  tfree(pRepo->syncPart);
+}
+
 static int tsdbReload(STsdbRepo *pRepo, bool isMfChanged) {
   // TODO: may need to stop and restart stream
   // if (isMfChanged) {
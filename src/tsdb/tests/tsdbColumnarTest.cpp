@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "tsdbint.h"
+
+namespace {
+
+// the schema of the blocks is ts timestamp, c1 int, c2 binary(binaryLen)
+const int32_t binaryLen = 16;
+
+const int64_t ts[] = {1626006833000, 1626006833001, 1626006833002};
+const int32_t ints[] = {1, -2, 3};
+const char *  strs[] = {"a", "", "0123456789abcdef"};
+const int32_t numOfRows = 3;
+
+STSchema *testSchema() {
+  STSchemaBuilder builder;
+  if (tdInitTSchemaBuilder(&builder, 1) < 0) return NULL;
+
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_TIMESTAMP, 1, TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP]);
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_INT, 2, TYPE_BYTES[TSDB_DATA_TYPE_INT]);
+  tdAddColToSchema(&builder, TSDB_DATA_TYPE_BINARY, 3, binaryLen + VARSTR_HEADER_SIZE);
+
+  STSchema *pSchema = tdGetSchemaFromBuilder(&builder);
+  tdDestroyTSchemaBuilder(&builder);
+  return pSchema;
+}
+
+// a columnar submit block of the rows in host byte order, it is freed by free()
+SSubmitBlk *makeBlock(int32_t rows, const int64_t *pts, const int32_t *pints, const char **pstrs) {
+  int32_t varLen = 0;
+  for (int32_t r = 0; r < rows; r++) varLen += VARSTR_HEADER_SIZE + (int32_t)strlen(pstrs[r]);
+
+  int32_t     dataLen = rows * (sizeof(int64_t) + sizeof(int32_t)) + (rows + 1) * sizeof(int32_t) + varLen;
+  SSubmitBlk *pBlock = (SSubmitBlk *)calloc(1, sizeof(SSubmitBlk) + dataLen);
+  if (pBlock == NULL) return NULL;
+
+  pBlock->flag = FLAG_BLK_COLUMNAR;
+  pBlock->sversion = 1;
+  pBlock->dataLen = dataLen;
+  pBlock->numOfRows = (int16_t)rows;
+
+  char *pData = pBlock->data;
+  memcpy(pData, pts, rows * sizeof(int64_t));
+  pData += rows * sizeof(int64_t);
+  memcpy(pData, pints, rows * sizeof(int32_t));
+  pData += rows * sizeof(int32_t);
+
+  int32_t *offsets = (int32_t *)pData;
+  char *   values = pData + (rows + 1) * sizeof(int32_t);
+  offsets[0] = 0;
+  for (int32_t r = 0; r < rows; r++) {
+    STR_WITH_SIZE_TO_VARSTR(values + offsets[r], pstrs[r], (VarDataLenT)strlen(pstrs[r]));
+    offsets[r + 1] = offsets[r] + varDataTLen(values + offsets[r]);
+  }
+
+  return pBlock;
+}
+
+SSubmitBlk *buildBlock() { return makeBlock(numOfRows, ts, ints, strs); }
+
+// the code of checking the block against the schema, 0 if the block is good
+int32_t checkBlock(SSubmitBlk *pBlock) {
+  STSchema *pSchema = testSchema();
+  int32_t   code = TSDB_CODE_SUCCESS;
+
+  terrno = TSDB_CODE_SUCCESS;
+  if (tsdbCheckColumnarData(pSchema, pBlock) < 0) code = terrno;
+
+  tdFreeSchema(pSchema);
+  return code;
+}
+
+// the rows built from the block, at most maxRows, the binary values are null-terminated
+int32_t readRows(SSubmitBlk *pBlock, int64_t *pts, int32_t *pints, char (*pstrs)[binaryLen + 1], int32_t maxRows) {
+  STSchema *     pSchema = testSchema();
+  void *         pBuf = NULL;
+  SSubmitColIter iter;
+  int32_t        rows = 0;
+
+  memset(&iter, 0, sizeof(iter));
+  if (tsdbInitSubmitColIter(pSchema, pBlock, &pBuf, &iter) == 0) {
+    SMemRow memRow = NULL;
+    while (rows < maxRows && (memRow = tsdbGetSubmitColNext(&iter)) != NULL) {
+      SDataRow row = memRowDataBody(memRow);
+      pts[rows] = *(int64_t *)tdGetColOfRowBySchema(row, pSchema, 0);
+      pints[rows] = *(int32_t *)tdGetColOfRowBySchema(row, pSchema, 1);
+
+      char *value = (char *)tdGetColOfRowBySchema(row, pSchema, 2);
+      memcpy(pstrs[rows], varDataVal(value), varDataLen(value));
+      pstrs[rows][varDataLen(value)] = 0;
+      rows++;
+    }
+  }
+
+  taosTZfree(pBuf);
+  tdFreeSchema(pSchema);
+  return rows;
+}
+
+int32_t *offsetsOf(SSubmitBlk *pBlock) {
+  return (int32_t *)(pBlock->data + pBlock->schemaLen + pBlock->numOfRows * (sizeof(int64_t) + sizeof(int32_t)));
+}
+
+char *valuesOf(SSubmitBlk *pBlock) { return (char *)(offsetsOf(pBlock) + pBlock->numOfRows + 1); }
+
+}  // namespace
+
+TEST(tsdbColumnarTest, check_good_block) {
+  SSubmitBlk *pBlock = buildBlock();
+  ASSERT_NE(pBlock, nullptr);
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_SUCCESS);
+  free(pBlock);
+}
+
+TEST(tsdbColumnarTest, check_messed_up_block) {
+  SSubmitBlk *pBlock = buildBlock();
+
+  // the data is shorter or longer than the columns
+  pBlock->dataLen -= 1;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  pBlock->dataLen += 2;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  pBlock->dataLen -= 1;
+
+  pBlock->numOfRows = 0;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  pBlock->numOfRows = numOfRows;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_SUCCESS);
+
+  // the offsets of the binary values
+  int32_t *offsets = offsetsOf(pBlock);
+  offsets[0] = 1;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  offsets[0] = 0;
+
+  offsets[numOfRows] += 1;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  offsets[numOfRows] -= 1;
+
+  std::swap(offsets[1], offsets[2]);
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  std::swap(offsets[1], offsets[2]);
+
+  // the length of a value does not match its offsets
+  VarDataLenT *pLen = (VarDataLenT *)(valuesOf(pBlock) + offsets[0]);
+  *pLen += 1;
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  *pLen -= 1;
+
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_SUCCESS);
+  free(pBlock);
+}
+
+TEST(tsdbColumnarTest, check_too_long_binary) {
+  const char *longStrs[] = {"a", "", "0123456789abcdefg"};
+  SSubmitBlk *pBlock = makeBlock(numOfRows, ts, ints, longStrs);
+  EXPECT_EQ(checkBlock(pBlock), TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP);
+  free(pBlock);
+}
+
+TEST(tsdbColumnarTest, rows_of_block) {
+  SSubmitBlk *pBlock = buildBlock();
+
+  int64_t rts[numOfRows + 1] = {0};
+  int32_t rints[numOfRows + 1] = {0};
+  char    rstrs[numOfRows + 1][binaryLen + 1];
+  ASSERT_EQ(readRows(pBlock, rts, rints, rstrs, numOfRows + 1), numOfRows);
+
+  for (int32_t r = 0; r < numOfRows; ++r) {
+    EXPECT_EQ(rts[r], ts[r]);
+    EXPECT_EQ(rints[r], ints[r]);
+    EXPECT_STREQ(rstrs[r], strs[r]);
+  }
+
+  // the iterator stops at the rows asked for
+  ASSERT_EQ(readRows(pBlock, rts, rints, rstrs, 1), 1);
+  EXPECT_EQ(rts[0], ts[0]);
+
+  free(pBlock);
+}
+
+TEST(tsdbColumnarTest, rows_of_large_block) {
+  const int32_t            rows = 4096;
+  std::vector<int64_t>     vts(rows);
+  std::vector<int32_t>     vints(rows);
+  std::vector<std::string> vstrs(rows);
+  std::vector<const char *> pstrs(rows);
+  for (int32_t r = 0; r < rows; ++r) {
+    vts[r] = 1626006833000 + r;
+    vints[r] = r * 7;
+    vstrs[r] = std::string(r % (binaryLen + 1), 'a' + r % 26);
+    pstrs[r] = vstrs[r].c_str();
+  }
+
+  SSubmitBlk *pBlock = makeBlock(rows, vts.data(), vints.data(), pstrs.data());
+  ASSERT_EQ(checkBlock(pBlock), TSDB_CODE_SUCCESS);
+
+  std::vector<int64_t> rts(rows);
+  std::vector<int32_t> rints(rows);
+  std::vector<char>    rstrs(rows * (binaryLen + 1));
+  ASSERT_EQ(readRows(pBlock, rts.data(), rints.data(), (char(*)[binaryLen + 1])rstrs.data(), rows), rows);
+
+  for (int32_t r = 0; r < rows; ++r) {
+    ASSERT_EQ(rts[r], vts[r]);
+    ASSERT_EQ(rints[r], vints[r]);
+    ASSERT_STREQ(&rstrs[r * (binaryLen + 1)], pstrs[r]);
+  }
+
+  free(pBlock);
+}
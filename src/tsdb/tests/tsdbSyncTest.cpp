@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tsdbint.h"
+
+namespace {
+
+const std::string testDir = "/tmp/tsdbSyncTest";
+const int64_t     chunk = TSDB_SYNC_CHUNK_SIZE;
+
+typedef struct {
+  int32_t sendCode;
+  int32_t recvCode;
+  int64_t sent;
+  int64_t received;
+} SSyncFileResult;
+
+typedef struct {
+  SSyncH *pSynch;
+  SDFile *pDFile;
+  bool    byChunks;
+  int32_t code;
+} SSendParam;
+
+void *syncSend(void *param) {
+  SSendParam *pParam = (SSendParam *)param;
+  pParam->code = tsdbSyncSendDFile(pParam->pSynch, pParam->pDFile, pParam->byChunks);
+  return NULL;
+}
+
+void initDFile(SDFile *pDFile, const char *name) {
+  struct stat st;
+
+  memset(pDFile, 0, sizeof(SDFile));
+  tstrncpy(pDFile->f.aname, name, sizeof(pDFile->f.aname));
+  if (stat(name, &st) == 0) pDFile->info.size = st.st_size;
+  TSDB_FILE_SET_CLOSED(pDFile);
+}
+
+void initSyncH(SSyncH *pSynch, STsdbRepo *pRepo, SOCKET fd) {
+  memset(pSynch, 0, sizeof(SSyncH));
+  pSynch->pRepo = pRepo;
+  pSynch->socketFd = fd;
+}
+
+// the remote file is sent to the recv file through a socket pair, local and part may be NULL
+void syncFile(const char *remote, const char *recv, const char *local, const char *part, bool byChunks,
+              SSyncFileResult *pRes) {
+  STsdbRepo  repo;
+  SSyncH     sendH, recvH;
+  SDFile     rdf, sdf, df, ldf, pdf;
+  SSendParam param;
+  pthread_t  thread;
+  int        fds[2];
+
+  memset(&repo, 0, sizeof(repo));
+  memset(pRes, 0, sizeof(SSyncFileResult));
+  pRes->sendCode = pRes->recvCode = -1;
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return;
+
+  initSyncH(&sendH, &repo, fds[0]);
+  initSyncH(&recvH, &repo, fds[1]);
+
+  initDFile(&rdf, remote);
+  sdf = rdf;
+  initDFile(&df, recv);
+  if (local) initDFile(&ldf, local);
+  if (part) initDFile(&pdf, part);
+
+  if (tsdbOpenDFile(&sdf, O_RDONLY) == 0 && tsdbOpenDFile(&df, O_WRONLY | O_CREAT | O_TRUNC) == 0) {
+    param.pSynch = &sendH;
+    param.pDFile = &sdf;
+    param.byChunks = byChunks;
+    param.code = -1;
+    pthread_create(&thread, NULL, syncSend, &param);
+    pRes->recvCode = tsdbSyncRecvDFile(&recvH, &df, &rdf, local ? &ldf : NULL, part ? &pdf : NULL, byChunks);
+    pthread_join(thread, NULL);
+
+    pRes->sendCode = param.code;
+    pRes->sent = sendH.sent;
+    pRes->received = recvH.received;
+  }
+
+  tsdbCloseDFile(&sdf);
+  tsdbCloseDFile(&df);
+  tsdbDestroySyncH(&sendH);
+  tsdbDestroySyncH(&recvH);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// the fid and the sender features told by the fileset info, which is sent in the format of old versions if asked
+int32_t syncFSetInfo(int32_t fid, bool oldVersion, int32_t *rfid, uint8_t *features) {
+  STsdbRepo repo;
+  SSyncH    sendH, recvH;
+  SDFileSet set;
+  int       fds[2];
+  int32_t   code = -1;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return -1;
+  memset(&repo, 0, sizeof(repo));
+  initSyncH(&sendH, &repo, fds[0]);
+  initSyncH(&recvH, &repo, fds[1]);
+
+  memset(&set, 0, sizeof(set));
+  set.fid = fid;
+  set.ver = TSDB_LATEST_FSET_VER;
+  for (int ftype = 0; ftype < tsdbGetNFiles(&set); ftype++) {
+    TSDB_DFILE_IN_SET(&set, ftype)->info.size = 1000 + ftype;
+  }
+
+  if (oldVersion) {
+    uint32_t tlen = tsdbEncodeDFileSetEx(NULL, &set) + sizeof(TSCKSUM);
+    char     buf[1024];
+    void *   ptr = buf;
+    taosEncodeFixedU32(&ptr, tlen);
+    tsdbEncodeDFileSetEx(&ptr, &set);
+    taosCalcChecksumAppend(0, (uint8_t *)buf + sizeof(uint32_t), tlen);
+    if (taosWriteMsg(fds[0], buf, tlen + sizeof(uint32_t)) != (int32_t)(tlen + sizeof(uint32_t))) goto _end;
+  } else {
+    if (tsdbSendDFileSetInfo(&sendH, &set) < 0) goto _end;
+  }
+
+  if (tsdbRecvDFileSetInfo(&recvH) < 0 || recvH.pdf == NULL) goto _end;
+  if (TSDB_DFILE_IN_SET(recvH.pdf, TSDB_FILE_LAST)->info.size != 1000 + TSDB_FILE_LAST) goto _end;
+
+  *rfid = recvH.pdf->fid;
+  *features = recvH.features;
+  code = 0;
+
+_end:
+  tsdbDestroySyncH(&sendH);
+  tsdbDestroySyncH(&recvH);
+  close(fds[0]);
+  close(fds[1]);
+  return code;
+}
+
+std::string pathOf(const char *name) { return testDir + "/" + name; }
+
+std::vector<char> makeContent(int64_t size, uint32_t seed) {
+  std::vector<char> content(size);
+  std::mt19937      rng(seed);
+  for (int64_t i = 0; i < size; ++i) content[i] = (char)(rng() % 256);
+  return content;
+}
+
+void writeFile(const char *name, const std::vector<char> &content) {
+  FILE *fp = fopen(pathOf(name).c_str(), "wb");
+  ASSERT_NE(fp, nullptr);
+  if (!content.empty()) {
+    ASSERT_EQ(fwrite(content.data(), 1, content.size(), fp), content.size());
+  }
+  fclose(fp);
+}
+
+std::vector<char> readFile(const char *name) {
+  std::vector<char> content;
+  FILE *            fp = fopen(pathOf(name).c_str(), "rb");
+  if (fp == NULL) return content;
+
+  char   buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) content.insert(content.end(), buf, buf + n);
+  fclose(fp);
+  return content;
+}
+
+class TsdbSyncTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TearDown();
+    ASSERT_EQ(mkdir(testDir.c_str(), 0755), 0);
+  }
+
+  void TearDown() override {
+    const char *names[] = {"remote", "recv", "local", "recv.sync"};
+    for (const char *name : names) unlink(pathOf(name).c_str());
+    rmdir(testDir.c_str());
+  }
+
+  // the remote file is sent to "recv", with the local and partly received files of the names given
+  SSyncFileResult sync(const std::vector<char> &remote, const char *local, const char *part, bool byChunks) {
+    SSyncFileResult res;
+    writeFile("remote", remote);
+
+    std::string localPath = local ? pathOf(local) : "";
+    std::string partPath = part ? pathOf(part) : "";
+    syncFile(pathOf("remote").c_str(), pathOf("recv").c_str(), local ? localPath.c_str() : NULL,
+             part ? partPath.c_str() : NULL, byChunks, &res);
+
+    EXPECT_EQ(res.sendCode, 0);
+    EXPECT_EQ(res.recvCode, 0);
+    EXPECT_EQ(res.sent, res.received);
+    EXPECT_TRUE(readFile("recv") == remote);
+    return res;
+  }
+};
+
+}  // namespace
+
+// no digest is exchanged with the peer of old version, the whole file is sent even if the local one is the same
+TEST_F(TsdbSyncTest, whole_file) {
+  std::vector<char> remote = makeContent(2 * chunk + 123, 1);
+  writeFile("local", remote);
+
+  SSyncFileResult res = sync(remote, "local", NULL, false);
+  EXPECT_EQ(res.received, (int64_t)remote.size());
+}
+
+TEST_F(TsdbSyncTest, skip_same_chunks) {
+  std::vector<char> remote = makeContent(3 * chunk + 1000, 2);
+  std::vector<char> local = remote;
+  local[chunk + 10] ^= 0x1;
+  local.resize(3 * chunk + 10);
+  writeFile("local", local);
+
+  // the chunk modified and the last chunk of a different size are received
+  SSyncFileResult res = sync(remote, "local", NULL, true);
+  EXPECT_EQ(res.received, chunk + 1000);
+}
+
+TEST_F(TsdbSyncTest, link_same_file) {
+  std::vector<char> remote = makeContent(chunk + 7, 3);
+  writeFile("local", remote);
+
+  SSyncFileResult res = sync(remote, "local", NULL, true);
+  EXPECT_EQ(res.received, 0);
+
+  struct stat st;
+  ASSERT_EQ(stat(pathOf("recv").c_str(), &st), 0);
+  EXPECT_EQ(st.st_nlink, 2u);
+}
+
+TEST_F(TsdbSyncTest, empty_file) {
+  SSyncFileResult res = sync(std::vector<char>(), NULL, NULL, true);
+  EXPECT_EQ(res.received, 0);
+}
+
+// the chunks received by the broken sync are kept, the rest of the file is received
+TEST_F(TsdbSyncTest, resume_from_part) {
+  std::vector<char> remote = makeContent(3 * chunk + 5, 4);
+  writeFile("recv.sync", std::vector<char>(remote.begin(), remote.begin() + 2 * chunk + chunk / 2));
+
+  SSyncFileResult res = sync(remote, NULL, "recv.sync", true);
+  EXPECT_EQ(res.received, chunk + 5);
+}
+
+// the part covers the leading chunks before the local file, which differs in the first and last chunk
+TEST_F(TsdbSyncTest, resume_from_part_and_local) {
+  std::vector<char> remote = makeContent(4 * chunk, 5);
+  std::vector<char> local = remote;
+  local[10] ^= 0x1;
+  local[3 * chunk + 10] ^= 0x1;
+  writeFile("recv.sync", std::vector<char>(remote.begin(), remote.begin() + chunk));
+  writeFile("local", local);
+
+  SSyncFileResult res = sync(remote, "local", "recv.sync", true);
+  EXPECT_EQ(res.received, chunk);
+}
+
+TEST_F(TsdbSyncTest, corrupted_part) {
+  std::vector<char> remote = makeContent(2 * chunk, 6);
+  std::vector<char> part(remote.begin(), remote.begin() + chunk);
+  part[100] ^= 0x1;
+  writeFile("recv.sync", part);
+
+  SSyncFileResult res = sync(remote, NULL, "recv.sync", true);
+  EXPECT_EQ(res.received, 2 * chunk);
+}
+
+TEST_F(TsdbSyncTest, fileset_info_features) {
+  int32_t fid = 0;
+  uint8_t features = 0xff;
+
+  ASSERT_EQ(syncFSetInfo(100, false, &fid, &features), 0);
+  EXPECT_EQ(fid, 100);
+  EXPECT_EQ(features, 0x1);  // TSDB_SYNC_FEATURE_CHUNKS
+
+  // a sender of old version sends the fileset only, so the files are asked in whole
+  ASSERT_EQ(syncFSetInfo(101, true, &fid, &features), 0);
+  EXPECT_EQ(fid, 101);
+  EXPECT_EQ(features, 0);
+}
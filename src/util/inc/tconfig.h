@@ -20,7 +20,7 @@
 extern "C" {
 #endif
 
-#define TSDB_CFG_MAX_NUM    131
+#define TSDB_CFG_MAX_NUM    147
 #define TSDB_CFG_PRINT_LEN  23
 #define TSDB_CFG_OPTION_LEN 24
 #define TSDB_CFG_VALUE_LEN  41
@@ -63,7 +63,8 @@ enum {
   TAOS_CFG_UTYPE_MB,
   TAOS_CFG_UTYPE_BYTE,
   TAOS_CFG_UTYPE_SECOND,
-  TAOS_CFG_UTYPE_MS
+  TAOS_CFG_UTYPE_MS,
+  TAOS_CFG_UTYPE_KB
 };
 
 typedef struct {
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TNUMFMT_H
+#define TDENGINE_TNUMFMT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * Number to text conversion without the printf machinery. Integers are written two digits at a time from a lookup
+ * table. Doubles and floats are written with the fewest digits that still parse back to the same value (Grisu2),
+ * in fixed notation for exponents in (-7, 21) and scientific notation otherwise, e.g. 0.1, 12.0, 1e-7, 1.5e300.
+ */
+#define TNUMFMT_MAX_LEN 32  // enough for any value and the terminating zero
+
+/**
+ * @return the length of the text, which is always terminated by zero
+ */
+int32_t tInt64ToStr(int64_t val, char *buf);
+int32_t tUInt64ToStr(uint64_t val, char *buf);
+int32_t tDoubleToStr(double val, char *buf);
+int32_t tFloatToStr(float val, char *buf);
+
+/**
+ * Write val as exactly width digits padded with leading zeros, val must be less than 10^width. Not terminated.
+ */
+void tFmtPadDigits(uint32_t val, int32_t width, char *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TNUMFMT_H
@@ -30,7 +30,11 @@ a single API instead of looping every queue by itself.
 Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe 
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
-3: read/write operation APIs are multi-thread safe
+3: write operation APIs are multi-thread safe and lock free, a queue may have many writers
+4: a queue shall have only one reader at a time. Reads from a queue set are serialized by the
+   qset, so any number of threads can read the same queue set; taosReadQitem/taosReadAllQitems
+   on a queue shall be called by one thread only
+5: a reader waiting on a queue set is only woken up if there is an item or a resume for it
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection. 
@@ -46,6 +50,7 @@ void       taosCloseQueue(taos_queue);
 void      *taosAllocateQitem(int size);
 void       taosFreeQitem(void *item);
 int        taosWriteQitem(taos_queue, int type, void *item);
+int        taosWriteQitems(taos_queue, int type, void **pitems, int num);
 int        taosReadQitem(taos_queue, int *type, void **pitem);
 
 taos_qall  taosAllocateQall();
@@ -55,7 +60,7 @@ int        taosGetQitem(taos_qall, int *type, void **pitem);
 void       taosResetQitems(taos_qall);
 
 taos_qset  taosOpenQset();
-void       taosCloseQset();
+void       taosCloseQset(taos_qset);
 void       taosQsetThreadResume(taos_qset param);
 int        taosAddIntoQset(taos_qset, taos_queue, void *ahandle);
 void       taosRemoveFromQset(taos_qset, taos_queue);
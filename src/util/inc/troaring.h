@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TROARING_H
+#define TDENGINE_TROARING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * A compressed bitmap of uint32 values in the roaring layout: values are partitioned by their high 16 bits, and each
+ * partition is a sorted uint16 array while it has at most ROARING_ARRAY_MAX_CARD values, or a 64K-bit bitset above.
+ */
+#define ROARING_ARRAY_MAX_CARD 4096
+
+typedef struct SRoaringContainer {
+  uint16_t  key;       // high 16 bits of the values
+  bool      isBitset;
+  int32_t   card;      // number of values
+  int32_t   capacity;  // capacity of the array container
+  uint16_t *array;     // sorted values of an array container
+  uint64_t *bitset;    // bits of a bitset container
+} SRoaringContainer;
+
+typedef struct SRoaringBitmap {
+  int32_t            size;
+  int32_t            capacity;
+  SRoaringContainer *containers;  // sorted by key
+} SRoaringBitmap;
+
+typedef struct SRoaringIter {
+  const SRoaringBitmap *pBitmap;
+  int32_t               cidx;
+  int32_t               pos;
+} SRoaringIter;
+
+SRoaringBitmap *tRoaringCreate();
+void            tRoaringDestroy(SRoaringBitmap *pBitmap);
+SRoaringBitmap *tRoaringDup(const SRoaringBitmap *pBitmap);
+
+/**
+ * @return 0 on success, -1 if out of memory
+ */
+int32_t tRoaringAdd(SRoaringBitmap *pBitmap, uint32_t val);
+void    tRoaringRemove(SRoaringBitmap *pBitmap, uint32_t val);
+bool    tRoaringContains(const SRoaringBitmap *pBitmap, uint32_t val);
+int64_t tRoaringCardinality(const SRoaringBitmap *pBitmap);
+
+/**
+ * The set operations return a new bitmap, or NULL if out of memory
+ */
+SRoaringBitmap *tRoaringAnd(const SRoaringBitmap *left, const SRoaringBitmap *right);
+SRoaringBitmap *tRoaringOr(const SRoaringBitmap *left, const SRoaringBitmap *right);
+SRoaringBitmap *tRoaringAndNot(const SRoaringBitmap *left, const SRoaringBitmap *right);
+
+/**
+ * Iterate the values in ascending order
+ */
+void tRoaringIterInit(SRoaringIter *pIter, const SRoaringBitmap *pBitmap);
+bool tRoaringIterNext(SRoaringIter *pIter, uint32_t *val);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TROARING_H
@@ -62,6 +62,8 @@ extern int tsCompressDoubleImp(const char *const input, const int nelements, cha
 extern int tsDecompressDoubleImp(const char *const input, const int nelements, char *const output);
 extern int tsCompressFloatImp(const char *const input, const int nelements, char *const output);
 extern int tsDecompressFloatImp(const char *const input, const int nelements, char *const output);
+// pick the decompression kernels supported by the cpu
+extern void taosResolveDecompress();
 // lossy
 extern int tsCompressFloatLossyImp(const char * input, const int nelements, char *const output);
 extern int tsDecompressFloatLossyImp(const char * input, int compressedSize, const int nelements, char *const output);
@@ -24,6 +24,7 @@ extern "C" {
 #include "taosdef.h"
 #include "tarray.h"
 #include "tfunctional.h"
+#include "tlockfree.h"
 
 #define MAX_SKIP_LIST_LEVEL 15
 #define SKIP_LIST_RECORD_PERFORMANCE 0
@@ -35,12 +36,14 @@ extern "C" {
 
 // For thread safety setting
 #define SL_THREAD_SAFE (uint8_t)0x4
+#define SL_LOCK_FREE (uint8_t)0x8  // Readers never block, writers are serialized by a latch (for mem table usage)
 
 typedef char *SSkipListKey;
 typedef char *(*__sl_key_fn_t)(const void *);
 
 typedef void (*sl_patch_row_fn_t)(void * pDst, const void * pSrc);
 typedef void* (*iter_next_fn_t)(void *iter);
+typedef void* (*sl_node_alloc_fn_t)(void *param, int32_t size);
 
 typedef struct SSkipListNode {
   uint8_t        level;
@@ -71,7 +74,16 @@ typedef struct SSkipListNode {
  *
  *    Memory consumption: the memory alignment causes many memory wasted. So, employ a memory
  *    pool will significantly reduce the total memory consumption, as well as the calloc/malloc operation costs.
+ *    A node allocator can be set by tSkipListSetNodeAllocator, the nodes are then carved out of the memory owned
+ *    by the caller and released all at once by the caller, tSkipListDestroy does not walk the nodes any more.
  *
+ * Note: Lock free mode (SL_LOCK_FREE).
+ * Readers (iterators, tSkipListGet) take no lock at all. Writers are serialized by a spin latch, which is
+ * uncontended for the mem table since the vnode write worker already serializes the inserts of one table.
+ * A new node is fully initialized before it is published, level by level from the bottom, with atomic stores,
+ * so a concurrent reader either sees the whole node or does not see it at all. Removed nodes are unlinked but
+ * retired instead of freed, and reclaimed only when the skip list is destroyed. The owner of the skip list
+ * (e.g. the reference counted mem table) guarantees that no reader is alive at that time.
  */
 
 // state struct, record following information:
@@ -123,6 +135,10 @@ typedef struct SSkipList {
   tSkipListState state;  // skiplist state
 #endif
   tGenericSavedFunc* insertHandleFn;
+  SRWLatch          wLatch;    // writer latch, only used in lock free mode
+  SArray *          pRetired;  // removed nodes waiting to be reclaimed, only used in lock free mode
+  sl_node_alloc_fn_t nodeAllocFn;  // allocate nodes from an arena owned by the caller, never freed one by one
+  void *             nodeAllocParam;
 } SSkipList;
 
 typedef struct SSkipListIterator {
@@ -134,6 +150,7 @@ typedef struct SSkipListIterator {
 } SSkipListIterator;
 
 #define SL_IS_THREAD_SAFE(s) (((s)->flags) & SL_THREAD_SAFE)
+#define SL_IS_LOCK_FREE(s) (((s)->flags) & SL_LOCK_FREE)
 #define SL_DUP_MODE(s) (((s)->flags) & ((((uint8_t)1) << 2) - 1))
 #define SL_GET_NODE_KEY(s, n) ((s)->keyFn((n)->pData))
 #define SL_GET_MIN_KEY(s) SL_GET_NODE_KEY(s, SL_NODE_GET_FORWARD_POINTER((s)->pHead, 0))
@@ -143,6 +160,7 @@ typedef struct SSkipListIterator {
 SSkipList *tSkipListCreate(uint8_t maxLevel, uint8_t keyType, uint16_t keyLen, __compar_fn_t comparFn, uint8_t flags,
                            __sl_key_fn_t fn);
 void       tSkipListDestroy(SSkipList *pSkipList);
+void       tSkipListSetNodeAllocator(SSkipList *pSkipList, sl_node_alloc_fn_t fn, void *param);
 SSkipListNode *    tSkipListPut(SSkipList *pSkipList, void *pData);
 void               tSkipListPutBatchByIter(SSkipList *pSkipList, void *iter, iter_next_fn_t iterate);
 SArray *           tSkipListGet(SSkipList *pSkipList, SSkipListKey pKey);
@@ -26,6 +26,9 @@ extern "C" {
 
 int32_t taosReadn(SOCKET sock, char *buffer, int32_t len);
 int32_t taosWriteMsg(SOCKET fd, void *ptr, int32_t nbytes);
+#ifndef WINDOWS
+int32_t taosWriteMsgV(SOCKET fd, struct iovec *iov, int32_t iovcnt);
+#endif
 int32_t taosReadMsg(SOCKET fd, void *ptr, int32_t nbytes);
 int32_t taosNonblockwrite(SOCKET fd, char *ptr, int32_t nbytes);
 int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len);
@@ -34,6 +37,10 @@ int32_t taosSetNonblocking(SOCKET sock, int32_t on);
 SOCKET  taosOpenUdpSocket(uint32_t localIp, uint16_t localPort);
 SOCKET  taosOpenTcpClientSocket(uint32_t ip, uint16_t port, uint32_t localIp);
 SOCKET  taosOpenTcpServerSocket(uint32_t ip, uint16_t port);
+#ifdef SO_REUSEPORT
+SOCKET  taosOpenTcpReusePortSocket(uint32_t ip, uint16_t port);
+bool    taosTcpPortInUse(uint32_t ip, uint16_t port);
+#endif
 int32_t taosKeepTcpAlive(SOCKET sockFd);
 
 int32_t  taosGetFqdn(char *);
@@ -232,7 +232,7 @@ int tsCompressINTImp(const char *const input, const int nelements, char *const o
   return opos;
 }
 
-int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
+static int tsDecompressINTScalar(const char *const input, const int nelements, char *const output, const char type) {
   int word_length = 0;
   switch (type) {
     case TSDB_DATA_TYPE_BIGINT:
@@ -567,7 +567,7 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
-int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output) {
+static int tsDecompressTimestampScalar(const char *const input, const int nelements, char *const output) {
   assert(nelements >= 0);
   if (nelements == 0) return 0;
 
@@ -746,7 +746,7 @@ uint64_t decodeDoubleValue(const char *const input, int *const ipos, uint8_t fla
   return diff;
 }
 
-int tsDecompressDoubleImp(const char *const input, const int nelements, char *const output) {
+static int tsDecompressDoubleScalar(const char *const input, const int nelements, char *const output) {
   // output stream
   double *ostream = (double *)output;
 
@@ -893,7 +893,7 @@ uint32_t decodeFloatValue(const char *const input, int *const ipos, uint8_t flag
   return diff;
 }
 
-int tsDecompressFloatImp(const char *const input, const int nelements, char *const output) {
+static int tsDecompressFloatScalar(const char *const input, const int nelements, char *const output) {
   float *ostream = (float *)output;
 
   if (input[0] == 1) {
@@ -930,6 +930,395 @@ int tsDecompressFloatImp(const char *const input, const int nelements, char *con
   return nelements * FLOAT_BYTES;
 }
 
+/* --------------------------------------------Decompression Kernels
+ * ---------------------------------------------- */
+// The decompression kernels are picked by taosResolveDecompress() according to the CPU features. All kernels decode
+// the same format and produce exactly the same output as the scalar ones above.
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__) && !defined(WINDOWS)
+#define TS_DECOMPRESS_AVX2
+#endif
+
+#ifdef TS_DECOMPRESS_AVX2
+#include <immintrin.h>
+
+#define TS_AVX2_FUNC __attribute__((target("avx2")))
+#define TS_DECOMPRESS_CHUNK 256  // values parsed from the stream before they are accumulated, must be even
+#define SIMPLE8B_MAX_ELEMS 240
+
+static const uint8_t simple8bBitPerInteger[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t simple8bSelectorToElems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+static const uint64_t byteMask[] = {0x0ul,
+                                    0xfful,
+                                    0xfffful,
+                                    0xfffffful,
+                                    0xfffffffful,
+                                    0xfffffffffful,
+                                    0xfffffffffffful,
+                                    0xfffffffffffffful,
+                                    0xfffffffffffffffful};
+
+// [a, b, c, d] -> [a, a+b, a+b+c, a+b+c+d]
+TS_AVX2_FUNC static FORCE_INLINE __m256i tsPrefixSumEpi64(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+  return x;
+}
+
+// [a, b, c, d] -> [a, a^b, a^b^c, a^b^c^d]
+TS_AVX2_FUNC static FORCE_INLINE __m256i tsPrefixXorEpi64(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+  return x;
+}
+
+// the same as above on 8 lanes of 32 bits
+TS_AVX2_FUNC static FORCE_INLINE __m256i tsPrefixXorEpi32(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6)), zero, 0x01));
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5)), zero, 0x03));
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 2, 3)), zero, 0x0F));
+  return x;
+}
+
+TS_AVX2_FUNC static FORCE_INLINE __m256i tsZigzagDecodeEpi64(__m256i v) {
+  __m256i sign = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(v, _mm256_set1_epi64x(1)));
+  return _mm256_xor_si256(_mm256_srli_epi64(v, 1), sign);
+}
+
+static FORCE_INLINE void tsStoreDecodedINT(const int64_t *values, int n, char *const output, int pos, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      memcpy((int64_t *)output + pos, values, n * sizeof(int64_t));
+      break;
+    case TSDB_DATA_TYPE_INT:
+      for (int i = 0; i < n; i++) *((int32_t *)output + pos + i) = (int32_t)values[i];
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      for (int i = 0; i < n; i++) *((int16_t *)output + pos + i) = (int16_t)values[i];
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      for (int i = 0; i < n; i++) *((int8_t *)output + pos + i) = (int8_t)values[i];
+      break;
+  }
+}
+
+/*
+ * Unpack the lanes of one simple8b word with variable shifts. The elements are zigzag decoded and accumulated four at
+ * a time, the last value of each group is carried to the next one.
+ */
+TS_AVX2_FUNC static int tsDecompressINTAvx2(const char *const input, const int nelements, char *const output, const char type) {
+  int word_length = 0;
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      word_length = LONG_BYTES;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      word_length = INT_BYTES;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      word_length = SHORT_BYTES;
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      word_length = CHAR_BYTES;
+      break;
+    default:
+      uError("Invalid decompress integer type:%d", type);
+      return -1;
+  }
+
+  // If not compressed.
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * word_length);
+    return nelements * word_length;
+  }
+
+  // the tail group of a word may write three lanes beyond the elements of the word
+  int64_t     values[SIMPLE8B_MAX_ELEMS + 4];
+  const char *ip = input + 1;
+  int         count = 0;
+  uint64_t    prev_value = 0;
+
+  const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+
+  while (count < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
+
+    int selector = (int)(w & INT64MASK(4));
+    int elems = MIN(simple8bSelectorToElems[selector], nelements - count);
+
+    if (selector == 0 || selector == 1) {
+      for (int i = 0; i < elems; i++) values[i] = (int64_t)prev_value;
+    } else {
+      int bit = simple8bBitPerInteger[selector];
+
+      __m256i vword = _mm256_set1_epi64x((int64_t)w);
+      __m256i vmask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+      __m256i vshift = _mm256_add_epi64(_mm256_set1_epi64x(4), _mm256_mul_epu32(lane, _mm256_set1_epi64x(bit)));
+      __m256i vstep = _mm256_set1_epi64x(bit * 4);
+      __m256i vprev = _mm256_set1_epi64x((int64_t)prev_value);
+
+      for (int i = 0; i < elems; i += 4) {
+        // shifts not less than 64 give zero, so the lanes beyond the word are harmless
+        __m256i zigzag = _mm256_and_si256(_mm256_srlv_epi64(vword, vshift), vmask);
+        __m256i curr = _mm256_add_epi64(tsPrefixSumEpi64(tsZigzagDecodeEpi64(zigzag)), vprev);
+        _mm256_storeu_si256((__m256i *)(values + i), curr);
+
+        vprev = _mm256_permute4x64_epi64(curr, _MM_SHUFFLE(3, 3, 3, 3));
+        vshift = _mm256_add_epi64(vshift, vstep);
+      }
+      prev_value = (uint64_t)values[elems - 1];
+    }
+
+    tsStoreDecodedINT(values, elems, output, count, type);
+    count += elems;
+  }
+
+  return nelements * word_length;
+}
+
+/*
+ * The flag bytes make the stream variable length, so the zigzag encoded delta of delta of a chunk is parsed first and
+ * then accumulated twice in vector registers. While at least eight pairs follow the current one, a value can be loaded
+ * with a single unaligned 8 bytes read and masked.
+ */
+TS_AVX2_FUNC static int tsDecompressTimestampAvx2(const char *const input, const int nelements, char *const output) {
+  assert(nelements >= 0);
+  if (nelements == 0) return 0;
+
+  if (input[0] == 0) {
+    memcpy(output, input + 1, nelements * LONG_BYTES);
+    return nelements * LONG_BYTES;
+  } else if (input[0] != 1) {
+    assert(0);
+    return -1;
+  }
+
+  int64_t *ostream = (int64_t *)output;
+  uint64_t dods[TS_DECOMPRESS_CHUNK];
+  int      ipos = 1, opos = 0;
+  uint64_t prev_value = 0;
+  uint64_t prev_delta = 0;
+
+  while (opos < nelements) {
+    int n = MIN(TS_DECOMPRESS_CHUNK, nelements - opos);
+
+    for (int i = 0; i < n; i += 2) {
+      uint8_t flags = input[ipos++];
+      int     nbytes1 = flags & INT8MASK(4);
+      int     nbytes2 = (flags >> 4) & INT8MASK(4);
+      uint64_t dd1 = 0, dd2 = 0;
+
+      if (nelements - (opos + i) >= 18) {
+        memcpy(&dd1, input + ipos, LONG_BYTES);
+        memcpy(&dd2, input + ipos + nbytes1, LONG_BYTES);
+        dd1 &= byteMask[nbytes1];
+        dd2 &= byteMask[nbytes2];
+      } else {
+        memcpy(&dd1, input + ipos, nbytes1);
+        if (i + 1 < n) memcpy(&dd2, input + ipos + nbytes1, nbytes2);
+      }
+
+      dods[i] = dd1;
+      ipos += nbytes1;
+      if (i + 1 < n) {
+        dods[i + 1] = dd2;
+        ipos += nbytes2;
+      }
+    }
+
+    int i = 0;
+    if (opos == 0) {
+      // the first value is stored as is
+      prev_value = (uint64_t)ZIGZAG_DECODE(int64_t, dods[0]);
+      prev_delta = 0;
+      ostream[0] = (int64_t)prev_value;
+      i = 1;
+    }
+
+    __m256i vdelta = _mm256_set1_epi64x((int64_t)prev_delta);
+    __m256i vvalue = _mm256_set1_epi64x((int64_t)prev_value);
+    for (; i + 4 <= n; i += 4) {
+      __m256i dod = tsZigzagDecodeEpi64(_mm256_loadu_si256((__m256i *)(dods + i)));
+      __m256i delta = _mm256_add_epi64(tsPrefixSumEpi64(dod), vdelta);
+      __m256i value = _mm256_add_epi64(tsPrefixSumEpi64(delta), vvalue);
+      _mm256_storeu_si256((__m256i *)(ostream + opos + i), value);
+
+      vdelta = _mm256_permute4x64_epi64(delta, _MM_SHUFFLE(3, 3, 3, 3));
+      vvalue = _mm256_permute4x64_epi64(value, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    prev_delta = (uint64_t)_mm256_extract_epi64(vdelta, 0);
+    prev_value = (uint64_t)_mm256_extract_epi64(vvalue, 0);
+
+    for (; i < n; i++) {
+      prev_delta += (uint64_t)ZIGZAG_DECODE(int64_t, dods[i]);
+      prev_value += prev_delta;
+      ostream[opos + i] = (int64_t)prev_value;
+    }
+
+    opos += n;
+  }
+
+  return nelements * LONG_BYTES;
+}
+
+/*
+ * Every value takes at least one byte in the stream, so a full word can be read whenever enough values remain. The
+ * XOR against the previous value is a prefix xor over the parsed differences.
+ */
+TS_AVX2_FUNC static int tsDecompressDoubleAvx2(const char *const input, const int nelements, char *const output) {
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * DOUBLE_BYTES);
+    return nelements * DOUBLE_BYTES;
+  }
+
+  uint64_t *ostream = (uint64_t *)output;
+  uint64_t  diffs[TS_DECOMPRESS_CHUNK];
+  uint8_t   flags = 0;
+  int       ipos = 1;
+  int       opos = 0;
+  uint64_t  prev_value = 0;
+
+  while (opos < nelements) {
+    int n = MIN(TS_DECOMPRESS_CHUNK, nelements - opos);
+
+    for (int i = 0; i < n; i++) {
+      if (i % 2 == 0) {
+        flags = input[ipos++];
+      }
+
+      uint8_t flag = flags & INT8MASK(4);
+      flags >>= 4;
+
+      if (nelements - (opos + i) >= LONG_BYTES) {
+        int      nbytes = (flag & INT8MASK(3)) + 1;
+        uint64_t diff = 0;
+        memcpy(&diff, input + ipos, LONG_BYTES);
+        ipos += nbytes;
+        diffs[i] = (diff & byteMask[nbytes]) << ((LONG_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+      } else {
+        diffs[i] = decodeDoubleValue(input, &ipos, flag);
+      }
+    }
+
+    int     i = 0;
+    __m256i vprev = _mm256_set1_epi64x((int64_t)prev_value);
+    for (; i + 4 <= n; i += 4) {
+      __m256i curr = _mm256_xor_si256(tsPrefixXorEpi64(_mm256_loadu_si256((__m256i *)(diffs + i))), vprev);
+      _mm256_storeu_si256((__m256i *)(ostream + opos + i), curr);
+      vprev = _mm256_permute4x64_epi64(curr, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    prev_value = (uint64_t)_mm256_extract_epi64(vprev, 0);
+
+    for (; i < n; i++) {
+      prev_value ^= diffs[i];
+      ostream[opos + i] = prev_value;
+    }
+
+    opos += n;
+  }
+
+  return nelements * DOUBLE_BYTES;
+}
+
+TS_AVX2_FUNC static int tsDecompressFloatAvx2(const char *const input, const int nelements, char *const output) {
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * FLOAT_BYTES);
+    return nelements * FLOAT_BYTES;
+  }
+
+  uint32_t *ostream = (uint32_t *)output;
+  uint32_t  diffs[TS_DECOMPRESS_CHUNK];
+  uint8_t   flags = 0;
+  int       ipos = 1;
+  int       opos = 0;
+  uint32_t  prev_value = 0;
+
+  while (opos < nelements) {
+    int n = MIN(TS_DECOMPRESS_CHUNK, nelements - opos);
+
+    for (int i = 0; i < n; i++) {
+      if (i % 2 == 0) {
+        flags = input[ipos++];
+      }
+
+      uint8_t flag = flags & INT8MASK(4);
+      flags >>= 4;
+
+      if (nelements - (opos + i) >= FLOAT_BYTES) {
+        int      nbytes = (flag & INT8MASK(3)) + 1;
+        uint32_t diff = 0;
+        memcpy(&diff, input + ipos, FLOAT_BYTES);
+        ipos += nbytes;
+        diffs[i] = (diff & (uint32_t)byteMask[nbytes]) << ((FLOAT_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+      } else {
+        diffs[i] = decodeFloatValue(input, &ipos, flag);
+      }
+    }
+
+    int     i = 0;
+    __m256i vprev = _mm256_set1_epi32((int32_t)prev_value);
+    for (; i + 8 <= n; i += 8) {
+      __m256i curr = _mm256_xor_si256(tsPrefixXorEpi32(_mm256_loadu_si256((__m256i *)(diffs + i))), vprev);
+      _mm256_storeu_si256((__m256i *)(ostream + opos + i), curr);
+      vprev = _mm256_permutevar8x32_epi32(curr, _mm256_set1_epi32(7));
+    }
+    prev_value = (uint32_t)_mm256_extract_epi32(vprev, 0);
+
+    for (; i < n; i++) {
+      prev_value ^= diffs[i];
+      ostream[opos + i] = prev_value;
+    }
+
+    opos += n;
+  }
+
+  return nelements * FLOAT_BYTES;
+}
+#endif  // TS_DECOMPRESS_AVX2
+
+static int (*tsDecompressINTFp)(const char *const, const int, char *const, const char) = tsDecompressINTScalar;
+static int (*tsDecompressTimestampFp)(const char *const, const int, char *const) = tsDecompressTimestampScalar;
+static int (*tsDecompressDoubleFp)(const char *const, const int, char *const) = tsDecompressDoubleScalar;
+static int (*tsDecompressFloatFp)(const char *const, const int, char *const) = tsDecompressFloatScalar;
+
+void taosResolveDecompress() {
+#ifdef TS_DECOMPRESS_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    tsDecompressINTFp = tsDecompressINTAvx2;
+    tsDecompressTimestampFp = tsDecompressTimestampAvx2;
+    tsDecompressDoubleFp = tsDecompressDoubleAvx2;
+    tsDecompressFloatFp = tsDecompressFloatAvx2;
+    return;
+  }
+#endif
+  tsDecompressINTFp = tsDecompressINTScalar;
+  tsDecompressTimestampFp = tsDecompressTimestampScalar;
+  tsDecompressDoubleFp = tsDecompressDoubleScalar;
+  tsDecompressFloatFp = tsDecompressFloatScalar;
+}
+
+int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
+  return (*tsDecompressINTFp)(input, nelements, output, type);
+}
+
+int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output) {
+  return (*tsDecompressTimestampFp)(input, nelements, output);
+}
+
+int tsDecompressDoubleImp(const char *const input, const int nelements, char *const output) {
+  return (*tsDecompressDoubleFp)(input, nelements, output);
+}
+
+int tsDecompressFloatImp(const char *const input, const int nelements, char *const output) {
+  return (*tsDecompressFloatFp)(input, nelements, output);
+}
+
 #ifdef TD_TSZ  
 //
 //   ----------  float double lossy  -----------
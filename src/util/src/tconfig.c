@@ -38,7 +38,8 @@ static char *tsGlobalUnit[] = {
   "(Mb)", 
   "(byte)", 
   "(s)", 
-  "(ms)"
+  "(ms)",
+  "(KB)"
 };
 
 char *tsCfgStatusStr[] = {
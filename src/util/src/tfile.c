@@ -104,6 +104,17 @@ int32_t tfFsync(int64_t tfd) {
   return code;
 }
 
+int32_t tfFdatasync(int64_t tfd) {
+  void *p = taosAcquireRef(tsFileRsetId, tfd);
+  if (p == NULL) return -1;
+
+  int32_t fd = (int32_t)(uintptr_t)p;
+  int32_t code = taosFdatasync(fd);
+
+  taosReleaseRef(tsFileRsetId, tfd);
+  return code;
+}
+
 bool tfValid(int64_t tfd) {
   void *p = taosAcquireRef(tsFileRsetId, tfd);
   if (p == NULL) return false;
@@ -134,6 +145,17 @@ int32_t tfFtruncate(int64_t tfd, int64_t length) {
   return code;
 }
 
+int32_t tfFallocate(int64_t tfd, int64_t length) {
+  void *p = taosAcquireRef(tsFileRsetId, tfd);
+  if (p == NULL) return -1;
+
+  int32_t fd = (int32_t)(uintptr_t)p;
+  int32_t code = taosFallocate(fd, length);
+
+  taosReleaseRef(tsFileRsetId, tfd);
+  return code;
+}
+
 int32_t tfStat(int64_t tfd, struct stat *pFstat) {
   void *p = taosAcquireRef(tsFileRsetId, tfd);
   if (p == NULL) return -1;
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tnumfmt.h"
+
+static const char tDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t tPow10[] = {1ULL,
+                                  10ULL,
+                                  100ULL,
+                                  1000ULL,
+                                  10000ULL,
+                                  100000ULL,
+                                  1000000ULL,
+                                  10000000ULL,
+                                  100000000ULL,
+                                  1000000000ULL,
+                                  10000000000ULL,
+                                  100000000000ULL,
+                                  1000000000000ULL,
+                                  10000000000000ULL,
+                                  100000000000000ULL,
+                                  1000000000000000ULL,
+                                  10000000000000000ULL,
+                                  100000000000000000ULL,
+                                  1000000000000000000ULL,
+                                  10000000000000000000ULL};
+
+int32_t tUInt64ToStr(uint64_t val, char *buf) {
+  char  tmp[24];
+  char *p = tmp + sizeof(tmp);
+
+  while (val >= 100) {
+    uint32_t r = (uint32_t)(val % 100);
+    val /= 100;
+    p -= 2;
+    memcpy(p, &tDigitPairs[r * 2], 2);
+  }
+
+  if (val >= 10) {
+    p -= 2;
+    memcpy(p, &tDigitPairs[val * 2], 2);
+  } else {
+    *--p = (char)('0' + val);
+  }
+
+  int32_t len = (int32_t)(tmp + sizeof(tmp) - p);
+  memcpy(buf, p, len);
+  buf[len] = 0;
+  return len;
+}
+
+int32_t tInt64ToStr(int64_t val, char *buf) {
+  if (val < 0) {
+    buf[0] = '-';
+    return tUInt64ToStr((uint64_t)0 - (uint64_t)val, buf + 1) + 1;
+  }
+
+  return tUInt64ToStr((uint64_t)val, buf);
+}
+
+void tFmtPadDigits(uint32_t val, int32_t width, char *buf) {
+  char *p = buf + width;
+
+  while (p - buf >= 2) {
+    p -= 2;
+    memcpy(p, &tDigitPairs[(val % 100) * 2], 2);
+    val /= 100;
+  }
+
+  if (p > buf) {
+    *--p = (char)('0' + val % 10);
+  }
+}
+
+/*
+ * Grisu2 of Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers". The value and
+ * the halfway points to its neighbours are scaled by a cached power of ten with 64-bit integer arithmetic, and the
+ * digits are generated until they fall inside the scaled interval, so the text always parses back to the same value.
+ */
+typedef struct SDiyFp {
+  uint64_t f;
+  int32_t  e;
+} SDiyFp;
+
+// normalized 10^k for k = -348, -340, ..., 340
+static const uint64_t tCachedPowersF[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const int16_t tCachedPowersE[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static SDiyFp diyFpMul(SDiyFp x, SDiyFp y) {
+  const uint64_t m32 = 0xFFFFFFFFULL;
+  uint64_t       a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+  uint64_t       ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t       tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);  // round the lower half
+
+  SDiyFp r = {ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+  return r;
+}
+
+static SDiyFp diyFpNormalize(SDiyFp x) {
+  int32_t s = BUILDIN_CLZL(x.f);
+  x.f <<= s;
+  x.e -= s;
+  return x;
+}
+
+// the cached power c = 10^-K that scales the exponent e into [-60, -32]
+static SDiyFp grisuCachedPower(int32_t e, int32_t *K) {
+  double  dk = (-61 - e) * 0.30102999566398114 + 347;
+  int32_t k = (int32_t)dk;
+  if (dk - k > 0.0) k++;
+
+  int32_t index = (k >> 3) + 1;
+  *K = -(-348 + index * 8);
+
+  SDiyFp c = {tCachedPowersF[index], tCachedPowersE[index]};
+  return c;
+}
+
+static void grisuRound(char *buf, int32_t len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wpw) {
+  while (rest < wpw && delta - rest >= tenKappa && (rest + tenKappa < wpw || wpw - rest > rest + tenKappa - wpw)) {
+    buf[len - 1]--;
+    rest += tenKappa;
+  }
+}
+
+static int32_t grisuDigitGen(SDiyFp W, SDiyFp Mp, uint64_t delta, char *buf, int32_t *K) {
+  const int32_t  shift = -Mp.e;
+  const uint64_t one = 1ULL << shift;
+  const uint64_t wpw = Mp.f - W.f;
+  uint32_t       p1 = (uint32_t)(Mp.f >> shift);
+  uint64_t       p2 = Mp.f & (one - 1);
+  int32_t        kappa = 1;
+  int32_t        len = 0;
+
+  while (kappa < 10 && p1 >= tPow10[kappa]) kappa++;
+
+  while (kappa > 0) {
+    uint32_t div = (uint32_t)tPow10[kappa - 1];
+    uint32_t d = p1 / div;
+    p1 %= div;
+    if (d || len) buf[len++] = (char)('0' + d);
+    kappa--;
+
+    uint64_t rest = ((uint64_t)p1 << shift) + p2;
+    if (rest <= delta) {
+      *K += kappa;
+      grisuRound(buf, len, delta, rest, tPow10[kappa] << shift, wpw);
+      return len;
+    }
+  }
+
+  for (;;) {
+    p2 *= 10;
+    delta *= 10;
+    char d = (char)(p2 >> shift);
+    if (d || len) buf[len++] = (char)('0' + d);
+    p2 &= one - 1;
+    kappa--;
+
+    if (p2 < delta) {
+      *K += kappa;
+      int32_t index = -kappa;
+      grisuRound(buf, len, delta, p2, one, wpw * (index < 20 ? tPow10[index] : 0));
+      return len;
+    }
+  }
+}
+
+static int32_t fmtExponent(int32_t K, char *buf) {
+  char *p = buf;
+
+  if (K < 0) {
+    *p++ = '-';
+    K = -K;
+  }
+
+  if (K >= 100) {
+    *p++ = (char)('0' + K / 100);
+    K %= 100;
+    memcpy(p, &tDigitPairs[K * 2], 2);
+    p += 2;
+  } else if (K >= 10) {
+    memcpy(p, &tDigitPairs[K * 2], 2);
+    p += 2;
+  } else {
+    *p++ = (char)('0' + K);
+  }
+
+  return (int32_t)(p - buf);
+}
+
+// place the decimal point into the len digits of value digits * 10^k
+static int32_t fmtDigits(char *buf, int32_t len, int32_t k) {
+  int32_t kk = len + k;  // 10^(kk-1) <= value < 10^kk
+
+  if (k >= 0 && kk <= 21) {
+    // 1234e7 -> 12340000000.0
+    for (int32_t i = len; i < kk; ++i) buf[i] = '0';
+    buf[kk] = '.';
+    buf[kk + 1] = '0';
+    buf[kk + 2] = 0;
+    return kk + 2;
+  } else if (kk > 0 && kk <= 21) {
+    // 1234e-2 -> 12.34
+    memmove(&buf[kk + 1], &buf[kk], (size_t)(len - kk));
+    buf[kk] = '.';
+    buf[len + 1] = 0;
+    return len + 1;
+  } else if (kk > -6 && kk <= 0) {
+    // 1234e-6 -> 0.001234
+    int32_t offset = 2 - kk;
+    memmove(&buf[offset], &buf[0], (size_t)len);
+    buf[0] = '0';
+    buf[1] = '.';
+    for (int32_t i = 2; i < offset; ++i) buf[i] = '0';
+    buf[len + offset] = 0;
+    return len + offset;
+  } else if (len == 1) {
+    // 1e30
+    buf[1] = 'e';
+    int32_t n = 2 + fmtExponent(kk - 1, &buf[2]);
+    buf[n] = 0;
+    return n;
+  } else {
+    // 1234e30 -> 1.234e33
+    memmove(&buf[2], &buf[1], (size_t)(len - 1));
+    buf[1] = '.';
+    buf[len + 1] = 'e';
+    int32_t n = len + 2 + fmtExponent(kk - 1, &buf[len + 2]);
+    buf[n] = 0;
+    return n;
+  }
+}
+
+// format the positive value f * 2^e, lowerCloser when the value below is nearer than the one above
+static int32_t grisuFormat(uint64_t f, int32_t e, bool lowerCloser, char *buf) {
+  SDiyFp v = {f, e};
+  SDiyFp mp = {(f << 1) + 1, e - 1};
+  SDiyFp mm = lowerCloser ? (SDiyFp){(f << 2) - 1, e - 2} : (SDiyFp){(f << 1) - 1, e - 1};
+
+  mp = diyFpNormalize(mp);
+  mm.f <<= mm.e - mp.e;
+  mm.e = mp.e;
+
+  int32_t K = 0;
+  SDiyFp  c = grisuCachedPower(mp.e, &K);
+  SDiyFp  W = diyFpMul(diyFpNormalize(v), c);
+  SDiyFp  Wp = diyFpMul(mp, c);
+  SDiyFp  Wm = diyFpMul(mm, c);
+
+  Wm.f++;
+  Wp.f--;
+
+  int32_t len = grisuDigitGen(W, Wp, Wp.f - Wm.f, buf, &K);
+  return fmtDigits(buf, len, K);
+}
+
+static int32_t fmtSpecial(bool neg, bool zero, bool nan, char *buf) {
+  const char *s = nan ? "nan" : (zero ? (neg ? "-0.0" : "0.0") : (neg ? "-inf" : "inf"));
+  int32_t     len = (int32_t)strlen(s);
+  memcpy(buf, s, len + 1);
+  return len;
+}
+
+int32_t tDoubleToStr(double val, char *buf) {
+  uint64_t u = 0;
+  memcpy(&u, &val, sizeof(u));
+
+  bool     neg = (u >> 63) != 0;
+  int32_t  biasedE = (int32_t)((u >> 52) & 0x7FF);
+  uint64_t significand = u & ((1ULL << 52) - 1);
+
+  if (biasedE == 0x7FF || (biasedE == 0 && significand == 0)) {
+    return fmtSpecial(neg, biasedE == 0, biasedE == 0x7FF && significand != 0, buf);
+  }
+
+  int32_t n = 0;
+  if (neg) buf[n++] = '-';
+
+  if (biasedE != 0) {
+    return n + grisuFormat(significand | (1ULL << 52), biasedE - 1075, significand == 0 && biasedE > 1, buf + n);
+  } else {
+    return n + grisuFormat(significand, -1074, false, buf + n);
+  }
+}
+
+int32_t tFloatToStr(float val, char *buf) {
+  uint32_t u = 0;
+  memcpy(&u, &val, sizeof(u));
+
+  bool     neg = (u >> 31) != 0;
+  int32_t  biasedE = (int32_t)((u >> 23) & 0xFF);
+  uint32_t significand = u & ((1U << 23) - 1);
+
+  if (biasedE == 0xFF || (biasedE == 0 && significand == 0)) {
+    return fmtSpecial(neg, biasedE == 0, biasedE == 0xFF && significand != 0, buf);
+  }
+
+  int32_t n = 0;
+  if (neg) buf[n++] = '-';
+
+  if (biasedE != 0) {
+    return n + grisuFormat(significand | (1U << 23), biasedE - 150, significand == 0 && biasedE > 1, buf + n);
+  } else {
+    return n + grisuFormat(significand, -149, false, buf + n);
+  }
+}
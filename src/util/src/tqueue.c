@@ -24,24 +24,28 @@ typedef struct STaosQnode {
   char                item[];
 } STaosQnode;
 
+// Each queue is an intrusive multi-producer/single-consumer list: writers only swap the tail
+// and link the previous node, the reader owns the head. A stub node keeps the list non-empty,
+// so writers and the reader never touch the same pointer unless the queue is nearly empty.
 typedef struct STaosQueue {
   int32_t             itemSize;
   int32_t             numOfItems;
-  struct STaosQnode  *head;
-  struct STaosQnode  *tail;
+  struct STaosQnode  *head;    // reader side
+  struct STaosQnode  *tail;    // writer side
+  struct STaosQnode  *stub;
   struct STaosQueue  *next;    // for queue set
   struct STaosQset   *qset;    // for queue set
   void               *ahandle; // for queue set
-  pthread_mutex_t     mutex;  
 } STaosQueue;
 
 typedef struct STaosQset {
   STaosQueue        *head;
   STaosQueue        *current;
   pthread_mutex_t    mutex;
+  pthread_cond_t     cond;
   int32_t            numOfQueues;
-  int32_t            numOfItems;
-  tsem_t             sem;
+  int32_t            numOfWaiters;  // readers blocked on cond, writers only signal if it is not zero
+  int32_t            numOfResumes;
 } STaosQset;
 
 typedef struct STaosQall {
@@ -50,7 +54,63 @@ typedef struct STaosQall {
   int32_t       itemSize;
   int32_t       numOfItems;
 } STaosQall; 
-  
+
+static void taosPushQnodes(STaosQueue *queue, STaosQnode *first, STaosQnode *last) {
+  last->next = NULL;
+  STaosQnode *prev = atomic_exchange_ptr(&queue->tail, last);
+  atomic_store_ptr(&prev->next, first);
+}
+
+// only one reader at a time, it returns NULL if the queue is empty or a writer has not
+// linked its node yet
+static STaosQnode *taosPopQnode(STaosQueue *queue) {
+  STaosQnode *head = queue->head;
+  STaosQnode *next = atomic_load_ptr(&head->next);
+
+  if (head == queue->stub) {
+    if (next == NULL) return NULL;
+    queue->head = next;
+    head = next;
+    next = atomic_load_ptr(&next->next);
+  }
+
+  if (next == NULL) {
+    if (head != atomic_load_ptr(&queue->tail)) return NULL;
+
+    // the last node can only be taken out after the stub is queued behind it
+    taosPushQnodes(queue, queue->stub, queue->stub);
+    next = atomic_load_ptr(&head->next);
+    if (next == NULL) return NULL;
+  }
+
+  queue->head = next;
+  head->next = NULL;
+
+  atomic_sub_fetch_32(&queue->numOfItems, 1);
+
+  return head;
+}
+
+static void taosWriteQnodes(STaosQueue *queue, STaosQnode *first, STaosQnode *last, int32_t num) {
+  STaosQset *qset = atomic_load_ptr(&queue->qset);
+
+  // the counter is increased before the nodes are linked, a reader may see more items than it
+  // can pop, but never less, so it will not sleep while there are items
+  atomic_add_fetch_32(&queue->numOfItems, num);
+
+  taosPushQnodes(queue, first, last);
+
+  if (qset && atomic_load_32(&qset->numOfWaiters) > 0) {
+    pthread_mutex_lock(&qset->mutex);
+    if (num > 1) {
+      pthread_cond_broadcast(&qset->cond);
+    } else {
+      pthread_cond_signal(&qset->cond);
+    }
+    pthread_mutex_unlock(&qset->mutex);
+  }
+}
+
 taos_queue taosOpenQueue() {
   
   STaosQueue *queue = (STaosQueue *) calloc(sizeof(STaosQueue), 1);
@@ -59,7 +119,15 @@ taos_queue taosOpenQueue() {
     return NULL;
   }
 
-  pthread_mutex_init(&queue->mutex, NULL);
+  queue->stub = (STaosQnode *) calloc(sizeof(STaosQnode), 1);
+  if (queue->stub == NULL) {
+    free(queue);
+    terrno = TSDB_CODE_COM_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  queue->head = queue->stub;
+  queue->tail = queue->stub;
 
   uTrace("queue:%p is opened", queue);
   return queue;
@@ -71,22 +139,20 @@ void taosCloseQueue(taos_queue param) {
   STaosQnode *pTemp;
   STaosQset  *qset;
 
-  pthread_mutex_lock(&queue->mutex);
   STaosQnode *pNode = queue->head;  
   queue->head = NULL;
   qset = queue->qset;
-  pthread_mutex_unlock(&queue->mutex);
 
-  if (queue->qset) taosRemoveFromQset(qset, queue); 
+  if (qset) taosRemoveFromQset(qset, queue); 
 
   while (pNode) {
     pTemp = pNode;
     pNode = pNode->next;
-    free (pTemp);
+    if (pTemp != queue->stub) free(pTemp);
   }
 
-  pthread_mutex_destroy(&queue->mutex);
   uTrace("queue:%p is closed", queue);
+  free(queue->stub);
   free(queue);
 }
 
@@ -111,52 +177,45 @@ int taosWriteQitem(taos_queue param, int type, void *item) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQnode *pNode = (STaosQnode *)(((char *)item) - sizeof(STaosQnode));
   pNode->type = type;
-  pNode->next = NULL;
 
-  pthread_mutex_lock(&queue->mutex);
+  taosWriteQnodes(queue, pNode, pNode, 1);
+  uTrace("item:%p is put into queue:%p, type:%d", item, queue, type);
 
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode; 
-  }
+  return 0;
+}
 
-  queue->numOfItems++;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, type:%d items:%d", item, queue, type, queue->numOfItems);
+int taosWriteQitems(taos_queue param, int type, void **pitems, int num) {
+  STaosQueue *queue = (STaosQueue *)param;
+  if (num <= 0) return 0;
 
-  pthread_mutex_unlock(&queue->mutex);
+  STaosQnode *first = (STaosQnode *)(((char *)pitems[0]) - sizeof(STaosQnode));
+  STaosQnode *last = first;
+  first->type = type;
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  for (int i = 1; i < num; ++i) {
+    STaosQnode *pNode = (STaosQnode *)(((char *)pitems[i]) - sizeof(STaosQnode));
+    pNode->type = type;
+    last->next = pNode;
+    last = pNode;
+  }
+
+  taosWriteQnodes(queue, first, last, num);
+  uTrace("%d items are put into queue:%p, type:%d", num, queue, type);
 
   return 0;
 }
 
 int taosReadQitem(taos_queue param, int *type, void **pitem) {
   STaosQueue *queue = (STaosQueue *)param;
-  STaosQnode *pNode = NULL;
-  int         code = 0;
-
-  pthread_mutex_lock(&queue->mutex);
 
-  if (queue->head) {
-      pNode = queue->head;
-      *pitem = pNode->item;
-      *type = pNode->type;
-      queue->head = pNode->next;
-      if (queue->head == NULL) 
-        queue->tail = NULL;
-      queue->numOfItems--;
-      if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
-      code = 1;
-      uDebug("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, *type, queue->numOfItems);
-  } 
+  STaosQnode *pNode = taosPopQnode(queue);
+  if (pNode == NULL) return 0;
 
-  pthread_mutex_unlock(&queue->mutex);
+  *pitem = pNode->item;
+  *type = pNode->type;
+  uDebug("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, *type, queue->numOfItems);
 
-  return code;
+  return 1;
 }
 
 void *taosAllocateQall() {
@@ -168,38 +227,40 @@ void taosFreeQall(void *param) {
   free(param);
 }
 
+// move the items which are ready into qall, queue shall have only one reader
+static int taosPopAllQnodes(STaosQueue *queue, STaosQall *qall, STaosQnode *pNode) {
+  STaosQnode *last = pNode;
+
+  memset(qall, 0, sizeof(STaosQall));
+  qall->start = pNode;
+  qall->current = pNode;
+  qall->numOfItems = 1;
+  qall->itemSize = queue->itemSize;
+
+  while ((pNode = taosPopQnode(queue)) != NULL) {
+    last->next = pNode;
+    last = pNode;
+    qall->numOfItems++;
+  }
+
+  return qall->numOfItems;
+}
+
 int taosReadAllQitems(taos_queue param, taos_qall p2) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQall  *qall = (STaosQall *)p2;
-  int         code = 0;
-  bool        empty;
-
-  pthread_mutex_lock(&queue->mutex);
-
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    qall->itemSize = queue->itemSize;
-    code = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
-  }
 
-  pthread_mutex_unlock(&queue->mutex);
+  STaosQnode *pNode = taosPopQnode(queue);
 
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
+  if (pNode == NULL) {
     qall->current = NULL;
     qall->start = NULL;
     qall->numOfItems = 0;
+    return 0;
   }
-  return code;
+
+  return taosPopAllQnodes(queue, qall, pNode);
 }
 
 int taosGetQitem(taos_qall param, int *type, void **pitem) {
@@ -235,7 +296,7 @@ taos_qset taosOpenQset() {
   }
 
   pthread_mutex_init(&qset->mutex, NULL);
-  tsem_init(&qset->sem, 0, 0);
+  pthread_cond_init(&qset->cond, NULL);
 
   uTrace("qset:%p is opened", qset);
   return qset;
@@ -257,18 +318,21 @@ void taosCloseQset(taos_qset param) {
   pthread_mutex_unlock(&qset->mutex);
 
   pthread_mutex_destroy(&qset->mutex);
+  pthread_cond_destroy(&qset->cond);
   uTrace("qset:%p is closed", qset);
-  tsem_destroy(&qset->sem);
   free(qset);
 }
 
-// tsem_post 'qset->sem', so that reader threads waiting for it
-// resumes execution and return, should only be used to signal the
-// thread to exit.
+// wake up one reader thread waiting on 'qset->cond', so that it resumes
+// execution and returns, should only be used to signal the thread to exit.
 void taosQsetThreadResume(taos_qset param) {
   STaosQset *qset = (STaosQset *)param;
   uDebug("qset:%p, it will exit", qset);
-  tsem_post(&qset->sem);
+
+  pthread_mutex_lock(&qset->mutex);
+  qset->numOfResumes++;
+  pthread_cond_signal(&qset->cond);
+  pthread_mutex_unlock(&qset->mutex);
 }
 
 int taosAddIntoQset(taos_qset p1, taos_queue p2, void *ahandle) {
@@ -284,10 +348,8 @@ int taosAddIntoQset(taos_qset p1, taos_queue p2, void *ahandle) {
   qset->head = queue;
   qset->numOfQueues++;
 
-  pthread_mutex_lock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
-  pthread_mutex_unlock(&queue->mutex);
+  atomic_store_ptr(&queue->qset, qset);
+  if (atomic_load_32(&queue->numOfItems) > 0) pthread_cond_broadcast(&qset->cond);
 
   pthread_mutex_unlock(&qset->mutex);
 
@@ -326,11 +388,8 @@ void taosRemoveFromQset(taos_qset p1, taos_queue p2) {
       if (qset->current == queue) qset->current = tqueue->next;
       qset->numOfQueues--;
 
-      pthread_mutex_lock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      atomic_store_ptr(&queue->qset, NULL);
       queue->next = NULL;
-      pthread_mutex_unlock(&queue->mutex);
     }
   } 
   
@@ -343,43 +402,80 @@ int taosGetQueueNumber(taos_qset param) {
   return ((STaosQset *)param)->numOfQueues;
 }
 
-int taosReadQitemFromQset(taos_qset param, int *type, void **pitem, void **phandle) {
-  STaosQset  *qset = (STaosQset *)param;
-  STaosQnode *pNode = NULL;
-  int         code = 0;
-   
-  tsem_wait(&qset->sem);
-
-  pthread_mutex_lock(&qset->mutex);
-
+// round robin the queues and pop an item from the first one which has items,
+// qset->mutex shall be locked, so that each queue has only one reader
+static STaosQueue *taosPopQnodeFromQset(STaosQset *qset, STaosQnode **ppNode) {
   for(int i=0; i<qset->numOfQueues; ++i) {
     if (qset->current == NULL) 
       qset->current = qset->head;   
     STaosQueue *queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
-
-    pthread_mutex_lock(&queue->mutex);
-
-    if (queue->head) {
-        pNode = queue->head;
-        *pitem = pNode->item;
-        if (type) *type = pNode->type;
-        if (phandle) *phandle = queue->ahandle;
-        queue->head = pNode->next;
-        if (queue->head == NULL) 
-          queue->tail = NULL;
-        queue->numOfItems--;
-        atomic_sub_fetch_32(&qset->numOfItems, 1);
-        code = 1;
-        uTrace("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, pNode->type, queue->numOfItems);
-    } 
-
-    pthread_mutex_unlock(&queue->mutex);
-    if (pNode) break;
+    if (atomic_load_32(&queue->numOfItems) <= 0) continue;
+
+    STaosQnode *pNode = taosPopQnode(queue);
+    if (pNode) {
+      *ppNode = pNode;
+      return queue;
+    }
+  }
+
+  return NULL;
+}
+
+// block until an item may be ready, qset->mutex shall be locked. It returns false if
+// the thread is resumed by taosQsetThreadResume
+static bool taosWaitQset(STaosQset *qset) {
+  if (qset->numOfResumes > 0) {
+    qset->numOfResumes--;
+    return false;
   }
 
+  // a writer increases the counters before it checks numOfWaiters, and the reader
+  // registers itself before it checks the counters, so one of them sees the other
+  atomic_add_fetch_32(&qset->numOfWaiters, 1);
+
+  bool ready = false;
+  for (STaosQueue *queue = qset->head; queue; queue = queue->next) {
+    if (atomic_load_32(&queue->numOfItems) > 0) {
+      ready = true;
+      break;
+    }
+  }
+
+  if (ready) {
+    // an item is counted but not linked yet, it will be there in a moment
+    pthread_mutex_unlock(&qset->mutex);
+    sched_yield();
+    pthread_mutex_lock(&qset->mutex);
+  } else {
+    pthread_cond_wait(&qset->cond, &qset->mutex);
+  }
+
+  atomic_sub_fetch_32(&qset->numOfWaiters, 1);
+  return true;
+}
+
+int taosReadQitemFromQset(taos_qset param, int *type, void **pitem, void **phandle) {
+  STaosQset  *qset = (STaosQset *)param;
+  STaosQnode *pNode = NULL;
+  STaosQueue *queue = NULL;
+  int         code = 0;
+
+  pthread_mutex_lock(&qset->mutex);
+
+  do {
+    queue = taosPopQnodeFromQset(qset, &pNode);
+    if (queue) {
+      *pitem = pNode->item;
+      if (type) *type = pNode->type;
+      if (phandle) *phandle = queue->ahandle;
+      code = 1;
+      uTrace("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, pNode->type, queue->numOfItems);
+      break;
+    }
+  } while (taosWaitQset(qset));
+
   pthread_mutex_unlock(&qset->mutex);
 
   return code; 
@@ -387,42 +483,21 @@ int taosReadQitemFromQset(taos_qset param, int *type, void **pitem, void **phand
 
 int taosReadAllQitemsFromQset(taos_qset param, taos_qall p2, void **phandle) {
   STaosQset  *qset = (STaosQset *)param;
-  STaosQueue *queue;
+  STaosQnode *pNode = NULL;
+  STaosQueue *queue = NULL;
   STaosQall  *qall = (STaosQall *)p2;
   int         code = 0;
 
-  tsem_wait(&qset->sem);
   pthread_mutex_lock(&qset->mutex);
 
-  for(int i=0; i<qset->numOfQueues; ++i) {
-    if (qset->current == NULL) 
-      qset->current = qset->head;   
-    queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
-
-    pthread_mutex_lock(&queue->mutex);
-
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      qall->itemSize = queue->itemSize;
-      code = qall->numOfItems;
+  do {
+    queue = taosPopQnodeFromQset(qset, &pNode);
+    if (queue) {
+      code = taosPopAllQnodes(queue, qall, pNode);
       *phandle = queue->ahandle;
-          
-      queue->head = NULL;
-      queue->tail = NULL;
-      queue->numOfItems = 0;
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int j=1; j<qall->numOfItems; ++j) tsem_wait(&qset->sem);
-    } 
-
-    pthread_mutex_unlock(&queue->mutex);
-
-    if (code != 0) break;  
-  }
+      break;
+    }
+  } while (taosWaitQset(qset));
 
   pthread_mutex_unlock(&qset->mutex);
   return code;
@@ -432,20 +507,22 @@ int taosGetQueueItemsNumber(taos_queue param) {
   STaosQueue *queue = (STaosQueue *)param;
   if (!queue) return 0;
 
-  int num;
-  pthread_mutex_lock(&queue->mutex);
-  num = queue->numOfItems;
-  pthread_mutex_unlock(&queue->mutex);
-  return num;
+  return atomic_load_32(&queue->numOfItems);
 }
 
+// a writer may still hold the qset of a queue being removed, so the items are not counted in
+// the qset by writers, but summed up over the queues which are in the qset right now
 int taosGetQsetItemsNumber(taos_qset param) {
   STaosQset *qset = (STaosQset *)param;
   if (!qset) return 0;
 
-  int num = 0;
+  int32_t numOfItems = 0;
+
   pthread_mutex_lock(&qset->mutex);
-  num = qset->numOfItems;
+  for (STaosQueue *queue = qset->head; queue; queue = queue->next) {
+    numOfItems += atomic_load_32(&queue->numOfItems);
+  }
   pthread_mutex_unlock(&qset->mutex);
-  return num;
+
+  return numOfItems;
 }
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "troaring.h"
+
+#define ROARING_BITSET_WORDS 1024  // 65536 bits
+#define ROARING_BITSET_SIZE  (ROARING_BITSET_WORDS * sizeof(uint64_t))
+
+#define ROARING_HIGH(v) ((uint16_t)((v) >> 16))
+#define ROARING_LOW(v)  ((uint16_t)((v)&0xFFFF))
+
+#define BITSET_GET(b, v)   (((b)[(v) >> 6] >> ((v)&63)) & 1)
+#define BITSET_SET(b, v)   ((b)[(v) >> 6] |= (1ULL << ((v)&63)))
+#define BITSET_CLEAR(b, v) ((b)[(v) >> 6] &= ~(1ULL << ((v)&63)))
+
+static void rContainerFree(SRoaringContainer *pCont) {
+  tfree(pCont->array);
+  tfree(pCont->bitset);
+}
+
+static int32_t rBitsetCard(const uint64_t *bitset) {
+  int32_t card = 0;
+  for (int32_t i = 0; i < ROARING_BITSET_WORDS; ++i) {
+    card += BUILDIN_POPCOUNTL(bitset[i]);
+  }
+  return card;
+}
+
+// the first position in the array whose value is not less than v
+static int32_t rArrayLowerBound(const uint16_t *array, int32_t num, uint16_t v) {
+  int32_t low = 0, high = num;
+  while (low < high) {
+    int32_t mid = (low + high) >> 1;
+    if (array[mid] < v) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+static int32_t rArrayToBitset(SRoaringContainer *pCont) {
+  uint64_t *bitset = calloc(1, ROARING_BITSET_SIZE);
+  if (bitset == NULL) return -1;
+
+  for (int32_t i = 0; i < pCont->card; ++i) {
+    BITSET_SET(bitset, pCont->array[i]);
+  }
+
+  tfree(pCont->array);
+  pCont->capacity = 0;
+  pCont->bitset = bitset;
+  pCont->isBitset = true;
+  return 0;
+}
+
+static int32_t rBitsetToArray(SRoaringContainer *pCont) {
+  uint16_t *array = malloc(sizeof(uint16_t) * MAX(pCont->card, 1));
+  if (array == NULL) return -1;
+
+  int32_t n = 0;
+  for (int32_t i = 0; i < ROARING_BITSET_WORDS; ++i) {
+    uint64_t w = pCont->bitset[i];
+    while (w != 0) {
+      uint64_t t = w & (~w + 1);
+      array[n++] = (uint16_t)(i * 64 + BUILDIN_POPCOUNTL(t - 1));
+      w ^= t;
+    }
+  }
+
+  tfree(pCont->bitset);
+  pCont->array = array;
+  pCont->capacity = MAX(pCont->card, 1);
+  pCont->isBitset = false;
+  return 0;
+}
+
+// keep small containers as arrays and large ones as bitsets
+static int32_t rContainerNormalize(SRoaringContainer *pCont) {
+  if (pCont->isBitset && pCont->card <= ROARING_ARRAY_MAX_CARD) return rBitsetToArray(pCont);
+  if (!pCont->isBitset && pCont->card > ROARING_ARRAY_MAX_CARD) return rArrayToBitset(pCont);
+  return 0;
+}
+
+// index of the container with the key, or -(insert position + 1) if there is none
+static int32_t rFindContainer(const SRoaringBitmap *pBitmap, uint16_t key) {
+  int32_t low = 0, high = pBitmap->size - 1;
+  while (low <= high) {
+    int32_t  mid = (low + high) >> 1;
+    uint16_t k = pBitmap->containers[mid].key;
+    if (k == key) return mid;
+    if (k < key) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return -(low + 1);
+}
+
+static SRoaringContainer *rInsertContainer(SRoaringBitmap *pBitmap, int32_t idx, uint16_t key) {
+  if (pBitmap->size >= pBitmap->capacity) {
+    int32_t            capacity = MAX(pBitmap->capacity * 2, 4);
+    SRoaringContainer *containers = realloc(pBitmap->containers, sizeof(SRoaringContainer) * capacity);
+    if (containers == NULL) return NULL;
+    pBitmap->containers = containers;
+    pBitmap->capacity = capacity;
+  }
+
+  memmove(pBitmap->containers + idx + 1, pBitmap->containers + idx, sizeof(SRoaringContainer) * (pBitmap->size - idx));
+  pBitmap->size++;
+
+  SRoaringContainer *pCont = pBitmap->containers + idx;
+  memset(pCont, 0, sizeof(*pCont));
+  pCont->key = key;
+  return pCont;
+}
+
+// append a container of the result of a set operation, which is built in ascending key order
+static int32_t rAppendContainer(SRoaringBitmap *pBitmap, SRoaringContainer *pCont) {
+  if (pCont->card == 0) {
+    rContainerFree(pCont);
+    return 0;
+  }
+
+  if (rContainerNormalize(pCont) < 0 || rInsertContainer(pBitmap, pBitmap->size, pCont->key) == NULL) {
+    rContainerFree(pCont);
+    return -1;
+  }
+
+  pBitmap->containers[pBitmap->size - 1] = *pCont;
+  return 0;
+}
+
+static int32_t rContainerCopy(SRoaringContainer *pDst, const SRoaringContainer *pSrc) {
+  memset(pDst, 0, sizeof(*pDst));
+  pDst->key = pSrc->key;
+  pDst->isBitset = pSrc->isBitset;
+  pDst->card = pSrc->card;
+  if (pSrc->isBitset) {
+    pDst->bitset = malloc(ROARING_BITSET_SIZE);
+    if (pDst->bitset == NULL) return -1;
+    memcpy(pDst->bitset, pSrc->bitset, ROARING_BITSET_SIZE);
+  } else {
+    pDst->capacity = MAX(pSrc->card, 1);
+    pDst->array = malloc(sizeof(uint16_t) * pDst->capacity);
+    if (pDst->array == NULL) return -1;
+    memcpy(pDst->array, pSrc->array, sizeof(uint16_t) * pSrc->card);
+  }
+  return 0;
+}
+
+SRoaringBitmap *tRoaringCreate() { return calloc(1, sizeof(SRoaringBitmap)); }
+
+void tRoaringDestroy(SRoaringBitmap *pBitmap) {
+  if (pBitmap == NULL) return;
+
+  for (int32_t i = 0; i < pBitmap->size; ++i) {
+    rContainerFree(pBitmap->containers + i);
+  }
+  tfree(pBitmap->containers);
+  free(pBitmap);
+}
+
+SRoaringBitmap *tRoaringDup(const SRoaringBitmap *pBitmap) {
+  SRoaringBitmap *pNew = tRoaringCreate();
+  if (pNew == NULL) return NULL;
+
+  for (int32_t i = 0; i < pBitmap->size; ++i) {
+    SRoaringContainer cont;
+    if (rContainerCopy(&cont, pBitmap->containers + i) < 0 || rAppendContainer(pNew, &cont) < 0) {
+      tRoaringDestroy(pNew);
+      return NULL;
+    }
+  }
+
+  return pNew;
+}
+
+int32_t tRoaringAdd(SRoaringBitmap *pBitmap, uint32_t val) {
+  uint16_t key = ROARING_HIGH(val), low = ROARING_LOW(val);
+  int32_t  idx = rFindContainer(pBitmap, key);
+
+  SRoaringContainer *pCont = NULL;
+  if (idx >= 0) {
+    pCont = pBitmap->containers + idx;
+  } else {
+    pCont = rInsertContainer(pBitmap, -idx - 1, key);
+    if (pCont == NULL) return -1;
+  }
+
+  if (pCont->isBitset) {
+    if (!BITSET_GET(pCont->bitset, low)) {
+      BITSET_SET(pCont->bitset, low);
+      pCont->card++;
+    }
+    return 0;
+  }
+
+  int32_t pos = rArrayLowerBound(pCont->array, pCont->card, low);
+  if (pos < pCont->card && pCont->array[pos] == low) return 0;
+
+  if (pCont->card >= ROARING_ARRAY_MAX_CARD) {
+    if (rArrayToBitset(pCont) < 0) return -1;
+    BITSET_SET(pCont->bitset, low);
+    pCont->card++;
+    return 0;
+  }
+
+  if (pCont->card >= pCont->capacity) {
+    int32_t   capacity = MAX(pCont->capacity * 2, 4);
+    if (capacity > ROARING_ARRAY_MAX_CARD) capacity = ROARING_ARRAY_MAX_CARD;
+    uint16_t *array = realloc(pCont->array, sizeof(uint16_t) * capacity);
+    if (array == NULL) return -1;
+    pCont->array = array;
+    pCont->capacity = capacity;
+  }
+
+  memmove(pCont->array + pos + 1, pCont->array + pos, sizeof(uint16_t) * (pCont->card - pos));
+  pCont->array[pos] = low;
+  pCont->card++;
+  return 0;
+}
+
+void tRoaringRemove(SRoaringBitmap *pBitmap, uint32_t val) {
+  uint16_t low = ROARING_LOW(val);
+  int32_t  idx = rFindContainer(pBitmap, ROARING_HIGH(val));
+  if (idx < 0) return;
+
+  SRoaringContainer *pCont = pBitmap->containers + idx;
+  if (pCont->isBitset) {
+    if (!BITSET_GET(pCont->bitset, low)) return;
+    BITSET_CLEAR(pCont->bitset, low);
+    pCont->card--;
+    // shrinking is best effort, a bitset container is still valid if it fails
+    rContainerNormalize(pCont);
+  } else {
+    int32_t pos = rArrayLowerBound(pCont->array, pCont->card, low);
+    if (pos >= pCont->card || pCont->array[pos] != low) return;
+    memmove(pCont->array + pos, pCont->array + pos + 1, sizeof(uint16_t) * (pCont->card - pos - 1));
+    pCont->card--;
+  }
+
+  if (pCont->card == 0) {
+    rContainerFree(pCont);
+    memmove(pCont, pCont + 1, sizeof(SRoaringContainer) * (pBitmap->size - idx - 1));
+    pBitmap->size--;
+  }
+}
+
+bool tRoaringContains(const SRoaringBitmap *pBitmap, uint32_t val) {
+  uint16_t low = ROARING_LOW(val);
+  int32_t  idx = rFindContainer(pBitmap, ROARING_HIGH(val));
+  if (idx < 0) return false;
+
+  const SRoaringContainer *pCont = pBitmap->containers + idx;
+  if (pCont->isBitset) return BITSET_GET(pCont->bitset, low);
+
+  int32_t pos = rArrayLowerBound(pCont->array, pCont->card, low);
+  return pos < pCont->card && pCont->array[pos] == low;
+}
+
+int64_t tRoaringCardinality(const SRoaringBitmap *pBitmap) {
+  int64_t card = 0;
+  for (int32_t i = 0; i < pBitmap->size; ++i) {
+    card += pBitmap->containers[i].card;
+  }
+  return card;
+}
+
+static bool rContainerContains(const SRoaringContainer *pCont, uint16_t low) {
+  if (pCont->isBitset) return BITSET_GET(pCont->bitset, low);
+
+  int32_t pos = rArrayLowerBound(pCont->array, pCont->card, low);
+  return pos < pCont->card && pCont->array[pos] == low;
+}
+
+static int32_t rContainerAnd(const SRoaringContainer *c1, const SRoaringContainer *c2, SRoaringContainer *pRes) {
+  memset(pRes, 0, sizeof(*pRes));
+  pRes->key = c1->key;
+
+  if (c1->isBitset && c2->isBitset) {
+    pRes->bitset = malloc(ROARING_BITSET_SIZE);
+    if (pRes->bitset == NULL) return -1;
+    pRes->isBitset = true;
+    for (int32_t i = 0; i < ROARING_BITSET_WORDS; ++i) {
+      pRes->bitset[i] = c1->bitset[i] & c2->bitset[i];
+    }
+    pRes->card = rBitsetCard(pRes->bitset);
+    return 0;
+  }
+
+  if (c1->isBitset) {
+    const SRoaringContainer *t = c1;
+    c1 = c2;
+    c2 = t;
+  }
+
+  pRes->capacity = MAX(c1->card, 1);
+  pRes->array = malloc(sizeof(uint16_t) * pRes->capacity);
+  if (pRes->array == NULL) return -1;
+
+  if (c2->isBitset) {
+    for (int32_t i = 0; i < c1->card; ++i) {
+      if (BITSET_GET(c2->bitset, c1->array[i])) pRes->array[pRes->card++] = c1->array[i];
+    }
+  } else {
+    int32_t i = 0, j = 0;
+    while (i < c1->card && j < c2->card) {
+      if (c1->array[i] < c2->array[j]) {
+        i++;
+      } else if (c1->array[i] > c2->array[j]) {
+        j++;
+      } else {
+        pRes->array[pRes->card++] = c1->array[i];
+        i++;
+        j++;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int32_t rContainerOr(const SRoaringContainer *c1, const SRoaringContainer *c2, SRoaringContainer *pRes) {
+  memset(pRes, 0, sizeof(*pRes));
+  pRes->key = c1->key;
+
+  if (!c1->isBitset && !c2->isBitset && c1->card + c2->card <= ROARING_ARRAY_MAX_CARD) {
+    pRes->capacity = MAX(c1->card + c2->card, 1);
+    pRes->array = malloc(sizeof(uint16_t) * pRes->capacity);
+    if (pRes->array == NULL) return -1;
+
+    int32_t i = 0, j = 0;
+    while (i < c1->card || j < c2->card) {
+      if (j >= c2->card || (i < c1->card && c1->array[i] < c2->array[j])) {
+        pRes->array[pRes->card++] = c1->array[i++];
+      } else if (i >= c1->card || c1->array[i] > c2->array[j]) {
+        pRes->array[pRes->card++] = c2->array[j++];
+      } else {
+        pRes->array[pRes->card++] = c1->array[i];
+        i++;
+        j++;
+      }
+    }
+    return 0;
+  }
+
+  pRes->bitset = calloc(1, ROARING_BITSET_SIZE);
+  if (pRes->bitset == NULL) return -1;
+  pRes->isBitset = true;
+
+  const SRoaringContainer *conts[2] = {c1, c2};
+  for (int32_t c = 0; c < 2; ++c) {
+    if (conts[c]->isBitset) {
+      for (int32_t i = 0; i < ROARING_BITSET_WORDS; ++i) {
+        pRes->bitset[i] |= conts[c]->bitset[i];
+      }
+    } else {
+      for (int32_t i = 0; i < conts[c]->card; ++i) {
+        BITSET_SET(pRes->bitset, conts[c]->array[i]);
+      }
+    }
+  }
+  pRes->card = rBitsetCard(pRes->bitset);
+  return 0;
+}
+
+static int32_t rContainerAndNot(const SRoaringContainer *c1, const SRoaringContainer *c2, SRoaringContainer *pRes) {
+  memset(pRes, 0, sizeof(*pRes));
+  pRes->key = c1->key;
+
+  if (!c1->isBitset) {
+    pRes->capacity = MAX(c1->card, 1);
+    pRes->array = malloc(sizeof(uint16_t) * pRes->capacity);
+    if (pRes->array == NULL) return -1;
+    for (int32_t i = 0; i < c1->card; ++i) {
+      if (!rContainerContains(c2, c1->array[i])) pRes->array[pRes->card++] = c1->array[i];
+    }
+    return 0;
+  }
+
+  pRes->bitset = malloc(ROARING_BITSET_SIZE);
+  if (pRes->bitset == NULL) return -1;
+  pRes->isBitset = true;
+  memcpy(pRes->bitset, c1->bitset, ROARING_BITSET_SIZE);
+
+  if (c2->isBitset) {
+    for (int32_t i = 0; i < ROARING_BITSET_WORDS; ++i) {
+      pRes->bitset[i] &= ~c2->bitset[i];
+    }
+  } else {
+    for (int32_t i = 0; i < c2->card; ++i) {
+      BITSET_CLEAR(pRes->bitset, c2->array[i]);
+    }
+  }
+  pRes->card = rBitsetCard(pRes->bitset);
+  return 0;
+}
+
+SRoaringBitmap *tRoaringAnd(const SRoaringBitmap *left, const SRoaringBitmap *right) {
+  SRoaringBitmap *pRes = tRoaringCreate();
+  if (pRes == NULL) return NULL;
+
+  int32_t i = 0, j = 0;
+  while (i < left->size && j < right->size) {
+    const SRoaringContainer *c1 = left->containers + i;
+    const SRoaringContainer *c2 = right->containers + j;
+    if (c1->key < c2->key) {
+      i++;
+    } else if (c1->key > c2->key) {
+      j++;
+    } else {
+      SRoaringContainer cont;
+      if (rContainerAnd(c1, c2, &cont) < 0 || rAppendContainer(pRes, &cont) < 0) goto _err;
+      i++;
+      j++;
+    }
+  }
+
+  return pRes;
+
+_err:
+  tRoaringDestroy(pRes);
+  return NULL;
+}
+
+SRoaringBitmap *tRoaringOr(const SRoaringBitmap *left, const SRoaringBitmap *right) {
+  SRoaringBitmap *pRes = tRoaringCreate();
+  if (pRes == NULL) return NULL;
+
+  int32_t i = 0, j = 0;
+  while (i < left->size || j < right->size) {
+    const SRoaringContainer *c1 = (i < left->size) ? left->containers + i : NULL;
+    const SRoaringContainer *c2 = (j < right->size) ? right->containers + j : NULL;
+
+    SRoaringContainer cont;
+    int32_t           code = 0;
+    if (c2 == NULL || (c1 != NULL && c1->key < c2->key)) {
+      code = rContainerCopy(&cont, c1);
+      i++;
+    } else if (c1 == NULL || c1->key > c2->key) {
+      code = rContainerCopy(&cont, c2);
+      j++;
+    } else {
+      code = rContainerOr(c1, c2, &cont);
+      i++;
+      j++;
+    }
+
+    if (code < 0) {
+      rContainerFree(&cont);
+      goto _err;
+    }
+    if (rAppendContainer(pRes, &cont) < 0) goto _err;
+  }
+
+  return pRes;
+
+_err:
+  tRoaringDestroy(pRes);
+  return NULL;
+}
+
+SRoaringBitmap *tRoaringAndNot(const SRoaringBitmap *left, const SRoaringBitmap *right) {
+  SRoaringBitmap *pRes = tRoaringCreate();
+  if (pRes == NULL) return NULL;
+
+  int32_t j = 0;
+  for (int32_t i = 0; i < left->size; ++i) {
+    const SRoaringContainer *c1 = left->containers + i;
+    while (j < right->size && right->containers[j].key < c1->key) j++;
+
+    SRoaringContainer cont;
+    int32_t           code = 0;
+    if (j < right->size && right->containers[j].key == c1->key) {
+      code = rContainerAndNot(c1, right->containers + j, &cont);
+    } else {
+      code = rContainerCopy(&cont, c1);
+    }
+
+    if (code < 0) {
+      rContainerFree(&cont);
+      goto _err;
+    }
+    if (rAppendContainer(pRes, &cont) < 0) goto _err;
+  }
+
+  return pRes;
+
+_err:
+  tRoaringDestroy(pRes);
+  return NULL;
+}
+
+void tRoaringIterInit(SRoaringIter *pIter, const SRoaringBitmap *pBitmap) {
+  pIter->pBitmap = pBitmap;
+  pIter->cidx = 0;
+  pIter->pos = 0;
+}
+
+bool tRoaringIterNext(SRoaringIter *pIter, uint32_t *val) {
+  const SRoaringBitmap *pBitmap = pIter->pBitmap;
+
+  while (pIter->cidx < pBitmap->size) {
+    const SRoaringContainer *pCont = pBitmap->containers + pIter->cidx;
+    uint32_t                 high = ((uint32_t)pCont->key) << 16;
+
+    if (!pCont->isBitset) {
+      if (pIter->pos < pCont->card) {
+        *val = high | pCont->array[pIter->pos++];
+        return true;
+      }
+    } else {
+      // pos is the next bit to check
+      while (pIter->pos < (ROARING_BITSET_WORDS << 6)) {
+        uint64_t w = pCont->bitset[pIter->pos >> 6] >> (pIter->pos & 63);
+        if (w == 0) {
+          pIter->pos = ((pIter->pos >> 6) + 1) << 6;
+          continue;
+        }
+
+        pIter->pos += BUILDIN_POPCOUNTL((w & (~w + 1)) - 1);
+        *val = high | (uint32_t)(pIter->pos++);
+        return true;
+      }
+    }
+
+    pIter->cidx++;
+    pIter->pos = 0;
+  }
+
+  return false;
+}
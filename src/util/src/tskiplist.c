@@ -28,16 +28,37 @@ static SSkipListIterator *doCreateSkipListIterator(SSkipList *pSkipList, int32_t
 static void tSkipListDoInsert(SSkipList *pSkipList, SSkipListNode **direction, SSkipListNode *pNode, bool isForward);
 static bool tSkipListGetPosToPut(SSkipList *pSkipList, SSkipListNode **backward, void *pData);
 static SSkipListNode *tSkipListNewNode(uint8_t level);
+static SSkipListNode *tSkipListAllocNode(SSkipList *pSkipList, uint8_t level);
+static void           tSkipListReleaseNode(SSkipList *pSkipList, SSkipListNode *pNode);
 #define tSkipListFreeNode(n) tfree((n))
+#define SL_NODE_SIZE(l) (sizeof(SSkipListNode) + sizeof(SSkipListNode *) * (l) * 2)
 static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipListNode **direction, bool isForward,
                                        bool hasDup);
 
 
 static FORCE_INLINE int     tSkipListWLock(SSkipList *pSkipList);
+static FORCE_INLINE int     tSkipListWUnlock(SSkipList *pSkipList);
 static FORCE_INLINE int     tSkipListRLock(SSkipList *pSkipList);
 static FORCE_INLINE int     tSkipListUnlock(SSkipList *pSkipList);
 static FORCE_INLINE int32_t getSkipListRandLevel(SSkipList *pSkipList);
 
+// In lock free mode, links are published with atomic stores and read with atomic loads, so that a reader
+// always observes a fully initialized node.
+#define SL_LOAD_FORWARD(s, n, l)                                                                      \
+  (SL_IS_LOCK_FREE(s) ? (SSkipListNode *)atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER((n), (l))) \
+                      : SL_NODE_GET_FORWARD_POINTER((n), (l)))
+#define SL_LOAD_BACKWARD(s, n, l)                                                                      \
+  (SL_IS_LOCK_FREE(s) ? (SSkipListNode *)atomic_load_ptr(&SL_NODE_GET_BACKWARD_POINTER((n), (l))) \
+                      : SL_NODE_GET_BACKWARD_POINTER((n), (l)))
+#define SL_PUBLISH(s, p, v)          \
+  do {                               \
+    if (SL_IS_LOCK_FREE(s)) {        \
+      atomic_store_ptr(&(p), (v));   \
+    } else {                         \
+      (p) = (v);                     \
+    }                                \
+  } while (0)
+
 SSkipList *tSkipListCreate(uint8_t maxLevel, uint8_t keyType, uint16_t keyLen, __compar_fn_t comparFn, uint8_t flags,
                            __sl_key_fn_t fn) {
   SSkipList *pSkipList = (SSkipList *)calloc(1, sizeof(SSkipList));
@@ -64,7 +85,14 @@ SSkipList *tSkipListCreate(uint8_t maxLevel, uint8_t keyType, uint16_t keyLen, _
     return NULL;
   }
 
-  if (SL_IS_THREAD_SAFE(pSkipList)) {
+  if (SL_IS_LOCK_FREE(pSkipList)) {
+    taosInitRWLatch(&pSkipList->wLatch);
+    pSkipList->pRetired = taosArrayInit(4, POINTER_BYTES);
+    if (pSkipList->pRetired == NULL) {
+      tSkipListDestroy(pSkipList);
+      return NULL;
+    }
+  } else if (SL_IS_THREAD_SAFE(pSkipList)) {
     pSkipList->lock = (pthread_rwlock_t *)calloc(1, sizeof(pthread_rwlock_t));
     if (pSkipList->lock == NULL) {
       tSkipListDestroy(pSkipList);
@@ -92,17 +120,28 @@ void tSkipListDestroy(SSkipList *pSkipList) {
 
   tSkipListWLock(pSkipList);
 
-  SSkipListNode *pNode = SL_NODE_GET_FORWARD_POINTER(pSkipList->pHead, 0);
+  // nodes from the allocator are released by its owner, and may be gone already
+  if (pSkipList->nodeAllocFn == NULL) {
+    SSkipListNode *pNode = SL_NODE_GET_FORWARD_POINTER(pSkipList->pHead, 0);
 
-  while (pNode != pSkipList->pTail) {
-    SSkipListNode *pTemp = pNode;
-    pNode = SL_NODE_GET_FORWARD_POINTER(pNode, 0);
-    tSkipListFreeNode(pTemp);
+    while (pNode != pSkipList->pTail) {
+      SSkipListNode *pTemp = pNode;
+      pNode = SL_NODE_GET_FORWARD_POINTER(pNode, 0);
+      tSkipListFreeNode(pTemp);
+    }
   }
 
   tfree(pSkipList->insertHandleFn);
 
-  tSkipListUnlock(pSkipList);
+  if (pSkipList->pRetired != NULL) {
+    for (size_t i = 0; i < taosArrayGetSize(pSkipList->pRetired); ++i) {
+      SSkipListNode *pRetired = *(SSkipListNode **)taosArrayGet(pSkipList->pRetired, i);
+      tSkipListReleaseNode(pSkipList, pRetired);
+    }
+    taosArrayDestroy(&pSkipList->pRetired);
+  }
+
+  tSkipListWUnlock(pSkipList);
   if (pSkipList->lock != NULL) {
     pthread_rwlock_destroy(pSkipList->lock);
     tfree(pSkipList->lock);
@@ -113,6 +152,14 @@ void tSkipListDestroy(SSkipList *pSkipList) {
   tfree(pSkipList);
 }
 
+void tSkipListSetNodeAllocator(SSkipList *pSkipList, sl_node_alloc_fn_t fn, void *param) {
+  // nodes already in the list are released by free(), so the allocator can only be set on an empty list
+  ASSERT(pSkipList->size == 0);
+
+  pSkipList->nodeAllocFn = fn;
+  pSkipList->nodeAllocParam = param;
+}
+
 SSkipListNode *tSkipListPut(SSkipList *pSkipList, void *pData) {
   if (pSkipList == NULL || pData == NULL) return NULL;
 
@@ -124,7 +171,7 @@ SSkipListNode *tSkipListPut(SSkipList *pSkipList, void *pData) {
   bool hasDup = tSkipListGetPosToPut(pSkipList, backward, pData);
   pNode = tSkipListPutImpl(pSkipList, pData, backward, false, hasDup);
 
-  tSkipListUnlock(pSkipList);
+  tSkipListWUnlock(pSkipList);
 
   return pNode;
 }
@@ -140,7 +187,10 @@ void tSkipListPutBatchByIter(SSkipList *pSkipList, void *iter, iter_next_fn_t it
   tSkipListWLock(pSkipList);
 
   void* pData = iterate(iter);
-  if(pData == NULL) return;
+  if(pData == NULL) {
+    tSkipListWUnlock(pSkipList);
+    return;
+  }
 
   // backward to put the first data
   hasDup = tSkipListGetPosToPut(pSkipList, backward, pData);
@@ -210,7 +260,7 @@ void tSkipListPutBatchByIter(SSkipList *pSkipList, void *iter, iter_next_fn_t it
 
     tSkipListPutImpl(pSkipList, pData, forward, true, hasDup);
   }
-  tSkipListUnlock(pSkipList);
+  tSkipListWUnlock(pSkipList);
 }
 
 uint32_t tSkipListRemove(SSkipList *pSkipList, SSkipListKey key) {
@@ -235,7 +285,7 @@ uint32_t tSkipListRemove(SSkipList *pSkipList, SSkipListKey key) {
 
   tSkipListCorrectLevel(pSkipList);
 
-  tSkipListUnlock(pSkipList);
+  tSkipListWUnlock(pSkipList);
 
   return count;
 }
@@ -247,7 +297,7 @@ SArray *tSkipListGet(SSkipList *pSkipList, SSkipListKey key) {
 
   SSkipListNode *pNode = getPriorNode(pSkipList, key, TSDB_ORDER_ASC, NULL);
   while (1) {
-    SSkipListNode *p = SL_NODE_GET_FORWARD_POINTER(pNode, 0);
+    SSkipListNode *p = SL_LOAD_FORWARD(pSkipList, pNode, 0);
     if (p == pSkipList->pTail) {
       break;
     }
@@ -267,7 +317,7 @@ void tSkipListRemoveNode(SSkipList *pSkipList, SSkipListNode *pNode) {
   tSkipListWLock(pSkipList);
   tSkipListRemoveNodeImpl(pSkipList, pNode);
   tSkipListCorrectLevel(pSkipList);
-  tSkipListUnlock(pSkipList);
+  tSkipListWUnlock(pSkipList);
 }
 
 SSkipListIterator *tSkipListCreateIter(SSkipList *pSkipList) {
@@ -309,14 +359,14 @@ bool tSkipListIterNext(SSkipListIterator *iter) {
       return false;
     }
 
-    iter->cur = SL_NODE_GET_FORWARD_POINTER(iter->cur, 0);
+    iter->cur = SL_LOAD_FORWARD(pSkipList, iter->cur, 0);
 
     // a new node is inserted into between iter->cur and iter->next, ignore it
     if (iter->cur != iter->next && (iter->next != NULL)) {
       iter->cur = iter->next;
     }
 
-    iter->next = SL_NODE_GET_FORWARD_POINTER(iter->cur, 0);
+    iter->next = SL_LOAD_FORWARD(pSkipList, iter->cur, 0);
     iter->step++;
   } else {
     if (iter->cur == pSkipList->pHead) {
@@ -325,14 +375,14 @@ bool tSkipListIterNext(SSkipListIterator *iter) {
       return false;
     }
 
-    iter->cur = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->cur = SL_LOAD_BACKWARD(pSkipList, iter->cur, 0);
 
     // a new node is inserted into between iter->cur and iter->next, ignore it
     if (iter->cur != iter->next && (iter->next != NULL)) {
       iter->cur = iter->next;
     }
 
-    iter->next = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->next = SL_LOAD_BACKWARD(pSkipList, iter->cur, 0);
     iter->step++;
   }
 
@@ -400,24 +450,26 @@ void tSkipListPrint(SSkipList *pSkipList, int16_t nlevel) {
 }
 
 static void tSkipListDoInsert(SSkipList *pSkipList, SSkipListNode **direction, SSkipListNode *pNode, bool isForward) {
+  // the links of the new node are set up before the node is published to its neighbours, from the bottom level
+  // up, so that a reader without lock never walks into a half linked node
   for (int32_t i = 0; i < pNode->level; ++i) {
     SSkipListNode *x = direction[i];
     if (isForward) {
-      SL_NODE_GET_BACKWARD_POINTER(pNode, i) = x;
-
       SSkipListNode *next = SL_NODE_GET_FORWARD_POINTER(x, i);
-      SL_NODE_GET_BACKWARD_POINTER(next, i) = pNode;
 
+      SL_NODE_GET_BACKWARD_POINTER(pNode, i) = x;
       SL_NODE_GET_FORWARD_POINTER(pNode, i) = next;
-      SL_NODE_GET_FORWARD_POINTER(x, i) = pNode;
-    } else {
-      SL_NODE_GET_FORWARD_POINTER(pNode, i) = x;
 
+      SL_PUBLISH(pSkipList, SL_NODE_GET_FORWARD_POINTER(x, i), pNode);
+      SL_PUBLISH(pSkipList, SL_NODE_GET_BACKWARD_POINTER(next, i), pNode);
+    } else {
       SSkipListNode *prev = SL_NODE_GET_BACKWARD_POINTER(x, i);
-      SL_NODE_GET_FORWARD_POINTER(prev, i) = pNode;
 
+      SL_NODE_GET_FORWARD_POINTER(pNode, i) = x;
       SL_NODE_GET_BACKWARD_POINTER(pNode, i) = prev;
-      SL_NODE_GET_BACKWARD_POINTER(x, i) = pNode;
+
+      SL_PUBLISH(pSkipList, SL_NODE_GET_FORWARD_POINTER(prev, i), pNode);
+      SL_PUBLISH(pSkipList, SL_NODE_GET_BACKWARD_POINTER(x, i), pNode);
     }
   }
 
@@ -433,10 +485,10 @@ static SSkipListIterator *doCreateSkipListIterator(SSkipList *pSkipList, int32_t
   iter->order = order;
   if (order == TSDB_ORDER_ASC) {
     iter->cur = pSkipList->pHead;
-    iter->next = SL_NODE_GET_FORWARD_POINTER(iter->cur, 0);
+    iter->next = SL_LOAD_FORWARD(pSkipList, iter->cur, 0);
   } else {
     iter->cur = pSkipList->pTail;
-    iter->next = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->next = SL_LOAD_BACKWARD(pSkipList, iter->cur, 0);
   }
 
   return iter;
@@ -445,10 +497,22 @@ static SSkipListIterator *doCreateSkipListIterator(SSkipList *pSkipList, int32_t
 static FORCE_INLINE int tSkipListWLock(SSkipList *pSkipList) {
   if (pSkipList->lock) {
     return pthread_rwlock_wrlock(pSkipList->lock);
+  } else if (SL_IS_LOCK_FREE(pSkipList)) {
+    taosWLockLatch(&pSkipList->wLatch);
+  }
+  return 0;
+}
+
+static FORCE_INLINE int tSkipListWUnlock(SSkipList *pSkipList) {
+  if (pSkipList->lock) {
+    return pthread_rwlock_unlock(pSkipList->lock);
+  } else if (SL_IS_LOCK_FREE(pSkipList)) {
+    taosWUnLockLatch(&pSkipList->wLatch);
   }
   return 0;
 }
 
+// readers never take the writer latch in lock free mode
 static FORCE_INLINE int tSkipListRLock(SSkipList *pSkipList) {
   if (pSkipList->lock) {
     return pthread_rwlock_rdlock(pSkipList->lock);
@@ -531,11 +595,16 @@ static void tSkipListRemoveNodeImpl(SSkipList *pSkipList, SSkipListNode *pNode)
     SSkipListNode *prev = SL_NODE_GET_BACKWARD_POINTER(pNode, j);
     SSkipListNode *next = SL_NODE_GET_FORWARD_POINTER(pNode, j);
 
-    SL_NODE_GET_FORWARD_POINTER(prev, j) = next;
-    SL_NODE_GET_BACKWARD_POINTER(next, j) = prev;
+    SL_PUBLISH(pSkipList, SL_NODE_GET_FORWARD_POINTER(prev, j), next);
+    SL_PUBLISH(pSkipList, SL_NODE_GET_BACKWARD_POINTER(next, j), prev);
   }
 
-  tSkipListFreeNode(pNode);
+  // a reader may still stand on the removed node, whose own links are left intact, so it is reclaimed later
+  if (SL_IS_LOCK_FREE(pSkipList) && pSkipList->nodeAllocFn == NULL) {
+    taosArrayPush(pSkipList->pRetired, &pNode);
+  } else {
+    tSkipListReleaseNode(pSkipList, pNode);
+  }
   pSkipList->size--;
 }
 
@@ -609,12 +678,12 @@ static SSkipListNode *getPriorNode(SSkipList *pSkipList, const char *val, int32_
   if (order == TSDB_ORDER_ASC) {
     pNode = pSkipList->pHead;
     for (int32_t i = pSkipList->level - 1; i >= 0; --i) {
-      SSkipListNode *p = SL_NODE_GET_FORWARD_POINTER(pNode, i);
+      SSkipListNode *p = SL_LOAD_FORWARD(pSkipList, pNode, i);
       while (p != pSkipList->pTail) {
         char *key = SL_GET_NODE_KEY(pSkipList, p);
         if (comparFn(key, val) < 0) {
           pNode = p;
-          p = SL_NODE_GET_FORWARD_POINTER(p, i);
+          p = SL_LOAD_FORWARD(pSkipList, p, i);
         } else {
           if (pCur != NULL) {
             *pCur = p;
@@ -626,12 +695,12 @@ static SSkipListNode *getPriorNode(SSkipList *pSkipList, const char *val, int32_
   } else {
     pNode = pSkipList->pTail;
     for (int32_t i = pSkipList->level - 1; i >= 0; --i) {
-      SSkipListNode *p = SL_NODE_GET_BACKWARD_POINTER(pNode, i);
+      SSkipListNode *p = SL_LOAD_BACKWARD(pSkipList, pNode, i);
       while (p != pSkipList->pHead) {
         char *key = SL_GET_NODE_KEY(pSkipList, p);
         if (comparFn(key, val) > 0) {
           pNode = p;
-          p = SL_NODE_GET_BACKWARD_POINTER(p, i);
+          p = SL_LOAD_BACKWARD(pSkipList, p, i);
         } else {
           if (pCur != NULL) {
             *pCur = p;
@@ -668,7 +737,7 @@ static int initForwardBackwardPtr(SSkipList *pSkipList) {
 }
 
 static SSkipListNode *tSkipListNewNode(uint8_t level) {
-  int32_t tsize = sizeof(SSkipListNode) + sizeof(SSkipListNode *) * level * 2;
+  int32_t tsize = SL_NODE_SIZE(level);
 
   SSkipListNode *pNode = (SSkipListNode *)calloc(1, tsize);
   if (pNode == NULL) return NULL;
@@ -677,6 +746,26 @@ static SSkipListNode *tSkipListNewNode(uint8_t level) {
   return pNode;
 }
 
+static SSkipListNode *tSkipListAllocNode(SSkipList *pSkipList, uint8_t level) {
+  if (pSkipList->nodeAllocFn == NULL) {
+    return tSkipListNewNode(level);
+  }
+
+  int32_t        tsize = SL_NODE_SIZE(level);
+  SSkipListNode *pNode = (SSkipListNode *)(*pSkipList->nodeAllocFn)(pSkipList->nodeAllocParam, tsize);
+  if (pNode == NULL) return NULL;
+
+  memset(pNode, 0, tsize);
+  pNode->level = level;
+  return pNode;
+}
+
+static void tSkipListReleaseNode(SSkipList *pSkipList, SSkipListNode *pNode) {
+  if (pSkipList->nodeAllocFn == NULL) {
+    tSkipListFreeNode(pNode);
+  }
+}
+
 static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipListNode **direction, bool isForward,
                                        bool hasDup) {
   uint8_t        dupMode = SL_DUP_MODE(pSkipList);
@@ -706,7 +795,7 @@ static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipL
       }
     }
   } else {
-    pNode = tSkipListNewNode(getSkipListRandLevel(pSkipList));
+    pNode = tSkipListAllocNode(pSkipList, getSkipListRandLevel(pSkipList));
     if (pNode != NULL) {
       // insertHandleFn will be assigned only for timeseries data,
       // in which case, pData is pointed to an memory to be freed later;
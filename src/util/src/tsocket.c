@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define _GNU_SOURCE
 #include "os.h"
 #include "tulog.h"
 #include "tsocket.h"
@@ -144,6 +145,44 @@ int32_t taosWriteMsg(SOCKET fd, void *buf, int32_t nbytes) {
   return (nbytes - nleft);
 }
 
+#ifndef WINDOWS
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// write all the segments, the iovec array is consumed while the partial writes are resumed
+int32_t taosWriteMsgV(SOCKET fd, struct iovec *iov, int32_t iovcnt) {
+  int32_t nbytes = 0;
+
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    nbytes += (int32_t)iov[i].iov_len;
+  }
+
+  while (iovcnt > 0) {
+    int32_t n = (int32_t)writev(fd, iov, MIN(iovcnt, IOV_MAX));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      else
+        return -1;
+    }
+
+    while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+      n -= (int32_t)iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+
+    if (n > 0) {
+      iov->iov_base = (char *)iov->iov_base + n;
+      iov->iov_len -= n;
+    }
+  }
+
+  return nbytes;
+}
+#endif
+
 int32_t taosReadMsg(SOCKET fd, void *buf, int32_t nbytes) {
   int32_t nleft, nread;
   char *  ptr = (char *)buf;
@@ -450,7 +489,46 @@ int32_t taosKeepTcpAlive(SOCKET sockFd) {
   return 0;
 }
 
-SOCKET taosOpenTcpServerSocket(uint32_t ip, uint16_t port) {
+static SOCKET taosOpenTcpListenSocket(uint32_t ip, uint16_t port, bool reusePort);
+
+SOCKET taosOpenTcpServerSocket(uint32_t ip, uint16_t port) { return taosOpenTcpListenSocket(ip, port, false); }
+
+#ifdef SO_REUSEPORT
+// each socket opened on the same port has its own accept queue, the kernel distributes the connections among them
+SOCKET taosOpenTcpReusePortSocket(uint32_t ip, uint16_t port) { return taosOpenTcpListenSocket(ip, port, true); }
+
+/*
+ * A socket without SO_REUSEPORT can not be bound to a port on which any socket is listening, even the listening
+ * sockets opened with SO_REUSEPORT by another process. So the port is probed by binding such a socket, which is
+ * closed without listening.
+ */
+bool taosTcpPortInUse(uint32_t ip, uint16_t port) {
+  struct sockaddr_in serverAdd;
+  int32_t            reuse = 1;
+
+  bzero((char *)&serverAdd, sizeof(serverAdd));
+  serverAdd.sin_family = AF_INET;
+  serverAdd.sin_addr.s_addr = ip;
+  serverAdd.sin_port = (uint16_t)htons(port);
+
+  SOCKET sockFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sockFd < 0) {
+    uError("failed to open TCP socket to probe port:%hu: %d (%s)", port, errno, strerror(errno));
+    return false;
+  }
+
+  bool inUse = false;
+  if (taosSetSockOpt(sockFd, SOL_SOCKET, SO_REUSEADDR, (void *)&reuse, sizeof(reuse)) == 0 &&
+      bind(sockFd, (struct sockaddr *)&serverAdd, sizeof(serverAdd)) < 0 && errno == EADDRINUSE) {
+    inUse = true;
+  }
+
+  taosCloseSocket(sockFd);
+  return inUse;
+}
+#endif
+
+static SOCKET taosOpenTcpListenSocket(uint32_t ip, uint16_t port, bool reusePort) {
   struct sockaddr_in serverAdd;
   SOCKET             sockFd;
   int32_t            reuse;
@@ -476,6 +554,14 @@ SOCKET taosOpenTcpServerSocket(uint32_t ip, uint16_t port) {
     return -1;
   }
 
+#ifdef SO_REUSEPORT
+  if (reusePort && taosSetSockOpt(sockFd, SOL_SOCKET, SO_REUSEPORT, (void *)&reuse, sizeof(reuse)) < 0) {
+    uError("setsockopt SO_REUSEPORT failed: %d (%s)", errno, strerror(errno));
+    taosCloseSocket(sockFd);
+    return -1;
+  }
+#endif
+
   /* bind socket to server address */
   if (bind(sockFd, (struct sockaddr *)&serverAdd, sizeof(serverAdd)) < 0) {
     uError("bind tcp server socket failed, 0x%x:%hu(%s)", ip, port, strerror(errno));
@@ -503,13 +589,88 @@ void tinet_ntoa(char *ipstr, uint32_t ip) {
 }
 
 #define COPY_SIZE 32768
-// sendfile shall be used
+#define SPLICE_SIZE (1024 * 1024)
+
+#if defined(_TD_LINUX) && defined(SPLICE_F_MOVE)
+// for the files which can not be spliced into
+static int64_t taosDrainPipe(int32_t pfd, int32_t dfd, int64_t len) {
+  char    temp[COPY_SIZE];
+  int64_t leftLen = len;
+
+  while (leftLen > 0) {
+    int32_t readLen = (int32_t)taosReadMsg(pfd, temp, (int32_t)MIN(leftLen, COPY_SIZE));
+    if (readLen <= 0 || taosWriteMsg(dfd, temp, readLen) != readLen) return -1;
+    leftLen -= readLen;
+  }
+
+  return len;
+}
+
+/*
+ * the data is moved from the socket into the file by the pages of a pipe, never copied into the user space.
+ * -2 is returned if nothing is moved since the socket can not be spliced, the caller shall copy it then
+ */
+static int64_t taosSpliceFds(SOCKET sfd, int32_t dfd, int64_t len) {
+  int32_t pipeFds[2];
+  int64_t leftLen = len;
+  bool    spliceOut = true;
+
+  if (pipe(pipeFds) != 0) return -2;
+
+  while (leftLen > 0) {
+    ssize_t inLen = splice(sfd, NULL, pipeFds[1], NULL, (size_t)MIN(leftLen, SPLICE_SIZE), SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (inLen < 0 && errno == EINTR) continue;
+    if (inLen <= 0) {
+      if (inLen < 0 && errno == EINVAL && leftLen == len) leftLen = -2;
+      break;
+    }
+
+    while (inLen > 0 && spliceOut) {
+      ssize_t outLen = splice(pipeFds[0], NULL, dfd, NULL, (size_t)inLen, SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (outLen < 0 && errno == EINTR) continue;
+      if (outLen < 0 && errno == EINVAL) {
+        spliceOut = false;
+        break;
+      }
+      if (outLen <= 0) break;
+      inLen -= outLen;
+      leftLen -= outLen;
+    }
+
+    if (inLen > 0 && !spliceOut) {
+      if (taosDrainPipe(pipeFds[0], dfd, inLen) != inLen) break;
+      leftLen -= inLen;
+      inLen = 0;
+    }
+
+    if (inLen > 0) break;
+  }
+
+  close(pipeFds[0]);
+  close(pipeFds[1]);
+
+  if (leftLen == -2) return -2;
+  if (leftLen != 0) {
+    uError("splice error, len:%" PRId64 " leftLen:%" PRId64 ", reason:%s", len, leftLen, strerror(errno));
+    return -1;
+  }
+
+  return len;
+}
+#endif
 
 int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len) {
   int64_t leftLen;
   int64_t readLen, writeLen;
   char    temp[COPY_SIZE];
 
+#if defined(_TD_LINUX) && defined(SPLICE_F_MOVE)
+  if (len > COPY_SIZE) {
+    int64_t ret = taosSpliceFds(sfd, dfd, len);
+    if (ret != -2) return ret;
+  }
+#endif
+
   leftLen = len;
 
   while (leftLen > 0) {
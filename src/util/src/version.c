@@ -0,0 +1,7 @@
+char version[12] = "2.7.0.0";
+char compatible_version[12] = "2.0.0.0";
+char gitinfo[48] = "47d3a33b78d5043b28685dde4f7fd7323d1e6403";
+char gitinfoOfInternal[48] = "47d3a33b78d5043b28685dde4f7fd7323d1e6403";
+char buildinfo[64] = "Built at 2026-10-18 08:48:28";
+
+void libtaos_2_7_0_0_Linux_x32_stable() {};
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#include "tscompression.h"
+
+namespace {
+const int kNumOfElems[] = {1, 2, 3, 7, 17, 19, 240, 255, 256, 257, 1001, 4096};
+
+typedef std::vector<std::string> DecodedSet;
+
+std::string genInput(std::mt19937_64 &rng, int type, int nelements) {
+  std::string data;
+  int64_t     ts = 1600000000000L;
+  int64_t     step = 1000;
+  double      dv = 100.0;
+  float       fv = 10.0f;
+
+  for (int i = 0; i < nelements; i++) {
+    uint64_t r = rng();
+    switch (type) {
+      case TSDB_DATA_TYPE_TIMESTAMP: {
+        // regular intervals with some jitter and gaps
+        ts += (r % 16 == 0) ? (int64_t)(r % 100000000) : step + (int64_t)(r % 3) - 1;
+        data.append((char *)&ts, sizeof(ts));
+        break;
+      }
+      case TSDB_DATA_TYPE_BIGINT: {
+        int64_t v = (r % 8 == 0) ? (int64_t)(r >> 8) : (int64_t)(r % 1000) - 500;
+        data.append((char *)&v, sizeof(v));
+        break;
+      }
+      case TSDB_DATA_TYPE_INT: {
+        int32_t v = (r % 8 == 0) ? (int32_t)r : (int32_t)(r % 100);
+        data.append((char *)&v, sizeof(v));
+        break;
+      }
+      case TSDB_DATA_TYPE_SMALLINT: {
+        int16_t v = (int16_t)(r % 4096);
+        data.append((char *)&v, sizeof(v));
+        break;
+      }
+      case TSDB_DATA_TYPE_TINYINT: {
+        int8_t v = (int8_t)(r % 3);
+        data.append((char *)&v, sizeof(v));
+        break;
+      }
+      case TSDB_DATA_TYPE_DOUBLE: {
+        dv = (r % 16 == 0) ? (double)r : dv + (double)(r % 10) / 8;
+        data.append((char *)&dv, sizeof(dv));
+        break;
+      }
+      case TSDB_DATA_TYPE_FLOAT: {
+        fv = (r % 16 == 0) ? (float)(r % 1000000) / 7 : fv + (float)(r % 10) / 4;
+        data.append((char *)&fv, sizeof(fv));
+        break;
+      }
+    }
+  }
+
+  return data;
+}
+
+std::string compressAndDecompress(const std::string &input, int type, int nelements) {
+  std::vector<char> compressed(input.size() + 256);
+  std::vector<char> output(input.size() + 256);
+
+  switch (type) {
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      tsCompressTimestampImp(input.data(), nelements, compressed.data());
+      EXPECT_EQ(tsDecompressTimestampImp(compressed.data(), nelements, output.data()), (int)input.size());
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      tsCompressDoubleImp(input.data(), nelements, compressed.data());
+      EXPECT_EQ(tsDecompressDoubleImp(compressed.data(), nelements, output.data()), (int)input.size());
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      tsCompressFloatImp(input.data(), nelements, compressed.data());
+      EXPECT_EQ(tsDecompressFloatImp(compressed.data(), nelements, output.data()), (int)input.size());
+      break;
+    default:
+      tsCompressINTImp(input.data(), nelements, compressed.data(), type);
+      EXPECT_EQ(tsDecompressINTImp(compressed.data(), nelements, output.data(), type), (int)input.size());
+      break;
+  }
+
+  return std::string(output.data(), input.size());
+}
+
+void decodeAll(DecodedSet &inputs, DecodedSet &outputs) {
+  const int       types[] = {TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_SMALLINT,
+                       TSDB_DATA_TYPE_TINYINT,   TSDB_DATA_TYPE_DOUBLE, TSDB_DATA_TYPE_FLOAT};
+  std::mt19937_64 rng(20211018);
+
+  for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+    for (size_t n = 0; n < sizeof(kNumOfElems) / sizeof(kNumOfElems[0]); n++) {
+      std::string input = genInput(rng, types[t], kNumOfElems[n]);
+      inputs.push_back(input);
+      outputs.push_back(compressAndDecompress(input, types[t], kNumOfElems[n]));
+    }
+  }
+}
+}  // namespace
+
+// the kernels resolved for this cpu must give exactly the same output as the scalar ones
+TEST(testCase, decompress_kernel_test) {
+  DecodedSet inputs, scalar, resolved;
+
+  decodeAll(inputs, scalar);
+
+  taosResolveDecompress();
+  inputs.clear();
+  decodeAll(inputs, resolved);
+
+  ASSERT_EQ(scalar.size(), resolved.size());
+  for (size_t i = 0; i < scalar.size(); i++) {
+    EXPECT_EQ(scalar[i], inputs[i]);
+    EXPECT_EQ(resolved[i], inputs[i]);
+  }
+}
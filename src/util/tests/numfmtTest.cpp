@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+
+#include "tnumfmt.h"
+
+namespace {
+std::string fmtDouble(double v) {
+  char    buf[TNUMFMT_MAX_LEN];
+  int32_t len = tDoubleToStr(v, buf);
+  EXPECT_EQ(len, (int32_t)strlen(buf));
+  return std::string(buf, len);
+}
+
+std::string fmtFloat(float v) {
+  char    buf[TNUMFMT_MAX_LEN];
+  int32_t len = tFloatToStr(v, buf);
+  EXPECT_EQ(len, (int32_t)strlen(buf));
+  return std::string(buf, len);
+}
+}  // namespace
+
+TEST(testCase, numfmt_int_test) {
+  char         buf[TNUMFMT_MAX_LEN];
+  std::mt19937 rng(20211018);
+
+  const int64_t edges[] = {0, 1, -1, 9, 10, 99, 100, -100, INT32_MAX, INT32_MIN, INT64_MAX, INT64_MIN};
+  for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+    ASSERT_EQ(tInt64ToStr(edges[i], buf), (int32_t)std::to_string(edges[i]).size());
+    ASSERT_STREQ(buf, std::to_string(edges[i]).c_str());
+  }
+
+  tUInt64ToStr(UINT64_MAX, buf);
+  ASSERT_STREQ(buf, "18446744073709551615");
+
+  for (int32_t i = 0; i < 100000; ++i) {
+    int64_t v = (int64_t)(((uint64_t)rng() << 32) | rng()) >> (rng() % 64);
+    tInt64ToStr(v, buf);
+    ASSERT_STREQ(buf, std::to_string(v).c_str());
+  }
+
+  memset(buf, 0, sizeof(buf));
+  tFmtPadDigits(7, 3, buf);
+  EXPECT_STREQ(buf, "007");
+  tFmtPadDigits(123456789, 9, buf);
+  EXPECT_STREQ(buf, "123456789");
+  tFmtPadDigits(0, 2, buf + 9);
+  EXPECT_STREQ(buf, "12345678900");
+}
+
+TEST(testCase, numfmt_double_test) {
+  EXPECT_EQ(fmtDouble(0.0), "0.0");
+  EXPECT_EQ(fmtDouble(-0.0), "-0.0");
+  EXPECT_EQ(fmtDouble(0.1), "0.1");
+  EXPECT_EQ(fmtDouble(-1.5), "-1.5");
+  EXPECT_EQ(fmtDouble(123456.0), "123456.0");
+  EXPECT_EQ(fmtDouble(0.001234), "0.001234");
+  EXPECT_EQ(fmtDouble(1e-7), "1e-7");
+  EXPECT_EQ(fmtDouble(1e21), "1e21");
+  EXPECT_EQ(fmtDouble(1e20), "100000000000000000000.0");
+  EXPECT_EQ(fmtDouble(1.5e300), "1.5e300");
+  EXPECT_EQ(fmtDouble(5e-324), "5e-324");
+  EXPECT_EQ(fmtDouble(DBL_MAX), "1.7976931348623157e308");
+  EXPECT_EQ(fmtDouble(1.0 / 3), "0.3333333333333333");
+
+  // any value is parsed back exactly
+  std::mt19937_64 rng(1018);
+  for (int32_t i = 0; i < 1000000; ++i) {
+    uint64_t u = rng();
+    double   v = 0;
+    memcpy(&v, &u, sizeof(v));
+    if (v != v || v - v != 0) continue;
+
+    std::string s = fmtDouble(v);
+    ASSERT_EQ(strtod(s.c_str(), NULL), v) << s;
+  }
+
+  for (int32_t i = 0; i < 100000; ++i) {
+    double      v = (double)(int64_t)(rng() % 2000000 - 1000000) / 1000;
+    std::string s = fmtDouble(v);
+    ASSERT_EQ(strtod(s.c_str(), NULL), v) << s;
+    ASSERT_LE(s.size(), 13u) << s;
+  }
+}
+
+TEST(testCase, numfmt_float_test) {
+  EXPECT_EQ(fmtFloat(0.0f), "0.0");
+  EXPECT_EQ(fmtFloat(0.1f), "0.1");
+  EXPECT_EQ(fmtFloat(3.14159f), "3.14159");
+  EXPECT_EQ(fmtFloat(-2.5e-10f), "-2.5e-10");
+  EXPECT_EQ(fmtFloat(FLT_MAX), "3.4028235e38");
+  EXPECT_EQ(fmtFloat(1e-45f), "1e-45");
+
+  std::mt19937 rng(1018);
+  for (int32_t i = 0; i < 1000000; ++i) {
+    uint32_t u = rng();
+    float    v = 0;
+    memcpy(&v, &u, sizeof(v));
+    if (v != v || v - v != 0) continue;
+
+    std::string s = fmtFloat(v);
+    ASSERT_EQ(strtof(s.c_str(), NULL), v) << s;
+  }
+}
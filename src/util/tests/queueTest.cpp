@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "os.h"
+#include "tqueue.h"
+
+namespace {
+const int kNumOfWriters = 4;
+const int kNumOfItems = 20000;
+
+struct SWriter {
+  taos_queue queue;
+  int        id;
+  int        batch;
+};
+
+void *writeItems(void *param) {
+  SWriter           *pWriter = (SWriter *)param;
+  std::vector<void *> items;
+
+  for (int i = 0; i < kNumOfItems; ++i) {
+    int32_t *item = (int32_t *)taosAllocateQitem(sizeof(int32_t));
+    *item = i;
+    items.push_back(item);
+
+    if ((int)items.size() == pWriter->batch || i == kNumOfItems - 1) {
+      taosWriteQitems(pWriter->queue, pWriter->id, items.data(), (int)items.size());
+      items.clear();
+    }
+  }
+
+  return NULL;
+}
+
+// items from each writer shall be read out in the order they are written
+void checkItems(taos_queue queue, bool readAll) {
+  std::vector<int32_t> next(kNumOfWriters, 0);
+  SWriter              writers[kNumOfWriters];
+  pthread_t            threads[kNumOfWriters];
+
+  for (int i = 0; i < kNumOfWriters; ++i) {
+    writers[i].queue = queue;
+    writers[i].id = i;
+    writers[i].batch = i + 1;
+    pthread_create(&threads[i], NULL, writeItems, &writers[i]);
+  }
+
+  taos_qall qall = taosAllocateQall();
+  int       total = 0;
+  int       type;
+  int32_t  *item;
+
+  while (total < kNumOfWriters * kNumOfItems) {
+    int num = readAll ? taosReadAllQitems(queue, qall) : taosReadQitem(queue, &type, (void **)&item);
+
+    for (int i = 0; i < num; ++i) {
+      if (readAll) taosGetQitem(qall, &type, (void **)&item);
+      ASSERT_TRUE(type >= 0 && type < kNumOfWriters);
+      ASSERT_EQ(*item, next[type]);
+      next[type]++;
+      taosFreeQitem(item);
+    }
+
+    total += num;
+  }
+
+  for (int i = 0; i < kNumOfWriters; ++i) {
+    pthread_join(threads[i], NULL);
+    EXPECT_EQ(next[i], kNumOfItems);
+  }
+
+  EXPECT_EQ(taosGetQueueItemsNumber(queue), 0);
+  EXPECT_EQ(taosReadQitem(queue, &type, (void **)&item), 0);
+  taosFreeQall(qall);
+}
+
+void *readQset(void *param) {
+  taos_qset qset = param;
+  int       type;
+  void     *item, *ahandle;
+  int64_t   num = 0;
+
+  while (taosReadQitemFromQset(qset, &type, &item, &ahandle) > 0) {
+    taosFreeQitem(item);
+    num++;
+  }
+
+  return (void *)num;
+}
+}  // namespace
+
+TEST(testCase, queue_read_test) {
+  taos_queue queue = taosOpenQueue();
+  checkItems(queue, false);
+  taosCloseQueue(queue);
+}
+
+TEST(testCase, queue_read_all_test) {
+  taos_queue queue = taosOpenQueue();
+  checkItems(queue, true);
+  taosCloseQueue(queue);
+}
+
+// readers sleeping on a qset shall be woken up by writes, and exit on resume
+TEST(testCase, qset_read_test) {
+  taos_qset  qset = taosOpenQset();
+  taos_queue queue1 = taosOpenQueue();
+  taos_queue queue2 = taosOpenQueue();
+  pthread_t  readers[2];
+
+  taosAddIntoQset(qset, queue1, NULL);
+  taosAddIntoQset(qset, queue2, NULL);
+  EXPECT_EQ(taosGetQueueNumber(qset), 2);
+
+  for (int i = 0; i < 2; ++i) pthread_create(&readers[i], NULL, readQset, qset);
+
+  for (int i = 0; i < 1000; ++i) {
+    taosWriteQitem(i % 2 ? queue1 : queue2, 0, taosAllocateQitem(8));
+    if (i % 100 == 0) taosMsleep(1);
+  }
+
+  while (taosGetQsetItemsNumber(qset) > 0) taosMsleep(1);
+
+  taosQsetThreadResume(qset);
+  taosQsetThreadResume(qset);
+
+  int64_t total = 0;
+  for (int i = 0; i < 2; ++i) {
+    void *num = NULL;
+    pthread_join(readers[i], &num);
+    total += (int64_t)num;
+  }
+  EXPECT_EQ(total, 1000);
+
+  taosCloseQueue(queue1);
+  taosCloseQueue(queue2);
+  taosCloseQset(qset);
+}
+
+// the items of a queue are no longer counted in the qset once the queue is removed
+TEST(testCase, qset_remove_test) {
+  taos_qset  qset = taosOpenQset();
+  taos_queue queue1 = taosOpenQueue();
+  taos_queue queue2 = taosOpenQueue();
+
+  taosAddIntoQset(qset, queue1, NULL);
+  taosAddIntoQset(qset, queue2, NULL);
+
+  for (int i = 0; i < 10; ++i) {
+    taosWriteQitem(i % 2 ? queue1 : queue2, 0, taosAllocateQitem(8));
+  }
+  EXPECT_EQ(taosGetQsetItemsNumber(qset), 10);
+
+  taosRemoveFromQset(qset, queue1);
+  EXPECT_EQ(taosGetQsetItemsNumber(qset), 5);
+  EXPECT_EQ(taosGetQueueItemsNumber(queue1), 5);
+
+  taosWriteQitem(queue1, 0, taosAllocateQitem(8));
+  EXPECT_EQ(taosGetQsetItemsNumber(qset), 5);
+
+  taosAddIntoQset(qset, queue1, NULL);
+  EXPECT_EQ(taosGetQsetItemsNumber(qset), 11);
+
+  taosCloseQueue(queue1);
+  taosCloseQueue(queue2);
+  taosCloseQset(qset);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+#include "troaring.h"
+
+namespace {
+typedef std::set<uint32_t> ValueSet;
+
+// sparse values, a dense range that turns into a bitset container and values around the container boundaries
+void genValues(std::mt19937 &rng, SRoaringBitmap *pBitmap, ValueSet &values, uint32_t denseStart) {
+  for (int32_t i = 0; i < 3000; ++i) {
+    uint32_t v = rng() % 1000000;
+    ASSERT_EQ(tRoaringAdd(pBitmap, v), 0);
+    values.insert(v);
+  }
+
+  for (uint32_t v = denseStart; v < denseStart + 20000; v += 1 + rng() % 3) {
+    ASSERT_EQ(tRoaringAdd(pBitmap, v), 0);
+    values.insert(v);
+  }
+
+  const uint32_t edges[] = {0, 65535, 65536, 131071, 0xFFFFFFFF};
+  for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+    ASSERT_EQ(tRoaringAdd(pBitmap, edges[i]), 0);
+    values.insert(edges[i]);
+  }
+}
+
+void checkBitmap(const SRoaringBitmap *pBitmap, const ValueSet &values) {
+  EXPECT_EQ(tRoaringCardinality(pBitmap), (int64_t)values.size());
+
+  SRoaringIter iter;
+  uint32_t     v = 0;
+  tRoaringIterInit(&iter, pBitmap);
+  for (ValueSet::const_iterator it = values.begin(); it != values.end(); ++it) {
+    ASSERT_TRUE(tRoaringIterNext(&iter, &v));
+    ASSERT_EQ(v, *it);
+    ASSERT_TRUE(tRoaringContains(pBitmap, v));
+  }
+  EXPECT_FALSE(tRoaringIterNext(&iter, &v));
+}
+}  // namespace
+
+TEST(testCase, roaring_add_remove_test) {
+  std::mt19937    rng(20211018);
+  SRoaringBitmap *pBitmap = tRoaringCreate();
+  ValueSet        values;
+
+  genValues(rng, pBitmap, values, 200000);
+  checkBitmap(pBitmap, values);
+
+  // adding existing values changes nothing
+  ASSERT_EQ(tRoaringAdd(pBitmap, 65536), 0);
+  checkBitmap(pBitmap, values);
+
+  // remove most of the dense range so that its container turns back into an array
+  for (uint32_t v = 200000; v < 218000; ++v) {
+    tRoaringRemove(pBitmap, v);
+    values.erase(v);
+  }
+  tRoaringRemove(pBitmap, 123456789);
+  checkBitmap(pBitmap, values);
+  EXPECT_FALSE(tRoaringContains(pBitmap, 200001));
+
+  for (ValueSet::iterator it = values.begin(); it != values.end(); ++it) {
+    tRoaringRemove(pBitmap, *it);
+  }
+  EXPECT_EQ(tRoaringCardinality(pBitmap), 0);
+  EXPECT_EQ(pBitmap->size, 0);
+
+  tRoaringDestroy(pBitmap);
+}
+
+TEST(testCase, roaring_set_operation_test) {
+  std::mt19937    rng(1018);
+  SRoaringBitmap *pLeft = tRoaringCreate();
+  SRoaringBitmap *pRight = tRoaringCreate();
+  ValueSet        left, right, expect;
+
+  genValues(rng, pLeft, left, 300000);
+  genValues(rng, pRight, right, 310000);
+
+  SRoaringBitmap *pRes = tRoaringAnd(pLeft, pRight);
+  std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::inserter(expect, expect.end()));
+  checkBitmap(pRes, expect);
+  tRoaringDestroy(pRes);
+
+  expect.clear();
+  pRes = tRoaringOr(pLeft, pRight);
+  std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::inserter(expect, expect.end()));
+  checkBitmap(pRes, expect);
+  tRoaringDestroy(pRes);
+
+  expect.clear();
+  pRes = tRoaringAndNot(pLeft, pRight);
+  std::set_difference(left.begin(), left.end(), right.begin(), right.end(), std::inserter(expect, expect.end()));
+  checkBitmap(pRes, expect);
+  tRoaringDestroy(pRes);
+
+  pRes = tRoaringDup(pLeft);
+  checkBitmap(pRes, left);
+  tRoaringDestroy(pRes);
+
+  SRoaringBitmap *pEmpty = tRoaringCreate();
+  pRes = tRoaringAnd(pLeft, pEmpty);
+  EXPECT_EQ(tRoaringCardinality(pRes), 0);
+  tRoaringDestroy(pRes);
+  pRes = tRoaringOr(pEmpty, pRight);
+  checkBitmap(pRes, right);
+  tRoaringDestroy(pRes);
+  tRoaringDestroy(pEmpty);
+
+  tRoaringDestroy(pLeft);
+  tRoaringDestroy(pRight);
+}
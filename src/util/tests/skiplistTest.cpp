@@ -377,4 +377,200 @@ TEST(testCase, skiplist_test) {
       free(pKeys);*/
 }
 
-#endif
\ No newline at end of file
+#endif
+namespace {
+
+char* getInt64Key(const void* data) { return (char*)(data); }
+
+struct SConcurrentSkipListParam {
+  SSkipList*        pSkipList;
+  int64_t*          keys;
+  int32_t           numOfKeys;
+  volatile int32_t* stop;
+  int64_t           numOfScans;
+};
+
+void* concurrentSkipListWriter(void* param) {
+  SConcurrentSkipListParam* p = (SConcurrentSkipListParam*)param;
+  for (int32_t i = 0; i < p->numOfKeys; ++i) {
+    tSkipListPut(p->pSkipList, &p->keys[i]);
+  }
+
+  atomic_store_32(p->stop, 1);
+  return NULL;
+}
+
+void* concurrentSkipListReader(void* param) {
+  SConcurrentSkipListParam* p = (SConcurrentSkipListParam*)param;
+
+  while (atomic_load_32(p->stop) == 0) {
+    int32_t            order = (p->numOfScans % 2 == 0) ? TSDB_ORDER_ASC : TSDB_ORDER_DESC;
+    int64_t            start = (order == TSDB_ORDER_ASC) ? 0 : INT64_MAX;
+    SSkipListIterator* iter = tSkipListCreateIterFromVal(p->pSkipList, (const char*)&start, TSDB_DATA_TYPE_BIGINT, order);
+
+    int64_t prev = (order == TSDB_ORDER_ASC) ? -1 : INT64_MAX;
+    while (tSkipListIterNext(iter)) {
+      int64_t key = *(int64_t*)SL_GET_NODE_DATA(tSkipListIterGet(iter));
+      if (order == TSDB_ORDER_ASC) {
+        EXPECT_GT(key, prev);
+      } else {
+        EXPECT_LT(key, prev);
+      }
+      prev = key;
+    }
+
+    tSkipListDestroyIter(iter);
+    p->numOfScans++;
+  }
+
+  return NULL;
+}
+
+int64_t concurrentSkipListRun(uint8_t flags, int64_t* keys, int32_t numOfKeys, int32_t numOfReaders) {
+  SSkipList* pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t),
+                                         getKeyComparFunc(TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC),
+                                         SL_DISCARD_DUP_KEY | flags, getInt64Key);
+
+  volatile int32_t         stop = 0;
+  pthread_t                writer;
+  pthread_t                readers[8];
+  SConcurrentSkipListParam param[9];
+  for (int32_t i = 0; i <= numOfReaders; ++i) {
+    param[i] = {pSkipList, keys, numOfKeys, &stop, 0};
+  }
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfReaders; ++i) {
+    pthread_create(&readers[i], NULL, concurrentSkipListReader, &param[i + 1]);
+  }
+  pthread_create(&writer, NULL, concurrentSkipListWriter, &param[0]);
+
+  pthread_join(writer, NULL);
+  int64_t et = taosGetTimestampUs();
+
+  int64_t numOfScans = 0;
+  for (int32_t i = 0; i < numOfReaders; ++i) {
+    pthread_join(readers[i], NULL);
+    numOfScans += param[i + 1].numOfScans;
+  }
+
+  EXPECT_EQ(SL_SIZE(pSkipList), (uint32_t)numOfKeys);
+
+  int64_t            prev = -1;
+  SSkipListIterator* iter = tSkipListCreateIter(pSkipList);
+  while (tSkipListIterNext(iter)) {
+    int64_t key = *(int64_t*)SL_GET_NODE_DATA(tSkipListIterGet(iter));
+    EXPECT_GT(key, prev);
+    prev = key;
+  }
+  tSkipListDestroyIter(iter);
+  tSkipListDestroy(pSkipList);
+
+  printf("%s: insert %d keys with %d concurrent readers, elapsed time:%" PRId64 "us, scans:%" PRId64 "\n",
+         (flags & SL_LOCK_FREE) ? "lock free" : "rwlock", numOfKeys, numOfReaders, et - st, numOfScans);
+  return et - st;
+}
+
+}  // namespace
+
+TEST(testCase, skiplist_lock_free_test) {
+  const int32_t numOfKeys = 20000;
+  int64_t*      keys = (int64_t*)malloc(sizeof(int64_t) * numOfKeys);
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    keys[i] = i;
+  }
+
+  // shuffle the keys so that nodes are inserted in the middle of the list as well
+  srand(time(NULL));
+  for (int32_t i = numOfKeys - 1; i > 0; --i) {
+    int32_t j = rand() % (i + 1);
+    int64_t t = keys[i];
+    keys[i] = keys[j];
+    keys[j] = t;
+  }
+
+  concurrentSkipListRun(SL_THREAD_SAFE, keys, numOfKeys, 2);
+  concurrentSkipListRun(SL_LOCK_FREE, keys, numOfKeys, 2);
+
+  free(keys);
+}
+
+TEST(testCase, skiplist_lock_free_remove_test) {
+  SSkipList* pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t),
+                                         getKeyComparFunc(TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC),
+                                         SL_ALLOW_DUP_KEY | SL_LOCK_FREE, getInt64Key);
+
+  int64_t keys[100];
+  for (int32_t i = 0; i < 100; ++i) {
+    keys[i] = i / 2;
+    tSkipListPut(pSkipList, &keys[i]);
+  }
+
+  // a removed node is still linked to its neighbours, so an iterator standing on it can move on
+  int64_t            key = 10;
+  SSkipListIterator* iter = tSkipListCreateIterFromVal(pSkipList, (const char*)&key, TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC);
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  EXPECT_EQ(*(int64_t*)SL_GET_NODE_DATA(tSkipListIterGet(iter)), 10);
+
+  EXPECT_EQ(tSkipListRemove(pSkipList, (char*)&key), 2u);
+  EXPECT_EQ(SL_SIZE(pSkipList), 98u);
+
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  EXPECT_GE(*(int64_t*)SL_GET_NODE_DATA(tSkipListIterGet(iter)), 10);
+  tSkipListDestroyIter(iter);
+
+  SArray* res = tSkipListGet(pSkipList, (char*)&key);
+  EXPECT_EQ(taosArrayGetSize(res), 0u);
+  taosArrayDestroy(&res);
+
+  tSkipListDestroy(pSkipList);
+}
+
+namespace {
+
+struct SSkipListArena {
+  char*   buf;
+  int32_t size;
+  int32_t offset;
+};
+
+void* skipListArenaAlloc(void* param, int32_t size) {
+  SSkipListArena* pArena = (SSkipListArena*)param;
+  if (pArena->offset + size > pArena->size) return NULL;
+
+  void* ptr = pArena->buf + pArena->offset;
+  pArena->offset += ALIGN8(size);
+  return ptr;
+}
+
+}  // namespace
+
+TEST(testCase, skiplist_node_allocator_test) {
+  SSkipListArena arena = {(char*)malloc(1024 * 1024), 1024 * 1024, 0};
+
+  SSkipList* pSkipList = tSkipListCreate(5, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t),
+                                         getKeyComparFunc(TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC), SL_DISCARD_DUP_KEY,
+                                         getInt64Key);
+  tSkipListSetNodeAllocator(pSkipList, skipListArenaAlloc, &arena);
+
+  int64_t keys[1000];
+  for (int32_t i = 0; i < 1000; ++i) {
+    keys[i] = (i * 7919) % 1000;
+    SSkipListNode* pNode = tSkipListPut(pSkipList, &keys[i]);
+    ASSERT_TRUE((char*)pNode >= arena.buf && (char*)pNode < arena.buf + arena.size);
+  }
+  EXPECT_EQ(SL_SIZE(pSkipList), 1000u);
+
+  int64_t            prev = -1;
+  SSkipListIterator* iter = tSkipListCreateIter(pSkipList);
+  while (tSkipListIterNext(iter)) {
+    int64_t key = *(int64_t*)SL_GET_NODE_DATA(tSkipListIterGet(iter));
+    EXPECT_EQ(key, prev + 1);
+    prev = key;
+  }
+  tSkipListDestroyIter(iter);
+
+  // the arena owns the nodes and is released before the skip list, as the mem table does
+  free(arena.buf);
+  tSkipListDestroy(pSkipList);
+}
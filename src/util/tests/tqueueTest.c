@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "os.h"
+#include "tqueue.h"
+#include "tlog.h"
+#include "tglobal.h"
+#include "taoserror.h"
+#include "tulog.h"
+
+typedef struct {
+  int         id;
+  int         msgs;
+  int         batch;
+  taos_queue  queue;
+} SProducer;
+
+typedef struct {
+  int         readAll;
+  taos_qset   qset;
+  taos_qall   qall;
+  int64_t     items;
+  int64_t     checksum;
+} SConsumer;
+
+static int64_t tsConsumed = 0;
+
+void *produceItems(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+  void     **pitems = calloc(pProducer->batch, sizeof(void *));
+
+  for (int i = 0; i < pProducer->msgs; i += pProducer->batch) {
+    int num = pProducer->msgs - i < pProducer->batch ? pProducer->msgs - i : pProducer->batch;
+
+    for (int j = 0; j < num; ++j) {
+      int64_t *item = taosAllocateQitem(sizeof(int64_t));
+      *item = i + j;
+      pitems[j] = item;
+    }
+
+    if (num == 1) {
+      taosWriteQitem(pProducer->queue, pProducer->id, pitems[0]);
+    } else {
+      taosWriteQitems(pProducer->queue, pProducer->id, pitems, num);
+    }
+  }
+
+  free(pitems);
+  return NULL;
+}
+
+void *consumeItems(void *param) {
+  SConsumer *pConsumer = (SConsumer *)param;
+  void      *ahandle;
+  int64_t   *item;
+  int        type;
+
+  while (1) {
+    int num = 0;
+    if (pConsumer->readAll) {
+      num = taosReadAllQitemsFromQset(pConsumer->qset, pConsumer->qall, &ahandle);
+      for (int i = 0; i < num; ++i) {
+        taosGetQitem(pConsumer->qall, &type, (void **)&item);
+        pConsumer->checksum += *item;
+        taosFreeQitem(item);
+      }
+    } else {
+      num = taosReadQitemFromQset(pConsumer->qset, &type, (void **)&item, &ahandle);
+      if (num > 0) {
+        pConsumer->checksum += *item;
+        taosFreeQitem(item);
+      }
+    }
+
+    if (num == 0) break;
+    pConsumer->items += num;
+    atomic_add_fetch_64(&tsConsumed, num);
+  }
+
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  int producers = 4;
+  int consumers = 1;
+  int queues = 1;
+  int msgs = 1000000;
+  int batch = 1;
+  int readAll = 0;
+
+  uDebugFlag = 131;
+
+  for (int i=1; i<argc; ++i) {
+    if (strcmp(argv[i], "-p")==0 && i < argc-1) {
+      producers = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-c")==0 && i < argc-1) {
+      consumers = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-q")==0 && i < argc-1) {
+      queues = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n")==0 && i < argc-1) {
+      msgs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b")==0 && i < argc-1) {
+      batch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-a")==0) {
+      readAll = 1;
+    } else if (strcmp(argv[i], "-d")==0 && i < argc-1) {
+      uDebugFlag = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-p]: number of producer threads, default: %d\n", producers);
+      printf("  [-c]: number of consumer threads reading the qset, default: %d\n", consumers);
+      printf("  [-q]: number of queues in the qset, default: %d\n", queues);
+      printf("  [-n]: number of items written by each producer, default: %d\n", msgs);
+      printf("  [-b]: number of items in each write, default: %d\n", batch);
+      printf("  [-a]: consumers read all the items of a queue at once\n");
+      printf("  [-d]: debugFlag, default: %d\n", uDebugFlag);
+      exit(0);
+    }
+  }
+
+  if (producers <= 0 || consumers <= 0 || queues <= 0 || msgs <= 0 || batch <= 0) {
+    printf("invalid parameters\n");
+    exit(1);
+  }
+
+  taosInitLog("tqueue.log", 5000000, 10);
+
+  taos_qset   qset = taosOpenQset();
+  taos_queue *queueList = (taos_queue *) calloc(sizeof(taos_queue), queues);
+  for (int i=0; i<queues; ++i) {
+    queueList[i] = taosOpenQueue();
+    taosAddIntoQset(qset, queueList[i], NULL);
+  }
+
+  SProducer *pProducerList = (SProducer *) calloc(sizeof(SProducer), producers);
+  SConsumer *pConsumerList = (SConsumer *) calloc(sizeof(SConsumer), consumers);
+  pthread_t *pThreadList = (pthread_t *) calloc(sizeof(pthread_t), producers + consumers);
+
+  pthread_attr_t thattr;
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+
+  int64_t st = taosGetTimestampUs();
+
+  for (int i=0; i<consumers; ++i) {
+    pConsumerList[i].readAll = readAll;
+    pConsumerList[i].qset = qset;
+    pConsumerList[i].qall = taosAllocateQall();
+    pthread_create(&(pThreadList[i]), &thattr, consumeItems, (void *)(pConsumerList+i));
+  }
+
+  for (int i=0; i<producers; ++i) {
+    pProducerList[i].id = i;
+    pProducerList[i].msgs = msgs;
+    pProducerList[i].batch = batch;
+    pProducerList[i].queue = queueList[i % queues];
+    pthread_create(&(pThreadList[consumers+i]), &thattr, produceItems, (void *)(pProducerList+i));
+  }
+
+  for (int i=0; i<producers; ++i) {
+    pthread_join(pThreadList[consumers+i], NULL);
+  }
+
+  int64_t total = (int64_t)producers * msgs;
+  while (atomic_load_64(&tsConsumed) < total) {
+    usleep(100);
+  }
+
+  int64_t et = taosGetTimestampUs();
+
+  for (int i=0; i<consumers; ++i) {
+    taosQsetThreadResume(qset);
+  }
+
+  int64_t items = 0, checksum = 0;
+  for (int i=0; i<consumers; ++i) {
+    pthread_join(pThreadList[i], NULL);
+    items += pConsumerList[i].items;
+    checksum += pConsumerList[i].checksum;
+    taosFreeQall(pConsumerList[i].qall);
+  }
+
+  int64_t expected = (int64_t)producers * ((int64_t)msgs * (msgs - 1) / 2);
+  printf("producers:%d consumers:%d queues:%d batch:%d readAll:%d\n", producers, consumers, queues, batch, readAll);
+  printf("%" PRId64 " items in %.3f seconds, %.0f items/s, checksum %s\n", items, (et - st) / 1000000.0,
+         items * 1000000.0 / (et - st > 0 ? et - st : 1), checksum == expected ? "ok" : "mismatched");
+
+  for (int i=0; i<queues; ++i) {
+    taosCloseQueue(queueList[i]);
+  }
+  taosCloseQset(qset);
+
+  free(queueList);
+  free(pProducerList);
+  free(pConsumerList);
+  free(pThreadList);
+
+  taosCloseLog();
+
+  return (items == total && checksum == expected) ? 0 : 1;
+}
@@ -22,7 +22,7 @@ extern "C" {
 #include "vnodeInt.h"
 
 int32_t vnodeReadCfg(SVnodeObj *pVnode);
-int32_t vnodeWriteCfg(SCreateVnodeMsg *pVnodeCfg);
+int32_t vnodeWriteCfg(SCreateVnodeMsg *pVnodeCfg, int8_t memSkipListMode);
 
 #ifdef __cplusplus
 }
@@ -59,6 +59,7 @@ typedef struct {
   uint32_t tblMsgVer; // create table msg version
   void *   wqueue;    // write queue
   void *   qqueue;    // read query queue
+  void *   bqueue;    // read query queue of the batch queries
   void *   fqueue;    // read fetch/cancel queue
   void *   wal;
   void *   tsdb;
@@ -20,7 +20,7 @@
 #include "dnode.h"
 #include "vnodeCfg.h"
 
-static void vnodeLoadCfg(SVnodeObj *pVnode, SCreateVnodeMsg* vnodeMsg) {
+static void vnodeLoadCfg(SVnodeObj *pVnode, SCreateVnodeMsg* vnodeMsg, int8_t memSkipListMode) {
   tstrncpy(pVnode->db, vnodeMsg->db, sizeof(pVnode->db));
   pVnode->dbCfgVersion = vnodeMsg->cfg.dbCfgVersion;
   pVnode->vgCfgVersion = vnodeMsg->cfg.vgCfgVersion;
@@ -36,6 +36,7 @@ static void vnodeLoadCfg(SVnodeObj *pVnode, SCreateVnodeMsg* vnodeMsg) {
   pVnode->tsdbCfg.compression = vnodeMsg->cfg.compression;
   pVnode->tsdbCfg.update = vnodeMsg->cfg.update;
   pVnode->tsdbCfg.cacheLastRow = vnodeMsg->cfg.cacheLastRow;
+  pVnode->tsdbCfg.memSkipListMode = memSkipListMode;
   pVnode->walCfg.walLevel = vnodeMsg->cfg.walLevel;
   pVnode->walCfg.fsyncPeriod = vnodeMsg->cfg.fsyncPeriod;
   pVnode->walCfg.keep = TAOS_WAL_NOT_KEEP;
@@ -66,6 +67,7 @@ int32_t vnodeReadCfg(SVnodeObj *pVnode) {
   cJSON * root = NULL;
   FILE *  fp = NULL;
   bool    nodeChanged = false;
+  int8_t  memSkipListMode = (int8_t)tsdbMemSkipListMode;
   SCreateVnodeMsg vnodeMsg;
 
   char file[TSDB_FILENAME_LEN + 30] = {0};
@@ -255,6 +257,14 @@ int32_t vnodeReadCfg(SVnodeObj *pVnode) {
     vnodeMsg.cfg.dbType = (int8_t)dbType->valueint;
   }
 
+  // the vnodes created by the previous versions take the mode of the dnode
+  cJSON *skipListMode = cJSON_GetObjectItem(root, "memSkipListMode");
+  if (!skipListMode || skipListMode->type != cJSON_Number) {
+    vWarn("vgId: %d, failed to read %s, memSkipListMode not found", pVnode->vgId, file);
+  } else {
+    memSkipListMode = (int8_t)skipListMode->valueint;
+  }
+
   cJSON *nodeInfos = cJSON_GetObjectItem(root, "nodeInfos");
   if (!nodeInfos || nodeInfos->type != cJSON_Array) {
     vError("vgId:%d, failed to read %s, nodeInfos not found", pVnode->vgId, file);
@@ -298,18 +308,18 @@ PARSE_VCFG_ERROR:
   if (fp != NULL) fclose(fp);
 
   if (nodeChanged) {
-    vnodeWriteCfg(&vnodeMsg);
+    vnodeWriteCfg(&vnodeMsg, memSkipListMode);
   }
 
   if (ret == TSDB_CODE_SUCCESS) {
-    vnodeLoadCfg(pVnode, &vnodeMsg);
+    vnodeLoadCfg(pVnode, &vnodeMsg, memSkipListMode);
   }
 
   terrno = 0;
   return ret;
 }
 
-int32_t vnodeWriteCfg(SCreateVnodeMsg *pMsg) {
+int32_t vnodeWriteCfg(SCreateVnodeMsg *pMsg, int8_t memSkipListMode) {
   char file[TSDB_FILENAME_LEN + 30] = {0};
   sprintf(file, "%s/vnode%d/config.json", tsVnodeDir, pMsg->cfg.vgId);
 
@@ -347,6 +357,7 @@ int32_t vnodeWriteCfg(SCreateVnodeMsg *pMsg) {
   len += snprintf(content + len, maxLen - len, "  \"update\": %d,\n", pMsg->cfg.update);
   len += snprintf(content + len, maxLen - len, "  \"cacheLastRow\": %d,\n", pMsg->cfg.cacheLastRow);
   len += snprintf(content + len, maxLen - len, "  \"dbType\": %d,\n", pMsg->cfg.dbType);
+  len += snprintf(content + len, maxLen - len, "  \"memSkipListMode\": %d,\n", memSkipListMode);
   len += snprintf(content + len, maxLen - len, "  \"nodeInfos\": [{\n");
   for (int32_t i = 0; i < pMsg->cfg.vgReplica; i++) {
     SVnodeDesc *node = &pMsg->nodes[i];
@@ -57,7 +57,8 @@ int32_t vnodeCreate(SCreateVnodeMsg *pVnodeCfg) {
     return terrno;
   }
 
-  code = vnodeWriteCfg(pVnodeCfg);
+  // the skip list mode of the mem tables is decided when the vnode is created, and kept in its cfg
+  code = vnodeWriteCfg(pVnodeCfg, (int8_t)tsdbMemSkipListMode);
   if (code != TSDB_CODE_SUCCESS) {
     vError("vgId:%d, failed to save vnode cfg, reason:%s", pVnodeCfg->cfg.vgId, tstrerror(code));
     return code;
@@ -137,7 +138,7 @@ static int32_t vnodeAlterImp(SVnodeObj *pVnode, SCreateVnodeMsg *pVnodeCfg) {
   int32_t  dbCfgVersion = pVnode->dbCfgVersion;
   int32_t  vgCfgVersion = pVnode->vgCfgVersion;
 
-  int32_t code = vnodeWriteCfg(pVnodeCfg);
+  int32_t code = vnodeWriteCfg(pVnodeCfg, tsdbCfg.memSkipListMode);
   if (code != TSDB_CODE_SUCCESS) {
     pVnode->dbCfgVersion = dbCfgVersion;
     pVnode->vgCfgVersion = vgCfgVersion;
@@ -300,8 +301,9 @@ int32_t vnodeOpen(int32_t vgId) {
   
   pVnode->wqueue = dnodeAllocVWriteQueue(pVnode);
   pVnode->qqueue = dnodeAllocVQueryQueue(pVnode);
+  pVnode->bqueue = dnodeAllocVBatchQueue(pVnode);
   pVnode->fqueue = dnodeAllocVFetchQueue(pVnode);
-  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL) {
+  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->bqueue == NULL || pVnode->fqueue == NULL) {
     vnodeCleanUp(pVnode);
     return terrno;
   }
@@ -360,6 +362,8 @@ int32_t vnodeOpen(int32_t vgId) {
 
   sprintf(temp, "%s/wal", walRootDir);
   pVnode->walCfg.vgId = pVnode->vgId;
+  pVnode->walCfg.bufSize = tsWalBufferSize * 1024;
+  pVnode->walCfg.preallocSize = tsWalPreallocSize * 1024 * 1024;
   pVnode->wal = walOpen(temp, &pVnode->walCfg);
   if (pVnode->wal == NULL) { 
     vnodeCleanUp(pVnode);
@@ -549,6 +553,11 @@ void vnodeDestroy(SVnodeObj *pVnode) {
     pVnode->qqueue = NULL;
   }
 
+  if (pVnode->bqueue) {
+    dnodeFreeVBatchQueue(pVnode->bqueue);
+    pVnode->bqueue = NULL;
+  }
+
   if (pVnode->fqueue) {
     dnodeFreeVFetchQueue(pVnode->fqueue);
     pVnode->fqueue = NULL;
@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "os.h"
 #include "dnode.h"
+#include "query.h"
 #include "vnodeStatus.h"
 #include "vnodeBackup.h"
 #include "vnodeWorker.h"
@@ -34,6 +35,7 @@ static SStep tsVnodeSteps[] = {
   {"vnode-worker", vnodeInitMWorker,    vnodeCleanupMWorker},
   {"vnode-write",  vnodeInitWrite,      vnodeCleanupWrite},
   {"vnode-read",   vnodeInitRead,       vnodeCleanupRead},
+  {"query-scan",   qInitQueryScanPool,  qCleanupQueryScanPool},
   {"vnode-hash",   vnodeInitHash,       vnodeCleanupHash},
   {"tsdb-queue",   tsdbInitCommitQueue, tsdbDestroyCommitQueue}
 };
@@ -143,14 +145,22 @@ static void vnodeBuildVloadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
   int64_t totalStorage = 0;
   int64_t compStorage = 0;
   int64_t pointsWritten = 0;
+  int64_t cacheHits = 0;
+  int64_t cacheMisses = 0;
 
   if (vnodeInClosingStatus(pVnode)) return;
   if (pStatus->openVnodes >= TSDB_MAX_VNODES) return;
 
   if (pVnode->tsdb) {
     tsdbReportStat(pVnode->tsdb, &pointsWritten, &totalStorage, &compStorage);
+    tsdbReportBlockCacheStat(pVnode->tsdb, &cacheHits, &cacheMisses);
   }
 
+  // the extensions are collected behind the largest load array, and moved to the end of the actual one by dnode
+  SVnodeLoadExt *pLoadExt = (SVnodeLoadExt *)(pStatus->load + TSDB_MAX_VNODES) + pStatus->openVnodes;
+  pLoadExt->blockCacheHits = htobe64(cacheHits);
+  pLoadExt->blockCacheMisses = htobe64(cacheMisses);
+
   SVnodeLoad *pLoad = &pStatus->load[pStatus->openVnodes++];
   pLoad->vgId = htonl(pVnode->vgId);
   pLoad->dbCfgVersion = htonl(pVnode->dbCfgVersion);
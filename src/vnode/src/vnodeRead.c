@@ -149,6 +149,10 @@ int32_t vnodeWriteToRQueue(void *vparam, void *pCont, int32_t contLen, int8_t qt
     vTrace("vgId:%d, write into vfetch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
     return taosWriteQitem(pVnode->fqueue, qtype, pRead);
+  } else if (qtype == TAOS_QTYPE_QUERY && qIsBatchQuery(*(void **)pCont)) {
+    vTrace("vgId:%d, write into vbatch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
+           pVnode->queuedRMsg);
+    return taosWriteQitem(pVnode->bqueue, qtype, pRead);
   } else {
     vTrace("vgId:%d, write into vquery queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
@@ -182,7 +186,8 @@ static int32_t vnodeDumpQueryResult(SRspRet *pRet, void *pVnode, uint64_t qId, v
   bool continueExec = false;
 
   int32_t code = TSDB_CODE_SUCCESS;
-  if ((code = qDumpRetrieveResult(*handle, (SRetrieveTableRsp **)&pRet->rsp, &pRet->len, &continueExec)) == TSDB_CODE_SUCCESS) {
+  if ((code = qDumpRetrieveResult(*handle, (SRetrieveTableRsp **)&pRet->rsp, &pRet->len, &pRet->pIov,
+                                   &pRet->numOfIov, &continueExec)) == TSDB_CODE_SUCCESS) {
     if (continueExec) {
       *freeHandle = false;
       code = vnodePutItemIntoReadQueue(pVnode, handle, ahandle);
@@ -192,6 +197,10 @@ static int32_t vnodeDumpQueryResult(SRspRet *pRet, void *pVnode, uint64_t qId, v
       } else {
         pRet->qhandle = *handle;
       }
+    } else if (!((SRetrieveTableRsp *)pRet->rsp)->completed) {
+      // the prefetched result is returned, and the query is still in execution or waits for the buffer room
+      *freeHandle = false;
+      qReleaseQInfo(((SVnodeObj *)pVnode)->qMgmt, (void **)&handle, false);
     } else {
       *freeHandle = true;
       vTrace("QInfo:0x%"PRIx64"-%p exec completed, free handle:%d", qId, *handle, *freeHandle);
@@ -300,11 +309,13 @@ static int32_t vnodeProcessQueryMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
 
     // In the retrieve blocking model, only 50% CPU will be used in query processing
     if (tsRetrieveBlockingModel) {
-      qTableQuery(*qhandle, &qId);  // do execute query
+      bool continueExec = false;
+      qTableQuery(*qhandle, &qId, &continueExec);  // do execute query
       qReleaseQInfo(pVnode->qMgmt, (void **)&qhandle, false);
     } else {
       bool freehandle = false;
-      bool buildRes = qTableQuery(*qhandle, &qId);  // do execute query
+      bool continueExec = false;
+      bool buildRes = qTableQuery(*qhandle, &qId, &continueExec);  // do execute query
 
       // build query rsp, the retrieve request has reached here already
       if (buildRes) {
@@ -320,13 +331,23 @@ static int32_t vnodeProcessQueryMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
 
         // NOTE: set return code to be TSDB_CODE_QRY_HAS_RSP to notify dnode to return msg to client
         code = TSDB_CODE_QRY_HAS_RSP;
-      } else {
+      } else if (!continueExec) {
         //void *h1 = qGetResultRetrieveMsg(*qhandle);
 
         /* remove this assert, one possible case that will cause h1 not NULL: query thread unlock pQInfo->lock, and then FETCH thread execute twice before query thread reach here */
         //assert(h1 == NULL);
 
         freehandle = qQueryCompleted(*qhandle);
+      } else {
+        // the time slice is used up or the result is prefetched, the query is queued again behind the others, and
+        // the qhandle is kept by the queue
+        vTrace("vgId:%d, QInfo:%p, query continues, put into vread queue again", pVnode->vgId, *qhandle);
+        if (vnodePutItemIntoReadQueue(pVnode, qhandle, pRead->rpcAhandle) == TSDB_CODE_SUCCESS) {
+          return code;
+        }
+
+        qKillQuery(*qhandle);
+        freehandle = true;
       }
 
       // NOTE: if the qhandle is not put into vread queue or query is completed, free the qhandle.
@@ -178,3 +178,19 @@ void vnodeConfirmForward(void *vparam, uint64_t version, int32_t code, bool forc
   SVnodeObj *pVnode = vparam;
   syncConfirmForward(pVnode->sync, version, code, force);
 }
+
+void vnodeBeginForwards(void *vparam) {
+  SVnodeObj *pVnode = vparam;
+  if (pVnode->syncCfg.replica > 1) syncBeginForwards(pVnode->sync);
+}
+
+// flushed even if the replica is changed to 1 after the forwards began
+void vnodeFlushForwards(void *vparam) {
+  SVnodeObj *pVnode = vparam;
+  syncFlushForwards(pVnode->sync);
+}
+
+bool vnodeCumulativeAcks(void *vparam) {
+  SVnodeObj *pVnode = vparam;
+  return syncCumulativeAcks(pVnode->sync);
+}
@@ -55,6 +55,25 @@ int32_t vnodeInitWrite(void) {
 
 void vnodeCleanupWrite() {}
 
+// the submit msg is still in network byte order, except the flag of the blocks
+static bool vnodeHasColumnarBlock(SSubmitMsg *pMsg, int32_t contLen) {
+  int64_t totalLen = (int32_t)htonl(pMsg->length);
+  if (totalLen > contLen) totalLen = contLen;
+
+  int64_t len = sizeof(SSubmitMsg);
+  while (len + (int64_t)sizeof(SSubmitBlk) <= totalLen) {
+    SSubmitBlk *pBlock = (SSubmitBlk *)POINTER_SHIFT(pMsg, len);
+    if (IS_COLUMNAR_BLOCK(pBlock)) return true;
+
+    int32_t dataLen = htonl(pBlock->dataLen);
+    int32_t schemaLen = htonl(pBlock->schemaLen);
+    if (dataLen < 0 || schemaLen < 0) break;
+    len += sizeof(SSubmitBlk) + (int64_t)dataLen + schemaLen;
+  }
+
+  return false;
+}
+
 int32_t vnodeProcessWrite(void *vparam, void *wparam, int32_t qtype, void *rparam) {
   int32_t    code = 0;
   SVnodeObj *pVnode = vparam;
@@ -90,6 +109,14 @@ int32_t vnodeProcessWrite(void *vparam, void *wparam, int32_t qtype, void *rpara
       return TSDB_CODE_APP_NOT_READY;
     }
 
+    // the connections made before columnarSubmit is turned off still send columnar blocks, which shall not reach
+    // the wal to be replayed by an older version after downgrade
+    if (!tsColumnarSubmit && pHead->msgType == TSDB_MSG_TYPE_SUBMIT &&
+        vnodeHasColumnarBlock((SSubmitMsg *)pHead->cont, pHead->len)) {
+      vDebug("vgId:%d, msg:%s not processed since columnar submit is disabled", pVnode->vgId, taosMsg[pHead->msgType]);
+      return TSDB_CODE_VND_NO_COLUMNAR_SUBMIT;
+    }
+
     // assign version
     pHead->version = pVnode->version + 1;
   } else {  // from wal or forward
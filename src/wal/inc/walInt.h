@@ -39,6 +39,8 @@ extern int32_t wDebugFlag;
 #define WAL_PATH_LEN   (TSDB_FILENAME_LEN + 12)
 #define WAL_FILE_LEN   (WAL_PATH_LEN + 32)
 #define WAL_FILE_NUM   1 // 3
+#define WAL_RECYCLE_PREFIX "recycle"
+#define WAL_RECYCLE_NUM    2  // preallocated files kept for reuse instead of being removed
 
 typedef struct {
   uint64_t version;
@@ -50,8 +52,13 @@ typedef struct {
   int32_t  level;
   int32_t  fsyncPeriod;
   int32_t  fsyncSeq;
+  int32_t  bufSize;
+  int32_t  bufLen;
+  int32_t  preallocSize;
+  int64_t  offset;  // bytes written into the current file, it may be preallocated far beyond
   int8_t   stop;
   int8_t   reserved[3];
+  char *   buf;  // records written but not yet flushed to the file
   char     path[WAL_PATH_LEN];
   char     name[WAL_FILE_LEN];
   pthread_mutex_t mutex;
@@ -60,6 +67,9 @@ typedef struct {
 int32_t walGetNextFile(SWal *pWal, int64_t *nextFileId);
 int32_t walGetOldFile(SWal *pWal, int64_t curFileId, int32_t minDiff, int64_t *oldFileId);
 int32_t walGetNewFile(SWal *pWal, int64_t *newFileId);
+int32_t walFlushBuf(SWal *pWal);
+int32_t walRecycleFile(SWal *pWal, char *name);
+int32_t walReuseFile(SWal *pWal, char *name);
 
 #ifdef __cplusplus
 }
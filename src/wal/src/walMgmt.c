@@ -75,9 +75,20 @@ void *walOpen(char *path, SWalCfg *pCfg) {
   pWal->level = pCfg->walLevel;
   pWal->keep = pCfg->keep;
   pWal->fsyncPeriod = pCfg->fsyncPeriod;
+  pWal->preallocSize = pCfg->preallocSize;
   tstrncpy(pWal->path, path, sizeof(pWal->path));
   pthread_mutex_init(&pWal->mutex, NULL);
 
+  if (pCfg->bufSize > 0) {
+    pWal->buf = malloc(pCfg->bufSize);
+    if (pWal->buf == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      walFreeObj(pWal);
+      return NULL;
+    }
+    pWal->bufSize = pCfg->bufSize;
+  }
+
   pWal->fsyncSeq = pCfg->fsyncPeriod / 1000;
   if (pWal->fsyncSeq <= 0) pWal->fsyncSeq = 1;
 
@@ -92,7 +103,8 @@ void *walOpen(char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
-  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d", pWal->vgId, pWal, pWal->level, pWal->fsyncPeriod);
+  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d bufSize:%d preallocSize:%d", pWal->vgId, pWal,
+         pWal->level, pWal->fsyncPeriod, pWal->bufSize, pWal->preallocSize);
 
   return pWal;
 }
@@ -133,6 +145,8 @@ void walClose(void *handle) {
 
   SWal *pWal = handle;
   pthread_mutex_lock(&pWal->mutex);
+  walFlushBuf(pWal);
+  if (pWal->preallocSize > 0 && tfValid(pWal->tfd)) tfFtruncate(pWal->tfd, pWal->offset);
   tfClose(pWal->tfd);
   pthread_mutex_unlock(&pWal->mutex);
   taosRemoveRef(tsWal.refId, pWal->rid);
@@ -154,6 +168,7 @@ static void walFreeObj(void *wal) {
 
   tfClose(pWal->tfd);
   pthread_mutex_destroy(&pWal->mutex);
+  tfree(pWal->buf);
   tfree(pWal);
 }
 
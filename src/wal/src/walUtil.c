@@ -115,4 +115,38 @@ int32_t walGetNewFile(SWal *pWal, int64_t *newFileId) {
   wTrace("vgId:%d, path:%s, newFileId:%" PRId64, pWal->vgId, pWal->path, *newFileId);
 
   return 0;
-}
\ No newline at end of file
+}
+
+int32_t walRecycleFile(SWal *pWal, char *name) {
+  char recycleName[WAL_FILE_LEN];
+
+  for (int32_t i = 0; i < WAL_RECYCLE_NUM; ++i) {
+    struct stat fstat;
+    snprintf(recycleName, sizeof(recycleName), "%s/%s%d", pWal->path, WAL_RECYCLE_PREFIX, i);
+    if (stat(recycleName, &fstat) == 0) continue;
+
+    if (rename(name, recycleName) < 0) {
+      wError("vgId:%d, file:%s, failed to recycle since %s", pWal->vgId, name, strerror(errno));
+      return -1;
+    }
+
+    wDebug("vgId:%d, file:%s, it is recycled as %s", pWal->vgId, name, recycleName);
+    return 0;
+  }
+
+  return -1;
+}
+
+int32_t walReuseFile(SWal *pWal, char *name) {
+  char recycleName[WAL_FILE_LEN];
+
+  for (int32_t i = 0; i < WAL_RECYCLE_NUM; ++i) {
+    snprintf(recycleName, sizeof(recycleName), "%s/%s%d", pWal->path, WAL_RECYCLE_PREFIX, i);
+    if (rename(recycleName, name) == 0) {
+      wDebug("vgId:%d, file:%s, it is reused as %s", pWal->vgId, recycleName, name);
+      return 0;
+    }
+  }
+
+  return -1;
+}
@@ -39,6 +39,9 @@ int32_t walRenew(void *handle) {
   pthread_mutex_lock(&pWal->mutex);
 
   if (tfValid(pWal->tfd)) {
+    walFlushBuf(pWal);
+    // cut the preallocated zeros, a file no longer written ends at its last record
+    if (pWal->preallocSize > 0) tfFtruncate(pWal->tfd, pWal->offset);
     tfClose(pWal->tfd);
     wDebug("vgId:%d, file:%s, it is closed while renew", pWal->vgId, pWal->name);
   }
@@ -51,13 +54,21 @@ int32_t walRenew(void *handle) {
   }
 
   snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, pWal->fileId);
+  bool prealloc = (pWal->preallocSize > 0 && pWal->keep != TAOS_WAL_KEEP);
+  bool reused = (prealloc && walReuseFile(pWal, pWal->name) == 0);
   pWal->tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+  pWal->offset = 0;
 
   if (!tfValid(pWal->tfd)) {
     code = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%s, failed to open since %s", pWal->vgId, pWal->name, strerror(errno));
   } else {
-    wDebug("vgId:%d, file:%s, it is created and open while renew", pWal->vgId, pWal->name);
+    wDebug("vgId:%d, file:%s, it is %s and open while renew", pWal->vgId, pWal->name, reused ? "reused" : "created");
+    // records then overwrite zeros, so appending neither allocates blocks nor changes the file size
+    if (prealloc && tfFallocate(pWal->tfd, pWal->preallocSize) < 0) {
+      wWarn("vgId:%d, file:%s, failed to preallocate %d bytes since %s", pWal->vgId, pWal->name, pWal->preallocSize,
+            strerror(errno));
+    }
   }
 
   pthread_mutex_unlock(&pWal->mutex);
@@ -79,7 +90,9 @@ void walRemoveOneOldFile(void *handle) {
     char walName[WAL_FILE_LEN] = {0};
     snprintf(walName, sizeof(walName), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, oldFileId);
 
-    if (remove(walName) < 0) {
+    if (pWal->preallocSize > 0 && walRecycleFile(pWal, walName) == 0) {
+      wInfo("vgId:%d, file:%s, it is recycled", pWal->vgId, walName);
+    } else if (remove(walName) < 0) {
       wError("vgId:%d, file:%s, failed to remove since %s", pWal->vgId, walName, strerror(errno));
     } else {
       wInfo("vgId:%d, file:%s, it is removed", pWal->vgId, walName);
@@ -96,14 +109,18 @@ void walRemoveAllOldFiles(void *handle) {
   int64_t fileId = -1;
 
   pthread_mutex_lock(&pWal->mutex);
-  
+
+  pWal->bufLen = 0;
+  pWal->offset = 0;
   tfClose(pWal->tfd);
   wDebug("vgId:%d, file:%s, it is closed before remove all wals", pWal->vgId, pWal->name);
 
   while (walGetNextFile(pWal, &fileId) >= 0) {
     snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, fileId);
 
-    if (remove(pWal->name) < 0) {
+    if (pWal->preallocSize > 0 && walRecycleFile(pWal, pWal->name) == 0) {
+      wInfo("vgId:%d, wal:%p file:%s, it is recycled", pWal->vgId, pWal, pWal->name);
+    } else if (remove(pWal->name) < 0) {
       wError("vgId:%d, wal:%p file:%s, failed to remove since %s", pWal->vgId, pWal, pWal->name, strerror(errno));
     } else {
       wInfo("vgId:%d, wal:%p file:%s, it is removed", pWal->vgId, pWal, pWal->name);
@@ -112,6 +129,11 @@ void walRemoveAllOldFiles(void *handle) {
   pthread_mutex_unlock(&pWal->mutex);
 }
 
+static bool walIsZeroHead(SWalHead *pHead) {
+  static const SWalHead zeroHead = {0};
+  return memcmp(pHead, &zeroHead, sizeof(SWalHead)) == 0;
+}
+
 #if defined(WAL_CHECKSUM_WHOLE)
 
 static void walUpdateChecksum(SWalHead *pHead) {
@@ -132,6 +154,22 @@ static int walValidateChecksum(SWalHead *pHead) {
   return 0;
 }
 
+// nothing but the zeros of a preallocated file follows, as after a record torn by a crash. A bad record followed by
+// any other data is a corruption
+static bool walIsTornTail(int64_t tfd) {
+  char buf[4096];
+
+  while (1) {
+    int64_t ret = tfRead(tfd, buf, sizeof(buf));
+    if (ret < 0) return false;
+    if (ret == 0) return true;
+
+    for (int64_t i = 0; i < ret; ++i) {
+      if (buf[i] != 0) return false;
+    }
+  }
+}
+
 #endif
 
 int32_t walWrite(void *handle, SWalHead *pHead) {
@@ -157,6 +195,24 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
 
   pthread_mutex_lock(&pWal->mutex);
 
+  if (pWal->bufSize > 0) {
+    // group commit, the record reaches the file with the others of the batch in walFsync
+    if (contLen > pWal->bufSize - pWal->bufLen && (code = walFlushBuf(pWal)) != 0) {
+      pthread_mutex_unlock(&pWal->mutex);
+      return code;
+    }
+
+    if (contLen <= pWal->bufSize) {
+      memcpy(pWal->buf + pWal->bufLen, pHead, contLen);
+      pWal->bufLen += contLen;
+      wTrace("vgId:%d, buffer wal, fileId:%" PRId64 " hver:%" PRId64 " wver:%" PRIu64 " len:%d buffered:%d",
+             pWal->vgId, pWal->fileId, pHead->version, pWal->version, pHead->len, pWal->bufLen);
+      pWal->version = pHead->version;
+      pthread_mutex_unlock(&pWal->mutex);
+      return code;
+    }
+  }
+
   if (tfWrite(pWal->tfd, pHead, contLen) != contLen) {
     code = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%s, failed to write since %s", pWal->vgId, pWal->name, strerror(errno));
@@ -164,6 +220,7 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
     wTrace("vgId:%d, write wal, fileId:%" PRId64 " tfd:%" PRId64 " hver:%" PRId64 " wver:%" PRIu64 " len:%d", pWal->vgId,
            pWal->fileId, pWal->tfd, pHead->version, pWal->version, pHead->len);
     pWal->version = pHead->version;
+    pWal->offset += contLen;
   }
 
   pthread_mutex_unlock(&pWal->mutex);
@@ -173,9 +230,42 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
   return code;
 }
 
-void walFsync(void *handle, bool forceFsync) {
+int32_t walFlushBuf(SWal *pWal) {
+  if (pWal->bufLen == 0) return 0;
+
+  int32_t code = 0;
+  if (tfWrite(pWal->tfd, pWal->buf, pWal->bufLen) != pWal->bufLen) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%s, failed to write %d buffered bytes since %s", pWal->vgId, pWal->name, pWal->bufLen,
+           strerror(errno));
+  } else {
+    wTrace("vgId:%d, fileId:%" PRId64 ", flush %d buffered bytes", pWal->vgId, pWal->fileId, pWal->bufLen);
+    pWal->offset += pWal->bufLen;
+  }
+
+  pWal->bufLen = 0;
+  return code;
+}
+
+int32_t walFsync(void *handle, bool forceFsync) {
   SWal *pWal = handle;
-  if (pWal == NULL || !tfValid(pWal->tfd)) return;
+  if (pWal == NULL || !tfValid(pWal->tfd)) return 0;
+
+  int32_t code = 0;
+  if (pWal->bufSize > 0) {
+    // one write and one fdatasync for all the records of the batch
+    pthread_mutex_lock(&pWal->mutex);
+    code = walFlushBuf(pWal);
+    if (code == 0 && (forceFsync || (pWal->level == TAOS_WAL_FSYNC && pWal->fsyncPeriod == 0))) {
+      wTrace("vgId:%d, fileId:%" PRId64 ", do fdatasync", pWal->vgId, pWal->fileId);
+      if (tfFdatasync(pWal->tfd) < 0) {
+        code = TAOS_SYSTEM_ERROR(errno);
+        wError("vgId:%d, fileId:%" PRId64 ", fdatasync failed since %s", pWal->vgId, pWal->fileId, strerror(errno));
+      }
+    }
+    pthread_mutex_unlock(&pWal->mutex);
+    return code;
+  }
 
   if (forceFsync || (pWal->level == TAOS_WAL_FSYNC && pWal->fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ", do fsync", pWal->vgId, pWal->fileId);
@@ -183,6 +273,8 @@ void walFsync(void *handle, bool forceFsync) {
       wError("vgId:%d, fileId:%" PRId64 ", fsync failed since %s", pWal->vgId, pWal->fileId, strerror(errno));
     }
   }
+
+  return code;
 }
 
 int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
@@ -239,6 +331,9 @@ int32_t walGetWalFile(void *handle, char *fileName, int64_t *fileId) {
 
   pthread_mutex_lock(&(pWal->mutex));
 
+  // the peer reads the file, let it see every record written so far
+  walFlushBuf(pWal);
+
   int32_t code = walGetNextFile(pWal, fileId);
   if (code >= 0) {
     sprintf(fileName, "wal/%s%" PRId64, WAL_PREFIX, *fileId);
@@ -454,6 +549,11 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
       break;
     }
 
+    if (walIsZeroHead(pHead)) {
+      wDebug("vgId:%d, file:%s, reach the end of preallocated records, offset:%" PRId64, pWal->vgId, name, offset);
+      break;
+    }
+
 #if defined(WAL_CHECKSUM_WHOLE)
     if ((pHead->sver == 0 && !walValidateChecksum(pHead)) || pHead->sver < 0 || pHead->sver > 2) {
       wError("vgId:%d, file:%s, wal head cksum is messed up, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
@@ -489,6 +589,12 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     }
 
     if ((pHead->sver >= 1) && !walValidateChecksum(pHead)) {
+      if (walIsTornTail(tfd)) {
+        wWarn("vgId:%d, file:%s, last record is torn, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
+              pHead->version, pHead->len, offset);
+        break;
+      }
+
       wError("vgId:%d, file:%s, wal whole cksum is messed up, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
       code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
@@ -578,12 +684,28 @@ void walResetVersion(twalh param, uint64_t newVer) {
   pWal->version = newVer;
 }
 
+bool walIsValidRecord(SWalHead *pHead) {
+  if (walIsZeroHead(pHead)) return false;
+
+#if defined(WAL_CHECKSUM_WHOLE)
+  if (pHead->sver >= 1) {
+    uint32_t cksum = pHead->cksum;
+    bool     valid = walValidateChecksum(pHead);
+    pHead->cksum = cksum;
+    return valid;
+  }
+#endif
+
+  return true;
+}
+
 int64_t walGetFSize(twalh handle) {
   SWal *pWal = handle;
   if (pWal == NULL) return 0;
   struct stat _fstat;
+  if (pWal->preallocSize > 0) return pWal->offset + pWal->bufLen;
   if (tfStat(pWal->tfd, &_fstat) == 0) {
-    return _fstat.st_size;
+    return _fstat.st_size + pWal->bufLen;
   };
   return 0;
 }
\ No newline at end of file
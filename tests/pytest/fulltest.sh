@@ -57,6 +57,7 @@ python3 test.py -f tag_lite/json_tag_extra.py
 
 # tag
 python3 ./test.py -f tag_lite/filter.py
+python3 ./test.py -f tag_lite/tagIndex.py
 python3 ./test.py -f tag_lite/create-tags-boundary.py
 python3 ./test.py -f tag_lite/3.py
 python3 ./test.py -f tag_lite/4.py
@@ -181,6 +182,7 @@ python3 test.py -f tools/taosdemoTestInterlace.py
 # restful test for python
 # python3 test.py -f restful/restful_bind_db1.py
 # python3 test.py -f restful/restful_bind_db2.py
+# python3 test.py -f restful/restful_columnar.py
 
 # nano support
 python3 test.py -f tools/taosdemoAllTest/NanoTestCase/taosdemoTestSupportNanoInsert.py
@@ -302,6 +304,7 @@ python3 ./test.py -f stream/stream1.py
 python3 ./test.py -f stream/stream2.py
 #python3 ./test.py -f stream/parser.py
 python3 ./test.py -f stream/history.py
+python3 ./test.py -f stream/incremental.py
 python3 ./test.py -f stream/sys.py
 python3 ./test.py -f stream/table_1.py
 python3 ./test.py -f stream/table_n.py
@@ -344,6 +347,8 @@ python3 ./test.py -f update/merge_commit_data-0.py
 # wal
 python3 ./test.py -f wal/addOldWalTest.py
 python3 ./test.py -f wal/sdbComp.py
+python3 ./test.py -f wal/walGroupCommit.py
+python3 ./test.py -f wal/walPrealloc.py
 
 # function
 python3 ./test.py -f functions/all_null_value.py
@@ -374,6 +379,11 @@ python3 ./test.py -f functions/function_interp.py
 python3 ./test.py -f insert/metadataUpdate.py
 python3 ./test.py -f query/last_cache.py
 python3 ./test.py -f query/last_row_cache.py
+python3 ./test.py -f query/queryParallelScan.py
+python3 ./test.py -f query/queryBlockCache.py
+python3 ./test.py -f query/queryReadAhead.py
+python3 ./test.py -f query/queryTimeSlice.py
+python3 ./test.py -f query/queryPrefetch.py
 python3 ./test.py -f account/account_create.py
 python3 ./test.py -f alter/alter_table.py
 python3 ./test.py -f query/queryGroupbySort.py
@@ -0,0 +1,76 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+from util.dnodes import tdDnodes
+
+class TDTestCase:
+    updatecfgDict={'blockCacheSize':16}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.rows = 3000
+        self.ts = 1601481600000
+
+    def insertData(self, start, num):
+        for i in range(start, start + num, 500):
+            values = ["(%d, %d, 'b%d')" % (self.ts + j * 1000, j, j % 7) for j in range(i, min(i + 500, start + num))]
+            tdSql.execute("insert into t1 values " + " ".join(values))
+
+    def checkData(self, num):
+        tdSql.query("select count(*), sum(c1), max(c1) from t1")
+        tdSql.checkData(0, 0, num)
+        tdSql.checkData(0, 1, num * (num - 1) // 2)
+        tdSql.checkData(0, 2, num - 1)
+
+        tdSql.query("select c2 from t1 where c1 = 1000")
+        tdSql.checkData(0, 0, "b%d" % (1000 % 7))
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create database test1 days 1")
+        tdSql.execute("use test1")
+        tdSql.execute("create table t1 (ts timestamp, c1 int, c2 binary(10))")
+        self.insertData(0, self.rows)
+
+        # flush the data into data files
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+
+        # the second round shall be served by the block cache
+        self.checkData(self.rows)
+        self.checkData(self.rows)
+
+        # new data in the same file sets, merged with the cached blocks from the mem table
+        self.insertData(self.rows, self.rows)
+        self.checkData(self.rows * 2)
+
+        # commit the new data into the same file sets
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.checkData(self.rows * 2)
+        self.checkData(self.rows * 2)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,94 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+from util.dnodes import tdDnodes
+
+class TDTestCase:
+    updatecfgDict={'queryScanThreads':4}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.rows = 6000
+        self.ts = 1601481600000
+        self.step = 150000  # about 10 days of data, one file set per day
+
+    def insertData(self, offset, num):
+        rows = []
+        for i in range(num):
+            c1 = None if i % 17 == 0 else (i * 7919) % 2001 - 1000
+            c2 = (i * 104729) % 100000 / 8.0
+            ts = self.ts + offset + i * self.step
+            rows.append("(%d, %s, %f)" % (ts, "null" if c1 is None else c1, c2))
+            self.data.append((ts, c1, c2))
+
+        for i in range(0, num, 500):
+            tdSql.execute("insert into t1 values " + " ".join(rows[i:i + 500]))
+
+    def executeQueries(self):
+        c1 = [r[1] for r in self.data if r[1] is not None]
+
+        tdSql.query("select count(*), count(c1), sum(c1), min(c1), max(c1), max(c2) from t1")
+        tdSql.checkData(0, 0, len(self.data))
+        tdSql.checkData(0, 1, len(c1))
+        tdSql.checkData(0, 2, sum(c1))
+        tdSql.checkData(0, 3, min(c1))
+        tdSql.checkData(0, 4, max(c1))
+        tdSql.checkData(0, 5, max([r[2] for r in self.data]))
+
+        tdSql.query("select avg(c1) from t1")
+        if abs(tdSql.getData(0, 0) - float(sum(c1)) / len(c1)) > 1e-6:
+            tdLog.exit("avg(c1) is %f, expect %f" % (tdSql.getData(0, 0), float(sum(c1)) / len(c1)))
+
+        # time range starts and ends in the middle of a file set
+        skey = self.ts + 1000 * self.step
+        ekey = self.ts + 4000 * self.step
+        rows = [r for r in self.data if r[0] >= skey and r[0] < ekey]
+        tdSql.query("select count(*), sum(c1) from t1 where ts >= %d and ts < %d" % (skey, ekey))
+        tdSql.checkData(0, 0, len(rows))
+        tdSql.checkData(0, 1, sum([r[1] for r in rows if r[1] is not None]))
+
+        tdSql.query("select count(*), max(c1) from t1 where ts > %d" % (self.ts + 2 * self.rows * self.step))
+        tdSql.checkRows(0)
+
+    def run(self):
+        tdSql.prepare()
+
+        self.data = []
+
+        tdSql.execute("create database test1 days 1")
+        tdSql.execute("use test1")
+        tdSql.execute("create table t1 (ts timestamp, c1 int, c2 double)")
+        self.insertData(0, self.rows)
+
+        # all data in data files
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.executeQueries()
+
+        # data in both data files and mem table
+        self.insertData(self.step // 2, self.rows)
+        self.executeQueries()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
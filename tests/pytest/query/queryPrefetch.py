@@ -0,0 +1,79 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+
+class TDTestCase:
+    # the result blocks are computed ahead of the retrieve msgs
+    updatecfgDict={'queryPrefetchBlocks':4}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self.conn = conn
+
+        self.rows = 30000
+        self.ts = 1600000000000
+
+    def value(self, t, i):
+        return (i * 7919 + t * 13) % 2001 - 1000
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create table st (ts timestamp, v int, b binary(16)) tags (g int)")
+        for t in range(2):
+            tdSql.execute("create table t%d using st tags(%d)" % (t, t))
+            for i in range(0, self.rows, 500):
+                tdSql.execute("insert into t%d values " % t + " ".join(
+                    "(%d, %d, 'b%d')" % (self.ts + j * 1000, self.value(t, j), j % 97) for j in range(i, i + 500)))
+
+        # the result of many blocks is returned in order
+        tdSql.query("select ts, v, b from t0")
+        tdSql.checkRows(self.rows)
+        for i in range(0, self.rows, 997):
+            tdSql.checkData(i, 1, self.value(0, i))
+            tdSql.checkData(i, 2, "b%d" % (i % 97))
+
+        rows = [self.value(t, i) for t in range(2) for i in range(self.rows) if self.value(t, i) > 100]
+        tdSql.query("select v from st where v > 100")
+        tdSql.checkRows(len(rows))
+        if sorted(r[0] for r in tdSql.queryResult) != sorted(rows):
+            tdLog.exit("unexpected result of the super table projection")
+
+        tdSql.query("select v from t1 limit 5000 offset 12345")
+        tdSql.checkRows(5000)
+        for i in range(0, 5000, 499):
+            tdSql.checkData(i, 0, self.value(1, i + 12345))
+
+        # the prefetched results of the queries abandoned by the client are discarded
+        for k in range(10):
+            cursor = self.conn.cursor()
+            cursor.execute("select ts, v, b from st")
+            cursor.fetchone()
+            cursor.close()
+
+        tdSql.query("select count(*), sum(v) from st")
+        tdSql.checkData(0, 0, self.rows * 2)
+        tdSql.checkData(0, 1, sum(self.value(t, i) for t in range(2) for i in range(self.rows)))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
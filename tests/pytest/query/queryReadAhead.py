@@ -0,0 +1,66 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+from util.dnodes import tdDnodes
+
+class TDTestCase:
+    updatecfgDict={'readAheadBlocks':4}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.rows = 20000
+        self.ts = 1600000000000
+
+    def executeQueries(self):
+        v = [(i * 7919) % 2001 - 1000 for i in range(self.rows)]
+
+        # filters force every block to be loaded instead of using the block statistics
+        rows = [x for x in v if x > 10]
+        tdSql.query("select count(*), sum(v) from t1 where v > 10")
+        tdSql.checkData(0, 0, len(rows))
+        tdSql.checkData(0, 1, sum(rows))
+
+        rows = [i for i in range(self.rows) if v[i] < -990]
+        tdSql.query("select v, w from t1 where v < -990 order by ts desc")
+        tdSql.checkRows(len(rows))
+        tdSql.checkData(0, 0, v[rows[-1]])
+        tdSql.checkData(0, 1, rows[-1] / 8.0)
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create database test1 maxrows 200 minrows 10")
+        tdSql.execute("use test1")
+        tdSql.execute("create table t1 (ts timestamp, v int, w double)")
+        for i in range(0, self.rows, 500):
+            tdSql.execute("insert into t1 values " + " ".join(
+                "(%d, %d, %f)" % (self.ts + j * 1000, (j * 7919) % 2001 - 1000, j / 8.0) for j in range(i, i + 500)))
+
+        # many blocks in one file set
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.executeQueries()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
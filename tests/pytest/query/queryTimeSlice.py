@@ -0,0 +1,94 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+from util.dnodes import tdDnodes
+
+class TDTestCase:
+    # the aggregate queries yield after almost every data block
+    updatecfgDict={'queryTimeSlice':1}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.rows = 20000
+        self.ts = 1600000000000
+
+    def value(self, t, i):
+        return (i * 7919 + t * 13) % 2001 - 1000
+
+    def executeQueries(self):
+        v = [[self.value(t, i) for i in range(self.rows)] for t in range(2)]
+
+        rows = [x for x in v[0] if x > 10]
+        tdSql.query("select count(*), sum(v), min(v), max(v) from t0 where v > 10")
+        tdSql.checkData(0, 0, len(rows))
+        tdSql.checkData(0, 1, sum(rows))
+        tdSql.checkData(0, 2, min(rows))
+        tdSql.checkData(0, 3, max(rows))
+
+        rows = [x for t in range(2) for x in v[t] if x < 500]
+        tdSql.query("select count(*), sum(v) from st where v < 500")
+        tdSql.checkData(0, 0, len(rows))
+        tdSql.checkData(0, 1, sum(rows))
+
+        # a window of 1000 seconds holds 1000 rows
+        tdSql.query("select count(*), max(v) from t1 where v > 0 interval(1000s)")
+        tdSql.checkRows(self.rows // 1000)
+        for k in range(self.rows // 1000):
+            rows = [x for x in v[1][k * 1000:(k + 1) * 1000] if x > 0]
+            tdSql.checkData(k, 1, len(rows))
+            tdSql.checkData(k, 2, max(rows))
+
+        tdSql.query("select count(*), sum(v) from st where v > -100 group by g")
+        tdSql.checkRows(2)
+        for t in range(2):
+            rows = [x for x in v[t] if x > -100]
+            tdSql.checkData(t, 0, len(rows))
+            tdSql.checkData(t, 1, sum(rows))
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create database test1 maxrows 200 minrows 10")
+        tdSql.execute("use test1")
+        tdSql.execute("create table st (ts timestamp, v int) tags (g int)")
+        for t in range(2):
+            tdSql.execute("create table t%d using st tags(%d)" % (t, t))
+            for i in range(0, self.rows, 500):
+                tdSql.execute("insert into t%d values " % t + " ".join(
+                    "(%d, %d)" % (self.ts + j * 1000, self.value(t, j)) for j in range(i, i + 500)))
+
+        self.executeQueries()
+
+        # many blocks in one file set
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        self.executeQueries()
+
+        # the cpu time consumed in vnodes is shown along with the elapsed time
+        tdSql.query("show queries")
+        if "cpu_time" not in [d[0] for d in tdSql.cursor.description]:
+            tdLog.exit("cpu_time is not shown in show queries")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
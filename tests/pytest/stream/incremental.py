@@ -0,0 +1,80 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+
+
+class TDTestCase:
+    updatecfgDict={'maxStreamCompDelay':10, 'maxFirstStreamCompDelay':1000, 'streamIncremental':1}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.ts = 1609430400000
+        self.tables = 4
+
+    def insertData(self):
+        for t in range(self.tables):
+            rows = []
+            for i in range(1200):
+                v = (i * 7919 + t * 104729) % 2001 - 1000
+                f = "null" if (i + t) % 13 == 0 else "%f" % ((i * 31 + t) % 1000 / 8.0)
+                rows.append("(%d, %d, %s)" % (self.ts + t * 137 + i * 1500, v, f))
+
+            for i in range(0, len(rows), 300):
+                tdSql.execute("insert into t%d values %s" % (t, " ".join(rows[i:i + 300])))
+
+    # the windows of the stream are merged from the panes of the sliding length
+    def checkStream(self, stream, sql):
+        tdSql.query(sql)
+        expect = tdSql.queryResult
+
+        tdSql.waitedQuery("select * from %s" % stream, len(expect), 120)
+        tdSql.query("select * from %s" % stream)
+        tdSql.checkRows(len(expect))
+        for i in range(len(expect)):
+            for j in range(len(expect[i])):
+                tdSql.checkData(i, j, expect[i][j])
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create table st (ts timestamp, v int, f double) tags (g int)")
+        for t in range(self.tables):
+            tdSql.execute("create table t%d using st tags(%d)" % (t, t))
+        self.insertData()
+
+        select = "select count(*), sum(v), min(f), max(v), first(v), last(f) from st interval(60s) sliding(10s)"
+        tdSql.execute("create table s1 as %s" % select)
+        self.checkStream("s1", select)
+
+        select = "select count(*), sum(f), max(f), last(v) from t1 interval(30s) sliding(15s)"
+        tdSql.execute("create table s2 as %s" % select)
+        self.checkStream("s2", select)
+
+        # not merged from the panes
+        select = "select avg(v), spread(f) from t2 interval(60s) sliding(20s)"
+        tdSql.execute("create table s3 as %s" % select)
+        self.checkStream("s3", select)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,112 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import taos
+from util.log import tdLog
+from util.cases import tdCases
+from util.sql import tdSql
+from util.dnodes import tdDnodes
+
+class TDTestCase:
+    updatecfgDict={'tagIndex':1}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+        self.tables = 1000
+        self.regions = ['east', 'west', 'north', 'south', None]
+
+    def createTables(self):
+        tdSql.execute("create table st (ts timestamp, v int) tags (id int, region binary(16), model nchar(16), site int, temp double)")
+        for i in range(self.tables):
+            region = self.regions[i % 5]
+            temp = None if i % 11 == 0 else (i % 13) / 2.0
+            tdSql.execute("create table t%d using st tags(%d, %s, '%s', %d, %s)" % (
+                i, i, "null" if region is None else "'%s'" % region, "m%d" % (i % 7), i % 50, "null" if temp is None else temp))
+            self.tags["t%d" % i] = {'id': i, 'region': region, 'model': "m%d" % (i % 7), 'site': i % 50, 'temp': temp}
+
+    def checkCount(self, cond, func):
+        tdSql.query("select count(tbname) from st where %s" % cond)
+        expect = len([t for t in self.tags.values() if func(t)])
+        if expect == 0:
+            tdSql.checkRows(0)
+        else:
+            tdSql.checkData(0, 0, expect)
+
+    def executeQueries(self):
+        self.checkCount("region = 'east'", lambda t: t['region'] == 'east')
+        self.checkCount("region = 'east' and model = 'm3'", lambda t: t['region'] == 'east' and t['model'] == 'm3')
+        self.checkCount("region = 'east' or site = 7", lambda t: t['region'] == 'east' or t['site'] == 7)
+        self.checkCount("site > 45", lambda t: t['site'] is not None and t['site'] > 45)
+        self.checkCount("site between 5 and 6", lambda t: t['site'] is not None and 5 <= t['site'] <= 6)
+        self.checkCount("site in (1, 2, 3) and region <> 'west'",
+                        lambda t: t['site'] in (1, 2, 3) and t['region'] is not None and t['region'] != 'west')
+        self.checkCount("region like 'no%'", lambda t: t['region'] is not None and t['region'].startswith('no'))
+        self.checkCount("region is null", lambda t: t['region'] is None)
+        self.checkCount("temp = 1.5", lambda t: t['temp'] == 1.5)
+        self.checkCount("temp >= 5 and site < 10", lambda t: t['temp'] is not None and t['temp'] >= 5 and t['site'] is not None and t['site'] < 10)
+        self.checkCount("model in ('m1', 'm2')", lambda t: t['model'] in ('m1', 'm2'))
+        self.checkCount("model = 'none'", lambda t: False)
+        self.checkCount("region = 'east' or tbname = 't1'", lambda t: t['region'] == 'east' or t['id'] == 1)
+        self.checkCount("id > 10 and region = 'south'", lambda t: t['id'] > 10 and t['region'] == 'south')
+
+    def run(self):
+        tdSql.prepare()
+
+        self.tags = {}
+
+        tdSql.execute("create database test1")
+        tdSql.execute("use test1")
+        self.createTables()
+        self.executeQueries()
+
+        # the indexes follow tag updates and dropped tables
+        tdSql.execute("alter table t1 set tag region = 'east'")
+        self.tags['t1']['region'] = 'east'
+        tdSql.execute("alter table t2 set tag site = null")
+        self.tags['t2']['site'] = None
+        tdSql.execute("alter table t3 set tag model = 'm0'")
+        self.tags['t3']['model'] = 'm0'
+        tdSql.execute("drop table t0")
+        del self.tags['t0']
+        self.checkCount("site = 2", lambda t: t['site'] == 2)
+        self.executeQueries()
+
+        # rebuilt from the meta file after restart
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        tdSql.execute("use test1")
+        self.executeQueries()
+
+        # the index of a dropped tag is not used by a new tag of the same name
+        tdSql.execute("alter stable st drop tag temp")
+        tdSql.execute("alter table t4 set tag site = 7")
+        self.tags['t4']['site'] = 7
+        self.checkCount("site = 7", lambda t: t['site'] == 7)
+        tdSql.execute("alter stable st add tag temp double")
+        tdSql.execute("alter table t5 set tag temp = 1.5")
+        for t in self.tags.values():
+            t['temp'] = None
+        self.tags['t5']['temp'] = 1.5
+        self.executeQueries()
+
+        tdSql.execute("drop stable st")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
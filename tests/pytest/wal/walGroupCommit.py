@@ -0,0 +1,60 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import os
+import taos
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    updatecfgDict={'walBufferSize':64}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.ts = 1600000000000
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create database wdb wal 2 fsync 0")
+        tdSql.execute("use wdb")
+        tdSql.execute("create table t1(ts timestamp, a int, b binary(200))")
+
+        # single records and batches larger than the wal buffer
+        for i in range(200):
+            tdSql.execute("insert into t1 values(%d, %d, '%s')" % (self.ts + i, i, 'x' * 200))
+        for i in range(200, 2200, 500):
+            tdSql.execute("insert into t1 values " + " ".join(
+                "(%d, %d, '%s')" % (self.ts + j, j, 'y' * 200) for j in range(i, i + 500)))
+
+        # acked writes must be restored from the wal
+        os.system("sudo kill -9 $(pgrep taosd)")
+        tdDnodes.start(1)
+
+        tdSql.execute("use wdb")
+        tdSql.query("select count(*), sum(a) from t1")
+        tdSql.checkData(0, 0, 2200)
+        tdSql.checkData(0, 1, sum(range(2200)))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
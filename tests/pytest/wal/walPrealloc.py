@@ -0,0 +1,70 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import sys
+import os
+import taos
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    updatecfgDict={'walPreallocSize':4}
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.ts = 1600000000000
+
+    def insertData(self, start, num):
+        for i in range(start, start + num, 100):
+            tdSql.execute("insert into t1 values " + " ".join(
+                "(%d, %d)" % (self.ts + j, j) for j in range(i, i + 100)))
+
+    def checkData(self, num):
+        tdSql.execute("use wdb")
+        tdSql.query("select count(*), sum(a) from t1")
+        tdSql.checkData(0, 0, num)
+        tdSql.checkData(0, 1, sum(range(num)))
+
+    def run(self):
+        tdSql.prepare()
+
+        tdSql.execute("create database wdb")
+        tdSql.execute("use wdb")
+        tdSql.execute("create table t1(ts timestamp, a int)")
+        self.insertData(0, 3000)
+
+        # records end in the zeros of the preallocated wal file
+        os.system("sudo kill -9 $(pgrep taosd)")
+        tdDnodes.start(1)
+        self.checkData(3000)
+
+        # the recycled wal file must not bring back records written before
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        tdSql.execute("use wdb")
+        self.insertData(3000, 100)
+        os.system("sudo kill -9 $(pgrep taosd)")
+        tdDnodes.start(1)
+        self.checkData(3100)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())